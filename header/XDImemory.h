@@ -28,6 +28,10 @@ bool_t XDIMEMORY_WriteRequest(uint8_t * const p_writeBuffer,
 
 bool_t XDIMEMORY_EraseRequest(void);
 
+#ifdef UNIT_TEST_BUILD
+void XDIMEMORY_ShadowDiscard_TDD(void);
+#endif
+
 #endif /* XDI_MEMORY_H_ */
 
 // ----------------------------------------------------------------------------
@@ -90,6 +90,12 @@ typedef OpcodePacket_t LoaderMessage_t;
 /** Maximum length of a message for SSB or CAN message*/
 #define COMM_MAX_LENGTH 512
 
+/** Space needed in front of the data of a streamed message (SOF, address, length and status) */
+#define LOADER_STREAM_PREFIX_LENGTH 5u
+
+/** Space needed after the data of a streamed message (checksum and end character) */
+#define LOADER_STREAM_SUFFIX_LENGTH 3u
+
 // Global variables:
 extern EBusType_t 		gBusCOM;
 extern unsigned char 	gRxBuffer[COMM_MAX_LENGTH];
@@ -97,6 +103,9 @@ extern unsigned char 	gRxBuffer[COMM_MAX_LENGTH];
 // Function prototypes:
 LoaderMessage_t* 	loader_waitForMessage(Timer_t *timer);
 void 				loader_MessageSend(Uint8 Status, Uint16 LengthOfDataInBytes, char* pData);
+void 				loader_MessageStreamStart(void);
+void 				loader_MessageStreamSend(Uint8 Status, Uint16 LengthOfDataInBytes, unsigned char* pFrame);
+void 				loader_MessageStreamEnd(void);
 
 
 #endif
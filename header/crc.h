@@ -16,6 +16,16 @@
 #ifndef CRC_H_
 #define CRC_H_
 
+/// CRC engines which can be selected at build time - see crc.c.
+#define CRC_ENGINE_BYTE_TABLE   1u  ///< One table, one byte per step.
+#define CRC_ENGINE_WORD_TABLE   2u  ///< Two tables, one word per step.
+#define CRC_ENGINE_SLICE_BY_4   4u  ///< Four tables, two words per step.
+
+/// CRC engine used by crc.c and dsp_crc.c.
+#ifndef CRC_ENGINE
+#define CRC_ENGINE              CRC_ENGINE_WORD_TABLE
+#endif
+
 bool_t 		CRC_Check(const uint16_t* const pBuffer, const uint32_t LengthInBytes,
 				      const uint16_t InitialValue, const uint16_t ExpectedCRC);
 
@@ -26,6 +36,14 @@ uint16_t 	CRC_CCITTCalculate(const uint16_t * const pBuffer,
 uint16_t 	CRC_CCITTOnByteCalculate(const uint8_t * const pBuffer,
          	                         uint32_t LengthInBytes,
                                      const uint16_t InitialValue);
+uint16_t    CRC_CCITTAugmentedCalculate(const uint16_t * const pBuffer,
+                                        uint32_t LengthInWords,
+                                        const uint16_t RunningValue);
+
+uint16_t    CRC_CCITTAugmentedOnBytePairCalculate(const uint16_t * const pBuffer,
+                                                  const uint32_t LengthInBytes,
+                                                  const uint16_t RunningValue);
+
 uint16_t    CheckNum_Calculate(const uint8_t * const pBuffer,
                                      uint32_t LengthInBytes,
                                      const uint16_t InitialValue);
@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        download_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for download_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_DOWNLOAD_SIM_H_
+#define HEADER_DOWNLOAD_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/**
+ * Structure holding the link and flash model used by the download simulation.
+ */
+typedef struct
+{
+    uint32_t    baud_rate;                  ///< SSB baud rate (10 bits per character).
+    uint32_t    image_words;                ///< Number of words downloaded.
+    uint32_t    frame_data_bytes;           ///< Data bytes per opcode 37 frame (even, max 254).
+    uint32_t    word_program_us;            ///< Internal flash program time per word.
+    uint32_t    dsp_turnaround_us;          ///< Delay before the DSP replies (RS485 enable).
+    uint32_t    host_turnaround_us;         ///< Delay before the host sends the next frame.
+    bool_t      b_double_buffered;          ///< Program while the next frame is received.
+} download_sim_config_t;
+
+/**
+ * Structure holding the results of a download simulation.
+ */
+typedef struct
+{
+    uint32_t    frames;                     ///< Number of opcode 37 frames.
+    uint64_t    total_us;                   ///< Time until the last word is in the flash.
+    uint64_t    link_limited_us;            ///< Time with zero flash program time.
+    uint64_t    program_us;                 ///< Total flash program time.
+    uint64_t    program_hidden_us;          ///< Program time overlapped with reception.
+} download_sim_result_t;
+
+void    download_sim_config_default(download_sim_config_t * const p_config);
+
+void    download_sim_run(const download_sim_config_t * const p_config,
+                         download_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_DOWNLOAD_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
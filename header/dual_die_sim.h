@@ -0,0 +1,56 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        dual_die_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for dual_die_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_DUAL_DIE_SIM_H_
+#define HEADER_DUAL_DIE_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Largest range which can be erased and written, across both devices.
+#define DUAL_DIE_SIM_MAX_BYTES      0x00100000u
+
+/**
+ * Structure holding the range erased and written by the dual device benchmark.
+ */
+typedef struct
+{
+    uint32_t    sectors_per_die;            ///< Sectors each side of the boundary between the devices.
+} dual_die_sim_config_t;
+
+/**
+ * Structure holding the results of the dual device benchmark.
+ */
+typedef struct
+{
+    uint64_t    serial_erase_us;            ///< lld_SectorEraseOp, one sector at a time.
+    uint64_t    parallel_erase_us;          ///< flash_hal_device_erase.
+    uint64_t    serial_write_us;            ///< lld_memcpy_bytes, one device at a time.
+    uint64_t    parallel_write_us;          ///< flash_hal_device_write.
+    bool_t      b_erased;                   ///< Both erases left the range blank.
+    bool_t      b_data_matches;             ///< Both writes left the data in the flash.
+} dual_die_sim_result_t;
+
+void    dual_die_sim_config_default(dual_die_sim_config_t * const p_config);
+
+bool_t  dual_die_sim_run(const dual_die_sim_config_t * const p_config,
+                         dual_die_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_DUAL_DIE_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
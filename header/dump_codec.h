@@ -0,0 +1,41 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        dump_codec.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for dump_codec.c
+ * @note        Please refer to the .c file for a detailed description.
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef DUMP_CODEC_H_
+#define DUMP_CODEC_H_
+
+/// Worst case encoded size of a block - one token per 128 literals.
+#define DUMP_CODEC_MAX_ENCODED_BYTES(n) ((n) + (((n) + 127u) / 128u))
+
+uint16_t    dump_codec_encode(const uint8_t * const p_input,
+                              const uint16_t input_length,
+                              uint8_t * const p_output,
+                              const uint16_t output_capacity,
+                              uint16_t * const p_consumed);
+
+#ifdef UNIT_TEST_BUILD
+
+bool_t      dump_codec_decode(const uint8_t * const p_input,
+                              const uint16_t input_length,
+                              uint8_t * const p_output,
+                              const uint16_t output_capacity,
+                              uint16_t * const p_output_length);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* DUMP_CODEC_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        erase_suspend_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for erase_suspend_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_ERASE_SUSPEND_SIM_H_
+#define HEADER_ERASE_SUSPEND_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Largest number of bytes which can be read per request.
+#define ERASE_SUSPEND_SIM_MAX_READ_BYTES    2048u
+
+/**
+ * Structure holding the erase, and the reads made while it runs.
+ */
+typedef struct
+{
+    uint32_t    erase_address;              ///< First main flash byte address erased (sector aligned).
+    uint32_t    erase_sectors;              ///< Number of sectors erased.
+    uint32_t    read_bytes;                 ///< Bytes per read request (max 2048).
+    uint32_t    polls_per_read;             ///< Erase polls between read requests.
+} erase_suspend_sim_config_t;
+
+/**
+ * Structure holding the cost of the reads made to one of the devices.
+ */
+typedef struct
+{
+    uint32_t    reads;                      ///< Read requests made.
+    uint64_t    total_us;                   ///< Simulated time in the reads.
+    uint64_t    longest_us;                 ///< Simulated time of the longest read.
+} erase_suspend_sim_reads_t;
+
+/**
+ * Structure holding the results of the erase suspend check.
+ */
+typedef struct
+{
+    bool_t                      b_erase_ok;         ///< Erase reported no error, and the range is blank.
+    uint64_t                    blocking_erase_us;  ///< Simulated time of flash_hal_device_erase.
+    uint64_t                    background_erase_us;///< Simulated time of the background erase, with reads.
+    uint32_t                    polls;              ///< Calls to flash_hal_erase_poll().
+    erase_suspend_sim_reads_t   same_die;           ///< Reads from the device being erased.
+    erase_suspend_sim_reads_t   other_die;          ///< Reads from the other device.
+    bool_t                      b_data_matches;     ///< Every read returned what is in the flash.
+    uint32_t                    erase_suspends;     ///< Erase suspends.
+    uint32_t                    erase_resumes;      ///< Erase resumes.
+    uint32_t                    early_suspends;     ///< Suspends before the erase could progress.
+    uint32_t                    suspended_sector_reads; ///< Reads from the suspended sector.
+} erase_suspend_sim_result_t;
+
+void    erase_suspend_sim_config_default(erase_suspend_sim_config_t * const p_config);
+
+bool_t  erase_suspend_sim_run(const erase_suspend_sim_config_t * const p_config,
+                              erase_suspend_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_ERASE_SUSPEND_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
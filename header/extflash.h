@@ -10,6 +10,8 @@
 
 extern	uint16_t (*EXTFLASH_ExternalFlashRead)(const uint32_t address);   			///< Pointer to the external flash read function.
 extern	void (*EXTFLASH_ExternalFlashWrite)(uint32_t address, const uint16_t data); ///< Pointer to the external flash write function.
+extern	void (*EXTFLASH_ExternalFlashBlockRead)(uint32_t address, uint32_t number_of_words,
+                                          uint16_t * const p_data);       ///< Pointer to the external flash burst read function.
 
 
 #endif /* HEADER_EXTFLASH_H_ */
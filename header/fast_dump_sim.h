@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        fast_dump_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for fast_dump_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_FAST_DUMP_SIM_H_
+#define HEADER_FAST_DUMP_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/**
+ * Structure holding the link and memory model used by the fast dump simulation.
+ */
+typedef struct
+{
+    uint32_t    baud_rate;                  ///< SSB baud rate (10 bits per character).
+    uint32_t    dump_bytes;                 ///< Number of bytes dumped.
+    uint32_t    frame_data_bytes;           ///< Data bytes per frame (max 512).
+    uint32_t    read_ns_per_byte;           ///< Logging memory read time per byte.
+    uint32_t    crc_ns_per_byte;            ///< CRC time per byte.
+    uint32_t    transmit_wait_us;           ///< Polling delay of the old blocking dump.
+    bool_t      b_overlapped;               ///< Prepare the next frame while this one is sent.
+} fast_dump_sim_config_t;
+
+/**
+ * Structure holding the results of a fast dump simulation.
+ */
+typedef struct
+{
+    uint32_t    frames;                     ///< Number of frames.
+    uint64_t    total_us;                   ///< Time until the last character has been sent.
+    uint64_t    wire_us;                    ///< Time the characters take on the wire.
+    uint64_t    prepare_us;                 ///< Total read and CRC time.
+    uint32_t    link_utilisation_percent;   ///< Wire time as a percentage of the total time.
+} fast_dump_sim_result_t;
+
+void    fast_dump_sim_config_default(fast_dump_sim_config_t * const p_config);
+
+void    fast_dump_sim_run(const fast_dump_sim_config_t * const p_config,
+                          fast_dump_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_FAST_DUMP_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -117,6 +117,48 @@ flash_hal_error_t   flash_hal_device_read
                          uint8_t * const p_read_data);
 
 
+/**
+ * flash_hal_device_verify_read reads back data which has just been written,
+ * from the device itself rather than from the serial flash or EEPROM
+ * write-behind cache.
+ *
+ * @note
+ * The logical start address is a BYTE ADDRESS.
+ *
+ * @param   logical_start_address       The logical start address for the read.
+ * @param   number_of_bytes_to_read     The number of bytes to read.
+ * @param   p_read_data                 Pointer to buffer to put read data in.
+ * @retval  flash_hal_error_t           Enumerated value for read status - a
+ *                                      write fail if the data couldn't be
+ *                                      written back into the device.
+ *
+ */
+flash_hal_error_t   flash_hal_device_verify_read
+                        (const uint32_t logical_start_address,
+                         const uint32_t number_of_bytes_to_read,
+                         uint8_t * const p_read_data);
+
+
+/**
+ * flash_hal_device_read_words converts logical to physical address and then
+ * reads whole 16 bit words, joined little-endian as by flash_hal_device_read.
+ *
+ * @note
+ * The logical start address is a BYTE ADDRESS, and must be even for the
+ * main flash.
+ *
+ * @param   logical_start_address       The logical start address for the read.
+ * @param   number_of_words_to_read     The number of 16 bit words to read.
+ * @param   p_read_data                 Pointer to buffer to put read data in.
+ * @retval  flash_hal_error_t           Enumerated value for read status.
+ *
+ */
+flash_hal_error_t   flash_hal_device_read_words
+                        (const uint32_t logical_start_address,
+                         const uint32_t number_of_words_to_read,
+                         uint16_t * const p_read_data);
+
+
 /**
  * flash_hal_device_write converts logical to physical address and then
  * calls the appropriate flash driver function to perform the write.
@@ -157,11 +199,46 @@ flash_hal_error_t   flash_hal_device_erase
                          const uint32_t number_of_bytes_to_erase);
 
 
+/**
+ * flash_hal_device_erase_start starts an erase, as flash_hal_device_erase,
+ * which then runs in the background while flash_hal_erase_poll() is called.
+ *
+ * Main flash reads and writes elsewhere while the erase is running suspend
+ * it, and resume it afterwards.  Blank checks on the same device wait for
+ * the sector being erased.  Other devices are erased straight away.
+ *
+ * @note
+ * The logical start address is a BYTE ADDRESS.
+ *
+ * @param   logical_start_address       The logical start address for the erase.
+ * @param   number_of_bytes_to_erase    The number of bytes to erase.
+ * @retval  flash_hal_error_t           FLASH_HAL_NO_ERROR if the erase was started.
+ *
+ */
+flash_hal_error_t   flash_hal_device_erase_start
+                        (const uint32_t logical_start_address,
+                         const uint32_t number_of_bytes_to_erase);
+
+
+/**
+ * flash_hal_erase_poll moves an erase started by flash_hal_device_erase_start
+ * on, a sector at a time, without waiting for the device.
+ *
+ * @param   p_erase_status  Erase status is written here once it has finished.
+ * @retval  bool_t          TRUE while the erase is still running.
+ *
+ */
+bool_t              flash_hal_erase_poll(flash_hal_error_t * const p_erase_status);
+
+
 /**
  * flash_hal_device_blank_check converts logical to physical address and then
  * calls the appropriate flash driver function to check for the device being
  * blank.
  *
+ * Main flash pages which are known to be erased are remembered, so asking
+ * again about a region which hasn't been written since doesn't read the flash.
+ *
  * @note
  * The logical start address is a BYTE ADDRESS.
  *
@@ -175,6 +252,15 @@ bool_t              flash_hal_device_blank_check
                          const uint32_t number_of_bytes_to_blank_check);
 
 
+/**
+ * flash_hal_erased_cache_invalidate forgets everything the erased cache knows
+ * about the main flash.  It must be called by anything which programs the
+ * main flash without going through flash_hal_device_write.
+ *
+ */
+void                flash_hal_erased_cache_invalidate(void);
+
+
 /**
  * flash_hal_write_timeout_callbck is the callback function for the flash
  * write timeout.
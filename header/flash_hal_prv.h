@@ -18,6 +18,34 @@ typedef struct
     uint32_t            physical_address_adjustment;
 } address_translation_t;
 
+/**
+ * Structure holding the state of a main flash erase which is running in the
+ * background - see flash_hal_device_erase_start().
+ */
+typedef struct
+{
+    bool_t              b_in_progress;      ///< Erase started and not yet finished.
+    bool_t              b_sector_running;   ///< Sector erase command issued, not yet complete.
+    bool_t              b_suspended;        ///< Sector erase suspended for a read.
+    uint32_t            word_address;       ///< First word of the sector being erased.
+    uint32_t            sectors_remaining;  ///< Sectors left to erase, including this one.
+    uint32_t            run_start_time;     ///< Stopwatch, set when the sector erase starts or resumes.
+    flash_hal_error_t   erase_status;       ///< Result, once the erase has finished.
+} flash_hal_erase_t;
+
+/**
+ * Structure holding the part of a main flash write or erase which is in one
+ * of the two devices, so that both devices can be kept busy at once.
+ */
+typedef struct
+{
+    uint32_t            device_offset;      ///< Next word to write, or next sector to erase, in the device.
+    uint32_t            words_remaining;    ///< Words left to write or erase in the device.
+    uint32_t            byte_offset;        ///< Offset of the next word in the write data.
+    uint32_t            poll_offset;        ///< Offset to poll while the device is busy.
+    bool_t              b_busy;             ///< Operation started in the device, not yet finished.
+} flash_hal_die_op_t;
+
 extern const address_translation_t* flash_hal_address_trans_ptr_get(const uint16_t partition_index);
 
 #endif /* HEADER_FLASH_HAL_PRV_H_ */
@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        flash_read_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for flash_read_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_FLASH_READ_SIM_H_
+#define HEADER_FLASH_READ_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Largest number of words which can be read per request.
+#define FLASH_READ_SIM_MAX_REQUEST_WORDS    1024u
+
+/**
+ * Structure holding the reads made by the main flash read benchmark.
+ */
+typedef struct
+{
+    uint32_t    start_word_address;         ///< First main flash word address read.
+    uint32_t    number_of_words;            ///< Number of words read.
+    uint32_t    request_words;              ///< Words per read request (max 1024).
+} flash_read_sim_config_t;
+
+/**
+ * Structure holding the cost of reading with one of the read paths.
+ */
+typedef struct
+{
+    uint32_t    requests;                   ///< Number of read requests made.
+    uint32_t    bus_reads;                  ///< XINTF read cycles.
+    uint32_t    address_setups;             ///< GPIO[26:20] set ups.
+    uint64_t    bus_ns;                     ///< Simulated time spent on the bus.
+    uint64_t    host_ns;                    ///< Host processor time.
+} flash_read_sim_path_t;
+
+/**
+ * Structure holding the results of the main flash read benchmark.
+ */
+typedef struct
+{
+    flash_read_sim_path_t   word_loop;      ///< One lld_ReadOp per word, as before.
+    flash_read_sim_path_t   burst_bytes;    ///< flash_hal_device_read.
+    flash_read_sim_path_t   burst_words;    ///< flash_hal_device_read_words.
+    bool_t                  b_data_matches; ///< All three paths read the same data.
+} flash_read_sim_result_t;
+
+void    flash_read_sim_config_default(flash_read_sim_config_t * const p_config);
+
+bool_t  flash_read_sim_run(const flash_read_sim_config_t * const p_config,
+                           flash_read_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_FLASH_READ_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
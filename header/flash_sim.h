@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        flash_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for flash_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_FLASH_SIM_H_
+#define HEADER_FLASH_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+#include "rsappconfig.h"
+
+/**
+ * Structure holding the timing model used by the simulated storage devices.
+ *
+ * @note
+ * Bus accesses are specified in nanoseconds, embedded (internal) operations
+ * in microseconds.  The defaults are the typical datasheet values for the
+ * S29GL01GS, M95512 and 24LC32A, and the address setup is the time the F28335
+ * takes to update GPIO[26:20] through GPADAT and GPATOGGLE.  The SPI register
+ * access includes the driver code around it, which is what the FIFOs hide.
+ */
+typedef struct
+{
+    uint32_t    main_flash_access_ns;           ///< One XINTF read or write cycle.
+    uint32_t    main_flash_address_setup_ns;    ///< Setting up GPIO[26:20] before an access.
+    uint32_t    main_flash_poll_quantum_ns;     ///< Time which passes per status poll while busy.
+    uint32_t    main_flash_word_program_us;     ///< Single word program time.
+    uint32_t    main_flash_buffer_program_us;   ///< Write buffer program time.
+    uint32_t    main_flash_sector_erase_us;     ///< Sector erase time (chip erase is per sector).
+    uint32_t    main_flash_blank_check_us;      ///< Sector blank check time.
+    uint32_t    main_flash_erase_suspend_us;    ///< Erase suspend latency.
+    uint32_t    main_flash_resume_to_suspend_us;    ///< Erase must run this long after a resume to progress.
+    uint32_t    spi_bit_ns;                     ///< SPI bit time.
+    uint32_t    spi_register_access_ns;         ///< SPI-A register access, with the code around it.
+    uint32_t    m95_page_write_us;              ///< M95 write cycle time (tW).
+    uint32_t    i2c_bit_ns;                     ///< I2C bit time.
+    uint32_t    x24lc32a_page_write_us;         ///< 24LC32A write cycle time (tWC).
+} flash_sim_timing_t;
+
+/**
+ * Structure holding the access counters for the simulated storage devices.
+ */
+typedef struct
+{
+    uint32_t    main_flash_bus_reads;           ///< XINTF read cycles.
+    uint32_t    main_flash_bus_writes;          ///< XINTF write cycles (commands and data).
+    uint32_t    main_flash_address_setups;      ///< GPIO[26:20] set ups.
+    uint32_t    main_flash_status_polls;        ///< Status reads made while a die was busy.
+    uint32_t    main_flash_program_operations;  ///< Word and write buffer program operations.
+    uint32_t    main_flash_words_programmed;    ///< Words programmed.
+    uint32_t    main_flash_bit_raise_attempts;  ///< Words which tried to program a 0 back to 1.
+    uint32_t    main_flash_sector_erases;       ///< Sectors erased (chip erase counts every sector).
+    uint32_t    main_flash_blank_checks;        ///< Sector blank check operations.
+    uint32_t    main_flash_erase_suspends;      ///< Sector erases suspended.
+    uint32_t    main_flash_erase_resumes;       ///< Sector erases resumed.
+    uint32_t    main_flash_early_suspends;      ///< Suspends too soon after a resume (erase lost the time).
+    uint32_t    main_flash_suspended_sector_reads;  ///< Reads from a sector whose erase is suspended.
+    uint32_t    main_flash_suspended_programs;  ///< Programs made while an erase is suspended.
+    uint32_t    m95_bytes_read;                 ///< Bytes read from the M95 array.
+    uint32_t    m95_bytes_written;              ///< Bytes written into the M95 array.
+    uint32_t    m95_write_cycles;               ///< M95 write cycles started.
+    uint32_t    x24lc32a_bytes_read;            ///< Bytes read from the 24LC32A array.
+    uint32_t    x24lc32a_bytes_written;         ///< Bytes written into the 24LC32A array.
+    uint32_t    x24lc32a_write_cycles;          ///< 24LC32A write cycles started.
+} flash_sim_stats_t;
+
+void        flash_sim_install(void);
+void        flash_sim_uninstall(void);
+void        flash_sim_reset(void);
+
+void        flash_sim_timing_set(const flash_sim_timing_t * const p_timing);
+void        flash_sim_timing_get(flash_sim_timing_t * const p_timing);
+void        flash_sim_strict_programming_set(const bool_t b_strict);
+
+uint64_t    flash_sim_time_ns_get(void);
+void        flash_sim_time_advance(const uint32_t nanoseconds);
+
+void        flash_sim_stats_get(flash_sim_stats_t * const p_stats);
+void        flash_sim_stats_clear(void);
+
+bool_t      flash_sim_backdoor_read(const storage_devices_t device,
+                                    const uint32_t physical_address,
+                                    const uint32_t number_of_bytes,
+                                    uint8_t * const p_buffer);
+
+bool_t      flash_sim_backdoor_write(const storage_devices_t device,
+                                     const uint32_t physical_address,
+                                     const uint32_t number_of_bytes,
+                                     const uint8_t * const p_buffer);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_FLASH_SIM_H_ */
@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        format_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for format_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_FORMAT_SIM_H_
+#define HEADER_FORMAT_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Largest TDR written into the other partition.
+#define FORMAT_SIM_MAX_TDR_BYTES    256u
+
+/**
+ * Structure holding the format and the traffic run alongside it.
+ */
+typedef struct
+{
+    uint8_t     format_partition_index;     ///< Partition to format, a step at a time.
+    uint8_t     traffic_partition_index;    ///< Partition written and read between steps.
+    uint16_t    writes_per_step;            ///< Records written (and read back) per step.
+    uint16_t    tdr_bytes;                  ///< Size of each TDR (max FORMAT_SIM_MAX_TDR_BYTES).
+} format_sim_config_t;
+
+/**
+ * Structure holding the results of the format.
+ */
+typedef struct
+{
+    rs_error_t  format_status;              ///< Result of the format.
+    uint32_t    steps;                      ///< Calls to rspartition_format_step().
+    uint64_t    format_us;                  ///< Simulated time in the format steps.
+    uint64_t    longest_step_us;            ///< Simulated time of the longest step.
+    bool_t      b_progress_ok;              ///< Progress never went back, and ended at 100.
+    uint32_t    traffic_writes;             ///< Records written into the other partition.
+    uint32_t    traffic_write_failures;     ///< Writes into the other partition which failed.
+    uint32_t    traffic_read_mismatches;    ///< Records which didn't read back as written.
+    uint32_t    writes_not_refused;         ///< Writes into the formatting partition which weren't refused.
+    bool_t      b_partition_usable;         ///< Formatted partition is empty and ready to use.
+} format_sim_result_t;
+
+void    format_sim_config_default(format_sim_config_t * const p_config);
+
+bool_t  format_sim_run(const format_sim_config_t * const p_config,
+                       format_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_FORMAT_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
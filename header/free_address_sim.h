@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        free_address_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for free_address_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_FREE_ADDRESS_SIM_H_
+#define HEADER_FREE_ADDRESS_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Number of fill levels the pages are built at - 0, 10, 25, 50, 75 and 100%.
+#define FREE_ADDRESS_SIM_FILL_LEVELS    6u
+
+/// Largest area which can be searched.
+#define FREE_ADDRESS_SIM_MAX_AREA_BYTES (RS_CFG_PAGE_SIZE_KB * 1024u)
+
+/**
+ * Structure holding the pages built by the next free address benchmark.
+ */
+typedef struct
+{
+    uint32_t    area_logical_address;       ///< Start of the area in the main flash (even).
+    uint32_t    area_bytes;                 ///< Size of the area, normally a page data area.
+    uint32_t    pages_per_level;            ///< Random pages built at each fill level.
+    uint16_t    max_tdr_bytes;              ///< Largest TDR written (max RS_CFG_MAX_TDR_SIZE_BYTES).
+    uint16_t    ff_run_percent;             ///< Chance of each TDR byte starting a run of 0xFF.
+    uint16_t    spanning_percent;           ///< Chance of a page starting with the end of an RSR.
+    uint32_t    seed;                       ///< Random number seed.
+} free_address_sim_config_t;
+
+/**
+ * Structure holding the results for the pages built at one fill level.
+ */
+typedef struct
+{
+    uint16_t    fill_percent;               ///< How full the pages were.
+    uint32_t    pages;                      ///< Number of pages searched.
+    uint32_t    probe_bus_reads;            ///< XINTF reads made by rssearch_find_next_free_address.
+    uint32_t    linear_bus_reads;           ///< XINTF reads made by the linear search.
+    uint64_t    probe_bus_ns;               ///< Simulated time for rssearch_find_next_free_address.
+    uint64_t    linear_bus_ns;              ///< Simulated time for the linear search.
+    uint32_t    fallbacks;                  ///< Pages which the probe search left to the linear search.
+    uint32_t    mismatches;                 ///< Pages where either search missed the end of the data.
+} free_address_sim_level_t;
+
+/**
+ * Structure holding the results of the next free address benchmark.
+ */
+typedef struct
+{
+    free_address_sim_level_t    level[FREE_ADDRESS_SIM_FILL_LEVELS];
+    uint32_t                    mismatches; ///< Total over all the fill levels.
+} free_address_sim_result_t;
+
+void    free_address_sim_config_default(free_address_sim_config_t * const p_config);
+
+bool_t  free_address_sim_run(const free_address_sim_config_t * const p_config,
+                             free_address_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_FREE_ADDRESS_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
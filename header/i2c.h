@@ -19,6 +19,37 @@ typedef enum
 	I2C_UNKNOWN_ERROR = 5                   ///< Some unknown error.
 } EI2CStatus_t;
 
+/// Number of transactions the I2C transaction queue can hold.
+#define I2C_TRANSACTION_QUEUE_SIZE	8u
+
+/// Enumerated values for the type of a queued I2C transaction.
+typedef enum
+{
+	I2C_TRANSACTION_READ = 0,               ///< Read, as I2C_Read.
+	I2C_TRANSACTION_WRITE = 1,              ///< Write, as I2C_Write.
+	I2C_TRANSACTION_ACK_POLL = 2            ///< Acknowledgement poll, one poll per step.
+} EI2CTransactionType_t;
+
+/// Function called when a queued transaction has finished, with its status.
+typedef void (*I2CTransactionCallback_t)(void * const p_context, const EI2CStatus_t Status);
+
+/**
+ * Structure holding a queued I2C transaction.  The data buffer must stay
+ * valid until the callback has been called.
+ */
+typedef struct
+{
+	EI2CTransactionType_t		Type;           ///< What to do.
+	uint16_t					SlaveAddress;   ///< Slave address of device on the I2C bus.
+	uint16_t					DeviceAddress;  ///< Start address within the device (not ack poll).
+	uint16_t					DataCount;      ///< Number of bytes to transfer (not ack poll).
+	uint8_t *					p_read_data;    ///< Buffer to read into (read only).
+	const uint8_t *				p_write_data;   ///< Buffer to write from (write only).
+	uint16_t					MaxPolls;       ///< Ack poll limit - zero waits for the force timeout flag, without a limit.
+	I2CTransactionCallback_t	p_callback;     ///< Called on completion, or NULL.
+	void *						p_context;      ///< Passed to the callback.
+} I2CTransaction_t;
+
 bool_t				I2C_Open(const uint32_t iSysClk_Hz, const uint32_t iDataRate);
 void 				I2C_Close(void);
 
@@ -39,6 +70,10 @@ extern EI2CStatus_t	(*I2C_AckPoll)(uint16_t SlaveAddress, uint16_t MaxTimeout);
 
 void                I2C_AckPollTimeoutFlagSet(void);
 
+bool_t              I2C_TransactionQueue(const I2CTransaction_t * const p_transaction);
+bool_t              I2C_TransactionStep(void);
+uint16_t            I2C_TransactionCountGet(void);
+
 
 
 #endif /* HEADER_I2C_H_ */
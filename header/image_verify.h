@@ -0,0 +1,66 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        image_verify.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for image_verify.c
+ * @note        Please refer to the .c file for a detailed description.
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef IMAGE_VERIFY_H_
+#define IMAGE_VERIFY_H_
+
+/**
+ * Structure holding a verified image descriptor, as read back from flash.
+ */
+typedef struct
+{
+    uint16_t    Partition;              ///< Partition number of the image.
+    uint32_t    Generation;             ///< Flash programming generation.
+    uint32_t    LengthInWords;          ///< Length covered by the CRC.
+    uint16_t    ImageCRC;               ///< CRC of the image when verified.
+} ImageDescriptor_t;
+
+/**
+ * Structure holding an image CRC which is calculated a step at a time.
+ */
+typedef struct
+{
+    uint32_t    NextAddress;            ///< Next address to include in the CRC.
+    uint32_t    WordsRemaining;         ///< Words still to include in the CRC.
+    uint16_t    RunningCRC;             ///< CRC so far, final CRC once complete.
+    bool_t      bComplete;              ///< All words included and CRC finished.
+} ImageVerifyCRC_t;
+
+bool_t  ImageVerify_DescriptorGet(const uint16_t Partition,
+                                  ImageDescriptor_t* const pDescriptor);
+
+bool_t  ImageVerify_DescriptorTrustedCheck(const uint16_t Partition,
+                                           const uint32_t LengthInWords,
+                                           const uint16_t ExpectedCRC);
+
+bool_t  ImageVerify_DescriptorWrite(const uint16_t Partition,
+                                    const uint32_t LengthInWords,
+                                    const uint16_t ImageCRC);
+
+bool_t  ImageVerify_DescriptorRetire(const uint16_t Partition);
+
+bool_t  ImageVerify_LogFullCheck(void);
+
+void    ImageVerify_CRCStart(ImageVerifyCRC_t* const pCRC,
+                             const uint32_t StartAddress,
+                             const uint32_t LengthInWords);
+
+bool_t  ImageVerify_CRCStep(ImageVerifyCRC_t* const pCRC,
+                            const uint32_t MaximumWords);
+
+#endif /* IMAGE_VERIFY_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
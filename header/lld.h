@@ -202,6 +202,8 @@ typedef enum
 				 */
                 #define FLASH_WR(b,o,d) ( (b == DEVICE_ZERO_BASE) ? EXTFLASH_ExternalFlashWrite( 0x00000000u + (ADDRESS)o, d) : EXTFLASH_ExternalFlashWrite( 0x04000000u + (ADDRESS)o, d) )
                 #define FLASH_RD(b,o)   ( (b == DEVICE_ZERO_BASE) ? EXTFLASH_ExternalFlashRead ( 0x00000000u + (ADDRESS)o)    : EXTFLASH_ExternalFlashRead ( 0x04000000u + (ADDRESS)o)    )
+                /* Burst read of n words into p, the die is chosen once. */
+                #define FLASH_BLOCK_RD(b,o,n,p) ( (b == DEVICE_ZERO_BASE) ? EXTFLASH_ExternalFlashBlockRead ( 0x00000000u + (ADDRESS)o, n, p) : EXTFLASH_ExternalFlashBlockRead ( 0x04000000u + (ADDRESS)o, n, p) )
             #else
                 #define FLASH_WR(b,o,d) FLASH_OFFSET((b),(o)) = (d)
                 #define FLASH_RD(b,o)   FLASH_OFFSET((b),(o))
@@ -346,6 +348,14 @@ extern FLASHDATA lld_ReadOp
 FLASHDATA * base_addr,			/* device base address is system */
 ADDRESS offset					/* address offset from base address */
 );
+
+extern void lld_BlockReadOp
+(
+FLASHDATA * base_addr,			/* device base address is system */
+ADDRESS offset,					/* address offset from base address */
+ADDRESS number_of_words,		/* number of words to read */
+FLASHDATA * data_buf			/* buffer to put the read data in */
+);
 #endif 
 
 #ifdef LLD_WRITE_BUFFER_OP
@@ -364,6 +374,14 @@ ADDRESS offset,                 /* address offset from base address */
 WORDCOUNT word_count,           /* number of words to program */
 const BYTE * const p_data_buf   /* buffer containing data to program as bytes */
 );
+
+extern ADDRESS lld_WriteByteBufferCmd
+(
+FLASHDATA * base_addr,          /* device base address is system */
+ADDRESS offset,                 /* address offset from base address */
+WORDCOUNT word_count,           /* number of words to program, not zero */
+const BYTE * const p_data_buf   /* buffer containing data to program as bytes */
+);
 #endif
 
 #ifdef LLD_POLL_TOGGLE_AS_STATUS_API
@@ -32,9 +32,13 @@ bool_t 		M95_ReadIDCommandSend(const uint32_t StartAddress,
 
 EM95PollStatus_t M95_WriteCompletePoll(void);
 
-void        M95_BlockRead(const uint32_t StartAddress,
-                            const uint32_t NumberOfReads,
-                            uint8_t * const p_dest_buffer);
+EM95PollStatus_t M95_BlockRead(const uint32_t StartAddress,
+                                const uint32_t NumberOfReads,
+                                uint8_t * const p_dest_buffer);
+
+EM95PollStatus_t M95_VerifyRead(const uint32_t StartAddress,
+                                const uint32_t NumberOfReads,
+                                uint8_t * const p_dest_buffer);
 
 EM95PollStatus_t M95_BlockWrite(const uint32_t StartAddress,
                                     const uint32_t NumberOfWrites,
@@ -52,6 +56,9 @@ uint32_t 			M95_DevicePageSizeGet(void);
 uint32_t 			M95_DeviceTotalSizeGet(void);
 EM95PollStatus_t	M95_DeviceErase(void);
 
+bool_t              M95_FlushStep(void);
+EM95PollStatus_t    M95_Flush(void);
+
 void                M95_ForceTimeoutFlagSet(void);
 
 #endif /* HEADER_M95_H_ */
@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        m95_cache_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for m95_cache_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_M95_CACHE_SIM_H_
+#define HEADER_M95_CACHE_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Largest number of bytes which can be written.
+#define M95_CACHE_SIM_MAX_BYTES     4096u
+
+/**
+ * Structure holding the write made by the serial flash cache benchmark.
+ */
+typedef struct
+{
+    uint32_t    address;                    ///< First serial flash address written.
+    uint32_t    write_bytes;                ///< Bytes written (max 4096).
+    uint32_t    patch_bytes;                ///< Bytes written again, half way through, before the flush.
+    uint32_t    idle_us;                    ///< Idle time between calls to M95_FlushStep().
+} m95_cache_sim_config_t;
+
+/**
+ * Structure holding the results of the serial flash cache benchmark.
+ */
+typedef struct
+{
+    uint64_t    blocking_write_us;          ///< M95_BlockWrite, a page at a time.
+    uint64_t    cached_write_us;            ///< M95_memcpy, returning once the data is cached.
+    uint64_t    flush_us;                   ///< Background write back by M95_FlushStep().
+    uint32_t    flush_steps;                ///< Calls to M95_FlushStep() until the cache was empty.
+    uint32_t    blocking_write_cycles;      ///< Device write cycles for the blocking write.
+    uint32_t    cached_write_cycles;        ///< Device write cycles for the cached write and patch.
+    bool_t      b_cache_reads_match;        ///< Reads before the flush returned the data written.
+    bool_t      b_data_matches;             ///< Both writes left the data in the device.
+} m95_cache_sim_result_t;
+
+void    m95_cache_sim_config_default(m95_cache_sim_config_t * const p_config);
+
+bool_t  m95_cache_sim_run(const m95_cache_sim_config_t * const p_config,
+                          m95_cache_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_M95_CACHE_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
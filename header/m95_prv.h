@@ -16,10 +16,27 @@
 #ifndef ACQMTC_DSP_B_M95_PRV_H_
 #define ACQMTC_DSP_B_M95_PRV_H_
 
+#define M95_MAX_PAGE_SIZE           256u        ///< Maximum possible page size.
+#define M95_CACHE_PAGES             8u          ///< Pages held by the write-behind cache.
+
+/**
+ * Structure holding one page of the write-behind cache - the bytes from
+ * first_offset up to (but not including) end_offset are waiting to be
+ * written into the device.
+ */
+typedef struct
+{
+    uint32_t    page_address;                   ///< First device address of the page.
+    uint32_t    first_offset;                   ///< Offset of the first byte waiting.
+    uint32_t    end_offset;                     ///< Offset after the last byte waiting.
+    uint8_t     data[M95_MAX_PAGE_SIZE];        ///< Page data (only the bytes waiting are valid).
+} m95_cache_page_t;
+
 #ifdef UNIT_TEST_BUILD
 
 void M95_ForceTimeoutFlagReset_TDD(void);
 void M95_MemcpyFunctionPtrReset_TDD(void);
+void M95_CacheDiscard_TDD(void);
 
 #endif
 
@@ -11,10 +11,24 @@
 #include "loader_state.h"
 #include "timer.h"
 #include "comm.h"
+
+/**
+ * Time (in milliseconds) spent formatting for each message, before replying
+ * with LOADER_FORMAT_IN_PROGRESS.  At least one block is erased per message.
+ */
+#define OPCODE013_TIME_SLICE_MS 50u
+
 /**
  * Executes opcode 13.
  * 
  */
 void opcode13_execute(ELoaderState_t * loaderState, LoaderMessage_t * message, Timer_t* timer);
 
+/**
+ * Carries on with a format started by opcode 13, a step at a time.  Called
+ * whenever the loader is waiting for a message.
+ *
+ */
+bool_t opcode13_FormatStep(void);
+
 #endif   // OPCODE013_H
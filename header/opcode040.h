@@ -0,0 +1,62 @@
+/**
+ * \file
+ * Definition of opcode 40 (windowed download)
+ *
+ * @author Fei Li
+ * @date 16 October 2026
+ *
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work,
+ * created 2026.  This computer program includes confidential,
+ * proprietary information and is a trade secret of Xi'an Shiyou Univ.
+ * DD Lab.  All use, disclosure, and/or reproduction is
+ * prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+
+#ifndef OPCODE040_H
+#define OPCODE040_H
+#include "loader_state.h"
+#include "timer.h"
+#include "comm.h"
+
+/**
+ * Subfield of opcode40 which starts a windowed download, setting the next
+ * expected sequence number to zero.  No other data.
+ */
+#define OPCODE40_START 0
+
+/**
+ * Subfield of opcode40 which carries one frame of download data.  Followed by
+ * the sequence number (2 bytes), the address (4 bytes) and the data (an even
+ * number of bytes, up to the size of the receive buffer).  No reply is sent.
+ */
+#define OPCODE40_DATA 1
+
+/**
+ * Subfield of opcode40 which ends a window.  Followed by the sequence number
+ * of the last data frame sent (2 bytes).  The reply holds the next expected
+ * sequence number (2 bytes) and a bitmap of the missing frames (2 bytes).
+ */
+#define OPCODE40_WINDOW_END 2
+
+/**
+ * Maximum number of data frames which can be outstanding - one bit for each
+ * frame in the missing frame bitmap.
+ */
+#define OPCODE40_WINDOW_FRAMES 16u
+
+/**
+ * Space in the download buffer (in words) reserved for each frame in the window.
+ */
+#define OPCODE40_FRAME_WORDS 256u
+
+/**
+ * Executes opcode 40 (windowed download)
+ *
+ * @param loaderState The current state of the program
+ * @param message Pointer to the received message
+ * @param timer Pointer to the current Timer running in the Loader
+ */
+void opcode40_execute(ELoaderState_t* loaderState, LoaderMessage_t* message, Timer_t* timer);
+
+#endif   // OPCODE040_H
@@ -8,16 +8,13 @@
 #ifndef HEADER_OPCODE046_H_
 #define HEADER_OPCODE046_H_
 
-/// Enumerated the fast dump state machine.
+/// Enumerated the fast dump engine states.
 typedef enum
 {
-	FAST_DUMP_INITIAL 		= 0,			///< Initial state.
-	FAST_DUMP_FIRST_FRAME 	= 1,			///< Send the first frame.
-	FAST_DUMP_EVEN_FRAME	= 2,			///< Send an even frame.
-	FAST_DUMP_ODD_FRAME		= 3,			///< Send an odd frame.
-	FAST_DUMP_LAST_FRAME	= 4,			///< Send the last frame.
-	FAST_DUMP_END			= 5				///< Last step.
-}sendFrameState_t;
+	FAST_DUMP_IDLE 			= 0,			///< No dump in progress.
+	FAST_DUMP_RUNNING 		= 1,			///< Frames being read and sent.
+	FAST_DUMP_DRAINING		= 2				///< Waiting for the last character to go.
+}fastDumpState_t;
 
 typedef enum
 {
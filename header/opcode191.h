@@ -16,6 +16,36 @@
 #ifndef OPCODE191_H
 #define OPCODE191_H
 
+/**
+ * Subfield of opcode191 which starts the CRC of a partition.  Followed by the
+ * partition number (2 bytes).
+ */
+#define OPCODE191_PARTITION 0
+
+/**
+ * Subfield of opcode191 which starts the CRC of an address range.  Followed by
+ * the start address (4 bytes) and the length in words (4 bytes), which must lie
+ * within the flash or the OTP.
+ */
+#define OPCODE191_RANGE 1
+
+/**
+ * Subfield of opcode191 which is used to poll the loader for the result after
+ * sending OPCODE191_PARTITION or OPCODE191_RANGE.
+ */
+#define OPCODE191_POLL 2
+
+/**
+ * Time (in milliseconds) spent calculating the CRC for each message, before
+ * replying with LOADER_FORMAT_IN_PROGRESS.
+ */
+#define OPCODE191_TIME_SLICE_MS 50u
+
+/**
+ * Number of words of CRC calculated between checks of the time slice.
+ */
+#define OPCODE191_CHUNK_WORDS 1024u
+
 /**
  * Executes opcode 191 ( compute program CRC )
  * 
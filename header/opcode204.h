@@ -23,6 +23,8 @@
 void opcode204_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,
                        Timer_t* timer) ;
 
+void opcode204_DpointTableInvalidate(void);
+
 #endif
 
 // ----------------------------------------------------------------------------
@@ -17,6 +17,13 @@
 #ifndef PROM_HARDWARE_H
 #define PROM_HARDWARE_H
 
+//Partition numbers
+#define BOOT_PARTITION			0 		//boot-loader's partition number
+#define APPLICATION_PARTITION	1 		//application's partition number
+#define PARAMETER_PARTITION		2		//parameter's partition number
+#define CONFIG_PARTITION		3		//configuration's partition number
+#define UNDEFINED_PARTITION		0xFF 	//undefined partition number (initialize to this)
+
 typedef struct PartitionParameters
 {
 	uint16_t		PartitionNumber;
@@ -31,6 +38,9 @@ typedef struct PartitionParameters
 } PartitionParameters_t;
 
 bool_t PromHardware_ProgramMemoryWrite(Uint8* pData, Uint32 LengthInBytes, Uint32 StartAddressInFlash);
+bool_t PromHardware_ProgramMemoryStage(Uint8* pData, Uint32 LengthInBytes, Uint32 StartAddressInFlash, Uint32 BufferOffset);
+bool_t PromHardware_StagedMemoryProgram(Uint32 StartAddressInFlash, Uint32 LengthInWords, Uint32 BufferOffset);
+bool_t PromHardware_PendingProgramComplete(void);
 bool_t PromHardware_isValidPartition( Uint16 partition );
 Uint16 PromHardware_PartitionPrepare( Uint16 partition ) ;
 bool_t PromHardware_isPartitionPrepared( void ) ;
@@ -39,6 +49,7 @@ Uint16 PromHardware_PartitionProgram( void ) ;
 bool_t PromHardware_isPartitionProgrammed( void ) ;
 bool_t PromHardware_PartitionCRCCalculate( Uint16 partition, Uint16 * crc ) ;
 bool_t PromHardware_PartitionCRCGetExpected( Uint16 partition, Uint16 * expectedCRC ) ;
+bool_t PromHardware_PartitionRangeGet( Uint16 partition, Uint32 * pStartAddress, Uint32 * pLength ) ;
 bool_t PromHardware_ProgramMemoryRead(Uint8* pData, Uint32 LengthInBytes, Uint32 Address);
 void   PromHardware_AllowBootloaderProgrammingFlagSet(bool_t Allow);
 void   PromHardware_AllowIncrementalFlashWriteFlagSet(bool_t Allow);
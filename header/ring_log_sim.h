@@ -0,0 +1,69 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        ring_log_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for ring_log_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_RING_LOG_SIM_H_
+#define HEADER_RING_LOG_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Largest TDR written into the ring log.
+#define RING_LOG_SIM_MAX_TDR_BYTES  RS_CFG_MAX_TDR_SIZE_BYTES
+
+/**
+ * Structure holding the ring log and the records written into it.
+ */
+typedef struct
+{
+    uint8_t     partition_index;            ///< Partition to use as a ring log.
+    uint32_t    ring_pages;                 ///< Pages in the ring log (made up to whole blocks).
+    uint16_t    tdr_bytes;                  ///< Size of each TDR (even, max RING_LOG_SIM_MAX_TDR_BYTES).
+    uint32_t    wraps;                      ///< Times the records go round the ring log.
+    uint32_t    write_interval_us;          ///< Simulated time between records.
+    uint16_t    read_stride;                ///< Records between the ones read back.
+} ring_log_sim_config_t;
+
+/**
+ * Structure holding the results of the ring log check.
+ */
+typedef struct
+{
+    uint32_t    records_written;            ///< Records written.
+    uint32_t    write_failures;             ///< Writes which failed.
+    uint64_t    total_write_us;             ///< Simulated time in the writes.
+    uint64_t    longest_write_us;           ///< Simulated time of the longest write.
+    bool_t      b_mount_matches;            ///< Restart found the same head, and page counts.
+    bool_t      b_no_index;                 ///< No record index was reserved or used.
+    uint32_t    records_kept;               ///< Records from the oldest to the newest.
+    bool_t      b_ends_ok;                  ///< Oldest and newest records found both ways.
+    uint32_t    reads;                      ///< Records read back.
+    uint32_t    read_mismatches;            ///< Records which didn't read back as written.
+    uint32_t    bit_raise_attempts;         ///< Programs into flash which wasn't erased.
+    uint32_t    sector_erases;              ///< Sectors erased, including the format.
+    uint32_t    erase_suspends;             ///< Background erases suspended.
+    uint32_t    suspended_programs;         ///< Programs made while an erase was suspended.
+} ring_log_sim_result_t;
+
+void    ring_log_sim_config_default(ring_log_sim_config_t * const p_config);
+
+bool_t  ring_log_sim_run(const ring_log_sim_config_t * const p_config,
+                         ring_log_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_RING_LOG_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
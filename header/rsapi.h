@@ -40,6 +40,7 @@ typedef enum
     RS_ERR_BAD_WRITE_QUEUE          = 10,
     RS_ERR_READ_WRITE_TASK_RUNNING  = 11,
     RS_ERR_BAD_FORMAT_QUEUE         = 12,
+    RS_ERR_FORMAT_IN_PROGRESS       = 13,
     RS_ERR_UNIT_TEST_DEFAULT_VAL    = 1000
 } rs_error_t;
 
@@ -195,6 +196,23 @@ typedef struct
 } rs_format_request_t;
 
 
+/*!
+ * Batched write request structure.
+ *
+ * This groups a number of write requests for the same partition so that
+ * they can be written into the recording memory together.  Each write
+ * request follows the same rules as for rsapi_write_request(), and has its
+ * status (and semaphore) updated individually.
+ *
+ */
+typedef struct
+{
+    uint8_t                 partition_id;           ///< ID of partition to write into.
+    rs_write_request_t *    p_write_requests;       ///< Pointer to array of write requests.
+    uint16_t                number_of_requests;     ///< Number of write requests in the array.
+} rs_write_batch_request_t;
+
+
 bool_t      rsapi_recording_system_init(void);
 
 rs_error_t  rsapi_partition_format_request
@@ -208,6 +226,9 @@ rs_error_t  rsapi_read_request(const rs_read_request_t * const p_read_request);
 
 rs_error_t  rsapi_write_request(const rs_write_request_t * const p_write_request);
 
+rs_error_t  rsapi_write_batch_request
+                        (const rs_write_batch_request_t * const p_batch_request);
+
 void        rsapi_readwrite_task(void * p_task_parameters);
 
 bool_t      rsapi_query_if_task_enabled(void);
@@ -216,6 +237,8 @@ void        rsapi_task_enable(void);
 
 void        rsapi_task_disable(void * const p_disable_semaphore);
 
+bool_t      rsapi_mount_record_write(void);
+
 const rs_configuration_t*   rsapi_configuration_pointer_get(void);
 
 uint16_t    rsapi_queue_items_waiting_get(const rs_queue_identifiers_t identifier);
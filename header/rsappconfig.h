@@ -92,6 +92,69 @@
 #define RS_CFG_WRITE_QUEUE_TIMEOUT_MS       100u
 
 
+/**
+ * Define the record index checkpoint interval.
+ * For partitions which have an index area, a checkpoint (record number,
+ * logical address of the RSR and the instances of each record ID written
+ * before it) is appended to the index area for the first record written and
+ * then for every RS_CFG_INDEX_RECORD_INTERVAL records after that.  A read
+ * never has to step over more than this many records once it has found the
+ * nearest checkpoint.
+ */
+#define RS_CFG_INDEX_RECORD_INTERVAL        32u
+
+
+/**
+ * Define the number of record IDs counted by each record index.
+ * The first RS_CFG_INDEX_RECORD_IDS record IDs written into a partition have
+ * their instances counted in every checkpoint, so a search for an instance of
+ * one of them is a bisection search on the index area.  A search for any
+ * other record ID uses the normal search.  Each ID adds 6 bytes to every
+ * checkpoint.
+ */
+#define RS_CFG_INDEX_RECORD_IDS             6u
+
+
+/**
+ * Define the size of the staging buffer used for batched writes, in bytes.
+ * Consecutive RSRs are assembled in this buffer and then programmed into
+ * the flash with a single write, so it is best kept to a multiple of the
+ * main flash write buffer (512 bytes).
+ */
+#define RS_CFG_BATCH_STAGING_SIZE_BYTES     1024u
+
+
+/**
+ * Define the maximum number of write requests in a single batch.
+ */
+#define RS_CFG_BATCH_MAX_RECORDS            16u
+
+
+/**
+ * Define the number of blocks reserved for the mount record area, which
+ * follows the last partition (in the same device).  The blocks are used in
+ * turn, so there must be at least two.  Set to zero for no mount records,
+ * in which case every partition is searched at startup.
+ */
+#define RS_CFG_MOUNT_RECORD_BLOCKS          2u
+
+
+/**
+ * Define how often a mount record is written, as a number of records written
+ * into the recording system.  Mount records are also written after a format,
+ * on request (i.e. clean shutdown) and at startup if a search was needed.
+ * Set to zero to only write mount records at these times.
+ */
+#define RS_CFG_MOUNT_RECORD_INTERVAL        256u
+
+
+/**
+ * Define how many bytes from the next free address (as stored in the mount
+ * record) must be blank for a partition to be restored without a search.
+ */
+#define RS_CFG_MOUNT_TAIL_CHECK_BYTES       32u
+
+
 /**
  * Enumerated type for all storage devices
  * which could be used by the recording system.
@@ -119,9 +182,11 @@ typedef enum
 /**
  * Partition settings - these are loaded into an array of structures,
  * of type rs_partition_info_t (see rspartition.h).
- * Only the first three elements of the structure need to be initialised here,
- * the partition ID, the number of pages in the partition and the device in
- * which the partition is to be stored.
+ * Only the first five elements of the structure need to be initialised here,
+ * the partition ID, the number of pages in the partition, the device in
+ * which the partition is to be stored, the number of pages to reserve
+ * for the record index (zero for no index) and whether the partition is a
+ * ring log (circular).
  * All other values are setup by the recording system itself, so can be
  * initialised to zero or a default value.
  *
@@ -134,21 +199,40 @@ typedef enum
  * by increasing the number of pages, otherwise it would not be possible to
  * erase a partition without partially erasing the adjacent partition.
  *
+ * @note
+ * The record index pages are placed immediately after the data pages of the
+ * partition and are rounded up to whole blocks in the same way.  They are
+ * not visible as recording system pages (there are no page headers in the
+ * index area), but they are erased whenever the partition is formatted.
+ *
+ * @note
+ * A circular partition never fills up - once the last page has been written
+ * the oldest data is erased, a block at a time, and the pages are used again
+ * (see rspartition.c).  It needs at least three blocks, otherwise it is used
+ * as a normal partition.  Changing a partition to or from circular means
+ * that it has to be formatted again.  A circular partition never has a record
+ * index, as the oldest records are erased from under it, so any index pages
+ * given for it are ignored.
+ *
+ * @note
+ * The mount record area (RS_CFG_MOUNT_RECORD_BLOCKS) follows the last
+ * partition, so leave room for it after the last partition.
+ *
  * @warning
  * It is the responsibility of whoever is setting up this file to ensure
  * that the partition settings used will actually fit in the physical space
  * available.
  *
  */
-#define RS_CFG_PARTITION_SETTINGS                                                                                          \
-{                                                                                                                          \
-    { RS_PARTITION_CALIBRATION,    1u,     STORAGE_DEVICE_SERIAL_FLASH, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u }, \
-    { RS_PARTITION_CONFIGURATION,  7u,     STORAGE_DEVICE_SERIAL_FLASH, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u }, \
-    { RS_PARTITION_MWD,            128u,   STORAGE_DEVICE_MAIN_FLASH,   0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u }, \
-    { RS_PARTITION_STATIC_SURVEYS, 256u,   STORAGE_DEVICE_MAIN_FLASH,   0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u }, \
-    { RS_PARTITION_TRAJECTORY,     2304u,  STORAGE_DEVICE_MAIN_FLASH,   0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u }, \
-    { RS_PARTITION_BURST_DATA,     12032u, STORAGE_DEVICE_MAIN_FLASH,   0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u }, \
-    { RS_PARTITION_ALL_OTHER,      18048u, STORAGE_DEVICE_MAIN_FLASH,   0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u }, \
+#define RS_CFG_PARTITION_SETTINGS                                                                                                                       \
+{                                                                                                                                                       \
+    { RS_PARTITION_CALIBRATION,    1u,     STORAGE_DEVICE_SERIAL_FLASH, 0u,   FALSE, 0u, 0u, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u }, \
+    { RS_PARTITION_CONFIGURATION,  7u,     STORAGE_DEVICE_SERIAL_FLASH, 0u,   FALSE, 0u, 0u, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u }, \
+    { RS_PARTITION_MWD,            128u,   STORAGE_DEVICE_MAIN_FLASH,   0u,   FALSE, 0u, 0u, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u }, \
+    { RS_PARTITION_STATIC_SURVEYS, 256u,   STORAGE_DEVICE_MAIN_FLASH,   0u,   FALSE, 0u, 0u, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u }, \
+    { RS_PARTITION_TRAJECTORY,     2304u,  STORAGE_DEVICE_MAIN_FLASH,   0u,   FALSE, 0u, 0u, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u }, \
+    { RS_PARTITION_BURST_DATA,     12032u, STORAGE_DEVICE_MAIN_FLASH,   0u,   TRUE,   0u, 0u, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u }, \
+    { RS_PARTITION_ALL_OTHER,      17888u, STORAGE_DEVICE_MAIN_FLASH,   128u, FALSE, 0u, 0u, 0u, 0u, RS_ERR_NO_ERROR, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u }, \
 }
 
 
@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        rsindex.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for rsindex.c
+ * @note        Please refer to the .c file for a detailed description.
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef SOURCE_RSINDEX_H_
+#define SOURCE_RSINDEX_H_
+
+#include "rsapi.h"
+#include "rssearch.h"
+
+void    rsindex_partition_load(const uint8_t partition_index);
+
+void    rsindex_partition_reset(const uint8_t partition_index);
+
+void    rsindex_record_written(const uint8_t partition_index,
+                               const uint32_t rsr_start_address,
+                               const uint16_t record_id,
+                               const bool_t b_write_ok);
+
+bool_t  rsindex_search_seek(const uint8_t partition_index,
+                            rssearch_search_data_t * const p_search_data);
+
+bool_t  rsindex_query_if_valid(const uint8_t partition_index);
+
+#endif /* SOURCE_RSINDEX_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
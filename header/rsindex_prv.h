@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        rsindex_prv.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Private header file for rsindex.c
+ * @note        Please refer to the .c file for a detailed description.
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef SOURCE_RSINDEX_PRV_H_
+#define SOURCE_RSINDEX_PRV_H_
+
+/**
+ * Internal structure used in rsindex.c to count the instances of each record
+ * ID.  Record IDs get a slot in the order in which they are first written,
+ * and keep it until the partition is formatted.
+ */
+typedef struct
+{
+    uint16_t    ids_tracked;                                ///< Number of slots in use.
+    uint16_t    record_ids[RS_CFG_INDEX_RECORD_IDS];        ///< Record ID in each slot.
+    uint32_t    instances[RS_CFG_INDEX_RECORD_IDS];         ///< Records with the ID in each slot.
+} rsindex_id_table_t;
+
+/**
+ * Internal structure used in rsindex.c to hold the state of each index.
+ */
+typedef struct
+{
+    bool_t              b_index_valid;      ///< Index matches the partition contents.
+    uint32_t            entries_used;       ///< Number of checkpoints in the index area.
+    uint32_t            maximum_entries;    ///< Number of checkpoints the index area can hold.
+    uint32_t            records_written;    ///< Number of records in the partition.
+    rsindex_id_table_t  id_table;           ///< Instances of each record ID written.
+} rsindex_state_t;
+
+/**
+ * Internal structure used in rsindex.c for a single checkpoint.
+ */
+typedef struct
+{
+    uint32_t            record_number;      ///< Record number in partition, first record is 1.
+    uint32_t            rsr_start_address;  ///< Logical address of the start of the RSR.
+    rsindex_id_table_t  id_table;           ///< Instances of each record ID before this record.
+} rsindex_entry_t;
+
+
+#ifdef UNIT_TEST_BUILD
+
+/**
+ * Structure for recording system, for unit testing.
+ * This allows the unit tests to check all results via a single pointer.
+ */
+typedef struct
+{
+    rsindex_state_t*    p_index_state;
+
+} rsindex_unit_test_ptrs_t;
+
+rsindex_unit_test_ptrs_t* rsindex_unit_test_ptrs_get(void);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* SOURCE_RSINDEX_PRV_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
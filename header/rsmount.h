@@ -0,0 +1,34 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        rsmount.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for rsmount.c
+ * @note        Please refer to the .c file for a detailed description.
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef SOURCE_RSMOUNT_H_
+#define SOURCE_RSMOUNT_H_
+
+#include "rsapi.h"
+
+void    rsmount_load(void);
+
+bool_t  rsmount_partition_restore(const uint8_t partition_index);
+
+void    rsmount_partitions_mounted(void);
+
+bool_t  rsmount_record_write(void);
+
+void    rsmount_record_written(void);
+
+#endif /* SOURCE_RSMOUNT_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        rsmount_prv.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Private header file for rsmount.c
+ * @note        Please refer to the .c file for a detailed description.
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef SOURCE_RSMOUNT_PRV_H_
+#define SOURCE_RSMOUNT_PRV_H_
+
+/**
+ * Internal structure used in rsmount.c to hold the state of the mount
+ * record area.
+ */
+typedef struct
+{
+    bool_t      b_area_available;       ///< Mount record area is configured.
+    uint32_t    area_start_address;     ///< Logical start address of the area.
+    uint32_t    block_size_bytes;       ///< Size of each block in the area.
+    uint32_t    slots_per_block;        ///< Number of mount records per block.
+    uint16_t    current_block;          ///< Block holding the latest mount record.
+    uint32_t    next_slot;              ///< Next free slot in the current block.
+    uint32_t    generation;             ///< Generation of the latest mount record.
+    uint16_t    layout_signature;       ///< CRC of the partition layout.
+    bool_t      b_record_loaded;        ///< A valid mount record was loaded.
+    bool_t      b_refresh_required;     ///< A partition could not be restored directly.
+    uint16_t    records_since_write;    ///< Records written since the last mount record.
+} rsmount_state_t;
+
+/**
+ * Internal structure used in rsmount.c for the mount state of one partition.
+ */
+typedef struct
+{
+    uint32_t    next_available_address; ///< Next available logical address in partition.
+    uint32_t    free_pages;             ///< Number of free pages.
+    uint32_t    full_pages;             ///< Number of full pages.
+    rs_error_t  partition_error_status; ///< Error status of the partition.
+} rsmount_partition_t;
+
+
+#ifdef UNIT_TEST_BUILD
+
+/**
+ * Structure for recording system, for unit testing.
+ * This allows the unit tests to check all results via a single pointer.
+ */
+typedef struct
+{
+    rsmount_state_t*        p_mount_state;
+    rsmount_partition_t*    p_mount_partitions;
+
+} rsmount_unit_test_ptrs_t;
+
+rsmount_unit_test_ptrs_t* rsmount_unit_test_ptrs_get(void);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* SOURCE_RSMOUNT_PRV_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -25,6 +25,9 @@
 /// The page header is 16 bytes long.
 #define PAGE_HEADER_LENGTH_BYTES    16u
 
+/// Page header sequence number for a page which isn't in a ring log.
+#define PAGE_HEADER_NO_SEQUENCE     0xFFFFFFFFu
+
 /**
  * Enumerated types for all possible status messages relating to the
  * page headers in the recording system.
@@ -63,6 +66,7 @@ typedef struct
     uint16_t            status;                         ///< The status word.
     uint8_t             error_code;                     ///< The error code.
     uint16_t            error_address;                  ///< The error address.
+    uint32_t            sequence;                       ///< Ring log page sequence number.
 } rs_header_data_t;
 
 /**
@@ -140,6 +144,13 @@ rs_header_status_t rspages_page_header_check
                              const uint32_t page_number_to_check,
                              const uint8_t  partition_id);
 
+rs_header_status_t      rspages_page_sequence_get
+                            (const uint32_t partition_logical_start_address,
+                             const uint32_t partition_logical_end_address,
+                             const uint32_t page_number_to_check,
+                             const uint8_t  partition_id,
+                             uint32_t * const p_sequence);
+
 rs_header_status_t      rspages_page_header_write
                             (const rs_header_data_t * const p_header_data);
 
@@ -150,6 +161,11 @@ rs_page_status_t        rspages_page_data_check
 rs_page_write_status_t  rspages_page_data_write
                             (const rs_page_write_t * const p_write_data);
 
+uint16_t                rspages_page_data_write_batch
+                            (rs_page_write_t * const p_write_data,
+                             const uint16_t number_of_writes,
+                             rs_page_write_status_t * const p_write_status);
+
 bool_t                  rspages_page_details_calculate
                             (rs_page_details_t * const p_page_details);
 
@@ -19,6 +19,22 @@
 #ifndef SOURCE_RSPAGES_PRV_H_
 #define SOURCE_RSPAGES_PRV_H_
 
+/**
+ * Structure holding the state of a batched write, used by
+ * rspages_page_data_write_batch() and its helper functions.
+ */
+typedef struct
+{
+    rs_page_write_t *           p_write_data;       ///< Array of writes in the batch.
+    rs_page_write_status_t *    p_write_status;     ///< Array of statuses for the batch.
+    uint16_t                    first_staged_index; ///< Index of first write in the staging buffer.
+    uint16_t                    staged_writes;      ///< Number of writes in the staging buffer.
+    uint32_t                    staged_bytes;       ///< Number of bytes in the staging buffer.
+    uint32_t                    next_free_addr;     ///< Next free address after everything staged so far.
+    bool_t                      b_read_back;        ///< Set if any staged write needs reading back.
+    bool_t                      b_page_filled;      ///< Set if the last staged write fills the page.
+} rspages_batch_t;
+
 #ifdef UNIT_TEST_BUILD
 
 /**
@@ -30,10 +30,14 @@ typedef struct
     uint8_t             id;                 ///< Partition ID.
     uint32_t            number_of_pages;    ///< Number of pages in the partition.
     storage_devices_t   device_to_use;      ///< ID of device to store the partition in.
+    uint32_t            index_pages;        ///< Number of pages reserved for the record index.
+    bool_t              b_circular;         ///< TRUE to use the partition as a ring log.
 
     /* These values are derived by the recording system and updated as we go along. */
     uint32_t    start_address;              ///< First logical address in partition.
     uint32_t    end_address;                ///< Last logical address in partition.
+    uint32_t    index_start_address;        ///< First logical address of record index (0 if none).
+    uint32_t    index_end_address;          ///< Last logical address of record index (0 if none).
     rs_error_t  partition_error_status;     ///< Error status of the partition.
     uint32_t    next_available_address;     ///< Next available logical address in partition.
 
@@ -42,16 +46,32 @@ typedef struct
     uint32_t    unusable_pages;             ///< Number of pages with corrupted header.
     uint32_t    error_pages;                ///< Number of pages with error flagged.
     uint32_t    blank_headers_and_pages;    ///< Number of blank header \ page combinations.
+    uint32_t    ring_unit_pages;            ///< Pages erased at a time in a ring log (0 if not a ring).
+    uint32_t    page_sequence;              ///< Sequence number of the page being written (ring only).
 } rs_partition_info_t;
 
 
 void        rspartition_addresses_calculate(void);
 
+bool_t      rspartition_mount_area_get(uint32_t * const p_start_address,
+                                       uint32_t * const p_end_address);
+
 bool_t      rspartition_bisection_search_do(const uint8_t partition_index);
 
+bool_t      rspartition_bisection_search_from(const uint8_t partition_index,
+                                              const uint32_t first_page);
+
 rs_error_t  rspartition_format_partition(const uint8_t partition_index,
                                          uint8_t * const p_progress_counter);
 
+rs_error_t  rspartition_format_start(const uint8_t partition_index);
+
+rs_error_t  rspartition_format_step(void);
+
+uint8_t     rspartition_format_progress_get(void);
+
+bool_t      rspartition_format_in_progress_check(const uint8_t partition_index);
+
 uint16_t    rspartition_check_partition_id(const uint8_t partition_id);
 
 void        rspartition_flag_page_as_full(const uint8_t partition_index);
@@ -59,8 +79,21 @@ void        rspartition_flag_page_as_full(const uint8_t partition_index);
 bool_t      rspartition_next_address_set(const uint8_t partition_index,
                                          const uint32_t next_free_address);
 
+bool_t      rspartition_mount_state_set(const uint8_t partition_index,
+                                        const uint32_t next_free_address,
+                                        const uint32_t free_pages,
+                                        const uint32_t full_pages,
+                                        const rs_error_t partition_error_status);
+
 const rs_partition_info_t* rspartition_partition_ptr_get(const uint8_t partition_index);
 
+uint32_t    rspartition_ring_page_open(const uint8_t partition_index);
+
+void        rspartition_ring_erase_step(void);
+
+bool_t      rspartition_ring_oldest_address_get(const uint8_t partition_index,
+                                                uint32_t * const p_oldest_address);
+
 
 #endif /* SOURCE_RSPARTITION_H_ */
 
@@ -19,6 +19,45 @@
 #ifndef SOURCE_RSPARTITION_PRV_H_
 #define SOURCE_RSPARTITION_PRV_H_
 
+/**
+ * Enumerated type for the stages of a partition format.
+ */
+typedef enum
+{
+    RSPARTITION_FORMAT_IDLE,                ///< No format in progress.
+    RSPARTITION_FORMAT_ERASING,             ///< Erasing (and blank checking) a block at a time.
+    RSPARTITION_FORMAT_HEADER_WRITE         ///< Writing the first page header.
+} rspartition_format_stage_t;
+
+/**
+ * Structure holding the state of a partition format, which is carried out
+ * one step at a time by rspartition_format_step().
+ */
+typedef struct
+{
+    rspartition_format_stage_t  stage;              ///< What the next step does.
+    uint8_t                     partition_index;    ///< Partition being formatted.
+    uint32_t                    next_erase_address; ///< Logical address of the next block to erase.
+    uint32_t                    erase_size_bytes;   ///< Bytes erased by each step.
+    uint32_t                    blocks_to_erase;    ///< Number of erase steps in the format.
+    uint32_t                    blocks_erased;      ///< Number of erase steps done so far.
+    bool_t                      b_erase_running;    ///< Block erase running in the flash HAL.
+    uint8_t                     progress;           ///< Progress counter (0-100).
+    rs_error_t                  format_status;      ///< Status of the format so far.
+} rspartition_format_t;
+
+/**
+ * Structure holding the erase-ahead state of a ring log partition - the unit
+ * after the one being written is erased in the background, a step at a time,
+ * by rspartition_ring_erase_step().
+ */
+typedef struct
+{
+    bool_t      b_erase_due;                ///< Unit at erase_address needs erasing.
+    bool_t      b_erase_running;            ///< Unit erase running in the flash HAL.
+    uint32_t    erase_address;              ///< Logical address of the unit to erase.
+} rspartition_ring_t;
+
 #ifdef UNIT_TEST_BUILD
 
 /**
@@ -28,6 +67,8 @@
 typedef struct
 {
     rs_partition_info_t*    p_partitions;
+    rspartition_format_t*   p_format;
+    rspartition_ring_t*     p_ring;
 
 } rspartition_unit_test_ptrs_t;
 
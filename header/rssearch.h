@@ -29,6 +29,9 @@ typedef struct
     uint32_t                required_record_instance;           ///< Record instance to find.
     bool_t                  b_match_record_id;                  ///< Flag to say whether to match record ID or not.
     uint16_t                required_record_id;                 ///< Expected record ID if we're trying to match.
+    bool_t                  b_ring_wrapped;                     ///< Ring log which has discarded its oldest data.
+    uint32_t                ring_oldest_address;                ///< First address of the oldest data (ring only).
+    uint32_t                ring_next_free_address;             ///< Next free address in partition (ring only).
 } rssearch_search_data_t;
 
 /**
@@ -25,6 +25,8 @@ typedef struct
     uint32_t                partition_logical_start_address;    ///< Logical start address.
     uint32_t                partition_logical_end_address;      ///< Logical end address.
     uint32_t                search_start_address;               ///< Search start address.
+    uint32_t                first_page_number;                  ///< First page with data to search.
+    uint32_t                last_page_number;                   ///< Last page with data to search.
 } rssearch_internal_memory_t;
 
 /**
@@ -78,6 +80,15 @@ typedef struct
     uint16_t    (*p_count_blanks_from_end)(const uint8_t * const p_area,
                                            const uint16_t size_of_area);
 
+    uint32_t    (*p_linear_free_address_find)
+                            (const uint32_t logical_start_address,
+                             const uint32_t number_of_bytes_to_check);
+
+    bool_t      (*p_probe_free_address_find)
+                            (const uint32_t logical_start_address,
+                             const uint32_t number_of_bytes_to_check,
+                             uint32_t * const p_next_free_address);
+
     uint8_t     (*p_partition_memory_read_setup)
                             (const rssearch_internal_memory_t * const p_memory_data,
                              uint32_t * const p_read_addresses,
@@ -53,8 +53,20 @@ void            SCI_RxTriggerInitialise(const ESCIModule_t module,
                                         const uint8_t matchCharacter,
                                         void * const p_receiveSemaphore);
 
+void            SCI_RxBufferFlush(const ESCIModule_t module);
+
 uint16_t 	    SCI_RxBufferNumberOfCharsGet(const ESCIModule_t module);
 
+uint16_t        SCI_RxSpanGet(const ESCIModule_t module,
+                              const uint16_t offset,
+                              const uint8_t ** const pp_span);
+
+void            SCI_RxSpanRelease(const ESCIModule_t module, const uint16_t count);
+
+bool_t          SCI_RxCharacterGet(const ESCIModule_t module, uint8_t * const p_data);
+
+uint16_t        SCI_RxOverrunCountGet(const ESCIModule_t module);
+
 void            SCI_TxTriggerInitialise(const ESCIModule_t module,
                                         void * const p_transmitSemaphore);
 
@@ -64,6 +76,10 @@ void 		    SCI_TxStart(const ESCIModule_t module,
 
 bool_t		    SCI_TxDoneCheck(const ESCIModule_t module);
 
+bool_t          SCI_TxBufferFreeCheck(const ESCIModule_t module);
+
+void            SCI_RxFifoPoll(const ESCIModule_t module);
+
 interrupt void  SCI_RxInterruptA_ISR(void);
 interrupt void  SCI_TxInterruptA_ISR(void);
 interrupt void  SCI_RxInterruptB_ISR(void);
@@ -30,12 +30,21 @@ typedef struct SelfTestResult
     Uint16 	ActualApplicationCRC;
     Uint16 	ExpectedApplicationCRC;
     bool_t 	bApplicationCRCIsOK;
+
+    //Whether the CRCs above have been calculated, or just trusted from the
+    //verified image descriptors (in which case they're calculated in the background)
+    bool_t	bImagesVerified;
+    //Whether the verified image descriptor log is full, so that every boot
+    //calculates the CRCs until the parameter partition is programmed again
+    bool_t	bDescriptorLogFull;
 } SelfTestResult_t;
 
 void 					SelfTest_TestExecute(void);
 bool_t					SelfTest_isBootloaderImageValid(void);
 bool_t					SelfTest_isApplicationImageValid(void);
 const SelfTestResult_t*	SelfTest_ResultPointerGet(void);
+bool_t					SelfTest_BackgroundVerifyStep(void);
+void					SelfTest_VerificationComplete(void);
 
 #endif /* SELFTEST_H_ */
 
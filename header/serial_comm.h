@@ -21,8 +21,12 @@
 
 LoaderMessage_t*    serial_LoaderMessagePointerGet(void);
 bool_t              serial_StartCharacterReceivedCheck(EBusType_t busType);
+bool_t              serial_CharacterReceivedCheck(EBusType_t busType);
 EMessageStatus_t 	serial_MessageWait(Timer_t* pExternalTimer, bool_t bFoundStartCharacterAlready, EBusType_t busType);
 void                serial_MessageSend(Uint8 status, Uint16 length, char * data, EBusType_t busType);
+void                serial_StreamStart(EBusType_t busType);
+void                serial_StreamMessageSend(Uint8 status, Uint16 length, unsigned char * pFrame, EBusType_t busType);
+void                serial_StreamEnd(EBusType_t busType);
 const Timer_t* 		serial_CommTimerPointerGet(void);
 void                serial_SlaveAddressSet(uint8_t NewAddress, EBusType_t busType);
 void                serial_AltSlaveAddressSet(const uint8_t NewAddress, const EBusType_t busType);
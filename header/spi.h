@@ -13,6 +13,9 @@ void        SPI_Close(void);
 bool_t      SPI_BaudRateSet(const uint32_t iLspClk_Hz, const uint32_t iBaudRate);
 uint16_t    SPI_Read(const uint16_t DummyWord);
 void        SPI_Write(uint16_t DataToWrite);
+void        SPI_TransferBlock(const uint8_t * const p_tx_buffer,
+                              uint8_t * const p_rx_buffer,
+                              const uint32_t NumberOfWords);
 void 		SPI_EEPROMActiveSet(void);
 void 		SPI_EEPROMInactiveSet(void);
 void 		SPI_RTCActiveSet(void);
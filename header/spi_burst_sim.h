@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        spi_burst_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for spi_burst_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_SPI_BURST_SIM_H_
+#define HEADER_SPI_BURST_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Largest number of bytes which can be read.
+#define SPI_BURST_SIM_MAX_READ_BYTES    4096u
+
+/**
+ * Structure holding the transfers made by the SPI burst benchmark.
+ */
+typedef struct
+{
+    uint32_t    address;                    ///< First serial flash address read (and page written).
+    uint32_t    read_bytes;                 ///< Bytes read (max 4096).
+    uint32_t    write_bytes;                ///< Bytes written into each of two pages (max one page).
+} spi_burst_sim_config_t;
+
+/**
+ * Structure holding the time and throughput of one way of transferring.
+ */
+typedef struct
+{
+    uint64_t    read_us;                    ///< Simulated time of the read.
+    uint32_t    read_bytes_per_s;           ///< Read throughput, including the command.
+    uint64_t    write_us;                   ///< Simulated time of the write frame (not the write cycle).
+    uint32_t    write_bytes_per_s;          ///< Write frame throughput, including the command.
+} spi_burst_sim_transfer_t;
+
+/**
+ * Structure holding the results of the SPI burst benchmark.
+ */
+typedef struct
+{
+    spi_burst_sim_transfer_t    word;       ///< SPI_Read \ SPI_Write, a word at a time.
+    spi_burst_sim_transfer_t    burst;      ///< M95 commands, through SPI_TransferBlock.
+    bool_t                      b_read_matches;     ///< Both reads returned what is in the device.
+    bool_t                      b_write_matches;    ///< Both writes left the data in the device.
+} spi_burst_sim_result_t;
+
+void    spi_burst_sim_config_default(spi_burst_sim_config_t * const p_config);
+
+bool_t  spi_burst_sim_run(const spi_burst_sim_config_t * const p_config,
+                          spi_burst_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_SPI_BURST_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
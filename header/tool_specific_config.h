@@ -47,7 +47,10 @@
 #define APPLICATION_CRC_ADDRESS     APPLICATION_END_ADDRESS     // CRC one off the end of the app
 
 #define PARAMETER_START_ADDRESS     0x330000                    // Parameters in flash sector B.
-#define PARAMETER_END_ADDRESS       0x337FFF
+// Was 0x337FFF - the top 1k words of sector B now hold the image descriptors,
+// so parameters programmed by an older loader (CRC at 0x337FFF) must be
+// programmed again.
+#define PARAMETER_END_ADDRESS       0x337BFF                    // Top of sector B holds image descriptors.
 #define PARAMETER_LENGTH            (PARAMETER_END_ADDRESS - PARAMETER_START_ADDRESS)
 #define PARAMETER_CRC_ADDRESS       PARAMETER_END_ADDRESS       // CRC in final application location.
 
@@ -56,14 +59,23 @@
 #define CONFIG_LENGTH               (CONFIG_END_ADDRESS - CONFIG_START_ADDRESS)     // Length must be zero for not used.
 #define CONFIG_CRC_ADDRESS          CONFIG_END_ADDRESS
 
+#define IMAGE_DESCRIPTOR_START_ADDRESS  0x337C00                // Verified image descriptors, top of flash sector B.
+#define IMAGE_DESCRIPTOR_LENGTH         0x0400                  // Erased along with the parameter partition.
+
+#define SELF_TEST_BACKGROUND_WORDS  1024u   // Words of image CRC calculated per background step.
+
 
 #define TARGET_ENDIAN_TYPE          LITTLE_ENDIAN
 #define DOWNLOAD_ENDIANESS          BIG_ENDIAN      //endianess when downloading data
 #define UPLOAD_ENDIANESS            BIG_ENDIAN
 
 
+#ifndef BASELINE_NAME
 #define BASELINE_NAME               "dummy baseline"
+#endif
+#ifndef BASELINE_DATE
 #define BASELINE_DATE               "Thursday, January 1, 1970 00:00:00"
+#endif
 /* Define Identity for Opcode 2
  * To ensure backward compatibility with the classic Toolscope, the format is as follows:
  *  aaabbbbbbcccdddefff
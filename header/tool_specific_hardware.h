@@ -133,6 +133,52 @@ bool_t 	ToolSpecificHardware_SSBPortCharacterReceiveReadOnce(unsigned char* pDat
 bool_t  ToolSpecificHardware_ISBPortCharacterReceiveReadOnce(unsigned char* pData);
 
 
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificHardware_SSBPortReceiveSpanGet gives direct access to the
+ * characters received from the SSB port, which stay in the receive buffer
+ * until they are released.
+ *
+ * @param   Offset      Number of received characters to skip.
+ * @param   ppData      Pointer to the first character is written here.
+ * @retval  uint16_t    Number of contiguous characters, zero if none.
+ */
+uint16_t ToolSpecificHardware_SSBPortReceiveSpanGet(uint16_t Offset, const unsigned char** ppData);
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificHardware_ISBPortReceiveSpanGet gives direct access to the
+ * characters received from the ISB port, which stay in the receive buffer
+ * until they are released.
+ *
+ * @param   Offset      Number of received characters to skip.
+ * @param   ppData      Pointer to the first character is written here.
+ * @retval  uint16_t    Number of contiguous characters, zero if none.
+ */
+uint16_t ToolSpecificHardware_ISBPortReceiveSpanGet(uint16_t Offset, const unsigned char** ppData);
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificHardware_SSBPortReceiveSpanRelease throws away the oldest
+ * characters received from the SSB port.
+ *
+ * @param   Count       Number of characters to throw away.
+ */
+void    ToolSpecificHardware_SSBPortReceiveSpanRelease(uint16_t Count);
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificHardware_ISBPortReceiveSpanRelease throws away the oldest
+ * characters received from the ISB port.
+ *
+ * @param   Count       Number of characters to throw away.
+ */
+void    ToolSpecificHardware_ISBPortReceiveSpanRelease(uint16_t Count);
+
+
 // ----------------------------------------------------------------------------
 /**
  * ToolSpecificHardware_SSBPortWaitForSendComplete waits for any SSB message
@@ -173,6 +219,32 @@ void 	ToolSpecificHardware_SSBPortByteSend(unsigned char data);
 void    ToolSpecificHardware_ISBPortByteSend(unsigned char data);
 
 
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificHardware_SSBPortBufferSend starts transmitting a buffer of data,
+ * once the previous buffer has been taken by the transmitter, and returns
+ * without waiting for the data to be sent.  The buffer must be left alone
+ * until the next call has returned.
+ *
+ * @param   pData       Pointer to the characters to transmit.
+ * @param   Count       Number of characters to transmit.
+ */
+void    ToolSpecificHardware_SSBPortBufferSend(const unsigned char* pData, uint16_t Count);
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificHardware_ISBPortBufferSend starts transmitting a buffer of data,
+ * once the previous buffer has been taken by the transmitter, and returns
+ * without waiting for the data to be sent.  The buffer must be left alone
+ * until the next call has returned.
+ *
+ * @param   pData       Pointer to the characters to transmit.
+ * @param   Count       Number of characters to transmit.
+ */
+void    ToolSpecificHardware_ISBPortBufferSend(const unsigned char* pData, uint16_t Count);
+
+
 // ----------------------------------------------------------------------------
 /**
  * ToolSpecificHardware_SSBPortCharacterReceiveByPolling polls the SSB port
@@ -197,6 +269,14 @@ bool_t 	ToolSpecificHardware_SSBPortCharacterReceiveByPolling(unsigned char *pDa
 bool_t ToolSpecificHardware_ISBPortCharacterReceiveByPolling(unsigned char *pData, Timer_t* pTimer);
 
 
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificHardware_SSBPortReceivePoll moves any characters waiting in the
+ * SSB receiver into the receive buffer, for use while interrupts are disabled.
+ */
+void    ToolSpecificHardware_SSBPortReceivePoll(void);
+
+
 // ----------------------------------------------------------------------------
 /**
  * ToolSpecificHardware_SSBPortSelfTest performs a self test on the SSB port.
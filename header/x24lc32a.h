@@ -14,6 +14,10 @@ EI2CStatus_t	X24LC32A_BlockRead(const uint32_t StartAddress,
 									const uint16_t NumberOfReads,
 									uint8_t * const p_destination_buffer);
 
+EI2CStatus_t	X24LC32A_VerifyRead(const uint32_t StartAddress,
+									const uint16_t NumberOfReads,
+									uint8_t * const p_destination_buffer);
+
 EI2CStatus_t	X24LC32A_BlockWrite(const uint32_t StartAddress,
 									const uint16_t NumberOfWrites,
 									const uint8_t * const p_source_buffer);
@@ -25,6 +29,11 @@ extern EI2CStatus_t	(*X24LC32A_memcpy)(uint32_t StartAddress,
 
 EI2CStatus_t	X24LC32A_DeviceErase(void);
 
+bool_t          X24LC32A_FlushStep(void);
+EI2CStatus_t    X24LC32A_Flush(void);
+
+uint16_t        X24LC32A_WriteCountGet(void);
+
 void            X24LC32A_ForceTimeoutFlagSet(void);
 
 #endif /* HEADER_X24LC32A_H_ */
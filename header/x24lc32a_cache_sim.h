@@ -0,0 +1,64 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        x24lc32a_cache_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for x24lc32a_cache_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_X24LC32A_CACHE_SIM_H_
+#define HEADER_X24LC32A_CACHE_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/// Largest number of bytes which can be written.
+#define X24LC32A_CACHE_SIM_MAX_BYTES    2048u
+
+/**
+ * Structure holding the write made by the EEPROM cache benchmark.
+ */
+typedef struct
+{
+    uint32_t    address;                    ///< First EEPROM address written.
+    uint32_t    write_bytes;                ///< Bytes written (max 2048).
+    uint32_t    patch_bytes;                ///< Bytes written again, half way through, before the flush.
+    uint32_t    idle_us;                    ///< Other work between calls to X24LC32A_FlushStep().
+} x24lc32a_cache_sim_config_t;
+
+/**
+ * Structure holding the results of the EEPROM cache benchmark.
+ */
+typedef struct
+{
+    uint64_t    blocking_write_us;          ///< X24LC32A_BlockWrite, a page at a time.
+    uint64_t    longest_blocking_us;        ///< Longest single X24LC32A_BlockWrite call.
+    uint64_t    cached_write_us;            ///< X24LC32A_memcpy, returning once the data is cached.
+    uint64_t    flush_us;                   ///< Background write back, including the idle work.
+    uint64_t    flush_busy_us;              ///< Time spent inside X24LC32A_FlushStep().
+    uint64_t    longest_step_us;            ///< Longest single X24LC32A_FlushStep() call.
+    uint32_t    flush_steps;                ///< Calls to X24LC32A_FlushStep() until the cache was empty.
+    uint32_t    blocking_write_cycles;      ///< Device write cycles for the blocking write.
+    uint32_t    cached_write_cycles;        ///< Device write cycles for the cached write and patch.
+    bool_t      b_cache_reads_match;        ///< Reads before the flush returned the data written.
+    bool_t      b_data_matches;             ///< Both writes left the data in the device.
+} x24lc32a_cache_sim_result_t;
+
+void    x24lc32a_cache_sim_config_default(x24lc32a_cache_sim_config_t * const p_config);
+
+bool_t  x24lc32a_cache_sim_run(const x24lc32a_cache_sim_config_t * const p_config,
+                               x24lc32a_cache_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_X24LC32A_CACHE_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,56 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        xdi_shadow_sim.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Header file for xdi_shadow_sim.c
+ * @note        Please refer to the .c file for a detailed functional description.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef HEADER_XDI_SHADOW_SIM_H_
+#define HEADER_XDI_SHADOW_SIM_H_
+
+#ifdef UNIT_TEST_BUILD
+
+/**
+ * Structure holding the record written by the XDI shadow benchmark.
+ */
+typedef struct
+{
+    uint16_t    record_bytes;               ///< numberOfBytesToWrite, as opcode 206 passes it.
+    uint16_t    changed_offset;             ///< First data byte changed by the update.
+    uint16_t    changed_bytes;              ///< Number of data bytes changed by the update.
+} xdi_shadow_sim_config_t;
+
+/**
+ * Structure holding the results of the XDI shadow benchmark.
+ */
+typedef struct
+{
+    uint64_t    first_read_us;              ///< XDIMEMORY_ReadRequest, loading the shadow.
+    uint64_t    repeat_read_us;             ///< XDIMEMORY_ReadRequest, from the shadow.
+    uint64_t    full_write_us;              ///< Whole record written, as every update used to be.
+    uint32_t    full_write_cycles;          ///< EEPROM write cycles for the whole record.
+    uint64_t    delta_write_us;             ///< XDIMEMORY_WriteRequest for the update.
+    uint32_t    delta_write_cycles;         ///< EEPROM write cycles for the update.
+    bool_t      b_data_matches;             ///< The EEPROM and the reads hold the record.
+} xdi_shadow_sim_result_t;
+
+void    xdi_shadow_sim_config_default(xdi_shadow_sim_config_t * const p_config);
+
+bool_t  xdi_shadow_sim_run(const xdi_shadow_sim_config_t * const p_config,
+                           xdi_shadow_sim_result_t * const p_result);
+
+#endif /* UNIT_TEST_BUILD */
+
+#endif /* HEADER_XDI_SHADOW_SIM_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -13,6 +13,8 @@
 #include "loader_state.h"
 #include "self_test.h"
 #include "comm.h"
+#include "m95.h"
+#include "x24lc32a.h"
 #include "rsapi.h"
 #include "opcode000.h"
 #include "opcode001.h"
@@ -24,6 +26,7 @@
 #include "opcode037.h"
 #include "opcode038.h"
 #include "opcode039.h"
+#include "opcode040.h"
 #include "opcode046.h"
 #include "opcode070.h"
 #include "opcode191.h"
@@ -161,6 +164,10 @@ static void common_main(uint32_t initialTimeout, ELoaderState_t initialState)
                     opcode39_execute(&loaderState, messagePtr, &loaderTimer);
                     break;
 
+                case 40:
+                    opcode40_execute(&loaderState, messagePtr, &loaderTimer);
+                    break;
+
                 case 46:
                     opcode46_execute(&loaderState, messagePtr, &loaderTimer);
                     break;
@@ -231,6 +238,10 @@ static void common_main(uint32_t initialTimeout, ELoaderState_t initialState)
 
 static void common_timeoutOperation(ELoaderState_t loaderState)
 {
+    // Get any cached serial flash and EEPROM writes into the devices before the reset or jump.
+    (void)M95_Flush();
+    (void)X24LC32A_Flush();
+
     if (LOADER_WAITING == loaderState)
     {
         // No attempt was made to activate the loader in order to download
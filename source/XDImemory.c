@@ -14,6 +14,14 @@
  * 				except that the data are read or written immediately.
  * 				The request status are then updated and the request semaphore released.
  *
+ * 				The XDI region is kept in a RAM shadow, read from the EEPROM the
+ * 				first time it is needed and protected by a CRC.  Reads are served
+ * 				from the shadow, and a write only programs the EEPROM pages in
+ * 				which the new record differs from the shadow.  The shadow is
+ * 				read again once the EEPROM driver's write count shows that
+ * 				something else (FLASH_Erase, flash.c or the flash HAL) has
+ * 				written the EEPROM.
+ *
  * @attention
  * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2016.
  * This computer program includes confidential, proprietary information and is a
@@ -39,6 +47,7 @@
 #define XDI_MEMORY_SIZE				1024u   ///< 1024 bytes memory size.
 #define WRITE_BUFFER_LENGTH_MSB_IDX	3u      ///< Index to the data length MSB in the write buffer.
 #define WRITE_BUFFER_LENGTH_LSB_IDX	4u      ///< Index to the data length LSB in the write buffer.
+#define XDI_PAGE_SIZE				32u     ///< EEPROM page size - the unit of a delta write.
 
 
 // ----------------------------------------------------------------------------
@@ -48,10 +57,30 @@ static void   ReadBufferDataLeftShift(uint8_t* const p_buffer,
                                       const uint16_t bufferSize,
                                       const uint16_t leftShiftValue);
 
+static EI2CStatus_t ShadowLoad(void);
+
+static EI2CStatus_t ShadowDeltaWrite(const uint8_t * const p_record,
+                                     const uint16_t recordLength);
+
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module:
 
+/// RAM copy of the XDI region of the EEPROM.
+//lint -e{956} Only accessed from the background loop.
+static uint8_t  m_shadow[XDI_MEMORY_SIZE];
+
+/// CRC of m_shadow, taken whenever it is changed.
+//lint -e{956} Only accessed from the background loop.
+static uint16_t m_shadow_crc = 0u;
+
+/// EEPROM driver write count when m_shadow last matched the EEPROM.
+//lint -e{956} Only accessed from the background loop.
+static uint16_t m_shadow_write_count = 0u;
+
+/// TRUE once m_shadow holds the XDI region.
+//lint -e{956} Only accessed from the background loop.
+static bool_t   m_b_shadow_valid = FALSE;
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -60,6 +89,9 @@ static void   ReadBufferDataLeftShift(uint8_t* const p_buffer,
 // ----------------------------------------------------------------------------
 /*!
  * XDIMEMORY_ReadRequest passes a read request on to the XDImemory.
+ * The data comes from the RAM shadow, which is only read from the EEPROM
+ * the first time, if something else has written the EEPROM since, or if its
+ * CRC shows that it has been corrupted.
  *
  * @note
  * All arguments to this function are pointers, and are used to return various
@@ -76,22 +108,25 @@ bool_t XDIMEMORY_ReadRequest(uint8_t * const p_readBuffer,
                              uint16_t * const p_readLength,
                              rs_queue_status_t * const p_readStatus)
 {
-    const uint32_t  address = DNI_PROM_ADDRESS_OFFSET;
     EI2CStatus_t 	requestStatus;
     bool_t 			b_readRequestAcknowledge = FALSE;
+    uint16_t        loop;
 
     if ( (NULL != p_readBuffer) && (NULL != p_readLength) && (NULL != p_readStatus) )
     {
-        // Read the all EEPROM content.
-        requestStatus = X24LC32A_BlockRead(address,
-                                         XDI_MEMORY_SIZE,
-                                         p_readBuffer);
+        // Get the all EEPROM content.
+        requestStatus = ShadowLoad();
 
         // Update the read request status.
         if (I2C_COMPLETED_OK == requestStatus)
         {
             b_readRequestAcknowledge = TRUE;
 
+            for (loop = 0u; loop < XDI_MEMORY_SIZE; loop++)
+            {
+                p_readBuffer[loop] = m_shadow[loop];
+            }
+
             *p_readStatus = RS_QUEUE_REQUEST_COMPLETE;
 
             // Get the record length.
@@ -134,6 +169,8 @@ bool_t XDIMEMORY_ReadRequest(uint8_t * const p_readBuffer,
 // ----------------------------------------------------------------------------
 /*!
  * XDIMEMORY_write_request passes a write request on to the XDImemory.
+ * The record is framed as before, and then compared with the RAM shadow, so
+ * that only the EEPROM pages which have changed are programmed.
  *
  * @param   p_writeRequest Pointer to read request.
  * @retval  bool_t          TRUE if request accepted OK, FALSE if any error.
@@ -144,12 +181,11 @@ bool_t XDIMEMORY_WriteRequest(uint8_t * const p_writeBuffer,
                               const uint16_t numberOfBytesToWrite,
                               rs_queue_status_t * const p_writeStatus)
 {
-    const uint32_t  address 				  = DNI_PROM_ADDRESS_OFFSET;
     const uint16_t  totalNumberOfBytesToWrite = numberOfBytesToWrite + 2u;
     EI2CStatus_t 	requestStatus;
     bool_t 			b_writeRequestAcknowledge = FALSE;
     uint16_t                running_crc;
-    uint8_t crc_length;
+    uint16_t crc_length;
 
     if ( (NULL != p_writeBuffer) && (NULL != p_writeStatus) )
     {
@@ -172,16 +208,19 @@ bool_t XDIMEMORY_WriteRequest(uint8_t * const p_writeBuffer,
 
             //  CRC У
             crc_length = numberOfBytesToWrite - 3;
-            running_crc = CRC_CCITTOnByteCalculate(&p_writeBuffer, crc_length, 0x0000u);
+            // Records written before the CRC was taken over the buffer itself
+            // keep the wrong CRC.  Opcode 207 returns them as they are, so a
+            // host which checks it rejects them - writing them again with
+            // opcode 206 puts the right CRC in.
+            running_crc = CRC_CCITTOnByteCalculate(p_writeBuffer, crc_length, 0x0000u);
 
             p_writeBuffer[crc_length] = (uint8_t)((running_crc >> 8u) & 0x00FFu);
             p_writeBuffer[crc_length + 1u] = (uint8_t)(running_crc & 0x00FFu);
             p_writeBuffer[crc_length + 2u] = 0x1A;
-            // Copy the write buffer content into the 1Kbyte i2c EEPROM.
+            // Copy the changes in the write buffer content into the 1Kbyte i2c EEPROM.
             requestStatus
-                = X24LC32A_memcpy(address,
-                                totalNumberOfBytesToWrite,
-                                &p_writeBuffer[WRITE_BUFFER_LENGTH_MSB_IDX]);
+                = ShadowDeltaWrite(&p_writeBuffer[WRITE_BUFFER_LENGTH_MSB_IDX],
+                                   totalNumberOfBytesToWrite);
 
             // Update the write request status.
             if (I2C_COMPLETED_OK == requestStatus)
@@ -219,6 +258,9 @@ bool_t XDIMEMORY_EraseRequest(void)
 
     requestStatus = X24LC32A_DeviceErase();
 
+    // Read the region again next time, whatever state it was left in.
+    m_b_shadow_valid = FALSE;
+
     if (I2C_COMPLETED_OK == requestStatus)
     {
         b_erasedOK = TRUE;
@@ -228,6 +270,23 @@ bool_t XDIMEMORY_EraseRequest(void)
 }
 
 
+#ifdef UNIT_TEST_BUILD
+// ----------------------------------------------------------------------------
+/*!
+ * XDIMEMORY_ShadowDiscard_TDD throws away the RAM shadow, as happens at power
+ * up, so that it is read from the EEPROM again.
+ *
+ * This is only required when unit testing, hence the conditional compilation.
+ *
+ */
+// ----------------------------------------------------------------------------
+void XDIMEMORY_ShadowDiscard_TDD(void)
+{
+    m_b_shadow_valid = FALSE;
+}
+#endif
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 // FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
@@ -258,5 +317,141 @@ static void ReadBufferDataLeftShift(uint8_t* const p_buffer,
 }
 
 
+// ----------------------------------------------------------------------------
+/*!
+ * ShadowLoad makes sure the RAM shadow holds the XDI region.  The region is
+ * read from the EEPROM if the shadow hasn't been loaded yet, if the EEPROM
+ * has been written by anything else since, or if it no longer matches the
+ * CRC taken when it was last changed.
+ *
+ * @retval  EI2CStatus_t    I2C_COMPLETED_OK if the shadow is valid.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EI2CStatus_t ShadowLoad(void)
+{
+    EI2CStatus_t    requestStatus = I2C_COMPLETED_OK;
+
+    if ( (m_b_shadow_valid)
+            && ( (X24LC32A_WriteCountGet() != m_shadow_write_count)
+                    || (CRC_CCITTOnByteCalculate(m_shadow, XDI_MEMORY_SIZE, 0x0000u) != m_shadow_crc) ) )
+    {
+        m_b_shadow_valid = FALSE;
+    }
+
+    if (!m_b_shadow_valid)
+    {
+        requestStatus = X24LC32A_BlockRead(DNI_PROM_ADDRESS_OFFSET,
+                                           XDI_MEMORY_SIZE,
+                                           m_shadow);
+
+        if (I2C_COMPLETED_OK == requestStatus)
+        {
+            m_shadow_crc         = CRC_CCITTOnByteCalculate(m_shadow, XDI_MEMORY_SIZE, 0x0000u);
+            m_shadow_write_count = X24LC32A_WriteCountGet();
+            m_b_shadow_valid     = TRUE;
+        }
+    }
+
+    return requestStatus;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * ShadowDeltaWrite writes a record into the XDI region, programming only the
+ * EEPROM pages which differ from the RAM shadow - and within each of those,
+ * only the bytes from the first to the last which have changed.  The shadow
+ * is updated to match.  If the shadow can't be loaded the whole record is
+ * written, and if a write fails the shadow is thrown away, as the EEPROM
+ * contents are then unknown.  It returns once the record is in the EEPROM.
+ *
+ * @param   p_record        Pointer to the record, as it goes into the EEPROM.
+ * @param   recordLength    Number of bytes in the record.
+ * @retval  EI2CStatus_t    I2C bus \ programming status.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EI2CStatus_t ShadowDeltaWrite(const uint8_t * const p_record,
+                                     const uint16_t recordLength)
+{
+    EI2CStatus_t    requestStatus;
+    uint16_t        pageStart;
+    uint16_t        pageEnd;
+    uint16_t        firstChanged;
+    uint16_t        lastChanged;
+    uint16_t        loop;
+
+    requestStatus = ShadowLoad();
+
+    if (I2C_COMPLETED_OK != requestStatus)
+    {
+        requestStatus = X24LC32A_memcpy(DNI_PROM_ADDRESS_OFFSET, recordLength, p_record);
+    }
+    else
+    {
+        for (pageStart = 0u;
+                (pageStart < recordLength) && (I2C_COMPLETED_OK == requestStatus);
+                pageStart += XDI_PAGE_SIZE)
+        {
+            pageEnd = pageStart + XDI_PAGE_SIZE;
+
+            if (pageEnd > recordLength)
+            {
+                pageEnd = recordLength;
+            }
+
+            // Find the changed span within this page.
+            firstChanged = pageEnd;
+            lastChanged  = pageStart;
+
+            for (loop = pageStart; loop < pageEnd; loop++)
+            {
+                if (p_record[loop] != m_shadow[loop])
+                {
+                    if (firstChanged == pageEnd)
+                    {
+                        firstChanged = loop;
+                    }
+
+                    lastChanged = loop;
+                }
+            }
+
+            if (firstChanged != pageEnd)
+            {
+                //lint -e{921} Cast to uint16_t - never more than a page.
+                requestStatus = X24LC32A_memcpy(DNI_PROM_ADDRESS_OFFSET + firstChanged,
+                                                (uint16_t)((lastChanged - firstChanged) + 1u),
+                                                &p_record[firstChanged]);
+
+                for (loop = firstChanged; loop <= lastChanged; loop++)
+                {
+                    m_shadow[loop] = p_record[loop];
+                }
+            }
+        }
+
+        // The shadow matches the EEPROM again, including these writes.
+        m_shadow_crc         = CRC_CCITTOnByteCalculate(m_shadow, XDI_MEMORY_SIZE, 0x0000u);
+        m_shadow_write_count = X24LC32A_WriteCountGet();
+    }
+
+    // The write is acknowledged to the surface, so it must be in the EEPROM
+    // and not just in the write-behind cache.
+    if (I2C_COMPLETED_OK == requestStatus)
+    {
+        requestStatus = X24LC32A_Flush();
+    }
+
+    if (I2C_COMPLETED_OK != requestStatus)
+    {
+        m_b_shadow_valid = FALSE;
+    }
+
+    return requestStatus;
+}
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -32,6 +32,14 @@
 #include "serial_comm.h"
 #include "tool_specific_config.h"
 #include "tool_specific_hardware.h"
+#include "tool_specific_programming.h"
+#include "prom_hardware.h"
+#include "m95.h"
+#include "x24lc32a.h"
+#include "opcode013.h"
+#ifdef I_AM_THE_BOOTLOADER
+#include "self_test.h"
+#endif
 
 
 // ----------------------------------------------------------------------------
@@ -41,6 +49,8 @@
 // some function prototypes for dummy functions to mimic the behaviour of the
 // real functions.
 
+static void             loader_IdleWork(void);
+
 #ifdef COMM_CAN
 #include "can_task.h"
 #else
@@ -114,6 +124,11 @@ LoaderMessage_t* loader_waitForMessage(Timer_t* pTimer)
     // Enable reception
     ToolSpecificHardware_SSBTransmitDisable();
     //ToolSpecificHardware_ISBTransmitDisable();
+
+    // Program any downloaded block which is still pending, now that the reply
+    // has gone - the next message is received while the flash is programmed.
+    // Any failure is reported in reply to the next download message.
+    (void)PromHardware_PendingProgramComplete();
     // Wait in this loop for a good message or the timer to time out.
 	while( (status != MESSAGE_OK) && (Timer_TimerExpiredCheck(pTimer) == FALSE) )
 	{
@@ -130,6 +145,7 @@ LoaderMessage_t* loader_waitForMessage(Timer_t* pTimer)
 		    {
 
 		        bSSBSOFdone = serial_StartCharacterReceivedCheck(BUS_SSB);
+		        loader_IdleWork();
 		        //bIsbSOFdone = serial_StartCharacterReceivedCheck(BUS_ISB);
 //		        bGotDebugMessage = Debug_HaltMessageCheck();
 			    //proccessMessagesReceived();						//lint !e522 Lacks side effects.
@@ -173,6 +189,13 @@ LoaderMessage_t* loader_waitForMessage(Timer_t* pTimer)
 		}
 		else if ( (gBusCOM == BUS_SSB) || (gBusCOM == BUS_ISB) )
 		{
+		    // Use the idle time until the next message starts to arrive.
+		    while( (Timer_TimerExpiredCheck(pTimer) == FALSE)
+		    		&& (serial_CharacterReceivedCheck(gBusCOM) == FALSE) )
+		    {
+		        loader_IdleWork();
+		    }
+
 		    // Wait for message, including start character.
 		    status = serial_MessageWait( pTimer, FALSE , gBusCOM);
 		}
@@ -276,6 +299,108 @@ void loader_MessageSend(Uint8 Status, Uint16 LengthOfDataInBytes, char* pData)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * loader_MessageStreamStart gets the selected communications port ready to
+ * send a stream of messages with loader_MessageStreamSend.
+ *
+ */
+// ----------------------------------------------------------------------------
+void loader_MessageStreamStart(void)
+{
+    if ( (gBusCOM == BUS_SSB) || (gBusCOM == BUS_ISB) )
+    {
+        serial_StreamStart(gBusCOM);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * loader_MessageStreamSend sends one of a stream of messages over the selected
+ * communications port.  The data is in pFrame, after LOADER_STREAM_PREFIX_LENGTH
+ * spare bytes, with LOADER_STREAM_SUFFIX_LENGTH spare bytes after it, so the
+ * message can be built around the data and sent in one go.  On the SSB and ISB
+ * this returns as soon as the previous message has been taken by the
+ * transmitter, so the next message can be got ready while this one is being
+ * sent - pFrame mustn't be changed until the next call has returned.
+ * Other ports send the message as loader_MessageSend does.
+ *
+ * @param	Status					Status value to send.
+ * @param	LengthOfDataInBytes		Number of bytes of data to send.
+ * @param	pFrame					Pointer to buffer holding the data.
+ *
+ */
+// ----------------------------------------------------------------------------
+void loader_MessageStreamSend(Uint8 Status, Uint16 LengthOfDataInBytes, unsigned char* pFrame)
+{
+#if defined (COMM_DEBUG) && defined (COMM_DEBUG_FORWARD_SSB)
+	LoaderMessage_t* pMessage;
+#endif
+
+    if ( (gBusCOM == BUS_SSB) || (gBusCOM == BUS_ISB) )
+    {
+#if defined (COMM_DEBUG) && defined (COMM_DEBUG_FORWARD_SSB)
+    	pMessage = serial_LoaderMessagePointerGet();
+    	Debug_LoaderMessageSend(pMessage->opcode, Status, LengthOfDataInBytes,
+    	                        (char*)&pFrame[LOADER_STREAM_PREFIX_LENGTH]);
+#endif
+    	serial_StreamMessageSend(Status, LengthOfDataInBytes, pFrame, gBusCOM);
+    }
+    else
+    {
+        loader_MessageSend(Status, LengthOfDataInBytes, (char*)&pFrame[LOADER_STREAM_PREFIX_LENGTH]);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * loader_MessageStreamEnd waits for the last message of a stream to be sent,
+ * and puts the communications port back into receive.
+ *
+ */
+// ----------------------------------------------------------------------------
+void loader_MessageStreamEnd(void)
+{
+    if ( (gBusCOM == BUS_SSB) || (gBusCOM == BUS_ISB) )
+    {
+        serial_StreamEnd(gBusCOM);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * loader_IdleWork does a small piece of any background work while the loader
+ * is waiting for a message.  Each piece is kept short, so a message which
+ * starts to arrive isn't kept waiting.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void loader_IdleWork(void)
+{
+#ifdef I_AM_THE_BOOTLOADER
+    // Use the idle time to check any images trusted at boot.
+    (void)SelfTest_BackgroundVerifyStep();
+#endif
+    // Use the idle time to write back any cached serial flash pages.
+    (void)M95_FlushStep();
+    // ...and any cached EEPROM pages, one bus operation at a time.
+    (void)X24LC32A_FlushStep();
+    // ...and carry on with any format which opcode 13 started.
+    (void)opcode13_FormatStep();
+}
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 // FUNCTIONS WITH LOCAL SCOPE BELOW HERE - DUMMY FUNCTIONS
@@ -19,6 +19,24 @@
  * www.lammertbies.nl/comm/info/crc-calculation.html
  * for more information.
  *
+ * The table driven engine behind every function in this module is selected
+ * at build time with CRC_ENGINE (see crc.h):
+ * - CRC_ENGINE_BYTE_TABLE - the classic single table, one byte per step.
+ * - CRC_ENGINE_WORD_TABLE - two tables, one 16 bit word per step.  This suits
+ *   the 16 bit minimum addressable unit of the target and halves the number
+ *   of dependent table lookups per byte.
+ * - CRC_ENGINE_SLICE_BY_4 - four tables, two words (four bytes) per step.
+ * All engines give bit-identical results, the larger ones trade flash for
+ * speed (256, 512 and 1024 words of tables respectively).
+ *
+ * Each table holds h * x^n mod P for every 8 bit value of h, so a 16 bit
+ * value V is multiplied by x^16 with two lookups:
+ * V * x^16 mod P = CRCtableX24[V >> 8] ^ CRCtable[V & 0xFF].
+ * The direct form used by CRC_CCITTCalculate() advances the CRC by a word W
+ * as (CRC ^ W) * x^16, and the augmented form used by dsp_crc.c (where the
+ * message is finished off by feeding zeroes through it) as CRC * x^16 ^ W,
+ * so both forms share the same tables.
+ *
  * @warning
  * Data is processed in little-endian format.
  *
@@ -43,6 +61,21 @@
 // ----------------------------------------------------------------------------
 // Function prototypes for functions which only have scope within this module:
 
+static inline uint16_t  PackedWordGet(const uint16_t PackedWord);
+
+static inline uint16_t  DirectWordStep(const uint16_t Crc, const uint16_t Word);
+
+static inline uint16_t  DirectDoubleWordStep(const uint16_t Crc,
+                                             const uint16_t FirstWord,
+                                             const uint16_t SecondWord);
+
+static inline uint16_t  AugmentedWordStep(const uint16_t Crc,
+                                          const uint16_t Word);
+
+static inline uint16_t  AugmentedDoubleWordStep(const uint16_t Crc,
+                                                const uint16_t FirstWord,
+                                                const uint16_t SecondWord);
+
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module:
@@ -51,7 +84,9 @@
  * CRC lookup table for CRC-16-CCITT (as used for HDLC, Bluetooth etc).
  * This table is for polynomial: x^16 + x^12 + x^5 + 1, processing from least
  * to most significant bits.
+ * Entry h holds h * x^16 mod P.
  */
+#pragma DATA_SECTION(CRCtable, ".crcTable")
 static const uint16_t CRCtable[] =
 {
      0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
@@ -89,6 +124,133 @@ static const uint16_t CRCtable[] =
 };
 
 
+#if (CRC_ENGINE != CRC_ENGINE_BYTE_TABLE)
+/**
+ * Second lookup table for the word and slice engines - entry h holds
+ * h * x^24 mod P.
+ */
+#pragma DATA_SECTION(CRCtableX24, ".crcTable")
+static const uint16_t CRCtableX24[256] =
+{
+     0x0000u, 0x3331u, 0x6662u, 0x5553u, 0xCCC4u, 0xFFF5u, 0xAAA6u, 0x9997u,
+     0x89A9u, 0xBA98u, 0xEFCBu, 0xDCFAu, 0x456Du, 0x765Cu, 0x230Fu, 0x103Eu,
+     0x0373u, 0x3042u, 0x6511u, 0x5620u, 0xCFB7u, 0xFC86u, 0xA9D5u, 0x9AE4u,
+     0x8ADAu, 0xB9EBu, 0xECB8u, 0xDF89u, 0x461Eu, 0x752Fu, 0x207Cu, 0x134Du,
+     0x06E6u, 0x35D7u, 0x6084u, 0x53B5u, 0xCA22u, 0xF913u, 0xAC40u, 0x9F71u,
+     0x8F4Fu, 0xBC7Eu, 0xE92Du, 0xDA1Cu, 0x438Bu, 0x70BAu, 0x25E9u, 0x16D8u,
+     0x0595u, 0x36A4u, 0x63F7u, 0x50C6u, 0xC951u, 0xFA60u, 0xAF33u, 0x9C02u,
+     0x8C3Cu, 0xBF0Du, 0xEA5Eu, 0xD96Fu, 0x40F8u, 0x73C9u, 0x269Au, 0x15ABu,
+     0x0DCCu, 0x3EFDu, 0x6BAEu, 0x589Fu, 0xC108u, 0xF239u, 0xA76Au, 0x945Bu,
+     0x8465u, 0xB754u, 0xE207u, 0xD136u, 0x48A1u, 0x7B90u, 0x2EC3u, 0x1DF2u,
+     0x0EBFu, 0x3D8Eu, 0x68DDu, 0x5BECu, 0xC27Bu, 0xF14Au, 0xA419u, 0x9728u,
+     0x8716u, 0xB427u, 0xE174u, 0xD245u, 0x4BD2u, 0x78E3u, 0x2DB0u, 0x1E81u,
+     0x0B2Au, 0x381Bu, 0x6D48u, 0x5E79u, 0xC7EEu, 0xF4DFu, 0xA18Cu, 0x92BDu,
+     0x8283u, 0xB1B2u, 0xE4E1u, 0xD7D0u, 0x4E47u, 0x7D76u, 0x2825u, 0x1B14u,
+     0x0859u, 0x3B68u, 0x6E3Bu, 0x5D0Au, 0xC49Du, 0xF7ACu, 0xA2FFu, 0x91CEu,
+     0x81F0u, 0xB2C1u, 0xE792u, 0xD4A3u, 0x4D34u, 0x7E05u, 0x2B56u, 0x1867u,
+     0x1B98u, 0x28A9u, 0x7DFAu, 0x4ECBu, 0xD75Cu, 0xE46Du, 0xB13Eu, 0x820Fu,
+     0x9231u, 0xA100u, 0xF453u, 0xC762u, 0x5EF5u, 0x6DC4u, 0x3897u, 0x0BA6u,
+     0x18EBu, 0x2BDAu, 0x7E89u, 0x4DB8u, 0xD42Fu, 0xE71Eu, 0xB24Du, 0x817Cu,
+     0x9142u, 0xA273u, 0xF720u, 0xC411u, 0x5D86u, 0x6EB7u, 0x3BE4u, 0x08D5u,
+     0x1D7Eu, 0x2E4Fu, 0x7B1Cu, 0x482Du, 0xD1BAu, 0xE28Bu, 0xB7D8u, 0x84E9u,
+     0x94D7u, 0xA7E6u, 0xF2B5u, 0xC184u, 0x5813u, 0x6B22u, 0x3E71u, 0x0D40u,
+     0x1E0Du, 0x2D3Cu, 0x786Fu, 0x4B5Eu, 0xD2C9u, 0xE1F8u, 0xB4ABu, 0x879Au,
+     0x97A4u, 0xA495u, 0xF1C6u, 0xC2F7u, 0x5B60u, 0x6851u, 0x3D02u, 0x0E33u,
+     0x1654u, 0x2565u, 0x7036u, 0x4307u, 0xDA90u, 0xE9A1u, 0xBCF2u, 0x8FC3u,
+     0x9FFDu, 0xACCCu, 0xF99Fu, 0xCAAEu, 0x5339u, 0x6008u, 0x355Bu, 0x066Au,
+     0x1527u, 0x2616u, 0x7345u, 0x4074u, 0xD9E3u, 0xEAD2u, 0xBF81u, 0x8CB0u,
+     0x9C8Eu, 0xAFBFu, 0xFAECu, 0xC9DDu, 0x504Au, 0x637Bu, 0x3628u, 0x0519u,
+     0x10B2u, 0x2383u, 0x76D0u, 0x45E1u, 0xDC76u, 0xEF47u, 0xBA14u, 0x8925u,
+     0x991Bu, 0xAA2Au, 0xFF79u, 0xCC48u, 0x55DFu, 0x66EEu, 0x33BDu, 0x008Cu,
+     0x13C1u, 0x20F0u, 0x75A3u, 0x4692u, 0xDF05u, 0xEC34u, 0xB967u, 0x8A56u,
+     0x9A68u, 0xA959u, 0xFC0Au, 0xCF3Bu, 0x56ACu, 0x659Du, 0x30CEu, 0x03FFu
+};
+#endif
+
+#if (CRC_ENGINE == CRC_ENGINE_SLICE_BY_4)
+/**
+ * Third lookup table for the slice-by-4 engine - entry h holds h * x^32 mod P.
+ */
+#pragma DATA_SECTION(CRCtableX32, ".crcTable")
+static const uint16_t CRCtableX32[256] =
+{
+     0x0000u, 0x3730u, 0x6E60u, 0x5950u, 0xDCC0u, 0xEBF0u, 0xB2A0u, 0x8590u,
+     0xA9A1u, 0x9E91u, 0xC7C1u, 0xF0F1u, 0x7561u, 0x4251u, 0x1B01u, 0x2C31u,
+     0x4363u, 0x7453u, 0x2D03u, 0x1A33u, 0x9FA3u, 0xA893u, 0xF1C3u, 0xC6F3u,
+     0xEAC2u, 0xDDF2u, 0x84A2u, 0xB392u, 0x3602u, 0x0132u, 0x5862u, 0x6F52u,
+     0x86C6u, 0xB1F6u, 0xE8A6u, 0xDF96u, 0x5A06u, 0x6D36u, 0x3466u, 0x0356u,
+     0x2F67u, 0x1857u, 0x4107u, 0x7637u, 0xF3A7u, 0xC497u, 0x9DC7u, 0xAAF7u,
+     0xC5A5u, 0xF295u, 0xABC5u, 0x9CF5u, 0x1965u, 0x2E55u, 0x7705u, 0x4035u,
+     0x6C04u, 0x5B34u, 0x0264u, 0x3554u, 0xB0C4u, 0x87F4u, 0xDEA4u, 0xE994u,
+     0x1DADu, 0x2A9Du, 0x73CDu, 0x44FDu, 0xC16Du, 0xF65Du, 0xAF0Du, 0x983Du,
+     0xB40Cu, 0x833Cu, 0xDA6Cu, 0xED5Cu, 0x68CCu, 0x5FFCu, 0x06ACu, 0x319Cu,
+     0x5ECEu, 0x69FEu, 0x30AEu, 0x079Eu, 0x820Eu, 0xB53Eu, 0xEC6Eu, 0xDB5Eu,
+     0xF76Fu, 0xC05Fu, 0x990Fu, 0xAE3Fu, 0x2BAFu, 0x1C9Fu, 0x45CFu, 0x72FFu,
+     0x9B6Bu, 0xAC5Bu, 0xF50Bu, 0xC23Bu, 0x47ABu, 0x709Bu, 0x29CBu, 0x1EFBu,
+     0x32CAu, 0x05FAu, 0x5CAAu, 0x6B9Au, 0xEE0Au, 0xD93Au, 0x806Au, 0xB75Au,
+     0xD808u, 0xEF38u, 0xB668u, 0x8158u, 0x04C8u, 0x33F8u, 0x6AA8u, 0x5D98u,
+     0x71A9u, 0x4699u, 0x1FC9u, 0x28F9u, 0xAD69u, 0x9A59u, 0xC309u, 0xF439u,
+     0x3B5Au, 0x0C6Au, 0x553Au, 0x620Au, 0xE79Au, 0xD0AAu, 0x89FAu, 0xBECAu,
+     0x92FBu, 0xA5CBu, 0xFC9Bu, 0xCBABu, 0x4E3Bu, 0x790Bu, 0x205Bu, 0x176Bu,
+     0x7839u, 0x4F09u, 0x1659u, 0x2169u, 0xA4F9u, 0x93C9u, 0xCA99u, 0xFDA9u,
+     0xD198u, 0xE6A8u, 0xBFF8u, 0x88C8u, 0x0D58u, 0x3A68u, 0x6338u, 0x5408u,
+     0xBD9Cu, 0x8AACu, 0xD3FCu, 0xE4CCu, 0x615Cu, 0x566Cu, 0x0F3Cu, 0x380Cu,
+     0x143Du, 0x230Du, 0x7A5Du, 0x4D6Du, 0xC8FDu, 0xFFCDu, 0xA69Du, 0x91ADu,
+     0xFEFFu, 0xC9CFu, 0x909Fu, 0xA7AFu, 0x223Fu, 0x150Fu, 0x4C5Fu, 0x7B6Fu,
+     0x575Eu, 0x606Eu, 0x393Eu, 0x0E0Eu, 0x8B9Eu, 0xBCAEu, 0xE5FEu, 0xD2CEu,
+     0x26F7u, 0x11C7u, 0x4897u, 0x7FA7u, 0xFA37u, 0xCD07u, 0x9457u, 0xA367u,
+     0x8F56u, 0xB866u, 0xE136u, 0xD606u, 0x5396u, 0x64A6u, 0x3DF6u, 0x0AC6u,
+     0x6594u, 0x52A4u, 0x0BF4u, 0x3CC4u, 0xB954u, 0x8E64u, 0xD734u, 0xE004u,
+     0xCC35u, 0xFB05u, 0xA255u, 0x9565u, 0x10F5u, 0x27C5u, 0x7E95u, 0x49A5u,
+     0xA031u, 0x9701u, 0xCE51u, 0xF961u, 0x7CF1u, 0x4BC1u, 0x1291u, 0x25A1u,
+     0x0990u, 0x3EA0u, 0x67F0u, 0x50C0u, 0xD550u, 0xE260u, 0xBB30u, 0x8C00u,
+     0xE352u, 0xD462u, 0x8D32u, 0xBA02u, 0x3F92u, 0x08A2u, 0x51F2u, 0x66C2u,
+     0x4AF3u, 0x7DC3u, 0x2493u, 0x13A3u, 0x9633u, 0xA103u, 0xF853u, 0xCF63u
+};
+
+/**
+ * Fourth lookup table for the slice-by-4 engine - entry h holds
+ * h * x^40 mod P.
+ */
+#pragma DATA_SECTION(CRCtableX40, ".crcTable")
+static const uint16_t CRCtableX40[256] =
+{
+     0x0000u, 0x76B4u, 0xED68u, 0x9BDCu, 0xCAF1u, 0xBC45u, 0x2799u, 0x512Du,
+     0x85C3u, 0xF377u, 0x68ABu, 0x1E1Fu, 0x4F32u, 0x3986u, 0xA25Au, 0xD4EEu,
+     0x1BA7u, 0x6D13u, 0xF6CFu, 0x807Bu, 0xD156u, 0xA7E2u, 0x3C3Eu, 0x4A8Au,
+     0x9E64u, 0xE8D0u, 0x730Cu, 0x05B8u, 0x5495u, 0x2221u, 0xB9FDu, 0xCF49u,
+     0x374Eu, 0x41FAu, 0xDA26u, 0xAC92u, 0xFDBFu, 0x8B0Bu, 0x10D7u, 0x6663u,
+     0xB28Du, 0xC439u, 0x5FE5u, 0x2951u, 0x787Cu, 0x0EC8u, 0x9514u, 0xE3A0u,
+     0x2CE9u, 0x5A5Du, 0xC181u, 0xB735u, 0xE618u, 0x90ACu, 0x0B70u, 0x7DC4u,
+     0xA92Au, 0xDF9Eu, 0x4442u, 0x32F6u, 0x63DBu, 0x156Fu, 0x8EB3u, 0xF807u,
+     0x6E9Cu, 0x1828u, 0x83F4u, 0xF540u, 0xA46Du, 0xD2D9u, 0x4905u, 0x3FB1u,
+     0xEB5Fu, 0x9DEBu, 0x0637u, 0x7083u, 0x21AEu, 0x571Au, 0xCCC6u, 0xBA72u,
+     0x753Bu, 0x038Fu, 0x9853u, 0xEEE7u, 0xBFCAu, 0xC97Eu, 0x52A2u, 0x2416u,
+     0xF0F8u, 0x864Cu, 0x1D90u, 0x6B24u, 0x3A09u, 0x4CBDu, 0xD761u, 0xA1D5u,
+     0x59D2u, 0x2F66u, 0xB4BAu, 0xC20Eu, 0x9323u, 0xE597u, 0x7E4Bu, 0x08FFu,
+     0xDC11u, 0xAAA5u, 0x3179u, 0x47CDu, 0x16E0u, 0x6054u, 0xFB88u, 0x8D3Cu,
+     0x4275u, 0x34C1u, 0xAF1Du, 0xD9A9u, 0x8884u, 0xFE30u, 0x65ECu, 0x1358u,
+     0xC7B6u, 0xB102u, 0x2ADEu, 0x5C6Au, 0x0D47u, 0x7BF3u, 0xE02Fu, 0x969Bu,
+     0xDD38u, 0xAB8Cu, 0x3050u, 0x46E4u, 0x17C9u, 0x617Du, 0xFAA1u, 0x8C15u,
+     0x58FBu, 0x2E4Fu, 0xB593u, 0xC327u, 0x920Au, 0xE4BEu, 0x7F62u, 0x09D6u,
+     0xC69Fu, 0xB02Bu, 0x2BF7u, 0x5D43u, 0x0C6Eu, 0x7ADAu, 0xE106u, 0x97B2u,
+     0x435Cu, 0x35E8u, 0xAE34u, 0xD880u, 0x89ADu, 0xFF19u, 0x64C5u, 0x1271u,
+     0xEA76u, 0x9CC2u, 0x071Eu, 0x71AAu, 0x2087u, 0x5633u, 0xCDEFu, 0xBB5Bu,
+     0x6FB5u, 0x1901u, 0x82DDu, 0xF469u, 0xA544u, 0xD3F0u, 0x482Cu, 0x3E98u,
+     0xF1D1u, 0x8765u, 0x1CB9u, 0x6A0Du, 0x3B20u, 0x4D94u, 0xD648u, 0xA0FCu,
+     0x7412u, 0x02A6u, 0x997Au, 0xEFCEu, 0xBEE3u, 0xC857u, 0x538Bu, 0x253Fu,
+     0xB3A4u, 0xC510u, 0x5ECCu, 0x2878u, 0x7955u, 0x0FE1u, 0x943Du, 0xE289u,
+     0x3667u, 0x40D3u, 0xDB0Fu, 0xADBBu, 0xFC96u, 0x8A22u, 0x11FEu, 0x674Au,
+     0xA803u, 0xDEB7u, 0x456Bu, 0x33DFu, 0x62F2u, 0x1446u, 0x8F9Au, 0xF92Eu,
+     0x2DC0u, 0x5B74u, 0xC0A8u, 0xB61Cu, 0xE731u, 0x9185u, 0x0A59u, 0x7CEDu,
+     0x84EAu, 0xF25Eu, 0x6982u, 0x1F36u, 0x4E1Bu, 0x38AFu, 0xA373u, 0xD5C7u,
+     0x0129u, 0x779Du, 0xEC41u, 0x9AF5u, 0xCBD8u, 0xBD6Cu, 0x26B0u, 0x5004u,
+     0x9F4Du, 0xE9F9u, 0x7225u, 0x0491u, 0x55BCu, 0x2308u, 0xB8D4u, 0xCE60u,
+     0x1A8Eu, 0x6C3Au, 0xF7E6u, 0x8152u, 0xD07Fu, 0xA6CBu, 0x3D17u, 0x4BA3u
+};
+#endif
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 // CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
@@ -126,10 +288,16 @@ bool_t CRC_Check(const uint16_t* const pBuffer, const uint32_t LengthInBytes,
 // ----------------------------------------------------------------------------
 /**
  * CRC_CCITTCalculate calculates the CCITT CRC checksum for a certain number
- * of bytes.  The data is assumed to be presented in little-endian format.
+ * of words.  The data is assumed to be presented in little-endian format,
+ * so the low byte of each word is processed before the high byte.
+ *
+ * @note
+ * Since Oct 2021 both bytes of a word are processed for each count of
+ * LengthInBytes, so the length is really a number of 16 bit WORDS.  The
+ * parameter name is kept for the existing callers.
  *
  * @param	pBuffer			Pointer to buffer to calculate CRC of.
- * @param	LengthInBytes	Number of BYTES in the buffer.
+ * @param	LengthInBytes	Number of WORDS in the buffer (see note).
  * @param   InitialValue    Initial value to start the CRC off with.
  * @retval	uint16_t		Calculated CRC.
  *
@@ -140,58 +308,27 @@ uint16_t CRC_CCITTCalculate(const uint16_t * const pBuffer,
                             const uint16_t InitialValue)
 {
     uint16_t	Crc;
-//    uint16_t	next_byte;
-//    uint16_t	tmp;
-//    uint16_t	bitshift = 0u;	// Initial bit shift such that we do LSB first
-    uint16_t	index = 0u;
-    uint16_t    tmp_L;
-    uint16_t    tmp_H;
-    uint16_t  next_byte_L;
-    uint16_t  next_byte_H;
+    uint32_t	index = 0u;
 
     // Initial value for CCITT is normally either 0xFFFF or 0x1D0F.
     // Set the initial value to whatever is required here.
     Crc = InitialValue;
 
-//    while (LengthInBytes != 0u)
-//    {
-//    	// Get next byte by reading from 16 bit location, applying the
-//    	// appropriate bit shift and masking off the top 8 bits.
-//    	next_byte  = (pBuffer[index] >> bitshift) & 0x00FFu;
-//
-//    	// Add next byte to running CRC result.
-//    	tmp = (Crc >> 8) ^ next_byte;
-//    	Crc = (Crc << 8) ^ CRCtable[tmp];
-//
-//    	// Swap bit shift to do the 'other' byte - note that we
-//    	// only increment the index when we've done both bytes.
-//    	bitshift ^= 0x08u;
-//    	if (bitshift == 0u)
-//    	{
-//    		index++;
-//    	}
-//
-//    	LengthInBytes--;
-//    }
-    //crcУ20211005
-    while (LengthInBytes != 0u)
-     {
-         // Get next byte by reading from 16 bit location, applying the
-         // appropriate bit shift and masking off the top 8 bits.
-         next_byte_L  = (pBuffer[index] >> 0) & 0x00FFu;
-         next_byte_H  = (pBuffer[index] >> 8) & 0x00FFu;
-         // Add next byte to running CRC result.
-         tmp_L = (Crc >> 8) ^ next_byte_L;
-         Crc = (Crc << 8) ^ CRCtable[tmp_L];
-
-         tmp_H = (Crc >> 8) ^ next_byte_H;
-         Crc = (Crc << 8) ^ CRCtable[tmp_H];
-
-         // Swap bit shift to do the 'other' byte - note that we
-         // only increment the index when we've done both bytes.
-         index++;
-         LengthInBytes--;
-     }
+    // Two words at a time (one step for the slice-by-4 engine).
+    while (LengthInBytes >= 2u)
+    {
+        Crc = DirectDoubleWordStep(Crc, PackedWordGet(pBuffer[index]),
+                                   PackedWordGet(pBuffer[index + 1u]));
+        index += 2u;
+        LengthInBytes -= 2u;
+    }
+
+    // Odd word left over.
+    if (LengthInBytes != 0u)
+    {
+        Crc = DirectWordStep(Crc, PackedWordGet(pBuffer[index]));
+    }
+
     return Crc;
 }
 
@@ -212,27 +349,128 @@ uint16_t CRC_CCITTOnByteCalculate(const uint8_t * const pBuffer,
                                   const uint16_t InitialValue)
 {
     uint16_t	Crc;
-    uint16_t	next_byte;
+    uint16_t	next_word;
     uint16_t	tmp;
-    uint16_t	index = 0u;
+    uint32_t	index = 0u;
 
     // Initial value for CCITT is normally either 0xFFFF or 0x1D0F.
     // Set the initial value to whatever is required here.
     Crc = InitialValue;
 
-    while (LengthInBytes != 0u)
+    // Pairs of bytes are combined into a word, first byte in the top half,
+    // so that the word engine can process them in one step.
+    while (LengthInBytes >= 4u)
+    {
+        //lint -e{921} Cast to uint16_t
+        next_word = (uint16_t)(((uint16_t)pBuffer[index] & 0x00FFu) << 8)
+                    | ((uint16_t)pBuffer[index + 1u] & 0x00FFu);
+        //lint -e{921} Cast to uint16_t
+        tmp = (uint16_t)(((uint16_t)pBuffer[index + 2u] & 0x00FFu) << 8)
+              | ((uint16_t)pBuffer[index + 3u] & 0x00FFu);
+
+        Crc = DirectDoubleWordStep(Crc, next_word, tmp);
+        index += 4u;
+        LengthInBytes -= 4u;
+    }
+
+    if (LengthInBytes >= 2u)
+    {
+        //lint -e{921} Cast to uint16_t
+        next_word = (uint16_t)(((uint16_t)pBuffer[index] & 0x00FFu) << 8)
+                    | ((uint16_t)pBuffer[index + 1u] & 0x00FFu);
+
+        Crc = DirectWordStep(Crc, next_word);
+        index += 2u;
+        LengthInBytes -= 2u;
+    }
+
+    // Odd byte left over - add it to the running CRC result a byte at a time.
+    if (LengthInBytes != 0u)
     {
-    	// Get next byte by reading from 16 bit location, applying the
-    	// appropriate bit shift and masking off the top 8 bits.
         //lint -e{921} Cast to uint16_t
-    	next_byte  = (uint16_t)pBuffer[index];
-
-    	// Add next byte to running CRC result - the cast is to stop Lint
-    	// complaining about the << operator.
-    	tmp = (Crc >> 8) ^ next_byte;
-    	Crc = (Crc << 8) ^ CRCtable[tmp];
-    	index++;
-    	LengthInBytes--;
+        tmp = (Crc >> 8) ^ ((uint16_t)pBuffer[index] & 0x00FFu);
+        Crc = (uint16_t)(Crc << 8) ^ CRCtable[tmp];
+    }
+
+    return Crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * CRC_CCITTAugmentedCalculate runs the augmented (non-direct) form of the
+ * CCITT CRC over a certain number of words.  The data is assumed to be
+ * presented in little-endian format, so the low byte of each word is
+ * processed before the high byte.  The running value can be fed back in for
+ * the next block of data, and the result is finished off by feeding zeroes
+ * through it - see dsp_crc.c.
+ *
+ * @param	pBuffer			Pointer to buffer to calculate CRC of.
+ * @param	LengthInWords	Number of WORDS in the buffer.
+ * @param   RunningValue    Running CRC value to carry on from.
+ * @retval	uint16_t		Running CRC value.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t CRC_CCITTAugmentedCalculate(const uint16_t * const pBuffer,
+                                     uint32_t LengthInWords,
+                                     const uint16_t RunningValue)
+{
+    uint16_t	Crc;
+    uint32_t	index = 0u;
+
+    Crc = RunningValue;
+
+    while (LengthInWords >= 2u)
+    {
+        Crc = AugmentedDoubleWordStep(Crc, PackedWordGet(pBuffer[index]),
+                                      PackedWordGet(pBuffer[index + 1u]));
+        index += 2u;
+        LengthInWords -= 2u;
+    }
+
+    if (LengthInWords != 0u)
+    {
+        Crc = AugmentedWordStep(Crc, PackedWordGet(pBuffer[index]));
+    }
+
+    return Crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * CRC_CCITTAugmentedOnBytePairCalculate runs the augmented form of the CCITT
+ * CRC over a buffer holding one byte per word.  The bytes are taken in pairs
+ * in little-endian order, so the second byte of each pair is processed first.
+ *
+ * @warning
+ * An odd length is rounded up to a whole pair, so the word after the end of
+ * the buffer is read - this matches the original dsp_crc.c behaviour.
+ *
+ * @param	pBuffer			Pointer to buffer to calculate CRC of.
+ * @param	LengthInBytes	Number of BYTES (words) in the buffer.
+ * @param   RunningValue    Running CRC value to carry on from.
+ * @retval	uint16_t		Running CRC value.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t CRC_CCITTAugmentedOnBytePairCalculate(const uint16_t * const pBuffer,
+                                               const uint32_t LengthInBytes,
+                                               const uint16_t RunningValue)
+{
+    uint16_t	Crc;
+    uint16_t	next_word;
+    uint32_t	index;
+
+    Crc = RunningValue;
+
+    for (index = 0u; index < LengthInBytes; index += 2u)
+    {
+        next_word = (uint16_t)((pBuffer[index + 1u] & 0x00FFu) << 8)
+                    | (pBuffer[index] & 0x00FFu);
+
+        Crc = AugmentedWordStep(Crc, next_word);
     }
 
     return Crc;
@@ -263,5 +501,160 @@ uint16_t CheckNum_Calculate(const uint8_t * const pBuffer,
 }
 
 
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE - ONLY ACCESSIBLE WITHIN THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * PackedWordGet swaps the bytes of a little-endian data word, so that the
+ * byte which is processed first ends up in the top half of the word.
+ *
+ * This function is declared as inline, but will only be compiled inline if
+ * the optimiser is enabled.
+ *
+ * @param   PackedWord      Data word, low byte first.
+ * @retval  uint16_t        Data word, first byte in the top half.
+ *
+ */
+// ----------------------------------------------------------------------------
+static inline uint16_t PackedWordGet(const uint16_t PackedWord)
+{
+    //lint -e{921} Cast to uint16_t
+    return (uint16_t)((uint16_t)(PackedWord << 8) | (PackedWord >> 8));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * DirectWordStep adds two bytes to a direct form CRC, the first byte being
+ * in the top half of the word.  (CRC ^ W) * x^16 mod P.
+ *
+ * This function is declared as inline, but will only be compiled inline if
+ * the optimiser is enabled.
+ *
+ * @param   Crc             Running CRC.
+ * @param   Word            Next two bytes of data.
+ * @retval  uint16_t        Updated CRC.
+ *
+ */
+// ----------------------------------------------------------------------------
+static inline uint16_t DirectWordStep(const uint16_t Crc, const uint16_t Word)
+{
+    uint16_t    tmp;
+
+#if (CRC_ENGINE == CRC_ENGINE_BYTE_TABLE)
+    uint16_t    result;
+
+    tmp = (Crc >> 8) ^ (Word >> 8);
+    //lint -e{921} Cast to uint16_t
+    result = (uint16_t)(Crc << 8) ^ CRCtable[tmp];
+    tmp = (result >> 8) ^ (Word & 0x00FFu);
+    //lint -e{921} Cast to uint16_t
+    result = (uint16_t)(result << 8) ^ CRCtable[tmp];
+
+    return result;
+#else
+    tmp = Crc ^ Word;
+
+    return CRCtableX24[tmp >> 8] ^ CRCtable[tmp & 0x00FFu];
+#endif
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * DirectDoubleWordStep adds four bytes to a direct form CRC.
+ * (CRC ^ W1) * x^32 ^ W2 * x^16 mod P.
+ *
+ * This function is declared as inline, but will only be compiled inline if
+ * the optimiser is enabled.
+ *
+ * @param   Crc             Running CRC.
+ * @param   FirstWord       First two bytes of data.
+ * @param   SecondWord      Second two bytes of data.
+ * @retval  uint16_t        Updated CRC.
+ *
+ */
+// ----------------------------------------------------------------------------
+static inline uint16_t DirectDoubleWordStep(const uint16_t Crc,
+                                            const uint16_t FirstWord,
+                                            const uint16_t SecondWord)
+{
+#if (CRC_ENGINE == CRC_ENGINE_SLICE_BY_4)
+    uint16_t    tmp;
+
+    tmp = Crc ^ FirstWord;
+
+    return CRCtableX40[tmp >> 8] ^ CRCtableX32[tmp & 0x00FFu]
+           ^ CRCtableX24[SecondWord >> 8] ^ CRCtable[SecondWord & 0x00FFu];
+#else
+    return DirectWordStep(DirectWordStep(Crc, FirstWord), SecondWord);
+#endif
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * AugmentedWordStep adds two bytes to an augmented form CRC, the first byte
+ * being in the top half of the word.  CRC * x^16 ^ W mod P.
+ *
+ * This function is declared as inline, but will only be compiled inline if
+ * the optimiser is enabled.
+ *
+ * @param   Crc             Running CRC.
+ * @param   Word            Next two bytes of data.
+ * @retval  uint16_t        Updated CRC.
+ *
+ */
+// ----------------------------------------------------------------------------
+static inline uint16_t AugmentedWordStep(const uint16_t Crc,
+                                         const uint16_t Word)
+{
+#if (CRC_ENGINE == CRC_ENGINE_BYTE_TABLE)
+    uint16_t    result;
+
+    //lint -e{921} Cast to uint16_t
+    result = ((uint16_t)(Crc << 8) | (Word >> 8)) ^ CRCtable[Crc >> 8];
+    //lint -e{921} Cast to uint16_t
+    result = ((uint16_t)(result << 8) | (Word & 0x00FFu))
+             ^ CRCtable[result >> 8];
+
+    return result;
+#else
+    return Word ^ CRCtableX24[Crc >> 8] ^ CRCtable[Crc & 0x00FFu];
+#endif
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * AugmentedDoubleWordStep adds four bytes to an augmented form CRC.
+ * CRC * x^32 ^ W1 * x^16 ^ W2 mod P.
+ *
+ * This function is declared as inline, but will only be compiled inline if
+ * the optimiser is enabled.
+ *
+ * @param   Crc             Running CRC.
+ * @param   FirstWord       First two bytes of data.
+ * @param   SecondWord      Second two bytes of data.
+ * @retval  uint16_t        Updated CRC.
+ *
+ */
+// ----------------------------------------------------------------------------
+static inline uint16_t AugmentedDoubleWordStep(const uint16_t Crc,
+                                               const uint16_t FirstWord,
+                                               const uint16_t SecondWord)
+{
+#if (CRC_ENGINE == CRC_ENGINE_SLICE_BY_4)
+    return SecondWord
+           ^ CRCtableX40[Crc >> 8] ^ CRCtableX32[Crc & 0x00FFu]
+           ^ CRCtableX24[FirstWord >> 8] ^ CRCtable[FirstWord & 0x00FFu];
+#else
+    return AugmentedWordStep(AugmentedWordStep(Crc, FirstWord), SecondWord);
+#endif
+}
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
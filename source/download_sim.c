@@ -0,0 +1,226 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        download_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side timing simulation of an opcode 37 application download.
+ * @details
+ * Models the time taken to download an image with opcode 37, frame by frame,
+ * following the same sequence of events as the loader:
+ *
+ *  - The host sends a frame, which is received by the SSB receive interrupt.
+ *  - Synchronous programming - the loader programs the frame into the flash
+ *    and then replies, so the host waits for the flash on every frame.
+ *  - Double buffered programming - the loader stages the frame into one half
+ *    of the buffer and replies straight away.  The frame is programmed by
+ *    PromHardware_PendingProgramComplete() when the loader next waits for a
+ *    message, while the host is sending the next frame (the flash API
+ *    callback keeps the receiver going), so the next reply is only delayed if
+ *    programming takes longer than receiving the next frame.
+ *  - Before replying the loader waits for the RS485 driver to switch over.
+ *
+ * The link limited time is the same download with no flash program time, i.e.
+ * the best that can be done without changing the protocol or the baud rate.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "timer.h"
+#include "comm.h"
+#include "serial_comm.h"
+#include "download_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define BITS_PER_CHARACTER          10u     ///< Start, 8 data and stop bits.
+#define FRAME_OVERHEAD_CHARACTERS   13u     ///< SOF, address, length, opcode, address, size, checksum, EOF.
+#define REPLY_CHARACTERS            8u      ///< SOF, address, length, status, checksum, EOF.
+#define MAX_FRAME_DATA_BYTES        254u    ///< Largest even opcode 37 length.
+
+#define DEFAULT_CONFIG              { 57600u, 0x30000u, 254u, 50u, \
+                                      RS485_ENPIN_TOGGLE_TO_RX_DELAY * 1000u, 1000u, TRUE }
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static uint64_t download_time_get(const download_sim_config_t * const p_config,
+                                  const bool_t b_include_programming,
+                                  uint32_t * const p_frames,
+                                  uint64_t * const p_program_us);
+
+static uint64_t characters_time_get(const download_sim_config_t * const p_config,
+                                    const uint32_t characters);
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * download_sim_config_default fills in the configuration for a 0x30000 word
+ * application at 57600 baud, in full size opcode 37 frames, with the typical
+ * F28335 word program time and double buffering.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void download_sim_config_default(download_sim_config_t * const p_config)
+{
+    const download_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * download_sim_run simulates a download and returns the end to end time,
+ * along with the link limited time for the same download.
+ *
+ * @param   p_config    Pointer to the link and flash model.
+ * @param   p_result    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void download_sim_run(const download_sim_config_t * const p_config,
+                      download_sim_result_t * const p_result)
+{
+    uint64_t    synchronous_us;
+    uint32_t    frames;
+    uint64_t    program_us;
+
+    p_result->total_us        = download_time_get(p_config, TRUE, &frames, &program_us);
+    p_result->link_limited_us = download_time_get(p_config, FALSE, &frames, &program_us);
+    p_result->frames          = frames;
+    p_result->program_us      = program_us;
+
+    // Whatever the synchronous download would have spent waiting for the
+    // flash, and this one didn't, was hidden behind the reception.
+    synchronous_us = p_result->link_limited_us + program_us;
+    p_result->program_hidden_us = synchronous_us - p_result->total_us;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * download_time_get steps through the download one frame at a time.
+ *
+ * @param   p_config                Pointer to the link and flash model.
+ * @param   b_include_programming   FALSE to give the link limited time.
+ * @param   p_frames                Number of frames is written here.
+ * @param   p_program_us            Total flash program time is written here.
+ * @retval  uint64_t                Time until the last word is in the flash.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint64_t download_time_get(const download_sim_config_t * const p_config,
+                                  const bool_t b_include_programming,
+                                  uint32_t * const p_frames,
+                                  uint64_t * const p_program_us)
+{
+    uint32_t    frame_words;
+    uint32_t    words_remaining = p_config->image_words;
+    uint64_t    host_send_time = 0u;
+    uint64_t    receive_end_time;
+    uint64_t    message_time;
+    uint64_t    reply_end_time = 0u;
+    uint64_t    program_end_time = 0u;
+    uint64_t    program_time;
+
+    frame_words = p_config->frame_data_bytes >> 1;
+    if (frame_words > (MAX_FRAME_DATA_BYTES >> 1))
+    {
+        frame_words = MAX_FRAME_DATA_BYTES >> 1;
+    }
+    if (frame_words == 0u)
+    {
+        frame_words = 1u;
+    }
+
+    *p_frames = 0u;
+    *p_program_us = 0u;
+
+    while (words_remaining != 0u)
+    {
+        if (frame_words > words_remaining)
+        {
+            frame_words = words_remaining;
+        }
+
+        program_time = (uint64_t)frame_words * p_config->word_program_us;
+        *p_program_us += program_time;
+        if (!b_include_programming)
+        {
+            program_time = 0u;
+        }
+
+        receive_end_time = host_send_time
+                         + characters_time_get(p_config, (frame_words * 2u) + FRAME_OVERHEAD_CHARACTERS);
+
+        if (p_config->b_double_buffered)
+        {
+            // The message can't be handled until the previous frame has been
+            // programmed, and this frame is programmed after the reply.
+            message_time = (receive_end_time > program_end_time) ? receive_end_time : program_end_time;
+            reply_end_time = message_time + p_config->dsp_turnaround_us
+                           + characters_time_get(p_config, REPLY_CHARACTERS);
+            program_end_time = reply_end_time + program_time;
+        }
+        else
+        {
+            reply_end_time = receive_end_time + program_time + p_config->dsp_turnaround_us
+                           + characters_time_get(p_config, REPLY_CHARACTERS);
+            program_end_time = reply_end_time;
+        }
+
+        host_send_time = reply_end_time + p_config->host_turnaround_us;
+        words_remaining -= frame_words;
+        (*p_frames)++;
+    }
+
+    return (program_end_time > reply_end_time) ? program_end_time : reply_end_time;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * characters_time_get returns the time taken to send a number of characters.
+ *
+ * @param   p_config    Pointer to the link and flash model.
+ * @param   characters  Number of characters.
+ * @retval  uint64_t    Time in microseconds.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint64_t characters_time_get(const download_sim_config_t * const p_config,
+                                    const uint32_t characters)
+{
+    return ((uint64_t)characters * BITS_PER_CHARACTER * 1000000u) / p_config->baud_rate;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
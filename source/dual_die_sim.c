@@ -0,0 +1,328 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        dual_die_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side benchmark of erasing and writing both main flash devices.
+ * @details
+ * Erases and then writes a range of the simulated main flash (flash_sim.c)
+ * which is split evenly across the boundary between the two devices, two ways,
+ * and measures each with the simulated time:
+ *
+ *  - Serial - as flash_hal used to, erasing a sector at a time with
+ *    lld_SectorEraseOp, and writing the part in each device with
+ *    lld_memcpy_bytes, each of which waits for the device before going on.
+ *  - Parallel - flash_hal_device_erase and flash_hal_device_write, which
+ *    keep both devices busy at once.
+ *
+ * After each erase the range must be blank, and after each write it must hold
+ * the data written, so the benchmark also checks the parallel paths.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs and resets the
+ * simulated devices and initialises the flash HAL with its own map, in which
+ * logical and physical main flash addresses are the same.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "flash_hal.h"
+#include "lld.h"
+#include "flash_sim.h"
+#include "dual_die_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define MAIN_FLASH_LOWER_DEVICE_MAX     0x04000000u     ///< First word address in device one.
+#define SERIAL_WRITE_CHUNK_WORDS        0x8000u         ///< Words per lld_memcpy_bytes (max 65535).
+
+#define DEFAULT_CONFIG                  { 2u }
+
+/// Whole of the main flash in the first partition, the rest just fill the map.
+#define BENCHMARK_LOGICAL_ADDRESSES                                 \
+{                                                                   \
+    { STORAGE_DEVICE_MAIN_FLASH,   0x00000000u, 0x0FFFFFFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10000000u, 0x10001FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10002000u, 0x10003FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10004000u, 0x10005FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10006000u, 0x10007FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10008000u, 0x10009FFFu },      \
+    { STORAGE_DEVICE_I2C_EEPROM,   0x10010000u, 0x10010FFFu },      \
+}
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     serial_erase(const uint32_t word_address,
+                             const uint32_t number_of_sectors,
+                             const uint32_t sector_words);
+
+static void     serial_write(const uint32_t word_address,
+                             const uint32_t number_of_words);
+
+static bool_t   flash_check(const uint32_t byte_address,
+                            const uint32_t number_of_bytes,
+                            const bool_t b_blank);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static const flash_hal_logical_t m_logical_addresses[RS_CFG_MAX_NUMBER_OF_PARTITIONS]
+                                    = BENCHMARK_LOGICAL_ADDRESSES;
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_data[DUAL_DIE_SIM_MAX_BYTES];
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_flash_bytes[DUAL_DIE_SIM_MAX_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * dual_die_sim_config_default fills in the configuration for two sectors in
+ * each device.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void dual_die_sim_config_default(dual_die_sim_config_t * const p_config)
+{
+    const dual_die_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * dual_die_sim_run erases and writes the range each way.
+ *
+ * @param   p_config    Pointer to the range to use.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t dual_die_sim_run(const dual_die_sim_config_t * const p_config,
+                        dual_die_sim_result_t * const p_result)
+{
+    const uint32_t  sector_bytes = flash_hal_block_size_bytes_get(STORAGE_DEVICE_MAIN_FLASH);
+    uint32_t        range_bytes = 0u;
+    uint32_t        byte_address;
+    uint32_t        i;
+    uint64_t        start_ns;
+    bool_t          b_valid = FALSE;
+
+    if (p_config->sectors_per_die != 0u)
+    {
+        range_bytes = p_config->sectors_per_die * sector_bytes * 2u;
+
+        if (range_bytes <= DUAL_DIE_SIM_MAX_BYTES)
+        {
+            flash_sim_install();
+            flash_sim_reset();
+            b_valid = flash_hal_initialise(&m_logical_addresses[0]);
+        }
+    }
+
+    if (b_valid)
+    {
+        byte_address = (MAIN_FLASH_LOWER_DEVICE_MAX * 2u) - (range_bytes / 2u);
+
+        for (i = 0u; i < range_bytes; i++)
+        {
+            m_data[i] = (uint8_t)((i * 13u) ^ (i >> 8u));
+        }
+
+        /* Something to erase, then erase it both ways. */
+        (void)flash_sim_backdoor_write(STORAGE_DEVICE_MAIN_FLASH, byte_address, range_bytes, &m_data[0]);
+
+        start_ns = flash_sim_time_ns_get();
+        serial_erase(byte_address / 2u, p_config->sectors_per_die * 2u, sector_bytes / 2u);
+        p_result->serial_erase_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        p_result->b_erased = flash_check(byte_address, range_bytes, TRUE);
+
+        (void)flash_sim_backdoor_write(STORAGE_DEVICE_MAIN_FLASH, byte_address, range_bytes, &m_data[0]);
+        flash_hal_erased_cache_invalidate();
+
+        start_ns = flash_sim_time_ns_get();
+        if (flash_hal_device_erase(byte_address, range_bytes) != FLASH_HAL_NO_ERROR)
+        {
+            p_result->b_erased = FALSE;
+        }
+        p_result->parallel_erase_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        if (!flash_check(byte_address, range_bytes, TRUE))
+        {
+            p_result->b_erased = FALSE;
+        }
+
+        /* Write the data both ways, erasing in between. */
+        start_ns = flash_sim_time_ns_get();
+        serial_write(byte_address / 2u, range_bytes / 2u);
+        p_result->serial_write_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        p_result->b_data_matches = flash_check(byte_address, range_bytes, FALSE);
+
+        (void)flash_hal_device_erase(byte_address, range_bytes);
+
+        start_ns = flash_sim_time_ns_get();
+        if (flash_hal_device_write(byte_address, range_bytes, &m_data[0]) != FLASH_HAL_NO_ERROR)
+        {
+            p_result->b_data_matches = FALSE;
+        }
+        p_result->parallel_write_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        if (!flash_check(byte_address, range_bytes, FALSE))
+        {
+            p_result->b_data_matches = FALSE;
+        }
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * serial_erase erases one sector at a time, waiting for each, as
+ * main_flash_partial_erase used to.
+ *
+ * @param   word_address        First word address to erase.
+ * @param   number_of_sectors   Number of sectors to erase.
+ * @param   sector_words        Words in each sector.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void serial_erase(const uint32_t word_address,
+                         const uint32_t number_of_sectors,
+                         const uint32_t sector_words)
+{
+    uint32_t    address = word_address;
+    uint32_t    sector_counter;
+
+    for (sector_counter = 0u; sector_counter < number_of_sectors; sector_counter++)
+    {
+        if (address < MAIN_FLASH_LOWER_DEVICE_MAX)
+        {
+            (void)lld_SectorEraseOp(DEVICE_ZERO_BASE, address);
+        }
+        else
+        {
+            //lint -e{9078} -e{923} Cast from int to pointer.
+            (void)lld_SectorEraseOp(DEVICE_ONE_BASE, address - MAIN_FLASH_LOWER_DEVICE_MAX);
+        }
+
+        address += sector_words;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * serial_write writes the part of the data in each device with
+ * lld_memcpy_bytes, as main_flash_write used to.
+ *
+ * @param   word_address        First word address to write.
+ * @param   number_of_words     Number of words to write.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void serial_write(const uint32_t word_address,
+                         const uint32_t number_of_words)
+{
+    uint32_t    address = word_address;
+    uint32_t    words_remaining = number_of_words;
+    uint32_t    chunk_words;
+    uint32_t    byte_offset = 0u;
+
+    while (words_remaining != 0u)
+    {
+        chunk_words = (words_remaining > SERIAL_WRITE_CHUNK_WORDS) ? SERIAL_WRITE_CHUNK_WORDS : words_remaining;
+
+        if (address < MAIN_FLASH_LOWER_DEVICE_MAX)
+        {
+            if (chunk_words > (MAIN_FLASH_LOWER_DEVICE_MAX - address))
+            {
+                chunk_words = MAIN_FLASH_LOWER_DEVICE_MAX - address;
+            }
+
+            (void)lld_memcpy_bytes(DEVICE_ZERO_BASE, address, (uint16_t)chunk_words, &m_data[byte_offset]);
+        }
+        else
+        {
+            //lint -e{9078} -e{923} Cast from int to pointer.
+            (void)lld_memcpy_bytes(DEVICE_ONE_BASE, address - MAIN_FLASH_LOWER_DEVICE_MAX,
+                                   (uint16_t)chunk_words, &m_data[byte_offset]);
+        }
+
+        address         += chunk_words;
+        byte_offset     += chunk_words * 2u;
+        words_remaining -= chunk_words;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_check checks, straight from the simulated main flash, that a range
+ * is blank or holds the data written.
+ *
+ * @param   byte_address        First byte address to check.
+ * @param   number_of_bytes     Number of bytes to check.
+ * @param   b_blank             TRUE to check for blank, FALSE for the data.
+ * @retval  bool_t              TRUE if the range is as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t flash_check(const uint32_t byte_address,
+                          const uint32_t number_of_bytes,
+                          const bool_t b_blank)
+{
+    uint32_t    i;
+    bool_t      b_matches = TRUE;
+
+    (void)flash_sim_backdoor_read(STORAGE_DEVICE_MAIN_FLASH, byte_address,
+                                  number_of_bytes, &m_flash_bytes[0]);
+
+    for (i = 0u; i < number_of_bytes; i++)
+    {
+        if (m_flash_bytes[i] != (b_blank ? RS_CFG_BLANK_LOCATION_CONTAINS : m_data[i]))
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
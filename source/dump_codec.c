@@ -0,0 +1,520 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        dump_codec.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Lightweight compression of recording memory dumps.
+ * @details
+ * Most of a dumped partition is either erased (0xFF) or made of records which
+ * differ little from each other, so a simple byte oriented LZ77 coding with
+ * a special token for erased runs gives most of the benefit of a proper
+ * compressor, for very little code, time or RAM.  Each block is coded on its
+ * own, so every dump frame can be decoded without the ones before it.
+ *
+ * The coded block is a sequence of tokens:
+ * - 0x00 - 0x7F  Literals - (token + 1) bytes follow, copied as they are.
+ * - 0x80 - 0xBF  Match - copy (((token >> 2) & 0x0F) + 3) bytes from a
+ *                distance of (((token & 0x03) << 8) + next byte) + 1 bytes
+ *                back in the block.  The copy may overlap itself, so a
+ *                distance of 1 is a run of the previous byte.
+ * - 0xC0 - 0xDF  Erased run - ((token & 0x1F) << 8) + next byte + 1 bytes of
+ *                0xFF.
+ * - 0xE0 - 0xFF  Repeat match - copy (token & 0x1F) + 2 bytes from the same
+ *                distance as the last match (1 if there hasn't been one).
+ *
+ * Records which are written one after another mostly differ from the one
+ * before in a few fields, so once the record length has been found by a
+ * match, the parts between the changed fields are each coded in one byte by
+ * a repeat match.
+ *
+ * Matches are found with a single entry hash table of the last position at
+ * which each 3 byte sequence was seen, and by checking for a run of the
+ * previous byte and for a repeat of the last distance - this finds the
+ * repeated records and runs without searching.
+ *
+ * The encoder only stops at the end of the input or when the output is full,
+ * and says how much of the input was coded, so the caller can code a large
+ * block into a fixed size frame and carry on from where it got to.  The
+ * decoder is only built for UNIT_TEST_BUILD, as it is only needed by the host.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include "common_data_types.h"
+#include "dump_codec.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TOKEN_MATCH                 0x80u   ///< Match token type.
+#define TOKEN_ERASED_RUN            0xC0u   ///< Erased run token type.
+#define TOKEN_REPEAT_MATCH          0xE0u   ///< Repeat match token type.
+#define TOKEN_MATCH_TYPE_MASK       0xC0u   ///< Literal, match or other (erased or repeat).
+#define TOKEN_OTHER_TYPE_MASK       0xE0u   ///< Erased run or repeat match.
+#define TOKEN_MATCH_LENGTH_MASK     0x0Fu   ///< Match length bits, after shifting.
+#define TOKEN_MATCH_LENGTH_SHIFT    2u      ///< Match length bits position.
+#define TOKEN_MATCH_DISTANCE_MASK   0x03u   ///< Match distance MSBs.
+#define TOKEN_OTHER_LENGTH_MASK     0x1Fu   ///< Erased run and repeat match length bits.
+
+#define MAX_LITERALS                128u    ///< Longest run of literals.
+#define MIN_MATCH                   3u      ///< Shortest match worth coding (token is 2 bytes).
+#define MAX_MATCH                   (MIN_MATCH + TOKEN_MATCH_LENGTH_MASK)
+#define MAX_DISTANCE                0x400u  ///< Furthest back a match can copy from.
+#define MIN_REPEAT_MATCH            2u      ///< Shortest repeat match worth coding (token is 1 byte).
+#define MAX_REPEAT_MATCH            (MIN_REPEAT_MATCH + TOKEN_OTHER_LENGTH_MASK)
+#define MIN_ERASED_RUN              3u      ///< Shortest erased run worth coding (token is 2 bytes).
+#define MAX_ERASED_RUN              0x2000u ///< Longest erased run.
+#define MATCH_TOKEN_BYTES           2u      ///< Token and distance LSB.
+#define ERASED_RUN_TOKEN_BYTES      2u      ///< Token and length LSB.
+#define REPEAT_MATCH_TOKEN_BYTES    1u      ///< Token only.
+
+#define ERASED_BYTE                 0xFFu   ///< Erased flash.
+
+#define HASH_TABLE_ENTRIES          256u    ///< Must be a power of 2.
+#define NO_POSITION                 0xFFFFu ///< Hash table entry not used yet.
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static uint16_t erased_run_length_get(const uint8_t * const p_input,
+                                      const uint16_t length);
+
+static uint16_t match_length_get(const uint8_t * const p_input,
+                                 const uint16_t candidate,
+                                 const uint16_t position,
+                                 const uint16_t input_length,
+                                 const uint16_t max_length);
+
+static uint16_t literals_write(const uint8_t * const p_literals,
+                               const uint16_t count,
+                               uint8_t * const p_output);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// Last position of each 3 byte sequence in the block being coded.
+//lint -e{956} Doesn't need to be volatile.
+static uint16_t m_hash_table[HASH_TABLE_ENTRIES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * dump_codec_encode codes as much of a block as fits into the output buffer.
+ * An output buffer of DUMP_CODEC_MAX_ENCODED_BYTES(input_length) bytes always
+ * takes the whole block.
+ *
+ * @param   p_input             Pointer to the block to code.
+ * @param   input_length        Number of bytes in the block.
+ * @param   p_output            Pointer to the output buffer.
+ * @param   output_capacity     Size of the output buffer.
+ * @param   p_consumed          Number of input bytes which were coded.
+ * @retval  uint16_t            Number of bytes written to the output buffer.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t dump_codec_encode(const uint8_t * const p_input,
+                           const uint16_t input_length,
+                           uint8_t * const p_output,
+                           const uint16_t output_capacity,
+                           uint16_t * const p_consumed)
+{
+    uint16_t    position = 0u;
+    uint16_t    output_length = 0u;
+    uint16_t    literal_count = 0u;
+    uint16_t    literal_bytes;
+    uint16_t    run_length;
+    uint16_t    match_length;
+    uint16_t    match_distance = 0u;
+    uint16_t    last_distance = 1u;
+    uint16_t    repeat_length;
+    uint16_t    candidate_length;
+    uint16_t    token_type;
+    uint16_t    token_bytes;
+    uint16_t    hash;
+    uint16_t    i;
+    bool_t      b_output_full = FALSE;
+
+    for (i = 0u; i < HASH_TABLE_ENTRIES; i++)
+    {
+        m_hash_table[i] = NO_POSITION;
+    }
+
+    while ( (position < input_length) && (b_output_full == FALSE) )
+    {
+        match_length = 0u;
+        token_type = TOKEN_MATCH;
+        token_bytes = MATCH_TOKEN_BYTES;
+
+        run_length = erased_run_length_get(&p_input[position], input_length - position);
+
+        if (run_length >= MIN_ERASED_RUN)
+        {
+            match_length = run_length;
+            token_type = TOKEN_ERASED_RUN;
+            token_bytes = ERASED_RUN_TOKEN_BYTES;
+        }
+        else if ((uint16_t)(input_length - position) >= MIN_MATCH)
+        {
+            // Try a run of the previous byte, then the last time these three
+            // bytes were seen.
+            if (position != 0u)
+            {
+                match_length = match_length_get(p_input, position - 1u, position,
+                                                input_length, MAX_MATCH);
+                match_distance = 1u;
+            }
+
+            hash = ( ((uint16_t)p_input[position] << 5)
+                   ^ ((uint16_t)p_input[position + 1u] << 2)
+                   ^ (uint16_t)p_input[position + 2u] ) & (HASH_TABLE_ENTRIES - 1u);
+
+            if ( (m_hash_table[hash] != NO_POSITION)
+                    && ((uint16_t)(position - m_hash_table[hash]) <= MAX_DISTANCE) )
+            {
+                candidate_length = match_length_get(p_input, m_hash_table[hash], position,
+                                                    input_length, MAX_MATCH);
+                if (candidate_length > match_length)
+                {
+                    match_length = candidate_length;
+                    match_distance = position - m_hash_table[hash];
+                }
+            }
+
+            m_hash_table[hash] = position;
+        }
+        else
+        {
+            // Too close to the end for a match.
+        }
+
+        // A repeat of the last distance is a byte shorter, so it's used
+        // unless the other match is longer by more than a byte.
+        if ( (token_type == TOKEN_MATCH) && (position >= last_distance) )
+        {
+            repeat_length = match_length_get(p_input, position - last_distance, position,
+                                             input_length, MAX_REPEAT_MATCH);
+
+            if ( (repeat_length >= MIN_REPEAT_MATCH)
+                    && ((repeat_length + 1u) >= match_length) )
+            {
+                match_length = repeat_length;
+                match_distance = last_distance;
+                token_type = TOKEN_REPEAT_MATCH;
+                token_bytes = REPEAT_MATCH_TOKEN_BYTES;
+            }
+        }
+
+        if ( (match_length >= MIN_MATCH)
+                || ( (token_type == TOKEN_REPEAT_MATCH) && (match_length >= MIN_REPEAT_MATCH) ) )
+        {
+            // Write out the literals so far, then the token, if they fit.
+            literal_bytes = (literal_count != 0u) ? (literal_count + 1u) : 0u;
+
+            if ((output_length + literal_bytes + token_bytes) > output_capacity)
+            {
+                b_output_full = TRUE;
+            }
+            else
+            {
+                output_length += literals_write(&p_input[position - literal_count],
+                                                literal_count, &p_output[output_length]);
+                literal_count = 0u;
+
+                if (token_type == TOKEN_ERASED_RUN)
+                {
+                    //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+                    p_output[output_length]      = (uint8_t)(TOKEN_ERASED_RUN | ((match_length - 1u) >> 8));
+                    //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+                    p_output[output_length + 1u] = (uint8_t)((match_length - 1u) & 0xFFu);
+                }
+                else if (token_type == TOKEN_REPEAT_MATCH)
+                {
+                    //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+                    p_output[output_length]      = (uint8_t)(TOKEN_REPEAT_MATCH | (match_length - MIN_REPEAT_MATCH));
+                }
+                else
+                {
+                    //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+                    p_output[output_length]      = (uint8_t)(TOKEN_MATCH
+                                                             | ((match_length - MIN_MATCH) << TOKEN_MATCH_LENGTH_SHIFT)
+                                                             | ((match_distance - 1u) >> 8));
+                    //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+                    p_output[output_length + 1u] = (uint8_t)((match_distance - 1u) & 0xFFu);
+                    last_distance = match_distance;
+                }
+
+                output_length += token_bytes;
+                position += match_length;
+            }
+        }
+        // Otherwise this byte is a literal, if there's room for it along with
+        // its token.
+        else if ((output_length + literal_count + 2u) > output_capacity)
+        {
+            b_output_full = TRUE;
+        }
+        else
+        {
+            literal_count++;
+            position++;
+
+            if (literal_count == MAX_LITERALS)
+            {
+                output_length += literals_write(&p_input[position - literal_count],
+                                                literal_count, &p_output[output_length]);
+                literal_count = 0u;
+            }
+        }
+    }
+
+    // There's always room for the last literals.
+    output_length += literals_write(&p_input[position - literal_count],
+                                    literal_count, &p_output[output_length]);
+
+    *p_consumed = position;
+
+    return output_length;
+}
+
+
+#ifdef UNIT_TEST_BUILD
+// ----------------------------------------------------------------------------
+/**
+ * dump_codec_decode decodes a block coded by dump_codec_encode.
+ *
+ * @param   p_input             Pointer to the coded block.
+ * @param   input_length        Number of bytes in the coded block.
+ * @param   p_output            Pointer to the output buffer.
+ * @param   output_capacity     Size of the output buffer.
+ * @param   p_output_length     Number of bytes decoded.
+ * @retval  bool_t              FALSE if the coded block is not valid.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t dump_codec_decode(const uint8_t * const p_input,
+                         const uint16_t input_length,
+                         uint8_t * const p_output,
+                         const uint16_t output_capacity,
+                         uint16_t * const p_output_length)
+{
+    uint32_t    in = 0u;
+    uint32_t    out = 0u;
+    uint32_t    count = 0u;
+    uint32_t    distance = 0u;
+    uint32_t    last_distance = 1u;
+    uint32_t    i;
+    uint8_t     token;
+    bool_t      b_copy;
+    bool_t      b_valid = TRUE;
+
+    while ( (in < input_length) && (b_valid == TRUE) )
+    {
+        token = p_input[in];
+        b_copy = FALSE;
+
+        if ((token & TOKEN_MATCH) == 0u)
+        {
+            count = (uint32_t)token + 1u;
+
+            if ( ((in + 1u + count) > input_length) || ((out + count) > output_capacity) )
+            {
+                b_valid = FALSE;
+            }
+            else
+            {
+                for (i = 0u; i < count; i++)
+                {
+                    p_output[out + i] = p_input[in + 1u + i];
+                }
+                in += 1u + count;
+                out += count;
+            }
+        }
+        else if ((token & TOKEN_MATCH_TYPE_MASK) == TOKEN_MATCH)
+        {
+            count = (((uint32_t)token >> TOKEN_MATCH_LENGTH_SHIFT) & TOKEN_MATCH_LENGTH_MASK) + MIN_MATCH;
+
+            if ((in + MATCH_TOKEN_BYTES) > input_length)
+            {
+                b_valid = FALSE;
+            }
+            else
+            {
+                distance = (((uint32_t)token & TOKEN_MATCH_DISTANCE_MASK) << 8)
+                           + (uint32_t)p_input[in + 1u] + 1u;
+                last_distance = distance;
+                in += MATCH_TOKEN_BYTES;
+                b_copy = TRUE;
+            }
+        }
+        else if ((token & TOKEN_OTHER_TYPE_MASK) == TOKEN_REPEAT_MATCH)
+        {
+            count = ((uint32_t)token & TOKEN_OTHER_LENGTH_MASK) + MIN_REPEAT_MATCH;
+            distance = last_distance;
+            in += REPEAT_MATCH_TOKEN_BYTES;
+            b_copy = TRUE;
+        }
+        else
+        {
+            if ((in + ERASED_RUN_TOKEN_BYTES) > input_length)
+            {
+                b_valid = FALSE;
+            }
+            else
+            {
+                count = (((uint32_t)token & TOKEN_OTHER_LENGTH_MASK) << 8) + (uint32_t)p_input[in + 1u] + 1u;
+
+                if ((out + count) > output_capacity)
+                {
+                    b_valid = FALSE;
+                }
+                else
+                {
+                    for (i = 0u; i < count; i++)
+                    {
+                        p_output[out + i] = ERASED_BYTE;
+                    }
+                    in += ERASED_RUN_TOKEN_BYTES;
+                    out += count;
+                }
+            }
+        }
+
+        if (b_copy == TRUE)
+        {
+            if ( (distance > out) || ((out + count) > output_capacity) )
+            {
+                b_valid = FALSE;
+            }
+            else
+            {
+                // Byte by byte, as the copy may overlap itself.
+                for (i = 0u; i < count; i++)
+                {
+                    p_output[out + i] = p_output[(out + i) - distance];
+                }
+                out += count;
+            }
+        }
+    }
+
+    //lint -e{921} Cast to uint16_t, can't be more than output_capacity.
+    *p_output_length = (uint16_t)out;
+
+    return b_valid;
+}
+#endif /* UNIT_TEST_BUILD */
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * erased_run_length_get counts the erased bytes at the start of the input,
+ * up to the longest run which can be coded.
+ *
+ * @param   p_input     Pointer to the input.
+ * @param   length      Number of bytes left in the input.
+ * @retval  uint16_t    Number of erased bytes.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t erased_run_length_get(const uint8_t * const p_input,
+                                      const uint16_t length)
+{
+    uint16_t    run_length = 0u;
+
+    while ( (run_length < length) && (run_length < MAX_ERASED_RUN)
+            && (p_input[run_length] == ERASED_BYTE) )
+    {
+        run_length++;
+    }
+
+    return run_length;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * match_length_get counts how many bytes from an earlier position match the
+ * bytes at the current position, up to the longest match which can be coded.
+ *
+ * @param   p_input         Pointer to the block.
+ * @param   candidate       Earlier position in the block.
+ * @param   position        Current position in the block.
+ * @param   input_length    Number of bytes in the block.
+ * @param   max_length      Longest match which can be coded.
+ * @retval  uint16_t        Number of matching bytes.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t match_length_get(const uint8_t * const p_input,
+                                 const uint16_t candidate,
+                                 const uint16_t position,
+                                 const uint16_t input_length,
+                                 const uint16_t max_length)
+{
+    uint16_t    length = 0u;
+
+    while ( (length < max_length) && (length < (input_length - position))
+            && (p_input[candidate + length] == p_input[position + length]) )
+    {
+        length++;
+    }
+
+    return length;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * literals_write writes a literal token and the literals, if there are any.
+ *
+ * @param   p_literals  Pointer to the literals.
+ * @param   count       Number of literals (up to MAX_LITERALS).
+ * @param   p_output    Pointer to where to write the token.
+ * @retval  uint16_t    Number of bytes written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t literals_write(const uint8_t * const p_literals,
+                               const uint16_t count,
+                               uint8_t * const p_output)
+{
+    uint16_t    i;
+    uint16_t    written = 0u;
+
+    if (count != 0u)
+    {
+        //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+        p_output[0] = (uint8_t)(count - 1u);
+
+        for (i = 0u; i < count; i++)
+        {
+            p_output[1u + i] = p_literals[i];
+        }
+
+        written = count + 1u;
+    }
+
+    return written;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,365 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        erase_suspend_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side check of reads during a background main flash erase.
+ * @details
+ * Erases a range of sectors in the simulated main flash (flash_sim.c) twice:
+ *
+ *  - With flash_hal_device_erase, which holds everything up until the last
+ *    sector has been erased - this is how long a read could have to wait.
+ *  - With flash_hal_device_erase_start and flash_hal_erase_poll, reading a
+ *    block from another sector of the same device and a block from the other
+ *    device between polls.
+ *
+ * Each read is measured with the simulated bus time and checked against the
+ * contents of the simulated flash, and the erase suspends and resumes are
+ * counted.  An early suspend (one too soon after a resume for the erase to
+ * make progress) means the flash HAL isn't keeping to the minimum interval.
+ * At the end the erased range must be blank.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs and resets the
+ * simulated devices and initialises the flash HAL with its own map, in which
+ * logical and physical main flash addresses are the same.  The flash HAL
+ * times the erase with the millisecond timer, so Timer_StopWatchSet() and
+ * Timer_StopWatchGet() must run from flash_sim_time_ns_get().
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "flash_hal.h"
+#include "flash_sim.h"
+#include "erase_suspend_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define MAIN_FLASH_DIE_SIZE_BYTES   0x08000000u     ///< Bytes in each main flash device.
+#define READ_WINDOW_BYTES           0x00010000u     ///< Bytes read round and round in each device.
+
+#define DEFAULT_CONFIG              { 0x00100000u, 4u, 512u, 1u }
+
+/// Whole of the main flash in the first partition, the rest just fill the map.
+#define BENCHMARK_LOGICAL_ADDRESSES                                 \
+{                                                                   \
+    { STORAGE_DEVICE_MAIN_FLASH,   0x00000000u, 0x0FFFFFFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10000000u, 0x10001FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10002000u, 0x10003FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10004000u, 0x10005FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10006000u, 0x10007FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10008000u, 0x10009FFFu },      \
+    { STORAGE_DEVICE_I2C_EEPROM,   0x10010000u, 0x10010FFFu },      \
+}
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     area_fill(const uint32_t address,
+                          const uint32_t number_of_bytes);
+
+static bool_t   area_blank_check(const uint32_t address,
+                                 const uint32_t number_of_bytes);
+
+static bool_t   timed_read(const uint32_t address,
+                           const uint32_t number_of_bytes,
+                           erase_suspend_sim_reads_t * const p_reads);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static const flash_hal_logical_t m_logical_addresses[RS_CFG_MAX_NUMBER_OF_PARTITIONS]
+                                    = BENCHMARK_LOGICAL_ADDRESSES;
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_read_bytes[ERASE_SUSPEND_SIM_MAX_READ_BYTES];
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_flash_bytes[ERASE_SUSPEND_SIM_MAX_READ_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * erase_suspend_sim_config_default fills in the configuration for erasing
+ * four sectors at 1MB, with a 512 byte read (the size of a dump frame) from
+ * each device after every poll.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void erase_suspend_sim_config_default(erase_suspend_sim_config_t * const p_config)
+{
+    const erase_suspend_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * erase_suspend_sim_run erases the configured range both ways.
+ *
+ * @param   p_config    Pointer to the range to erase.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t erase_suspend_sim_run(const erase_suspend_sim_config_t * const p_config,
+                             erase_suspend_sim_result_t * const p_result)
+{
+    const erase_suspend_sim_reads_t no_reads = { 0u, 0u, 0u };
+    const uint32_t      sector_bytes = flash_hal_block_size_bytes_get(STORAGE_DEVICE_MAIN_FLASH);
+    uint32_t            erase_bytes = 0u;
+    uint32_t            same_die_window;
+    uint32_t            read_offset = 0u;
+    uint32_t            poll_counter;
+    uint64_t            start_ns;
+    flash_sim_stats_t   stats_at_start;
+    flash_sim_stats_t   stats;
+    flash_hal_error_t   erase_status = FLASH_HAL_WRITE_FAIL;
+    bool_t              b_erasing;
+    bool_t              b_valid = FALSE;
+
+    if ( (p_config->erase_sectors != 0u)
+            && (p_config->erase_sectors <= ((MAIN_FLASH_DIE_SIZE_BYTES - READ_WINDOW_BYTES) / sector_bytes))
+            && ((p_config->erase_address % sector_bytes) == 0u)
+            && (p_config->read_bytes != 0u)
+            && (p_config->read_bytes <= ERASE_SUSPEND_SIM_MAX_READ_BYTES)
+            && ((p_config->read_bytes & 1u) == 0u)
+            && (p_config->polls_per_read != 0u) )
+    {
+        erase_bytes = p_config->erase_sectors * sector_bytes;
+
+        if (p_config->erase_address <= (MAIN_FLASH_DIE_SIZE_BYTES - READ_WINDOW_BYTES - erase_bytes))
+        {
+            flash_sim_install();
+            flash_sim_reset();
+            b_valid = flash_hal_initialise(&m_logical_addresses[0]);
+        }
+    }
+
+    if (b_valid)
+    {
+        same_die_window = p_config->erase_address + erase_bytes;
+
+        p_result->same_die       = no_reads;
+        p_result->other_die      = no_reads;
+        p_result->polls          = 0u;
+        p_result->b_data_matches = TRUE;
+
+        /* The old way - nothing else can happen until the erase is done. */
+        area_fill(p_config->erase_address, erase_bytes);
+
+        start_ns = flash_sim_time_ns_get();
+        (void)flash_hal_device_erase(p_config->erase_address, erase_bytes);
+        p_result->blocking_erase_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        /* In the background, reading between polls. */
+        area_fill(p_config->erase_address, erase_bytes);
+        area_fill(same_die_window, READ_WINDOW_BYTES);
+        area_fill(MAIN_FLASH_DIE_SIZE_BYTES, READ_WINDOW_BYTES);
+        flash_hal_erased_cache_invalidate();
+
+        flash_sim_stats_get(&stats_at_start);
+        start_ns = flash_sim_time_ns_get();
+
+        b_erasing = (flash_hal_device_erase_start(p_config->erase_address, erase_bytes)
+                        == FLASH_HAL_NO_ERROR);
+
+        while (b_erasing)
+        {
+            for (poll_counter = 0u; (poll_counter < p_config->polls_per_read) && b_erasing; poll_counter++)
+            {
+                b_erasing = flash_hal_erase_poll(&erase_status);
+                p_result->polls++;
+            }
+
+            if (!timed_read(same_die_window + read_offset, p_config->read_bytes, &p_result->same_die))
+            {
+                p_result->b_data_matches = FALSE;
+            }
+
+            if (!timed_read(MAIN_FLASH_DIE_SIZE_BYTES + read_offset, p_config->read_bytes, &p_result->other_die))
+            {
+                p_result->b_data_matches = FALSE;
+            }
+
+            read_offset = (read_offset + p_config->read_bytes) % (READ_WINDOW_BYTES - p_config->read_bytes);
+        }
+
+        p_result->background_erase_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        flash_sim_stats_get(&stats);
+        p_result->erase_suspends         = stats.main_flash_erase_suspends - stats_at_start.main_flash_erase_suspends;
+        p_result->erase_resumes          = stats.main_flash_erase_resumes - stats_at_start.main_flash_erase_resumes;
+        p_result->early_suspends         = stats.main_flash_early_suspends - stats_at_start.main_flash_early_suspends;
+        p_result->suspended_sector_reads = stats.main_flash_suspended_sector_reads
+                                                - stats_at_start.main_flash_suspended_sector_reads;
+
+        p_result->b_erase_ok = (erase_status == FLASH_HAL_NO_ERROR)
+                                    && area_blank_check(p_config->erase_address, erase_bytes);
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * area_fill writes a pattern, which depends on the address, straight into
+ * the simulated main flash.
+ *
+ * @param   address             First byte address to fill.
+ * @param   number_of_bytes     Number of bytes to fill.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void area_fill(const uint32_t address,
+                      const uint32_t number_of_bytes)
+{
+    uint32_t    offset = 0u;
+    uint32_t    chunk_bytes;
+    uint32_t    i;
+
+    while (offset < number_of_bytes)
+    {
+        chunk_bytes = number_of_bytes - offset;
+        if (chunk_bytes > ERASE_SUSPEND_SIM_MAX_READ_BYTES)
+        {
+            chunk_bytes = ERASE_SUSPEND_SIM_MAX_READ_BYTES;
+        }
+
+        for (i = 0u; i < chunk_bytes; i++)
+        {
+            m_flash_bytes[i] = (uint8_t)(((address + offset + i) * 7u) ^ ((address + offset + i) >> 8u));
+        }
+
+        (void)flash_sim_backdoor_write(STORAGE_DEVICE_MAIN_FLASH, address + offset,
+                                       chunk_bytes, &m_flash_bytes[0]);
+
+        offset += chunk_bytes;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * area_blank_check checks, straight from the simulated main flash, that an
+ * area is blank.
+ *
+ * @param   address             First byte address to check.
+ * @param   number_of_bytes     Number of bytes to check.
+ * @retval  bool_t              TRUE if every byte is blank.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t area_blank_check(const uint32_t address,
+                               const uint32_t number_of_bytes)
+{
+    uint32_t    offset = 0u;
+    uint32_t    chunk_bytes;
+    uint32_t    i;
+    bool_t      b_blank = TRUE;
+
+    while ( (offset < number_of_bytes) && b_blank )
+    {
+        chunk_bytes = number_of_bytes - offset;
+        if (chunk_bytes > ERASE_SUSPEND_SIM_MAX_READ_BYTES)
+        {
+            chunk_bytes = ERASE_SUSPEND_SIM_MAX_READ_BYTES;
+        }
+
+        (void)flash_sim_backdoor_read(STORAGE_DEVICE_MAIN_FLASH, address + offset,
+                                      chunk_bytes, &m_flash_bytes[0]);
+
+        for (i = 0u; i < chunk_bytes; i++)
+        {
+            if (m_flash_bytes[i] != RS_CFG_BLANK_LOCATION_CONTAINS)
+            {
+                b_blank = FALSE;
+            }
+        }
+
+        offset += chunk_bytes;
+    }
+
+    return b_blank;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * timed_read reads through the flash HAL, measures the simulated time the
+ * read took, and checks the data against the simulated flash.
+ *
+ * @param   address             First byte address to read.
+ * @param   number_of_bytes     Number of bytes to read.
+ * @param   p_reads             Pointer to the reads to add this one to.
+ * @retval  bool_t              TRUE if the data read is what is in the flash.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t timed_read(const uint32_t address,
+                         const uint32_t number_of_bytes,
+                         erase_suspend_sim_reads_t * const p_reads)
+{
+    uint64_t    start_ns;
+    uint64_t    read_us;
+    uint32_t    i;
+    bool_t      b_matches = TRUE;
+
+    start_ns = flash_sim_time_ns_get();
+    (void)flash_hal_device_read(address, number_of_bytes, &m_read_bytes[0]);
+    read_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+    p_reads->reads++;
+    p_reads->total_us += read_us;
+    if (read_us > p_reads->longest_us)
+    {
+        p_reads->longest_us = read_us;
+    }
+
+    (void)flash_sim_backdoor_read(STORAGE_DEVICE_MAIN_FLASH, address,
+                                  number_of_bytes, &m_flash_bytes[0]);
+
+    for (i = 0u; i < number_of_bytes; i++)
+    {
+        if (m_read_bytes[i] != m_flash_bytes[i])
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 #define GPATOGGLE_ADDRESS	            0x00006FC6u		///< Address for GPATOGGLE register
 #define GPIO_BIT_MASK	                0x07F00000u		///< bit mask to clear GPIO[26:20]
 #define OUT_OF_RANGE_MASK			    0xFFF00000u		///< bit mask for out of range addresses
+#define WINDOW_SIZE_IN_WORDS		    0x00100000u		///< words reached by XA0 - XA19
 
 
 // ----------------------------------------------------------------------------
@@ -115,6 +116,74 @@ static void Extflash_ExternalFlashWrite_Impl(uint32_t address, const uint16_t da
 void (*EXTFLASH_ExternalFlashWrite)(uint32_t address, const uint16_t data) = Extflash_ExternalFlashWrite_Impl;
 
 
+// ----------------------------------------------------------------------------
+/**
+ * Extflash_ExternalFlashBlockRead_Impl reads a block of consecutive 16 bit
+ * words, starting from a 32 bit address.
+ *
+ * Unlike Extflash_ExternalFlashRead_Impl, GPIO[26:20] are only set up when
+ * the block crosses into a new 1M word window, and the words within a window
+ * are copied straight from zone 7, four at a time.
+ *
+ * @param	address			Address to start reading from.
+ * @param	number_of_words	Number of words to read.
+ * @param	p_data			Pointer to buffer to put the read data in.
+ *
+*/
+// ----------------------------------------------------------------------------
+static void Extflash_ExternalFlashBlockRead_Impl(uint32_t address, uint32_t number_of_words,
+                                                 uint16_t * const p_data)
+{
+	volatile const uint16_t	*p_flash;
+	uint16_t				*p_destination = p_data;
+	uint32_t				window_words;
+
+	while (number_of_words != 0u)
+	{
+		// Set address bits 26:20 once for this window.
+		SetupTopAddressBits(address);
+
+		// Read up to the end of the window, or the end of the block.
+		window_words = WINDOW_SIZE_IN_WORDS - (address & ~OUT_OF_RANGE_MASK);
+		if (window_words > number_of_words)
+		{
+			window_words = number_of_words;
+		}
+
+		//lint -e{923} Cast from unsigned long to pointer - zone 7 is a fixed address.
+		p_flash = (volatile const uint16_t *)(uintptr_t)((address & ~OUT_OF_RANGE_MASK) | XZCS7_ADDRESS_ZONE);
+
+		address         += window_words;
+		number_of_words -= window_words;
+
+		while (window_words >= 4u)
+		{
+			p_destination[0] = p_flash[0];
+			p_destination[1] = p_flash[1];
+			p_destination[2] = p_flash[2];
+			p_destination[3] = p_flash[3];
+			p_destination = &p_destination[4];
+			p_flash       = &p_flash[4];
+			window_words -= 4u;
+		}
+
+		while (window_words != 0u)
+		{
+			*p_destination = *p_flash;
+			p_destination++;
+			p_flash++;
+			window_words--;
+		}
+	}
+}
+
+/// This is the defining instance of the global function pointer EXTFLASH_ExternalFlashBlockRead.
+/// The pointer is initialised to point to Extflash_ExternalFlashBlockRead_Impl.
+//lint -e{956} Doesn't need to be volatile.
+void (*EXTFLASH_ExternalFlashBlockRead)(uint32_t address, uint32_t number_of_words,
+                                        uint16_t * const p_data) = Extflash_ExternalFlashBlockRead_Impl;
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 // FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
@@ -0,0 +1,195 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        fast_dump_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side timing simulation of an opcode 46 logging memory dump.
+ * @details
+ * Models the time taken to dump the logging memory with opcode 46, frame by
+ * frame, following the same sequence of events as the loader:
+ *
+ *  - Blocking dump - each frame is read and its CRC computed, then it is sent,
+ *    and the loader polls for the end of the transmission every
+ *    transmit_wait_us, so every frame takes at least one polling delay.
+ *  - Overlapped dump - the frames are sent from two ping-pong buffers by the
+ *    SCI transmit interrupt.  The next frame is read and its CRC computed
+ *    while the previous one is being sent, and is started as soon as the
+ *    previous one has gone, so the link only waits if preparing a frame takes
+ *    longer than sending one.
+ *
+ * The wire time is the time the characters of the dump take at the baud rate,
+ * i.e. the best that can be done without changing the protocol or the baud
+ * rate.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "fast_dump_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define BITS_PER_CHARACTER          10u     ///< Start, 8 data and stop bits.
+#define FRAME_OVERHEAD_CHARACTERS   12u     ///< SOF, address, length, status, offset, CRC, EOF.
+#define MAX_FRAME_DATA_BYTES        512u    ///< Size of the frame buffers.
+
+#define DEFAULT_CONFIG              { 921600u, 0x100000u, 512u, 200u, 100u, 50000u, TRUE }
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static uint64_t characters_time_get(const fast_dump_sim_config_t * const p_config,
+                                    const uint32_t characters);
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * fast_dump_sim_config_default fills in the configuration for a 1 Mbyte dump
+ * at 921600 baud, in full size frames, with typical logging memory read and
+ * CRC times and the overlapped dump.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void fast_dump_sim_config_default(fast_dump_sim_config_t * const p_config)
+{
+    const fast_dump_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * fast_dump_sim_run simulates a dump and returns the end to end time, along
+ * with the wire time for the same dump.
+ *
+ * @param   p_config    Pointer to the link and memory model.
+ * @param   p_result    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void fast_dump_sim_run(const fast_dump_sim_config_t * const p_config,
+                       fast_dump_sim_result_t * const p_result)
+{
+    uint32_t    frame_bytes;
+    uint32_t    bytes_remaining = p_config->dump_bytes;
+    uint64_t    prepare_time;
+    uint64_t    send_time;
+    uint64_t    prepare_end_time = 0u;
+    uint64_t    send_end_time = 0u;
+    uint64_t    previous_send_end_time = 0u;
+    uint64_t    send_start_time;
+    uint64_t    waits;
+
+    frame_bytes = p_config->frame_data_bytes;
+    if (frame_bytes > MAX_FRAME_DATA_BYTES)
+    {
+        frame_bytes = MAX_FRAME_DATA_BYTES;
+    }
+    if (frame_bytes == 0u)
+    {
+        frame_bytes = 1u;
+    }
+
+    p_result->frames     = 0u;
+    p_result->wire_us    = 0u;
+    p_result->prepare_us = 0u;
+
+    while (bytes_remaining != 0u)
+    {
+        if (frame_bytes > bytes_remaining)
+        {
+            frame_bytes = bytes_remaining;
+        }
+
+        prepare_time = ((uint64_t)frame_bytes
+                     * (p_config->read_ns_per_byte + p_config->crc_ns_per_byte)) / 1000u;
+        send_time = characters_time_get(p_config, frame_bytes + FRAME_OVERHEAD_CHARACTERS);
+
+        p_result->prepare_us += prepare_time;
+        p_result->wire_us    += send_time;
+
+        if (p_config->b_overlapped)
+        {
+            // A frame can only be prepared once the previous one is ready and
+            // its buffer (the one sent two frames ago) has been sent.
+            prepare_end_time = ((prepare_end_time > previous_send_end_time) ?
+                                prepare_end_time : previous_send_end_time) + prepare_time;
+
+            send_start_time = (prepare_end_time > send_end_time) ? prepare_end_time : send_end_time;
+            previous_send_end_time = send_end_time;
+            send_end_time = send_start_time + send_time;
+        }
+        else
+        {
+            // The end of the transmission is only seen at the end of a
+            // polling delay.
+            waits = 1u;
+            if (p_config->transmit_wait_us != 0u)
+            {
+                waits = (send_time + p_config->transmit_wait_us - 1u) / p_config->transmit_wait_us;
+                if (waits == 0u)
+                {
+                    waits = 1u;
+                }
+            }
+            send_end_time += prepare_time
+                           + ((p_config->transmit_wait_us != 0u) ?
+                              (waits * p_config->transmit_wait_us) : send_time);
+        }
+
+        bytes_remaining -= frame_bytes;
+        p_result->frames++;
+    }
+
+    p_result->total_us = send_end_time;
+    p_result->link_utilisation_percent = (send_end_time == 0u) ? 100u :
+            (uint32_t)((p_result->wire_us * 100u) / send_end_time);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * characters_time_get returns the time taken to send a number of characters.
+ *
+ * @param   p_config    Pointer to the link and memory model.
+ * @param   characters  Number of characters.
+ * @retval  uint64_t    Time in microseconds.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint64_t characters_time_get(const fast_dump_sim_config_t * const p_config,
+                                    const uint32_t characters)
+{
+    return ((uint64_t)characters * BITS_PER_CHARACTER * 1000000u) / p_config->baud_rate;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -35,6 +35,7 @@
 #include "lld.h"			// chipset drivers for Spansion flash
 #include "M95.h"			// chipset drivers for M95M01 serial flash
 #include "x24lc32a.h"			// chipset drivers for X24LC32A serial EEPROM
+#include "flash_hal.h"		// erased cache must forget anything written here
 
 
 // ----------------------------------------------------------------------------
@@ -94,7 +95,7 @@ void FLASH_Read(const EFLASHDeviceNumber_t device, const uint32_t address,
 			break;
 
 		case FLASH_DEVICE_SERIAL:
-			M95_BlockRead(address, WordCount, pData);
+			(void)M95_BlockRead(address, WordCount, pData);
 			break;
 
 		// Discard return value from read - if it doesn't work we'll
@@ -394,6 +395,10 @@ static EFLASHProgramStatus_t Flash_ParallelFlashWrite
 	DEVSTATUS				WriteStatus;
 	EFLASHProgramStatus_t	ReturnValue;
 
+	// This write doesn't go through the flash HAL, so the HAL can no longer
+	// trust what it knows about which pages are erased.
+	flash_hal_erased_cache_invalidate();
+
 	if (address < LOWER_DEVICE_MAX)
 	{
 		WriteStatus = lld_memcpy(DEVICE_ZERO_BASE, address, (uint16_t)WordCount, pData);
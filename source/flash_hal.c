@@ -16,15 +16,29 @@
 #include "i2c.h"
 #include "x24lc32a.h"         // chipset drivers for X24LC32A serial EEPROM
 #include "buffer_utils.h"
+#include "timer.h"
 
 
 // ----------------------------------------------------------------------------
 // Defines section - add all #defines here:
 
 #define MAIN_FLASH_LOWER_DEVICE_MAX     0x04000000u     ///< maximum word address in device zero
+#define MAIN_FLASH_DEVICES              2u              ///< Devices which make up the main flash
+#define READ_CHUNK_SIZE_IN_WORDS        32u             ///< Words staged per chunk by the read functions
+#define MAIN_FLASH_SIZE_IN_BYTES        0x10000000u     ///< Both main flash devices
+#define ERASED_CACHE_UNIT_BYTES         (RS_CFG_PAGE_SIZE_KB * 1024u)   ///< Erased cache granularity, one page
+#define ERASED_CACHE_UNITS              (MAIN_FLASH_SIZE_IN_BYTES / ERASED_CACHE_UNIT_BYTES)
+#define ERASED_CACHE_UNITS_PER_WORD     16u             ///< Bits in each word of the erased cache
 #define M95_PAGE_SIZE_IN_BYTES          128u            ///< Page is 128 bytes
 #define X24LC32A_PAGE_SIZE_IN_BYTES       32u             ///< Page is 16 bytes
 
+/*
+ * A suspended erase needs about 100us after it resumes before it makes any
+ * progress.  The stopwatch counts in 1ms ticks, so waiting for two of them
+ * guarantees at least 1ms, and a stream of reads can't stop the erase.
+ */
+#define ERASE_RESUME_TO_SUSPEND_TICKS   2u
+
 
 // ----------------------------------------------------------------------------
 // Function prototypes for functions which only have scope within this module:
@@ -43,6 +57,10 @@ static void     main_flash_read(const uint32_t byte_address,
                                 const uint32_t bytes_to_read,
                                 uint8_t * const p_byte_data);
 
+static void     main_flash_words_read(const uint32_t word_address,
+                                      const uint32_t words_to_read,
+                                      uint16_t * const p_word_data);
+
 static flash_hal_error_t main_flash_write(const uint32_t byte_address,
                                           const uint32_t bytes_to_write,
                                           const uint8_t * const p_byte_data);
@@ -72,6 +90,47 @@ static bool_t check_one_flash_address_blank(const uint32_t word_address);
 
 static bool_t check_one_flash_sector_blank(const uint32_t start_word_address);
 
+static void   erased_cache_mark(const uint32_t byte_address,
+                                const uint32_t number_of_bytes);
+
+static void   erased_cache_clear(const uint32_t byte_address,
+                                 const uint32_t number_of_bytes);
+
+static bool_t erased_cache_check(const uint32_t byte_address,
+                                 const uint32_t number_of_bytes);
+
+static bool_t erase_range_check(const uint32_t logical_start_address,
+                                const uint32_t number_of_bytes_to_erase,
+                                uint32_t * const p_physical_address,
+                                storage_devices_t * const p_physical_device);
+
+static void   erase_step(void);
+
+static void   erase_sector_start(void);
+
+static void   erase_sector_check(void);
+
+static void   erase_sector_wait(const uint32_t word_address,
+                                const uint32_t number_of_words);
+
+static bool_t erase_access_suspend(const uint32_t word_address,
+                                   const uint32_t number_of_words);
+
+static void   erase_access_resume(void);
+
+static bool_t erase_die_check(const uint32_t word_address,
+                              const uint32_t number_of_words);
+
+static void   main_flash_device_get(const uint32_t word_address,
+                                    FLASHDATA ** const pp_device,
+                                    ADDRESS * const p_device_offset);
+
+static void   main_flash_die_split(const uint32_t word_address,
+                                   const uint32_t number_of_words,
+                                   flash_hal_die_op_t * const p_die_op);
+
+static FLASHDATA* main_flash_die_base_get(const uint32_t die);
+
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module:
@@ -88,6 +147,24 @@ static address_translation_t  m_address_map[RS_CFG_MAX_NUMBER_OF_PARTITIONS];
 //lint -e{956} Doesn't need to be volatile.
 static storage_devices_t      m_current_device_used_for_write;
 
+//lint -e{956} Doesn't need to be volatile.
+static uint16_t               m_read_chunk_words[READ_CHUNK_SIZE_IN_WORDS];
+
+//lint -e{956} Doesn't need to be volatile.
+static uint8_t                m_read_chunk_bytes[READ_CHUNK_SIZE_IN_WORDS * 2u];
+
+/*
+ * One bit per page of the main flash, set when the whole page is known to be
+ * erased.  Bits are set by erases and by blank checks which pass, and cleared
+ * before anything is written, so a set bit can always be trusted.  The cache
+ * starts empty and fills in again as the recording system runs.
+ */
+//lint -e{956} Doesn't need to be volatile.
+static uint16_t               m_erased_cache[ERASED_CACHE_UNITS / ERASED_CACHE_UNITS_PER_WORD];
+
+//lint -e{956} Doesn't need to be volatile.
+static flash_hal_erase_t      m_erase = { FALSE, FALSE, FALSE, 0u, 0u, 0u, FLASH_HAL_NO_ERROR };
+
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -109,6 +186,12 @@ bool_t flash_hal_initialise(const flash_hal_logical_t * const p_logical_addresse
 
     m_b_flash_hal_initialised = FALSE;
 
+    flash_hal_erased_cache_invalidate();
+
+    m_erase.b_in_progress    = FALSE;
+    m_erase.b_sector_running = FALSE;
+    m_erase.b_suspended      = FALSE;
+
     if (p_logical_addresses != NULL)
     {
         b_physical_structure_ok = check_physical_structure();
@@ -197,21 +280,41 @@ flash_hal_error_t flash_hal_device_read
                 if ( ((logical_start_address & 0x00000001u) == 0u)
                         && ((number_of_bytes_to_read & 0x000000001u) == 0u) )
                 {
-                    main_flash_read(physical_address,
-                                    number_of_bytes_to_read,
-                                    p_read_data);
+                    /* A background erase on the same device is suspended for the read. */
+                    if (erase_access_suspend(physical_address / 2u, number_of_bytes_to_read / 2u))
+                    {
+                        main_flash_read(physical_address,
+                                        number_of_bytes_to_read,
+                                        p_read_data);
+
+                        erase_access_resume();
+                    }
+                    else
+                    {
+                        main_flash_read(physical_address,
+                                        number_of_bytes_to_read,
+                                        p_read_data);
+                    }
 
                     read_status = FLASH_HAL_NO_ERROR;
                 }
             break;
 
-            /* The serial flash is a byte-addressable device.*/
+            /*
+             * The serial flash is a byte-addressable device.  The read fails
+             * if a page being written back from the cache never finished.
+             */
             case STORAGE_DEVICE_SERIAL_FLASH:
-                M95_BlockRead(physical_address,
-                              number_of_bytes_to_read,
-                              p_read_data);
-
-                read_status = FLASH_HAL_NO_ERROR;
+                if (M95_BlockRead(physical_address,
+                                  number_of_bytes_to_read,
+                                  p_read_data) == M95_POLL_NO_WRITE_IN_PROGRESS)
+                {
+                    read_status = FLASH_HAL_NO_ERROR;
+                }
+                else
+                {
+                    read_status = FLASH_HAL_WRITE_FAIL;
+                }
             break;
 
             /*
@@ -247,6 +350,206 @@ flash_hal_error_t flash_hal_device_read
 }
 
 
+// ----------------------------------------------------------------------------
+/*!
+ * flash_hal_device_verify_read reads back data which has just been written,
+ * from the device itself.  flash_hal_device_read may return data from the
+ * serial flash or EEPROM write-behind cache, which would always match what
+ * was written, so here the cached pages are written into the device first and
+ * the device is read without the cache.
+ *
+ * @note
+ * The logical start address is a BYTE ADDRESS.
+ *
+ * @param   logical_start_address       The logical start address for the read.
+ * @param   number_of_bytes_to_read     The number of bytes to read.
+ * @param   p_read_data                 Pointer to buffer to put read data in.
+ * @retval  flash_hal_error_t           Enumerated value for read status - a
+ *                                      write fail if the data couldn't be
+ *                                      written back into the device.
+ *
+ */
+// ----------------------------------------------------------------------------
+flash_hal_error_t flash_hal_device_verify_read
+                        (const uint32_t logical_start_address,
+                         const uint32_t number_of_bytes_to_read,
+                         uint8_t * const p_read_data)
+{
+    uint32_t            physical_address;
+    storage_devices_t   physical_device;
+    bool_t              b_converted_ok;
+    flash_hal_error_t   read_status;
+
+    b_converted_ok = convert_from_logical_2_physical(logical_start_address,
+                                                     number_of_bytes_to_read,
+                                                     &physical_address,
+                                                     &physical_device);
+
+    if ( (b_converted_ok) && (physical_device == STORAGE_DEVICE_SERIAL_FLASH) )
+    {
+        if (M95_VerifyRead(physical_address,
+                           number_of_bytes_to_read,
+                           p_read_data) == M95_POLL_NO_WRITE_IN_PROGRESS)
+        {
+            read_status = FLASH_HAL_NO_ERROR;
+        }
+        else
+        {
+            read_status = FLASH_HAL_WRITE_FAIL;
+        }
+    }
+    else if ( (b_converted_ok) && (physical_device == STORAGE_DEVICE_I2C_EEPROM) )
+    {
+        //lint -e{921} Cast from uint32_t to uint16_t, as flash_hal_device_read.
+        if (X24LC32A_VerifyRead(physical_address,
+                                (uint16_t)number_of_bytes_to_read,
+                                p_read_data) == I2C_COMPLETED_OK)
+        {
+            read_status = FLASH_HAL_NO_ERROR;
+        }
+        else
+        {
+            read_status = FLASH_HAL_WRITE_FAIL;
+        }
+    }
+    else
+    {
+        /* Nothing is cached for the main flash. */
+        read_status = flash_hal_device_read(logical_start_address,
+                                            number_of_bytes_to_read,
+                                            p_read_data);
+    }
+
+    return read_status;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * flash_hal_device_read_words converts logical to physical address and then
+ * reads whole 16 bit words, for callers which work in words anyway (CRC
+ * calculation, serial transmission) and would otherwise have to join pairs
+ * of bytes back together.
+ *
+ * Words are read from the main flash without being split into bytes.  The
+ * byte-addressable devices are read a chunk at a time, and each pair of
+ * bytes is joined in little-endian fashion, to match flash_hal_device_read.
+ *
+ * @note
+ * The logical start address is a BYTE ADDRESS.
+ *
+ * @param   logical_start_address       The logical start address for the read.
+ * @param   number_of_words_to_read     The number of 16 bit words to read.
+ * @param   p_read_data                 Pointer to buffer to put read data in.
+ * @retval  flash_hal_error_t           Enumerated value for read status.
+ *
+ */
+// ----------------------------------------------------------------------------
+flash_hal_error_t flash_hal_device_read_words
+                        (const uint32_t logical_start_address,
+                         const uint32_t number_of_words_to_read,
+                         uint16_t * const p_read_data)
+{
+    uint32_t            physical_address;
+    storage_devices_t   physical_device;
+    bool_t              b_converted_ok;
+    flash_hal_error_t   read_status = FLASH_HAL_INVALID_ADDRESS;
+    uint32_t            words_remaining;
+    uint32_t            words_in_chunk;
+    uint32_t            word_offset = 0u;
+    uint32_t            i;
+
+    b_converted_ok = convert_from_logical_2_physical(logical_start_address,
+                                                     number_of_words_to_read * 2u,
+                                                     &physical_address,
+                                                     &physical_device);
+
+    if (b_converted_ok)
+    {
+        //lint -e{788} Not all enum types used in switch, but we have a default case.
+        switch (physical_device)
+        {
+            /* Only read from the main flash if the address is a word address. */
+            case STORAGE_DEVICE_MAIN_FLASH:
+                if ((logical_start_address & 0x00000001u) == 0u)
+                {
+                    /* A background erase on the same device is suspended for the read. */
+                    if (erase_access_suspend(physical_address / 2u, number_of_words_to_read))
+                    {
+                        main_flash_words_read(physical_address / 2u,
+                                              number_of_words_to_read,
+                                              p_read_data);
+
+                        erase_access_resume();
+                    }
+                    else
+                    {
+                        main_flash_words_read(physical_address / 2u,
+                                              number_of_words_to_read,
+                                              p_read_data);
+                    }
+
+                    read_status = FLASH_HAL_NO_ERROR;
+                }
+            break;
+
+            /*
+             * The serial flash and I2C EEPROM are byte-addressable devices,
+             * so read a chunk of bytes and join them into words.  Discard
+             * the return value from the EEPROM read, as flash_hal_device_read.
+             */
+            case STORAGE_DEVICE_SERIAL_FLASH:
+            case STORAGE_DEVICE_I2C_EEPROM:
+                words_remaining = number_of_words_to_read;
+                read_status     = FLASH_HAL_NO_ERROR;
+
+                while ( (words_remaining != 0u) && (read_status == FLASH_HAL_NO_ERROR) )
+                {
+                    words_in_chunk = words_remaining;
+                    if (words_in_chunk > READ_CHUNK_SIZE_IN_WORDS)
+                    {
+                        words_in_chunk = READ_CHUNK_SIZE_IN_WORDS;
+                    }
+
+                    if (physical_device == STORAGE_DEVICE_SERIAL_FLASH)
+                    {
+                        if (M95_BlockRead(physical_address + (word_offset * 2u),
+                                          words_in_chunk * 2u,
+                                          &m_read_chunk_bytes[0])
+                                != M95_POLL_NO_WRITE_IN_PROGRESS)
+                        {
+                            read_status = FLASH_HAL_WRITE_FAIL;
+                        }
+                    }
+                    else
+                    {
+                        //lint -e{920} -e{921} Cast from enum->void, uint32_t->uint16_t
+                        (void)X24LC32A_BlockRead(physical_address + (word_offset * 2u),
+                                                 (uint16_t)(words_in_chunk * 2u),
+                                                 &m_read_chunk_bytes[0]);
+                    }
+
+                    for (i = 0u; i < words_in_chunk; i++)
+                    {
+                        p_read_data[word_offset + i]
+                            = BUFFER_UTILS_8bitBufToUint16(&m_read_chunk_bytes[i * 2u]);
+                    }
+
+                    word_offset     += words_in_chunk;
+                    words_remaining -= words_in_chunk;
+                }
+            break;
+
+            default:
+                /* As flash_hal_device_read - return FLASH_HAL_INVALID_ADDRESS. */
+            break;
+        }
+    }
+
+    return read_status;
+}
+
+
 // ----------------------------------------------------------------------------
 /*!
  * flash_hal_device_write converts logical to physical address and then
@@ -295,9 +598,24 @@ flash_hal_error_t flash_hal_device_write
                 {
                     m_current_device_used_for_write = STORAGE_DEVICE_MAIN_FLASH;
 
-                    write_status = main_flash_write(physical_address,
-                                                    number_of_bytes_to_write,
-                                                    p_write_data);
+                    /* Forget the erased state first, in case the write fails part way. */
+                    erased_cache_clear(physical_address, number_of_bytes_to_write);
+
+                    /* A background erase on the same device is suspended for the write. */
+                    if (erase_access_suspend(physical_address / 2u, number_of_bytes_to_write / 2u))
+                    {
+                        write_status = main_flash_write(physical_address,
+                                                        number_of_bytes_to_write,
+                                                        p_write_data);
+
+                        erase_access_resume();
+                    }
+                    else
+                    {
+                        write_status = main_flash_write(physical_address,
+                                                        number_of_bytes_to_write,
+                                                        p_write_data);
+                    }
                 }
             break;
 
@@ -383,54 +701,55 @@ flash_hal_error_t flash_hal_device_erase
 {
      uint32_t            physical_address;
      storage_devices_t   physical_device;
-     bool_t              b_converted_ok;
+     bool_t              b_range_ok;
      flash_hal_error_t   erase_status = FLASH_HAL_INVALID_ADDRESS;
-     uint32_t            sector_offset;
-     uint32_t            sector_remainder;
 
-     b_converted_ok = convert_from_logical_2_physical(logical_start_address,
-                                                      number_of_bytes_to_erase,
-                                                      &physical_address,
-                                                      &physical_device);
+     /* Only erase if we're doing an entire sector (or sectors). */
+     b_range_ok = erase_range_check(logical_start_address,
+                                    number_of_bytes_to_erase,
+                                    &physical_address,
+                                    &physical_device);
 
-     if (b_converted_ok)
+     if (b_range_ok)
      {
-         sector_offset    = (physical_address - m_physical_addresses[physical_device].start_address)
-                                % m_physical_addresses[physical_device].block_size_bytes;
-
-         sector_remainder = number_of_bytes_to_erase
-                                 % m_physical_addresses[physical_device].block_size_bytes;
-
-         /* Only erase if we're doing an entire sector (or sectors). */
-         if ( (sector_offset == 0u) && (sector_remainder == 0u) )
+         //lint -e{788} Not all enum types used in switch, but we have a default case.
+         switch (physical_device)
          {
-             //lint -e{788} Not all enum types used in switch, but we have a default case.
-             switch (physical_device)
-             {
-                 case STORAGE_DEVICE_MAIN_FLASH:
-                     erase_status = main_flash_partial_erase(physical_address,
-                                                             number_of_bytes_to_erase);
-                 break;
-
-                 case STORAGE_DEVICE_SERIAL_FLASH:
-                     erase_status = serial_flash_partial_erase(physical_address,
-                                                               number_of_bytes_to_erase);
-                 break;
-
-                 case STORAGE_DEVICE_I2C_EEPROM:
-                     erase_status = eeprom_partial_erase(physical_address,
+             case STORAGE_DEVICE_MAIN_FLASH:
+                 /* Let any sector being erased in the background finish first. */
+                 erase_sector_wait(physical_address / 2u, number_of_bytes_to_erase / 2u);
+
+                 erase_status = main_flash_partial_erase(physical_address,
                                                          number_of_bytes_to_erase);
-                 break;
-
-                 default:
-                     /*
-                      * Default case returns FLASH_HAL_INVALID_ADDRESS.
-                      * Shouldn't ever get here as the conversion function
-                      * will fail if we try and access a device which doesn't
-                      * exist.
-                      */
-                 break;
-             }
+
+                 if (erase_status == FLASH_HAL_NO_ERROR)
+                 {
+                     erased_cache_mark(physical_address, number_of_bytes_to_erase);
+                 }
+                 else
+                 {
+                     erased_cache_clear(physical_address, number_of_bytes_to_erase);
+                 }
+             break;
+
+             case STORAGE_DEVICE_SERIAL_FLASH:
+                 erase_status = serial_flash_partial_erase(physical_address,
+                                                           number_of_bytes_to_erase);
+             break;
+
+             case STORAGE_DEVICE_I2C_EEPROM:
+                 erase_status = eeprom_partial_erase(physical_address,
+                                                     number_of_bytes_to_erase);
+             break;
+
+             default:
+                 /*
+                  * Default case returns FLASH_HAL_INVALID_ADDRESS.
+                  * Shouldn't ever get here as the conversion function
+                  * will fail if we try and access a device which doesn't
+                  * exist.
+                  */
+             break;
          }
      }
 
@@ -438,12 +757,106 @@ flash_hal_error_t flash_hal_device_erase
 }
 
 
+// ----------------------------------------------------------------------------
+/*!
+ * flash_hal_device_erase_start starts an erase which runs in the background,
+ * a sector at a time, while flash_hal_erase_poll is called.
+ *
+ * Only the main flash is erased in the background - its sector erases take
+ * hundreds of milliseconds, during which the recording system still needs to
+ * read and write.  A main flash read or write elsewhere suspends the erase
+ * while it runs (see erase_access_suspend), and blank checks on the same
+ * device wait for the sector.  The serial flash and EEPROM are erased
+ * straight away, and the status is returned by the next poll.
+ *
+ * Only one erase runs in the background, so if one is already running it is
+ * finished first.
+ *
+ * @note
+ * The logical start address is a BYTE ADDRESS.
+ *
+ * @param   logical_start_address       The logical start address for the erase.
+ * @param   number_of_bytes_to_erase    The number of bytes to erase.
+ * @retval  flash_hal_error_t           FLASH_HAL_NO_ERROR if the erase was started.
+ *
+ */
+// ----------------------------------------------------------------------------
+flash_hal_error_t flash_hal_device_erase_start
+                        (const uint32_t logical_start_address,
+                         const uint32_t number_of_bytes_to_erase)
+{
+    uint32_t            physical_address;
+    storage_devices_t   physical_device;
+    flash_hal_error_t   start_status = FLASH_HAL_INVALID_ADDRESS;
+
+    while (m_erase.b_in_progress)
+    {
+        erase_step();
+    }
+
+    if (erase_range_check(logical_start_address,
+                          number_of_bytes_to_erase,
+                          &physical_address,
+                          &physical_device))
+    {
+        start_status = FLASH_HAL_NO_ERROR;
+
+        if (physical_device == STORAGE_DEVICE_MAIN_FLASH)
+        {
+            m_erase.word_address      = physical_address / 2u;
+            m_erase.sectors_remaining = number_of_bytes_to_erase
+                                            / m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].block_size_bytes;
+            m_erase.erase_status      = FLASH_HAL_NO_ERROR;
+            m_erase.b_in_progress     = (m_erase.sectors_remaining != 0u);
+        }
+        else
+        {
+            m_erase.erase_status = flash_hal_device_erase(logical_start_address,
+                                                          number_of_bytes_to_erase);
+        }
+    }
+
+    return start_status;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * flash_hal_erase_poll moves a background erase on by one step - starting
+ * the next sector, or checking whether the sector being erased has finished.
+ * It never waits for the device, so it can be called from a loop which has
+ * other things to do.
+ *
+ * @param   p_erase_status  Erase status is written here once it has finished.
+ * @retval  bool_t          TRUE while the erase is still running.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t flash_hal_erase_poll(flash_hal_error_t * const p_erase_status)
+{
+    if (m_erase.b_in_progress)
+    {
+        erase_step();
+    }
+
+    if (!m_erase.b_in_progress)
+    {
+        *p_erase_status = m_erase.erase_status;
+    }
+
+    return m_erase.b_in_progress;
+}
+
+
 // ----------------------------------------------------------------------------
 /*!
  * flash_hal_device_blank_check converts logical to physical address and then
  * calls the appropriate flash driver function to check for the device being
  * blank.
  *
+ * Main flash pages which are known to be erased are remembered, so asking
+ * again about a region which hasn't been written since doesn't read the flash.
+ *
  * @note
  * The logical start address is a BYTE ADDRESS.
  *
@@ -481,9 +894,25 @@ bool_t flash_hal_device_blank_check
                 if ( ((logical_start_address & 0x00000001u) == 0u)
                         && ((number_of_bytes_to_blank_check & 0x000000001u) == 0u) )
                 {
-                    b_device_is_blank
-                        = main_flash_blank_check(physical_address,
-                                                 number_of_bytes_to_blank_check);
+                    /* Only go to the flash if the erased cache can't answer. */
+                    if (erased_cache_check(physical_address, number_of_bytes_to_blank_check))
+                    {
+                        b_device_is_blank = TRUE;
+                    }
+                    else
+                    {
+                        /* The blank check command can't run while the device is erasing. */
+                        erase_sector_wait(physical_address / 2u, number_of_bytes_to_blank_check / 2u);
+
+                        b_device_is_blank
+                            = main_flash_blank_check(physical_address,
+                                                     number_of_bytes_to_blank_check);
+
+                        if (b_device_is_blank)
+                        {
+                            erased_cache_mark(physical_address, number_of_bytes_to_blank_check);
+                        }
+                    }
                 }
             break;
 
@@ -516,6 +945,28 @@ bool_t flash_hal_device_blank_check
 }
 
 
+// ----------------------------------------------------------------------------
+/*!
+ * flash_hal_erased_cache_invalidate forgets everything the erased cache knows
+ * about the main flash, so that the next blank checks go to the flash again.
+ *
+ * This must be called by anything which programs the main flash without
+ * going through flash_hal_device_write.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_hal_erased_cache_invalidate(void)
+{
+    uint32_t    word_counter;
+
+    for (word_counter = 0u;
+            word_counter < (ERASED_CACHE_UNITS / ERASED_CACHE_UNITS_PER_WORD); word_counter++)
+    {
+        m_erased_cache[word_counter] = 0u;
+    }
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * flash_hal_write_timeout_callbck is the callback function for the flash
@@ -835,8 +1286,8 @@ static bool_t convert_from_logical_2_physical(const uint32_t logical_address,
 /*!
  * main_flash_read reads data from the main flash.
  *
- * As the flash chipset driver reads in 16 bit words, we take each 16 bit word
- * and convert it to 2 x 8 bit bytes.
+ * As the flash chipset driver reads in 16 bit words, we burst read a chunk of
+ * words at a time and convert each 16 bit word to 2 x 8 bit bytes.
  *
  * @warning
  * This function must have an even number of bytes to read, and the byte address
@@ -854,7 +1305,9 @@ static void main_flash_read(const uint32_t byte_address,
 {
     uint32_t    word_address;
     uint32_t    words_to_read;
+    uint32_t    words_in_chunk;
     uint32_t    byte_offset = 0u;
+    uint32_t    i;
     uint16_t    temp_read;
 
     word_address  = byte_address / 2u;
@@ -862,115 +1315,192 @@ static void main_flash_read(const uint32_t byte_address,
 
     while (words_to_read != 0u)
     {
-        if (word_address < MAIN_FLASH_LOWER_DEVICE_MAX)
+        words_in_chunk = words_to_read;
+        if (words_in_chunk > READ_CHUNK_SIZE_IN_WORDS)
         {
-            temp_read = lld_ReadOp(DEVICE_ZERO_BASE, word_address);
+            words_in_chunk = READ_CHUNK_SIZE_IN_WORDS;
         }
-        else
+
+        main_flash_words_read(word_address, words_in_chunk, &m_read_chunk_words[0]);
+
+        /* Split each 16 bit word into bytes in little-endian fashion. */
+        for (i = 0u; i < words_in_chunk; i++)
         {
-            /*
-             * lld_ReadOp's second argument is the offset into the device,
-             * so we need to subtract the maximum address of the lower device
-             * to get the desired offset.  Note that we have to disable the
-             * Lint warning for cast from int to pointer (in DEVICE_ONE_BASE) -
-             * this contravenes MISRA rule 11.4, but is a function of the way
-             * the Spansion library code works, so is difficult to change.
-             */
-            //lint -e{9078} -e{923} Conversion between pointer and integer type.
-            temp_read = lld_ReadOp(DEVICE_ONE_BASE,
-                                   (word_address - MAIN_FLASH_LOWER_DEVICE_MAX) );
+            temp_read = m_read_chunk_words[i];
+
+            //lint -e{921} Cast from uint16_t to uint8_t before assigning.
+            p_byte_data[byte_offset]      = (uint8_t)(temp_read & 0x00FFu);
+            //lint -e{921} Cast from uint16_t to uint8_t before assigning.
+            p_byte_data[byte_offset + 1u] = (uint8_t)((temp_read >> 8u) & 0x00FFu);
+            byte_offset += 2u;
         }
 
-        /* Split 16 bit word into bytes in little-endian fashion. */
-        //lint -e{920} Ignoring return value, not used here as we use byte_offset.
-        (void)BUFFER_UTILS_Uint16To8bitBuf(&p_byte_data[byte_offset], temp_read);
-        byte_offset += 2u;
-        word_address++;
-        words_to_read--;
+        word_address  += words_in_chunk;
+        words_to_read -= words_in_chunk;
     }
 }
 
 
 // ----------------------------------------------------------------------------
 /*!
- * main_flash_write writes data to the main flash.
+ * main_flash_words_read reads 16 bit words from the main flash.
  *
- * As the flash chipset driver writes in 16 bit words, we use the function
- * lld_memcpy_bytes in here, which takes each pair of bytes and converts to
- * a 16 bit word before writing to the flash.
- *
- * @warning
- * This function must have an even number of bytes to write, and the byte
- * address must be word aligned, so the calling function must check for this.
+ * The read is split between the two devices once, rather than for every word,
+ * and each part is passed to the chipset driver as a single block read.
  *
- * @param   byte_address        The first byte address to write.
- * @param   bytes_to_write      Number of bytes to write.
- * @param   p_byte_data         Pointer to byte array containing data to write.
- * @retval  flash_hal_error_t   Enumerated value for flash status.
+ * @param   word_address        The word address to read from.
+ * @param   words_to_read       Number of words to read.
+ * @param   p_word_data         Pointer to word array to put the read data in.
  *
  */
 // ----------------------------------------------------------------------------
-static flash_hal_error_t main_flash_write(const uint32_t byte_address,
-                                          const uint32_t bytes_to_write,
-                                          const uint8_t * const p_byte_data)
+static void main_flash_words_read(const uint32_t word_address,
+                                  const uint32_t words_to_read,
+                                  uint16_t * const p_word_data)
 {
-    uint32_t            word_address;
-    uint32_t            words_to_write;
-    DEVSTATUS           write_status;
-    flash_hal_error_t   write_result = FLASH_HAL_WRITE_FAIL;
-
-    word_address   = byte_address / 2u;
-    words_to_write = bytes_to_write / 2u;
+    uint32_t    lower_device_words = 0u;
 
     if (word_address < MAIN_FLASH_LOWER_DEVICE_MAX)
     {
-        /*
-         * The maximum amount of data which the flash driver can handle in
-         * one go is 65535 words.  In the recording system we'll never write
-         * a TDR of more than 4k (plus the wrapper) so this isn't a problem.
-         * Note the cast, as memcpy takes a uint16_t as it's argument.
-         */
-        //lint -e{921} Cast from uint32_t to uint16_t.
-        write_status = lld_memcpy_bytes(DEVICE_ZERO_BASE,
-                                        word_address,
-                                        (uint16_t)words_to_write,
-                                        p_byte_data);
+        lower_device_words = MAIN_FLASH_LOWER_DEVICE_MAX - word_address;
+        if (lower_device_words > words_to_read)
+        {
+            lower_device_words = words_to_read;
+        }
+
+        if (lower_device_words != 0u)
+        {
+            lld_BlockReadOp(DEVICE_ZERO_BASE, word_address,
+                            lower_device_words, p_word_data);
+        }
     }
-    else
+
+    if (words_to_read > lower_device_words)
     {
         /*
-         * lld_memcpy's second argument is the offset into the device,
+         * lld_BlockReadOp's second argument is the offset into the device,
          * so we need to subtract the maximum address of the lower device
          * to get the desired offset.  Note that we have to disable the
          * Lint warning for cast from int to pointer (in DEVICE_ONE_BASE) -
          * this contravenes MISRA rule 11.4, but is a function of the way
          * the Spansion library code works, so is difficult to change.
          */
-        //lint -e{9078} -e{923} Cast from int to pointer.
-        //lint -e{921} Cast from uint32_t to uint16_t.
-        write_status = lld_memcpy_bytes(DEVICE_ONE_BASE,
-                                        (word_address - MAIN_FLASH_LOWER_DEVICE_MAX),
-                                        (uint16_t)words_to_write,
-                                        p_byte_data);
-    }
-
-    /* The only write status which means the write was OK is DEV_NOT_BUSY. */
-    if (write_status == DEV_NOT_BUSY)
-    {
-        write_result = FLASH_HAL_NO_ERROR;
+        //lint -e{9078} -e{923} Conversion between pointer and integer type.
+        lld_BlockReadOp(DEVICE_ONE_BASE,
+                        (word_address + lower_device_words) - MAIN_FLASH_LOWER_DEVICE_MAX,
+                        words_to_read - lower_device_words,
+                        &p_word_data[lower_device_words]);
     }
-
-    return write_result;
 }
 
 
 // ----------------------------------------------------------------------------
 /*!
- * main_flash_partial_erase erases one or more sectors in the main flash.
+ * main_flash_write writes data to the main flash.
+ *
+ * The data is written a write buffer at a time (lld_WriteByteBufferCmd takes
+ * each pair of bytes and converts to a 16 bit word), without the flash driver
+ * waiting for each buffer to program.  A write which goes from one device
+ * into the other loads the buffer of one device while the other programs,
+ * and only then waits for the first.
  *
  * @warning
- * This function must have an address which is on a sector boundary, and
- * a number of bytes which is a multiple of the sector size, so the calling
+ * This function must have an even number of bytes to write, and the byte
+ * address must be word aligned, so the calling function must check for this.
+ *
+ * @param   byte_address        The first byte address to write.
+ * @param   bytes_to_write      Number of bytes to write.
+ * @param   p_byte_data         Pointer to byte array containing data to write.
+ * @retval  flash_hal_error_t   Enumerated value for flash status.
+ *
+ */
+// ----------------------------------------------------------------------------
+static flash_hal_error_t main_flash_write(const uint32_t byte_address,
+                                          const uint32_t bytes_to_write,
+                                          const uint8_t * const p_byte_data)
+{
+    flash_hal_die_op_t  die_op[MAIN_FLASH_DEVICES];
+    flash_hal_die_op_t* p_op;
+    FLASHDATA *         p_device;
+    FLASHDATA           status_reg;
+    uint32_t            die;
+    uint32_t            words_in_buffer;
+    bool_t              b_busy = TRUE;
+    bool_t              b_written_ok = TRUE;
+    flash_hal_error_t   write_result = FLASH_HAL_WRITE_FAIL;
+
+    main_flash_die_split(byte_address / 2u, bytes_to_write / 2u, &die_op[0]);
+
+    while (b_busy)
+    {
+        b_busy = FALSE;
+
+        for (die = 0u; die < MAIN_FLASH_DEVICES; die++)
+        {
+            p_op     = &die_op[die];
+            p_device = main_flash_die_base_get(die);
+
+            /* Wait for the last buffer - the other device has been programming meanwhile. */
+            if (p_op->b_busy)
+            {
+                status_reg = lld_PollWithTimeout(p_device, p_op->poll_offset, 0u);
+                p_op->b_busy = FALSE;
+
+                if ( ((status_reg & DEV_RDY_MASK) != DEV_RDY_MASK)
+                        || ((status_reg & (DEV_SEC_LOCK_MASK | DEV_PROGRAM_MASK)) != 0u) )
+                {
+                    b_written_ok = FALSE;
+                }
+            }
+
+            /* Load the next buffer, up to the end of the write buffer page. */
+            if ( (b_written_ok) && (p_op->words_remaining != 0u) )
+            {
+                words_in_buffer = LLD_BUFFER_SIZE - (p_op->device_offset & (LLD_BUFFER_SIZE - 1u));
+                if (words_in_buffer > p_op->words_remaining)
+                {
+                    words_in_buffer = p_op->words_remaining;
+                }
+
+                //lint -e{921} Cast from uint32_t to WORDCOUNT - no more than LLD_BUFFER_SIZE.
+                p_op->poll_offset = lld_WriteByteBufferCmd(p_device,
+                                                           p_op->device_offset,
+                                                           (WORDCOUNT)words_in_buffer,
+                                                           &p_byte_data[p_op->byte_offset]);
+                p_op->b_busy = TRUE;
+
+                p_op->device_offset   += words_in_buffer;
+                p_op->byte_offset     += (words_in_buffer * 2u);
+                p_op->words_remaining -= words_in_buffer;
+            }
+
+            if (p_op->b_busy)
+            {
+                b_busy = TRUE;
+            }
+        }
+    }
+
+    if (b_written_ok)
+    {
+        write_result = FLASH_HAL_NO_ERROR;
+    }
+
+    return write_result;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * main_flash_partial_erase erases one or more sectors in the main flash.
+ *
+ * Each device erases one sector at a time, but when the sectors are in both
+ * devices they are erased at the same time - a sector is started in each,
+ * and whichever is waited for, the other is erasing too.
+ *
+ * @warning
+ * This function must have an address which is on a sector boundary, and
+ * a number of bytes which is a multiple of the sector size, so the calling
  * function must check for this.
  *
  * @param   byte_address        The first byte address to erase.
@@ -982,55 +1512,59 @@ static flash_hal_error_t main_flash_write(const uint32_t byte_address,
 static flash_hal_error_t main_flash_partial_erase(const uint32_t byte_address,
                                                   const uint32_t bytes_to_erase)
 {
-    flash_hal_error_t   status = FLASH_HAL_NO_ERROR;
-    uint32_t            word_address;
-    uint32_t            number_of_sectors;
-    DEVSTATUS           flash_erase_status;
+    const uint32_t      sector_words = m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].block_size_bytes / 2u;
+    flash_hal_die_op_t  die_op[MAIN_FLASH_DEVICES];
+    flash_hal_die_op_t* p_op;
     FLASHDATA *         p_device;
-    ADDRESS             device_offset;
+    FLASHDATA           status_reg;
+    uint32_t            die;
+    bool_t              b_busy = TRUE;
     bool_t              b_erased_ok = TRUE;
+    flash_hal_error_t   status = FLASH_HAL_NO_ERROR;
 
-    word_address = byte_address / 2u;
-
-    number_of_sectors = bytes_to_erase / m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].block_size_bytes;
+    main_flash_die_split(byte_address / 2u, bytes_to_erase / 2u, &die_op[0]);
 
-    while (number_of_sectors != 0u)
+    while (b_busy)
     {
-        if (word_address < MAIN_FLASH_LOWER_DEVICE_MAX)
-        {
-            p_device      = DEVICE_ZERO_BASE;
-            device_offset = word_address;
-        }
-        else
-        {
-            //lint -e{9078} -e{923} Cast from int to pointer.
-            p_device      = DEVICE_ONE_BASE;
-            device_offset = word_address - MAIN_FLASH_LOWER_DEVICE_MAX;
-        }
+        b_busy = FALSE;
 
-        /* If a sector is already blank no need to erase it. */
-        if (check_one_flash_sector_blank(word_address))
+        for (die = 0u; die < MAIN_FLASH_DEVICES; die++)
         {
-            flash_erase_status = DEV_NOT_BUSY;
-        }
-        else
-        {
-            flash_erase_status = lld_SectorEraseOp(p_device, device_offset);
-        }
+            p_op     = &die_op[die];
+            p_device = main_flash_die_base_get(die);
 
-        /* Anything other than DEV_NOT_BUSY means that the erase failed. */
-        if (flash_erase_status != DEV_NOT_BUSY)
-        {
-            b_erased_ok = FALSE;
-            break;
-        }
+            if (p_op->b_busy)
+            {
+                status_reg = lld_Poll(p_device, p_op->device_offset);
+                p_op->b_busy = FALSE;
 
-        /*
-         * Increase the word address to the address of the first location
-         * in the next sector, and go round again.
-         */
-        word_address += (m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].block_size_bytes / 2u);
-        number_of_sectors--;
+                /* Anything other than ready with no errors means that the erase failed. */
+                if ( ((status_reg & DEV_RDY_MASK) != DEV_RDY_MASK)
+                        || ((status_reg & (DEV_SEC_LOCK_MASK | DEV_ERASE_MASK)) != 0u) )
+                {
+                    b_erased_ok = FALSE;
+                }
+
+                p_op->device_offset   += sector_words;
+                p_op->words_remaining -= sector_words;
+            }
+
+            /* If a sector is already blank no need to erase it. */
+            while ( (b_erased_ok) && (p_op->words_remaining != 0u)
+                        && (check_one_flash_sector_blank(p_op->device_offset
+                                                            + (die * MAIN_FLASH_LOWER_DEVICE_MAX))) )
+            {
+                p_op->device_offset   += sector_words;
+                p_op->words_remaining -= sector_words;
+            }
+
+            if ( (b_erased_ok) && (p_op->words_remaining != 0u) )
+            {
+                lld_SectorEraseCmd(p_device, p_op->device_offset);
+                p_op->b_busy = TRUE;
+                b_busy       = TRUE;
+            }
+        }
     }
 
     if (!b_erased_ok)
@@ -1422,12 +1956,18 @@ static bool_t serial_flash_blank_check(const uint32_t byte_address,
 
     while ( (block_reads != 0u) && (b_blank_check_ok) )
     {
+        // A page which can't be read doesn't count as blank.
         //lint -e{921} Cast from uint16_t to uint32_t.
-        M95_BlockRead(erase_address, (uint32_t)M95_PAGE_SIZE_IN_BYTES, &buffer[0u]);
+        b_blank_check_ok = (M95_BlockRead(erase_address,
+                                          (uint32_t)M95_PAGE_SIZE_IN_BYTES,
+                                          &buffer[0u]) == M95_POLL_NO_WRITE_IN_PROGRESS);
 
-        //lint -e{921} Cast from uint16_t to uint32_t.
-        b_blank_check_ok = blank_check_buffer(&buffer[0u],
-                                              (uint32_t)M95_PAGE_SIZE_IN_BYTES);
+        if (b_blank_check_ok)
+        {
+            //lint -e{921} Cast from uint16_t to uint32_t.
+            b_blank_check_ok = blank_check_buffer(&buffer[0u],
+                                                  (uint32_t)M95_PAGE_SIZE_IN_BYTES);
+        }
 
         erase_address += M95_PAGE_SIZE_IN_BYTES;
         block_reads--;
@@ -1435,10 +1975,15 @@ static bool_t serial_flash_blank_check(const uint32_t byte_address,
 
     if ( (remainder_reads != 0u) && (b_blank_check_ok) )
     {
-        M95_BlockRead(erase_address, remainder_reads, &buffer[0u]);
+        b_blank_check_ok = (M95_BlockRead(erase_address,
+                                          remainder_reads,
+                                          &buffer[0u]) == M95_POLL_NO_WRITE_IN_PROGRESS);
 
-        b_blank_check_ok = blank_check_buffer(&buffer[0u],
-                                              remainder_reads);
+        if (b_blank_check_ok)
+        {
+            b_blank_check_ok = blank_check_buffer(&buffer[0u],
+                                                  remainder_reads);
+        }
     }
 
     return b_blank_check_ok;
@@ -1629,3 +2174,505 @@ static bool_t check_one_flash_sector_blank(const uint32_t start_word_address)
     return b_sector_is_blank;
 }
 
+
+// ----------------------------------------------------------------------------
+/*!
+ * erased_cache_mark records that a region of the main flash is erased.  Only
+ * pages which lie wholly within the region are marked.
+ *
+ * @param   byte_address        The first byte address which is erased.
+ * @param   number_of_bytes     Number of bytes which are erased.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void erased_cache_mark(const uint32_t byte_address,
+                              const uint32_t number_of_bytes)
+{
+    uint32_t    offset;
+    uint32_t    unit;
+    uint32_t    end_unit;
+
+    offset = byte_address - m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].start_address;
+
+    /* Round the start up and the end down to whole pages. */
+    unit     = (offset + (ERASED_CACHE_UNIT_BYTES - 1u)) / ERASED_CACHE_UNIT_BYTES;
+    end_unit = (offset + number_of_bytes) / ERASED_CACHE_UNIT_BYTES;
+
+    while ( (unit < end_unit) && (unit < ERASED_CACHE_UNITS) )
+    {
+        //lint -e{921} Cast from uint32_t to uint16_t.
+        m_erased_cache[unit / ERASED_CACHE_UNITS_PER_WORD]
+            |= (uint16_t)(1u << (unit % ERASED_CACHE_UNITS_PER_WORD));
+        unit++;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erased_cache_clear forgets the erased state of every page which a region
+ * of the main flash touches.
+ *
+ * @param   byte_address        The first byte address which may be written.
+ * @param   number_of_bytes     Number of bytes which may be written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void erased_cache_clear(const uint32_t byte_address,
+                               const uint32_t number_of_bytes)
+{
+    uint32_t    offset;
+    uint32_t    unit;
+    uint32_t    last_unit;
+
+    if (number_of_bytes != 0u)
+    {
+        offset = byte_address - m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].start_address;
+
+        unit      = offset / ERASED_CACHE_UNIT_BYTES;
+        last_unit = ((offset + number_of_bytes) - 1u) / ERASED_CACHE_UNIT_BYTES;
+
+        while ( (unit <= last_unit) && (unit < ERASED_CACHE_UNITS) )
+        {
+            //lint -e{921} Cast from uint32_t to uint16_t.
+            m_erased_cache[unit / ERASED_CACHE_UNITS_PER_WORD]
+                &= (uint16_t)~(1u << (unit % ERASED_CACHE_UNITS_PER_WORD));
+            unit++;
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erased_cache_check checks whether every page which a region of the main
+ * flash touches is known to be erased.
+ *
+ * @param   byte_address        The first byte address to check.
+ * @param   number_of_bytes     Number of bytes to check.
+ * @retval  bool_t              TRUE if the region is known to be blank,
+ *                              FALSE if it has to be read to find out.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t erased_cache_check(const uint32_t byte_address,
+                                 const uint32_t number_of_bytes)
+{
+    uint32_t    offset;
+    uint32_t    unit;
+    uint32_t    last_unit;
+    bool_t      b_known_blank = FALSE;
+
+    if (number_of_bytes != 0u)
+    {
+        offset = byte_address - m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].start_address;
+
+        unit      = offset / ERASED_CACHE_UNIT_BYTES;
+        last_unit = ((offset + number_of_bytes) - 1u) / ERASED_CACHE_UNIT_BYTES;
+
+        if (last_unit < ERASED_CACHE_UNITS)
+        {
+            b_known_blank = TRUE;
+
+            while (unit <= last_unit)
+            {
+                if ((m_erased_cache[unit / ERASED_CACHE_UNITS_PER_WORD]
+                        & (1u << (unit % ERASED_CACHE_UNITS_PER_WORD))) == 0u)
+                {
+                    b_known_blank = FALSE;
+                    break;
+                }
+
+                unit++;
+            }
+        }
+    }
+
+    return b_known_blank;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erase_range_check converts the logical address for an erase to a physical
+ * one, and checks that the erase is of whole sectors.
+ *
+ * @param   logical_start_address       The logical start address for the erase.
+ * @param   number_of_bytes_to_erase    The number of bytes to erase.
+ * @param   p_physical_address          Physical address is written here.
+ * @param   p_physical_device           Physical device is written here.
+ * @retval  bool_t                      TRUE if the range can be erased.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t erase_range_check(const uint32_t logical_start_address,
+                                const uint32_t number_of_bytes_to_erase,
+                                uint32_t * const p_physical_address,
+                                storage_devices_t * const p_physical_device)
+{
+    bool_t      b_range_ok = FALSE;
+    uint32_t    sector_offset;
+    uint32_t    sector_remainder;
+
+    if (convert_from_logical_2_physical(logical_start_address,
+                                        number_of_bytes_to_erase,
+                                        p_physical_address,
+                                        p_physical_device))
+    {
+        sector_offset    = (*p_physical_address - m_physical_addresses[*p_physical_device].start_address)
+                                % m_physical_addresses[*p_physical_device].block_size_bytes;
+
+        sector_remainder = number_of_bytes_to_erase
+                                % m_physical_addresses[*p_physical_device].block_size_bytes;
+
+        if ( (sector_offset == 0u) && (sector_remainder == 0u) )
+        {
+            b_range_ok = TRUE;
+        }
+    }
+
+    return b_range_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erase_step moves the background erase on by one step - checking on the
+ * sector being erased if there is one, otherwise starting the next.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void erase_step(void)
+{
+    if (m_erase.b_sector_running)
+    {
+        erase_sector_check();
+    }
+    else if (m_erase.b_in_progress)
+    {
+        erase_sector_start();
+    }
+    else
+    {
+        /* Nothing to do. */
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erase_sector_start starts erasing the next sector of the background erase,
+ * without waiting for it.  As main_flash_partial_erase, a sector which is
+ * already blank isn't erased.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void erase_sector_start(void)
+{
+    const uint32_t  sector_bytes = m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].block_size_bytes;
+    FLASHDATA *     p_device;
+    ADDRESS         device_offset;
+
+    if (check_one_flash_sector_blank(m_erase.word_address))
+    {
+        erased_cache_mark(m_erase.word_address * 2u, sector_bytes);
+
+        m_erase.word_address += (sector_bytes / 2u);
+        m_erase.sectors_remaining--;
+        m_erase.b_in_progress = (m_erase.sectors_remaining != 0u);
+    }
+    else
+    {
+        main_flash_device_get(m_erase.word_address, &p_device, &device_offset);
+
+        lld_SectorEraseCmd(p_device, device_offset);
+
+        m_erase.b_sector_running = TRUE;
+        Timer_StopWatchSet(&m_erase.run_start_time);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erase_sector_check reads the status of the sector being erased, and if it
+ * has finished moves on to the next sector.  An error stops the erase.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void erase_sector_check(void)
+{
+    const uint32_t  sector_bytes = m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].block_size_bytes;
+    FLASHDATA *     p_device;
+    ADDRESS         device_offset;
+    FLASHDATA       status_reg;
+
+    main_flash_device_get(m_erase.word_address, &p_device, &device_offset);
+
+    status_reg = lld_StatusGetReg(p_device, device_offset);
+
+    if ((status_reg & DEV_RDY_MASK) == DEV_RDY_MASK)
+    {
+        m_erase.b_sector_running = FALSE;
+
+        if ((status_reg & (DEV_ERASE_MASK | DEV_SEC_LOCK_MASK)) != 0u)
+        {
+            /* Leave the device in read mode, as lld_SectorEraseOp would, and give up. */
+            lld_StatusClear(p_device);
+
+            erased_cache_clear(m_erase.word_address * 2u, sector_bytes);
+
+            m_erase.erase_status  = FLASH_HAL_WRITE_FAIL;
+            m_erase.b_in_progress = FALSE;
+        }
+        else
+        {
+            erased_cache_mark(m_erase.word_address * 2u, sector_bytes);
+
+            m_erase.word_address += (sector_bytes / 2u);
+            m_erase.sectors_remaining--;
+            m_erase.b_in_progress = (m_erase.sectors_remaining != 0u);
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erase_sector_wait waits for the sector being erased in the background to
+ * finish, if it's on the same device as the range about to be accessed.
+ * The next sector isn't started until the erase is polled again.
+ *
+ * @param   word_address        First word address to be accessed.
+ * @param   number_of_words     Number of words to be accessed.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void erase_sector_wait(const uint32_t word_address,
+                              const uint32_t number_of_words)
+{
+    if (erase_die_check(word_address, number_of_words))
+    {
+        while (m_erase.b_sector_running)
+        {
+            erase_sector_check();
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erase_access_suspend gets the main flash ready for a read or write while an
+ * erase is running in the background on the same device.
+ *
+ * An access to the sector being erased has to wait for the erase to finish.
+ * Anywhere else, the erase is suspended for the access, but only once it has
+ * run for ERASE_RESUME_TO_SUSPEND_TICKS since it started or last resumed -
+ * otherwise back to back accesses would keep it from ever finishing.  If the
+ * erase finishes before it can be suspended, it's dealt with as finished.
+ *
+ * @param   word_address        First word address to be accessed.
+ * @param   number_of_words     Number of words to be accessed.
+ * @retval  bool_t              TRUE if the erase was suspended, in which case
+ *                              erase_access_resume must be called after the access.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t erase_access_suspend(const uint32_t word_address,
+                                   const uint32_t number_of_words)
+{
+    const uint32_t  sector_words = m_physical_addresses[STORAGE_DEVICE_MAIN_FLASH].block_size_bytes / 2u;
+    FLASHDATA *     p_device;
+    ADDRESS         device_offset;
+    bool_t          b_suspended = FALSE;
+
+    if ( (m_erase.b_sector_running) && (erase_die_check(word_address, number_of_words)) )
+    {
+        if ( (word_address < (m_erase.word_address + sector_words))
+                && ((word_address + number_of_words) > m_erase.word_address) )
+        {
+            erase_sector_wait(word_address, number_of_words);
+        }
+        else
+        {
+            while ( (m_erase.b_sector_running)
+                        && (Timer_StopWatchGet(m_erase.run_start_time) < ERASE_RESUME_TO_SUSPEND_TICKS) )
+            {
+                erase_sector_check();
+            }
+
+            if (m_erase.b_sector_running)
+            {
+                main_flash_device_get(m_erase.word_address, &p_device, &device_offset);
+
+                if (lld_EraseSuspendOp(p_device) == DEV_ERASE_SUSPEND)
+                {
+                    m_erase.b_suspended = TRUE;
+                    b_suspended = TRUE;
+                }
+                else
+                {
+                    erase_sector_check();
+                }
+            }
+        }
+    }
+
+    return b_suspended;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erase_access_resume resumes an erase suspended by erase_access_suspend, and
+ * restarts the time it must run for before it can be suspended again.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void erase_access_resume(void)
+{
+    FLASHDATA *     p_device;
+    ADDRESS         device_offset;
+
+    if (m_erase.b_suspended)
+    {
+        main_flash_device_get(m_erase.word_address, &p_device, &device_offset);
+
+        lld_EraseResumeCmd(p_device);
+
+        m_erase.b_suspended = FALSE;
+        Timer_StopWatchSet(&m_erase.run_start_time);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * erase_die_check checks whether a range of the main flash is on the same
+ * device as the erase running in the background.
+ *
+ * @param   word_address        First word address in the range.
+ * @param   number_of_words     Number of words in the range.
+ * @retval  bool_t              TRUE if an erase is running on the same device.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t erase_die_check(const uint32_t word_address,
+                              const uint32_t number_of_words)
+{
+    bool_t  b_same_die = FALSE;
+
+    if ( (m_erase.b_in_progress) && (number_of_words != 0u) )
+    {
+        if (m_erase.word_address >= MAIN_FLASH_LOWER_DEVICE_MAX)
+        {
+            b_same_die = (((word_address + number_of_words) - 1u) >= MAIN_FLASH_LOWER_DEVICE_MAX);
+        }
+        else
+        {
+            b_same_die = (word_address < MAIN_FLASH_LOWER_DEVICE_MAX);
+        }
+    }
+
+    return b_same_die;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * main_flash_device_get finds which main flash device a word address is in,
+ * and the offset into that device.
+ *
+ * @param   word_address        Word address in the main flash.
+ * @param   pp_device           Device base address is written here.
+ * @param   p_device_offset     Offset into the device is written here.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_device_get(const uint32_t word_address,
+                                  FLASHDATA ** const pp_device,
+                                  ADDRESS * const p_device_offset)
+{
+    if (word_address < MAIN_FLASH_LOWER_DEVICE_MAX)
+    {
+        *pp_device       = DEVICE_ZERO_BASE;
+        *p_device_offset = word_address;
+    }
+    else
+    {
+        //lint -e{9078} -e{923} Cast from int to pointer.
+        *pp_device       = DEVICE_ONE_BASE;
+        *p_device_offset = word_address - MAIN_FLASH_LOWER_DEVICE_MAX;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * main_flash_die_split splits a range of the main flash into the part in
+ * each device, ready for an operation to run in both at once.
+ *
+ * @param   word_address        First word address in the range.
+ * @param   number_of_words     Number of words in the range.
+ * @param   p_die_op            Pointer to array of MAIN_FLASH_DEVICES to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_die_split(const uint32_t word_address,
+                                 const uint32_t number_of_words,
+                                 flash_hal_die_op_t * const p_die_op)
+{
+    uint32_t    lower_device_words = 0u;
+
+    if (word_address < MAIN_FLASH_LOWER_DEVICE_MAX)
+    {
+        lower_device_words = MAIN_FLASH_LOWER_DEVICE_MAX - word_address;
+        if (lower_device_words > number_of_words)
+        {
+            lower_device_words = number_of_words;
+        }
+
+        p_die_op[0].device_offset = word_address;
+        p_die_op[1].device_offset = 0u;
+    }
+    else
+    {
+        p_die_op[0].device_offset = 0u;
+        p_die_op[1].device_offset = word_address - MAIN_FLASH_LOWER_DEVICE_MAX;
+    }
+
+    p_die_op[0].words_remaining = lower_device_words;
+    p_die_op[0].byte_offset     = 0u;
+    p_die_op[0].poll_offset     = 0u;
+    p_die_op[0].b_busy          = FALSE;
+
+    p_die_op[1].words_remaining = number_of_words - lower_device_words;
+    p_die_op[1].byte_offset     = lower_device_words * 2u;
+    p_die_op[1].poll_offset     = 0u;
+    p_die_op[1].b_busy          = FALSE;
+}
+
+
+// ----------------------------------------------------------------------------
+/*!
+ * main_flash_die_base_get returns the base address of a main flash device.
+ *
+ * @param   die             Device number, 0 or 1.
+ * @retval  FLASHDATA*      Device base address.
+ *
+ */
+// ----------------------------------------------------------------------------
+static FLASHDATA* main_flash_die_base_get(const uint32_t die)
+{
+    FLASHDATA*  p_device = DEVICE_ZERO_BASE;
+
+    if (die != 0u)
+    {
+        //lint -e{9078} -e{923} Cast from int to pointer.
+        p_device = DEVICE_ONE_BASE;
+    }
+
+    return p_device;
+}
+
@@ -0,0 +1,298 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        flash_read_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side benchmark of the main flash read paths.
+ * @details
+ * Reads the same range of the simulated main flash (flash_sim.c) three ways,
+ * one request at a time, and measures each with the simulated bus time and
+ * with the host processor time:
+ *
+ *  - Word loop - the original main_flash_read, which chooses the die, calls
+ *    lld_ReadOp and splits the word into bytes once per word.
+ *  - Burst bytes - flash_hal_device_read, which chooses the die once per
+ *    request and reads through lld_BlockReadOp.
+ *  - Burst words - flash_hal_device_read_words, as above but without
+ *    splitting the words into bytes.
+ *
+ * The range may cross from die 0 into die 1.  The data read by each path is
+ * compared, so the benchmark also checks the burst paths against the word loop.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs the simulated
+ * devices (without resetting them, so they can be preloaded) and initialises
+ * the flash HAL with its own map, in which logical and physical main flash
+ * addresses are the same.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include <time.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "flash_hal.h"
+#include "lld.h"
+#include "buffer_utils.h"
+#include "flash_sim.h"
+#include "flash_read_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define MAIN_FLASH_LOWER_DEVICE_MAX     0x04000000u     ///< First word address in device one.
+#define MAIN_FLASH_SIZE_WORDS           0x08000000u     ///< Words in both devices.
+
+#define DEFAULT_CONFIG                  { MAIN_FLASH_LOWER_DEVICE_MAX - 0x8000u, 0x10000u, 256u }
+
+/// Whole of the main flash in the first partition, the rest just fill the map.
+#define BENCHMARK_LOGICAL_ADDRESSES                                 \
+{                                                                   \
+    { STORAGE_DEVICE_MAIN_FLASH,   0x00000000u, 0x0FFFFFFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10000000u, 0x10001FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10002000u, 0x10003FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10004000u, 0x10005FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10006000u, 0x10007FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10008000u, 0x10009FFFu },      \
+    { STORAGE_DEVICE_I2C_EEPROM,   0x10010000u, 0x10010FFFu },      \
+}
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     word_loop_read(const uint32_t word_address,
+                               const uint32_t words_to_read,
+                               uint8_t * const p_byte_data);
+
+static void     path_start(flash_read_sim_path_t * const p_path,
+                           clock_t * const p_host_start);
+
+static void     path_end(flash_read_sim_path_t * const p_path,
+                         const clock_t host_start);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static const flash_hal_logical_t m_logical_addresses[RS_CFG_MAX_NUMBER_OF_PARTITIONS]
+                                    = BENCHMARK_LOGICAL_ADDRESSES;
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_word_loop_bytes[FLASH_READ_SIM_MAX_REQUEST_WORDS * 2u];
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_burst_bytes[FLASH_READ_SIM_MAX_REQUEST_WORDS * 2u];
+
+//lint -e{956} Only used from a single host thread.
+static uint16_t     m_burst_words[FLASH_READ_SIM_MAX_REQUEST_WORDS];
+
+//lint -e{956} Only used from a single host thread.
+static flash_sim_stats_t m_stats_at_start;
+
+//lint -e{956} Only used from a single host thread.
+static uint64_t     m_bus_ns_at_start;
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * flash_read_sim_config_default fills in the configuration for 64k words,
+ * read in 256 word (512 byte) requests - the size of a dump frame - starting
+ * 32k words below the end of die 0, so that half of the reads are in each die.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_read_sim_config_default(flash_read_sim_config_t * const p_config)
+{
+    const flash_read_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_read_sim_run reads the configured range with each read path.
+ *
+ * @param   p_config    Pointer to the range to read.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t flash_read_sim_run(const flash_read_sim_config_t * const p_config,
+                          flash_read_sim_result_t * const p_result)
+{
+    uint32_t    word_address;
+    uint32_t    words_remaining;
+    uint32_t    request_words;
+    uint32_t    i;
+    clock_t     host_start;
+    bool_t      b_valid = FALSE;
+    const flash_read_sim_path_t no_reads = { 0u, 0u, 0u, 0u, 0u };
+
+    if ( (p_config->request_words != 0u)
+            && (p_config->request_words <= FLASH_READ_SIM_MAX_REQUEST_WORDS)
+            && (p_config->start_word_address < MAIN_FLASH_SIZE_WORDS)
+            && (p_config->number_of_words <= (MAIN_FLASH_SIZE_WORDS - p_config->start_word_address)) )
+    {
+        flash_sim_install();
+        b_valid = flash_hal_initialise(&m_logical_addresses[0]);
+    }
+
+    if (b_valid)
+    {
+        p_result->word_loop      = no_reads;
+        p_result->burst_bytes    = no_reads;
+        p_result->burst_words    = no_reads;
+        p_result->b_data_matches = TRUE;
+
+        word_address    = p_config->start_word_address;
+        words_remaining = p_config->number_of_words;
+
+        while (words_remaining != 0u)
+        {
+            request_words = (words_remaining > p_config->request_words)
+                                ? p_config->request_words : words_remaining;
+
+            path_start(&p_result->word_loop, &host_start);
+            word_loop_read(word_address, request_words, &m_word_loop_bytes[0]);
+            path_end(&p_result->word_loop, host_start);
+
+            path_start(&p_result->burst_bytes, &host_start);
+            (void)flash_hal_device_read(word_address * 2u, request_words * 2u, &m_burst_bytes[0]);
+            path_end(&p_result->burst_bytes, host_start);
+
+            path_start(&p_result->burst_words, &host_start);
+            (void)flash_hal_device_read_words(word_address * 2u, request_words, &m_burst_words[0]);
+            path_end(&p_result->burst_words, host_start);
+
+            for (i = 0u; i < request_words; i++)
+            {
+                if ( (m_word_loop_bytes[i * 2u] != m_burst_bytes[i * 2u])
+                        || (m_word_loop_bytes[(i * 2u) + 1u] != m_burst_bytes[(i * 2u) + 1u])
+                        || (BUFFER_UTILS_8bitBufToUint16(&m_word_loop_bytes[i * 2u]) != m_burst_words[i]) )
+                {
+                    p_result->b_data_matches = FALSE;
+                }
+            }
+
+            word_address    += request_words;
+            words_remaining -= request_words;
+        }
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * word_loop_read is the main_flash_read which flash_hal used before the burst
+ * read path, kept here as the reference.
+ *
+ * @param   word_address    The word address to read from.
+ * @param   words_to_read   Number of words to read.
+ * @param   p_byte_data     Pointer to byte array to put the read data in.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void word_loop_read(const uint32_t word_address,
+                           const uint32_t words_to_read,
+                           uint8_t * const p_byte_data)
+{
+    uint32_t    address = word_address;
+    uint32_t    words_remaining = words_to_read;
+    uint32_t    byte_offset = 0u;
+    uint16_t    temp_read;
+
+    while (words_remaining != 0u)
+    {
+        if (address < MAIN_FLASH_LOWER_DEVICE_MAX)
+        {
+            temp_read = lld_ReadOp(DEVICE_ZERO_BASE, address);
+        }
+        else
+        {
+            //lint -e{9078} -e{923} Conversion between pointer and integer type.
+            temp_read = lld_ReadOp(DEVICE_ONE_BASE, (address - MAIN_FLASH_LOWER_DEVICE_MAX));
+        }
+
+        //lint -e{920} Ignoring return value, not used here as we use byte_offset.
+        (void)BUFFER_UTILS_Uint16To8bitBuf(&p_byte_data[byte_offset], temp_read);
+        byte_offset += 2u;
+        address++;
+        words_remaining--;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * path_start records the simulated and host time before a read request.
+ *
+ * @param   p_path          Pointer to the read path being measured.
+ * @param   p_host_start    Host processor time is written here.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void path_start(flash_read_sim_path_t * const p_path,
+                       clock_t * const p_host_start)
+{
+    flash_sim_stats_get(&m_stats_at_start);
+    m_bus_ns_at_start = flash_sim_time_ns_get();
+
+    p_path->requests++;
+    *p_host_start = clock();
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * path_end adds the cost of a read request to a read path.
+ *
+ * @param   p_path          Pointer to the read path being measured.
+ * @param   host_start      Host processor time before the request.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void path_end(flash_read_sim_path_t * const p_path,
+                     const clock_t host_start)
+{
+    clock_t             host_end;
+    flash_sim_stats_t   stats;
+
+    host_end = clock();
+    flash_sim_stats_get(&stats);
+
+    p_path->host_ns        += ((uint64_t)(host_end - host_start) * 1000000000u) / CLOCKS_PER_SEC;
+    p_path->bus_ns         += flash_sim_time_ns_get() - m_bus_ns_at_start;
+    p_path->bus_reads      += stats.main_flash_bus_reads - m_stats_at_start.main_flash_bus_reads;
+    p_path->address_setups += stats.main_flash_address_setups - m_stats_at_start.main_flash_address_setups;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,2053 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        flash_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side simulation of the recording system storage devices.
+ * @details
+ * RAM backed models of the three devices which sit underneath flash_hal.c,
+ * so that the recording system can be run and timed on a PC:
+ *
+ *  - Main flash - two S29GL01GS dies (64M words each, 128kbyte sectors).
+ *    The model decodes the command sequences issued by the LLD through
+ *    EXTFLASH_ExternalFlashRead / EXTFLASH_ExternalFlashWrite (and burst reads
+ *    through EXTFLASH_ExternalFlashBlockRead), so the real lld.c and
+ *    flash_hal.c code paths are exercised.  Each single access pays for
+ *    setting up GPIO[26:20], a burst read only once per 1M word window.  Erase sets every bit
+ *    in the sector to 1, programming can only clear bits (the new contents
+ *    are the AND of the old contents and the data), and each die has its own
+ *    busy time and status register.  A sector erase can be suspended, which
+ *    takes the suspend latency, after which the rest of the die can be read
+ *    and programmed (the suspended sector reads as status).  An erase
+ *    suspended less than the minimum time after it started or resumed makes
+ *    no progress in that time, as the device spends it getting going again.
+ *  - Serial flash - an M95512 SPI EEPROM (64kbytes, 128 byte pages), decoded
+ *    from the SPI-A register accesses made through genericIO and the GPIO57
+ *    chip select.  Writes wrap within a page and start a write cycle (WIP).
+ *    The SPI shifter and the 16 word FIFOs are modelled, so characters only
+ *    go out back to back when the FIFOs are kept topped up.
+ *  - I2C EEPROM - a 24LC32A (4kbytes, 32 byte pages), reached through the
+ *    I2C_Read / I2C_Write / I2C_AckPoll function pointers.  Writes wrap within
+ *    a page and the device does not acknowledge until the write cycle ends.
+ *
+ * All devices share one simulated clock, advanced by every bus access and
+ * by the time spent polling busy devices, so that throughput and latency can
+ * be measured from flash_sim_time_ns_get() independently of host speed.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD and uses the C library heap -
+ * main flash sectors are only allocated once they have been programmed.
+ *
+ * @note
+ * As on the target, M95_DeviceSizeInitialise(128u, 65536u) and SPI_Open(8u)
+ * must be called before the serial flash is used.
+ *
+ * @note
+ * The flash HAL times erase suspends with the millisecond timer, so host
+ * builds which erase the main flash should run the timer from the simulated
+ * clock (flash_sim_time_ns_get() / 1000000).
+ *
+ * @note
+ * test/Makefile builds this module with the recording system for the host
+ * programs, including the benchmark in test/rs_bench.c.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include <stdlib.h>
+#include <string.h>
+#include "common_data_types.h"
+#include "DSP28335_device.h"
+#include "rsappconfig.h"
+#include "extflash.h"
+#include "genericIO.h"
+#include "i2c.h"
+#include "m95.h"
+#include "m95_prv.h"
+#include "flash_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define MAIN_FLASH_NUMBER_OF_DIES       2u              ///< Two devices, split at MAIN_FLASH_LOWER_DEVICE_MAX.
+#define MAIN_FLASH_DIE_SIZE_WORDS       0x04000000u     ///< Words per die.
+#define MAIN_FLASH_SECTOR_SIZE_WORDS    0x00010000u     ///< Words per sector (128kbytes).
+#define MAIN_FLASH_SECTOR_SHIFT         16u             ///< Word offset to sector shift.
+#define MAIN_FLASH_WINDOW_SIZE_WORDS    0x00100000u     ///< Words reached by XA0 - XA19.
+#define MAIN_FLASH_SECTORS_PER_DIE      (MAIN_FLASH_DIE_SIZE_WORDS / MAIN_FLASH_SECTOR_SIZE_WORDS)
+#define MAIN_FLASH_BUFFER_SIZE_WORDS    256u            ///< Write buffer size (LLD_BUFFER_SIZE).
+#define MAIN_FLASH_BUFFER_LINE_MASK     0xFFFFFF00u     ///< Write buffer page mask.
+#define MAIN_FLASH_COMMAND_ADDRESS_MASK 0x00000FFFu     ///< Address bits decoded for commands.
+#define MAIN_FLASH_UNLOCK_ADDRESS_1     0x00000555u     ///< First unlock address.
+#define MAIN_FLASH_UNLOCK_ADDRESS_2     0x000002AAu     ///< Second unlock address.
+#define MAIN_FLASH_ERASED_WORD          0xFFFFu         ///< Contents of an erased word.
+
+#define MAIN_FLASH_CMD_UNLOCK_DATA_1    0x00AAu         ///< First unlock data.
+#define MAIN_FLASH_CMD_UNLOCK_DATA_2    0x0055u         ///< Second unlock data.
+#define MAIN_FLASH_CMD_PROGRAM          0x00A0u         ///< Word program.
+#define MAIN_FLASH_CMD_BUFFER_LOAD      0x0025u         ///< Write to buffer.
+#define MAIN_FLASH_CMD_BUFFER_CONFIRM   0x0029u         ///< Program buffer to flash.
+#define MAIN_FLASH_CMD_ERASE_SETUP      0x0080u         ///< Erase setup.
+#define MAIN_FLASH_CMD_SECTOR_ERASE     0x0030u         ///< Sector erase.
+#define MAIN_FLASH_CMD_CHIP_ERASE       0x0010u         ///< Chip erase.
+#define MAIN_FLASH_CMD_RESET            0x00F0u         ///< Reset \ write buffer abort reset.
+#define MAIN_FLASH_CMD_STATUS_READ      0x0070u         ///< Status register read.
+#define MAIN_FLASH_CMD_STATUS_CLEAR     0x0071u         ///< Status register clear.
+#define MAIN_FLASH_CMD_BLANK_CHECK      0x0033u         ///< Sector blank check.
+#define MAIN_FLASH_CMD_ERASE_SUSPEND    0x00B0u         ///< Erase suspend.
+#define MAIN_FLASH_CMD_ERASE_RESUME     0x0030u         ///< Erase resume.
+
+#define MAIN_FLASH_STATUS_READY         0x0080u         ///< Device ready bit.
+#define MAIN_FLASH_STATUS_ERASE_SUSPEND 0x0040u         ///< Erase suspended bit.
+#define MAIN_FLASH_STATUS_ERASE_ERROR   0x0020u         ///< Erase error \ sector not blank.
+#define MAIN_FLASH_STATUS_PROGRAM_ERROR 0x0010u         ///< Program error.
+#define MAIN_FLASH_STATUS_BUFFER_ABORT  0x0008u         ///< Write buffer abort.
+#define MAIN_FLASH_STATUS_ERROR_BITS    0x0038u         ///< Bits cleared by the status clear command.
+
+#define SPI_A_BASE_ADDRESS              0x00007040u     ///< Base address of the SPI-A registers.
+#define SPI_A_REGISTER_COUNT            16u             ///< Size of the SPI-A register window.
+#define SPICCR_OFFSET                   0x0000u         ///< Offset from base for SPICCR.
+#define SPISTS_OFFSET                   0x0002u         ///< Offset from base for SPISTS.
+#define SPIRXBUF_OFFSET                 0x0007u         ///< Offset from base for SPIRXBUF.
+#define SPITXBUF_OFFSET                 0x0008u         ///< Offset from base for SPITXBUF.
+#define SPIFFTX_OFFSET                  0x000Au         ///< Offset from base for SPIFFTX.
+#define SPIFFRX_OFFSET                  0x000Bu         ///< Offset from base for SPIFFRX.
+#define SPISTS_SPIINT_BIT_MASK          0x0040u         ///< SPIINT is bit 6.
+#define SPIFFTX_SPIFFENA_BIT_MASK       0x4000u         ///< FIFOs enabled.
+#define SPIFFTX_TXFFST_BIT_MASK         0x1F00u         ///< Words waiting in the TX FIFO.
+#define SPIFFRX_RXFFOVF_BIT_MASK        0x8000u         ///< RX FIFO overflowed.
+#define SPIFFRX_RXFFOVFCLR_BIT_MASK     0x4000u         ///< Clear RXFFOVF.
+#define SPIFFRX_RXFIFORESET_BIT_MASK    0x2000u         ///< RX FIFO pointer out of reset.
+#define SPIFFRX_RXFFST_BIT_MASK         0x1F00u         ///< Words waiting in the RX FIFO.
+#define SPI_FIFO_STATUS_SHIFT           8u              ///< Shift to TXFFST \ RXFFST.
+#define SPI_FIFO_DEPTH                  16u             ///< Words in each SPI FIFO.
+#define SPICCR_CHAR_BITS_MASK           0x000Fu         ///< Number of bits - 1.
+
+#define M95_SIZE_BYTES                  65536u          ///< M95512 array size.
+#define M95_PAGE_SIZE_BYTES             128u            ///< M95512 page size.
+#define M95_ID_PAGE_SIZE_BYTES          256u            ///< Identification page size.
+#define M95_CMD_WRITE_STATUS            0x01u           ///< Write status register.
+#define M95_CMD_WRITE                   0x02u           ///< Write array.
+#define M95_CMD_READ                    0x03u           ///< Read array.
+#define M95_CMD_WRITE_DISABLE           0x04u           ///< Write disable.
+#define M95_CMD_READ_STATUS             0x05u           ///< Read status register.
+#define M95_CMD_WRITE_ENABLE            0x06u           ///< Write enable.
+#define M95_CMD_WRITE_ID_PAGE           0x82u           ///< Write identification page.
+#define M95_CMD_READ_ID_PAGE            0x83u           ///< Read identification page.
+#define M95_STATUS_WIP                  0x01u           ///< Write in progress.
+#define M95_STATUS_WEL                  0x02u           ///< Write enable latch.
+#define M95_STATUS_WRITABLE_BITS        0x8Cu           ///< SRWD and BP bits.
+
+#define X24LC32A_SIZE_BYTES             4096u           ///< 24LC32A array size.
+#define X24LC32A_PAGE_SIZE_BYTES        32u             ///< 24LC32A page size.
+#define X24LC32A_SLAVE_ADDRESS          0x54u           ///< 7 bit slave address as strapped.
+#define I2C_ADDRESS_PHASE_BITS          28u             ///< Start, slave and two address bytes.
+#define I2C_READ_RESTART_BITS           10u             ///< Repeated start and slave byte.
+#define I2C_ACK_POLL_BITS               11u             ///< Start, slave byte and stop.
+
+#define DEFAULT_TIMING                  { 120u, 160u, 10000u, 125u, 340u, 275000u, 1000u, \
+                                          30u, 100u, 500u, 100u, 5000u, 2500u, 5000u }
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// Command decoder states for one main flash die.
+typedef enum
+{
+    DIE_CMD_READ_ARRAY,                 ///< Idle - reads return the array.
+    DIE_CMD_UNLOCK_1,                   ///< First unlock cycle seen.
+    DIE_CMD_UNLOCK_2,                   ///< Second unlock cycle seen.
+    DIE_CMD_PROGRAM_WORD,               ///< Next write is the word to program.
+    DIE_CMD_BUFFER_COUNT,               ///< Next write is the word count - 1.
+    DIE_CMD_BUFFER_LOAD,                ///< Loading the write buffer.
+    DIE_CMD_BUFFER_CONFIRM,             ///< Waiting for program buffer to flash.
+    DIE_CMD_ERASE_SETUP,                ///< Erase setup seen.
+    DIE_CMD_ERASE_UNLOCK_1,             ///< First erase unlock cycle seen.
+    DIE_CMD_ERASE_UNLOCK_2              ///< Second erase unlock cycle seen.
+} die_cmd_state_t;
+
+/// Embedded operation running on one main flash die.
+typedef enum
+{
+    DIE_OP_NONE,                        ///< Nothing running.
+    DIE_OP_PROGRAM,                     ///< Word or buffer program.
+    DIE_OP_SECTOR_ERASE,                ///< Sector erase.
+    DIE_OP_CHIP_ERASE,                  ///< Chip erase.
+    DIE_OP_BLANK_CHECK                  ///< Sector blank check.
+} die_op_t;
+
+/// State for one main flash die.
+typedef struct
+{
+    die_cmd_state_t cmd_state;                              ///< Command decoder state.
+    bool_t          b_status_read_pending;                  ///< Next read returns the status register.
+    die_op_t        op;                                     ///< Embedded operation in progress.
+    uint32_t        op_sector;                              ///< Sector for erase \ blank check.
+    uint64_t        busy_until_ns;                          ///< Time at which the operation ends.
+    uint64_t        run_start_ns;                           ///< Time at which the erase started or resumed.
+    bool_t          b_erase_suspended;                      ///< Sector erase is suspended (or suspending).
+    uint64_t        suspended_at_ns;                        ///< Time at which the suspend takes effect.
+    uint64_t        erase_remaining_ns;                     ///< Erase time left while suspended.
+    uint64_t        suspend_program_until_ns;               ///< Time at which a program made while suspended ends.
+    uint16_t        status_errors;                          ///< Sticky status register error bits.
+    uint32_t        buffer_sector;                          ///< Sector addressed by the buffer load.
+    uint16_t        buffer_count;                           ///< Words to load into the buffer.
+    uint16_t        buffer_loaded;                          ///< Words loaded so far.
+    uint32_t        buffer_offset[MAIN_FLASH_BUFFER_SIZE_WORDS];    ///< Word offsets loaded.
+    uint16_t        buffer_data[MAIN_FLASH_BUFFER_SIZE_WORDS];      ///< Data loaded.
+    uint16_t*       p_sector[MAIN_FLASH_SECTORS_PER_DIE];   ///< Sector contents, NULL if erased.
+} main_flash_die_t;
+
+/// State for the M95 serial flash.
+typedef struct
+{
+    bool_t          b_selected;                             ///< Chip select is active.
+    uint32_t        byte_in_frame;                          ///< Bytes clocked since select.
+    uint8_t         command;                                ///< Instruction for this frame.
+    uint32_t        address;                                ///< Address assembled from the frame.
+    uint32_t        write_count;                            ///< Data bytes latched for a write.
+    uint8_t         status;                                 ///< Status register.
+    uint64_t        busy_until_ns;                          ///< End of the write cycle.
+    uint8_t         rx_data;                                ///< Last byte shifted in from the device.
+    uint16_t        registers[SPI_A_REGISTER_COUNT];        ///< SPI-A register shadow.
+    uint64_t        shift_end_ns;                           ///< End of the last character sent.
+    uint8_t         rx_fifo[SPI_FIFO_DEPTH];                ///< SPI receive FIFO.
+    uint64_t        rx_ready_ns[SPI_FIFO_DEPTH];            ///< When each RX FIFO word arrives.
+    uint16_t        rx_head;                                ///< Oldest word in the RX FIFO.
+    uint16_t        rx_count;                               ///< Words in the RX FIFO.
+    bool_t          b_rx_overflow;                          ///< RX FIFO has overflowed.
+    uint8_t         page_buffer[M95_PAGE_SIZE_BYTES];       ///< Data latched during a write.
+    bool_t          page_latched[M95_PAGE_SIZE_BYTES];      ///< Which page_buffer bytes are valid.
+    uint8_t         array[M95_SIZE_BYTES];                  ///< Memory array.
+    uint8_t         id_page[M95_ID_PAGE_SIZE_BYTES];        ///< Identification page.
+} m95_sim_t;
+
+/// State for the 24LC32A EEPROM.
+typedef struct
+{
+    uint64_t        busy_until_ns;                          ///< End of the write cycle.
+    uint8_t         array[X24LC32A_SIZE_BYTES];             ///< Memory array.
+} x24lc32a_sim_t;
+
+//lint -e{956} Only used from a single host thread.
+static main_flash_die_t     m_die[MAIN_FLASH_NUMBER_OF_DIES];
+
+//lint -e{956} Only used from a single host thread.
+static m95_sim_t            m_m95;
+
+//lint -e{956} Only used from a single host thread.
+static x24lc32a_sim_t       m_x24lc32a;
+
+//lint -e{956} Only used from a single host thread.
+static flash_sim_timing_t   m_timing = DEFAULT_TIMING;
+
+//lint -e{956} Only used from a single host thread.
+static flash_sim_stats_t    m_stats;
+
+//lint -e{956} Only used from a single host thread.
+static uint64_t             m_time_ns = 0u;
+
+//lint -e{956} Only used from a single host thread.
+static bool_t               mb_strict_programming = FALSE;
+
+//lint -e{956} Only used from a single host thread.
+static bool_t               mb_installed = FALSE;
+
+/// Function pointers saved by flash_sim_install, restored by flash_sim_uninstall.
+static uint16_t     (*m_saved_extflash_read)(uint32_t address);
+static void         (*m_saved_extflash_write)(uint32_t address, const uint16_t data);
+static void         (*m_saved_extflash_block_read)(uint32_t address, uint32_t number_of_words,
+                                                   uint16_t * const p_data);
+static uint16_t     (*m_saved_io_16bit_read)(const uint32_t address);
+static void         (*m_saved_io_16bit_write)(const uint32_t address, const uint16_t data);
+static EI2CStatus_t (*m_saved_i2c_read)(const uint16_t SlaveAddress,
+                                        const uint16_t DeviceAddress,
+                                        uint16_t DataCount,
+                                        uint8_t * const pData);
+static EI2CStatus_t (*m_saved_i2c_write)(const uint16_t SlaveAddress,
+                                         const uint16_t DeviceAddress,
+                                         uint16_t DataCount,
+                                         const uint8_t * const pData);
+static EI2CStatus_t (*m_saved_i2c_ack_poll)(uint16_t SlaveAddress, uint16_t MaxTimeout);
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static uint16_t     main_flash_bus_read(uint32_t address);
+static void         main_flash_bus_block_read(uint32_t address, uint32_t number_of_words,
+                                              uint16_t * const p_data);
+static void         main_flash_bus_write(uint32_t address, const uint16_t data);
+static uint16_t     main_flash_cycle_read(const uint32_t address);
+static void         main_flash_address_setup(void);
+static void         main_flash_command_decode(main_flash_die_t * const p_die,
+                                              const uint32_t offset,
+                                              const uint16_t data);
+static void         main_flash_array_command_decode(main_flash_die_t * const p_die,
+                                                    const uint32_t offset,
+                                                    const uint16_t data);
+static void         main_flash_operation_start(main_flash_die_t * const p_die,
+                                               const die_op_t operation,
+                                               const uint32_t sector,
+                                               const uint64_t duration_ns);
+static void         main_flash_program_start(main_flash_die_t * const p_die,
+                                             const uint32_t sector,
+                                             const uint64_t duration_ns);
+static void         main_flash_operation_complete(main_flash_die_t * const p_die);
+static void         main_flash_erase_suspend(main_flash_die_t * const p_die);
+static void         main_flash_erase_resume(main_flash_die_t * const p_die);
+static bool_t       main_flash_busy_check(const main_flash_die_t * const p_die);
+static uint16_t     main_flash_status_get(const main_flash_die_t * const p_die);
+static uint16_t     main_flash_word_get(const main_flash_die_t * const p_die,
+                                        const uint32_t offset);
+static void         main_flash_word_program(main_flash_die_t * const p_die,
+                                            const uint32_t offset,
+                                            const uint16_t data);
+static void         main_flash_word_force(main_flash_die_t * const p_die,
+                                          const uint32_t offset,
+                                          const uint16_t data);
+static void         main_flash_sector_erase(main_flash_die_t * const p_die,
+                                            const uint32_t sector);
+
+static uint16_t     spi_register_read(const uint32_t address);
+static void         spi_register_write(const uint32_t address, const uint16_t data);
+static uint16_t     spi_rx_fifo_ready_count(void);
+static uint16_t     spi_tx_fifo_waiting_count(void);
+static void         m95_chip_select_update(void);
+static void         m95_frame_end(void);
+static uint8_t      m95_byte_transfer(const uint8_t tx_byte);
+static uint32_t     m95_address_bytes_get(void);
+
+static EI2CStatus_t x24lc32a_read(const uint16_t SlaveAddress,
+                                  const uint16_t DeviceAddress,
+                                  uint16_t DataCount,
+                                  uint8_t * const pData);
+static EI2CStatus_t x24lc32a_write(const uint16_t SlaveAddress,
+                                   const uint16_t DeviceAddress,
+                                   uint16_t DataCount,
+                                   const uint8_t * const pData);
+static EI2CStatus_t x24lc32a_ack_poll(uint16_t SlaveAddress, uint16_t MaxTimeout);
+
+static void         time_advance(const uint64_t nanoseconds);
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_install redirects the external flash, SPI register and I2C
+ * access functions to the simulated devices.  The devices keep whatever
+ * contents they had, so flash_sim_reset() should be called for a clean start.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_install(void)
+{
+    if (!mb_installed)
+    {
+        m_saved_extflash_read   = EXTFLASH_ExternalFlashRead;
+        m_saved_extflash_write  = EXTFLASH_ExternalFlashWrite;
+        m_saved_extflash_block_read = EXTFLASH_ExternalFlashBlockRead;
+        m_saved_io_16bit_read   = genericIO_16bitRead;
+        m_saved_io_16bit_write  = genericIO_16bitWrite;
+        m_saved_i2c_read        = I2C_Read;
+        m_saved_i2c_write       = I2C_Write;
+        m_saved_i2c_ack_poll    = I2C_AckPoll;
+
+        EXTFLASH_ExternalFlashRead  = main_flash_bus_read;
+        EXTFLASH_ExternalFlashWrite = main_flash_bus_write;
+        EXTFLASH_ExternalFlashBlockRead = main_flash_bus_block_read;
+        genericIO_16bitRead         = spi_register_read;
+        genericIO_16bitWrite        = spi_register_write;
+        I2C_Read                    = x24lc32a_read;
+        I2C_Write                   = x24lc32a_write;
+        I2C_AckPoll                 = x24lc32a_ack_poll;
+
+        mb_installed = TRUE;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_uninstall restores the function pointers which were in use
+ * before flash_sim_install() was called.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_uninstall(void)
+{
+    if (mb_installed)
+    {
+        EXTFLASH_ExternalFlashRead  = m_saved_extflash_read;
+        EXTFLASH_ExternalFlashWrite = m_saved_extflash_write;
+        EXTFLASH_ExternalFlashBlockRead = m_saved_extflash_block_read;
+        genericIO_16bitRead         = m_saved_io_16bit_read;
+        genericIO_16bitWrite        = m_saved_io_16bit_write;
+        I2C_Read                    = m_saved_i2c_read;
+        I2C_Write                   = m_saved_i2c_write;
+        I2C_AckPoll                 = m_saved_i2c_ack_poll;
+
+        mb_installed = FALSE;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_reset puts every simulated device back into its erased, idle
+ * state, and zeroes the simulated clock and the statistics.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_reset(void)
+{
+    uint32_t    die;
+    uint32_t    sector;
+
+    for (die = 0u; die < MAIN_FLASH_NUMBER_OF_DIES; die++)
+    {
+        for (sector = 0u; sector < MAIN_FLASH_SECTORS_PER_DIE; sector++)
+        {
+            free(m_die[die].p_sector[sector]);
+        }
+
+        (void)memset(&m_die[die], 0, sizeof(m_die[die]));
+        m_die[die].cmd_state = DIE_CMD_READ_ARRAY;
+        m_die[die].op        = DIE_OP_NONE;
+    }
+
+    (void)memset(&m_m95, 0, sizeof(m_m95));
+    (void)memset(m_m95.array, 0xFF, sizeof(m_m95.array));
+    (void)memset(m_m95.id_page, 0xFF, sizeof(m_m95.id_page));
+    m_m95.registers[SPICCR_OFFSET] = 7u;
+
+    // The serial flash driver's write cache is lost at power up too.
+    M95_CacheDiscard_TDD();
+
+    (void)memset(&m_x24lc32a, 0, sizeof(m_x24lc32a));
+    (void)memset(m_x24lc32a.array, 0xFF, sizeof(m_x24lc32a.array));
+
+    // Clear any chip select edges left over from a previous run.
+    GpioDataRegs.GPBSET.bit.GPIO57   = 0u;
+    GpioDataRegs.GPBCLEAR.bit.GPIO57 = 0u;
+
+    m_time_ns = 0u;
+    flash_sim_stats_clear();
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_timing_set replaces the timing model.
+ *
+ * @param   p_timing    Pointer to the new timing values.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_timing_set(const flash_sim_timing_t * const p_timing)
+{
+    m_timing = *p_timing;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_timing_get returns a copy of the timing model in use.
+ *
+ * @param   p_timing    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_timing_get(flash_sim_timing_t * const p_timing)
+{
+    *p_timing = m_timing;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_strict_programming_set selects what happens when the main flash
+ * is asked to program a bit from 0 back to 1.  The bit always stays at 0 and
+ * the attempt is always counted - in strict mode the program error bit is
+ * also set in the status register so that the LLD reports DEV_PROGRAM_ERROR.
+ *
+ * @param   b_strict    TRUE to report attempts as program errors.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_strict_programming_set(const bool_t b_strict)
+{
+    mb_strict_programming = b_strict;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_time_ns_get returns the simulated time since the last reset.
+ *
+ * @retval  uint64_t    Simulated time, in nanoseconds.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint64_t flash_sim_time_ns_get(void)
+{
+    return m_time_ns;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_time_advance moves the simulated clock forwards, so that callers
+ * can model CPU time spent between device accesses.
+ *
+ * @param   nanoseconds     Time to add to the simulated clock.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_time_advance(const uint32_t nanoseconds)
+{
+    time_advance(nanoseconds);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_stats_get returns a copy of the access counters.
+ *
+ * @param   p_stats     Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_stats_get(flash_sim_stats_t * const p_stats)
+{
+    *p_stats = m_stats;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_stats_clear zeroes the access counters.
+ *
+ */
+// ----------------------------------------------------------------------------
+void flash_sim_stats_clear(void)
+{
+    (void)memset(&m_stats, 0, sizeof(m_stats));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_backdoor_read reads device contents directly, without using
+ * any simulated time and ignoring any operation in progress.
+ *
+ * @param   device              Device to read from.
+ * @param   physical_address    Physical byte address (as used by flash_hal).
+ * @param   number_of_bytes     Number of bytes to read.
+ * @param   p_buffer            Pointer to buffer to put data in.
+ * @retval  bool_t              TRUE if the range is valid, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t flash_sim_backdoor_read(const storage_devices_t device,
+                               const uint32_t physical_address,
+                               const uint32_t number_of_bytes,
+                               uint8_t * const p_buffer)
+{
+    bool_t      b_valid = TRUE;
+    uint32_t    counter;
+    uint32_t    byte_address;
+    uint32_t    word_address;
+    uint16_t    word;
+
+    for (counter = 0u; (counter < number_of_bytes) && b_valid; counter++)
+    {
+        byte_address = physical_address + counter;
+
+        switch (device)
+        {
+            case STORAGE_DEVICE_MAIN_FLASH:
+                word_address = byte_address >> 1u;
+                if (word_address < (MAIN_FLASH_NUMBER_OF_DIES * MAIN_FLASH_DIE_SIZE_WORDS))
+                {
+                    word = main_flash_word_get(&m_die[word_address / MAIN_FLASH_DIE_SIZE_WORDS],
+                                               word_address % MAIN_FLASH_DIE_SIZE_WORDS);
+                    //lint -e{921} Cast from uint16_t to uint8_t.
+                    p_buffer[counter] = (uint8_t)( ((byte_address & 1u) != 0u) ? (word >> 8u) : (word & 0x00FFu) );
+                }
+                else
+                {
+                    b_valid = FALSE;
+                }
+                break;
+
+            case STORAGE_DEVICE_SERIAL_FLASH:
+                if (byte_address < M95_SIZE_BYTES)
+                {
+                    p_buffer[counter] = m_m95.array[byte_address];
+                }
+                else
+                {
+                    b_valid = FALSE;
+                }
+                break;
+
+            case STORAGE_DEVICE_I2C_EEPROM:
+                if (byte_address < X24LC32A_SIZE_BYTES)
+                {
+                    p_buffer[counter] = m_x24lc32a.array[byte_address];
+                }
+                else
+                {
+                    b_valid = FALSE;
+                }
+                break;
+
+            default:
+                b_valid = FALSE;
+                break;
+        }
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_sim_backdoor_write overwrites device contents directly, without
+ * using any simulated time and without the erase \ program rules - used to
+ * preload images or to inject corruption.
+ *
+ * @param   device              Device to write to.
+ * @param   physical_address    Physical byte address (as used by flash_hal).
+ * @param   number_of_bytes     Number of bytes to write.
+ * @param   p_buffer            Pointer to buffer containing the data.
+ * @retval  bool_t              TRUE if the range is valid, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t flash_sim_backdoor_write(const storage_devices_t device,
+                                const uint32_t physical_address,
+                                const uint32_t number_of_bytes,
+                                const uint8_t * const p_buffer)
+{
+    bool_t              b_valid = TRUE;
+    uint32_t            counter;
+    uint32_t            byte_address;
+    uint32_t            word_address;
+    uint16_t            word;
+    main_flash_die_t*   p_die;
+
+    for (counter = 0u; (counter < number_of_bytes) && b_valid; counter++)
+    {
+        byte_address = physical_address + counter;
+
+        switch (device)
+        {
+            case STORAGE_DEVICE_MAIN_FLASH:
+                word_address = byte_address >> 1u;
+                if (word_address < (MAIN_FLASH_NUMBER_OF_DIES * MAIN_FLASH_DIE_SIZE_WORDS))
+                {
+                    p_die = &m_die[word_address / MAIN_FLASH_DIE_SIZE_WORDS];
+                    word_address %= MAIN_FLASH_DIE_SIZE_WORDS;
+                    word = main_flash_word_get(p_die, word_address);
+
+                    if ((byte_address & 1u) != 0u)
+                    {
+                        word = (word & 0x00FFu) | (uint16_t)((uint16_t)p_buffer[counter] << 8u);
+                    }
+                    else
+                    {
+                        word = (word & 0xFF00u) | (uint16_t)p_buffer[counter];
+                    }
+
+                    main_flash_word_force(p_die, word_address, word);
+                }
+                else
+                {
+                    b_valid = FALSE;
+                }
+                break;
+
+            case STORAGE_DEVICE_SERIAL_FLASH:
+                if (byte_address < M95_SIZE_BYTES)
+                {
+                    m_m95.array[byte_address] = p_buffer[counter];
+                }
+                else
+                {
+                    b_valid = FALSE;
+                }
+                break;
+
+            case STORAGE_DEVICE_I2C_EEPROM:
+                if (byte_address < X24LC32A_SIZE_BYTES)
+                {
+                    m_x24lc32a.array[byte_address] = p_buffer[counter];
+                }
+                else
+                {
+                    b_valid = FALSE;
+                }
+                break;
+
+            default:
+                b_valid = FALSE;
+                break;
+        }
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_bus_read models a single read of the external flash, which sets
+ * up GPIO[26:20] and then makes one read cycle.
+ *
+ * @param   address     Word address, die 1 starts at MAIN_FLASH_DIE_SIZE_WORDS.
+ * @retval  uint16_t    Data on the bus.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t main_flash_bus_read(uint32_t address)
+{
+    main_flash_address_setup();
+
+    return main_flash_cycle_read(address);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_bus_block_read models a burst read of the external flash, which
+ * only sets up GPIO[26:20] when the block crosses into a new window.
+ *
+ * @param   address         Word address, die 1 starts at MAIN_FLASH_DIE_SIZE_WORDS.
+ * @param   number_of_words Number of read cycles.
+ * @param   p_data          Pointer to buffer to put the data on the bus in.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_bus_block_read(uint32_t address, uint32_t number_of_words,
+                                      uint16_t * const p_data)
+{
+    uint32_t    i;
+
+    for (i = 0u; i < number_of_words; i++)
+    {
+        if ( (i == 0u) || ((address % MAIN_FLASH_WINDOW_SIZE_WORDS) == 0u) )
+        {
+            main_flash_address_setup();
+        }
+
+        p_data[i] = main_flash_cycle_read(address);
+        address++;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_cycle_read models a read cycle on the external flash.  Reads
+ * return the status register straight after a status read command or while
+ * an embedded operation is running, otherwise they return the array.
+ *
+ * @param   address     Word address, die 1 starts at MAIN_FLASH_DIE_SIZE_WORDS.
+ * @retval  uint16_t    Data on the bus.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t main_flash_cycle_read(const uint32_t address)
+{
+    main_flash_die_t*   p_die;
+    uint32_t            offset;
+    uint16_t            data;
+
+    p_die  = &m_die[(address / MAIN_FLASH_DIE_SIZE_WORDS) % MAIN_FLASH_NUMBER_OF_DIES];
+    offset = address % MAIN_FLASH_DIE_SIZE_WORDS;
+
+    m_stats.main_flash_bus_reads++;
+
+    if (main_flash_busy_check(p_die))
+    {
+        // Spinning on a busy device - let time pass.
+        m_stats.main_flash_status_polls++;
+        time_advance(m_timing.main_flash_poll_quantum_ns);
+    }
+    else
+    {
+        time_advance(m_timing.main_flash_access_ns);
+    }
+
+    if (p_die->b_status_read_pending || main_flash_busy_check(p_die))
+    {
+        data = main_flash_status_get(p_die);
+    }
+    else if ( (p_die->op != DIE_OP_NONE) && (!p_die->b_erase_suspended) )
+    {
+        data = main_flash_status_get(p_die);
+    }
+    else if ( (p_die->op != DIE_OP_NONE)
+                && ((offset >> MAIN_FLASH_SECTOR_SHIFT) == p_die->op_sector) )
+    {
+        // The sector whose erase is suspended can't be read.
+        m_stats.main_flash_suspended_sector_reads++;
+        data = main_flash_status_get(p_die);
+    }
+    else
+    {
+        data = main_flash_word_get(p_die, offset);
+    }
+
+    p_die->b_status_read_pending = FALSE;
+
+    return data;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_bus_write models a write cycle on the external flash.
+ *
+ * @param   address     Word address, die 1 starts at MAIN_FLASH_DIE_SIZE_WORDS.
+ * @param   data        Data on the bus.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_bus_write(uint32_t address, const uint16_t data)
+{
+    main_flash_die_t*   p_die;
+    uint32_t            offset;
+
+    p_die  = &m_die[(address / MAIN_FLASH_DIE_SIZE_WORDS) % MAIN_FLASH_NUMBER_OF_DIES];
+    offset = address % MAIN_FLASH_DIE_SIZE_WORDS;
+
+    main_flash_address_setup();
+
+    m_stats.main_flash_bus_writes++;
+    time_advance(m_timing.main_flash_access_ns);
+
+    main_flash_command_decode(p_die, offset, data);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_address_setup models setting up GPIO[26:20] before an access.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_address_setup(void)
+{
+    m_stats.main_flash_address_setups++;
+    time_advance(m_timing.main_flash_address_setup_ns);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_command_decode runs the command state machine for one die.
+ * Only the status read \ clear and reset commands (and suspend \ resume for
+ * a sector erase) are accepted while an embedded operation is running -
+ * anything else is ignored, as on the device.  Once a sector erase has been
+ * suspended the die can also be programmed (but not erased or blank checked).
+ *
+ * @param   p_die       Pointer to die.
+ * @param   offset      Word offset within the die.
+ * @param   data        Data written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_command_decode(main_flash_die_t * const p_die,
+                                      const uint32_t offset,
+                                      const uint16_t data)
+{
+    uint32_t    command_address = offset & MAIN_FLASH_COMMAND_ADDRESS_MASK;
+    uint16_t    command         = data & 0x00FFu;
+
+    if (p_die->op != DIE_OP_NONE)
+    {
+        // Part way through a program sequence while suspended - this is data, not a command.
+        if ( (p_die->b_erase_suspended) && (!main_flash_busy_check(p_die))
+                && (p_die->cmd_state != DIE_CMD_READ_ARRAY) )
+        {
+            main_flash_array_command_decode(p_die, offset, data);
+        }
+        else if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_1) && (command == MAIN_FLASH_CMD_STATUS_READ) )
+        {
+            p_die->b_status_read_pending = TRUE;
+        }
+        else if ( (p_die->op == DIE_OP_SECTOR_ERASE) && (command == MAIN_FLASH_CMD_ERASE_SUSPEND)
+                    && (!p_die->b_erase_suspended) )
+        {
+            main_flash_erase_suspend(p_die);
+        }
+        else if ( (p_die->op == DIE_OP_SECTOR_ERASE) && (command == MAIN_FLASH_CMD_ERASE_RESUME)
+                    && (p_die->b_erase_suspended) )
+        {
+            main_flash_erase_resume(p_die);
+        }
+        else if ( (p_die->b_erase_suspended) && (!main_flash_busy_check(p_die)) )
+        {
+            main_flash_array_command_decode(p_die, offset, data);
+        }
+        else
+        {
+            // Ignored while busy.
+        }
+    }
+    else
+    {
+        main_flash_array_command_decode(p_die, offset, data);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_array_command_decode runs the command state machine for a die
+ * which isn't busy - either idle, or with a sector erase suspended.
+ *
+ * @param   p_die       Pointer to die.
+ * @param   offset      Word offset within the die.
+ * @param   data        Data written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_array_command_decode(main_flash_die_t * const p_die,
+                                            const uint32_t offset,
+                                            const uint16_t data)
+{
+    uint32_t    command_address = offset & MAIN_FLASH_COMMAND_ADDRESS_MASK;
+    uint32_t    sector          = offset >> MAIN_FLASH_SECTOR_SHIFT;
+    uint32_t    counter;
+    uint16_t    command         = data & 0x00FFu;
+
+    switch (p_die->cmd_state)
+    {
+        case DIE_CMD_READ_ARRAY:
+            if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_1) && (command == MAIN_FLASH_CMD_UNLOCK_DATA_1) )
+            {
+                p_die->cmd_state = DIE_CMD_UNLOCK_1;
+            }
+            else if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_1) && (command == MAIN_FLASH_CMD_STATUS_READ) )
+            {
+                p_die->b_status_read_pending = TRUE;
+            }
+            else if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_1) && (command == MAIN_FLASH_CMD_STATUS_CLEAR) )
+            {
+                p_die->status_errors &= (uint16_t)~MAIN_FLASH_STATUS_ERROR_BITS;
+            }
+            else if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_1) && (command == MAIN_FLASH_CMD_BLANK_CHECK)
+                        && (!p_die->b_erase_suspended) )
+            {
+                m_stats.main_flash_blank_checks++;
+                main_flash_operation_start(p_die, DIE_OP_BLANK_CHECK, sector,
+                                           (uint64_t)m_timing.main_flash_blank_check_us * 1000u);
+            }
+            else
+            {
+                // Reset and anything unrecognised leave us in read array mode.
+                p_die->b_status_read_pending = FALSE;
+            }
+            break;
+
+        case DIE_CMD_UNLOCK_1:
+            if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_2) && (command == MAIN_FLASH_CMD_UNLOCK_DATA_2) )
+            {
+                p_die->cmd_state = DIE_CMD_UNLOCK_2;
+            }
+            else
+            {
+                p_die->cmd_state = DIE_CMD_READ_ARRAY;
+            }
+            break;
+
+        case DIE_CMD_UNLOCK_2:
+            p_die->cmd_state = DIE_CMD_READ_ARRAY;
+
+            if (command == MAIN_FLASH_CMD_PROGRAM)
+            {
+                p_die->cmd_state = DIE_CMD_PROGRAM_WORD;
+            }
+            else if (command == MAIN_FLASH_CMD_BUFFER_LOAD)
+            {
+                p_die->buffer_sector = sector;
+                p_die->cmd_state     = DIE_CMD_BUFFER_COUNT;
+            }
+            else if ( (command == MAIN_FLASH_CMD_ERASE_SETUP) && (!p_die->b_erase_suspended) )
+            {
+                p_die->cmd_state = DIE_CMD_ERASE_SETUP;
+            }
+            else
+            {
+                // Write buffer abort reset, or unsupported command.
+                p_die->status_errors &= (uint16_t)~MAIN_FLASH_STATUS_BUFFER_ABORT;
+            }
+            break;
+
+        case DIE_CMD_PROGRAM_WORD:
+            p_die->cmd_state = DIE_CMD_READ_ARRAY;
+            m_stats.main_flash_program_operations++;
+            main_flash_word_program(p_die, offset, data);
+            main_flash_program_start(p_die, sector,
+                                     (uint64_t)m_timing.main_flash_word_program_us * 1000u);
+            break;
+
+        case DIE_CMD_BUFFER_COUNT:
+            p_die->buffer_count  = (data & 0x00FFu) + 1u;
+            p_die->buffer_loaded = 0u;
+            p_die->cmd_state     = DIE_CMD_BUFFER_LOAD;
+            break;
+
+        case DIE_CMD_BUFFER_LOAD:
+            // Every load must be in the same write buffer page of the
+            // sector given with the load command, otherwise the device aborts.
+            if ( (sector != p_die->buffer_sector)
+                    || ( (p_die->buffer_loaded != 0u)
+                         && ( (offset & MAIN_FLASH_BUFFER_LINE_MASK)
+                              != (p_die->buffer_offset[0] & MAIN_FLASH_BUFFER_LINE_MASK) ) ) )
+            {
+                p_die->status_errors |= MAIN_FLASH_STATUS_BUFFER_ABORT;
+                p_die->cmd_state      = DIE_CMD_READ_ARRAY;
+            }
+            else
+            {
+                p_die->buffer_offset[p_die->buffer_loaded] = offset;
+                p_die->buffer_data[p_die->buffer_loaded]   = data;
+                p_die->buffer_loaded++;
+
+                if (p_die->buffer_loaded >= p_die->buffer_count)
+                {
+                    p_die->cmd_state = DIE_CMD_BUFFER_CONFIRM;
+                }
+            }
+            break;
+
+        case DIE_CMD_BUFFER_CONFIRM:
+            p_die->cmd_state = DIE_CMD_READ_ARRAY;
+
+            if ( (command == MAIN_FLASH_CMD_BUFFER_CONFIRM) && (sector == p_die->buffer_sector) )
+            {
+                m_stats.main_flash_program_operations++;
+
+                for (counter = 0u; counter < p_die->buffer_loaded; counter++)
+                {
+                    main_flash_word_program(p_die, p_die->buffer_offset[counter],
+                                            p_die->buffer_data[counter]);
+                }
+
+                main_flash_program_start(p_die, sector,
+                                         (uint64_t)m_timing.main_flash_buffer_program_us * 1000u);
+            }
+            else
+            {
+                p_die->status_errors |= MAIN_FLASH_STATUS_BUFFER_ABORT;
+            }
+            break;
+
+        case DIE_CMD_ERASE_SETUP:
+            if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_1) && (command == MAIN_FLASH_CMD_UNLOCK_DATA_1) )
+            {
+                p_die->cmd_state = DIE_CMD_ERASE_UNLOCK_1;
+            }
+            else
+            {
+                p_die->cmd_state = DIE_CMD_READ_ARRAY;
+            }
+            break;
+
+        case DIE_CMD_ERASE_UNLOCK_1:
+            if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_2) && (command == MAIN_FLASH_CMD_UNLOCK_DATA_2) )
+            {
+                p_die->cmd_state = DIE_CMD_ERASE_UNLOCK_2;
+            }
+            else
+            {
+                p_die->cmd_state = DIE_CMD_READ_ARRAY;
+            }
+            break;
+
+        case DIE_CMD_ERASE_UNLOCK_2:
+            p_die->cmd_state = DIE_CMD_READ_ARRAY;
+
+            if (command == MAIN_FLASH_CMD_SECTOR_ERASE)
+            {
+                main_flash_operation_start(p_die, DIE_OP_SECTOR_ERASE, sector,
+                                           (uint64_t)m_timing.main_flash_sector_erase_us * 1000u);
+            }
+            else if ( (command_address == MAIN_FLASH_UNLOCK_ADDRESS_1) && (command == MAIN_FLASH_CMD_CHIP_ERASE) )
+            {
+                main_flash_operation_start(p_die, DIE_OP_CHIP_ERASE, 0u,
+                                           (uint64_t)m_timing.main_flash_sector_erase_us
+                                                * 1000u * MAIN_FLASH_SECTORS_PER_DIE);
+            }
+            else
+            {
+                // Unsupported erase command - ignore.
+            }
+            break;
+
+        default:
+            p_die->cmd_state = DIE_CMD_READ_ARRAY;
+            break;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_operation_start marks a die as busy with an embedded operation.
+ * Programming has already been applied to the array by the caller - erases
+ * take effect when the operation completes.
+ *
+ * @param   p_die       Pointer to die.
+ * @param   operation   Operation which is starting.
+ * @param   sector      Sector the operation applies to.
+ * @param   duration_ns Time the operation takes.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_operation_start(main_flash_die_t * const p_die,
+                                       const die_op_t operation,
+                                       const uint32_t sector,
+                                       const uint64_t duration_ns)
+{
+    uint32_t    offset;
+
+    p_die->op            = operation;
+    p_die->op_sector     = sector;
+    p_die->busy_until_ns = m_time_ns + duration_ns;
+    p_die->run_start_ns  = m_time_ns;
+    p_die->b_erase_suspended = FALSE;
+    p_die->suspend_program_until_ns = 0u;
+    p_die->status_errors &= (uint16_t)~MAIN_FLASH_STATUS_ERASE_ERROR;
+
+    if (operation == DIE_OP_BLANK_CHECK)
+    {
+        // The array can't change while the check runs, so do it now.
+        if (p_die->p_sector[sector] != NULL)
+        {
+            for (offset = 0u; offset < MAIN_FLASH_SECTOR_SIZE_WORDS; offset++)
+            {
+                if (p_die->p_sector[sector][offset] != MAIN_FLASH_ERASED_WORD)
+                {
+                    p_die->status_errors |= MAIN_FLASH_STATUS_ERASE_ERROR;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_program_start marks a die as busy programming.  If a sector
+ * erase is suspended the program runs without disturbing it, and the die
+ * shows erase suspended again once the program has finished.
+ *
+ * @param   p_die       Pointer to die.
+ * @param   sector      Sector being programmed.
+ * @param   duration_ns Time the program takes.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_program_start(main_flash_die_t * const p_die,
+                                     const uint32_t sector,
+                                     const uint64_t duration_ns)
+{
+    if (p_die->b_erase_suspended)
+    {
+        m_stats.main_flash_suspended_programs++;
+        p_die->suspend_program_until_ns = m_time_ns + duration_ns;
+    }
+    else
+    {
+        main_flash_operation_start(p_die, DIE_OP_PROGRAM, sector, duration_ns);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_operation_complete finishes the embedded operation on a die.
+ *
+ * @param   p_die       Pointer to die.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_operation_complete(main_flash_die_t * const p_die)
+{
+    uint32_t    sector;
+
+    if (p_die->op == DIE_OP_SECTOR_ERASE)
+    {
+        main_flash_sector_erase(p_die, p_die->op_sector);
+    }
+    else if (p_die->op == DIE_OP_CHIP_ERASE)
+    {
+        for (sector = 0u; sector < MAIN_FLASH_SECTORS_PER_DIE; sector++)
+        {
+            main_flash_sector_erase(p_die, sector);
+        }
+    }
+    else
+    {
+        // Nothing more to do for program and blank check.
+    }
+
+    p_die->op = DIE_OP_NONE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_erase_suspend suspends the sector erase on a die, which takes
+ * effect after the suspend latency.  If the erase has run for less than the
+ * minimum time since it started or resumed, it has made no progress.  If it
+ * will have finished by the time the suspend takes effect, the suspend is
+ * ignored and the erase completes as normal.
+ *
+ * @param   p_die       Pointer to die.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_erase_suspend(main_flash_die_t * const p_die)
+{
+    uint64_t    suspended_at_ns;
+
+    suspended_at_ns = m_time_ns + ((uint64_t)m_timing.main_flash_erase_suspend_us * 1000u);
+
+    if ((m_time_ns - p_die->run_start_ns)
+            < ((uint64_t)m_timing.main_flash_resume_to_suspend_us * 1000u))
+    {
+        m_stats.main_flash_early_suspends++;
+        m_stats.main_flash_erase_suspends++;
+
+        p_die->erase_remaining_ns = p_die->busy_until_ns - p_die->run_start_ns;
+        p_die->suspended_at_ns    = suspended_at_ns;
+        p_die->b_erase_suspended  = TRUE;
+    }
+    else if (suspended_at_ns < p_die->busy_until_ns)
+    {
+        m_stats.main_flash_erase_suspends++;
+
+        p_die->erase_remaining_ns = p_die->busy_until_ns - suspended_at_ns;
+        p_die->suspended_at_ns    = suspended_at_ns;
+        p_die->b_erase_suspended  = TRUE;
+    }
+    else
+    {
+        // Too late - the erase finishes first.
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_erase_resume carries on with a suspended sector erase.
+ *
+ * @param   p_die       Pointer to die.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_erase_resume(main_flash_die_t * const p_die)
+{
+    uint64_t    resume_ns = m_time_ns;
+
+    // A resume before the suspend (or a program made while suspended) has
+    // taken effect waits for it.
+    if (resume_ns < p_die->suspended_at_ns)
+    {
+        resume_ns = p_die->suspended_at_ns;
+    }
+
+    if (resume_ns < p_die->suspend_program_until_ns)
+    {
+        resume_ns = p_die->suspend_program_until_ns;
+    }
+
+    m_stats.main_flash_erase_resumes++;
+
+    p_die->b_erase_suspended = FALSE;
+    p_die->run_start_ns      = resume_ns;
+    p_die->busy_until_ns     = resume_ns + p_die->erase_remaining_ns;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_busy_check says whether a die is busy - running an embedded
+ * operation, on its way to suspending one, or programming while suspended.
+ *
+ * @param   p_die       Pointer to die.
+ * @retval  bool_t      TRUE if the die is busy.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t main_flash_busy_check(const main_flash_die_t * const p_die)
+{
+    bool_t  b_busy = FALSE;
+
+    if (p_die->op != DIE_OP_NONE)
+    {
+        if (p_die->b_erase_suspended)
+        {
+            b_busy = ( (m_time_ns < p_die->suspended_at_ns)
+                        || (m_time_ns < p_die->suspend_program_until_ns) );
+        }
+        else
+        {
+            b_busy = (m_time_ns < p_die->busy_until_ns);
+        }
+    }
+
+    return b_busy;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_status_get generates the status register for a die.
+ *
+ * @param   p_die       Pointer to die.
+ * @retval  uint16_t    Status register value.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t main_flash_status_get(const main_flash_die_t * const p_die)
+{
+    uint16_t    status = p_die->status_errors;
+
+    if (p_die->op == DIE_OP_NONE)
+    {
+        status |= MAIN_FLASH_STATUS_READY;
+    }
+    else if ( (p_die->b_erase_suspended) && (m_time_ns >= p_die->suspended_at_ns)
+                && (m_time_ns >= p_die->suspend_program_until_ns) )
+    {
+        status |= MAIN_FLASH_STATUS_READY | MAIN_FLASH_STATUS_ERASE_SUSPEND;
+    }
+    else
+    {
+        // Busy.
+    }
+
+    return status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_word_get returns the array contents of one word.
+ *
+ * @param   p_die       Pointer to die.
+ * @param   offset      Word offset within the die.
+ * @retval  uint16_t    Word contents.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t main_flash_word_get(const main_flash_die_t * const p_die,
+                                    const uint32_t offset)
+{
+    const uint16_t* p_sector = p_die->p_sector[offset >> MAIN_FLASH_SECTOR_SHIFT];
+    uint16_t        word     = MAIN_FLASH_ERASED_WORD;
+
+    if (p_sector != NULL)
+    {
+        word = p_sector[offset & (MAIN_FLASH_SECTOR_SIZE_WORDS - 1u)];
+    }
+
+    return word;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_word_program programs one word - bits can only go from 1 to 0.
+ *
+ * @param   p_die       Pointer to die.
+ * @param   offset      Word offset within the die.
+ * @param   data        Data to program.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_word_program(main_flash_die_t * const p_die,
+                                    const uint32_t offset,
+                                    const uint16_t data)
+{
+    uint16_t    old_word = main_flash_word_get(p_die, offset);
+
+    m_stats.main_flash_words_programmed++;
+
+    if ((data & (uint16_t)~old_word) != 0u)
+    {
+        m_stats.main_flash_bit_raise_attempts++;
+
+        if (mb_strict_programming)
+        {
+            p_die->status_errors |= MAIN_FLASH_STATUS_PROGRAM_ERROR;
+        }
+    }
+
+    main_flash_word_force(p_die, offset, old_word & data);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_word_force sets the contents of one word, allocating the sector
+ * storage if this is the first non-erased word in the sector.
+ *
+ * @param   p_die       Pointer to die.
+ * @param   offset      Word offset within the die.
+ * @param   data        New contents.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_word_force(main_flash_die_t * const p_die,
+                                  const uint32_t offset,
+                                  const uint16_t data)
+{
+    uint32_t    sector = offset >> MAIN_FLASH_SECTOR_SHIFT;
+
+    if ( (p_die->p_sector[sector] == NULL) && (data != MAIN_FLASH_ERASED_WORD) )
+    {
+        p_die->p_sector[sector] = malloc(MAIN_FLASH_SECTOR_SIZE_WORDS * sizeof(uint16_t));
+        (void)memset(p_die->p_sector[sector], 0xFF, MAIN_FLASH_SECTOR_SIZE_WORDS * sizeof(uint16_t));
+    }
+
+    if (p_die->p_sector[sector] != NULL)
+    {
+        p_die->p_sector[sector][offset & (MAIN_FLASH_SECTOR_SIZE_WORDS - 1u)] = data;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * main_flash_sector_erase returns a sector to the erased state.
+ *
+ * @param   p_die       Pointer to die.
+ * @param   sector      Sector to erase.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void main_flash_sector_erase(main_flash_die_t * const p_die,
+                                    const uint32_t sector)
+{
+    m_stats.main_flash_sector_erases++;
+
+    free(p_die->p_sector[sector]);
+    p_die->p_sector[sector] = NULL;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * spi_register_read models reads from the SPI-A register window.  Accesses
+ * outside the window are passed on to the saved genericIO function.
+ *
+ * Each access takes the register access time.  A poll of SPISTS (or of
+ * SPIFFRX with the RX FIFO empty) waits for the shifter, as the polling loop
+ * would, and with the FIFOs enabled SPIRXBUF reads the oldest FIFO word.
+ *
+ * @param   address     32 bit address to read data from.
+ * @retval  uint16_t    Register contents.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t spi_register_read(const uint32_t address)
+{
+    uint16_t    data;
+    uint16_t    words;
+    uint32_t    offset = address - SPI_A_BASE_ADDRESS;
+
+    if ( (address < SPI_A_BASE_ADDRESS) || (offset >= SPI_A_REGISTER_COUNT) )
+    {
+        data = m_saved_io_16bit_read(address);
+    }
+    else
+    {
+        time_advance(m_timing.spi_register_access_ns);
+
+        if (offset == SPISTS_OFFSET)
+        {
+            // Wait for the current character to finish shifting.
+            if (m_time_ns < m_m95.shift_end_ns)
+            {
+                time_advance(m_m95.shift_end_ns - m_time_ns);
+            }
+
+            data = SPISTS_SPIINT_BIT_MASK;
+        }
+        else if (offset == SPIFFRX_OFFSET)
+        {
+            words = spi_rx_fifo_ready_count();
+
+            // Nothing yet - the polling loop waits for the next word.
+            if ( (words == 0u) && (m_m95.rx_count != 0u) )
+            {
+                time_advance(m_m95.rx_ready_ns[m_m95.rx_head] - m_time_ns);
+                words = spi_rx_fifo_ready_count();
+            }
+
+            data = (m_m95.registers[offset] & (uint16_t)~(SPIFFRX_RXFFST_BIT_MASK | SPIFFRX_RXFFOVF_BIT_MASK))
+                    | (uint16_t)(words << SPI_FIFO_STATUS_SHIFT);
+
+            if (m_m95.b_rx_overflow)
+            {
+                data |= SPIFFRX_RXFFOVF_BIT_MASK;
+            }
+        }
+        else if (offset == SPIFFTX_OFFSET)
+        {
+            data = (m_m95.registers[offset] & (uint16_t)~SPIFFTX_TXFFST_BIT_MASK)
+                    | (uint16_t)(spi_tx_fifo_waiting_count() << SPI_FIFO_STATUS_SHIFT);
+        }
+        else if ( (offset == SPIRXBUF_OFFSET)
+                    && ((m_m95.registers[SPIFFTX_OFFSET] & SPIFFTX_SPIFFENA_BIT_MASK) != 0u) )
+        {
+            data = m_m95.rx_data;
+
+            if (m_m95.rx_count != 0u)
+            {
+                if (m_time_ns < m_m95.rx_ready_ns[m_m95.rx_head])
+                {
+                    time_advance(m_m95.rx_ready_ns[m_m95.rx_head] - m_time_ns);
+                }
+
+                data = m_m95.rx_fifo[m_m95.rx_head];
+                m_m95.rx_head = (m_m95.rx_head + 1u) % SPI_FIFO_DEPTH;
+                m_m95.rx_count--;
+            }
+        }
+        else if (offset == SPIRXBUF_OFFSET)
+        {
+            data = m_m95.rx_data;
+        }
+        else
+        {
+            data = m_m95.registers[offset];
+        }
+    }
+
+    return data;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * spi_register_write models writes to the SPI-A register window.  A write
+ * to SPITXBUF clocks a character out to the M95 and a character back in,
+ * once the shifter has finished any characters before it - so with the FIFOs
+ * enabled the characters go out back to back, and the character received
+ * goes into the RX FIFO.  Accesses outside the window are passed on to the
+ * saved genericIO function.
+ *
+ * @param   address     32 bit address to write data into.
+ * @param   data        16 bit data to write into 'address'.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void spi_register_write(const uint32_t address, const uint16_t data)
+{
+    uint32_t    offset = address - SPI_A_BASE_ADDRESS;
+    uint16_t    number_of_bits;
+    uint8_t     rx_byte;
+
+    if ( (address < SPI_A_BASE_ADDRESS) || (offset >= SPI_A_REGISTER_COUNT) )
+    {
+        m_saved_io_16bit_write(address, data);
+    }
+    else
+    {
+        time_advance(m_timing.spi_register_access_ns);
+
+        if (offset == SPITXBUF_OFFSET)
+        {
+            number_of_bits = (m_m95.registers[SPICCR_OFFSET] & SPICCR_CHAR_BITS_MASK) + 1u;
+
+            if (m_m95.shift_end_ns < m_time_ns)
+            {
+                m_m95.shift_end_ns = m_time_ns;
+            }
+
+            m_m95.shift_end_ns += (uint64_t)number_of_bits * m_timing.spi_bit_ns;
+
+            m95_chip_select_update();
+
+            // Transmit data is left justified - the device only sees the top bits.
+            //lint -e{921} Cast from uint16_t to uint8_t.
+            rx_byte = m95_byte_transfer((uint8_t)((data >> (16u - number_of_bits)) & 0x00FFu));
+
+            if ((m_m95.registers[SPIFFTX_OFFSET] & SPIFFTX_SPIFFENA_BIT_MASK) == 0u)
+            {
+                m_m95.rx_data = rx_byte;
+            }
+            else if (m_m95.rx_count >= SPI_FIFO_DEPTH)
+            {
+                m_m95.b_rx_overflow = TRUE;
+            }
+            else
+            {
+                m_m95.rx_fifo[(m_m95.rx_head + m_m95.rx_count) % SPI_FIFO_DEPTH]     = rx_byte;
+                m_m95.rx_ready_ns[(m_m95.rx_head + m_m95.rx_count) % SPI_FIFO_DEPTH] = m_m95.shift_end_ns;
+                m_m95.rx_count++;
+            }
+        }
+        else
+        {
+            if (offset == SPIFFRX_OFFSET)
+            {
+                if ((data & SPIFFRX_RXFIFORESET_BIT_MASK) == 0u)
+                {
+                    m_m95.rx_head  = 0u;
+                    m_m95.rx_count = 0u;
+                }
+
+                if ((data & SPIFFRX_RXFFOVFCLR_BIT_MASK) != 0u)
+                {
+                    m_m95.b_rx_overflow = FALSE;
+                }
+            }
+
+            m_m95.registers[offset] = data;
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * spi_rx_fifo_ready_count counts the words in the SPI RX FIFO which have
+ * finished shifting in (RXFFST).
+ *
+ * @retval  uint16_t    Number of words which can be read.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t spi_rx_fifo_ready_count(void)
+{
+    uint16_t    count = 0u;
+
+    while ( (count < m_m95.rx_count)
+            && (m_m95.rx_ready_ns[(m_m95.rx_head + count) % SPI_FIFO_DEPTH] <= m_time_ns) )
+    {
+        count++;
+    }
+
+    return count;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * spi_tx_fifo_waiting_count counts the words in the SPI TX FIFO which have
+ * not started shifting out yet (TXFFST).
+ *
+ * @retval  uint16_t    Number of words waiting.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t spi_tx_fifo_waiting_count(void)
+{
+    const uint64_t  character_ns = (uint64_t)((m_m95.registers[SPICCR_OFFSET] & SPICCR_CHAR_BITS_MASK) + 1u)
+                                    * m_timing.spi_bit_ns;
+    uint16_t        count = 0u;
+    uint16_t        word;
+
+    for (word = 0u; word < m_m95.rx_count; word++)
+    {
+        if ((m_m95.rx_ready_ns[(m_m95.rx_head + word) % SPI_FIFO_DEPTH] - character_ns) > m_time_ns)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * m95_chip_select_update picks up any chip select edges which spi.c has
+ * generated since the last transfer.  spi.c drives the select through the
+ * GPIO57 SET \ CLEAR registers, which are plain memory on the host, so the
+ * model consumes (clears) the bits once it has seen them.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void m95_chip_select_update(void)
+{
+    if (GpioDataRegs.GPBSET.bit.GPIO57 == 1u)
+    {
+        GpioDataRegs.GPBSET.bit.GPIO57 = 0u;
+        m95_frame_end();
+    }
+
+    if (GpioDataRegs.GPBCLEAR.bit.GPIO57 == 1u)
+    {
+        GpioDataRegs.GPBCLEAR.bit.GPIO57 = 0u;
+        m95_frame_end();
+        m_m95.b_selected    = TRUE;
+        m_m95.byte_in_frame = 0u;
+        m_m95.write_count   = 0u;
+        (void)memset(m_m95.page_latched, 0, sizeof(m_m95.page_latched));
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * m95_frame_end handles the chip select going inactive - a write frame with
+ * the write enable latch set transfers the latched bytes into the array and
+ * starts the write cycle.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void m95_frame_end(void)
+{
+    uint32_t    page_base;
+    uint32_t    counter;
+    uint8_t*    p_memory;
+    uint32_t    memory_size;
+
+    if (m_m95.b_selected)
+    {
+        if ( ( (m_m95.command == M95_CMD_WRITE) || (m_m95.command == M95_CMD_WRITE_ID_PAGE) )
+                && (m_m95.write_count != 0u)
+                && ((m_m95.status & M95_STATUS_WEL) != 0u) )
+        {
+            if (m_m95.command == M95_CMD_WRITE)
+            {
+                p_memory    = m_m95.array;
+                memory_size = M95_SIZE_BYTES;
+            }
+            else
+            {
+                p_memory    = m_m95.id_page;
+                memory_size = M95_PAGE_SIZE_BYTES;
+            }
+
+            page_base = (m_m95.address % memory_size) & ~(M95_PAGE_SIZE_BYTES - 1u);
+
+            for (counter = 0u; counter < M95_PAGE_SIZE_BYTES; counter++)
+            {
+                if (m_m95.page_latched[counter])
+                {
+                    p_memory[page_base + counter] = m_m95.page_buffer[counter];
+                    m_stats.m95_bytes_written++;
+                }
+            }
+
+            m_stats.m95_write_cycles++;
+            m_m95.status       |= M95_STATUS_WIP;
+            m_m95.status       &= (uint8_t)~M95_STATUS_WEL;
+            m_m95.busy_until_ns = m_time_ns + ((uint64_t)m_timing.m95_page_write_us * 1000u);
+        }
+        else if ( (m_m95.command == M95_CMD_WRITE_STATUS)
+                    && (m_m95.byte_in_frame >= 2u)
+                    && ((m_m95.status & M95_STATUS_WEL) != 0u) )
+        {
+            m_stats.m95_write_cycles++;
+            m_m95.status       |= M95_STATUS_WIP;
+            m_m95.status       &= (uint8_t)~M95_STATUS_WEL;
+            m_m95.busy_until_ns = m_time_ns + ((uint64_t)m_timing.m95_page_write_us * 1000u);
+        }
+        else
+        {
+            // Nothing to commit for any other frame.
+        }
+    }
+
+    m_m95.b_selected = FALSE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * m95_byte_transfer clocks one byte through the M95 instruction decoder.
+ *
+ * @param   tx_byte     Byte sent to the device.
+ * @retval  uint8_t     Byte returned by the device.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint8_t m95_byte_transfer(const uint8_t tx_byte)
+{
+    uint8_t     rx_byte = 0xFFu;
+    uint32_t    address_bytes = m95_address_bytes_get();
+    uint32_t    data_index;
+    uint32_t    page_offset;
+
+    if ( ((m_m95.status & M95_STATUS_WIP) != 0u) && (m_time_ns >= m_m95.busy_until_ns) )
+    {
+        m_m95.status &= (uint8_t)~M95_STATUS_WIP;
+    }
+
+    if (m_m95.b_selected)
+    {
+        if (m_m95.byte_in_frame == 0u)
+        {
+            m_m95.command = tx_byte;
+            m_m95.address = 0u;
+
+            // Only the status register can be read during a write cycle.
+            if ( ((m_m95.status & M95_STATUS_WIP) != 0u) && (tx_byte != M95_CMD_READ_STATUS) )
+            {
+                m_m95.command = 0u;
+            }
+            else if (tx_byte == M95_CMD_WRITE_ENABLE)
+            {
+                m_m95.status |= M95_STATUS_WEL;
+            }
+            else if (tx_byte == M95_CMD_WRITE_DISABLE)
+            {
+                m_m95.status &= (uint8_t)~M95_STATUS_WEL;
+            }
+            else
+            {
+                // Remaining instructions use the following bytes.
+            }
+        }
+        else if (m_m95.command == M95_CMD_READ_STATUS)
+        {
+            rx_byte = m_m95.status;
+        }
+        else if (m_m95.command == M95_CMD_WRITE_STATUS)
+        {
+            if ( (m_m95.byte_in_frame == 1u) && ((m_m95.status & M95_STATUS_WEL) != 0u) )
+            {
+                m_m95.status = (m_m95.status & (uint8_t)~M95_STATUS_WRITABLE_BITS)
+                                | (tx_byte & M95_STATUS_WRITABLE_BITS);
+            }
+        }
+        else if ( (m_m95.command == M95_CMD_READ) || (m_m95.command == M95_CMD_WRITE)
+                    || (m_m95.command == M95_CMD_READ_ID_PAGE) || (m_m95.command == M95_CMD_WRITE_ID_PAGE) )
+        {
+            if (m_m95.byte_in_frame <= address_bytes)
+            {
+                m_m95.address = (m_m95.address << 8u) | tx_byte;
+            }
+            else
+            {
+                data_index = m_m95.byte_in_frame - address_bytes - 1u;
+
+                if (m_m95.command == M95_CMD_READ)
+                {
+                    rx_byte = m_m95.array[(m_m95.address + data_index) % M95_SIZE_BYTES];
+                    m_stats.m95_bytes_read++;
+                }
+                else if (m_m95.command == M95_CMD_READ_ID_PAGE)
+                {
+                    rx_byte = m_m95.id_page[(m_m95.address + data_index) % M95_ID_PAGE_SIZE_BYTES];
+                }
+                else
+                {
+                    // Writes wrap around within the page.
+                    page_offset = (m_m95.address + data_index) & (M95_PAGE_SIZE_BYTES - 1u);
+                    m_m95.page_buffer[page_offset]  = tx_byte;
+                    m_m95.page_latched[page_offset] = TRUE;
+                    m_m95.write_count++;
+                }
+            }
+        }
+        else
+        {
+            // Ignored instruction - the device leaves its output floating.
+        }
+
+        m_m95.byte_in_frame++;
+    }
+
+    return rx_byte;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * m95_address_bytes_get returns the number of address bytes, following the
+ * same rule as SendAddressToDevice in m95.c.
+ *
+ * @retval  uint32_t    Number of address bytes sent after the instruction.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t m95_address_bytes_get(void)
+{
+    return (M95_SIZE_BYTES > 65536u) ? 3u : 2u;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * x24lc32a_read models a random \ sequential read from the 24LC32A.
+ * The device doesn't acknowledge while a write cycle is running.
+ *
+ * @param   SlaveAddress    7 bit slave address.
+ * @param   DeviceAddress   Address within the device.
+ * @param   DataCount       Number of bytes to read.
+ * @param   pData           Pointer to buffer to put data in.
+ * @retval  EI2CStatus_t    I2C bus status.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EI2CStatus_t x24lc32a_read(const uint16_t SlaveAddress,
+                                  const uint16_t DeviceAddress,
+                                  uint16_t DataCount,
+                                  uint8_t * const pData)
+{
+    EI2CStatus_t    status = I2C_NO_ACK_RECEIVED_FROM_SLAVE;
+    uint16_t        counter;
+
+    time_advance((uint64_t)I2C_ACK_POLL_BITS * m_timing.i2c_bit_ns);
+
+    if ( (SlaveAddress == X24LC32A_SLAVE_ADDRESS) && (m_time_ns >= m_x24lc32a.busy_until_ns) )
+    {
+        time_advance( (uint64_t)(I2C_ADDRESS_PHASE_BITS - I2C_ACK_POLL_BITS + I2C_READ_RESTART_BITS
+                                 + (9u * (uint32_t)DataCount)) * m_timing.i2c_bit_ns);
+
+        for (counter = 0u; counter < DataCount; counter++)
+        {
+            pData[counter] = m_x24lc32a.array[((uint32_t)DeviceAddress + counter) % X24LC32A_SIZE_BYTES];
+        }
+
+        m_stats.x24lc32a_bytes_read += DataCount;
+        status = I2C_COMPLETED_OK;
+    }
+
+    return status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * x24lc32a_write models a page write to the 24LC32A - bytes beyond the end
+ * of the page wrap around to the start of the same page.
+ *
+ * @param   SlaveAddress    7 bit slave address.
+ * @param   DeviceAddress   Address within the device.
+ * @param   DataCount       Number of bytes to write.
+ * @param   pData           Pointer to buffer containing the data.
+ * @retval  EI2CStatus_t    I2C bus status.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EI2CStatus_t x24lc32a_write(const uint16_t SlaveAddress,
+                                   const uint16_t DeviceAddress,
+                                   uint16_t DataCount,
+                                   const uint8_t * const pData)
+{
+    EI2CStatus_t    status = I2C_NO_ACK_RECEIVED_FROM_SLAVE;
+    uint32_t        page_base;
+    uint16_t        counter;
+
+    time_advance((uint64_t)I2C_ACK_POLL_BITS * m_timing.i2c_bit_ns);
+
+    if ( (SlaveAddress == X24LC32A_SLAVE_ADDRESS) && (m_time_ns >= m_x24lc32a.busy_until_ns) )
+    {
+        time_advance( (uint64_t)(I2C_ADDRESS_PHASE_BITS - I2C_ACK_POLL_BITS
+                                 + (9u * (uint32_t)DataCount)) * m_timing.i2c_bit_ns);
+
+        page_base = ((uint32_t)DeviceAddress % X24LC32A_SIZE_BYTES) & ~(X24LC32A_PAGE_SIZE_BYTES - 1u);
+
+        for (counter = 0u; counter < DataCount; counter++)
+        {
+            m_x24lc32a.array[page_base + (((uint32_t)DeviceAddress + counter) & (X24LC32A_PAGE_SIZE_BYTES - 1u))]
+                = pData[counter];
+        }
+
+        m_stats.x24lc32a_bytes_written += DataCount;
+        m_stats.x24lc32a_write_cycles++;
+        m_x24lc32a.busy_until_ns = m_time_ns + ((uint64_t)m_timing.x24lc32a_page_write_us * 1000u);
+        status = I2C_COMPLETED_OK;
+    }
+
+    return status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * x24lc32a_ack_poll models acknowledgement polling - the slave address is
+ * sent repeatedly until the device acknowledges at the end of its write cycle.
+ *
+ * @param   SlaveAddress    7 bit slave address.
+ * @param   MaxTimeout      Maximum number of polls, zero for no limit.
+ * @retval  EI2CStatus_t    I2C bus status.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EI2CStatus_t x24lc32a_ack_poll(uint16_t SlaveAddress, uint16_t MaxTimeout)
+{
+    EI2CStatus_t    status = I2C_ACKPOLL_TIMEOUT_EXCEEDED;
+    uint32_t        polls = 0u;
+
+    if (SlaveAddress == X24LC32A_SLAVE_ADDRESS)
+    {
+        while ( (MaxTimeout == 0u) || (polls < MaxTimeout) )
+        {
+            time_advance((uint64_t)I2C_ACK_POLL_BITS * m_timing.i2c_bit_ns);
+            polls++;
+
+            if (m_time_ns >= m_x24lc32a.busy_until_ns)
+            {
+                status = I2C_COMPLETED_OK;
+                break;
+            }
+        }
+    }
+
+    return status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * time_advance moves the simulated clock on, completing any main flash
+ * operations which finish in the meantime.
+ *
+ * @param   nanoseconds     Time to add to the simulated clock.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void time_advance(const uint64_t nanoseconds)
+{
+    uint32_t    die;
+
+    m_time_ns += nanoseconds;
+
+    for (die = 0u; die < MAIN_FLASH_NUMBER_OF_DIES; die++)
+    {
+        if ( (m_die[die].op != DIE_OP_NONE) && (!m_die[die].b_erase_suspended)
+                && (m_time_ns >= m_die[die].busy_until_ns) )
+        {
+            main_flash_operation_complete(&m_die[die]);
+        }
+    }
+}
+
+#endif /* UNIT_TEST_BUILD */
@@ -0,0 +1,391 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        format_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side check of the time sliced partition format.
+ * @details
+ * Formats one partition of the simulated flash (flash_sim.c) a step at a time,
+ * using rspartition_format_start() and rspartition_format_step(), and between
+ * each step:
+ *
+ *  - Writes records into another partition, and reads the last one back with
+ *    a backwards search, as a read request would.
+ *  - Tries to write a record straight into the partition being formatted,
+ *    which must be refused.
+ *  - Checks that the progress never goes back.
+ *
+ * The simulated time of each step is measured, as this is how long the
+ * recording system (or opcode 13) is held up by the format.  At the end the
+ * formatted partition must be empty (just the first page header written) and
+ * have no errors.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs and resets the
+ * simulated devices and initialises the recording system, so the serial flash
+ * and SPI must have been set up (M95_DeviceSizeInitialise(), SPI_Open())
+ * before it is run.  The other partition is formatted before the traffic
+ * starts, the old way.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rspartition.h"
+#include "rspages.h"
+#include "rssearch.h"
+#include "flash_sim.h"
+#include "format_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define DEFAULT_CONFIG      { 6u, 4u, 4u, 64u }
+
+#define FIRST_RECORD_ID     0x0100u     ///< Record ID of the first traffic record.
+#define REFUSED_RECORD_ID   0x0055u     ///< Record ID of the writes which must be refused.
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   traffic_record_write(const format_sim_config_t * const p_config,
+                                     const uint16_t record_id);
+
+static bool_t   traffic_record_check(const format_sim_config_t * const p_config,
+                                     const uint16_t record_id);
+
+static bool_t   formatting_write_refused(const format_sim_config_t * const p_config);
+
+static void     tdr_fill(uint8_t * const p_tdr,
+                         const uint16_t tdr_bytes,
+                         const uint16_t record_id);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t  m_write_buffer[FORMAT_SIM_MAX_TDR_BYTES + RSAPI_BYTES_BEFORE_TDR
+                                    + RSAPI_BYTES_AFTER_TDR];
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t  m_expected_tdr[FORMAT_SIM_MAX_TDR_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * format_sim_config_default fills in the configuration to format the largest
+ * partition (index 6) while writing four 64 byte records per step into
+ * partition index 4.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void format_sim_config_default(format_sim_config_t * const p_config)
+{
+    const format_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * format_sim_run formats the partition with traffic between the steps.
+ *
+ * @param   p_config    Pointer to the partitions and traffic to use.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid or the recording
+ *                      system can't be set up, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t format_sim_run(const format_sim_config_t * const p_config,
+                      format_sim_result_t * const p_result)
+{
+    const rs_partition_info_t*  p_partition;
+    uint64_t    step_start_ns;
+    uint64_t    step_ns;
+    uint16_t    record_id = FIRST_RECORD_ID;
+    uint16_t    i;
+    uint8_t     progress;
+    uint8_t     last_progress = 0u;
+    uint8_t     dummy_progress;
+    bool_t      b_valid = FALSE;
+
+    if ( (p_config->format_partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+            && (p_config->traffic_partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+            && (p_config->format_partition_index != p_config->traffic_partition_index)
+            && (p_config->tdr_bytes != 0u)
+            && (p_config->tdr_bytes <= FORMAT_SIM_MAX_TDR_BYTES)
+            && ((p_config->tdr_bytes & 0x0001u) == 0u) )
+    {
+        flash_sim_install();
+        flash_sim_reset();
+
+        if (rsapi_recording_system_init())
+        {
+            b_valid = (rspartition_format_partition(p_config->traffic_partition_index,
+                                                    &dummy_progress) == RS_ERR_NO_ERROR);
+        }
+    }
+
+    if (b_valid)
+    {
+        p_result->steps                   = 0u;
+        p_result->format_us               = 0u;
+        p_result->longest_step_us         = 0u;
+        p_result->b_progress_ok           = TRUE;
+        p_result->traffic_writes          = 0u;
+        p_result->traffic_write_failures  = 0u;
+        p_result->traffic_read_mismatches = 0u;
+        p_result->writes_not_refused      = 0u;
+
+        p_result->format_status = rspartition_format_start(p_config->format_partition_index);
+
+        while (p_result->format_status == RS_ERR_FORMAT_IN_PROGRESS)
+        {
+            for (i = 0u; i < p_config->writes_per_step; i++)
+            {
+                p_result->traffic_writes++;
+
+                if (!traffic_record_write(p_config, record_id))
+                {
+                    p_result->traffic_write_failures++;
+                }
+                else if (!traffic_record_check(p_config, record_id))
+                {
+                    p_result->traffic_read_mismatches++;
+                }
+                else
+                {
+                    // Written and read back OK.
+                }
+
+                record_id++;
+            }
+
+            if (!formatting_write_refused(p_config))
+            {
+                p_result->writes_not_refused++;
+            }
+
+            step_start_ns = flash_sim_time_ns_get();
+            p_result->format_status = rspartition_format_step();
+            step_ns = flash_sim_time_ns_get() - step_start_ns;
+
+            p_result->steps++;
+            p_result->format_us += step_ns / 1000u;
+
+            if ((step_ns / 1000u) > p_result->longest_step_us)
+            {
+                p_result->longest_step_us = step_ns / 1000u;
+            }
+
+            progress = rspartition_format_progress_get();
+
+            if (progress < last_progress)
+            {
+                p_result->b_progress_ok = FALSE;
+            }
+
+            last_progress = progress;
+        }
+
+        if (last_progress != 100u)
+        {
+            p_result->b_progress_ok = FALSE;
+        }
+
+        p_partition = rspartition_partition_ptr_get(p_config->format_partition_index);
+
+        p_result->b_partition_usable
+            = ( (p_partition->partition_error_status == RS_ERR_NO_ERROR)
+                    && (p_partition->next_available_address
+                            == (p_partition->start_address + PAGE_HEADER_LENGTH_BYTES))
+                    && (!rspartition_format_in_progress_check(p_config->format_partition_index)) );
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * traffic_record_write writes one record into the traffic partition, through
+ * the batch write (which writes straight away, rather than queueing).
+ *
+ * @param   p_config    Pointer to the configuration.
+ * @param   record_id   Record ID to write, the TDR is made from this.
+ * @retval  bool_t      TRUE if the record was written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t traffic_record_write(const format_sim_config_t * const p_config,
+                                   const uint16_t record_id)
+{
+    const rs_partition_info_t*  p_partition;
+    rs_queue_status_t           write_status = RS_QUEUE_COULD_NOT_ADD_TO_QUEUE;
+    rs_write_request_t          write_request;
+    rs_write_batch_request_t    batch_request;
+    rs_error_t                  request_status;
+
+    p_partition = rspartition_partition_ptr_get(p_config->traffic_partition_index);
+
+    tdr_fill(&m_write_buffer[RSAPI_BYTES_BEFORE_TDR], p_config->tdr_bytes, record_id);
+
+    write_request.partition_id         = p_partition->id;
+    write_request.record_id            = record_id;
+    write_request.p_write_buffer       = &m_write_buffer[0];
+    write_request.tdr_bytes_to_write   = p_config->tdr_bytes;
+    write_request.b_read_back_required = TRUE;
+    write_request.p_write_status       = &write_status;
+    write_request.p_write_semaphore    = NULL;
+
+    batch_request.partition_id       = p_partition->id;
+    batch_request.p_write_requests   = &write_request;
+    batch_request.number_of_requests = 1u;
+
+    request_status = rsapi_write_batch_request(&batch_request);
+
+    return ( (request_status == RS_ERR_NO_ERROR)
+                && (write_status == RS_QUEUE_REQUEST_COMPLETE) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * traffic_record_check searches back for the last record in the traffic
+ * partition, as a read request would, and checks it is the one just written.
+ *
+ * @param   p_config    Pointer to the configuration.
+ * @param   record_id   Record ID which was written last.
+ * @retval  bool_t      TRUE if the record reads back as written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t traffic_record_check(const format_sim_config_t * const p_config,
+                                   const uint16_t record_id)
+{
+    const rs_partition_info_t*  p_partition;
+    const rssearch_rsr_info_t*  p_rsr_info;
+    rssearch_search_data_t      search_data;
+    uint16_t                    i;
+    bool_t                      b_matches = FALSE;
+
+    p_partition = rspartition_partition_ptr_get(p_config->traffic_partition_index);
+
+    search_data.search_direction                = RSSEARCH_BACKWARDS;
+    search_data.partition_logical_start_address = p_partition->start_address;
+    search_data.partition_logical_end_address   = p_partition->end_address;
+    search_data.search_start_address            = p_partition->next_available_address;
+    search_data.required_record_instance        = 0u;
+    search_data.b_match_record_id               = FALSE;
+    search_data.required_record_id              = 0u;
+    search_data.b_ring_wrapped                  = FALSE;
+    search_data.ring_oldest_address             = p_partition->start_address;
+    search_data.ring_next_free_address          = p_partition->next_available_address;
+
+    if (rssearch_find_valid_RSR_start(&search_data))
+    {
+        p_rsr_info = rssearch_valid_rsr_pointer_get();
+
+        tdr_fill(&m_expected_tdr[0], p_config->tdr_bytes, record_id);
+
+        b_matches = ( (p_rsr_info->record_id == record_id)
+                        && (p_rsr_info->tdr_length == p_config->tdr_bytes) );
+
+        for (i = 0u; (i < p_config->tdr_bytes) && (b_matches); i++)
+        {
+            b_matches = (p_rsr_info->p_start_of_tdr[i] == m_expected_tdr[i]);
+        }
+    }
+
+    return b_matches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * formatting_write_refused writes a record straight into the partition being
+ * formatted, below the recording system API which would turn it away first.
+ *
+ * @param   p_config    Pointer to the configuration.
+ * @retval  bool_t      TRUE if the write was refused.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t formatting_write_refused(const format_sim_config_t * const p_config)
+{
+    const rs_partition_info_t*  p_partition;
+    rs_page_write_t             page_write;
+
+    p_partition = rspartition_partition_ptr_get(p_config->format_partition_index);
+
+    tdr_fill(&m_write_buffer[RSAPI_BYTES_BEFORE_TDR], p_config->tdr_bytes, REFUSED_RECORD_ID);
+
+    page_write.partition_index              = p_config->format_partition_index;
+    page_write.partition_id                 = p_partition->id;
+    page_write.partition_logical_start_addr = p_partition->start_address;
+    page_write.partition_logical_end_addr   = p_partition->end_address;
+    page_write.next_free_addr               = p_partition->start_address;
+    page_write.record_id                    = REFUSED_RECORD_ID;
+    page_write.p_write_buffer               = &m_write_buffer[0];
+    page_write.bytes_to_write               = (p_config->tdr_bytes + RSAPI_BYTES_BEFORE_TDR)
+                                                + RSAPI_BYTES_AFTER_TDR;
+    page_write.b_read_back_write_command    = FALSE;
+
+    return (rspages_page_data_write(&page_write) != RS_PG_WRITE_OK);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * tdr_fill makes the TDR for a record from its record ID, so that each record
+ * is different and can be checked when it is read back.
+ *
+ * @param   p_tdr       Pointer to where to put the TDR.
+ * @param   tdr_bytes   Number of bytes in the TDR.
+ * @param   record_id   Record ID of the record.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void tdr_fill(uint8_t * const p_tdr,
+                     const uint16_t tdr_bytes,
+                     const uint16_t record_id)
+{
+    uint16_t    i;
+
+    for (i = 0u; i < tdr_bytes; i++)
+    {
+        //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+        p_tdr[i] = (uint8_t)((record_id + (i * 7u)) & 0xFFu);
+    }
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,387 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        free_address_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side benchmark and check of the next free address search.
+ * @details
+ * Builds random pages of RSRs in the simulated main flash (flash_sim.c) at a
+ * range of fill levels, and finds the end of the data in each page two ways:
+ *
+ *  - rssearch_find_next_free_address, which probes blocks and only searches
+ *    linearly if the probes can't be shown to be right.
+ *  - The linear search on its own, one block at a time from the end of the
+ *    page, as rssearch_find_next_free_address used to.
+ *
+ * Each is measured with the simulated bus reads and bus time, and both
+ * results are compared with the address after the last byte in the page
+ * which isn't blank, which is known from building the page.
+ *
+ * The TDRs are random, with runs of 0xFF in them (some long enough to leave
+ * whole blank blocks in the middle of the data), and some pages start with
+ * the end of an RSR from the previous page.  Any page where either search
+ * gets the wrong answer counts as a mismatch, so the benchmark is also a
+ * randomised check that the probe search is always the same as the linear.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs the simulated
+ * devices (without resetting them) and initialises the flash HAL with its own
+ * map, in which logical and physical main flash addresses are the same.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rspages.h"
+#include "rssearch.h"
+#include "rssearch_prv.h"
+#include "flash_hal.h"
+#include "crc.h"
+#include "flash_sim.h"
+#include "free_address_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define RSR_WRAPPER_SIZE_OVERHEAD   8u      ///< SYNC, IDx2, LENx2, CRCx2, ENDSYNC
+#define MAX_FF_RUN_BYTES            48u     ///< Longest run of 0xFF put in a TDR.
+
+#define DEFAULT_CONFIG              { 0x00100000u, (RS_CFG_PAGE_SIZE_KB * 1024u) - PAGE_HEADER_LENGTH_BYTES, \
+                                      200u, 64u, 2u, 25u, 1u }
+
+#define FILL_PERCENTAGES            { 0u, 10u, 25u, 50u, 75u, 100u }
+
+/// Whole of the main flash in the first partition, the rest just fill the map.
+#define BENCHMARK_LOGICAL_ADDRESSES                                 \
+{                                                                   \
+    { STORAGE_DEVICE_MAIN_FLASH,   0x00000000u, 0x0FFFFFFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10000000u, 0x10001FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10002000u, 0x10003FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10004000u, 0x10005FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10006000u, 0x10007FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10008000u, 0x10009FFFu },      \
+    { STORAGE_DEVICE_I2C_EEPROM,   0x10010000u, 0x10010FFFu },      \
+}
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static uint32_t page_build(const free_address_sim_config_t * const p_config,
+                           const uint16_t fill_percent);
+
+static uint32_t tdr_fill(const free_address_sim_config_t * const p_config,
+                         uint8_t * const p_tdr,
+                         const uint32_t tdr_length);
+
+static uint32_t random_get(const uint32_t range);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static const flash_hal_logical_t m_logical_addresses[RS_CFG_MAX_NUMBER_OF_PARTITIONS]
+                                    = BENCHMARK_LOGICAL_ADDRESSES;
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_page[FREE_ADDRESS_SIM_MAX_AREA_BYTES];
+
+//lint -e{956} Only used from a single host thread.
+static uint32_t     m_random_state;
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * free_address_sim_config_default fills in the configuration for 200 pages
+ * at each fill level, each the size of a page data area, with TDRs of up to
+ * 64 bytes.  One TDR byte in fifty starts a run of 0xFF, and a quarter of
+ * the pages start with the end of an RSR from the previous page.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void free_address_sim_config_default(free_address_sim_config_t * const p_config)
+{
+    const free_address_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * free_address_sim_run builds the pages and searches each of them.
+ *
+ * @param   p_config    Pointer to the pages to build.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t free_address_sim_run(const free_address_sim_config_t * const p_config,
+                            free_address_sim_result_t * const p_result)
+{
+    const uint16_t                  fill_percentages[FREE_ADDRESS_SIM_FILL_LEVELS] = FILL_PERCENTAGES;
+    rssearch_unit_test_pointers_t*  p_search;
+    free_address_sim_level_t*       p_level;
+    flash_sim_stats_t               stats_at_start;
+    flash_sim_stats_t               stats;
+    uint64_t                        bus_ns_at_start;
+    uint32_t                        data_end_address;
+    uint32_t                        found_address;
+    uint32_t                        level_index;
+    uint32_t                        page_counter;
+    bool_t                          b_valid = FALSE;
+
+    if ( (p_config->area_bytes != 0u)
+            && (p_config->area_bytes <= FREE_ADDRESS_SIM_MAX_AREA_BYTES)
+            && ((p_config->area_logical_address & 1u) == 0u)
+            && ((p_config->area_bytes & 1u) == 0u)
+            && (p_config->max_tdr_bytes <= RS_CFG_MAX_TDR_SIZE_BYTES)
+            && (p_config->ff_run_percent <= 100u)
+            && (p_config->spanning_percent <= 100u) )
+    {
+        flash_sim_install();
+        b_valid = flash_hal_initialise(&m_logical_addresses[0]);
+    }
+
+    if (b_valid)
+    {
+        p_search = rssearch_unit_test_ptr_get();
+        m_random_state = (p_config->seed != 0u) ? p_config->seed : 1u;
+        p_result->mismatches = 0u;
+
+        for (level_index = 0u; level_index < FREE_ADDRESS_SIM_FILL_LEVELS; level_index++)
+        {
+            p_level = &p_result->level[level_index];
+
+            p_level->fill_percent     = fill_percentages[level_index];
+            p_level->pages            = 0u;
+            p_level->probe_bus_reads  = 0u;
+            p_level->linear_bus_reads = 0u;
+            p_level->probe_bus_ns     = 0u;
+            p_level->linear_bus_ns    = 0u;
+            p_level->fallbacks        = 0u;
+            p_level->mismatches       = 0u;
+
+            for (page_counter = 0u; page_counter < p_config->pages_per_level; page_counter++)
+            {
+                data_end_address = page_build(p_config, p_level->fill_percent);
+
+                flash_sim_stats_get(&stats_at_start);
+                bus_ns_at_start = flash_sim_time_ns_get();
+                found_address = rssearch_find_next_free_address(p_config->area_logical_address,
+                                                                p_config->area_bytes);
+                flash_sim_stats_get(&stats);
+                p_level->probe_bus_ns    += flash_sim_time_ns_get() - bus_ns_at_start;
+                p_level->probe_bus_reads += stats.main_flash_bus_reads - stats_at_start.main_flash_bus_reads;
+
+                if (found_address != data_end_address)
+                {
+                    p_level->mismatches++;
+                }
+
+                flash_sim_stats_get(&stats_at_start);
+                bus_ns_at_start = flash_sim_time_ns_get();
+                found_address = p_search->p_linear_free_address_find(p_config->area_logical_address,
+                                                                     p_config->area_bytes);
+                flash_sim_stats_get(&stats);
+                p_level->linear_bus_ns    += flash_sim_time_ns_get() - bus_ns_at_start;
+                p_level->linear_bus_reads += stats.main_flash_bus_reads - stats_at_start.main_flash_bus_reads;
+
+                if (found_address != data_end_address)
+                {
+                    p_level->mismatches++;
+                }
+
+                if (!p_search->p_probe_free_address_find(p_config->area_logical_address,
+                                                         p_config->area_bytes,
+                                                         &found_address))
+                {
+                    p_level->fallbacks++;
+                }
+
+                p_level->pages++;
+            }
+
+            p_result->mismatches += p_level->mismatches;
+        }
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * page_build writes a random page of RSRs into the area, filling it until the
+ * next RSR would take it past the fill level.  At 100% the RSRs carry on
+ * until the next one wouldn't fit in the area.
+ *
+ * @param   p_config        Pointer to the pages to build.
+ * @param   fill_percent    How full to make the page.
+ * @retval  uint32_t        Address after the last byte which isn't blank.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t page_build(const free_address_sim_config_t * const p_config,
+                           const uint16_t fill_percent)
+{
+    uint32_t    fill_bytes;
+    uint32_t    offset = 0u;
+    uint32_t    tdr_length;
+    uint32_t    last_used_offset = 0u;
+    uint32_t    counter;
+    uint16_t    crc;
+    bool_t      b_full = FALSE;
+
+    for (counter = 0u; counter < p_config->area_bytes; counter++)
+    {
+        m_page[counter] = RS_CFG_BLANK_LOCATION_CONTAINS;
+    }
+
+    fill_bytes = (p_config->area_bytes * fill_percent) / 100u;
+
+    /* The end of an RSR from the previous page - its TDR, CRC and ENDSYNC. */
+    if ( (fill_bytes != 0u) && (random_get(100u) < p_config->spanning_percent) )
+    {
+        tdr_length = random_get((uint32_t)p_config->max_tdr_bytes + 3u);
+        if ((tdr_length + 1u) <= fill_bytes)
+        {
+            offset = tdr_fill(p_config, &m_page[0u], tdr_length);
+            m_page[offset] = RSR_ENDSYNC_CHARACTER;
+            offset++;
+        }
+    }
+
+    while (!b_full)
+    {
+        tdr_length = random_get((uint32_t)p_config->max_tdr_bytes + 1u);
+
+        if ((offset + tdr_length + RSR_WRAPPER_SIZE_OVERHEAD) > fill_bytes)
+        {
+            b_full = TRUE;
+        }
+        else
+        {
+            m_page[offset]      = RSR_SYNC_CHARACTER;
+            m_page[offset + 1u] = (uint8_t)random_get(256u);
+            m_page[offset + 2u] = (uint8_t)random_get(256u);
+            m_page[offset + 3u] = (uint8_t)(tdr_length & 0xFFu);
+            m_page[offset + 4u] = (uint8_t)(tdr_length >> 8u);
+            (void)tdr_fill(p_config, &m_page[offset + 5u], tdr_length);
+
+            crc = CRC_CCITTOnByteCalculate(&m_page[offset], tdr_length + 5u, 0x0000u);
+            m_page[offset + 5u + tdr_length] = (uint8_t)(crc >> 8u);
+            m_page[offset + 6u + tdr_length] = (uint8_t)(crc & 0xFFu);
+            m_page[offset + 7u + tdr_length] = RSR_ENDSYNC_CHARACTER;
+
+            offset += tdr_length + RSR_WRAPPER_SIZE_OVERHEAD;
+        }
+    }
+
+    for (counter = 0u; counter < p_config->area_bytes; counter++)
+    {
+        if (m_page[counter] != RS_CFG_BLANK_LOCATION_CONTAINS)
+        {
+            last_used_offset = counter + 1u;
+        }
+    }
+
+    (void)flash_sim_backdoor_write(STORAGE_DEVICE_MAIN_FLASH, p_config->area_logical_address,
+                                   p_config->area_bytes, &m_page[0u]);
+
+    /* The page changed behind flash_hal's back. */
+    flash_hal_erased_cache_invalidate();
+
+    return p_config->area_logical_address + last_used_offset;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * tdr_fill fills a TDR with random bytes and runs of 0xFF.
+ *
+ * @param   p_config    Pointer to the pages to build.
+ * @param   p_tdr       Pointer to the TDR.
+ * @param   tdr_length  Length of the TDR.
+ * @retval  uint32_t    Length of the TDR.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t tdr_fill(const free_address_sim_config_t * const p_config,
+                         uint8_t * const p_tdr,
+                         const uint32_t tdr_length)
+{
+    uint32_t    offset = 0u;
+    uint32_t    run_length;
+
+    while (offset < tdr_length)
+    {
+        if (random_get(100u) < p_config->ff_run_percent)
+        {
+            run_length = random_get(MAX_FF_RUN_BYTES) + 1u;
+
+            while ((run_length != 0u) && (offset < tdr_length))
+            {
+                p_tdr[offset] = RS_CFG_BLANK_LOCATION_CONTAINS;
+                offset++;
+                run_length--;
+            }
+        }
+        else
+        {
+            p_tdr[offset] = (uint8_t)random_get(256u);
+            offset++;
+        }
+    }
+
+    return tdr_length;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * random_get returns a pseudo random number (xorshift32), so that the pages
+ * are the same every time for the same seed.
+ *
+ * @param   range       Number of values wanted.
+ * @retval  uint32_t    Random number from 0 to range - 1.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t random_get(const uint32_t range)
+{
+    m_random_state ^= m_random_state << 13u;
+    m_random_state ^= m_random_state >> 17u;
+    m_random_state ^= m_random_state << 5u;
+
+    return m_random_state % range;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
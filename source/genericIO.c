@@ -80,7 +80,7 @@ static void IO_16bitWrite_Impl(const uint32_t address, const uint16_t data)
 {
 	volatile uint16_t *p;
 
-	p  = (uint16_t*)address;		//lint !e511 !e923 !e9078
+	p  = (uint16_t*)(uintptr_t)address;		//lint !e511 !e923 !e9078
 	*p = data;
 }
 
@@ -103,7 +103,7 @@ static uint16_t IO_16bitRead_Impl(const uint32_t address)
 {
 	volatile const uint16_t *p;
 
-	p = (uint16_t*)address;			//lint !e511 !e923 !e9078
+	p = (uint16_t*)(uintptr_t)address;			//lint !e511 !e923 !e9078
 	return *p;
 }
 
@@ -126,7 +126,7 @@ static void IO_32bitWrite_Impl(const uint32_t address, const uint32_t data)
 {
 	volatile uint32_t *p;
 
-	p  = (uint32_t*)address;		//lint !e511 !e923 !e9078
+	p  = (uint32_t*)(uintptr_t)address;		//lint !e511 !e923 !e9078
 	*p = data;
 }
 
@@ -149,7 +149,7 @@ static uint32_t IO_32bitRead_Impl(const uint32_t address)
 {
 	volatile const uint32_t *p;
 
-	p = (uint32_t*)address;			//lint !e511 !e923 !e9078
+	p = (uint32_t*)(uintptr_t)address;			//lint !e511 !e923 !e9078
 	return *p;
 }
 
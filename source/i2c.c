@@ -21,6 +21,21 @@
  * compliance with MISRA rule 10.5, to ensure that the data is always 16 bits
  * following a shift, i.e. it is implementation independent.
  *
+ * Transactions can also be queued with I2C_TransactionQueue(), and are then
+ * carried out by I2C_TransactionStep(), which does one bus operation per call
+ * and calls the transaction's callback when it has finished.  An ack poll only
+ * polls once per step, so a device's write cycle can be waited for from an
+ * idle loop without the CPU spinning.
+ *
+ * @note
+ * The queue is stepped from the background loop, not from the I2C interrupt,
+ * and each read or write still polls the module a byte at a time without the
+ * FIFOs.  The bus transfer of a 32 byte page takes under 1ms at 400kbps, next
+ * to the 5ms write cycle which used to be spun on, and the register accesses
+ * go through genericIO so that the host tests can replace them.  An ISR
+ * would need the PIE group 8 vectors set up by the loader and couldn't be run
+ * on the host, so it has been left out.
+ *
  * @warning
  * The GPIO multiplexers need to be set-up so that the I2C pins are mux'ed
  * through to the correct IO pins - this will need to be taken care of in a
@@ -91,6 +106,8 @@ static bool_t   PollForTransmitRegisterReady(void);
 static void     PollForReceivedDataReady(void);
 static void     ResetCountAndSendStopBit(void);
 
+static void     TransactionComplete(const EI2CStatus_t Status);
+
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module:
@@ -98,6 +115,22 @@ static void     ResetCountAndSendStopBit(void);
 /// Volatile flag to force a timeout during the polling function.
 static volatile bool_t m_b_force_timeout = FALSE;
 
+/// Transaction queue - oldest first.
+//lint -e{956} Only accessed from the background loop.
+static I2CTransaction_t m_transactions[I2C_TRANSACTION_QUEUE_SIZE];
+
+/// Index of the oldest transaction in the queue.
+//lint -e{956} Only accessed from the background loop.
+static uint16_t m_transaction_head = 0u;
+
+/// Number of transactions in the queue.
+//lint -e{956} Only accessed from the background loop.
+static uint16_t m_transaction_count = 0u;
+
+/// Number of polls made by the ack poll at the head of the queue.
+//lint -e{956} Only accessed from the background loop.
+static uint16_t m_transaction_polls = 0u;
+
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -273,7 +306,7 @@ static EI2CStatus_t I2C_Read_Impl(const uint16_t SlaveAddress,
             // Read the required number of data bytes from the device.
             while (DataCount != 0u)
             {
-                uint8_t i;
+                uint16_t i;
                 // Wait for next byte of data to be received.
                 PollForReceivedDataReady();
 
@@ -394,7 +427,7 @@ static EI2CStatus_t I2C_Write_Impl(const uint16_t SlaveAddress,
             // Write the required number of data bytes into the slave device.
             while (DataCount != 0u)
             {
-                uint8_t i;
+                uint16_t i;
                 // Get next byte from buffer and transmit it.
                 //lint -e{921} Cast to uint16_t OK - write function needs 16 bits.
                 genericIO_16bitWrite(I2CDXR_ADDRESS, (uint16_t)pData[WriteCounter]);
@@ -590,6 +623,131 @@ void I2C_AckPollTimeoutFlagSet(void)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * I2C_TransactionQueue puts a copy of a transaction on the end of the
+ * transaction queue.  Nothing happens on the bus until I2C_TransactionStep()
+ * is called.
+ *
+ * @param	p_transaction	Pointer to the transaction to queue.
+ * @retval	bool_t			TRUE if queued, FALSE if the queue is full.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t I2C_TransactionQueue(const I2CTransaction_t * const p_transaction)
+{
+    bool_t      bQueued = FALSE;
+    uint16_t    Index;
+
+    if (m_transaction_count < I2C_TRANSACTION_QUEUE_SIZE)
+    {
+        //lint -e{921} Cast to uint16_t - always less than I2C_TRANSACTION_QUEUE_SIZE.
+        Index = (uint16_t)((m_transaction_head + m_transaction_count) % I2C_TRANSACTION_QUEUE_SIZE);
+
+        m_transactions[Index] = *p_transaction;
+        m_transaction_count++;
+        bQueued = TRUE;
+    }
+
+    return bQueued;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * I2C_TransactionStep carries out one bus operation for the oldest queued
+ * transaction - a whole read or write, or a single acknowledgement poll.  A
+ * read or write always finishes in one step.  An ack poll finishes when the
+ * slave acknowledges, or when it runs out of polls (MaxPolls), or, if
+ * MaxPolls is zero, when the force timeout flag is set.  The transaction's
+ * callback is called once it has finished, and may queue more transactions.
+ *
+ * @retval	bool_t	TRUE if there are still transactions in the queue.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t I2C_TransactionStep(void)
+{
+    const I2CTransaction_t *    p_transaction;
+    EI2CStatus_t                Status;
+    bool_t                      bForceTimeout;
+
+    if (m_transaction_count != 0u)
+    {
+        p_transaction = &m_transactions[m_transaction_head];
+
+        switch (p_transaction->Type)
+        {
+            case I2C_TRANSACTION_READ:
+                Status = I2C_Read(p_transaction->SlaveAddress,
+                                  p_transaction->DeviceAddress,
+                                  p_transaction->DataCount,
+                                  p_transaction->p_read_data);
+                TransactionComplete(Status);
+                break;
+
+            case I2C_TRANSACTION_WRITE:
+                Status = I2C_Write(p_transaction->SlaveAddress,
+                                   p_transaction->DeviceAddress,
+                                   p_transaction->DataCount,
+                                   p_transaction->p_write_data);
+                TransactionComplete(Status);
+                break;
+
+            case I2C_TRANSACTION_ACK_POLL:
+                // Take the flag before polling - the poll function may reset it.
+                bForceTimeout = m_b_force_timeout;
+
+                // A single poll - it only 'times out' if there was no ACK.
+                Status = I2C_AckPoll(p_transaction->SlaveAddress, 1u);
+                m_transaction_polls++;
+
+                if (Status == I2C_COMPLETED_OK)
+                {
+                    TransactionComplete(Status);
+                }
+                else if (p_transaction->MaxPolls != 0u)
+                {
+                    if (m_transaction_polls >= p_transaction->MaxPolls)
+                    {
+                        TransactionComplete(I2C_ACKPOLL_TIMEOUT_EXCEEDED);
+                    }
+                }
+                else if ( (bForceTimeout) || (m_b_force_timeout) )
+                {
+                    TransactionComplete(I2C_ACKPOLL_TIMEOUT_EXCEEDED);
+                }
+                else
+                {
+                    ;   // Poll again next time.
+                }
+                break;
+
+            default:
+                TransactionComplete(I2C_UNKNOWN_ERROR);
+                break;
+        }
+    }
+
+    return (m_transaction_count != 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * I2C_TransactionCountGet returns the number of transactions in the queue,
+ * including the one being carried out.
+ *
+ * @retval	uint16_t	Number of transactions queued.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t I2C_TransactionCountGet(void)
+{
+    return m_transaction_count;
+}
+
+
 #ifdef UNIT_TEST_BUILD
 // ----------------------------------------------------------------------------
 /**
@@ -774,5 +932,35 @@ static void ResetCountAndSendStopBit(void)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * TransactionComplete takes the oldest transaction off the queue and calls its
+ * callback.  The transaction is removed first, so that the callback can queue
+ * another one in its place.
+ *
+ * @param	Status		Status to pass to the callback.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void TransactionComplete(const EI2CStatus_t Status)
+{
+    I2CTransactionCallback_t    p_callback;
+    void *                      p_context;
+
+    p_callback = m_transactions[m_transaction_head].p_callback;
+    p_context  = m_transactions[m_transaction_head].p_context;
+
+    //lint -e{921} Cast to uint16_t - always less than I2C_TRANSACTION_QUEUE_SIZE.
+    m_transaction_head = (uint16_t)((m_transaction_head + 1u) % I2C_TRANSACTION_QUEUE_SIZE);
+    m_transaction_count--;
+    m_transaction_polls = 0u;
+
+    if (p_callback != NULL)
+    {
+        p_callback(p_context, Status);
+    }
+}
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -0,0 +1,579 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        image_verify.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Verified image descriptors, to avoid a full image CRC at boot.
+ * @details
+ * After a partition has been programmed and its CRC calculated from the
+ * flash, a descriptor holding the CRC, the length and a flash programming
+ * generation counter is appended to a small log at the top of the parameter
+ * sector.  At boot the self test can trust the newest descriptor for the
+ * bootloader and application images instead of recalculating their CRCs,
+ * and the full CRC is then run in the background.
+ *
+ * Each descriptor occupies one slot of IMAGE_VERIFY_SLOT_WORDS words:
+ * - marker (0xA55A = verified, 0x0000 = retired, 0xFFFF = blank)
+ * - partition number
+ * - generation, LSW then MSW
+ * - length in words, LSW then MSW
+ * - image CRC
+ * - CRC-CCITT of the six words above (not including the marker)
+ *
+ * Flash can only have bits cleared without erasing the sector, so the log is
+ * append only.  A descriptor is retired by clearing its marker to zero, which
+ * is done before a partition is erased, so a stale descriptor can never be
+ * trusted.  The descriptor body is programmed before its marker, so a write
+ * which is interrupted by a reset is never seen as verified.  A slot with a
+ * bad body CRC after the newest descriptor means that the partition it
+ * belonged to is unknown, so nothing is trusted in that case.
+ *
+ * The image CRCs themselves are calculated a step at a time with
+ * ImageVerify_CRCStart() and ImageVerify_CRCStep(), so that they can be run
+ * in the background by the self test, and a slice per message by opcode 191.
+ * The flash is read through genericIO_16bitRead() in blocks of
+ * IMAGE_VERIFY_CRC_BLOCK_WORDS, rather than handing a flash address to the
+ * CRC as a pointer.
+ *
+ * The log is only erased when the parameter partition is erased.  If the log
+ * fills up no more descriptors can be written, and the self test falls back
+ * to a full CRC at every boot until then.  Retired slots can't be reused
+ * without erasing the sector, and the parameters are too big to be kept in
+ * RAM while it is erased, so the log can't be compacted in place - the self
+ * test reports a full log (ImageVerify_LogFullCheck()) instead, and the
+ * parameter partition has to be programmed again to clear it.
+ *
+ * The log took the top 1k words of flash sector B from the parameter
+ * partition, so PARAMETER_END_ADDRESS (and with it the parameter CRC) moved
+ * from 0x337FFF to 0x337BFF.  A parameter partition programmed by an older
+ * loader keeps its CRC at 0x337FFF, inside the log, and must be programmed
+ * again after this loader is installed.  Parameter images which run past
+ * 0x337BFE are refused, as for any write outside a partition.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include "common_data_types.h"
+#include "tool_specific_config.h"
+#include "tool_specific_programming.h"
+#include "genericIO.h"
+#include "crc.h"
+#include "dsp_crc.h"
+#include "image_verify.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define IMAGE_VERIFY_MARKER_VERIFIED    0xA55Au ///< Descriptor can be trusted.
+#define IMAGE_VERIFY_MARKER_RETIRED     0x0000u ///< Descriptor retired.
+#define IMAGE_VERIFY_BLANK_WORD         0xFFFFu ///< Erased flash.
+
+#define IMAGE_VERIFY_SLOT_WORDS         8u      ///< Words in each descriptor slot.
+#define IMAGE_VERIFY_BODY_WORDS         6u      ///< Words covered by the descriptor CRC.
+
+/// Number of descriptor slots in the log.
+#define IMAGE_VERIFY_NUMBER_OF_SLOTS    ((uint32_t)IMAGE_DESCRIPTOR_LENGTH \
+                                            / IMAGE_VERIFY_SLOT_WORDS)
+
+// Word offsets within a slot.
+#define SLOT_MARKER                     0u
+#define SLOT_PARTITION                  1u
+#define SLOT_GENERATION_LSW             2u
+#define SLOT_GENERATION_MSW             3u
+#define SLOT_LENGTH_LSW                 4u
+#define SLOT_LENGTH_MSW                 5u
+#define SLOT_IMAGE_CRC                  6u
+#define SLOT_DESCRIPTOR_CRC             7u
+
+#define IMAGE_VERIFY_CRC_SEED           0xFFFFu ///< Seed for the descriptor CRC.
+
+#define IMAGE_VERIFY_CRC_BLOCK_WORDS    32u     ///< Image words read per CRC block.
+
+
+/**
+ * Result of scanning the descriptor log for one partition.
+ */
+typedef struct
+{
+    bool_t              bFound;             ///< A verified descriptor was found.
+    uint32_t            FoundSlot;          ///< Slot holding the descriptor.
+    ImageDescriptor_t   Descriptor;         ///< Newest verified descriptor.
+    uint32_t            HighestGeneration;  ///< Highest generation for the partition.
+    bool_t              bCorruptSlotFound;  ///< A slot with a bad CRC was found.
+    uint32_t            LastCorruptSlot;    ///< Last slot with a bad CRC.
+    uint32_t            NextFreeSlot;       ///< First slot after the last used one.
+} ImageVerifyScan_t;
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     LogScan(const uint16_t Partition, ImageVerifyScan_t* const pScan);
+
+static void     SlotRead(const uint32_t Slot, uint16_t* const pSlotWords);
+
+static bool_t   SlotBodyIsValid(const uint16_t* const pSlotWords);
+
+static uint32_t SlotAddressGet(const uint32_t Slot);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * ImageVerify_DescriptorGet fetches the newest verified descriptor for a
+ * partition.  Nothing is returned if a corrupt slot follows it in the log.
+ *
+ * @param   Partition       Partition number to look for.
+ * @param   pDescriptor     Pointer to structure to copy descriptor into.
+ * @retval  bool_t          TRUE if a descriptor was found, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ImageVerify_DescriptorGet(const uint16_t Partition,
+                                 ImageDescriptor_t* const pDescriptor)
+{
+    ImageVerifyScan_t   scan;
+    bool_t              b_descriptor_found = FALSE;
+
+    LogScan(Partition, &scan);
+
+    if (scan.bFound == TRUE)
+    {
+        if ( (scan.bCorruptSlotFound == FALSE)
+                || (scan.LastCorruptSlot < scan.FoundSlot) )
+        {
+            *pDescriptor = scan.Descriptor;
+            b_descriptor_found = TRUE;
+        }
+    }
+
+    return b_descriptor_found;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ImageVerify_DescriptorTrustedCheck checks whether the image in a partition
+ * can be trusted without calculating its CRC.  The newest descriptor must be
+ * intact, must cover the whole partition, and its CRC must match the expected
+ * CRC which is stored with the image.
+ *
+ * @param   Partition       Partition number to check.
+ * @param   LengthInWords   Length of the partition.
+ * @param   ExpectedCRC     Expected CRC stored with the image.
+ * @retval  bool_t          TRUE if the image can be trusted, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ImageVerify_DescriptorTrustedCheck(const uint16_t Partition,
+                                          const uint32_t LengthInWords,
+                                          const uint16_t ExpectedCRC)
+{
+    ImageDescriptor_t   descriptor;
+    bool_t              b_trusted = FALSE;
+
+    if (ImageVerify_DescriptorGet(Partition, &descriptor) == TRUE)
+    {
+        if ( (descriptor.LengthInWords == LengthInWords)
+                && (descriptor.ImageCRC == ExpectedCRC) )
+        {
+            b_trusted = TRUE;
+        }
+    }
+
+    return b_trusted;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ImageVerify_DescriptorWrite appends a verified descriptor for a partition,
+ * retiring any older descriptors for the same partition first.  The CRC must
+ * have been calculated from the flash, not from a RAM buffer.
+ *
+ * @param   Partition       Partition number of the image.
+ * @param   LengthInWords   Length covered by the CRC.
+ * @param   ImageCRC        CRC calculated from the flash.
+ * @retval  bool_t          TRUE if written OK, FALSE if log full or flash error.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ImageVerify_DescriptorWrite(const uint16_t Partition,
+                                   const uint32_t LengthInWords,
+                                   const uint16_t ImageCRC)
+{
+    ImageVerifyScan_t   scan;
+    uint16_t            slot_words[IMAGE_VERIFY_SLOT_WORDS];
+    uint32_t            generation;
+    uint32_t            slot_address;
+    FlashStatus_t       flash_status;
+    bool_t              b_written_ok;
+
+    LogScan(Partition, &scan);
+
+    // Only retire the old descriptor if there is room for the new one.
+    if (scan.NextFreeSlot >= IMAGE_VERIFY_NUMBER_OF_SLOTS)
+    {
+        b_written_ok = FALSE;
+    }
+    else
+    {
+        b_written_ok = ImageVerify_DescriptorRetire(Partition);
+    }
+
+    if (b_written_ok == TRUE)
+    {
+        generation = scan.HighestGeneration + 1u;
+
+        //lint -e{921} Cast to uint16_t
+        slot_words[SLOT_MARKER]         = IMAGE_VERIFY_MARKER_VERIFIED;
+        slot_words[SLOT_PARTITION]      = Partition;
+        slot_words[SLOT_GENERATION_LSW] = (uint16_t)(generation & 0xFFFFu);
+        slot_words[SLOT_GENERATION_MSW] = (uint16_t)(generation >> 16);
+        slot_words[SLOT_LENGTH_LSW]     = (uint16_t)(LengthInWords & 0xFFFFu);
+        slot_words[SLOT_LENGTH_MSW]     = (uint16_t)(LengthInWords >> 16);
+        slot_words[SLOT_IMAGE_CRC]      = ImageCRC;
+        slot_words[SLOT_DESCRIPTOR_CRC] = CRC_CCITTCalculate(&slot_words[SLOT_PARTITION],
+                                                             IMAGE_VERIFY_BODY_WORDS,
+                                                             IMAGE_VERIFY_CRC_SEED);
+
+        // Program the body first and the marker last, so that the descriptor
+        // is only seen as verified once it has been completely written.
+        slot_address = SlotAddressGet(scan.NextFreeSlot);
+
+        //lint -e{923} Cast from integer to pointer - flash address.
+        b_written_ok = ToolSpecificProgramming_SafeFlashProgram((void*)(uintptr_t)(slot_address + SLOT_PARTITION),
+                                                                &slot_words[SLOT_PARTITION],
+                                                                (uint32_t)(IMAGE_VERIFY_SLOT_WORDS - 1u),
+                                                                &flash_status);
+        if (b_written_ok == TRUE)
+        {
+            //lint -e{923} Cast from integer to pointer - flash address.
+            b_written_ok = ToolSpecificProgramming_SafeFlashProgram((void*)(uintptr_t)slot_address,
+                                                                    &slot_words[SLOT_MARKER],
+                                                                    1u,
+                                                                    &flash_status);
+        }
+    }
+
+    return b_written_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ImageVerify_DescriptorRetire retires all verified descriptors for a
+ * partition by clearing their markers.  This must be called before the
+ * partition is erased or programmed.
+ *
+ * @param   Partition       Partition number of the image.
+ * @retval  bool_t          TRUE if retired OK, FALSE if flash error.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ImageVerify_DescriptorRetire(const uint16_t Partition)
+{
+    uint16_t        slot_words[IMAGE_VERIFY_SLOT_WORDS];
+    uint16_t        retired_marker = IMAGE_VERIFY_MARKER_RETIRED;
+    uint32_t        slot;
+    FlashStatus_t   flash_status;
+    bool_t          b_retired_ok = TRUE;
+
+    for (slot = 0u; slot < IMAGE_VERIFY_NUMBER_OF_SLOTS; slot++)
+    {
+        SlotRead(slot, &slot_words[0]);
+
+        if ( (slot_words[SLOT_MARKER] == IMAGE_VERIFY_MARKER_VERIFIED)
+                && (slot_words[SLOT_PARTITION] == Partition)
+                && (SlotBodyIsValid(&slot_words[0]) == TRUE) )
+        {
+            //lint -e{923} Cast from integer to pointer - flash address.
+            if (ToolSpecificProgramming_SafeFlashProgram((void*)(uintptr_t)SlotAddressGet(slot),
+                                                         &retired_marker, 1u,
+                                                         &flash_status) == FALSE)
+            {
+                b_retired_ok = FALSE;
+            }
+        }
+    }
+
+    return b_retired_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ImageVerify_LogFullCheck checks whether every slot in the descriptor log
+ * has been used, so that no more descriptors can be written until the
+ * parameter partition (and with it the log) is erased.
+ *
+ * @retval  bool_t          TRUE if the log is full.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ImageVerify_LogFullCheck(void)
+{
+    ImageVerifyScan_t   scan;
+
+    // The free slot doesn't depend on the partition looked for.
+    LogScan(IMAGE_VERIFY_BLANK_WORD, &scan);
+
+    return (scan.NextFreeSlot >= IMAGE_VERIFY_NUMBER_OF_SLOTS);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ImageVerify_CRCStart sets up an image CRC, to be calculated by
+ * ImageVerify_CRCStep().  The CRC is the same as the one stored with the
+ * image (crc_calcRunningCRC() in WORD_CRC_CALC mode, started from zero).
+ *
+ * @param   pCRC            Pointer to the CRC state.
+ * @param   StartAddress    First address of the image.
+ * @param   LengthInWords   Length of the image.
+ *
+ */
+// ----------------------------------------------------------------------------
+void ImageVerify_CRCStart(ImageVerifyCRC_t* const pCRC,
+                          const uint32_t StartAddress,
+                          const uint32_t LengthInWords)
+{
+    pCRC->NextAddress = StartAddress;
+    pCRC->WordsRemaining = LengthInWords;
+    pCRC->RunningCRC = 0u;
+    pCRC->bComplete = FALSE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ImageVerify_CRCStep includes up to MaximumWords more words of the image in
+ * the CRC, and finishes the CRC off once every word has been included.
+ *
+ * @param   pCRC            Pointer to the CRC state.
+ * @param   MaximumWords    Most words to include in this step.
+ * @retval  bool_t          TRUE if the CRC is complete, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ImageVerify_CRCStep(ImageVerifyCRC_t* const pCRC,
+                           const uint32_t MaximumWords)
+{
+    uint16_t    block[IMAGE_VERIFY_CRC_BLOCK_WORDS];
+    uint32_t    words_to_do;
+    uint32_t    block_words;
+    uint32_t    word_index;
+
+    if (pCRC->bComplete == FALSE)
+    {
+        words_to_do = pCRC->WordsRemaining;
+        if (words_to_do > MaximumWords)
+        {
+            words_to_do = MaximumWords;
+        }
+
+        while (words_to_do != 0u)
+        {
+            block_words = words_to_do;
+            if (block_words > IMAGE_VERIFY_CRC_BLOCK_WORDS)
+            {
+                block_words = IMAGE_VERIFY_CRC_BLOCK_WORDS;
+            }
+
+            for (word_index = 0u; word_index < block_words; word_index++)
+            {
+                block[word_index] = genericIO_16bitRead(pCRC->NextAddress + word_index);
+            }
+
+            pCRC->RunningCRC = crc_calcRunningCRC(pCRC->RunningCRC, &block[0],
+                                                  block_words, WORD_CRC_CALC);
+            pCRC->NextAddress += block_words;
+            pCRC->WordsRemaining -= block_words;
+            words_to_do -= block_words;
+        }
+
+        if (pCRC->WordsRemaining == 0u)
+        {
+            pCRC->RunningCRC = crc_calcFinalCRC(pCRC->RunningCRC, WORD_CRC_CALC);
+            pCRC->bComplete = TRUE;
+        }
+    }
+
+    return pCRC->bComplete;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE - ONLY ACCESSIBLE WITHIN THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * LogScan scans the whole descriptor log, finding the newest verified
+ * descriptor for a partition, the highest generation used for it, the last
+ * corrupt slot and the next free slot.
+ *
+ * @param   Partition       Partition number to look for.
+ * @param   pScan           Pointer to structure to put results in.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void LogScan(const uint16_t Partition, ImageVerifyScan_t* const pScan)
+{
+    uint16_t    slot_words[IMAGE_VERIFY_SLOT_WORDS];
+    uint32_t    slot;
+    uint32_t    generation;
+    uint16_t    word_index;
+    bool_t      b_slot_blank;
+
+    pScan->bFound = FALSE;
+    pScan->FoundSlot = 0u;
+    pScan->HighestGeneration = 0u;
+    pScan->bCorruptSlotFound = FALSE;
+    pScan->LastCorruptSlot = 0u;
+    pScan->NextFreeSlot = 0u;
+
+    for (slot = 0u; slot < IMAGE_VERIFY_NUMBER_OF_SLOTS; slot++)
+    {
+        SlotRead(slot, &slot_words[0]);
+
+        b_slot_blank = TRUE;
+        for (word_index = 0u; word_index < IMAGE_VERIFY_SLOT_WORDS; word_index++)
+        {
+            if (slot_words[word_index] != IMAGE_VERIFY_BLANK_WORD)
+            {
+                b_slot_blank = FALSE;
+            }
+        }
+
+        if (b_slot_blank == FALSE)
+        {
+            pScan->NextFreeSlot = slot + 1u;
+
+            if (SlotBodyIsValid(&slot_words[0]) == FALSE)
+            {
+                pScan->bCorruptSlotFound = TRUE;
+                pScan->LastCorruptSlot = slot;
+            }
+            else if (slot_words[SLOT_PARTITION] == Partition)
+            {
+                //lint -e{921} Cast to uint32_t
+                generation = ((uint32_t)slot_words[SLOT_GENERATION_MSW] << 16)
+                             | (uint32_t)slot_words[SLOT_GENERATION_LSW];
+
+                // Retired descriptors still count towards the generation.
+                if (generation >= pScan->HighestGeneration)
+                {
+                    pScan->HighestGeneration = generation;
+
+                    if (slot_words[SLOT_MARKER] == IMAGE_VERIFY_MARKER_VERIFIED)
+                    {
+                        pScan->bFound = TRUE;
+                        pScan->FoundSlot = slot;
+                        pScan->Descriptor.Partition = Partition;
+                        pScan->Descriptor.Generation = generation;
+                        //lint -e{921} Cast to uint32_t
+                        pScan->Descriptor.LengthInWords = ((uint32_t)slot_words[SLOT_LENGTH_MSW] << 16)
+                                                          | (uint32_t)slot_words[SLOT_LENGTH_LSW];
+                        pScan->Descriptor.ImageCRC = slot_words[SLOT_IMAGE_CRC];
+                    }
+                    else
+                    {
+                        // A newer generation which isn't verified means
+                        // that anything older is stale.
+                        pScan->bFound = FALSE;
+                    }
+                }
+            }
+            else
+            {
+                // Descriptor for another partition - nothing to do.
+            }
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * SlotRead reads all words of a descriptor slot from the flash.
+ *
+ * @param   Slot            Slot number to read.
+ * @param   pSlotWords      Pointer to buffer of IMAGE_VERIFY_SLOT_WORDS words.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void SlotRead(const uint32_t Slot, uint16_t* const pSlotWords)
+{
+    uint32_t    slot_address;
+    uint16_t    word_index;
+
+    slot_address = SlotAddressGet(Slot);
+
+    for (word_index = 0u; word_index < IMAGE_VERIFY_SLOT_WORDS; word_index++)
+    {
+        pSlotWords[word_index] = genericIO_16bitRead(slot_address + word_index);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * SlotBodyIsValid checks the CRC over the body of a descriptor slot.
+ *
+ * @param   pSlotWords      Pointer to buffer of IMAGE_VERIFY_SLOT_WORDS words.
+ * @retval  bool_t          TRUE if CRC is OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t SlotBodyIsValid(const uint16_t* const pSlotWords)
+{
+    uint16_t    calculated_crc;
+    bool_t      b_body_valid = FALSE;
+
+    calculated_crc = CRC_CCITTCalculate(&pSlotWords[SLOT_PARTITION],
+                                        IMAGE_VERIFY_BODY_WORDS,
+                                        IMAGE_VERIFY_CRC_SEED);
+
+    if (calculated_crc == pSlotWords[SLOT_DESCRIPTOR_CRC])
+    {
+        b_body_valid = TRUE;
+    }
+
+    return b_body_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * SlotAddressGet returns the flash address of a descriptor slot.
+ *
+ * @param   Slot            Slot number.
+ * @retval  uint32_t        Flash address of the slot.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t SlotAddressGet(const uint32_t Slot)
+{
+    return (uint32_t)IMAGE_DESCRIPTOR_START_ADDRESS
+            + (Slot * IMAGE_VERIFY_SLOT_WORDS);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
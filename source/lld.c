@@ -2086,6 +2086,38 @@ ADDRESS offset        /* address offset from base address */
 
   return(data);
 }
+
+/******************************************************************************
+*
+* lld_BlockReadOp - Read a block of the memory array
+*
+* Reads number_of_words consecutive words starting at offset.  Where the
+* platform provides a burst read (FLASH_BLOCK_RD) the device is selected once
+* for the whole block, otherwise this falls back to one FLASH_RD per word.
+* The block must not run past the end of the device.
+*
+* RETURNS: void
+*
+*/
+void lld_BlockReadOp
+(
+FLASHDATA * base_addr,    /* device base address is system */
+ADDRESS offset,           /* address offset from base address */
+ADDRESS number_of_words,  /* number of words to read */
+FLASHDATA * data_buf      /* buffer to put the read data in */
+)
+{
+#ifdef FLASH_BLOCK_RD
+  FLASH_BLOCK_RD(base_addr, offset, number_of_words, data_buf);
+#else
+  ADDRESS i;
+
+  for (i = 0; i < number_of_words; i++)
+  {
+    data_buf[i] = FLASH_RD(base_addr, offset + i);
+  }
+#endif
+}
 #endif /* LLD_READ_OP */
 
 #ifdef LLD_WRITE_BUFFER_OP
@@ -2236,11 +2268,23 @@ FLASHDATA *data_buf   /* buffer containing data to program */
 }
 #endif /* LLD_STATUS_REG */
 
-DEVSTATUS lld_WriteByteBufferProgramOp
+/******************************************************************************
+*
+* lld_WriteByteBufferCmd - Loads the write buffer from an 8 bit data buffer
+*                          and issues the Program Buffer to Flash command,
+*                          without waiting for the program to finish.
+*
+* This lets the caller load the write buffer of another device while this
+* one is programming.  Poll at the returned offset for completion.
+*
+* RETURNS: ADDRESS - offset of the last word loaded
+*
+*/
+ADDRESS lld_WriteByteBufferCmd
 (
 FLASHDATA * base_addr,          /* device base address is system */
 ADDRESS offset,                 /* address offset from base address */
-WORDCOUNT word_count,           /* number of WORDS to program */
+WORDCOUNT word_count,           /* number of WORDS to program, not zero */
 const BYTE * const p_data_buf   /* buffer containing data to program as BYTES */
 )
 {
@@ -2248,7 +2292,6 @@ const BYTE * const p_data_buf   /* buffer containing data to program as BYTES */
     ADDRESS         current_offset;
     ADDRESS         end_offset;
     FLASHDATA       wcount;
-    FLASHDATA       status_reg;
     FLASHDATA       temp_write;
     LLD_UINT32      write_offset = 0u;
 
@@ -2257,12 +2300,6 @@ const BYTE * const p_data_buf   /* buffer containing data to program as BYTES */
     end_offset       = offset + word_count - 1;
     last_loaded_addr = offset;
 
-    /* don't try with a count of zero */
-    if (!word_count)
-    {
-      return(DEV_NOT_BUSY);
-    }
-
     /* Issue Load Write Buffer Command Sequence */
     lld_WriteToBufferCmd(base_addr, offset);
 
@@ -2298,6 +2335,28 @@ const BYTE * const p_data_buf   /* buffer containing data to program as BYTES */
     /* Issue Program Buffer to Flash command */
     lld_ProgramBufferToFlashCmd(base_addr, offset);
 
+    return(last_loaded_addr);
+}
+
+DEVSTATUS lld_WriteByteBufferProgramOp
+(
+FLASHDATA * base_addr,          /* device base address is system */
+ADDRESS offset,                 /* address offset from base address */
+WORDCOUNT word_count,           /* number of WORDS to program */
+const BYTE * const p_data_buf   /* buffer containing data to program as BYTES */
+)
+{
+    ADDRESS         last_loaded_addr;
+    FLASHDATA       status_reg;
+
+    /* don't try with a count of zero */
+    if (!word_count)
+    {
+      return(DEV_NOT_BUSY);
+    }
+
+    last_loaded_addr = lld_WriteByteBufferCmd(base_addr, offset, word_count, p_data_buf);
+
     /* Poll with no initial timeout so we use the callback function instead. */
     status_reg = lld_PollWithTimeout(base_addr, last_loaded_addr, 0u);
 
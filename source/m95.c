@@ -13,6 +13,7 @@
 #include "common_data_types.h"
 #include "m95.h"
 #include "spi.h"
+#include "timer.h"
 #include "m95_prv.h"
 
 
@@ -31,7 +32,8 @@
 
 #define M95_ID_PAGE_MAX_ADDRESS     0x000000FFu ///< Max page address.
 #define M95_WIP_BIT_MASK            0x0001u     ///< Work In Progress bit mask.
-#define M95_MAX_PAGE_SIZE           256u        ///< Maximum possible page size.
+#define M95_HEADER_MAX_BYTES        4u          ///< Instruction and 24 bit address.
+#define M95_PAGE_WRITE_TIMEOUT_MS   10u         ///< Longest a page write may take (tW is 5ms).
 
 
 // ----------------------------------------------------------------------------
@@ -41,7 +43,32 @@ static EM95PollStatus_t local_memcpy(uint32_t StartAddress,
                                      uint32_t NumberOfWrites,
                                      const uint8_t * p_source_buffer);
 
-static void SendAddressToDevice(const uint32_t Address);
+static uint32_t CommandHeaderBuild(const uint8_t Command,
+                                   const uint32_t Address,
+                                   uint8_t * const p_header);
+
+static EM95PollStatus_t cache_page_add(const uint32_t StartAddress,
+                                       const uint32_t NumberOfWrites,
+                                       const uint8_t * const p_source_buffer);
+
+static bool_t cache_read(const uint32_t StartAddress,
+                         const uint32_t NumberOfReads,
+                         uint8_t * const p_dest_buffer);
+
+static void cache_overlay(const uint32_t StartAddress,
+                          const uint32_t NumberOfReads,
+                          uint8_t * const p_dest_buffer);
+
+static bool_t cache_range_check(const uint32_t StartAddress,
+                                const uint32_t NumberOfReads);
+
+static bool_t cache_write_done_check(EM95PollStatus_t * const p_write_status);
+
+static EM95PollStatus_t cache_write_wait(void);
+
+static EM95PollStatus_t cache_status_take(void);
+
+static uint16_t cache_index_get(const uint16_t Position);
 
 
 // ----------------------------------------------------------------------------
@@ -58,6 +85,30 @@ static uint32_t mDeviceSizeInBytes;
 /// Volatile flag to force a timeout during the polling function.
 static volatile bool_t m_b_force_timeout = FALSE;
 
+/// Write-behind cache - a queue of pages, oldest first, waiting to be written.
+//lint -e{956} Doesn't need to be volatile.
+static m95_cache_page_t m_cache[M95_CACHE_PAGES];
+
+/// Index of the oldest page in the cache.
+//lint -e{956} Doesn't need to be volatile.
+static uint16_t m_cache_head = 0u;
+
+/// Number of pages in the cache.
+//lint -e{956} Doesn't need to be volatile.
+static uint16_t m_cache_count = 0u;
+
+/// TRUE while the device is writing the oldest page in the cache.
+//lint -e{956} Doesn't need to be volatile.
+static bool_t m_b_cache_writing = FALSE;
+
+/// Started when the device began writing the oldest page in the cache.
+//lint -e{956} Doesn't need to be volatile.
+static Timer_t m_cache_write_timer;
+
+/// First error from writing the cache back, until it is reported.
+//lint -e{956} Doesn't need to be volatile.
+static EM95PollStatus_t m_cache_status = M95_POLL_NO_WRITE_IN_PROGRESS;
+
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -72,8 +123,10 @@ static volatile bool_t m_b_force_timeout = FALSE;
 // ----------------------------------------------------------------------------
 void M95_WriteEnableCommandSend(void)
 {
+    const uint8_t   Command = M95_WRITE_ENABLE_COMMAND;
+
     SPI_EEPROMActiveSet();
-    SPI_Write(M95_WRITE_ENABLE_COMMAND);
+    SPI_TransferBlock(&Command, NULL, 1u);
     SPI_EEPROMInactiveSet();
 }
 
@@ -87,8 +140,10 @@ void M95_WriteEnableCommandSend(void)
 // ----------------------------------------------------------------------------
 void M95_WriteDisableCommandSend(void)
 {
+    const uint8_t   Command = M95_WRITE_DISABLE_COMMAND;
+
     SPI_EEPROMActiveSet();
-    SPI_Write(M95_WRITE_DISABLE_COMMAND);
+    SPI_TransferBlock(&Command, NULL, 1u);
     SPI_EEPROMInactiveSet();
 }
 
@@ -96,24 +151,22 @@ void M95_WriteDisableCommandSend(void)
 // ----------------------------------------------------------------------------
 /**
  * M95_ReadStatusRegCommandSend sends the read status register command and
- * then performs a single read of the status register.
+ * then performs a single read of the status register, as one two word
+ * transfer - the status comes back in the second word.
  * The SPISSTE bit is driven into the active and inactive state.
  *
- * Note the cast to uint8_t - the SPI_Read() function returns a 16 bit word
- * but the status is only 8 bits, so we throw the top 8 bits away.
- *
  */
 // ----------------------------------------------------------------------------
 uint8_t M95_ReadStatusRegCommandSend(void)
 {
-    uint8_t status;
+    const uint8_t   Command[2] = { M95_READ_STATUS_COMMAND, 0u };
+    uint8_t         Response[2];
 
     SPI_EEPROMActiveSet();
-    SPI_Write(M95_READ_STATUS_COMMAND);
-    status = (uint8_t)(SPI_Read(0u) & 0x00FFu); //lint !e921 Cast from uint16_t to uint8_t.
+    SPI_TransferBlock(&Command[0], &Response[0], 2u);
     SPI_EEPROMInactiveSet();
 
-    return status;
+    return Response[1];
 }
 
 
@@ -130,9 +183,10 @@ uint8_t M95_ReadStatusRegCommandSend(void)
 // ----------------------------------------------------------------------------
 void M95_WriteStatusRegCommandSend(const uint8_t NewStatus)
 {
+    const uint8_t   Command[2] = { M95_WRITE_STATUS_COMMAND, NewStatus };
+
     SPI_EEPROMActiveSet();
-    SPI_Write(M95_WRITE_STATUS_COMMAND);
-    SPI_Write(NewStatus);
+    SPI_TransferBlock(&Command[0], NULL, 2u);
     SPI_EEPROMInactiveSet();
 }
 
@@ -146,9 +200,7 @@ void M95_WriteStatusRegCommandSend(const uint8_t NewStatus)
  * bytes which are being read!
  * The SPISSTE bit is driven into the active and inactive state.
  *
- * Note the cast to uint8_t - the SPI_Read() function returns a 16 bit word
- * but the data width of the chip itself is only 8 bits, so we throw the top
- * 8 bits away.
+ * The data is read as a single FIFO burst, straight into the buffer.
  *
  * @param   StartAddress        Address to start reading from.
  * @param   NumberOfReads       Number of bytes to read from the device.
@@ -160,19 +212,17 @@ void M95_ReadCommandSend(const uint32_t StartAddress,
                             const uint32_t NumberOfReads,
                             uint8_t * const p_dest_buffer)
 {
-    uint32_t    Counter;
+    uint8_t     Header[M95_HEADER_MAX_BYTES];
+    uint32_t    HeaderBytes;
+
+    HeaderBytes = CommandHeaderBuild(M95_READ_COMMAND, StartAddress, &Header[0]);
 
     SPI_EEPROMActiveSet();
-    SPI_Write(M95_READ_COMMAND);
-    SendAddressToDevice(StartAddress);
+    SPI_TransferBlock(&Header[0], NULL, HeaderBytes);
 
     // Read required number of bytes and put in buffer.
     // NOTE - no boundary checking for pointer!
-    for (Counter = 0u; Counter < NumberOfReads; Counter++)
-    {
-        //lint -e{921} Cast from uint16_t to uint8_t.
-        p_dest_buffer[Counter] = (uint8_t)(SPI_Read(0u) & 0x00FFu);
-    }
+    SPI_TransferBlock(NULL, p_dest_buffer, NumberOfReads);
 
     SPI_EEPROMInactiveSet();
 }
@@ -198,18 +248,17 @@ void M95_WriteCommandSend(const uint32_t StartAddress,
                             const uint32_t NumberOfWrites,
                             const uint8_t * const p_source_buffer)
 {
-    uint32_t    Counter;
+    uint8_t     Header[M95_HEADER_MAX_BYTES];
+    uint32_t    HeaderBytes;
+
+    HeaderBytes = CommandHeaderBuild(M95_WRITE_COMMAND, StartAddress, &Header[0]);
 
     SPI_EEPROMActiveSet();
-    SPI_Write(M95_WRITE_COMMAND);
-    SendAddressToDevice(StartAddress);
+    SPI_TransferBlock(&Header[0], NULL, HeaderBytes);
 
     // Write required number of bytes into device.
     // NOTE - no boundary checking for device pages \ source overrun!
-    for (Counter = 0u; Counter < NumberOfWrites; Counter++)
-    {
-        SPI_Write(p_source_buffer[Counter]);
-    }
+    SPI_TransferBlock(p_source_buffer, NULL, NumberOfWrites);
 
     SPI_EEPROMInactiveSet();
 }
@@ -224,10 +273,6 @@ void M95_WriteCommandSend(const uint32_t StartAddress,
  * bytes which are being read!
  * The SPISSTE bit is driven into the active and inactive state.
  *
- * Note the cast to uint8_t - the SPI_Read() function returns a 16 bit word
- * but the data width of the chip itself is only 8 bits, so we throw the top
- * 8 bits away.
- *
  * @param   StartAddress        Address to start reading from.
  * @param   NumberOfReads       Number of bytes to read from the device.
  * @param   p_dest_buffer       Pointer to buffer to put read data in.
@@ -239,7 +284,8 @@ bool_t M95_ReadIDCommandSend(const uint32_t StartAddress,
                                 const uint32_t NumberOfReads,
                                 uint8_t * const p_dest_buffer)
 {
-    uint32_t    Counter;
+    uint8_t     Header[M95_HEADER_MAX_BYTES];
+    uint32_t    HeaderBytes;
     bool_t      ReturnStatus = TRUE;
 
     // If any condition which would mean that we try and read beyond the end of
@@ -252,18 +298,14 @@ bool_t M95_ReadIDCommandSend(const uint32_t StartAddress,
     }
     else
     {
-        SPI_EEPROMActiveSet();
-        SPI_Write(M95_READ_ID_PAGE_COMMAND);
+        HeaderBytes = CommandHeaderBuild(M95_READ_ID_PAGE_COMMAND, StartAddress, &Header[0]);
 
-        SendAddressToDevice(StartAddress);
+        SPI_EEPROMActiveSet();
+        SPI_TransferBlock(&Header[0], NULL, HeaderBytes);
 
         // Read required number of bytes and put in buffer.
         // NOTE - no boundary checking for pointer!
-        for (Counter = 0u; Counter < NumberOfReads; Counter++)
-        {
-            //lint -e{921} Cast from uint16_t to uint8_t.
-            p_dest_buffer[Counter] = (uint8_t)(SPI_Read(0u) & 0x00FFu);
-        }
+        SPI_TransferBlock(NULL, p_dest_buffer, NumberOfReads);
 
         SPI_EEPROMInactiveSet();
     }
@@ -327,17 +369,107 @@ EM95PollStatus_t M95_WriteCompletePoll(void)
  * we could just have done the same thing to ReadCommandSend, but this seems
  * tidier).
  *
+ * Data still in the write-behind cache is newer than the device, so a read
+ * which only wants cached data is served from the cache without touching the
+ * device.  Otherwise the device is read (once it has finished writing the
+ * current page - it can't be read during a write cycle) and any cached data
+ * is copied over the top.  If the write doesn't finish, nothing is read.
+ *
+ * @note
+ * As the data may come from the cache, this can't be used to check that data
+ * has been written into the device - use M95_VerifyRead for that.
+ *
+ * @param   StartAddress        Initial address to start reading from.
+ * @param   NumberOfReads       Number of bytes to read from the device.
+ * @param   p_dest_buffer       Pointer to buffer to put data in.
+ * @retval  EM95PollStatus_t    Enumerated return value.
+ *
+ */
+// ----------------------------------------------------------------------------
+EM95PollStatus_t M95_BlockRead(const uint32_t StartAddress,
+                               const uint32_t NumberOfReads,
+                               uint8_t * const p_dest_buffer)
+{
+    EM95PollStatus_t    M95PollStatus = M95_POLL_NO_WRITE_IN_PROGRESS;
+
+#ifndef UNIT_TEST_BUILD
+    m_b_force_timeout = FALSE;
+#endif
+
+    if (!cache_read(StartAddress, NumberOfReads, p_dest_buffer))
+    {
+        M95PollStatus = cache_write_wait();
+
+        if (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
+        {
+            M95_ReadCommandSend(StartAddress, NumberOfReads, p_dest_buffer);
+
+            cache_overlay(StartAddress, NumberOfReads, p_dest_buffer);
+
+            // Carry on with the next page, if the wait finished one.
+            (void)M95_FlushStep();
+        }
+    }
+
+    return M95PollStatus;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * M95_VerifyRead reads data back from the device itself, to check a write.
+ * Any pages in the write-behind cache which hold part of the data are written
+ * into the device first, and then the device is read without the cache.
+ *
+ * An error writing the cache back is returned here (and nothing is read) as
+ * the device might not hold the data which was written.
+ *
  * @param   StartAddress        Initial address to start reading from.
  * @param   NumberOfReads       Number of bytes to read from the device.
  * @param   p_dest_buffer       Pointer to buffer to put data in.
+ * @retval  EM95PollStatus_t    Enumerated return value.
  *
  */
 // ----------------------------------------------------------------------------
-void M95_BlockRead(const uint32_t StartAddress,
-                    const uint32_t NumberOfReads,
-                    uint8_t * const p_dest_buffer)
+EM95PollStatus_t M95_VerifyRead(const uint32_t StartAddress,
+                                const uint32_t NumberOfReads,
+                                uint8_t * const p_dest_buffer)
 {
-    M95_ReadCommandSend(StartAddress, NumberOfReads, p_dest_buffer);
+    EM95PollStatus_t    M95PollStatus = M95_POLL_NO_WRITE_IN_PROGRESS;
+
+#ifndef UNIT_TEST_BUILD
+    m_b_force_timeout = FALSE;
+#endif
+
+    // The cache is written back oldest first, so keep going until none of
+    // the pages left hold any of the data.
+    while (cache_range_check(StartAddress, NumberOfReads))
+    {
+        (void)M95_FlushStep();
+
+        if (m_b_force_timeout)
+        {
+            M95PollStatus = M95_POLL_TIMEOUT_EXCEEDED;
+            break;
+        }
+    }
+
+    if (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
+    {
+        M95PollStatus = cache_write_wait();
+    }
+
+    if (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
+    {
+        M95PollStatus = cache_status_take();
+    }
+
+    if (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
+    {
+        M95_ReadCommandSend(StartAddress, NumberOfReads, p_dest_buffer);
+    }
+
+    return M95PollStatus;
 }
 
 
@@ -351,6 +483,9 @@ void M95_BlockRead(const uint32_t StartAddress,
  * Note that this function doesn't 'know' about any address boundaries - this
  * is dealt with by the next layer up in the code.
  *
+ * This write goes straight into the device, so the write-behind cache is
+ * flushed first - otherwise older cached data could be written over it.
+ *
  * @param   StartAddress        Initial address to start writing to.
  * @param   NumberOfWrites      Number of bytes to write into the device.
  * @param   p_source_buffer     Pointer to buffer containing source data.
@@ -364,9 +499,14 @@ EM95PollStatus_t M95_BlockWrite(const uint32_t StartAddress,
 {
     EM95PollStatus_t    M95PollStatus;
 
-    M95_WriteEnableCommandSend();
-    M95_WriteCommandSend(StartAddress, NumberOfWrites, p_source_buffer);
-    M95PollStatus = M95_WriteCompletePoll();
+    M95PollStatus = M95_Flush();
+
+    if (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
+    {
+        M95_WriteEnableCommandSend();
+        M95_WriteCommandSend(StartAddress, NumberOfWrites, p_source_buffer);
+        M95PollStatus = M95_WriteCompletePoll();
+    }
 
     return M95PollStatus;
 }
@@ -375,7 +515,17 @@ EM95PollStatus_t M95_BlockWrite(const uint32_t StartAddress,
 // ----------------------------------------------------------------------------
 /**
  * local_memcpy attempts to mimic the standard memcpy function for the device.
- * Data is written into the device, aligning to page boundaries as required.
+ * Data is split up on page boundaries and put into the write-behind cache,
+ * and the first page write is started - the rest are written in the
+ * background by M95_FlushStep(), each one as soon as the last has finished.
+ * The caller only waits if the cache is full, until the device has written
+ * enough pages to make room.
+ *
+ * @note
+ * A return of M95_POLL_NO_WRITE_IN_PROGRESS means that all of the data has
+ * been accepted - use M95_Flush() to wait until it is in the device.  An error
+ * writing earlier data back is returned by the next call to this, M95_Flush()
+ * or M95_VerifyRead().
  *
  * @param   StartAddress        Initial address to start writing to.
  * @param   NumberOfWrites      Number of bytes to write into the device.
@@ -394,58 +544,40 @@ static EM95PollStatus_t local_memcpy(uint32_t StartAddress,
     uint32_t            InternalWriteCounter;
     uint32_t            write_offset = 0u;
 
-    // Setup address mask and work out whether start address is within a page
-    // or appears nicely on a page boundary.
+#ifndef UNIT_TEST_BUILD
+    m_b_force_timeout = FALSE;
+#endif
+
     AddressMask = mPageSizeInBytes - 1u;
-    StartOffsetInPage = StartAddress & AddressMask;
 
-    // If the address starts somewhere within a block, then write as many words
-    // as are required to align the data (or just write the required words, if
-    // there aren't more than will fill the block).
-    if (StartOffsetInPage != 0u)
+    // Cache the data a page at a time - the first and last pages might only
+    // be partly written.
+    while ( (NumberOfWrites != 0u)
+            && (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS) )
     {
-        // Setup internal write counter for correct number of words to either
-        // fill the first page, or just as many words as are required.
-        if (NumberOfWrites < (mPageSizeInBytes - StartOffsetInPage) )
+        StartOffsetInPage    = StartAddress & AddressMask;
+        InternalWriteCounter = mPageSizeInBytes - StartOffsetInPage;
+
+        if (NumberOfWrites < InternalWriteCounter)
         {
             InternalWriteCounter = NumberOfWrites;
         }
-        else
-        {
-            InternalWriteCounter = mPageSizeInBytes - StartOffsetInPage;
-        }
 
-        // Write first page (might be only page).
-        M95PollStatus = M95_BlockWrite(StartAddress,
+        M95PollStatus = cache_page_add(StartAddress,
                                        InternalWriteCounter,
                                        &p_source_buffer[write_offset]);
 
-        // Update remaining number of bytes to write, start address and buffer pointer.
         NumberOfWrites  -= InternalWriteCounter;
         StartAddress    += InternalWriteCounter;
         write_offset    += InternalWriteCounter;
     }
 
-    // Having aligned the data to the page size, carry on writing in page sized
-    // chunks (or skip this if there's less than a page to go).
-    while ( (NumberOfWrites >= mPageSizeInBytes)
-            && (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS) )
-    {
-        M95PollStatus   = M95_BlockWrite(StartAddress,
-                                         mPageSizeInBytes,
-                                         &p_source_buffer[write_offset]);
-
-        NumberOfWrites  -= mPageSizeInBytes;
-        StartAddress    += mPageSizeInBytes;
-        write_offset    += mPageSizeInBytes;
-    }
+    // Get the first page going.
+    (void)M95_FlushStep();
 
-    // If there's any more data to write (less than a page) then do it.
-    if ( (NumberOfWrites != 0u) && (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS) )
+    if (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
     {
-        M95PollStatus = M95_BlockWrite(StartAddress,
-                                       NumberOfWrites,
-                                       &p_source_buffer[write_offset]);
+        M95PollStatus = cache_status_take();
     }
 
     return M95PollStatus;
@@ -549,10 +681,89 @@ EM95PollStatus_t M95_DeviceErase(void)
         Counter--;
     }
 
+    // Don't report the device as erased until it is.
+    if (PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
+    {
+        PollStatus = M95_Flush();
+    }
+
     return PollStatus;
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * M95_FlushStep moves the write-behind cache on, without waiting for the
+ * device - if the page being written has finished it is dropped from the
+ * cache, and the next page write is started straight away.  This should be
+ * called whenever there is nothing else to do.
+ *
+ * A page which the device hasn't finished writing after
+ * M95_PAGE_WRITE_TIMEOUT_MS is dropped as well, and the error is kept for the
+ * next call to M95_memcpy, M95_Flush or M95_VerifyRead to return.
+ *
+ * @retval  bool_t      TRUE if there are still pages waiting to be written.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t M95_FlushStep(void)
+{
+    const m95_cache_page_t* p_page;
+    EM95PollStatus_t        WriteStatus = M95_POLL_NO_WRITE_IN_PROGRESS;
+
+    if ( (cache_write_done_check(&WriteStatus)) && (m_cache_count != 0u) )
+    {
+        p_page = &m_cache[m_cache_head];
+
+        M95_WriteEnableCommandSend();
+        M95_WriteCommandSend(p_page->page_address + p_page->first_offset,
+                             p_page->end_offset - p_page->first_offset,
+                             &p_page->data[p_page->first_offset]);
+
+        Timer_TimerSet(&m_cache_write_timer, M95_PAGE_WRITE_TIMEOUT_MS);
+        m_b_cache_writing = TRUE;
+    }
+
+    return (m_cache_count != 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * M95_Flush waits until everything in the write-behind cache has been written
+ * into the device.  Like M95_WriteCompletePoll, this can be forced to time out.
+ *
+ * @retval  EM95PollStatus_t    Timeout, or the first error writing the cache
+ *                              back, if any.
+ *
+ */
+// ----------------------------------------------------------------------------
+EM95PollStatus_t M95_Flush(void)
+{
+    EM95PollStatus_t    M95PollStatus = M95_POLL_NO_WRITE_IN_PROGRESS;
+
+#ifndef UNIT_TEST_BUILD
+    m_b_force_timeout = FALSE;
+#endif
+
+    while (M95_FlushStep())
+    {
+        if (m_b_force_timeout)
+        {
+            M95PollStatus = M95_POLL_TIMEOUT_EXCEEDED;
+            break;
+        }
+    }
+
+    if (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
+    {
+        M95PollStatus = cache_status_take();
+    }
+
+    return M95PollStatus;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * M95_ForceTimeoutFlagSet set the force timeout flag, which will force
@@ -600,6 +811,24 @@ void M95_MemcpyFunctionPtrReset_TDD(void)
     //lint -e{546} Suspicious use of & - it's correct, we want the address.
     M95_memcpy = &local_memcpy;
 }
+
+
+// ----------------------------------------------------------------------------
+/**
+ * M95_CacheDiscard_TDD throws away anything in the write-behind cache, as
+ * happens at power up.
+ *
+ * This is only required when unit testing, hence the conditional compilation.
+ *
+ */
+// ----------------------------------------------------------------------------
+void M95_CacheDiscard_TDD(void)
+{
+    m_cache_head      = 0u;
+    m_cache_count     = 0u;
+    m_b_cache_writing = FALSE;
+    m_cache_status    = M95_POLL_NO_WRITE_IN_PROGRESS;
+}
 #endif
 
 
@@ -609,37 +838,402 @@ void M95_MemcpyFunctionPtrReset_TDD(void)
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 /**
- * SendAddressToDevice writes the 24 bit address to the device, as 3 x writes
- * (bits 23:16, 16:8 and 7:0)
+ * CommandHeaderBuild builds the instruction and address which start a read or
+ * write, so that they can be sent as one block.  The address is 24 bits
+ * (bits 23:16, 16:8 and 7:0) on the larger devices, 16 bits otherwise.
  *
  * @warning
  * This code doesn't cater for use on the very small devices (<= 4kbit) which
  * use an 8 bit address but add an extra address bit into the instruction word.
  *
- * @param   Address     24 bit address to write.
- *
+ * @param   Command     Instruction to send.
+ * @param   Address     24 bit address to send.
+ * @param   p_header    Pointer to buffer to build the header in (M95_HEADER_MAX_BYTES).
+ * @retval  uint32_t    Number of bytes in the header.
  *
  */
 // ----------------------------------------------------------------------------
-static void SendAddressToDevice(const uint32_t Address)
+static uint32_t CommandHeaderBuild(const uint8_t Command,
+                                   const uint32_t Address,
+                                   uint8_t * const p_header)
 {
-    uint16_t    MaskedAddress;
+    uint32_t    HeaderBytes = 0u;
+
+    p_header[HeaderBytes] = Command;
+    HeaderBytes++;
 
     if (mDeviceSizeInBytes > 65536u)
     {
         // Generate top 8 address bits - shift down by 16 and mask off.
-        //lint -e{921} Cast from uint32_t to uint16_t, but it's ok.
-        MaskedAddress = (uint16_t)((Address >> 16u) & 0x000000FFu);
-        SPI_Write(MaskedAddress);
+        //lint -e{921} Cast from uint32_t to uint8_t, but it's ok.
+        p_header[HeaderBytes] = (uint8_t)((Address >> 16u) & 0x000000FFu);
+        HeaderBytes++;
     }
 
     // Generate middle 8 address bits - shift down by 8 and mask off.
-    //lint -e{921} Cast from uint32_t to uint16_t, but it's ok.
-    MaskedAddress = (uint16_t)((Address >> 8u) & 0x000000FFu);
-    SPI_Write(MaskedAddress);
+    //lint -e{921} Cast from uint32_t to uint8_t, but it's ok.
+    p_header[HeaderBytes] = (uint8_t)((Address >> 8u) & 0x000000FFu);
+    HeaderBytes++;
 
     // Generate bottom 8 address bits - just mask off.
-    //lint -e{921} Cast from uint32_t to uint16_t, but it's ok.
-    MaskedAddress = (uint16_t)(Address & 0x000000FFu);
-    SPI_Write(MaskedAddress);
+    //lint -e{921} Cast from uint32_t to uint8_t, but it's ok.
+    p_header[HeaderBytes] = (uint8_t)(Address & 0x000000FFu);
+    HeaderBytes++;
+
+    return HeaderBytes;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_page_add puts data for one device page into the write-behind cache.
+ * If the newest cached copy of the page touches the data (and isn't already
+ * being written) the data is merged into it, otherwise the page goes on the
+ * end of the queue, waiting for room if the cache is full.
+ *
+ * @param   StartAddress        Initial address to write to.
+ * @param   NumberOfWrites      Number of bytes to write, all in the same page.
+ * @param   p_source_buffer     Pointer to buffer containing source data.
+ * @retval  EM95PollStatus_t    Enumerated return value.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EM95PollStatus_t cache_page_add(const uint32_t StartAddress,
+                                       const uint32_t NumberOfWrites,
+                                       const uint8_t * const p_source_buffer)
+{
+    EM95PollStatus_t    M95PollStatus = M95_POLL_NO_WRITE_IN_PROGRESS;
+    m95_cache_page_t*   p_page = NULL;
+    uint32_t            PageAddress;
+    uint32_t            FirstOffset;
+    uint32_t            EndOffset;
+    uint32_t            Counter;
+    uint16_t            Position;
+    bool_t              b_found = FALSE;
+
+    PageAddress = StartAddress & ~(mPageSizeInBytes - 1u);
+    FirstOffset = StartAddress - PageAddress;
+    EndOffset   = FirstOffset + NumberOfWrites;
+
+    // Only the newest copy of the page can be merged into, so that the pages
+    // still go into the device in the order they were written.
+    for (Position = m_cache_count; (Position != 0u) && (!b_found); Position--)
+    {
+        if (m_cache[cache_index_get(Position - 1u)].page_address == PageAddress)
+        {
+            b_found = TRUE;
+
+            if ( ((Position != 1u) || (!m_b_cache_writing))
+                    && (FirstOffset <= m_cache[cache_index_get(Position - 1u)].end_offset)
+                    && (EndOffset >= m_cache[cache_index_get(Position - 1u)].first_offset) )
+            {
+                p_page = &m_cache[cache_index_get(Position - 1u)];
+            }
+        }
+    }
+
+    if (p_page == NULL)
+    {
+        // Wait for the device to make room.
+        while (m_cache_count >= M95_CACHE_PAGES)
+        {
+            (void)M95_FlushStep();
+
+            if (m_b_force_timeout)
+            {
+                M95PollStatus = M95_POLL_TIMEOUT_EXCEEDED;
+                break;
+            }
+        }
+
+        if (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
+        {
+            p_page = &m_cache[cache_index_get(m_cache_count)];
+
+            p_page->page_address = PageAddress;
+            p_page->first_offset = FirstOffset;
+            p_page->end_offset   = EndOffset;
+
+            m_cache_count++;
+        }
+    }
+
+    if (p_page != NULL)
+    {
+        for (Counter = 0u; Counter < NumberOfWrites; Counter++)
+        {
+            p_page->data[FirstOffset + Counter] = p_source_buffer[Counter];
+        }
+
+        if (FirstOffset < p_page->first_offset)
+        {
+            p_page->first_offset = FirstOffset;
+        }
+
+        if (EndOffset > p_page->end_offset)
+        {
+            p_page->end_offset = EndOffset;
+        }
+    }
+
+    return M95PollStatus;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_read copies data out of the write-behind cache, if every byte asked
+ * for is in the newest cached copy of its page.
+ *
+ * @param   StartAddress        Initial address to read from.
+ * @param   NumberOfReads       Number of bytes to read.
+ * @param   p_dest_buffer       Pointer to buffer to put data in.
+ * @retval  bool_t              TRUE if all of the data came from the cache.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t cache_read(const uint32_t StartAddress,
+                         const uint32_t NumberOfReads,
+                         uint8_t * const p_dest_buffer)
+{
+    const m95_cache_page_t* p_page;
+    uint32_t                Address = StartAddress;
+    uint32_t                ReadsRemaining = NumberOfReads;
+    uint32_t                read_offset = 0u;
+    uint32_t                PageAddress;
+    uint32_t                FirstOffset;
+    uint32_t                InternalReadCounter;
+    uint32_t                Counter;
+    uint16_t                Position;
+    bool_t                  b_found;
+    bool_t                  b_hit = (m_cache_count != 0u);
+
+    while ( (ReadsRemaining != 0u) && (b_hit) )
+    {
+        PageAddress         = Address & ~(mPageSizeInBytes - 1u);
+        FirstOffset         = Address - PageAddress;
+        InternalReadCounter = mPageSizeInBytes - FirstOffset;
+
+        if (ReadsRemaining < InternalReadCounter)
+        {
+            InternalReadCounter = ReadsRemaining;
+        }
+
+        // Newest copy first - an older copy might have been written over.
+        b_found = FALSE;
+        b_hit   = FALSE;
+
+        for (Position = m_cache_count; (Position != 0u) && (!b_found); Position--)
+        {
+            p_page = &m_cache[cache_index_get(Position - 1u)];
+
+            if ( (p_page->page_address == PageAddress)
+                    && (FirstOffset < p_page->end_offset)
+                    && ((FirstOffset + InternalReadCounter) > p_page->first_offset) )
+            {
+                b_found = TRUE;
+
+                if ( (FirstOffset >= p_page->first_offset)
+                        && ((FirstOffset + InternalReadCounter) <= p_page->end_offset) )
+                {
+                    for (Counter = 0u; Counter < InternalReadCounter; Counter++)
+                    {
+                        p_dest_buffer[read_offset + Counter] = p_page->data[FirstOffset + Counter];
+                    }
+
+                    b_hit = TRUE;
+                }
+            }
+        }
+
+        ReadsRemaining  -= InternalReadCounter;
+        Address         += InternalReadCounter;
+        read_offset     += InternalReadCounter;
+    }
+
+    return b_hit;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_overlay copies anything in the write-behind cache over data which has
+ * been read from the device, oldest first so that the newest data wins.
+ *
+ * @param   StartAddress        Initial address the data was read from.
+ * @param   NumberOfReads       Number of bytes read.
+ * @param   p_dest_buffer       Pointer to buffer holding the data read.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void cache_overlay(const uint32_t StartAddress,
+                          const uint32_t NumberOfReads,
+                          uint8_t * const p_dest_buffer)
+{
+    const m95_cache_page_t* p_page;
+    uint32_t                CacheStart;
+    uint32_t                CacheEnd;
+    uint32_t                Address;
+    uint16_t                Position;
+
+    for (Position = 0u; Position < m_cache_count; Position++)
+    {
+        p_page = &m_cache[cache_index_get(Position)];
+
+        CacheStart = p_page->page_address + p_page->first_offset;
+        CacheEnd   = p_page->page_address + p_page->end_offset;
+
+        for (Address = CacheStart; Address < CacheEnd; Address++)
+        {
+            if ( (Address >= StartAddress) && (Address < (StartAddress + NumberOfReads)) )
+            {
+                p_dest_buffer[Address - StartAddress] = p_page->data[Address - p_page->page_address];
+            }
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_range_check checks whether any page in the write-behind cache holds
+ * data for part of a range of addresses.
+ *
+ * @param   StartAddress        Initial address of the range.
+ * @param   NumberOfReads       Number of bytes in the range.
+ * @retval  bool_t              TRUE if some of the range is still cached.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t cache_range_check(const uint32_t StartAddress,
+                                const uint32_t NumberOfReads)
+{
+    const m95_cache_page_t* p_page;
+    uint16_t                Position;
+    bool_t                  b_cached = FALSE;
+
+    for (Position = 0u; (Position < m_cache_count) && (!b_cached); Position++)
+    {
+        p_page = &m_cache[cache_index_get(Position)];
+
+        if ( ((p_page->page_address + p_page->first_offset) < (StartAddress + NumberOfReads))
+                && ((p_page->page_address + p_page->end_offset) > StartAddress) )
+        {
+            b_cached = TRUE;
+        }
+    }
+
+    return b_cached;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_write_done_check checks whether the device has finished writing the
+ * oldest page in the cache, and if so drops the page from the cache.  If the
+ * write has taken longer than M95_PAGE_WRITE_TIMEOUT_MS the page is dropped
+ * anyway, and the timeout is returned and kept in m_cache_status.
+ *
+ * @param   p_write_status  Set to M95_POLL_TIMEOUT_EXCEEDED if a page timed out.
+ * @retval  bool_t          TRUE if the device isn't writing a page.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t cache_write_done_check(EM95PollStatus_t * const p_write_status)
+{
+    uint8_t     StatusRegister;
+
+    if (m_b_cache_writing)
+    {
+        StatusRegister = M95_ReadStatusRegCommandSend();
+
+        if ( ((StatusRegister & M95_WIP_BIT_MASK) != 0u)
+                && (Timer_TimerExpiredCheck(&m_cache_write_timer)) )
+        {
+            *p_write_status = M95_POLL_TIMEOUT_EXCEEDED;
+
+            if (m_cache_status == M95_POLL_NO_WRITE_IN_PROGRESS)
+            {
+                m_cache_status = M95_POLL_TIMEOUT_EXCEEDED;
+            }
+
+            // Drop the page, as if it had been written.
+            StatusRegister = 0u;
+        }
+
+        if ((StatusRegister & M95_WIP_BIT_MASK) == 0u)
+        {
+            m_b_cache_writing = FALSE;
+
+            //lint -e{921} Cast to uint16_t - always less than M95_CACHE_PAGES.
+            m_cache_head = (uint16_t)((m_cache_head + 1u) % M95_CACHE_PAGES);
+            m_cache_count--;
+        }
+    }
+
+    return (!m_b_cache_writing);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_write_wait waits for the device to finish writing the current page,
+ * without starting the next one.  As with M95_WriteCompletePoll, the wait can
+ * be forced to time out - the page is then still being written.
+ *
+ * @retval  EM95PollStatus_t    M95_POLL_NO_WRITE_IN_PROGRESS if the device
+ *                              finished the page and can be read.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EM95PollStatus_t cache_write_wait(void)
+{
+    EM95PollStatus_t    M95PollStatus = M95_POLL_NO_WRITE_IN_PROGRESS;
+
+    while ( (!cache_write_done_check(&M95PollStatus))
+            && (M95PollStatus == M95_POLL_NO_WRITE_IN_PROGRESS) )
+    {
+        if (m_b_force_timeout)
+        {
+            M95PollStatus = M95_POLL_TIMEOUT_EXCEEDED;
+        }
+    }
+
+    return M95PollStatus;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_status_take returns the first error from writing the cache back since
+ * the last one was returned, and clears it.
+ *
+ * @retval  EM95PollStatus_t    Enumerated return value.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EM95PollStatus_t cache_status_take(void)
+{
+    const EM95PollStatus_t  M95PollStatus = m_cache_status;
+
+    m_cache_status = M95_POLL_NO_WRITE_IN_PROGRESS;
+
+    return M95PollStatus;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_index_get converts a position in the write-behind cache queue
+ * (0 is the oldest page) into an index into m_cache.
+ *
+ * @param   Position    Position in the queue.
+ * @retval  uint16_t    Index into m_cache.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t cache_index_get(const uint16_t Position)
+{
+    //lint -e{921} Cast to uint16_t - always less than M95_CACHE_PAGES.
+    return (uint16_t)((m_cache_head + Position) % M95_CACHE_PAGES);
 }
@@ -0,0 +1,310 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        m95_cache_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side benchmark of the M95 serial flash write-behind cache.
+ * @details
+ * Writes a range of the simulated serial flash (flash_sim.c) two ways, and
+ * measures each with the simulated time:
+ *
+ *  - Blocking - a page at a time with M95_BlockWrite, which waits for each
+ *    page write cycle before going on, as M95_memcpy used to.
+ *  - Cached - M95_memcpy, which returns once the data is in the cache.  Part
+ *    of the range is then written again, and the whole range read back (from
+ *    the cache), and then read back with a page either side (from the device,
+ *    with the cache over the top), before the cache is written back by calling
+ *    M95_FlushStep() with some idle time in between, as the loader would.
+ *
+ * After each write the range must hold the data written, and the cached write
+ * should take the same number of page write cycles as the blocking one.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs and resets the
+ * simulated devices, so the serial flash and SPI must have been set up
+ * (M95_DeviceSizeInitialise(), SPI_Open()) before it is run.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "m95.h"
+#include "flash_sim.h"
+#include "m95_cache_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define SERIAL_FLASH_BYTES          65536u      ///< Size of the simulated M95.
+#define SERIAL_FLASH_PAGE_BYTES     128u        ///< Page size of the simulated M95.
+
+#define DEFAULT_CONFIG              { 0x1000u, 1024u, 16u, 100u }
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   flash_check(const uint32_t address,
+                            const uint32_t number_of_bytes);
+
+static bool_t   read_check(const uint32_t address,
+                           const uint32_t number_of_bytes,
+                           const uint32_t data_address,
+                           const uint32_t data_bytes);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_data[M95_CACHE_SIM_MAX_BYTES];
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_read[M95_CACHE_SIM_MAX_BYTES + (2u * SERIAL_FLASH_PAGE_BYTES)];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * m95_cache_sim_config_default fills in the configuration for a 1k byte
+ * write (eight pages - a full cache), with 16 bytes written again.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void m95_cache_sim_config_default(m95_cache_sim_config_t * const p_config)
+{
+    const m95_cache_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * m95_cache_sim_run writes the range each way.
+ *
+ * @param   p_config    Pointer to the range to use.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t m95_cache_sim_run(const m95_cache_sim_config_t * const p_config,
+                         m95_cache_sim_result_t * const p_result)
+{
+    flash_sim_stats_t   stats;
+    uint32_t            address;
+    uint32_t            page_bytes;
+    uint32_t            patch_offset;
+    uint32_t            i;
+    uint64_t            start_ns;
+    bool_t              b_valid = FALSE;
+
+    if ( (p_config->write_bytes != 0u)
+            && (p_config->write_bytes <= M95_CACHE_SIM_MAX_BYTES)
+            && (p_config->patch_bytes <= (p_config->write_bytes / 2u))
+            && (p_config->address >= SERIAL_FLASH_PAGE_BYTES)
+            && ((p_config->address + p_config->write_bytes + SERIAL_FLASH_PAGE_BYTES)
+                    <= SERIAL_FLASH_BYTES) )
+    {
+        flash_sim_install();
+        flash_sim_reset();
+        b_valid = TRUE;
+    }
+
+    if (b_valid)
+    {
+        for (i = 0u; i < p_config->write_bytes; i++)
+        {
+            m_data[i] = (uint8_t)((i * 7u) ^ (i >> 8u));
+        }
+
+        /* The old way, waiting for each page. */
+        start_ns = flash_sim_time_ns_get();
+        address  = p_config->address;
+
+        while (address < (p_config->address + p_config->write_bytes))
+        {
+            page_bytes = SERIAL_FLASH_PAGE_BYTES - (address & (SERIAL_FLASH_PAGE_BYTES - 1u));
+
+            if (page_bytes > ((p_config->address + p_config->write_bytes) - address))
+            {
+                page_bytes = (p_config->address + p_config->write_bytes) - address;
+            }
+
+            (void)M95_BlockWrite(address, page_bytes, &m_data[address - p_config->address]);
+            address += page_bytes;
+        }
+
+        p_result->blocking_write_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        flash_sim_stats_get(&stats);
+        p_result->blocking_write_cycles = stats.m95_write_cycles;
+        p_result->b_data_matches = flash_check(p_config->address, p_config->write_bytes);
+
+        /* Through the cache, starting blank again. */
+        flash_sim_reset();
+
+        start_ns = flash_sim_time_ns_get();
+        if (M95_memcpy(p_config->address, p_config->write_bytes, &m_data[0])
+                != M95_POLL_NO_WRITE_IN_PROGRESS)
+        {
+            p_result->b_data_matches = FALSE;
+        }
+        p_result->cached_write_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        patch_offset = p_config->write_bytes / 2u;
+
+        for (i = patch_offset; i < (patch_offset + p_config->patch_bytes); i++)
+        {
+            m_data[i] = (uint8_t)~m_data[i];
+        }
+
+        if (p_config->patch_bytes != 0u)
+        {
+            (void)M95_memcpy(p_config->address + patch_offset, p_config->patch_bytes,
+                             &m_data[patch_offset]);
+        }
+
+        /* Read back before the write back - just the range, then with a page
+         * either side, which has to come from the device as well. */
+        p_result->b_cache_reads_match = read_check(p_config->address, p_config->write_bytes,
+                                                   p_config->address, p_config->write_bytes);
+
+        if (!read_check(p_config->address - SERIAL_FLASH_PAGE_BYTES,
+                        p_config->write_bytes + (2u * SERIAL_FLASH_PAGE_BYTES),
+                        p_config->address, p_config->write_bytes))
+        {
+            p_result->b_cache_reads_match = FALSE;
+        }
+
+        /* Write back in the idle time. */
+        p_result->flush_steps = 0u;
+        start_ns = flash_sim_time_ns_get();
+
+        while (M95_FlushStep())
+        {
+            p_result->flush_steps++;
+            flash_sim_time_advance(p_config->idle_us * 1000u);
+        }
+
+        p_result->flush_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        if ( (M95_Flush() != M95_POLL_NO_WRITE_IN_PROGRESS)
+                || (!flash_check(p_config->address, p_config->write_bytes)) )
+        {
+            p_result->b_data_matches = FALSE;
+        }
+
+        flash_sim_stats_get(&stats);
+        p_result->cached_write_cycles = stats.m95_write_cycles;
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * flash_check checks, straight from the simulated serial flash, that the
+ * range holds the data written.
+ *
+ * @param   address             First address to check.
+ * @param   number_of_bytes     Number of bytes to check.
+ * @retval  bool_t              TRUE if the range holds the data.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t flash_check(const uint32_t address,
+                          const uint32_t number_of_bytes)
+{
+    uint32_t    i;
+    bool_t      b_matches = TRUE;
+
+    (void)flash_sim_backdoor_read(STORAGE_DEVICE_SERIAL_FLASH, address,
+                                  number_of_bytes, &m_read[0]);
+
+    for (i = 0u; i < number_of_bytes; i++)
+    {
+        if (m_read[i] != m_data[i])
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * read_check reads through the driver, and checks that the data written is
+ * read back, with blank either side of it.
+ *
+ * @param   address             First address to read.
+ * @param   number_of_bytes     Number of bytes to read.
+ * @param   data_address        First address of the data written.
+ * @param   data_bytes          Number of bytes of data written.
+ * @retval  bool_t              TRUE if the read is as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t read_check(const uint32_t address,
+                         const uint32_t number_of_bytes,
+                         const uint32_t data_address,
+                         const uint32_t data_bytes)
+{
+    uint32_t    byte_address;
+    uint32_t    i;
+    uint8_t     expected;
+    bool_t      b_matches;
+
+    b_matches = (M95_BlockRead(address, number_of_bytes, &m_read[0])
+                    == M95_POLL_NO_WRITE_IN_PROGRESS);
+
+    for (i = 0u; i < number_of_bytes; i++)
+    {
+        byte_address = address + i;
+
+        if ( (byte_address >= data_address) && (byte_address < (data_address + data_bytes)) )
+        {
+            expected = m_data[byte_address - data_address];
+        }
+        else
+        {
+            expected = RS_CFG_BLANK_LOCATION_CONTAINS;
+        }
+
+        if (m_read[i] != expected)
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
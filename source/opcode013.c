@@ -2,23 +2,110 @@
  * @file        opcode013.c
 */
 #include "opcode013.h"
+#include "opcode204.h"
 #include "rsapi.h"
 #include "rspartition.h"
 #include "tool_specific_config.h"
 
+/// Partition being formatted, or whose result is waiting to be reported.
+static uint8_t      mFormatPartition = 0u;
+
+/// A format started by opcode 13 is still going.
+static bool_t       mbFormatRunning = FALSE;
+
+/// A format finished between messages, and the next opcode 13 for the same
+/// partition gets the result instead of starting another one.
+static bool_t       mbFormatResultPending = FALSE;
+
+static rs_error_t   mFormatResult = RS_ERR_NO_ERROR;
+
+static void opcode13_FormatFinish(rs_error_t FormatStatus);
+
 // Opcode 13 (Format memory) is used to recover the acquisition status
+//
+// The format is carried out in slices of OPCODE013_TIME_SLICE_MS (at least one
+// block erase per message), so that the loader can serve other messages - and
+// other partitions can be read and written - while a large partition is being
+// formatted.  Until the format is complete the reply is LOADER_FORMAT_IN_PROGRESS
+// with the progress (0-100) as its data.  The format carries on between
+// messages (see opcode13_FormatStep), so a single message is enough for it to
+// complete.  Sending the same message again reports the progress, or the
+// result once it has finished.  A message for a different partition abandons
+// the format in progress and starts a new one.
 void opcode13_execute(ELoaderState_t * loaderState, LoaderMessage_t * message, Timer_t* timer)
 {
 
-    rs_error_t                  format_status;
-    uint8_t              m_partition_format_progress = 0u;
-    uint8_t partition_index = message->dataPtr[0];
+    rs_error_t          format_status;
+    uint8_t             partition_index;
+    uint32_t            slice_start_time;
+    char                progress;
+
+    // Reset timeout timer before doing anything else, as a block erase
+    // could take a while.
+    Timer_TimerReset(timer);
+
+    if (message->dataLengthInBytes == 0u)
+    {
+        loader_MessageSend(LOADER_WRONG_NUM_PARAMETERS, 0, ""); //lint !e840 Use of nul character in string literal
+        return;
+    }
+
+    partition_index = message->dataPtr[0];
+
+    if ( (mbFormatResultPending) && (mFormatPartition == partition_index) )
+    {
+        // Finished between messages, so just report how it went.
+        format_status = mFormatResult;
+    }
+    else
+    {
+        if (rspartition_format_in_progress_check(partition_index))
+        {
+            format_status = RS_ERR_FORMAT_IN_PROGRESS;
+        }
+        else
+        {
+            format_status = rspartition_format_start(partition_index);
+
+            // The Dpoints opcode 204 keeps in RAM are about to be erased.
+            if (partition_index == rspartition_check_partition_id(RS_PARTITION_CONFIGURATION))
+            {
+                opcode204_DpointTableInvalidate();
+            }
+        }
+
+        Timer_StopWatchSet(&slice_start_time);
+
+        // Always do at least one step, so that every message makes progress.
+        while (format_status == RS_ERR_FORMAT_IN_PROGRESS)
+        {
+            format_status = rspartition_format_step();
+
+            if (Timer_StopWatchGet(slice_start_time) >= OPCODE013_TIME_SLICE_MS)
+            {
+                break;
+            }
+        }
 
-    format_status = rspartition_format_partition(partition_index,&m_partition_format_progress);
+        mFormatPartition = partition_index;
+
+        if (format_status == RS_ERR_FORMAT_IN_PROGRESS)
+        {
+            mbFormatRunning = TRUE;
+        }
+        else
+        {
+            opcode13_FormatFinish(format_status);
+        }
+    }
+
+    mbFormatResultPending = FALSE;
 
     if(format_status == RS_ERR_NO_ERROR){
-        (void)rspartition_bisection_search_do(partition_index);
         loader_MessageSend(LOADER_OK, 0, ""); //lint !e840 Use of nul character in string literal
+    }else if(format_status == RS_ERR_FORMAT_IN_PROGRESS){
+        progress = (char)rspartition_format_progress_get();
+        loader_MessageSend(LOADER_FORMAT_IN_PROGRESS, 1, &progress);
     }else{
         loader_MessageSend(LOADER_CANNOT_FORMAT, 0, ""); //lint !e840 Use of nul character in string literal
     }
@@ -26,3 +113,48 @@ void opcode13_execute(ELoaderState_t * loaderState, LoaderMessage_t * message, T
     Timer_TimerReset(timer);
 }
 
+// Carries out the next step of a format started by opcode 13, if there is one.
+// This is called by the loader whenever it is waiting for a message, the same
+// way as M95_FlushStep, so the format finishes even if the host never sends the
+// message again.  Each step erases a single block.  The result is kept for the
+// next opcode 13 for the same partition.
+//
+// Returns TRUE if the format still has more steps to do.
+bool_t opcode13_FormatStep(void)
+{
+    rs_error_t  format_status;
+
+    if (mbFormatRunning)
+    {
+        // Abandoned by something else starting a format, nothing to report.
+        if (!rspartition_format_in_progress_check(mFormatPartition))
+        {
+            mbFormatRunning = FALSE;
+        }
+        else
+        {
+            format_status = rspartition_format_step();
+
+            if (format_status != RS_ERR_FORMAT_IN_PROGRESS)
+            {
+                opcode13_FormatFinish(format_status);
+
+                mFormatResult         = format_status;
+                mbFormatResultPending = TRUE;
+            }
+        }
+    }
+
+    return mbFormatRunning;
+}
+
+// Tidies up once a format has finished, however it finished.
+static void opcode13_FormatFinish(rs_error_t FormatStatus)
+{
+    mbFormatRunning = FALSE;
+
+    if (FormatStatus == RS_ERR_NO_ERROR)
+    {
+        (void)rspartition_bisection_search_do(mFormatPartition);
+    }
+}
@@ -27,6 +27,8 @@ void opcode21_execute(ELoaderState_t* loaderState, Timer_t* timer)
 	const SelfTestResult_t*	pSelfTestResult;
 	unsigned char           iPortStatus;
 
+	// Report the real CRCs, not just the ones trusted from the image descriptors.
+	SelfTest_VerificationComplete();
 	pSelfTestResult = SelfTest_ResultPointerGet();
 
     //Composer the self-test result message
@@ -0,0 +1,283 @@
+/**
+ * \file
+ * Implementation of opcode40 ( windowed download ) for Flashloader
+ *
+ * @author Fei Li
+ * @date 16 October 2026
+ *
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work,
+ * created 2026.  This computer program includes confidential,
+ * proprietary information and is a trade secret of Xi'an Shiyou Univ.
+ * DD Lab.  All use, disclosure, and/or reproduction is
+ * prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+
+#include "common_data_types.h"
+#include "loader_state.h"
+#include "timer.h"
+#include "comm.h"
+#include "opcode040.h"
+#include "tool_specific_config.h"
+#include "utils.h"
+#include "tool_specific_programming.h"
+#include "prom_hardware.h"
+
+// Length of the data frame header - subfield, sequence number and address.
+#define OPCODE40_DATA_HEADER_LENGTH 7u
+
+//***************************************
+// Static declarations
+//***************************************
+
+/**
+ * Structure holding a data frame which has been staged in the download buffer.
+ */
+typedef struct
+{
+	bool_t	bStaged;			// Frame holds data which hasn't been programmed.
+	Uint16	Sequence;			// Sequence number of the frame.
+	Uint32	Address;			// Address in flash of the frame.
+	Uint32	LengthInWords;		// Length of the frame data.
+} Opcode40Frame_t;
+
+/**
+ * Handles a download message, by its subfield.
+ *
+ * @param message Pointer to the received message
+ * @param timer Pointer to the current Timer running in the Loader
+ */
+static void downloadMessageProcess( LoaderMessage_t * message, Timer_t * timer ) ;
+
+/**
+ * Starts a new windowed download.
+ */
+static void downloadStart( void ) ;
+
+/**
+ * Stages a data frame in the download buffer.  No reply is sent.
+ *
+ * @param message Pointer to the received message
+ */
+static void frameStage( LoaderMessage_t * message ) ;
+
+/**
+ * Programs all the frames received in order, then sends the cumulative
+ * acknowledgement and the bitmap of missing frames.
+ *
+ * @param message Pointer to the received message
+ */
+static void windowEnd( LoaderMessage_t * message ) ;
+
+static bool_t			mbDownloadStarted = FALSE;	// OPCODE40_START has been received.
+static bool_t			mbDownloadFailed = FALSE;	// A frame couldn't be staged or programmed.
+static Uint16			mNextSequence = 0u;			// Next frame to be programmed.
+static Opcode40Frame_t	mFrames[OPCODE40_WINDOW_FRAMES];
+
+
+//***************************************
+// functions declared in included files
+//***************************************
+
+/**
+ * Opcode 40 downloads an application in frames of up to the size of the
+ * receive buffer, rather than the 255 bytes of opcode 37, and without waiting
+ * for a reply to each frame.  Up to OPCODE40_WINDOW_FRAMES data frames,
+ * identified by sequence number, are sent before an OPCODE40_WINDOW_END.
+ * Each frame is staged in its own OPCODE40_FRAME_WORDS slot of the download
+ * buffer, and the frames received in order are programmed into the flash when
+ * the window ends.  The reply then gives the next expected sequence number and
+ * the frames which went missing, which are sent again in the next window.
+ * The partition is prepared, checked and programmed with opcode 39 as usual.
+ */
+void opcode40_execute( ELoaderState_t * loaderState, LoaderMessage_t * message,
+                       Timer_t * timer )
+{
+	//lint -e{788} enum constant not used within switch.
+    switch( *loaderState )
+    {
+    case LOADER_SCRATCH_PREPARED :
+        *loaderState = LOADER_DOWNLOADING;
+        downloadMessageProcess( message, timer );
+        break;
+
+    // We're currently downloading an application, so process the download
+    case LOADER_DOWNLOADING :
+        downloadMessageProcess( message, timer );
+        break;
+
+    default:
+        loader_MessageSend( LOADER_INVALID_OPCODE, 0, "" );
+    }
+}
+
+//***************************************
+// Static functions
+//***************************************
+
+static void downloadMessageProcess( LoaderMessage_t * message, Timer_t * timer )
+{
+    if (message->dataLengthInBytes == 0u)
+    {
+        loader_MessageSend( LOADER_WRONG_NUM_PARAMETERS, 0, "" );
+        return;
+    }
+
+    switch (message->dataPtr[0])
+    {
+    case OPCODE40_START:
+        downloadStart();
+        break;
+
+    case OPCODE40_DATA:
+        frameStage( message );
+        break;
+
+    case OPCODE40_WINDOW_END:
+        windowEnd( message );
+        break;
+
+    default:
+        loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+        break;
+    }
+
+    Timer_TimerReset( timer );
+}
+
+static void downloadStart( void )
+{
+	Uint16 i;
+
+	for (i = 0u; i < OPCODE40_WINDOW_FRAMES; i++)
+	{
+		mFrames[i].bStaged = FALSE;
+	}
+
+	mNextSequence = 0u;
+	mbDownloadFailed = FALSE;
+	mbDownloadStarted = TRUE;
+
+	loader_MessageSend( LOADER_OK, 0, "" );
+}
+
+static void frameStage( LoaderMessage_t * message )
+{
+	Uint16	Sequence;
+	Uint16	Slot;
+	Uint32	LengthInBytes;
+	Uint32	Address;
+
+	if ( (mbDownloadStarted == FALSE) || (mbDownloadFailed == TRUE) )
+	{
+		return;
+	}
+
+	// A malformed frame will never be accepted, so fail the download rather
+	// than asking for it again.
+	if ( (message->dataLengthInBytes <= OPCODE40_DATA_HEADER_LENGTH)
+			|| ( (message->dataLengthInBytes & 1u) == 0u ) )
+	{
+		mbDownloadFailed = TRUE;
+		return;
+	}
+
+	Sequence = utils_toUint16(&message->dataPtr[1], TARGET_ENDIAN_TYPE);
+	Address = utils_toUint32(&message->dataPtr[3], TARGET_ENDIAN_TYPE);
+	LengthInBytes = (Uint32)message->dataLengthInBytes - OPCODE40_DATA_HEADER_LENGTH;
+
+	if ( (LengthInBytes >> 1) > OPCODE40_FRAME_WORDS )
+	{
+		mbDownloadFailed = TRUE;
+		return;
+	}
+
+	// Ignore frames which have already been programmed (sent again because the
+	// acknowledgement was lost), or which are beyond the end of the window.
+	if ( (Uint16)(Sequence - mNextSequence) >= OPCODE40_WINDOW_FRAMES )
+	{
+		return;
+	}
+
+	Slot = Sequence % OPCODE40_WINDOW_FRAMES;
+
+	if ( (mFrames[Slot].bStaged == TRUE) && (mFrames[Slot].Sequence == Sequence) )
+	{
+		return;
+	}
+
+	if (PromHardware_ProgramMemoryStage( &message->dataPtr[OPCODE40_DATA_HEADER_LENGTH],
+	                                     LengthInBytes, Address,
+	                                     (Uint32)Slot * OPCODE40_FRAME_WORDS ) == TRUE)
+	{
+		mFrames[Slot].bStaged = TRUE;
+		mFrames[Slot].Sequence = Sequence;
+		mFrames[Slot].Address = Address;
+		mFrames[Slot].LengthInWords = LengthInBytes >> 1;
+	}
+	else
+	{
+		mbDownloadFailed = TRUE;
+	}
+}
+
+static void windowEnd( LoaderMessage_t * message )
+{
+	Uint16			LastSequence;
+	Uint16			Outstanding;
+	Uint16			MissingFrames = 0u;
+	Uint16			Slot;
+	Uint16			i;
+	unsigned char	Reply[4];
+
+	if (message->dataLengthInBytes != 3u)
+	{
+		loader_MessageSend( LOADER_WRONG_NUM_PARAMETERS, 0, "" );
+		return;
+	}
+
+	LastSequence = utils_toUint16(&message->dataPtr[1], TARGET_ENDIAN_TYPE);
+
+	// Program the frames which have been received in order.  This is done
+	// while the host waits for the reply, as the serial port is polled.
+	Slot = mNextSequence % OPCODE40_WINDOW_FRAMES;
+	while ( (mbDownloadStarted == TRUE) && (mbDownloadFailed == FALSE)
+			&& (mFrames[Slot].bStaged == TRUE) && (mFrames[Slot].Sequence == mNextSequence) )
+	{
+		if (PromHardware_StagedMemoryProgram( mFrames[Slot].Address, mFrames[Slot].LengthInWords,
+		                                      (Uint32)Slot * OPCODE40_FRAME_WORDS ) == FALSE)
+		{
+			mbDownloadFailed = TRUE;
+		}
+
+		mFrames[Slot].bStaged = FALSE;
+		mNextSequence++;
+		Slot = mNextSequence % OPCODE40_WINDOW_FRAMES;
+	}
+
+	if ( (mbDownloadStarted == FALSE) || (mbDownloadFailed == TRUE) )
+	{
+		loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+		return;
+	}
+
+	// Flag every frame up to the last one sent which hasn't arrived - if the
+	// last frame sent has already been programmed, there's nothing missing.
+	Outstanding = (Uint16)(LastSequence - mNextSequence);
+	if (Outstanding < OPCODE40_WINDOW_FRAMES)
+	{
+		for (i = 0u; i <= Outstanding; i++)
+		{
+			Slot = (Uint16)(mNextSequence + i) % OPCODE40_WINDOW_FRAMES;
+			if ( (mFrames[Slot].bStaged == FALSE)
+					|| (mFrames[Slot].Sequence != (Uint16)(mNextSequence + i)) )
+			{
+				MissingFrames |= (Uint16)(1u << i);
+			}
+		}
+	}
+
+	utils_to2Bytes(&Reply[0], mNextSequence, LITTLE_ENDIAN);
+	utils_to2Bytes(&Reply[2], MissingFrames, LITTLE_ENDIAN);
+	loader_MessageSend( LOADER_OK, 4, (char *)Reply );
+}
@@ -5,6 +5,7 @@
  *      Author: l
  */
 
+#include <string.h>
 #include "common_data_types.h"
 #include "loader_state.h"
 #include "timer.h"
@@ -18,6 +19,7 @@
 #include "buffer_utils.h"
 #include "crc.h"
 #include "iocontrolcommon.h"
+#include "dump_codec.h"
 // ----------------------------------------------------------------------------
 // Defines section - add all #defines here:
 
@@ -28,6 +30,9 @@
 #define END_DUMP							3u							///< End of dump command value.
 #define SEND_PACKET_CMD						4u							///< Send packet command value.
 #define ANOTHER_SEND_PACKET_CMD				5u							///< Another send packet command value.
+#define FAST_DUMP_RANGE_CMD					6u							///< Dump a byte range of the selected partition command value.
+#define FAST_DUMP_RANGE_CMD_LENGTH			9u							///< Command, byte offset (4 bytes) and byte count (4 bytes).
+#define FAST_DUMP_COMPRESSED_CMD			7u							///< Dump a byte range of the selected partition, compressed, command value.
 
 #define START_DUMP_ADDRESS					0x07310000u					///< Start memory dump address.120651776
 
@@ -41,37 +46,54 @@
 
 #define RECORDING_SYSTEM_STOP_TICK_TIMEOUT  20u		  					///< Default recording system stop timeout in tick counts.
 
+#define FAST_DUMP_BUFFERS					2u							///< One frame is prepared while the other is sent.
+#define LEGACY_HEADER_SIZE					10u							///< Start, address, byte count, packet size and address.
+#define RANGE_HEADER_SIZE					9u							///< Start, address, data length, status and byte offset.
+#define COMPRESSED_HEADER_SIZE				13u							///< Range header, then uncompressed length and CRC.
+#define RAW_BLOCK_SIZE						1024u						///< Most bytes compressed into one frame.
+#define FRAME_TRAILER_SIZE					3u							///< CRC MSB, CRC LSB and stop character.
+#define FRAME_START_OFFSET					1u							///< Leaves room to read from an even address.
+#define FAST_DUMP_BUFFER_SIZE				(FRAME_START_OFFSET + COMPRESSED_HEADER_SIZE + TRANSMIT_BUFFER_SIZE + FRAME_TRAILER_SIZE)
+
 
 // ----------------------------------------------------------------------------
 // Function prototypes for functions which only have scope within this module:
 
-static sendFrameState_t fast_dump_sendFrameRun(const uint8_t* const pMessage);
 static void 			fast_dump_initialise(const Ebaud_rate_t baudRate);
 
-static uint16_t			sentCommandDecode(const uint8_t* const pMessage,
-									uint32_t* const pLogicalAddress,
-									uint16_t* const pCrc);
-static void 			transmitBuffer_Initialise(uint32_t* const pLogicalAddress,
-									  	  	  	  const uint32_t ByteNumber,
-												  uint8_t* const pTransmitBuffer,
-												  uint16_t* const pCrc);
-static void 			lastFrame_Transmit(uint8_t* const pTransmitBuffer, const uint16_t crc);
+static void				fast_dump_legacyStart(const uint8_t* const pMessage);
+static bool_t			fast_dump_rangeStart(const uint8_t* const pMessage, const bool_t bCompressed);
+static fastDumpState_t	fast_dump_step(void);
+static void				fast_dump_framePrepare(const uint16_t bufferIndex);
+static void				fast_dump_compressedFramePrepare(const uint16_t bufferIndex);
 
 void SSB_BufferTransmitStart(const uint8_t * const p_bufferToTransmit,const uint16_t numberOfBytesToTransmit);
+void SSB_BusInReceiveModeSet(void);
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module:
 
-/// Fast dump state machine.
-//lint -e{956} Doesn't need to be volatile.
-static sendFrameState_t mState = FAST_DUMP_INITIAL;
-
-/// Logging memory physical address.
-//lint -e{956} Doesn't need to be volatile.
-static uint32_t		mLogicalAddress;
-
-/// Number of read sequences.
+/// Structure holding the progress of a dump.
+typedef struct
+{
+	fastDumpState_t	state;									///< Fast dump engine state.
+	bool_t			bFramePerBuffer;						///< Range dump - every buffer is a complete frame.
+	bool_t			bCompressed;							///< Range dump - the frames are compressed.
+	bool_t			bHeaderPending;							///< Legacy dump - the header hasn't been prepared yet.
+	bool_t			bLastFramePrepared;						///< Nothing more to read.
+	bool_t			bSending;								///< The send buffer is being transmitted.
+	bool_t			bTransmitterEnabled;					///< The RS485 bus has been switched to transmit.
+	uint32_t		logicalAddress;							///< Next byte to read from the logging memory.
+	uint32_t		byteOffset;								///< Byte offset of the next byte in the partition.
+	uint32_t		bytesRemaining;							///< Number of bytes still to read.
+	uint16_t		crc;									///< Running CRC.
+	uint16_t		fillIndex;								///< Buffer to prepare the next frame in.
+	uint16_t		sendIndex;								///< Buffer to transmit next.
+	uint16_t		frameLength[FAST_DUMP_BUFFERS];			///< Length of the prepared frame, zero if the buffer is free.
+} fastDump_t;
+
+/// Fast dump progress.
 //lint -e{956} Doesn't need to be volatile.
-static uint16_t     mNumberOfReads;
+static fastDump_t	mDump = { FAST_DUMP_IDLE };
 
 /// Current DSP_B baud rate.
 //lint -e{956} Doesn't need to be volatile.
@@ -85,20 +107,19 @@ static Ebaud_rate_t mFastDumpRate;
 //lint -e{956} Doesn't need to be volatile.
 static uint32_t    	mLoggingMemoryStartAddress;
 
-/// Pointer to the temporary buffer location used as "even frame" buffer.
+/// Legacy dump header, sent in front of the first frame.
 //lint -e{956} Doesn't need to be volatile.
-static uint8_t*    mpEvenTransmitBuffer 		= NULL;
+static uint8_t		mLegacyHeader[LEGACY_HEADER_SIZE];
 
-/// Pointer to the temporary buffer location used as "odd frame" buffer.
+/// Frame buffers, used as ping-pong buffers.
 //lint -e{956} Doesn't need to be volatile.
-static uint8_t*    mpOddTransmitBuffer  		= NULL;
+static uint8_t		mFrameBuffers[FAST_DUMP_BUFFERS][FAST_DUMP_BUFFER_SIZE];
 
-/// Computed crc.
+/// Uncompressed data for a compressed frame, with room to read from an even address.
 //lint -e{956} Doesn't need to be volatile.
-static uint16_t    mCrc 						= INITIAL_CRC_VALUE;
+static uint8_t		mRawBuffer[FRAME_START_OFFSET + RAW_BLOCK_SIZE + 1u];
 
 static uint8_t buffer[512];     //ݻ
-static uint8_t mTemporaryBuffer[1032];
 uint8_t selectPartitionIndex;
 void opcode46_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,
         Timer_t* timer){
@@ -148,30 +169,10 @@ void opcode46_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,
 	    break;
 		case FAST_DUMP_START_CMD:
 
-		    // Set the dump speed to 921600 Bytes/second.
-			//fast_dump_initialise(SSB_TX_BAUD_RATE_921600);
-
-
-			// We use the temporary buffer as two ping-pong buffers, we first make sure its size fits with the needs of the opcode.
-			if (1)//pCommand->TemporaryBufferSize >= (2u * (TRANSMIT_BUFFER_SIZE + 3u)) )
-			{
-				//Assign the Odd and the Even buffer pointers to some temporary buffer locations.
-				mpOddTransmitBuffer 	= &mTemporaryBuffer[0u];
-				mpEvenTransmitBuffer 	= &mTemporaryBuffer[TRANSMIT_BUFFER_SIZE + 3u];
-			    loader_MessageSend( LOADER_OK, 0, "" );
-			}
-			else
-			{
-				// Just avoid problem with the unit tests.
-				mpOddTransmitBuffer 	= NULL;
-				mpEvenTransmitBuffer 	= NULL;
-
-				// At that stage Toolscope should stop the dump process,
-				loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "");
-			}
+			// The frame buffers are always available, so just acknowledge.
+			loader_MessageSend( LOADER_OK, 0, "" );
 		break;
 
-
 		case END_DUMP:
 			// Set the RS485 speed back to their original values.
 		    if(!SCI_BaudRateSet(SCI_B, 58982400u, (uint32_t)mCurrentBaudRate)){
@@ -182,22 +183,39 @@ void opcode46_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,
 		break;
 
 		case SEND_PACKET_CMD:
-			// In case Toolscope continues the Dump process.
-			// One test should be sufficient as the two buffers are assigned together.
-			if ( (mpOddTransmitBuffer != NULL) && (mpEvenTransmitBuffer != NULL) )
+			// Send the requested number of Kbytes as one long frame.
+			fast_dump_legacyStart(pSendCommand);
+
+			// The next frame is read while the previous one is being sent, so
+			// just keep the engine going until the last frame has gone.
+			while (FAST_DUMP_IDLE != fast_dump_step())
 			{
-				// Loop until the complete frame is completed.
-				while (FAST_DUMP_INITIAL != fast_dump_sendFrameRun(pSendCommand))
-				{
-					; // Just loop.
-				}
+				; // Just loop.
+			}
+
+			// No answer except the dump frame is expected.
+		break;
 
-				// No answer except the dump frame is expected.
+		case FAST_DUMP_RANGE_CMD:
+		case FAST_DUMP_COMPRESSED_CMD:
+			if (message->dataLengthInBytes != FAST_DUMP_RANGE_CMD_LENGTH)
+			{
+			    loader_MessageSend( LOADER_WRONG_NUM_PARAMETERS, 0, "" );
 			}
-			else
+			else if (fast_dump_rangeStart(pSendCommand,
+			                              (commandType == FAST_DUMP_COMPRESSED_CMD) ? TRUE : FALSE) == FALSE)
 			{
 			    loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
 			}
+			else
+			{
+				while (FAST_DUMP_IDLE != fast_dump_step())
+				{
+					; // Just loop.
+				}
+
+				// No answer except the dump frames is expected.
+			}
 		break;
 
 		case ANOTHER_SEND_PACKET_CMD:
@@ -241,258 +259,447 @@ static void fast_dump_initialise(const Ebaud_rate_t baudRate)
 
 // ------------------------------------------------------------------------
 /**
- * fast_dump_sendFrameRun manages the different steps of a logging memory dump transmission.
+ * fast_dump_legacyStart gets the Toolscope command, computes the start address
+ * and the dump size, and initialises the 10 first characters of the frame.
+ * The whole dump is sent as one frame, with the CRC and CTRL_Z at the end.
  *
  * @note
- * This is not the most efficient way to process
- * a dump command but it allows to check
- * the parameters at each cycle and so it suits well with TDD.
+ * Toolscope always requests a number of Kbyte, pMessage[0], from an address
+ * given by pMessage[1] to pMessage[3] (LSB first, the lowest byte being zero).
  *
- * @param       pMessage    Pointer to the message received.
- * @retval      state       Packet transmission state.
+ * @param       pMessage            Pointer to the received message (command).
  */
 // ------------------------------------------------------------------------
-static sendFrameState_t fast_dump_sendFrameRun(const uint8_t* const pMessage)
-
+static void fast_dump_legacyStart(const uint8_t* const pMessage)
 {
-    switch (mState)
-    {
-        case FAST_DUMP_INITIAL:
-            //SSB_BusBaudRateSet(mFastDumpRate);
-            mCrc         	= INITIAL_CRC_VALUE;
-            mNumberOfReads 	= sentCommandDecode(pMessage,&mLogicalAddress, &mCrc);
-            mState        	= FAST_DUMP_FIRST_FRAME;
-            break;
-
-        case FAST_DUMP_FIRST_FRAME:
-            //lint -e{921} Cast to uint32_t to avoid prototype coercion.
-            transmitBuffer_Initialise(&mLogicalAddress,
-                                      (uint32_t)TRANSMIT_BUFFER_SIZE,
-            						  &mpEvenTransmitBuffer[0u],
-            						  &mCrc);
-            mNumberOfReads--;
-            //loader_MessageSend( LOADER_OK, 517, mpOddTransmitBuffer[0u] );
-            SSB_BufferTransmitStart(&mpOddTransmitBuffer[0u], 10u);	   	// send the 10 first bytes.
-            mState = FAST_DUMP_EVEN_FRAME;
-            break;
-
-        case FAST_DUMP_EVEN_FRAME:
-        	// freeRTOS waiting for the end of transmission event.
-        	if (SSB_TransmitDoneCheckAndWait())
-        	{
-        		//Send new frame
-        	    SSB_BufferTransmitStart(&mpEvenTransmitBuffer[0u],
-        		                        TRANSMIT_BUFFER_SIZE);
-
-        		//lint -e{921} Cast to uint32_t to avoid prototype coercion.
-        		transmitBuffer_Initialise(&mLogicalAddress,
-        		                          (uint32_t)TRANSMIT_BUFFER_SIZE,
-        								  &mpOddTransmitBuffer[0u],
-        								  &mCrc);
-        		mNumberOfReads--;
-
-        		/*
-        		 * The last frame is always sent from the odd buffer since the
-        		 * packet size is a multiple of 512 (words) and the page size
-        		 * is 256 (words)
-        		 */
-        		if ( 0u == mNumberOfReads )
-        		{
-        			mState = FAST_DUMP_LAST_FRAME;
-
-        			lastFrame_Transmit(&mpOddTransmitBuffer[0u], mCrc);
-        		}
-        		else
-        		{
-        			mState = FAST_DUMP_ODD_FRAME;
-        		}
-        	}
-        	break;
-
-        case FAST_DUMP_ODD_FRAME:
-        	// freeRTOS waiting for the end of transmission event.
-        	if (SSB_TransmitDoneCheckAndWait())
-        	{
-        		//Send new frame
-        	    SSB_BufferTransmitStart(&mpOddTransmitBuffer[0u],
-        		                        TRANSMIT_BUFFER_SIZE);
-
-        		//lint -e{921} Cast to uint32_t to avoid prototype coercion.
-        		transmitBuffer_Initialise(&mLogicalAddress,
-        		                          (uint32_t)TRANSMIT_BUFFER_SIZE,
-        								  &mpEvenTransmitBuffer[0u],
-        								  &mCrc);
-        		mNumberOfReads--;
-
-
-        		// ׸޸ģӦҲжһµǰǷݶȡ
-        		/*if ( 0u == mNumberOfReads )
-                {
-                    mState = FAST_DUMP_LAST_FRAME;
-
-                    lastFrame_Transmit(&mpOddTransmitBuffer[0u], mCrc);
-                }
-                else
-                {
-                    transmitBuffer_Initialise(&mLogicalAddress,
-                                                              (uint32_t)TRANSMIT_BUFFER_SIZE,
-                                                              &mpEvenTransmitBuffer[0u],
-                                                              &mCrc);
-                    mState = FAST_DUMP_EVEN_FRAME;
-                }*/
-        		mState = FAST_DUMP_EVEN_FRAME;
-        	}
-        	break;
-
-        case FAST_DUMP_LAST_FRAME:
-        	// freeRTOS waiting for the end of transmission event.
-        	if (SSB_TransmitDoneCheckAndWait())
-        	{
-        		//Send last frame
-        		// + 3 extra characters : <CRC_MSB><CRC_LSB><CTRL_Z>
-        	    SSB_BufferTransmitStart(&mpOddTransmitBuffer[0u],
-        		                        (TRANSMIT_BUFFER_SIZE + 3u));
-
-        		mState = FAST_DUMP_END;
-        	}
-        	break;
-
-        case FAST_DUMP_END:
-        	// freeRTOS waiting for the end of transmission event.
-        	if (SSB_TransmitDoneCheckAndWait())
-        	{
-
-        	    SSB_BusInReceiveModeSet();
-        		mState = FAST_DUMP_INITIAL;
-        	}
-        	break;
-
-        default :
-        	// Nothing, just need a comment here for Lint.
-            break;
-    }
-
-    return mState;
+    // Packet size and start address computation
+    //lint -e{921} Casts to avoid violating essential type mode.
+    const uint32_t ByteToRead   = (uint32_t)pMessage[0u] * 1024u;
+
+    //lint -e{921} Byte count is only 16 bits in the frame.
+    const uint16_t byteCount    = (uint16_t)(ByteToRead + EXTRA_BYTE_NUMBER);
+
+    //lint -e{921} Casts to avoid violating essential type mode.
+    uint32_t startAddress = ((uint32_t)pMessage[3u] << 24u);
+
+    //lint -e{921} Casts to avoid violating essential type mode.
+    startAddress +=         ((uint32_t)pMessage[2u] << 16u);
+
+    //lint -e{921} Casts to avoid violating essential type mode.
+    startAddress +=         ((uint32_t)pMessage[1u] << 8u);
+
+    // Initialise the 10 first bytes of the packet.
+    mLegacyHeader[0u] = START_CHAR;									// Start character.
+    mLegacyHeader[1u] = SLAVE_ADRESS_DSP_B; 							// Slave address.
+
+    // Add the byte count to the buffer, LSB then MSB.
+    //lint -e{920} Ignoring return value, not used here.
+    (void)BUFFER_UTILS_Uint16To8bitBuf(&mLegacyHeader[2u], byteCount);
+
+    mLegacyHeader[4u] = 0u;
+    mLegacyHeader[5u] = pMessage[0u];								// Packet size.
+    mLegacyHeader[6u] = pMessage[1u]; 								// Address, byte 1.
+    mLegacyHeader[7u] = pMessage[2u]; 								// Address, byte 2.
+    mLegacyHeader[8u] = pMessage[3u]; 								// Address, byte 3.
+    mLegacyHeader[9u] = pMessage[4u]; 								// Address, byte 4.
+
+    mDump.bFramePerBuffer    = FALSE;
+    mDump.bCompressed        = FALSE;
+    mDump.bHeaderPending     = TRUE;
+    mDump.logicalAddress     = mLoggingMemoryStartAddress + startAddress;
+    mDump.byteOffset         = startAddress;
+    mDump.bytesRemaining     = ByteToRead;
+
+    // Compute the CRC on the 10 first bytes.
+    //lint -e{921} Cast to uint32_t to avoid prototype coercion.
+    mDump.crc = CRC_CCITTOnByteCalculate(&mLegacyHeader[0u],
+                                         (uint32_t)LEGACY_HEADER_SIZE,
+                                         INITIAL_CRC_VALUE);
+
+    mDump.bLastFramePrepared = FALSE;
+    mDump.bSending           = FALSE;
+    mDump.bTransmitterEnabled = FALSE;
+    mDump.fillIndex          = 0u;
+    mDump.sendIndex          = 0u;
+    mDump.frameLength[0u]    = 0u;
+    mDump.frameLength[1u]    = 0u;
+    mDump.state              = FAST_DUMP_RUNNING;
 }
 
 
 // ------------------------------------------------------------------------
+/**
+ * fast_dump_rangeStart checks a range dump command and sets up the dump.
+ * The range is given as a byte offset and a byte count within the partition
+ * selected by ANOTHER_SEND_PACKET_CMD, and may start and end on any byte.
+ * Each frame of a range dump is complete in itself and holds the byte offset
+ * of its data, so after a link drop the dump can be restarted from the byte
+ * following the last good frame.
+ * A compressed dump stops at the partition's next available address, as
+ * there is nothing but erased memory after it - if the range starts after it,
+ * a single empty frame is sent.
+ *
+ * @param       pMessage            Pointer to the received message (command).
+ * @param       bCompressed         TRUE to compress the frames.
+ * @retval      bool_t              TRUE if the range is within the partition.
+ */
 // ------------------------------------------------------------------------
-// Local function definition
-// ------------------------------------------------------------------------
+static bool_t fast_dump_rangeStart(const uint8_t* const pMessage, const bool_t bCompressed)
+{
+	const rs_partition_info_t*	p_partition = rspartition_partition_ptr_get(selectPartitionIndex);
+	uint32_t					partitionSize;
+	uint32_t					writtenSize;
+	uint32_t					byteOffset;
+	uint32_t					byteCount;
+	bool_t						bRangeValid = FALSE;
+
+	//lint -e{921} Casts to avoid violating essential type mode.
+	byteOffset = (uint32_t)pMessage[0u] + ((uint32_t)pMessage[1u] << 8u)
+			+ ((uint32_t)pMessage[2u] << 16u) + ((uint32_t)pMessage[3u] << 24u);
+
+	//lint -e{921} Casts to avoid violating essential type mode.
+	byteCount  = (uint32_t)pMessage[4u] + ((uint32_t)pMessage[5u] << 8u)
+			+ ((uint32_t)pMessage[6u] << 16u) + ((uint32_t)pMessage[7u] << 24u);
+
+	if ( (p_partition != NULL) && (p_partition->end_address >= p_partition->start_address) )
+	{
+		partitionSize = (p_partition->end_address - p_partition->start_address) + 1u;
+
+		if ( (byteCount != 0u) && (byteOffset < partitionSize)
+				&& (byteCount <= (partitionSize - byteOffset)) )
+		{
+			if ( (bCompressed == TRUE)
+					&& (p_partition->next_available_address >= p_partition->start_address)
+					&& (p_partition->next_available_address <= p_partition->end_address) )
+			{
+				writtenSize = p_partition->next_available_address - p_partition->start_address;
+
+				if (byteOffset >= writtenSize)
+				{
+					byteCount = 0u;
+				}
+				else if (byteCount > (writtenSize - byteOffset))
+				{
+					byteCount = writtenSize - byteOffset;
+				}
+				else
+				{
+					// All of the range has been written.
+				}
+			}
+
+			mDump.bFramePerBuffer    = TRUE;
+			mDump.bCompressed        = bCompressed;
+			mDump.bHeaderPending     = FALSE;
+			mDump.logicalAddress     = p_partition->start_address + byteOffset;
+			mDump.byteOffset         = byteOffset;
+			mDump.bytesRemaining     = byteCount;
+			mDump.crc                = INITIAL_CRC_VALUE;
+			mDump.bLastFramePrepared = FALSE;
+			mDump.bSending           = FALSE;
+			mDump.bTransmitterEnabled = FALSE;
+			mDump.fillIndex          = 0u;
+			mDump.sendIndex          = 0u;
+			mDump.frameLength[0u]    = 0u;
+			mDump.frameLength[1u]    = 0u;
+			mDump.state              = FAST_DUMP_RUNNING;
+
+			bRangeValid = TRUE;
+		}
+	}
+
+	return bRangeValid;
+}
+
+
 // ------------------------------------------------------------------------
 /**
- * lastFrame_Transmit sends the last frame, adds to the message the last bytes; CRC and CTRL_Z.
+ * fast_dump_step runs the fast dump engine one step, without waiting for
+ * anything.  The two frame buffers are used as ping-pong buffers - one is
+ * being transmitted by the SCI transmit interrupt while the next frame is
+ * read from the logging memory into the other one and its CRC computed.
+ * The next frame is queued as soon as the interrupt has put the last
+ * character of the previous one into the transmit FIFO, so there is no gap
+ * between frames on the wire.
  *
- * @param pTransmitBuffer     Pointer to the transmit buffer.
- * @param crc                 CRC value.
+ * @retval      fastDumpState_t     FAST_DUMP_IDLE once the dump has finished.
  */
 // ------------------------------------------------------------------------
-//lint -e{921} Cast to uint8_t as buffer holds uint8_t's
-static void lastFrame_Transmit(uint8_t* const pTransmitBuffer, const uint16_t crc)
+static fastDumpState_t fast_dump_step(void)
 {
-    pTransmitBuffer[TRANSMIT_BUFFER_SIZE]      = (uint8_t)( (crc & 0xFF00u) >> 8u );    //CRC MSB
-    pTransmitBuffer[TRANSMIT_BUFFER_SIZE + 1u] = (uint8_t)(crc & 0x00FFu);              //CRC LSB
-    pTransmitBuffer[TRANSMIT_BUFFER_SIZE + 2u] = STOP_CHAR;
+	const uint16_t	sendIndex = mDump.sendIndex;
+	const uint16_t	fillIndex = mDump.fillIndex;
+
+	switch (mDump.state)
+	{
+		case FAST_DUMP_RUNNING:
+			// The buffer being sent is free once it's all in the FIFO.
+			if ( (mDump.bSending == TRUE) && (SCI_TxBufferFreeCheck(SCI_B) == TRUE) )
+			{
+				mDump.frameLength[sendIndex] = 0u;
+				mDump.sendIndex = (sendIndex + 1u) % FAST_DUMP_BUFFERS;
+				mDump.bSending = FALSE;
+			}
+			// Send the next frame as soon as it's ready - the first frame
+			// also switches the bus over to transmit.
+			else if ( (mDump.bSending == FALSE) && (mDump.frameLength[sendIndex] != 0u) )
+			{
+				if (mDump.bTransmitterEnabled == FALSE)
+				{
+					SSB_BufferTransmitStart(&mFrameBuffers[sendIndex][FRAME_START_OFFSET],
+					                        mDump.frameLength[sendIndex]);
+					mDump.bTransmitterEnabled = TRUE;
+				}
+				else
+				{
+					SCI_TxStart(SCI_B, &mFrameBuffers[sendIndex][FRAME_START_OFFSET],
+					            mDump.frameLength[sendIndex]);
+				}
+				mDump.bSending = TRUE;
+			}
+			// Otherwise use the time to prepare the next frame.
+			else if ( (mDump.frameLength[fillIndex] == 0u) && (mDump.bLastFramePrepared == FALSE) )
+			{
+				if (mDump.bCompressed == TRUE)
+				{
+					fast_dump_compressedFramePrepare(fillIndex);
+				}
+				else
+				{
+					fast_dump_framePrepare(fillIndex);
+				}
+				mDump.fillIndex = (fillIndex + 1u) % FAST_DUMP_BUFFERS;
+			}
+			else if ( (mDump.bSending == FALSE) && (mDump.bLastFramePrepared == TRUE) )
+			{
+				mDump.state = FAST_DUMP_DRAINING;
+			}
+			else
+			{
+				// Waiting for the transmit interrupt.
+			}
+			break;
+
+		case FAST_DUMP_DRAINING:
+			// Wait for the last character to leave the shift register.
+			if (SCI_TxDoneCheck(SCI_B) == TRUE)
+			{
+				SSB_BusInReceiveModeSet();
+				mDump.state = FAST_DUMP_IDLE;
+			}
+			break;
+
+		case FAST_DUMP_IDLE:
+		default:
+			mDump.state = FAST_DUMP_IDLE;
+			break;
+	}
+
+	return mDump.state;
 }
 
 
+// ------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+// Local function definition
+// ------------------------------------------------------------------------
 // ------------------------------------------------------------------------
 /**
- * sentCommandDecode gets the Toolscope command and computes the start address and the frame size.
- * Initialises the 10 first characters of the frame pMessage[0] frame size (Kbyte).
+ * fast_dump_framePrepare reads the next block of the logging memory into a
+ * frame buffer, computes the CRC and adds the header and the trailer.
+ *
+ * A range frame is
+ * <START><ADDRESS><LENGTH_LSB><LENGTH_MSB><STATUS><OFFSET x 4, LSB first>
+ * <DATA x LENGTH><CRC_MSB><CRC_LSB><CTRL_Z>, with the CRC over everything
+ * before it.  If the memory can't be read, the frame has no data and an
+ * error status, and ends the dump.
+ *
+ * A legacy dump is one long frame, so only the first buffer has the header
+ * and only the last one has the CRC and CTRL_Z.
  *
  * @note
- * Toolscope always requests a number of Kbyte (512 words minimum).
- * As the MEMORY_PAGE_SIZE is 256 words, the number of read is equal
- * to NumberOfWordRequested/MEMORY_PAGE_SIZE. The rest of  the division
- * is NULL.
- * @note
- * The address sent by Tooslcope is a byte address, it needs to be converted in a word
- * address in order to read the recording flash data.
+ * The main flash can only be read from an even address, so the read starts
+ * on the byte before an odd address, and the extra byte is overwritten by the
+ * header (this is why the header is written after the data).
  *
- * @param       pMessage            Pointer to the received message (command).
- * @param       pLogicalAddress     Pointer to the memory logical address.
- * @param       pCrc                Pointer to the crc value.
- * @retval      mNumberOfReads      Number of read sequences.
+ * @param       bufferIndex         Index of the frame buffer to use.
  */
 // ------------------------------------------------------------------------
-static uint16_t sentCommandDecode(const uint8_t* const pMessage,
-                                  uint32_t* const pLogicalAddress,
-                                  uint16_t* const pCrc)
+static void fast_dump_framePrepare(const uint16_t bufferIndex)
 {
-    // Packet size and start address computation
-    const uint16_t ByteToRead   = pMessage[0u] * 1024u;
-
-    const uint16_t byteCount    = ByteToRead + EXTRA_BYTE_NUMBER;
-
-    //lint -e{921} Casts to avoid violating essential type mode.
-    uint32_t startAddress = ((uint32_t)pMessage[3u] << 24u);
+	uint8_t* const		pFrame = &mFrameBuffers[bufferIndex][FRAME_START_OFFSET];
+	uint16_t			headerSize = 0u;
+	uint16_t			dataSize = TRANSMIT_BUFFER_SIZE;
+	uint16_t			frameLength;
+	uint32_t			leadingBytes;
+	uint8_t				status = LOADER_OK;
+	flash_hal_error_t	readStatus;
+
+	if (mDump.bFramePerBuffer == TRUE)
+	{
+		headerSize = RANGE_HEADER_SIZE;
+	}
+	else if (mDump.bHeaderPending == TRUE)
+	{
+		headerSize = LEGACY_HEADER_SIZE;
+	}
+	else
+	{
+		// No header on the following frames of a legacy dump.
+	}
 
-    //lint -e{921} Casts to avoid violating essential type mode.
-    startAddress +=         ((uint32_t)pMessage[2u] << 16u);
+	if (mDump.bytesRemaining < dataSize)
+	{
+		//lint -e{921} Less than TRANSMIT_BUFFER_SIZE, so fits in 16 bits.
+		dataSize = (uint16_t)mDump.bytesRemaining;
+	}
 
-    //lint -e{921} Casts to avoid violating essential type mode.
-    startAddress +=         ((uint32_t)pMessage[1u] << 8u);
+	// Read whole words, starting from an even address.
+	leadingBytes = mDump.logicalAddress & 0x00000001u;
+	readStatus = flash_hal_device_read(mDump.logicalAddress - leadingBytes,
+	                                   (leadingBytes + dataSize + 1u) & 0xFFFFFFFEu,
+	                                   &pFrame[headerSize - leadingBytes]);
 
-    mNumberOfReads = ByteToRead / TRANSMIT_BUFFER_SIZE;
+	if ( (readStatus != FLASH_HAL_NO_ERROR) && (mDump.bFramePerBuffer == TRUE) )
+	{
+		status = LOADER_PARAMETER_OUT_OF_RANGE;
+		dataSize = 0u;
+		mDump.bytesRemaining = 0u;
+	}
 
-    // Computes the physical address
-    *pLogicalAddress = mLoggingMemoryStartAddress + startAddress;
+	if (mDump.bFramePerBuffer == TRUE)
+	{
+		pFrame[0u] = START_CHAR;
+		pFrame[1u] = SLAVE_ADRESS_DSP_B;
+		(void)BUFFER_UTILS_Uint16To8bitBuf(&pFrame[2u], dataSize);
+		pFrame[4u] = status;
+		(void)BUFFER_UTILS_Uint32To8bitBuf(&pFrame[5u], mDump.byteOffset);
+
+		//lint -e{921} Cast to uint32_t to avoid prototype coercion.
+		mDump.crc = CRC_CCITTOnByteCalculate(&pFrame[0u],
+		                                     (uint32_t)headerSize,
+		                                     INITIAL_CRC_VALUE);
+	}
+	else if (headerSize != 0u)
+	{
+		// The CRC of the legacy header was computed when the dump started.
+		(void)memcpy(&pFrame[0u], &mLegacyHeader[0u], LEGACY_HEADER_SIZE);
+		mDump.bHeaderPending = FALSE;
+	}
+	else
+	{
+		// Data only.
+	}
 
-    // Initialise the 10 first bytes of the packet.
-    mpOddTransmitBuffer[0u] = START_CHAR;								// Start character.
-    mpOddTransmitBuffer[1u] = SLAVE_ADRESS_DSP_B; 						// Slave address.
+	//lint -e{921} Cast to uint32_t to avoid prototype coercion.
+	mDump.crc = CRC_CCITTOnByteCalculate(&pFrame[headerSize], (uint32_t)dataSize, mDump.crc);
 
-    // Add the byte count to the buffer, LSB then MSB.
-    //lint -e{920} Ignoring return value, not used here.
-    (void)BUFFER_UTILS_Uint16To8bitBuf(&mpOddTransmitBuffer[2u], byteCount);
+	mDump.logicalAddress += dataSize;
+	mDump.byteOffset     += dataSize;
+	mDump.bytesRemaining -= dataSize;
+	frameLength = headerSize + dataSize;
 
-    mpOddTransmitBuffer[4u] = 0u;
-    mpOddTransmitBuffer[5u] = pMessage[0u];								// Packet size.
-    mpOddTransmitBuffer[6u] = pMessage[1u]; 							// Address, byte 1.
-    mpOddTransmitBuffer[7u] = pMessage[2u]; 							// Address, byte 2.
-    mpOddTransmitBuffer[8u] = pMessage[3u]; 							// Address, byte 3.
-    mpOddTransmitBuffer[9u] = pMessage[4u]; 							// Address, byte 4.
+	// Add the CRC and CTRL_Z to every range frame, and the end of the legacy frame.
+	if ( (mDump.bFramePerBuffer == TRUE) || (mDump.bytesRemaining == 0u) )
+	{
+		//lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+		pFrame[frameLength]      = (uint8_t)( (mDump.crc & 0xFF00u) >> 8u );	//CRC MSB
+		//lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+		pFrame[frameLength + 1u] = (uint8_t)(mDump.crc & 0x00FFu);			//CRC LSB
+		pFrame[frameLength + 2u] = STOP_CHAR;
+		frameLength += FRAME_TRAILER_SIZE;
+	}
 
-    // Compute the CRC on the 10 first bytes.
-    //lint -e{921} Cast to uint32_t to avoid prototype coercion.
-    /**pCrc = CheckNum_Calculate(&mpOddTransmitBuffer[0u],
-                                     (uint32_t)10u,
-                                     *pCrc);*/
-    *pCrc = CRC_CCITTOnByteCalculate(&mpOddTransmitBuffer[0u],
-                                     (uint32_t)10u,
-                                     *pCrc);
-    return mNumberOfReads;
+	mDump.bLastFramePrepared = (mDump.bytesRemaining == 0u) ? TRUE : FALSE;
+	mDump.frameLength[bufferIndex] = frameLength;
 }
 
 
 // ------------------------------------------------------------------------
 /**
- * transmitBuffer_Initialise reads the content of the recording memory,
- * computes the crc and  updates the next physical address.
+ * fast_dump_compressedFramePrepare reads the next block of the logging memory,
+ * compresses as much of it as fits into a frame buffer (see dump_codec.c),
+ * and adds the header and the trailer.
+ *
+ * A compressed frame is
+ * <START><ADDRESS><LENGTH_LSB><LENGTH_MSB><STATUS><OFFSET x 4, LSB first>
+ * <UNCOMPRESSED_LENGTH x 2, LSB first><UNCOMPRESSED_CRC x 2, LSB first>
+ * <COMPRESSED DATA x LENGTH><CRC_MSB><CRC_LSB><CTRL_Z>.
+ * The first CRC is over the data before compression, so the host can check
+ * what it has decompressed, the second is over everything before it, as for
+ * a range frame.  If the memory can't be read, the frame has no data and an
+ * error status, and ends the dump.
  *
- * @param   pPhysicalAddress    Recording memory address.
- * @param   ByteNumber          Number of bytes to read.
- * @param   pTransmitBuffer     Pointer to the transmission buffer.
- * @param   pCrc                Pointer to the CRC value.
+ * @param       bufferIndex         Index of the frame buffer to use.
  */
 // ------------------------------------------------------------------------
-static void transmitBuffer_Initialise(uint32_t* const pLogicalAddress,
-                                      const uint32_t ByteNumber,
-                                      uint8_t* const pTransmitBuffer,
-                                      uint16_t* const pCrc)
+static void fast_dump_compressedFramePrepare(const uint16_t bufferIndex)
 {
-	// Read the data from the logging flash
-	//lint -e{920} CAst from enum to void - discard the return value.
-	(void)flash_hal_device_read(*pLogicalAddress, ByteNumber, pTransmitBuffer);
+	uint8_t* const		pFrame = &mFrameBuffers[bufferIndex][FRAME_START_OFFSET];
+	const uint8_t*		pRaw;
+	uint16_t			rawSize = RAW_BLOCK_SIZE;
+	uint16_t			consumed = 0u;
+	uint16_t			dataSize = 0u;
+	uint16_t			rawCrc = INITIAL_CRC_VALUE;
+	uint16_t			frameLength;
+	uint32_t			leadingBytes;
+	uint8_t				status = LOADER_OK;
+
+	if (mDump.bytesRemaining < rawSize)
+	{
+		//lint -e{921} Less than RAW_BLOCK_SIZE, so fits in 16 bits.
+		rawSize = (uint16_t)mDump.bytesRemaining;
+	}
+
+	if (rawSize != 0u)
+	{
+		// Read whole words, starting from an even address.
+		leadingBytes = mDump.logicalAddress & 0x00000001u;
+		pRaw = &mRawBuffer[FRAME_START_OFFSET];
+
+		if (flash_hal_device_read(mDump.logicalAddress - leadingBytes,
+		                          (leadingBytes + rawSize + 1u) & 0xFFFFFFFEu,
+		                          &mRawBuffer[FRAME_START_OFFSET - leadingBytes]) != FLASH_HAL_NO_ERROR)
+		{
+			status = LOADER_PARAMETER_OUT_OF_RANGE;
+			mDump.bytesRemaining = 0u;
+		}
+		else
+		{
+			dataSize = dump_codec_encode(pRaw, rawSize, &pFrame[COMPRESSED_HEADER_SIZE],
+			                             TRANSMIT_BUFFER_SIZE, &consumed);
 
-	// Compute the CRC.
-	//*pCrc = CheckNum_Calculate(pTransmitBuffer, ByteNumber, *pCrc);
-	*pCrc = CRC_CCITTOnByteCalculate(pTransmitBuffer, ByteNumber, *pCrc);
+			//lint -e{921} Cast to uint32_t to avoid prototype coercion.
+			rawCrc = CRC_CCITTOnByteCalculate(pRaw, (uint32_t)consumed, INITIAL_CRC_VALUE);
+		}
+	}
+
+	pFrame[0u] = START_CHAR;
+	pFrame[1u] = SLAVE_ADRESS_DSP_B;
+	(void)BUFFER_UTILS_Uint16To8bitBuf(&pFrame[2u], dataSize);
+	pFrame[4u] = status;
+	(void)BUFFER_UTILS_Uint32To8bitBuf(&pFrame[5u], mDump.byteOffset);
+	(void)BUFFER_UTILS_Uint16To8bitBuf(&pFrame[9u], consumed);
+	(void)BUFFER_UTILS_Uint16To8bitBuf(&pFrame[11u], rawCrc);
+
+	frameLength = COMPRESSED_HEADER_SIZE + dataSize;
+
+	//lint -e{921} Cast to uint32_t to avoid prototype coercion.
+	mDump.crc = CRC_CCITTOnByteCalculate(&pFrame[0u], (uint32_t)frameLength, INITIAL_CRC_VALUE);
 
-	// We assume that the logging flash is word addressable
-	*pLogicalAddress += ByteNumber;
+	//lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+	pFrame[frameLength]      = (uint8_t)( (mDump.crc & 0xFF00u) >> 8u );	//CRC MSB
+	//lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+	pFrame[frameLength + 1u] = (uint8_t)(mDump.crc & 0x00FFu);			//CRC LSB
+	pFrame[frameLength + 2u] = STOP_CHAR;
+	frameLength += FRAME_TRAILER_SIZE;
+
+	mDump.logicalAddress += consumed;
+	mDump.byteOffset     += consumed;
+	mDump.bytesRemaining -= consumed;
+
+	mDump.bLastFramePrepared = (mDump.bytesRemaining == 0u) ? TRUE : FALSE;
+	mDump.frameLength[bufferIndex] = frameLength;
 }
 
 void SSB_BufferTransmitStart(const uint8_t * const p_bufferToTransmit,
@@ -513,36 +720,6 @@ void SSB_BufferTransmitStart(const uint8_t * const p_bufferToTransmit,
     SCI_TxStart(SCI_B, p_bufferToTransmit, numberOfBytesToTransmit);
 }
 
-bool_t SSB_TransmitDoneCheckAndWait(void)
-{
-    bool_t  b_transmitDone = FALSE;
-    int16_t status = FALSE;
-
-    // 100mS timeout - worst case.
-    Timer_Wait(50);
-    /*
-     * If the status from the semaphore is OK then poll for transmit
-     * complete.  This isn't super efficient, but by this point there is
-     * only a single character which is being moved through the shift resister,
-     * worst case for this is 174uS at 57600 baud.  SSB is only used on the
-     * surface, so the CPU isn't busy, so polling isn't so bad here.
-     */
-    if (1 == status)
-    {
-        while (!b_transmitDone)
-        {
-            b_transmitDone = SCI_TxDoneCheck(SCI_B);
-        }
-    }
-    /* Otherwise just check once. */
-    else
-    {
-        b_transmitDone = SCI_TxDoneCheck(SCI_B);
-    }
-
-    return b_transmitDone;
-}
-
 void SSB_BusInReceiveModeSet(void)
 {
     // Disable the transmitter.
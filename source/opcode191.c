@@ -18,11 +18,215 @@
 #include "timer.h"
 #include "comm.h"
 #include "opcode191.h"
+#include "utils.h"
+#include "tool_specific_config.h"
+#include "tool_specific_programming.h"
+#include "prom_hardware.h"
+#include "image_verify.h"
 
+// Memory which a range CRC can cover - the flash and the OTP.  A range must
+// lie within one of them, so a CRC never reads peripheral registers or RAM.
+#define OPCODE191_FLASH_START	0x300000uL
+#define OPCODE191_FLASH_END		0x340000uL		// One past the last word.
+#define OPCODE191_OTP_START		0x380400uL
+#define OPCODE191_OTP_END		0x380800uL		// One past the last word.
+
+//***************************************
+// Static declarations
+//***************************************
+
+/**
+ * Calculates the CRC for up to OPCODE191_TIME_SLICE_MS, then sends either
+ * the result or LOADER_FORMAT_IN_PROGRESS.
+ */
+static void crcSliceRunAndReply( void ) ;
+
+/**
+ * Checks that an address range lies within one of the memories which a range
+ * CRC can cover.
+ */
+static bool_t rangeIsReadable( Uint32 StartAddress, Uint32 Length ) ;
+
+static bool_t	mbCRCInProgress = FALSE;	// CRC started and not yet complete.
+static bool_t	mbCRCComplete = FALSE;		// CRC complete, result can be polled for.
+static ImageVerifyCRC_t	mCRC;				// CRC so far.
+static Uint16	mExpectedCRC;				// Expected CRC for a partition, zero for a range.
+
+
+//***************************************
+// Implementations from included files
+//***************************************
+
+/**
+ * Opcode 191 calculates the CRC of a partition, or of an arbitrary address
+ * range, on the DSP - using the same CRC as the partition CRC stored by opcode
+ * 39 - so the image doesn't need to be uploaded with opcode 38 to verify it.
+ * A range must lie within the flash or the OTP.
+ * The CRC is calculated in slices of OPCODE191_TIME_SLICE_MS, with the same
+ * ImageVerify_CRCStep() as the self test uses for its background image CRC.  If it isn't
+ * complete by the end of the first slice the reply is LOADER_FORMAT_IN_PROGRESS,
+ * and each OPCODE191_POLL calculates the next slice.  The final reply holds
+ * the CRC and the expected CRC (zero for a range), both in little endian form.
+ * This works in any loader state, and doesn't change the state.
+ */
 //lint -e{715} Symbol not referenced - common function prototype to bootloader and promloader.
 void opcode191_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,
                         Timer_t* timer)
 {
-    // ALWAYS invalid here
-    loader_MessageSend( LOADER_INVALID_OPCODE, 0, "" );
+	Uint16	MessageType;
+	Uint16	Partition;
+	Uint32	StartAddress;
+	Uint32	Length;
+
+	// Reset timeout timer before doing anything else, as a partition CRC
+	// could take a while.
+    Timer_TimerReset(timer);
+
+    if (message->dataLengthInBytes == 0u)
+    {
+        loader_MessageSend( LOADER_WRONG_NUM_PARAMETERS, 0, "" );
+        return;
+    }
+
+    MessageType = message->dataPtr[0];
+
+    switch (MessageType)
+    {
+    case OPCODE191_PARTITION:
+    	if (message->dataLengthInBytes != 3u)
+    	{
+    		loader_MessageSend( LOADER_WRONG_NUM_PARAMETERS, 0, "" );
+    	}
+    	else
+    	{
+    		Partition = utils_toUint16(&message->dataPtr[1], TARGET_ENDIAN_TYPE);
+
+    		if ( (PromHardware_PartitionRangeGet(Partition, &StartAddress, &Length) == FALSE)
+    				|| (PromHardware_PartitionCRCGetExpected(Partition, &mExpectedCRC) == FALSE) )
+    		{
+    			mbCRCInProgress = FALSE;
+    			mbCRCComplete = FALSE;
+    			loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+    		}
+    		else
+    		{
+    			mbCRCInProgress = TRUE;
+    			mbCRCComplete = FALSE;
+    			ImageVerify_CRCStart(&mCRC, StartAddress, Length);
+    			crcSliceRunAndReply();
+    		}
+    	}
+    	break;
+
+    case OPCODE191_RANGE:
+    	if (message->dataLengthInBytes != 9u)
+    	{
+    		loader_MessageSend( LOADER_WRONG_NUM_PARAMETERS, 0, "" );
+    	}
+    	else
+    	{
+    		StartAddress = utils_toUint32(&message->dataPtr[1], TARGET_ENDIAN_TYPE);
+    		Length = utils_toUint32(&message->dataPtr[5], TARGET_ENDIAN_TYPE);
+
+    		if (rangeIsReadable(StartAddress, Length) == FALSE)
+    		{
+    			mbCRCInProgress = FALSE;
+    			mbCRCComplete = FALSE;
+    			loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+    		}
+    		else
+    		{
+    			mbCRCInProgress = TRUE;
+    			mbCRCComplete = FALSE;
+    			ImageVerify_CRCStart(&mCRC, StartAddress, Length);
+    			mExpectedCRC = 0u;
+    			crcSliceRunAndReply();
+    		}
+    	}
+    	break;
+
+    case OPCODE191_POLL:
+    	// Polling with nothing started is an error - once complete, the result
+    	// is sent again for each poll, in case a reply was lost.
+    	if ( (mbCRCInProgress == FALSE) && (mbCRCComplete == FALSE) )
+    	{
+    		loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+    	}
+    	else
+    	{
+    		crcSliceRunAndReply();
+    	}
+    	break;
+
+    default:
+    	loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+    	break;
+    }
+
+    Timer_TimerReset(timer);
+}
+
+//***************************************
+// Definitions of static functions
+//***************************************
+
+static void crcSliceRunAndReply( void )
+{
+	Uint32			SliceStartTime;
+	bool_t			bDone;
+	unsigned char	Reply[4];
+
+	if (mbCRCInProgress == TRUE)
+	{
+		Timer_StopWatchSet(&SliceStartTime);
+
+		// Always do at least one chunk, so that every poll makes progress.
+		do
+		{
+			bDone = ImageVerify_CRCStep(&mCRC, OPCODE191_CHUNK_WORDS);
+		} while ( (bDone == FALSE)
+					&& (Timer_StopWatchGet(SliceStartTime) < OPCODE191_TIME_SLICE_MS) );
+
+		if (bDone == TRUE)
+		{
+			mbCRCInProgress = FALSE;
+			mbCRCComplete = TRUE;
+		}
+	}
+
+	if (mbCRCComplete == TRUE)
+	{
+		utils_to2Bytes(&Reply[0], mCRC.RunningCRC, LITTLE_ENDIAN);
+		utils_to2Bytes(&Reply[2], mExpectedCRC, LITTLE_ENDIAN);
+		loader_MessageSend( LOADER_OK, 4, (char *)Reply );
+	}
+	else
+	{
+		loader_MessageSend( LOADER_FORMAT_IN_PROGRESS, 0, "" );
+	}
+}
+
+static bool_t rangeIsReadable( Uint32 StartAddress, Uint32 Length )
+{
+	bool_t	bReadable = FALSE;
+
+	if (Length != 0u)
+	{
+		if ( (StartAddress >= OPCODE191_FLASH_START) && (StartAddress < OPCODE191_FLASH_END)
+				&& (Length <= (OPCODE191_FLASH_END - StartAddress)) )
+		{
+			bReadable = TRUE;
+		}
+		else if ( (StartAddress >= OPCODE191_OTP_START) && (StartAddress < OPCODE191_OTP_END)
+				&& (Length <= (OPCODE191_OTP_END - StartAddress)) )
+		{
+			bReadable = TRUE;
+		}
+		else
+		{
+			// Outside the flash and the OTP, or crosses the end of one.
+		}
+	}
+
+	return bReadable;
 }
@@ -25,8 +25,20 @@
 #define PARAM_LOW_OFFSET    0u			///< Lower Dpoint argument buffer index.
 #define PARAM_HIGH_OFFSET   1u			///< Upper Dpoint argument buffer index.
 
+#define CONFIG_PARTITION_INDEX      1u				///< Index of the configuration partition.
+#define CONFIG_RECORD_ADDRESS       0x00002010u		///< Address of the configuration record written by opcode 205.
+#define CONFIG_RECORD_END_ADDRESS   0x0000221Cu		///< Address following the configuration record.
+#define DPOINT_TABLE_OFFSET         105u			///< Offset of the first Dpoint in the configuration record.
+#define BYTES_PER_DPOINT            4u				///< Number of bytes per Dpoint in the configuration record.
+#define NUMBER_OF_DPOINTS           104u			///< Number of Dpoints in the configuration record.
+#define DPOINT_TABLE_SIZE           (NUMBER_OF_DPOINTS * BYTES_PER_DPOINT)	///< Dpoint table size (in bytes).
+
 //-----------------------------------------------------------------------------
-//static uint8_t m_read_config_buffer[1024];   //ȡ
+/// RAM copy of the Dpoints held in the configuration record.
+static uint8_t m_dpoint_table[DPOINT_TABLE_SIZE];
+
+/// TRUE once m_dpoint_table holds the Dpoints in flash.
+static bool_t m_b_dpoint_table_valid = FALSE;
 
 // ----------------------------------------------------------------------------
 /**
@@ -40,6 +52,13 @@
  * It is the case for the toolface vector Dpoints and the
  * status word Dpoints.
  *
+ * @note
+ * The Dpoints are read from the configuration record in flash once, into a
+ * RAM table, and all the Dpoints requested are sent in a single response.
+ * The table is read again after opcode204_DpointTableInvalidate has been
+ * called.  If the upper index is below the lower one, only the lower Dpoint
+ * is sent, as it used to be.
+ *
  * @param   pCommand            Pointer to the command
  * @param   pResponse           Pointer to the response
  * @retval                      N.A
@@ -48,48 +67,60 @@
 void opcode204_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,Timer_t* timer)
 {
     const uint16_t LowerDpointIndex = (uint16_t)message->dataPtr[PARAM_LOW_OFFSET];     //lint !e960 pointer arithmetic
-    //const uint16_t UpperDpointIndex = (uint16_t)message->dataPtr[PARAM_HIGH_OFFSET];    //lint !e960 pointer arithmetic
-    uint8_t bufferOffset = 105 + 4 * LowerDpointIndex;
-    uint8_t buffer[4];
-    uint32_t startAddress = 0x00002010;
-    startAddress += bufferOffset;
+    uint16_t UpperDpointIndex = (uint16_t)message->dataPtr[PARAM_HIGH_OFFSET];          //lint !e960 pointer arithmetic
 
-    /*
-    // ڵһλȡ
-    if(LowerDpointIndex == 0){
-        if(rspartition_partition_ptr_get((uint8_t)1)->partition_error_status == RS_ERR_PARTITION_NEEDS_FORMAT){
-            loader_MessageSend(LOADER_FORMAT_IN_PROGRESS, 0, "");
-            return;
-        }
-        flash_hal_device_read(0x00002010, (uint32_t)524u, &m_read_config_buffer[0]);
+    if (UpperDpointIndex < LowerDpointIndex)
+    {
+        UpperDpointIndex = LowerDpointIndex;
     }
-    bufferOffset = 105 + 4 * LowerDpointIndex;
-    buffer[0] = m_read_config_buffer[bufferOffset];
-    buffer[1] = m_read_config_buffer[bufferOffset+1];
-    buffer[2] = m_read_config_buffer[bufferOffset+2];
-    buffer[3] = m_read_config_buffer[bufferOffset+3];
-*/
-
 
     // ж÷Ƿʽ
-    if(rspartition_partition_ptr_get(1)->partition_error_status == RS_ERR_PARTITION_NEEDS_FORMAT){
+    if(rspartition_partition_ptr_get(CONFIG_PARTITION_INDEX)->partition_error_status == RS_ERR_PARTITION_NEEDS_FORMAT){
         loader_MessageSend(LOADER_FORMAT_IN_PROGRESS, 0, "");
         return;
     }
     // ж÷Ƿд
-    if(rspartition_partition_ptr_get(1)->next_available_address < 0x0000221C){
+    if( (rspartition_partition_ptr_get(CONFIG_PARTITION_INDEX)->next_available_address < CONFIG_RECORD_END_ADDRESS)
+            || (UpperDpointIndex >= NUMBER_OF_DPOINTS) ){
         loader_MessageSend(LOADER_PARAMETER_OUT_OF_RANGE, 0, "");
         return;
     }
 
-    if(flash_hal_device_read(startAddress, (uint32_t)4u, &buffer[0]) == FLASH_HAL_NO_ERROR){
-        loader_MessageSend( LOADER_OK, 4, (char*)buffer );
+    if (!m_b_dpoint_table_valid)
+    {
+        if (flash_hal_device_read(CONFIG_RECORD_ADDRESS + DPOINT_TABLE_OFFSET,
+                                  (uint32_t)DPOINT_TABLE_SIZE,
+                                  &m_dpoint_table[0]) == FLASH_HAL_NO_ERROR)
+        {
+            m_b_dpoint_table_valid = TRUE;
+        }
+    }
+
+    if (m_b_dpoint_table_valid){
+        //lint -e{926} cast from uint8_t* to char*, as for the other responses.
+        loader_MessageSend( LOADER_OK,
+                            ((UpperDpointIndex - LowerDpointIndex) + 1u) * BYTES_PER_DPOINT,
+                            (char*)&m_dpoint_table[LowerDpointIndex * BYTES_PER_DPOINT] );
     }else{
         loader_MessageSend(LOADER_INVALID_MESSAGE, 0, "");
     }
 
 }
 
+// ----------------------------------------------------------------------------
+/**
+ * opcode204_DpointTableInvalidate throws away the RAM copy of the Dpoints, so
+ * that the next opcode 204 reads them from flash again.  It must be called
+ * whenever the configuration partition is written or erased - by opcode 205,
+ * by opcode 13 formatting it and by opcode 217 erasing the serial flash.
+ *
+ */
+// ----------------------------------------------------------------------------
+void opcode204_DpointTableInvalidate(void)
+{
+    m_b_dpoint_table_valid = FALSE;
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
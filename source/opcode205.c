@@ -18,6 +18,7 @@
 
 // ----------------------------------------------------------------------------
 #include "opcode205.h"
+#include "opcode204.h"
 #include "rspages.h"
 #include "rspartition.h"
 #include "sci.h"
@@ -28,7 +29,7 @@
 #define OPCODE_205_DATA_OFFSET  2u		///< Index of the first byte used to update the Dpoints.
 
 static uint8_t m_write_config_buffer[1024];
-static uint8_t bufferOffset = 5;    //ƫ
+static uint16_t bufferOffset = 5;    //ƫ
 uint8_t channal_num[20] = { 0x11u, 0x0Cu, 0x09u, 0x01u, 0x09u, 0x0Eu, 0x05u,
                             0x07u, 0x12u, 0x07u, 0x0Au, 0x09u, 0x02u, 0x05u,
                             0x04u, 0x08u, 0x10u, 0x19u, 0x15u, 0x10u }; //ÿ¼Ҫ¼ͨ
@@ -104,9 +105,10 @@ void opcode205_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,
         p_write_data.partition_logical_end_addr =
                 p_partition_info->end_address;
         p_write_data.next_free_addr = 8208;
-        p_write_data.p_write_buffer = &m_write_config_buffer;
+        p_write_data.p_write_buffer = &m_write_config_buffer[0];
         p_write_data.bytes_to_write = 524;
         rspages_page_data_write(&p_write_data);
+        opcode204_DpointTableInvalidate();
     }
     loader_MessageSend( LOADER_OK, 0, "");
     Timer_TimerReset(timer);
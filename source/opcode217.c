@@ -20,6 +20,7 @@
 
 #include "opcode217.h"
 #include "opcode221.h"
+#include "opcode204.h"
 #include "lld.h"
 #include "m95.h"
 #include "XDImemory.h"
@@ -50,12 +51,14 @@ void opcode217_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,Tim
     const uint16_t     blockIdentifier = (uint16_t)message->dataPtr[BLOCK_ID_OFFSET] & 0xFFu;
     EM95PollStatus_t m95EraseStatus;
     bool_t XDIEraseStatus = FALSE;
-    main_flash_status_t EraseStatus;
     // Record the device erased and send the command
     switch (blockIdentifier)
     {
         case 2:  //SPI EPPROM
             m95EraseStatus = M95_DeviceErase();
+            // The configuration record has gone (or partly gone, if the
+            // erase failed), so opcode 204 must read it again.
+            opcode204_DpointTableInvalidate();
             if (m95EraseStatus == M95_POLL_NO_WRITE_IN_PROGRESS)
             {
                 loader_MessageSend( LOADER_OK, 0, "" );
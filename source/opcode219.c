@@ -11,6 +11,12 @@
  * This is called a segment.
  * The segment to dump is identified on two bytes (16 words).
  * This leads to a maximum memory size : 2^16 * 256(words) = 16Mwords, 32Mbytes.
+ * A bulk request also gives a number of packets, which are sent back as a
+ * stream of replies without waiting for a request for each one.  The next
+ * packet is read from the memory while the previous one is being sent, so
+ * the dump runs at the speed of the link rather than of the request/reply
+ * round trip.  Each bulk reply also holds a sequence number, so a bulk packet
+ * is at most 255 words to keep the reply within COMM_MAX_LENGTH.
  *
  *
  * @attention
@@ -27,20 +33,41 @@
 #include "opcode219.h"
 #include "flash_hal.h"
 #include "rspartition.h"
+#include "buffer_utils.h"
 
 #define OPCODE_219_ADDRESS_LOW_OFFSET  	0u		///< Address LSB offset.
 #define OPCODE_219_ADDRESS_HIGH_OFFSET 	1u		///< Address MSB offset.
 #define OPCODE_219_PACKET_SIZE_OFFSET  	2u		///< Packet size offset.
 
+#define OPCODE_219_PACKET_COUNT_OFFSET	5u		///< Bulk read packet count offset (2 bytes).
+#define OPCODE_219_BULK_LENGTH			7u		///< Bulk read command length.
+
 #define SEGMENT_SIZE_IN_WORDS	512u	///< Segment size in words.
 
-uint8_t responseBuffer[1032];
+#define SEQUENCE_NUMBER_SIZE	2u		///< Bulk read replies start with a sequence number.
+
+/// Largest bulk packet (255 words), so the reply fits in COMM_MAX_LENGTH.
+#define MAX_BULK_PACKET_BYTES	(COMM_MAX_LENGTH - SEQUENCE_NUMBER_SIZE)
+
+/// Size of a bulk read reply, with room for the message to be built around it.
+#define BULK_FRAME_SIZE			(LOADER_STREAM_PREFIX_LENGTH + SEQUENCE_NUMBER_SIZE \
+								 + MAX_BULK_PACKET_BYTES + LOADER_STREAM_SUFFIX_LENGTH)
+
+static void opcode219_bulkRead(const rs_partition_info_t * const p_partition,
+                               const uint32_t firstSegment,
+                               const uint16_t packetCount,
+                               const uint16_t ByteCount);
+
+/// Reply buffer (at least 512 bytes) - also used as the two bulk read reply buffers.
+uint8_t responseBuffer[2u * BULK_FRAME_SIZE];
 extern uint8_t selectPartitionIndex;
 // ----------------------------------------------------------------------------
 /**
  * opcod219 reads the content of a logging memory segment (Fixed or Circular partition segment).
  * Sends back the data in the buffer pointed by pResponse->bufferPointer
- * The command format is <219><StartAddressLSB><StartAddressMSB><PacketSize(words)>.
+ * The command format is <219><Segment(4 bytes)><PacketSize(words)>.
+ * The bulk read command format is <219><Segment(4 bytes)><PacketSize(words)><PacketCount(2 bytes)>,
+ * and each reply is <SequenceNumber(2 bytes)><Data>, see opcode219_bulkRead.
  *
  * @param   pCommand        Pointer to the command
  * @param   pResponse       Pointer to the response
@@ -49,8 +76,10 @@ extern uint8_t selectPartitionIndex;
 void opcode219_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,Timer_t* timer){
 	uint16_t 				WordCount;
 	uint16_t 				ByteCount;
+	uint16_t				packetCount;
 	flash_hal_error_t   flash_read_status;
 	uint32_t address = 0u;
+	uint32_t segment;
 
 	// Get the number of words to dump
 	//WordCount = (uint16_t)message->dataPtr[OPCODE_219_PACKET_SIZE_OFFSET] & 0xFFu;		    //lint !e960 pointer arithmetic
@@ -68,25 +97,126 @@ void opcode219_execute(ELoaderState_t* loaderState, LoaderMessage_t* message,Tim
 //	address = (uint32_t)(message->dataPtr[OPCODE_219_ADDRESS_LOW_OFFSET])								//lint !e960 pointer arithmetic
 //	        + ((uint32_t)(message->dataPtr[OPCODE_219_ADDRESS_HIGH_OFFSET] ) << 8u);					//lint !e960 pointer arithmetic
 
-	address = (uint32_t)(message->dataPtr[OPCODE_219_ADDRESS_LOW_OFFSET])                               //lint !e960 pointer arithmetic
+	segment = (uint32_t)(message->dataPtr[OPCODE_219_ADDRESS_LOW_OFFSET])                               //lint !e960 pointer arithmetic
 	            + ((uint32_t)(message->dataPtr[OPCODE_219_ADDRESS_HIGH_OFFSET] ) << 8u)
 	            + ((uint32_t)(message->dataPtr[2] ) << 16u)
 	            + ((uint32_t)(message->dataPtr[3] ) << 24u);
 
-	address = address * SEGMENT_SIZE_IN_WORDS;
 	const rs_partition_info_t *p_partition = rspartition_partition_ptr_get(selectPartitionIndex);
-	address += p_partition->start_address;
-    flash_read_status = flash_hal_device_read(address,ByteCount,&responseBuffer[0u]);
 
-	if(flash_read_status == FLASH_HAL_NO_ERROR){
-		loader_MessageSend( LOADER_OK, ByteCount, (char*)responseBuffer );
+	if (message->dataLengthInBytes == OPCODE_219_BULK_LENGTH)
+	{
+		packetCount = (uint16_t)message->dataPtr[OPCODE_219_PACKET_COUNT_OFFSET]
+		            + ((uint16_t)message->dataPtr[OPCODE_219_PACKET_COUNT_OFFSET + 1u] << 8u);
+
+		// The sequence number takes two bytes of the reply.
+		if (ByteCount > MAX_BULK_PACKET_BYTES)
+		{
+			ByteCount = MAX_BULK_PACKET_BYTES;
+		}
+
+		opcode219_bulkRead(p_partition, segment, packetCount, ByteCount);
 	}
-	else                                              // The opcode is not processed
+	else
 	{
-		loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+		address = segment * SEGMENT_SIZE_IN_WORDS;
+		address += p_partition->start_address;
+	    flash_read_status = flash_hal_device_read(address,ByteCount,&responseBuffer[0u]);
+
+		if(flash_read_status == FLASH_HAL_NO_ERROR){
+			loader_MessageSend( LOADER_OK, ByteCount, (char*)responseBuffer );
+		}
+		else                                              // The opcode is not processed
+		{
+			loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+		}
 	}
 	Timer_TimerReset(timer);
 }
+
+
+// ----------------------------------------------------------------------------
+/**
+ * opcode219_bulkRead sends a number of consecutive packets, starting at the
+ * start of a segment, as a stream of replies.  Each reply holds a sequence
+ * number (starting from zero, LSB first) followed by the packet data, and
+ * each packet follows straight on from the one before, so nothing is skipped
+ * whatever the packet size.  The two halves of the reply buffer are used in
+ * turn - the next packet is read into one while the other is being sent.
+ * If a packet can't be read, the reply for it has the error status and just
+ * the sequence number, and no more packets are sent.  The whole request is
+ * rejected with a single error reply if any of it is outside the partition.
+ *
+ * @param   p_partition     Pointer to the selected partition.
+ * @param   firstSegment    Segment to start from.
+ * @param   packetCount     Number of packets to send.
+ * @param   ByteCount       Number of bytes in each packet, up to MAX_BULK_PACKET_BYTES.
+ */
+// ----------------------------------------------------------------------------
+static void opcode219_bulkRead(const rs_partition_info_t * const p_partition,
+                               const uint32_t firstSegment,
+                               const uint16_t packetCount,
+                               const uint16_t ByteCount)
+{
+	uint8_t*			p_frame;
+	uint8_t*			p_data;
+	uint32_t			address;
+	uint16_t			sequence;
+	uint16_t			dataLength;
+	uint8_t				status = LOADER_OK;
+	flash_hal_error_t	flash_read_status = FLASH_HAL_NO_ERROR;
+
+	if ( (p_partition == NULL) || (packetCount == 0u)
+			|| (firstSegment > (p_partition->end_address - p_partition->start_address) / SEGMENT_SIZE_IN_WORDS)
+			|| (((uint32_t)packetCount * ByteCount)
+			       > (p_partition->end_address - p_partition->start_address + 1u)
+			            - (firstSegment * SEGMENT_SIZE_IN_WORDS)) )
+	{
+		loader_MessageSend( LOADER_PARAMETER_OUT_OF_RANGE, 0, "" );
+		return;
+	}
+
+	loader_MessageStreamStart();
+
+	address = p_partition->start_address + (firstSegment * SEGMENT_SIZE_IN_WORDS);
+
+	for (sequence = 0u; (sequence < packetCount) && (status == LOADER_OK); sequence++)
+	{
+		// The first packet is read here, the rest were read while the
+		// previous reply was being sent.
+		p_frame = &responseBuffer[(sequence & 1u) * BULK_FRAME_SIZE];
+		p_data  = &p_frame[LOADER_STREAM_PREFIX_LENGTH];
+
+		if (sequence == 0u)
+		{
+			flash_read_status = flash_hal_device_read(address, ByteCount, &p_data[SEQUENCE_NUMBER_SIZE]);
+			address += ByteCount;
+		}
+
+		(void)BUFFER_UTILS_Uint16To8bitBuf(p_data, sequence);
+		dataLength = SEQUENCE_NUMBER_SIZE + ByteCount;
+
+		if (flash_read_status != FLASH_HAL_NO_ERROR)
+		{
+			status = LOADER_PARAMETER_OUT_OF_RANGE;
+			dataLength = SEQUENCE_NUMBER_SIZE;
+		}
+
+		loader_MessageStreamSend(status, dataLength, p_frame);
+
+		// The other buffer has now been taken by the transmitter, so read the
+		// next packet into it while this one is being sent.
+		if ( (status == LOADER_OK) && ((sequence + 1u) < packetCount) )
+		{
+			p_frame = &responseBuffer[((sequence + 1u) & 1u) * BULK_FRAME_SIZE];
+			flash_read_status = flash_hal_device_read(address, ByteCount,
+			                                          &p_frame[LOADER_STREAM_PREFIX_LENGTH + SEQUENCE_NUMBER_SIZE]);
+			address += ByteCount;
+		}
+	}
+
+	loader_MessageStreamEnd();
+}
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 /*+- OmniWorks Replacement History - fe_dhs`dev28335`tool`crs`acqmtc_dsp_b`src:opcode219.c;3 */
@@ -22,17 +22,17 @@
 #include "genericIO.h"
 #include "utils.h"
 #include "Flash2833x_API_Library.h"
-//Partition numbers
-#define BOOT_PARTITION			0 		//boot-loader's partition number
-#define APPLICATION_PARTITION	1 		//application's partition number
-#define PARAMETER_PARTITION		2		//parameter's partition number
-#define CONFIG_PARTITION		3		//configuration's partition number
-#define UNDEFINED_PARTITION		0xFF 	//undefined partition number (initialize to this)
+#include "image_verify.h"
 
 
 static bool_t erasePartition(Uint16 partition);
 static bool_t CheckForValidPartitionAndSetupParameters(void);
 static bool_t SetupPartitionParameters(Uint16 PartitionNumber, PartitionParameters_t* pParameters);
+static bool_t StageIntoBuffer(Uint8* pData, Uint32 LengthInBytes, Uint32 StartAddressInFlash,
+                              Uint32 BufferOffset);
+
+// Length of each half of the buffer used for double buffered incremental writes.
+#define BUFFER_HALF_LENGTH	((Uint32)BUFFER_LENGTH >> 1)
 
 
 static PartitionParameters_t mPartitionParameters = {UNDEFINED_PARTITION, FALSE, FALSE, 0u, 0u, 0u, 0u, {0u, 0u, 0u, 0}, 0u};
@@ -45,6 +45,16 @@ static PartitionParameters_t mPartitionParameters = {UNDEFINED_PARTITION, FALSE,
 static bool_t mbAllowBootloaderProgramming = ALLOW_BOOTLOADER_PROGRAMMING;
 static bool_t mbAllowIncrementalFlashWrite = ALLOW_INCREMENTAL_FLASH_WRITE;
 
+// Incremental writes are double buffered - each block of data is staged into
+// one half of the buffer, and programmed into the flash from there the next
+// time the loader waits for a message, while the next block is received.
+static Uint32 mStagingBufferOffset = 0u;		// Half of the buffer to stage the next block into.
+static bool_t mbProgramPending = FALSE;			// A staged block is waiting to be programmed.
+static bool_t mbPendingProgramFailed = FALSE;	// A block failed to program after it was acknowledged.
+static Uint32 mPendingAddress;					// Flash address of the pending block.
+static Uint32 mPendingLengthInWords;			// Length of the pending block.
+static Uint32 mPendingBufferOffset;				// Offset of the pending block in the buffer.
+
 
 /**
  * Writes the program data to the flash memory.  If mbAllowIncrementalFlashWrite is FALSE,
@@ -52,6 +62,11 @@ static bool_t mbAllowIncrementalFlashWrite = ALLOW_INCREMENTAL_FLASH_WRITE;
  * If mbAllowIncrementalFlashWrite is TRUE, data is still copied into the temporary buffer
  * but is then programmed into the flash (which has been previously erased with
  * PromHardware_PartitionPrepare()).
+ * Incremental writes are double buffered - the data is copied into the free half of
+ * the buffer and left pending, so that the reply can be sent straight away, and is
+ * programmed by PromHardware_PendingProgramComplete() while the next block is being
+ * received.  If a previous block is still pending it is programmed here first.  A block
+ * which fails to program after it has been acknowledged fails the next write.
  * 
  * @param pData					Array of data to write to the ROM
  * @param LengthInBytes 		The length of the data array, in bytes.
@@ -61,64 +76,129 @@ static bool_t mbAllowIncrementalFlashWrite = ALLOW_INCREMENTAL_FLASH_WRITE;
  */
 bool_t PromHardware_ProgramMemoryWrite(Uint8* pData, Uint32 LengthInBytes, Uint32 StartAddressInFlash)
 {
-	Uint32 			BufferAddress;
-	Uint32 			wordLen = LengthInBytes >> 1; //divide by 2
-	Uint16 			workingData;
-	Uint32 			i = 0; //counter
-	bool_t 			bRomCanBeWritten = FALSE;
-	FlashStatus_t	FlashStatus;
+	bool_t bRomCanBeWritten = FALSE;
 
-	if (CheckForValidPartitionAndSetupParameters() == TRUE)
+	if (mbAllowIncrementalFlashWrite == FALSE)
 	{
-		if ( (StartAddressInFlash >= mPartitionParameters.TargetStartAddress) && ( (StartAddressInFlash+wordLen) < mPartitionParameters.TargetEndAddress) )
+		bRomCanBeWritten = StageIntoBuffer(pData, LengthInBytes, StartAddressInFlash, 0u);
+	}
+	else if ( (mbPendingProgramFailed == FALSE) && ( (LengthInBytes >> 1) <= BUFFER_HALF_LENGTH) )
+	{
+		// Stage into the free half first, then program the other half if it's
+		// still pending (i.e. the loader didn't wait between the two blocks).
+		bRomCanBeWritten = StageIntoBuffer(pData, LengthInBytes, StartAddressInFlash, mStagingBufferOffset);
+
+		if (bRomCanBeWritten == TRUE)
 		{
-			// Generate address in buffer to copy data into - if an incremental flash write,
-			// it is likely that this buffer is quite small so we always start at the beginning
-			// of the buffer, otherwise the buffer is large enough to hold an entire image
-			// so setup the address to be offset by the correct amount.
-			if (mbAllowIncrementalFlashWrite == TRUE)
-			{
-				BufferAddress = BUFFER_BASE_ADDRESS;
-			}
-			else
-			{
-			    BufferAddress = BUFFER_BASE_ADDRESS + (StartAddressInFlash - mPartitionParameters.TargetStartAddress);
-			}
+			bRomCanBeWritten = PromHardware_PendingProgramComplete();
+		}
 
-			// Check to make sure new data can fit into the buffer.
-			if ( (BufferAddress + wordLen) <= ( (Uint32)BUFFER_BASE_ADDRESS + (Uint32)BUFFER_LENGTH) )
-			{
-				bRomCanBeWritten = TRUE;
-			}
+		if (bRomCanBeWritten == TRUE)
+		{
+			mPendingAddress = StartAddressInFlash;
+			mPendingLengthInWords = LengthInBytes >> 1;
+			mPendingBufferOffset = mStagingBufferOffset;
+			mbProgramPending = TRUE;
+			mStagingBufferOffset = BUFFER_HALF_LENGTH - mStagingBufferOffset;
 		}
 	}
+	else
+	{
+		;	// Previous block failed, or too long for half of the buffer.
+	}
 
-	if (bRomCanBeWritten == TRUE)
+	return bRomCanBeWritten;
+}
+
+
+/**
+ * Programs the block left pending by PromHardware_ProgramMemoryWrite(), if there is
+ * one.  This is called each time the loader starts waiting for a message, so that
+ * the flash is programmed while the next message is being received, and before
+ * anything which needs the whole image to be in the flash.
+ *
+ * @return bool_t				FALSE if any pending block has failed to program, else TRUE.
+ *
+ */
+bool_t PromHardware_PendingProgramComplete(void)
+{
+	if (mbProgramPending == TRUE)
 	{
-		// Reformat incoming data and write them into RAM buffer.
-		// We suppress the Lint warning for 'BufferAddress may not have been initialised'
-        // - there is no path through the code where we can get here without it being set.
-		for(i = 0; i < wordLen; i++)
-		{
-			workingData = utils_toUint16(&pData[i*2], DOWNLOAD_ENDIANESS);
-			genericIO_16bitWrite( (BufferAddress + i), workingData);		//lint !e644
-		}
-		// Copy from RAM buffer into flash, always starting at BUFFER_BASE_ADDRESS.
-		// (In incremental write mode, the data is always written into the start of
-		// the buffer and then copied pass by pass, rather than waiting until the end).
-		if (mbAllowIncrementalFlashWrite == TRUE)
+		mbProgramPending = FALSE;
+
+		if (PromHardware_StagedMemoryProgram(mPendingAddress, mPendingLengthInWords,
+		                                     mPendingBufferOffset) == FALSE)
 		{
-			bRomCanBeWritten = ToolSpecificProgramming_SafeFlashProgram((void*)StartAddressInFlash,
-			                                                            (Uint16*)BUFFER_BASE_ADDRESS,
-			                                                            wordLen,
-																		&FlashStatus);
+			mbPendingProgramFailed = TRUE;
 		}
 	}
 
+	return (mbPendingProgramFailed == TRUE) ? FALSE : TRUE;
+}
+
+
+/**
+ * Copies program data into the temporary buffer, without programming it into
+ * the flash.  If mbAllowIncrementalFlashWrite is TRUE, the data is copied to
+ * BufferOffset words from the start of the buffer, so that several blocks of
+ * data can be staged at once and programmed later with
+ * PromHardware_StagedMemoryProgram().  If mbAllowIncrementalFlashWrite is FALSE,
+ * the buffer holds the entire image, so BufferOffset is ignored and the data
+ * is copied to its offset in the partition.
+ *
+ * @param pData					Array of data to write to the ROM
+ * @param LengthInBytes 		The length of the data array, in bytes.
+ * @param StartAddressInFlash	The start address of the flash into which the data will be written.
+ * @param BufferOffset			Offset into the buffer (in words) for an incremental write.
+ * @return bool_t				TRUE if the data was staged, else FALSE.
+ *
+ */
+bool_t PromHardware_ProgramMemoryStage(Uint8* pData, Uint32 LengthInBytes, Uint32 StartAddressInFlash,
+                                       Uint32 BufferOffset)
+{
+	bool_t bRomCanBeWritten = FALSE;
+
+	// Any block left pending by PromHardware_ProgramMemoryWrite() could be in
+	// the part of the buffer this data is going into, so program it first.
+	if (PromHardware_PendingProgramComplete() == TRUE)
+	{
+		bRomCanBeWritten = StageIntoBuffer(pData, LengthInBytes, StartAddressInFlash, BufferOffset);
+	}
+
 	return bRomCanBeWritten;
 }
 
 
+/**
+ * Programs data previously staged with PromHardware_ProgramMemoryStage() into
+ * the flash.  This only does anything if mbAllowIncrementalFlashWrite is TRUE -
+ * otherwise the whole image is programmed by PromHardware_PartitionProgram().
+ *
+ * @param StartAddressInFlash	The start address of the flash into which the data will be written.
+ * @param LengthInWords			The length of the staged data, in words.
+ * @param BufferOffset			Offset into the buffer (in words) where the data was staged.
+ * @return bool_t				TRUE if the write encountered no errors, else FALSE.
+ *
+ */
+bool_t PromHardware_StagedMemoryProgram(Uint32 StartAddressInFlash, Uint32 LengthInWords, Uint32 BufferOffset)
+{
+	bool_t 			bRomWritten = TRUE;
+	FlashStatus_t	FlashStatus;
+
+	// Copy from RAM buffer into flash.  (In incremental write mode, the data is
+	// copied pass by pass, rather than waiting until the end).
+	if (mbAllowIncrementalFlashWrite == TRUE)
+	{
+		bRomWritten = ToolSpecificProgramming_SafeFlashProgram((void*)(uintptr_t)StartAddressInFlash,
+		                                                       (Uint16*)(uintptr_t)(BUFFER_BASE_ADDRESS + BufferOffset),
+		                                                       LengthInWords,
+		                                                       &FlashStatus);
+	}
+
+	return bRomWritten;
+}
+
+
 /**
  * Gets whether the indicated partition is a valid partition in the current
  * target.
@@ -195,6 +275,11 @@ Uint16 PromHardware_PartitionPrepare(Uint16 partition)
 	mPartitionParameters.bPartitionProgrammed = FALSE;
 	mPartitionParameters.bPartitionPrepared = FALSE;
 
+	// Any block still pending belongs to the previous download.
+	mbProgramPending = FALSE;
+	mbPendingProgramFailed = FALSE;
+	mStagingBufferOffset = 0u;
+
 	if (CheckForValidPartitionAndSetupParameters() == TRUE)
 	{
 		// Assume partition can be prepared...
@@ -271,9 +356,14 @@ bool_t PromHardware_PartitionCRCValidate(Uint16 crc)
 		new_crc = crc_calcFinalCRC(new_crc, WORD_CRC_CALC);
 		return new_crc==crc;
 	}
-	// Compute CRC from flash itself.
+	// Compute CRC from flash itself, once the last block is in the flash.
 	else
 	{
+		if (PromHardware_PendingProgramComplete() == FALSE)
+		{
+			return FALSE;
+		}
+
 		// If CRC calculation fails (invalid partition,normally) then return false.
 		if (PromHardware_PartitionCRCCalculate(mPartitionParameters.PartitionNumber, &new_crc) == FALSE)
 		{
@@ -309,8 +399,16 @@ Uint16 PromHardware_PartitionProgram(void)
 
     // If NOT doing incremental flash write we need to erase the appropriate partition
 	// and then copy the code from the RAM buffer into the flash.
-	// (If doing incremental flash write, the flash will already have been written).
-    if (mbAllowIncrementalFlashWrite == FALSE)
+	// (If doing incremental flash write, the flash will already have been written,
+	// apart from any block which is still pending).
+    if (mbAllowIncrementalFlashWrite == TRUE)
+    {
+        if (PromHardware_PendingProgramComplete() == FALSE)
+        {
+            return 3;
+        }
+    }
+    else
     {
         if (erasePartition(mPartitionParameters.PartitionNumber) == FALSE)
         {
@@ -323,7 +421,7 @@ Uint16 PromHardware_PartitionProgram(void)
 		}
 
 		// Copy from RAM buffer into flash, starting at BUFFER_BASE_ADDRESS.
-		bProgrammedOK = ToolSpecificProgramming_SafeFlashProgram((void*)mPartitionParameters.TargetStartAddress,
+		bProgrammedOK = ToolSpecificProgramming_SafeFlashProgram((void*)(uintptr_t)mPartitionParameters.TargetStartAddress,
 																	(Uint16*)BUFFER_BASE_ADDRESS,
 																	mPartitionParameters.PartitionLength,
 																	&mPartitionParameters.FlashStatus);
@@ -341,12 +439,19 @@ Uint16 PromHardware_PartitionProgram(void)
 		return 2; //failed to calculated the new crc
 	}
 
-	bProgrammedOK = ToolSpecificProgramming_SafeFlashProgram((void*)mPartitionParameters.CRCAddress,
+	bProgrammedOK = ToolSpecificProgramming_SafeFlashProgram((void*)(uintptr_t)mPartitionParameters.CRCAddress,
 																&crc, (Uint32)1, &mPartitionParameters.FlashStatus);
 	if(bProgrammedOK == FALSE)
 	{
 		return mPartitionParameters.FlashStatus.FlashStatusCode;
 	}
+
+	// The CRC has just been calculated from the flash itself, so record a
+	// verified image descriptor to let the next boot skip the full CRC.
+	// If the descriptor can't be written the self test just does a full CRC.
+	(void)ImageVerify_DescriptorWrite(mPartitionParameters.PartitionNumber,
+										mPartitionParameters.PartitionLength, crc);
+
     mPartitionParameters.bPartitionProgrammed = TRUE;
     mPartitionParameters.bPartitionPrepared = FALSE;
 	return 0; //no error
@@ -392,7 +497,7 @@ bool_t PromHardware_PartitionCRCCalculate(Uint16 partition, Uint16* crc)
 	if (crc != NULL)
 	{
 		(*crc) = 0; //initialize CRC to known value;
-		(*crc) = crc_calcRunningCRC(*crc,(const Uint16*)TempParameters.TargetStartAddress,
+		(*crc) = crc_calcRunningCRC(*crc,(const Uint16*)(uintptr_t)TempParameters.TargetStartAddress,
 										TempParameters.PartitionLength, WORD_CRC_CALC);
 		(*crc) = crc_calcFinalCRC(*crc, WORD_CRC_CALC);
 		return TRUE;
@@ -404,6 +509,32 @@ bool_t PromHardware_PartitionCRCCalculate(Uint16 partition, Uint16* crc)
 }
 
 
+/**
+ * Gets the start address and length of the given partition, e.g. so that its
+ * CRC can be calculated in slices.  As with PromHardware_PartitionCRCCalculate(),
+ * any partition can be used here, not just the ones which we're allowed to
+ * write to.
+ *
+ * @param partition The partition to get the address range of.
+ * @param pStartAddress The start address will be placed here.
+ * @param pLength The length in words will be placed here.
+ * @return TRUE if the partition is valid, else FALSE.
+ */
+bool_t PromHardware_PartitionRangeGet(Uint16 partition, Uint32* pStartAddress, Uint32* pLength)
+{
+	PartitionParameters_t TempParameters;
+
+	if (SetupPartitionParameters(partition, &TempParameters) == FALSE)
+	{
+		return FALSE;
+	}
+
+	*pStartAddress = TempParameters.TargetStartAddress;
+	*pLength = TempParameters.PartitionLength;
+	return TRUE;
+}
+
+
 /**
  * Gets the expected-CRC value that is stored in the partition.
  * Note that the CRC of any partition can be fetched here - not just limited
@@ -463,6 +594,9 @@ bool_t PromHardware_ProgramMemoryRead(Uint8* pData, Uint32 LengthInBytes, Uint32
 	bool_t bDataReadAllowed = FALSE;
 	new_address = Address;
 
+	// Make sure the last block downloaded is in the flash before reading it back.
+	(void)PromHardware_PendingProgramComplete();
+
 	if (mPartitionParameters.PartitionNumber != UNDEFINED_PARTITION)
 	{
 		// If partition is valid under the current configuration then read from it,
@@ -542,6 +676,8 @@ const PartitionParameters_t* PromHardware_PartitionParameterPointerGet_TDD(void)
 /**
  * Erase the sectors specified in the given array.
  * Any error will be in mParitionParameters.FlashStatus.FlashStatusCode (zero if OK).
+ * Any verified image descriptor for the partition is retired first, so that
+ * it can't be trusted once the image starts to change.
  *
  * @param 	partition	Partition number to erase.
  * @retval	bool_t		TRUE if erased OK, FALSE if some error.
@@ -552,7 +688,8 @@ static bool_t erasePartition(Uint16 partition)
 	bool_t  				bErasedOK = FALSE;
 	PartitionParameters_t	TempParameters;
 
-	if (SetupPartitionParameters(partition, &TempParameters) == TRUE)
+	if ( (SetupPartitionParameters(partition, &TempParameters) == TRUE)
+			&& (ImageVerify_DescriptorRetire(partition) == TRUE) )
 	{
 #ifndef	DEBUG_FLASH_ERASE_NOT_REQUIRED
         bErasedOK = ToolSpecificProgramming_SafeFlashErase(TempParameters.SectorMask, &mPartitionParameters.FlashStatus);
@@ -645,3 +782,62 @@ static bool_t SetupPartitionParameters(Uint16 PartitionNumber, PartitionParamete
 
 	return bPartitionIsOK;
 }
+
+
+/**
+ * Copies program data into the temporary buffer - see PromHardware_ProgramMemoryStage().
+ *
+ * @param pData					Array of data to write to the ROM
+ * @param LengthInBytes 		The length of the data array, in bytes.
+ * @param StartAddressInFlash	The start address of the flash into which the data will be written.
+ * @param BufferOffset			Offset into the buffer (in words) for an incremental write.
+ * @retval bool_t				TRUE if the data was staged, else FALSE.
+ */
+static bool_t StageIntoBuffer(Uint8* pData, Uint32 LengthInBytes, Uint32 StartAddressInFlash,
+                              Uint32 BufferOffset)
+{
+	Uint32 			BufferAddress;
+	Uint32 			wordLen = LengthInBytes >> 1; //divide by 2
+	Uint16 			workingData;
+	Uint32 			i = 0; //counter
+	bool_t 			bRomCanBeWritten = FALSE;
+
+	if (CheckForValidPartitionAndSetupParameters() == TRUE)
+	{
+		if ( (StartAddressInFlash >= mPartitionParameters.TargetStartAddress) && ( (StartAddressInFlash+wordLen) < mPartitionParameters.TargetEndAddress) )
+		{
+			// Generate address in buffer to copy data into - if an incremental flash write,
+			// it is likely that this buffer is quite small so the caller decides where in
+			// the buffer the data goes, otherwise the buffer is large enough to hold an
+			// entire image so setup the address to be offset by the correct amount.
+			if (mbAllowIncrementalFlashWrite == TRUE)
+			{
+				BufferAddress = BUFFER_BASE_ADDRESS + BufferOffset;
+			}
+			else
+			{
+			    BufferAddress = BUFFER_BASE_ADDRESS + (StartAddressInFlash - mPartitionParameters.TargetStartAddress);
+			}
+
+			// Check to make sure new data can fit into the buffer.
+			if ( (BufferAddress + wordLen) <= ( (Uint32)BUFFER_BASE_ADDRESS + (Uint32)BUFFER_LENGTH) )
+			{
+				bRomCanBeWritten = TRUE;
+			}
+		}
+	}
+
+	if (bRomCanBeWritten == TRUE)
+	{
+		// Reformat incoming data and write them into RAM buffer.
+		// We suppress the Lint warning for 'BufferAddress may not have been initialised'
+        // - there is no path through the code where we can get here without it being set.
+		for(i = 0; i < wordLen; i++)
+		{
+			workingData = utils_toUint16(&pData[i*2], DOWNLOAD_ENDIANESS);
+			genericIO_16bitWrite( (BufferAddress + i), workingData);		//lint !e644
+		}
+	}
+
+	return bRomCanBeWritten;
+}
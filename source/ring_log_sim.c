@@ -0,0 +1,448 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        ring_log_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side check of a partition used as a ring log.
+ * @details
+ * Shrinks one partition of the simulated flash (flash_sim.c) down to a few
+ * blocks, makes it a ring log, and writes records into it (through the batch
+ * write, with some idle time between records) until they have gone round the
+ * partition several times.  The simulated time of each write is measured, as
+ * this includes any wait for the erase-ahead of the next unit.
+ *
+ * Once the writes are done the recording system is started again, as after a
+ * power cycle, and must find the same head, page sequence and page counts
+ * from the flash.  The records are then read back, as a read request would:
+ *
+ *  - Forwards instance 0 must be the oldest record still in the ring log,
+ *    which mustn't be the first one written.
+ *  - Backwards instance 0 must be the last record written, and going back
+ *    must stop at the oldest record.
+ *  - Every read_stride'th record is read both ways, and checked.
+ *
+ * The ring log must not have a record index (it would lose data from under
+ * it), and no page may have been programmed without being erased first.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs and resets the
+ * simulated devices and initialises the recording system, so the serial flash
+ * and SPI must have been set up (M95_DeviceSizeInitialise(), SPI_Open())
+ * before it is run, and the millisecond timer must run from
+ * flash_sim_time_ns_get().  The partition settings are put back at the end,
+ * but the partition addresses aren't worked out again until the recording
+ * system is next initialised.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rspartition.h"
+#include "rspartition_prv.h"
+#include "rspages.h"
+#include "rssearch.h"
+#include "rsindex.h"
+#include "flash_sim.h"
+#include "ring_log_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define DEFAULT_CONFIG      { 5u, 64u, 1000u, 5u, 2000u, 37u }
+
+#define FIRST_RECORD_ID     0x0100u     ///< Record ID of the first record.
+#define LAST_RECORD_ID      0xFFF0u     ///< Record IDs stop here, whatever the number of wraps.
+#define ERASE_POLL_NS       1000000u    ///< Idle time between polls of the last erase.
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   record_write(const ring_log_sim_config_t * const p_config,
+                             const uint16_t record_id);
+
+static bool_t   record_read(const ring_log_sim_config_t * const p_config,
+                            const rs_search_direction_t direction,
+                            const uint32_t instance,
+                            uint16_t * const p_record_id);
+
+static void     tdr_fill(uint8_t * const p_tdr,
+                         const uint16_t tdr_bytes,
+                         const uint16_t record_id);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t  m_write_buffer[RING_LOG_SIM_MAX_TDR_BYTES + RSAPI_BYTES_BEFORE_TDR
+                                    + RSAPI_BYTES_AFTER_TDR];
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t  m_expected_tdr[RING_LOG_SIM_MAX_TDR_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * ring_log_sim_config_default fills in the configuration to make the burst
+ * data partition (index 5) a 64 page ring log, and go round it five times
+ * with 1000 byte records, 2ms apart.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void ring_log_sim_config_default(ring_log_sim_config_t * const p_config)
+{
+    const ring_log_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ring_log_sim_run writes the records round the ring log, restarts the
+ * recording system and reads the records back.
+ *
+ * @param   p_config    Pointer to the ring log and records to use.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid or the recording
+ *                      system can't be set up, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ring_log_sim_run(const ring_log_sim_config_t * const p_config,
+                        ring_log_sim_result_t * const p_result)
+{
+    rspartition_unit_test_ptrs_t*   p_test_ptrs;
+    rs_partition_info_t*            p_settings = NULL;
+    const rs_partition_info_t*      p_partition;
+    const rspartition_ring_t*       p_ring;
+    rs_partition_info_t             before_restart;
+    flash_sim_stats_t               stats;
+    uint64_t    bytes_to_write = 0u;
+    uint64_t    bytes_written = 0u;
+    uint64_t    write_start_ns;
+    uint64_t    write_us;
+    uint32_t    saved_pages = 0u;
+    uint32_t    instance;
+    uint16_t    record_id = FIRST_RECORD_ID;
+    uint16_t    oldest_id = 0u;
+    uint16_t    newest_id = 0u;
+    uint16_t    read_id = 0u;
+    uint8_t     dummy_progress;
+    bool_t      b_saved_circular = FALSE;
+    bool_t      b_valid = FALSE;
+
+    if ( (p_config->partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+            && (p_config->ring_pages != 0u)
+            && (p_config->tdr_bytes != 0u)
+            && (p_config->tdr_bytes <= RING_LOG_SIM_MAX_TDR_BYTES)
+            && ((p_config->tdr_bytes & 0x0001u) == 0u)
+            && (p_config->wraps != 0u)
+            && (p_config->read_stride != 0u) )
+    {
+        p_test_ptrs = rspartition_unit_test_ptrs_get();
+        p_settings  = &p_test_ptrs->p_partitions[p_config->partition_index];
+
+        saved_pages      = p_settings->number_of_pages;
+        b_saved_circular = p_settings->b_circular;
+
+        p_settings->number_of_pages = p_config->ring_pages;
+        p_settings->b_circular      = TRUE;
+
+        flash_sim_install();
+        flash_sim_reset();
+
+        if (rsapi_recording_system_init())
+        {
+            b_valid = ( (rspartition_format_partition(p_config->partition_index,
+                                                      &dummy_progress) == RS_ERR_NO_ERROR)
+                        && (p_settings->ring_unit_pages != 0u) );
+        }
+    }
+
+    if (b_valid)
+    {
+        p_partition = rspartition_partition_ptr_get(p_config->partition_index);
+        p_ring      = &rspartition_unit_test_ptrs_get()->p_ring[p_config->partition_index];
+
+        p_result->records_written  = 0u;
+        p_result->write_failures   = 0u;
+        p_result->total_write_us   = 0u;
+        p_result->longest_write_us = 0u;
+        p_result->reads            = 0u;
+        p_result->read_mismatches  = 0u;
+
+        flash_sim_stats_clear();
+
+        bytes_to_write = (uint64_t)p_config->wraps
+                            * ((uint64_t)p_partition->end_address - p_partition->start_address + 1u);
+
+        /* Go round the ring log, with some idle time between the records. */
+        while ( (bytes_written < bytes_to_write) && (record_id <= LAST_RECORD_ID) )
+        {
+            write_start_ns = flash_sim_time_ns_get();
+
+            if (record_write(p_config, record_id))
+            {
+                newest_id = record_id;
+            }
+            else
+            {
+                p_result->write_failures++;
+            }
+
+            write_us = (flash_sim_time_ns_get() - write_start_ns) / 1000u;
+
+            p_result->records_written++;
+            p_result->total_write_us += write_us;
+
+            if (write_us > p_result->longest_write_us)
+            {
+                p_result->longest_write_us = write_us;
+            }
+
+            bytes_written += (uint64_t)p_config->tdr_bytes
+                                + RSAPI_BYTES_BEFORE_TDR + RSAPI_BYTES_AFTER_TDR;
+            record_id++;
+
+            flash_sim_time_advance(p_config->write_interval_us * 1000u);
+        }
+
+        /* Let the erase-ahead finish before the restart. */
+        while ( (p_ring->b_erase_running) || (p_ring->b_erase_due) )
+        {
+            rspartition_ring_erase_step();
+            flash_sim_time_advance(ERASE_POLL_NS);
+        }
+
+        p_result->b_no_index = ( (p_partition->index_start_address == 0u)
+                                    && (!rsindex_query_if_valid(p_config->partition_index)) );
+
+        /* Start again, as after a power cycle, and check the same state is found. */
+        before_restart = *p_partition;
+
+        p_result->b_mount_matches
+            = ( rsapi_recording_system_init()
+                && (p_partition->next_available_address == before_restart.next_available_address)
+                && (p_partition->page_sequence == before_restart.page_sequence)
+                && (p_partition->full_pages == before_restart.full_pages)
+                && (p_partition->free_pages == before_restart.free_pages)
+                && (p_partition->partition_error_status == RS_ERR_NO_ERROR) );
+
+        /* Both ends of the ring log. */
+        p_result->b_ends_ok = record_read(p_config, RSSEARCH_FORWARDS, 0u, &oldest_id)
+                                && (oldest_id > FIRST_RECORD_ID)
+                                && (oldest_id <= newest_id)
+                                && record_read(p_config, RSSEARCH_BACKWARDS, 0u, &read_id)
+                                && (read_id == newest_id);
+
+        p_result->records_kept = 0u;
+
+        if (p_result->b_ends_ok)
+        {
+            p_result->records_kept = ((uint32_t)newest_id - oldest_id) + 1u;
+
+            p_result->b_ends_ok
+                = record_read(p_config, RSSEARCH_BACKWARDS, p_result->records_kept - 1u, &read_id)
+                    && (read_id == oldest_id)
+                    && (!record_read(p_config, RSSEARCH_BACKWARDS, p_result->records_kept, &read_id));
+        }
+
+        /* And a sample of the records in between, both ways. */
+        for (instance = 0u; instance < p_result->records_kept; instance += p_config->read_stride)
+        {
+            p_result->reads++;
+
+            if ( (!record_read(p_config, RSSEARCH_FORWARDS, instance, &read_id))
+                    || (read_id != (oldest_id + instance)) )
+            {
+                p_result->read_mismatches++;
+            }
+            else if ( (!record_read(p_config, RSSEARCH_BACKWARDS, instance, &read_id))
+                        || (read_id != (newest_id - instance)) )
+            {
+                p_result->read_mismatches++;
+            }
+            else
+            {
+                // Read back OK both ways.
+            }
+        }
+
+        flash_sim_stats_get(&stats);
+        p_result->bit_raise_attempts = stats.main_flash_bit_raise_attempts;
+        p_result->sector_erases      = stats.main_flash_sector_erases;
+        p_result->erase_suspends     = stats.main_flash_erase_suspends;
+        p_result->suspended_programs = stats.main_flash_suspended_programs;
+    }
+
+    if (p_settings != NULL)
+    {
+        p_settings->number_of_pages = saved_pages;
+        p_settings->b_circular      = b_saved_circular;
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * record_write writes one record into the ring log, through the batch write
+ * (which writes straight away, rather than queueing).
+ *
+ * @param   p_config    Pointer to the configuration.
+ * @param   record_id   Record ID to write, the TDR is made from this.
+ * @retval  bool_t      TRUE if the record was written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_write(const ring_log_sim_config_t * const p_config,
+                           const uint16_t record_id)
+{
+    const rs_partition_info_t*  p_partition;
+    rs_queue_status_t           write_status = RS_QUEUE_COULD_NOT_ADD_TO_QUEUE;
+    rs_write_request_t          write_request;
+    rs_write_batch_request_t    batch_request;
+    rs_error_t                  request_status;
+
+    p_partition = rspartition_partition_ptr_get(p_config->partition_index);
+
+    tdr_fill(&m_write_buffer[RSAPI_BYTES_BEFORE_TDR], p_config->tdr_bytes, record_id);
+
+    write_request.partition_id         = p_partition->id;
+    write_request.record_id            = record_id;
+    write_request.p_write_buffer       = &m_write_buffer[0];
+    write_request.tdr_bytes_to_write   = p_config->tdr_bytes;
+    write_request.b_read_back_required = TRUE;
+    write_request.p_write_status       = &write_status;
+    write_request.p_write_semaphore    = NULL;
+
+    batch_request.partition_id       = p_partition->id;
+    batch_request.p_write_requests   = &write_request;
+    batch_request.number_of_requests = 1u;
+
+    request_status = rsapi_write_batch_request(&batch_request);
+
+    return ( (request_status == RS_ERR_NO_ERROR)
+                && (write_status == RS_QUEUE_REQUEST_COMPLETE) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * record_read searches for a record in the ring log, setting up the search
+ * as a read request would, and checks the TDR against its record ID.
+ *
+ * @param   p_config        Pointer to the configuration.
+ * @param   direction       Direction to search in.
+ * @param   instance        Instance to find, counting from the oldest record
+ *                          (forwards) or the newest (backwards).
+ * @param   p_record_id     Pointer to return the record ID found.
+ * @retval  bool_t          TRUE if the record was found and its TDR matches.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_read(const ring_log_sim_config_t * const p_config,
+                          const rs_search_direction_t direction,
+                          const uint32_t instance,
+                          uint16_t * const p_record_id)
+{
+    const rs_partition_info_t*  p_partition;
+    const rssearch_rsr_info_t*  p_rsr_info;
+    rssearch_search_data_t      search_data;
+    uint16_t                    i;
+    bool_t                      b_matches = FALSE;
+
+    p_partition = rspartition_partition_ptr_get(p_config->partition_index);
+
+    search_data.search_direction                = direction;
+    search_data.partition_logical_start_address = p_partition->start_address;
+    search_data.partition_logical_end_address   = p_partition->end_address;
+    search_data.required_record_instance        = instance;
+    search_data.b_match_record_id               = FALSE;
+    search_data.required_record_id              = 0u;
+    search_data.ring_next_free_address          = p_partition->next_available_address;
+    search_data.b_ring_wrapped
+        = rspartition_ring_oldest_address_get(p_config->partition_index,
+                                              &search_data.ring_oldest_address);
+
+    if (direction == RSSEARCH_FORWARDS)
+    {
+        search_data.search_start_address = search_data.ring_oldest_address;
+    }
+    else
+    {
+        search_data.search_start_address = p_partition->next_available_address;
+    }
+
+    if (rssearch_find_valid_RSR_start(&search_data))
+    {
+        p_rsr_info   = rssearch_valid_rsr_pointer_get();
+        *p_record_id = p_rsr_info->record_id;
+
+        tdr_fill(&m_expected_tdr[0], p_config->tdr_bytes, p_rsr_info->record_id);
+
+        b_matches = (p_rsr_info->tdr_length == p_config->tdr_bytes);
+
+        for (i = 0u; (i < p_config->tdr_bytes) && (b_matches); i++)
+        {
+            b_matches = (p_rsr_info->p_start_of_tdr[i] == m_expected_tdr[i]);
+        }
+    }
+
+    return b_matches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * tdr_fill makes the TDR for a record from its record ID, so that each record
+ * is different and can be checked when it is read back.
+ *
+ * @param   p_tdr       Pointer to where to put the TDR.
+ * @param   tdr_bytes   Number of bytes in the TDR.
+ * @param   record_id   Record ID of the record.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void tdr_fill(uint8_t * const p_tdr,
+                     const uint16_t tdr_bytes,
+                     const uint16_t record_id)
+{
+    uint16_t    i;
+
+    for (i = 0u; i < tdr_bytes; i++)
+    {
+        //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+        p_tdr[i] = (uint8_t)((record_id + (i * 7u)) & 0xFFu);
+    }
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
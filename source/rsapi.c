@@ -39,6 +39,8 @@
 #include "rssearch.h"
 #include "rspartition.h"
 #include "rspages.h"
+#include "rsindex.h"
+#include "rsmount.h"
 #include "flash_hal.h"
 #include "rsapi_prv.h"
 
@@ -121,10 +123,6 @@ static bool_t               m_b_rw_task_enabled = FALSE;
 //lint -e{956}
 static bool_t               m_b_rw_task_disable_request = FALSE;
 
-/// Partition format progress counter, 0 to 100%.
-//lint -e{956}
-static uint8_t              m_partition_format_progress = 0u;
-
 #ifdef UNIT_TEST_BUILD
 /**
  * Structure to hold variables which we use for testing the read \ write task.
@@ -160,6 +158,8 @@ bool_t rsapi_recording_system_init(void)
     uint8_t                     partition_counter;
     const rs_partition_info_t * p_partition;
     bool_t                      b_flash_hal_initialised_ok;
+    uint32_t                    mount_area_start_address;
+    uint32_t                    mount_area_end_address;
 
     m_rs_config.spec_level              = SPEC_LEVEL;
     m_rs_config.code_version            = CODE_VERSION;
@@ -193,8 +193,25 @@ bool_t rsapi_recording_system_init(void)
         m_logical_address_map[partition_counter].start_address
             = p_partition->start_address;
 
-        m_logical_address_map[partition_counter].end_address
-            = p_partition->end_address;
+        /* The record index area (if any) belongs to the partition too. */
+        if (p_partition->index_pages != 0u)
+        {
+            m_logical_address_map[partition_counter].end_address
+                = p_partition->index_end_address;
+        }
+        else
+        {
+            m_logical_address_map[partition_counter].end_address
+                = p_partition->end_address;
+        }
+    }
+
+    /* The mount record area (if any) is mapped along with the last partition. */
+    if (rspartition_mount_area_get(&mount_area_start_address,
+                                   &mount_area_end_address))
+    {
+        m_logical_address_map[RS_CFG_MAX_NUMBER_OF_PARTITIONS - 1u].end_address
+            = mount_area_end_address;
     }
 
     /* Initialise the flash HAL before we need to use it. */
@@ -206,6 +223,9 @@ bool_t rsapi_recording_system_init(void)
      */
     if (b_flash_hal_initialised_ok)
     {
+        /* Find the latest mount record, so partitions can skip the search. */
+        rsmount_load();
+
         /* Check each partition to make sure it's in good order. */
         for (partition_counter = 0u;
                 partition_counter < RS_CFG_MAX_NUMBER_OF_PARTITIONS;
@@ -214,6 +234,7 @@ bool_t rsapi_recording_system_init(void)
             check_partition_before_use(partition_counter);
         }
 
+        rsmount_partitions_mounted();
     }
     m_b_recording_system_has_been_initialised = TRUE;
     return m_b_recording_system_has_been_initialised;
@@ -287,7 +308,8 @@ rs_error_t rsapi_partition_format_request
 // ----------------------------------------------------------------------------
 /**
  * rsapi_partition_format_prog_get return the progress of the partition
- * format function, which should be between 0 and 100%.
+ * format function, which should be between 0 and 100%.  This is updated
+ * after every step of the format, so it can be polled while one is running.
  *
  * @retval  uint8_t     Partition format progress, between 0 and 100%.
  *
@@ -295,7 +317,7 @@ rs_error_t rsapi_partition_format_request
 // ----------------------------------------------------------------------------
 uint8_t rsapi_partition_format_prog_get(void)
 {
-    return m_partition_format_progress;
+    return rspartition_format_progress_get();
 }
 
 
@@ -400,6 +422,190 @@ rs_error_t rsapi_read_request(const rs_read_request_t * const p_read_request)
 // ----------------------------------------------------------------------------
 
 
+// ----------------------------------------------------------------------------
+/**
+ * rsapi_write_batch_request writes a batch of records into a partition.
+ *
+ * The records are written back to back, with the RSRs assembled in RAM and
+ * programmed into the flash with one write per run of records within a page
+ * (see rspages_page_data_write_batch()), rather than one write per record.
+ * This makes a big difference to the main flash, where each write has a
+ * fixed overhead regardless of how many bytes it programs.
+ *
+ * @note
+ * Unlike rsapi_write_request() the batch is written straight away, so
+ * this must only be called from the task which owns the recording memory.
+ * The status (and semaphore) for each write request is updated as it would
+ * be for a queued write.
+ *
+ * @note
+ * The batch is rejected as a whole (and nothing is written) if any request
+ * is for a different partition, has a TDR which is too big, or won't align
+ * with the memory device.  Requests which have been checked are marked as
+ * RS_QUEUE_COULD_NOT_ADD_TO_QUEUE, and the offending request with the
+ * reason.
+ *
+ * @param   p_batch_request     Pointer to the batch write request structure.
+ * @retval  rs_error_t          Enumerated value for error code.
+ *
+ */
+// ----------------------------------------------------------------------------
+rs_error_t rsapi_write_batch_request
+                        (const rs_write_batch_request_t * const p_batch_request)
+{
+    rs_error_t                  write_request_status = RS_ERR_BAD_WRITE_QUEUE;
+    uint16_t                    partition_index;
+    uint16_t                    request_index;
+    uint16_t                    number_checked = 0u;
+    const rs_partition_info_t*  p_partition_info;
+    const rs_write_request_t*   p_request;
+    rs_queue_status_t           reject_status = RS_QUEUE_COULD_NOT_ADD_TO_QUEUE;
+    bool_t                      b_batch_ok = TRUE;
+    rs_page_write_t             page_writes[RS_CFG_BATCH_MAX_RECORDS];
+    rs_page_write_status_t      page_write_status[RS_CFG_BATCH_MAX_RECORDS];
+
+    if (!m_b_recording_system_has_been_initialised)
+    {
+        write_request_status = RS_ERR_NOT_INITIALISED_YET;
+    }
+    else if ( (p_batch_request != NULL)
+                && (p_batch_request->p_write_requests != NULL)
+                && (p_batch_request->number_of_requests != 0u)
+                && (p_batch_request->number_of_requests <= RS_CFG_BATCH_MAX_RECORDS) )
+    {
+        partition_index
+            = rspartition_check_partition_id(p_batch_request->partition_id);
+
+        if (partition_index == RSPARTITION_INDEX_BAD_ID_VALUE)
+        {
+            write_request_status = RS_ERR_BAD_PARTITION_ID;
+        }
+        else
+        {
+            //lint -e{921} Cast from uint16_t to uint8_t
+            p_partition_info = rspartition_partition_ptr_get((uint8_t)partition_index);
+
+            if (p_partition_info->partition_error_status == RS_ERR_PARTITION_NEEDS_FORMAT)
+            {
+                write_request_status = RS_ERR_PARTITION_NEEDS_FORMAT;
+            }
+            else if (p_partition_info->partition_error_status == RS_ERR_PARTITION_IS_FULL)
+            {
+                write_request_status = RS_ERR_PARTITION_IS_FULL;
+            }
+            else
+            {
+                /* Check every request before anything is written. */
+                p_request = p_batch_request->p_write_requests;
+
+                while ( (number_checked < p_batch_request->number_of_requests)
+                            && (b_batch_ok) )
+                {
+                    p_request = &p_batch_request->p_write_requests[number_checked];
+
+                    if ( (p_request->partition_id != p_batch_request->partition_id)
+                        || (p_request->p_write_buffer == NULL)
+                        || (p_request->tdr_bytes_to_write > RS_CFG_MAX_TDR_SIZE_BYTES) )
+                    {
+                        b_batch_ok = FALSE;
+                    }
+                    /* The main flash can only be written in whole 16 bit words. */
+                    else if ( (p_partition_info->device_to_use == STORAGE_DEVICE_MAIN_FLASH)
+                                && ((p_request->tdr_bytes_to_write & 0x0001u) != 0u) )
+                    {
+                        reject_status = RS_QUEUE_INCOMPATIBLE_ALIGNMENT;
+                        b_batch_ok = FALSE;
+                    }
+                    else
+                    {
+                        number_checked++;
+                    }
+                }
+
+                if (!b_batch_ok)
+                {
+                    queue_status_update(p_request->p_write_status, reject_status, NULL);
+
+                    for (request_index = 0u; request_index < number_checked; request_index++)
+                    {
+                        p_request = &p_batch_request->p_write_requests[request_index];
+
+                        queue_status_update(p_request->p_write_status,
+                                            RS_QUEUE_COULD_NOT_ADD_TO_QUEUE,
+                                            NULL);
+                    }
+                }
+                else
+                {
+                    for (request_index = 0u;
+                         request_index < p_batch_request->number_of_requests;
+                         request_index++)
+                    {
+                        p_request = &p_batch_request->p_write_requests[request_index];
+
+                        //lint -e{921} Cast from uint16_t to uint8_t
+                        page_writes[request_index].partition_index = (uint8_t)partition_index;
+                        page_writes[request_index].partition_id
+                                                    = p_batch_request->partition_id;
+                        page_writes[request_index].partition_logical_start_addr
+                                                    = p_partition_info->start_address;
+                        page_writes[request_index].partition_logical_end_addr
+                                                    = p_partition_info->end_address;
+                        page_writes[request_index].next_free_addr
+                                                    = p_partition_info->next_available_address;
+                        page_writes[request_index].record_id = p_request->record_id;
+                        page_writes[request_index].p_write_buffer
+                                                    = p_request->p_write_buffer;
+                        page_writes[request_index].bytes_to_write
+                            = (p_request->tdr_bytes_to_write + RSAPI_BYTES_BEFORE_TDR)
+                                + RSAPI_BYTES_AFTER_TDR;
+                        page_writes[request_index].b_read_back_write_command
+                                                    = p_request->b_read_back_required;
+
+                        queue_status_update(p_request->p_write_status,
+                                            RS_QUEUE_REQUEST_IN_PROGRESS,
+                                            p_request->p_write_semaphore);
+                    }
+
+                    //lint -e{920} Ignore return value, each status is checked below.
+                    (void)rspages_page_data_write_batch(page_writes,
+                                                        p_batch_request->number_of_requests,
+                                                        page_write_status);
+
+                    for (request_index = 0u;
+                         request_index < p_batch_request->number_of_requests;
+                         request_index++)
+                    {
+                        p_request = &p_batch_request->p_write_requests[request_index];
+
+                        if ( (page_write_status[request_index] == RS_PG_WRITE_OK)
+                            || (page_write_status[request_index] == RS_PG_WRITE_OK_PAGE_FULL) )
+                        {
+                            queue_status_update(p_request->p_write_status,
+                                                RS_QUEUE_REQUEST_COMPLETE,
+                                                p_request->p_write_semaphore);
+                        }
+                        else
+                        {
+                            queue_status_update(p_request->p_write_status,
+                                                RS_QUEUE_REQUEST_FAILED,
+                                                p_request->p_write_semaphore);
+                        }
+                    }
+
+                    write_request_status = RS_ERR_NO_ERROR;
+                }
+            }
+        }
+    }
+    else
+    {
+        ;   // Extra else for MISRA compliance - just return bad write queue.
+    }
+
+    return write_request_status;
+}
+
 
 // ----------------------------------------------------------------------------
 /**
@@ -473,6 +679,34 @@ void rsapi_task_enable(void)
 // ----------------------------------------------------------------------------
 
 
+// ----------------------------------------------------------------------------
+/**
+ * rsapi_mount_record_write writes a mount record holding the current state
+ * of every partition, so that the partitions can be mounted without being
+ * searched at the next startup.  This should be called before a clean
+ * shutdown (and can be called periodically).
+ *
+ * @note
+ * This writes into the recording memory, so must only be called from the
+ * task which owns the recording memory, when no other access is in progress.
+ *
+ * @retval  bool_t      TRUE if mount record written OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rsapi_mount_record_write(void)
+{
+    bool_t  b_write_ok = FALSE;
+
+    if (m_b_recording_system_has_been_initialised)
+    {
+        b_write_ok = rsmount_record_write();
+    }
+
+    return b_write_ok;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * rsapi_configuration_pointer_get returns a const pointer to the configuration
@@ -515,7 +749,9 @@ uint16_t rsapi_queue_items_waiting_get(const rs_queue_identifiers_t identifier)
 /**
  * check_partition_before_use makes sure that a partition is fit for use.
  *
- * This uses a bisection search to find the next page which can be written to.
+ * This restores the partition from the mount record if possible, otherwise
+ * uses a bisection search to find the next page which can be written to,
+ * and then loads the record index for the partition (if it has one).
  *
  * @note
  * This function needs various members of m_rs_partition_info to have been
@@ -532,8 +768,13 @@ static void check_partition_before_use(const uint8_t partition_index)
     /* Only check partition if index is valid. */
     if (partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
     {
-        //lint -e{920} Ignoring return value as the only failure is unformatted.
-        (void)rspartition_bisection_search_do(partition_index);
+        if (!rsmount_partition_restore(partition_index))
+        {
+            //lint -e{920} Ignoring return value as the only failure is unformatted.
+            (void)rspartition_bisection_search_do(partition_index);
+        }
+
+        rsindex_partition_load(partition_index);
 
         /* Index is valid so fetch pointer to partition information. */
         p_partition = rspartition_partition_ptr_get(partition_index);
@@ -598,7 +839,9 @@ static void queue_status_update(rs_queue_status_t * const p_status,
  * is called when a read is required.
  *
  * This function sets up the search data structure (via the p_search_data
- * pointer) if the partition is valid.
+ * pointer) if the partition is valid.  If the partition has a valid record
+ * index, the search is then converted into one which starts at the required
+ * record, so the partition doesn't need to be scanned.
  *
  * @note
  * This function uses the p_search_data pointer to setup the structure
@@ -624,19 +867,46 @@ static rsapi_read_write_task_state_t read_required_state_do
         p_search_data->search_direction                = p_read_request->search_direction;
         p_search_data->partition_logical_start_address = p_partition->start_address;
         p_search_data->partition_logical_end_address   = p_partition->end_address;
+        p_search_data->ring_next_free_address          = p_partition->next_available_address;
+
+        /* A ring log which has gone round starts with the oldest data. */
+        p_search_data->b_ring_wrapped
+            = rspartition_ring_oldest_address_get(p_read_request->partition_index,
+                                                  &p_search_data->ring_oldest_address);
 
         if (p_search_data->search_direction == RSSEARCH_FORWARDS)
         {
             p_search_data->search_start_address = p_partition->start_address;
+
+            if (p_search_data->b_ring_wrapped)
+            {
+                p_search_data->search_start_address = p_search_data->ring_oldest_address;
+            }
         }
         else
         {
             p_search_data->search_start_address = p_partition->next_available_address;
         }
+
+        p_search_data->required_record_instance = p_read_request->record_instance;
+        p_search_data->b_match_record_id        = p_read_request->b_match_record_id;
+        p_search_data->required_record_id       = p_read_request->record_id;
+
+        //lint -e{920} Ignoring return value, the search is left alone if no index.
+        (void)rsindex_search_seek(p_read_request->partition_index, p_search_data);
+
+        new_state = RSAPI_STATE_READ_IN_PROGRESS;
     }
+    else
+    {
+        queue_status_update(p_read_request->p_read_status,
+                            RS_QUEUE_REQUEST_FAILED,
+                            p_read_request->p_read_semaphore);
 
+        new_state = RSAPI_STATE_IDLE_READ_CHECK;
+    }
 
-    return RSAPI_STATE_WRITE_IN_PROGRESS;
+    return new_state;
 }
 
 
@@ -645,9 +915,14 @@ static rsapi_read_write_task_state_t read_required_state_do
  * read_in_progress_state_do is part of the read \ write task state engine, and
  * is called when a read is in progress.
  *
- * This function sets up the timeout timer and then searches for the appropriate
- * record using the search data structure.
+ * This function searches for the appropriate record using the search data
+ * structure, and if it is found copies the TDR into the read buffer and sets
+ * the read length.  The search itself is abandoned if the search timeout
+ * expires (see rssearch_timeout_callback()).
  *
+ * @note
+ * A NULL read buffer or read length pointer is ignored, as allowed by
+ * rsapi_read_request(), but the read status is still updated.
  *
  * @param   p_read_request      Pointer to read request data structure.
  * @param   p_search_data       Pointer to search data structure.
@@ -659,13 +934,47 @@ static rsapi_read_write_task_state_t read_in_progress_state_do
                             (const rs_read_request_t * const p_read_request,
                              const rssearch_search_data_t * const p_search_data)
 {
-    rs_queue_status_t           queue_status_to_update;
+    rs_queue_status_t           queue_status_to_update = RS_QUEUE_REQUEST_FAILED;
     bool_t                      b_read_ok;
     const rssearch_rsr_info_t*  p_valid_rsr;
     uint16_t                    copy_counter;
 
+    b_read_ok = rssearch_find_valid_RSR_start(p_search_data);
+
+    if (b_read_ok)
+    {
+        p_valid_rsr = rssearch_valid_rsr_pointer_get();
+
+        if (p_valid_rsr != NULL)
+        {
+            if (p_read_request->p_read_buffer != NULL)
+            {
+                for (copy_counter = 0u;
+                     copy_counter < p_valid_rsr->tdr_length;
+                     copy_counter++)
+                {
+                    p_read_request->p_read_buffer[copy_counter]
+                        = p_valid_rsr->p_start_of_tdr[copy_counter];
+                }
+            }
+
+            if (p_read_request->p_read_length != NULL)
+            {
+                *p_read_request->p_read_length = p_valid_rsr->tdr_length;
+            }
+
+            queue_status_to_update = RS_QUEUE_REQUEST_COMPLETE;
+        }
+    }
 
+    queue_status_update(p_read_request->p_read_status,
+                        queue_status_to_update,
+                        p_read_request->p_read_semaphore);
 
+    /*
+     * Always go back to the idle read state when a read has finished.
+     * It doesn't matter whether the read was successful or not.
+     */
     return RSAPI_STATE_IDLE_READ_CHECK;
 }
 
@@ -0,0 +1,1140 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        rsindex.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Support functions for the recording system record index.
+ * @details
+ * Support functions for the recording system, anything related to the
+ * persistent record index.
+ *
+ * Each partition may have an index area reserved after its data pages (see
+ * RS_CFG_PARTITION_SETTINGS).  Whenever a record is written into such a
+ * partition, the record number is incremented and, for the first record and
+ * every RS_CFG_INDEX_RECORD_INTERVAL records after that, a checkpoint is
+ * appended to the index area.  A checkpoint holds the record number, the
+ * logical address of the start of the RSR and a table of how many instances
+ * of each record ID were written before it, protected by a CRC.  The index
+ * area is append-only, so it only ever gets erased when the partition is
+ * formatted.
+ *
+ * Because the checkpoints are taken at a fixed interval, the checkpoint for
+ * any record number can be located directly, and at most
+ * RS_CFG_INDEX_RECORD_INTERVAL - 1 RSR headers need to be stepped over to
+ * get from the checkpoint to the record itself.
+ *
+ * The instances of each record ID only ever go up from one checkpoint to the
+ * next, so the checkpoint before any instance of a record ID is found with a
+ * bisection search on the index area.  The instance is then within the next
+ * RS_CFG_INDEX_RECORD_INTERVAL records.  Only the first
+ * RS_CFG_INDEX_RECORD_IDS record IDs written into the partition are counted,
+ * and searches for any other record ID use the normal search.
+ *
+ * Either way this replaces the backwards scan through the partition which
+ * rssearch_find_valid_RSR_start() would otherwise have to do.
+ *
+ * At startup the number of checkpoints is found using a bisection search on
+ * the index area, and the records written after the last checkpoint are
+ * counted by stepping through the RSR headers up to the next free address.
+ * If anything does not tie up (missing checkpoints, a corrupted checkpoint,
+ * a failed write, a full index area etc.) then the index is flagged as
+ * invalid for that partition and reads fall back to the normal search until
+ * the partition is formatted again.
+ *
+ * @note
+ * Ring log partitions never have an index area (see rspartition.c), as the
+ * oldest records are erased from under it.
+ *
+ * @note
+ * These functions should only be called from other recording system functions,
+ * not directly as if they were part of the API.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rssearch.h"
+#include "rspages.h"
+#include "rspartition.h"
+#include "rsindex.h"
+#include "rsindex_prv.h"
+#include "flash_hal.h"
+#include "buffer_utils.h"
+#include "crc.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+/// Number, address, IDs tracked, then an ID and instances for each slot, then CRC.
+#define INDEX_ENTRY_SIZE_BYTES      (12u + (6u * RS_CFG_INDEX_RECORD_IDS))
+#define INDEX_ENTRY_CRC_LENGTH      (INDEX_ENTRY_SIZE_BYTES - 2u)   ///< CRC covers everything before it.
+#define INDEX_ENTRY_NUMBER_OFFSET   0u      ///< Offset of record number (LSB first).
+#define INDEX_ENTRY_ADDRESS_OFFSET  4u      ///< Offset of RSR address (LSB first).
+#define INDEX_ENTRY_TRACKED_OFFSET  8u      ///< Offset of number of IDs tracked (LSB first).
+#define INDEX_ENTRY_IDS_OFFSET      10u     ///< Offset of first record ID (LSB first).
+#define INDEX_ENTRY_INSTANCES_OFFSET    (INDEX_ENTRY_IDS_OFFSET + (2u * RS_CFG_INDEX_RECORD_IDS))
+#define INDEX_ENTRY_CRC_OFFSET      INDEX_ENTRY_CRC_LENGTH          ///< Offset of CRC (MSB first).
+
+/// RSR header is SYNC, IDx2, LENx2 - read 6 bytes to keep the main flash happy.
+#define RSR_HEADER_READ_SIZE        6u
+#define RSR_ID_OFFSET               1u      ///< Offset of record ID in RSR (LSB first).
+#define RSR_LENGTH_OFFSET           3u      ///< Offset of TDR length in RSR (LSB first).
+
+/// Wrapper added around the TDR - SYNC, IDx2, LENx2, CRCx2, ENDSYNC.
+#define RSR_WRAPPER_SIZE_OVERHEAD   (RSAPI_BYTES_BEFORE_TDR + RSAPI_BYTES_AFTER_TDR)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void index_state_clear(rsindex_state_t * const p_state,
+                              const rs_partition_info_t * const p_partition);
+
+static uint32_t count_entries_used(const rs_partition_info_t * const p_partition,
+                                   const rsindex_state_t * const p_state);
+
+static bool_t entry_read(const rs_partition_info_t * const p_partition,
+                         const uint32_t entry_number,
+                         rsindex_entry_t * const p_entry);
+
+static bool_t entry_append(const rs_partition_info_t * const p_partition,
+                           rsindex_state_t * const p_state,
+                           const uint32_t rsr_start_address);
+
+static bool_t instance_entry_find(const rs_partition_info_t * const p_partition,
+                                  const rsindex_state_t * const p_state,
+                                  const uint16_t slot,
+                                  const uint16_t record_id,
+                                  const uint32_t instance,
+                                  rsindex_entry_t * const p_entry);
+
+static uint16_t id_slot_find(const rsindex_id_table_t * const p_id_table,
+                             const uint16_t record_id);
+
+static void id_instance_add(rsindex_id_table_t * const p_id_table,
+                            const uint16_t record_id);
+
+static bool_t walk_records(const rs_partition_info_t * const p_partition,
+                           const uint32_t logical_start_address,
+                           const uint32_t maximum_records,
+                           const bool_t b_match_record_id,
+                           const uint16_t record_id,
+                           rsindex_id_table_t * const p_id_table,
+                           uint32_t * const p_records_walked,
+                           uint32_t * const p_end_address);
+
+static bool_t partition_data_read(const rs_partition_info_t * const p_partition,
+                                  const uint32_t logical_address,
+                                  const uint32_t number_of_bytes,
+                                  uint8_t * const p_buffer);
+
+static uint32_t partition_address_advance
+                        (const rs_partition_info_t * const p_partition,
+                         const uint32_t logical_address,
+                         const uint32_t number_of_bytes);
+
+static uint32_t partition_data_end_get
+                        (const rs_partition_info_t * const p_partition);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// State of the record index for each partition.
+//lint -e{956} Doesn't need to be volatile, only used by the read \ write task.
+static rsindex_state_t  m_index_state[RS_CFG_MAX_NUMBER_OF_PARTITIONS];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * rsindex_partition_load loads the record index for a partition from the
+ * index area and checks that it matches the data in the partition.
+ *
+ * @note
+ * This function needs the partition next available address to have been
+ * setup by rspartition_bisection_search_do() before it is called.
+ *
+ * @param   partition_index     Partition number to load (0,1,2 etc).
+ *
+ */
+// ----------------------------------------------------------------------------
+void rsindex_partition_load(const uint8_t partition_index)
+{
+    const rs_partition_info_t*  p_partition;
+    rsindex_state_t*            p_state;
+    rsindex_entry_t             last_entry;
+    uint32_t                    walk_start_address = 0u;
+    uint32_t                    first_record_number = 1u;
+    uint32_t                    records_walked = 0u;
+    uint32_t                    walk_end_address = 0u;
+    bool_t                      b_index_ok;
+
+    p_partition = rspartition_partition_ptr_get(partition_index);
+
+    if ( (p_partition != NULL) && (p_partition->index_pages != 0u) )
+    {
+        p_state = &m_index_state[partition_index];
+
+        index_state_clear(p_state, p_partition);
+
+        /* Can't do anything with an unformatted partition. */
+        b_index_ok = (p_partition->partition_error_status
+                            != RS_ERR_PARTITION_NEEDS_FORMAT);
+
+        if (b_index_ok)
+        {
+            p_state->entries_used = count_entries_used(p_partition, p_state);
+
+            /* No checkpoints means no records, so start from the first page. */
+            if (p_state->entries_used == 0u)
+            {
+                walk_start_address = p_partition->start_address
+                                        + PAGE_HEADER_LENGTH_BYTES;
+            }
+            else
+            {
+                b_index_ok = entry_read(p_partition,
+                                        p_state->entries_used - 1u,
+                                        &last_entry);
+
+                /* Checkpoints must be exactly one interval apart. */
+                if ( (b_index_ok)
+                        && (last_entry.record_number
+                                == (((p_state->entries_used - 1u)
+                                        * RS_CFG_INDEX_RECORD_INTERVAL) + 1u)) )
+                {
+                    walk_start_address  = last_entry.rsr_start_address;
+                    first_record_number = last_entry.record_number;
+                    p_state->id_table   = last_entry.id_table;
+                }
+                else
+                {
+                    b_index_ok = FALSE;
+                }
+            }
+        }
+
+        /*
+         * Count the records after the last checkpoint, and their record IDs -
+         * there can't be more than an interval's worth, and they must take us
+         * exactly to the next free address otherwise the index doesn't match
+         * the data.
+         */
+        if (b_index_ok)
+        {
+            b_index_ok = walk_records(p_partition,
+                                      walk_start_address,
+                                      RS_CFG_INDEX_RECORD_INTERVAL + 1u,
+                                      FALSE,
+                                      0u,
+                                      &p_state->id_table,
+                                      &records_walked,
+                                      &walk_end_address);
+
+            if ( (records_walked > RS_CFG_INDEX_RECORD_INTERVAL)
+                    || ( (p_state->entries_used == 0u) && (records_walked != 0u) )
+                    || ( (p_state->entries_used != 0u) && (records_walked == 0u) ) )
+            {
+                b_index_ok = FALSE;
+            }
+
+            /* A full partition has no next free address to compare with. */
+            if ( (p_partition->partition_error_status != RS_ERR_PARTITION_IS_FULL)
+                    && (walk_end_address != p_partition->next_available_address) )
+            {
+                b_index_ok = FALSE;
+            }
+        }
+
+        if (b_index_ok)
+        {
+            if (records_walked != 0u)
+            {
+                p_state->records_written = (first_record_number + records_walked) - 1u;
+            }
+
+            p_state->b_index_valid = TRUE;
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsindex_partition_reset resets the record index for a partition which has
+ * just been formatted, so the index is valid and empty.
+ *
+ * @param   partition_index     Partition number to reset (0,1,2 etc).
+ *
+ */
+// ----------------------------------------------------------------------------
+void rsindex_partition_reset(const uint8_t partition_index)
+{
+    const rs_partition_info_t*  p_partition;
+
+    p_partition = rspartition_partition_ptr_get(partition_index);
+
+    if ( (p_partition != NULL) && (p_partition->index_pages != 0u) )
+    {
+        index_state_clear(&m_index_state[partition_index], p_partition);
+
+        m_index_state[partition_index].b_index_valid = TRUE;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsindex_record_written updates the record index after a record has been
+ * written into a partition, appending a checkpoint if one is due.
+ *
+ * @note
+ * A failed write still uses up space in the partition (the next free address
+ * skips over it), so the index can no longer be trusted and is invalidated.
+ *
+ * @param   partition_index     Partition number written to (0,1,2 etc).
+ * @param   rsr_start_address   Logical address of the start of the RSR.
+ * @param   record_id           Record ID of the RSR.
+ * @param   b_write_ok          TRUE if the write (and any read back) was OK.
+ *
+ */
+// ----------------------------------------------------------------------------
+void rsindex_record_written(const uint8_t partition_index,
+                            const uint32_t rsr_start_address,
+                            const uint16_t record_id,
+                            const bool_t b_write_ok)
+{
+    const rs_partition_info_t*  p_partition;
+    rsindex_state_t*            p_state;
+
+    p_partition = rspartition_partition_ptr_get(partition_index);
+
+    if ( (p_partition != NULL) && (m_index_state[partition_index].b_index_valid) )
+    {
+        p_state = &m_index_state[partition_index];
+
+        if (!b_write_ok)
+        {
+            p_state->b_index_valid = FALSE;
+        }
+        else
+        {
+            p_state->records_written++;
+
+            /* The checkpoint holds the instances before this record. */
+            if ( ((p_state->records_written - 1u) % RS_CFG_INDEX_RECORD_INTERVAL) == 0u)
+            {
+                p_state->b_index_valid = entry_append(p_partition,
+                                                      p_state,
+                                                      rsr_start_address);
+            }
+
+            id_instance_add(&p_state->id_table, record_id);
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsindex_search_seek uses the record index to convert a search into one
+ * which starts exactly at the required RSR, or (when matching the record ID)
+ * within one interval of it.
+ *
+ * If the index can be used, the search data is changed to a forwards search
+ * for the first RSR (with the required record ID, if matching), starting at
+ * the address found.  If the index can't be used then the search data is
+ * left untouched, so the normal search is carried out.
+ *
+ * @param   partition_index     Partition number to search (0,1,2 etc).
+ * @param   p_search_data       Pointer to search data structure to update.
+ * @retval  bool_t              TRUE if search data updated, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rsindex_search_seek(const uint8_t partition_index,
+                           rssearch_search_data_t * const p_search_data)
+{
+    const rs_partition_info_t*  p_partition;
+    const rsindex_state_t*      p_state;
+    rsindex_entry_t             entry;
+    uint32_t                    required_record_number;
+    uint32_t                    required_instance;
+    uint32_t                    total_instances;
+    uint32_t                    records_to_step = 0u;
+    uint32_t                    records_walked = 0u;
+    uint32_t                    rsr_start_address = 0u;
+    uint16_t                    slot;
+    bool_t                      b_seek_ok = FALSE;
+
+    p_partition = rspartition_partition_ptr_get(partition_index);
+
+    if ( (p_partition != NULL)
+            && (p_search_data != NULL)
+            && (m_index_state[partition_index].b_index_valid) )
+    {
+        p_state = &m_index_state[partition_index];
+
+        if (p_search_data->b_match_record_id)
+        {
+            slot = id_slot_find(&p_state->id_table, p_search_data->required_record_id);
+
+            /* Record IDs which aren't counted use the normal search. */
+            if (slot < p_state->id_table.ids_tracked)
+            {
+                total_instances = p_state->id_table.instances[slot];
+
+                if (p_search_data->required_record_instance < total_instances)
+                {
+                    /* Work out the instance counting from the first record. */
+                    if (p_search_data->search_direction == RSSEARCH_FORWARDS)
+                    {
+                        required_instance = p_search_data->required_record_instance;
+                    }
+                    else
+                    {
+                        required_instance = (total_instances - 1u)
+                                                - p_search_data->required_record_instance;
+                    }
+
+                    b_seek_ok = instance_entry_find(p_partition,
+                                                    p_state,
+                                                    slot,
+                                                    p_search_data->required_record_id,
+                                                    required_instance,
+                                                    &entry);
+
+                    /* Step over the instances between the checkpoint and this one. */
+                    if (b_seek_ok)
+                    {
+                        records_to_step = required_instance;
+
+                        if (slot < entry.id_table.ids_tracked)
+                        {
+                            records_to_step -= entry.id_table.instances[slot];
+                        }
+                    }
+                }
+            }
+        }
+        /* Instances count from zero, record numbers from one. */
+        else if (p_search_data->required_record_instance < p_state->records_written)
+        {
+            if (p_search_data->search_direction == RSSEARCH_FORWARDS)
+            {
+                required_record_number = p_search_data->required_record_instance + 1u;
+            }
+            else
+            {
+                required_record_number = p_state->records_written
+                                            - p_search_data->required_record_instance;
+            }
+
+            b_seek_ok = entry_read(p_partition,
+                                   (required_record_number - 1u) / RS_CFG_INDEX_RECORD_INTERVAL,
+                                   &entry);
+
+            if ( (b_seek_ok) && (entry.record_number <= required_record_number) )
+            {
+                records_to_step = required_record_number - entry.record_number;
+            }
+            else
+            {
+                b_seek_ok = FALSE;
+            }
+        }
+        else
+        {
+            ;   // Extra else for MISRA compliance - no such record.
+        }
+
+        if (b_seek_ok)
+        {
+            //lint -e{644} Entry is always set up if the seek is OK.
+            b_seek_ok = walk_records(p_partition,
+                                     entry.rsr_start_address,
+                                     records_to_step,
+                                     p_search_data->b_match_record_id,
+                                     p_search_data->required_record_id,
+                                     NULL,
+                                     &records_walked,
+                                     &rsr_start_address);
+
+            if (records_walked != records_to_step)
+            {
+                b_seek_ok = FALSE;
+            }
+        }
+    }
+
+    if (b_seek_ok)
+    {
+        p_search_data->search_direction         = RSSEARCH_FORWARDS;
+        p_search_data->search_start_address     = rsr_start_address;
+        p_search_data->required_record_instance = 0u;
+    }
+
+    return b_seek_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsindex_query_if_valid returns whether the record index for a partition
+ * can be used or not.
+ *
+ * @param   partition_index     Partition number to check (0,1,2 etc).
+ * @retval  bool_t              TRUE if index is valid, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rsindex_query_if_valid(const uint8_t partition_index)
+{
+    bool_t  b_index_valid = FALSE;
+
+    if (partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+    {
+        b_index_valid = m_index_state[partition_index].b_index_valid;
+    }
+
+    return b_index_valid;
+}
+
+
+#ifdef UNIT_TEST_BUILD
+// ----------------------------------------------------------------------------
+/**
+ * rsindex_unit_test_ptrs_get returns a pointer to the unit test pointers
+ * structure, for test purposes.
+ * We use an ifdef to ensure that this pointer can't be accessed under
+ * normal operation.
+ *
+ * @retval rsindex_unit_test_ptrs_t*    Pointer to test structure.
+ *
+ */
+// ----------------------------------------------------------------------------
+rsindex_unit_test_ptrs_t* rsindex_unit_test_ptrs_get(void)
+{
+    //lint -e{956} Doesn't need to be volatile here. Pointers never change.
+    static rsindex_unit_test_ptrs_t p_unit_test_structure =
+    {
+        &m_index_state[0u],
+    };
+
+    return &p_unit_test_structure;
+}
+#endif
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * index_state_clear clears the index state for a partition and works out
+ * how many checkpoints the index area can hold.  The index is left invalid.
+ *
+ * @param   p_state         Pointer to index state to clear.
+ * @param   p_partition     Pointer to partition information.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void index_state_clear(rsindex_state_t * const p_state,
+                              const rs_partition_info_t * const p_partition)
+{
+    p_state->b_index_valid         = FALSE;
+    p_state->entries_used          = 0u;
+    p_state->records_written       = 0u;
+    p_state->id_table.ids_tracked  = 0u;
+
+    p_state->maximum_entries = ((p_partition->index_end_address
+                                    - p_partition->index_start_address) + 1u)
+                                        / INDEX_ENTRY_SIZE_BYTES;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * count_entries_used uses a bisection search to find the first blank
+ * checkpoint in the index area, which is the number of checkpoints used.
+ *
+ * @note
+ * This works because the index area is only ever appended to, so all the
+ * used checkpoints are at the start and all the blank ones are at the end.
+ *
+ * @param   p_partition     Pointer to partition information.
+ * @param   p_state         Pointer to index state.
+ * @retval  uint32_t        Number of checkpoints used.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t count_entries_used(const rs_partition_info_t * const p_partition,
+                                   const rsindex_state_t * const p_state)
+{
+    uint32_t    lower_entry = 0u;
+    uint32_t    upper_entry = p_state->maximum_entries;
+    uint32_t    entry_to_check;
+    bool_t      b_entry_is_blank;
+
+    while (lower_entry < upper_entry)
+    {
+        entry_to_check = (lower_entry + upper_entry) / 2u;
+
+        //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+        b_entry_is_blank = flash_hal_device_blank_check
+                                (p_partition->index_start_address
+                                    + (entry_to_check * INDEX_ENTRY_SIZE_BYTES),
+                                 (uint32_t)INDEX_ENTRY_SIZE_BYTES);
+
+        if (b_entry_is_blank)
+        {
+            upper_entry = entry_to_check;
+        }
+        else
+        {
+            lower_entry = entry_to_check + 1u;
+        }
+    }
+
+    return lower_entry;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * entry_read reads a single checkpoint from the index area and checks the CRC.
+ *
+ * @param   p_partition     Pointer to partition information.
+ * @param   entry_number    Checkpoint number to read (0,1,2 etc).
+ * @param   p_entry         Pointer to checkpoint structure to fill in.
+ * @retval  bool_t          TRUE if checkpoint read OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t entry_read(const rs_partition_info_t * const p_partition,
+                         const uint32_t entry_number,
+                         rsindex_entry_t * const p_entry)
+{
+    uint8_t             entry_buffer[INDEX_ENTRY_SIZE_BYTES];
+    flash_hal_error_t   flash_read_status;
+    uint16_t            extracted_crc;
+    uint16_t            calculated_crc;
+    uint16_t            slot;
+    bool_t              b_entry_ok = FALSE;
+
+    //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+    flash_read_status = flash_hal_device_read(p_partition->index_start_address
+                                                + (entry_number * INDEX_ENTRY_SIZE_BYTES),
+                                              (uint32_t)INDEX_ENTRY_SIZE_BYTES,
+                                              &entry_buffer[0u]);
+
+    if (flash_read_status == FLASH_HAL_NO_ERROR)
+    {
+        //lint -e{921} Cast from uint8_t to uint16_t before shifting.
+        extracted_crc = (((uint16_t)entry_buffer[INDEX_ENTRY_CRC_OFFSET] << 8u) & 0xFF00u)
+                            | ((uint16_t)entry_buffer[INDEX_ENTRY_CRC_OFFSET + 1u] & 0x00FFu);
+
+        calculated_crc = CRC_CCITTOnByteCalculate(&entry_buffer[0u],
+                                                  INDEX_ENTRY_CRC_LENGTH,
+                                                  0x0000u);
+
+        if (extracted_crc == calculated_crc)
+        {
+            p_entry->record_number
+                = BUFFER_UTILS_8bitBufToUint32(&entry_buffer[INDEX_ENTRY_NUMBER_OFFSET]);
+
+            p_entry->rsr_start_address
+                = BUFFER_UTILS_8bitBufToUint32(&entry_buffer[INDEX_ENTRY_ADDRESS_OFFSET]);
+
+            p_entry->id_table.ids_tracked
+                = BUFFER_UTILS_8bitBufToUint16(&entry_buffer[INDEX_ENTRY_TRACKED_OFFSET]);
+
+            if (p_entry->id_table.ids_tracked <= RS_CFG_INDEX_RECORD_IDS)
+            {
+                for (slot = 0u; slot < p_entry->id_table.ids_tracked; slot++)
+                {
+                    p_entry->id_table.record_ids[slot] = BUFFER_UTILS_8bitBufToUint16
+                            (&entry_buffer[INDEX_ENTRY_IDS_OFFSET + (2u * slot)]);
+
+                    p_entry->id_table.instances[slot] = BUFFER_UTILS_8bitBufToUint32
+                            (&entry_buffer[INDEX_ENTRY_INSTANCES_OFFSET + (4u * slot)]);
+                }
+
+                b_entry_ok = TRUE;
+            }
+        }
+    }
+
+    return b_entry_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * entry_append writes a checkpoint for the most recent record into the next
+ * free location in the index area, with the instances of each record ID
+ * written before it.
+ *
+ * @param   p_partition         Pointer to partition information.
+ * @param   p_state             Pointer to index state to update.
+ * @param   rsr_start_address   Logical address of the start of the RSR.
+ * @retval  bool_t              TRUE if checkpoint written OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t entry_append(const rs_partition_info_t * const p_partition,
+                           rsindex_state_t * const p_state,
+                           const uint32_t rsr_start_address)
+{
+    uint8_t             entry_buffer[INDEX_ENTRY_SIZE_BYTES];
+    flash_hal_error_t   flash_write_status;
+    uint16_t            calculated_crc;
+    uint16_t            slot;
+    bool_t              b_entry_ok = FALSE;
+
+    /* Once the index area is full the index can't keep up any more. */
+    if (p_state->entries_used < p_state->maximum_entries)
+    {
+        /* Slots which aren't in use are left blank. */
+        for (slot = 0u; slot < INDEX_ENTRY_CRC_LENGTH; slot++)
+        {
+            entry_buffer[slot] = RS_CFG_BLANK_LOCATION_CONTAINS;
+        }
+
+        //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+        (void)BUFFER_UTILS_Uint32To8bitBuf(&entry_buffer[INDEX_ENTRY_NUMBER_OFFSET],
+                                           p_state->records_written);
+
+        //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+        (void)BUFFER_UTILS_Uint32To8bitBuf(&entry_buffer[INDEX_ENTRY_ADDRESS_OFFSET],
+                                           rsr_start_address);
+
+        //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+        (void)BUFFER_UTILS_Uint16To8bitBuf(&entry_buffer[INDEX_ENTRY_TRACKED_OFFSET],
+                                           p_state->id_table.ids_tracked);
+
+        for (slot = 0u; slot < p_state->id_table.ids_tracked; slot++)
+        {
+            //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+            (void)BUFFER_UTILS_Uint16To8bitBuf
+                        (&entry_buffer[INDEX_ENTRY_IDS_OFFSET + (2u * slot)],
+                         p_state->id_table.record_ids[slot]);
+
+            //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+            (void)BUFFER_UTILS_Uint32To8bitBuf
+                        (&entry_buffer[INDEX_ENTRY_INSTANCES_OFFSET + (4u * slot)],
+                         p_state->id_table.instances[slot]);
+        }
+
+        calculated_crc = CRC_CCITTOnByteCalculate(&entry_buffer[0u],
+                                                  INDEX_ENTRY_CRC_LENGTH,
+                                                  0x0000u);
+
+        //lint -e{921} Cast to 8 bits, just take the MSB here.
+        entry_buffer[INDEX_ENTRY_CRC_OFFSET] = (uint8_t)((calculated_crc >> 8u) & 0x00FFu);
+
+        //lint -e{921} Cast to 8 bits, just take the LSB here.
+        entry_buffer[INDEX_ENTRY_CRC_OFFSET + 1u] = (uint8_t)(calculated_crc & 0x00FFu);
+
+        //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+        flash_write_status = flash_hal_device_write(p_partition->index_start_address
+                                                        + (p_state->entries_used * INDEX_ENTRY_SIZE_BYTES),
+                                                    (uint32_t)INDEX_ENTRY_SIZE_BYTES,
+                                                    &entry_buffer[0u]);
+
+        /* The location is used up whether the write worked or not. */
+        p_state->entries_used++;
+
+        if (flash_write_status == FLASH_HAL_NO_ERROR)
+        {
+            b_entry_ok = TRUE;
+        }
+    }
+
+    return b_entry_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * instance_entry_find uses a bisection search to find the last checkpoint
+ * with no more than the required number of instances of a record ID before
+ * it.  The required instance is then within the interval which starts at
+ * that checkpoint.
+ *
+ * @note
+ * This works because the instances of a record ID only ever go up from one
+ * checkpoint to the next.  The first checkpoint has no instances of anything
+ * before it, so there is always a checkpoint to find.
+ *
+ * @param   p_partition     Pointer to partition information.
+ * @param   p_state         Pointer to index state.
+ * @param   slot            Slot of the record ID in the ID tables.
+ * @param   record_id       Record ID to find.
+ * @param   instance        Instance to find, counting from the first record.
+ * @param   p_entry         Pointer to checkpoint structure to fill in.
+ * @retval  bool_t          TRUE if checkpoint found OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t instance_entry_find(const rs_partition_info_t * const p_partition,
+                                  const rsindex_state_t * const p_state,
+                                  const uint16_t slot,
+                                  const uint16_t record_id,
+                                  const uint32_t instance,
+                                  rsindex_entry_t * const p_entry)
+{
+    uint32_t    lower_entry = 0u;
+    uint32_t    upper_entry = p_state->entries_used;
+    uint32_t    entry_to_check;
+    uint32_t    instances_before = 0u;
+    bool_t      b_entry_ok = TRUE;
+
+    while ( (b_entry_ok) && ((upper_entry - lower_entry) > 1u) )
+    {
+        entry_to_check = (lower_entry + upper_entry) / 2u;
+
+        b_entry_ok = entry_read(p_partition, entry_to_check, p_entry);
+
+        if (b_entry_ok)
+        {
+            /* An ID which hadn't been written yet has no instances. */
+            instances_before = 0u;
+
+            if (slot < p_entry->id_table.ids_tracked)
+            {
+                /* IDs never change slot, anything else is corrupt. */
+                b_entry_ok = (p_entry->id_table.record_ids[slot] == record_id);
+
+                instances_before = p_entry->id_table.instances[slot];
+            }
+
+            if (instances_before <= instance)
+            {
+                lower_entry = entry_to_check;
+            }
+            else
+            {
+                upper_entry = entry_to_check;
+            }
+        }
+    }
+
+    if (b_entry_ok)
+    {
+        b_entry_ok = entry_read(p_partition, lower_entry, p_entry);
+
+        if ( (b_entry_ok)
+                && (slot < p_entry->id_table.ids_tracked)
+                && ( (p_entry->id_table.record_ids[slot] != record_id)
+                        || (p_entry->id_table.instances[slot] > instance) ) )
+        {
+            b_entry_ok = FALSE;
+        }
+    }
+
+    return b_entry_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * id_slot_find finds the slot for a record ID in an ID table.
+ *
+ * @param   p_id_table      Pointer to the ID table.
+ * @param   record_id       Record ID to find.
+ * @retval  uint16_t        Slot, or the number of slots in use if not found.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t id_slot_find(const rsindex_id_table_t * const p_id_table,
+                             const uint16_t record_id)
+{
+    uint16_t    slot = 0u;
+
+    while ( (slot < p_id_table->ids_tracked)
+                && (p_id_table->record_ids[slot] != record_id) )
+    {
+        slot++;
+    }
+
+    return slot;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * id_instance_add counts another instance of a record ID, giving the record
+ * ID a slot if it hasn't been written before and there's a slot free.
+ *
+ * @param   p_id_table      Pointer to the ID table to update.
+ * @param   record_id       Record ID of the record written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void id_instance_add(rsindex_id_table_t * const p_id_table,
+                            const uint16_t record_id)
+{
+    uint16_t    slot;
+
+    slot = id_slot_find(p_id_table, record_id);
+
+    if (slot < p_id_table->ids_tracked)
+    {
+        p_id_table->instances[slot]++;
+    }
+    else if (p_id_table->ids_tracked < RS_CFG_INDEX_RECORD_IDS)
+    {
+        p_id_table->record_ids[slot] = record_id;
+        p_id_table->instances[slot]  = 1u;
+        p_id_table->ids_tracked++;
+    }
+    else
+    {
+        ;   // Extra else for MISRA compliance - ID isn't counted.
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * walk_records steps forwards through the partition one RSR at a time, using
+ * the length in each RSR header, until either the required number of records
+ * have been stepped over or the end of the data is reached.
+ *
+ * When matching the record ID only the records with that ID are counted, and
+ * the walk stops straight after the last one counted.  If an ID table is
+ * given, every record stepped over is added to it.
+ *
+ * @note
+ * This function only checks the sync character and the length of each RSR,
+ * not the CRC, as the RSR which is finally found is checked by the normal
+ * search anyway.
+ *
+ * @param   p_partition             Pointer to partition information.
+ * @param   logical_start_address   Address of the first RSR to step over.
+ * @param   maximum_records         Maximum number of records to step over.
+ * @param   b_match_record_id       TRUE to only count records with record_id.
+ * @param   record_id               Record ID to count, if matching.
+ * @param   p_id_table              Pointer to ID table to update, or NULL.
+ * @param   p_records_walked        Pointer to return number of records counted.
+ * @param   p_end_address           Pointer to return the address reached.
+ * @retval  bool_t                  TRUE if all RSR headers were OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t walk_records(const rs_partition_info_t * const p_partition,
+                           const uint32_t logical_start_address,
+                           const uint32_t maximum_records,
+                           const bool_t b_match_record_id,
+                           const uint16_t record_id,
+                           rsindex_id_table_t * const p_id_table,
+                           uint32_t * const p_records_walked,
+                           uint32_t * const p_end_address)
+{
+    uint8_t     rsr_header[RSR_HEADER_READ_SIZE];
+    uint32_t    logical_address = logical_start_address;
+    uint32_t    data_end_address;
+    uint32_t    records_walked = 0u;
+    uint16_t    tdr_length;
+    uint16_t    rsr_record_id;
+    bool_t      b_walk_ok = TRUE;
+
+    data_end_address = partition_data_end_get(p_partition);
+
+    while ( (records_walked < maximum_records)
+                && (logical_address < data_end_address) )
+    {
+        //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+        b_walk_ok = partition_data_read(p_partition,
+                                        logical_address,
+                                        (uint32_t)RSR_HEADER_READ_SIZE,
+                                        &rsr_header[0u]);
+
+        /* Blank means we've reached the end of the data in a full partition. */
+        if ( (!b_walk_ok) || (rsr_header[0u] == RS_CFG_BLANK_LOCATION_CONTAINS) )
+        {
+            break;
+        }
+
+        tdr_length    = BUFFER_UTILS_8bitBufToUint16(&rsr_header[RSR_LENGTH_OFFSET]);
+        rsr_record_id = BUFFER_UTILS_8bitBufToUint16(&rsr_header[RSR_ID_OFFSET]);
+
+        if ( (rsr_header[0u] != RSR_SYNC_CHARACTER)
+                || (tdr_length > RS_CFG_MAX_TDR_SIZE_BYTES) )
+        {
+            b_walk_ok = FALSE;
+            break;
+        }
+
+        //lint -e{921} Cast to uint32_t to force arithmetic as 32 bit.
+        logical_address = partition_address_advance(p_partition,
+                                                    logical_address,
+                                                    (uint32_t)tdr_length + RSR_WRAPPER_SIZE_OVERHEAD);
+
+        if ( (!b_match_record_id) || (rsr_record_id == record_id) )
+        {
+            records_walked++;
+        }
+
+        if (p_id_table != NULL)
+        {
+            id_instance_add(p_id_table, rsr_record_id);
+        }
+    }
+
+    *p_records_walked = records_walked;
+    *p_end_address    = logical_address;
+
+    return b_walk_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * partition_data_read reads a small block of data from the partition,
+ * skipping the page header if the block spans two pages.
+ *
+ * @param   p_partition         Pointer to partition information.
+ * @param   logical_address     Address of the first byte to read.
+ * @param   number_of_bytes     Number of bytes to read.
+ * @param   p_buffer            Pointer to buffer to read into.
+ * @retval  bool_t              TRUE if read OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t partition_data_read(const rs_partition_info_t * const p_partition,
+                                  const uint32_t logical_address,
+                                  const uint32_t number_of_bytes,
+                                  uint8_t * const p_buffer)
+{
+    rs_page_details_t   page_details;
+    uint32_t            free_space_in_page;
+    flash_hal_error_t   flash_read_status;
+
+    page_details.partition_logical_start_address = p_partition->start_address;
+    page_details.partition_logical_end_address   = p_partition->end_address;
+    page_details.address_within_partition        = logical_address;
+
+    //lint -e{920} Ignore return value as the address is always within the partition.
+    (void)rspages_page_details_calculate(&page_details);
+
+    /* Distance doesn't take into account the current address. */
+    free_space_in_page = page_details.distance_to_upper_address + 1u;
+
+    if (number_of_bytes <= free_space_in_page)
+    {
+        flash_read_status = flash_hal_device_read(logical_address,
+                                                  number_of_bytes,
+                                                  p_buffer);
+    }
+    else
+    {
+        flash_read_status = flash_hal_device_read(logical_address,
+                                                  free_space_in_page,
+                                                  p_buffer);
+
+        if (flash_read_status == FLASH_HAL_NO_ERROR)
+        {
+            flash_read_status = flash_hal_device_read(page_details.upper_address_within_page
+                                                        + PAGE_HEADER_LENGTH_BYTES + 1u,
+                                                      number_of_bytes - free_space_in_page,
+                                                      &p_buffer[free_space_in_page]);
+        }
+    }
+
+    return (flash_read_status == FLASH_HAL_NO_ERROR);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * partition_address_advance works out the address which follows a block of
+ * data written at a particular address, in the same way that the page write
+ * code does - so the page header is skipped if the data spans two pages, and
+ * if the data exactly fills the page the next address is after the next
+ * page header.
+ *
+ * @param   p_partition         Pointer to partition information.
+ * @param   logical_address     Address of the start of the data.
+ * @param   number_of_bytes     Number of bytes of data.
+ * @retval  uint32_t            Address following the data.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t partition_address_advance
+                        (const rs_partition_info_t * const p_partition,
+                         const uint32_t logical_address,
+                         const uint32_t number_of_bytes)
+{
+    rs_page_details_t   page_details;
+    uint32_t            free_space_in_page;
+    uint32_t            next_address;
+
+    page_details.partition_logical_start_address = p_partition->start_address;
+    page_details.partition_logical_end_address   = p_partition->end_address;
+    page_details.address_within_partition        = logical_address;
+
+    //lint -e{920} Ignore return value as the address is always within the partition.
+    (void)rspages_page_details_calculate(&page_details);
+
+    /* Distance doesn't take into account the current address. */
+    free_space_in_page = page_details.distance_to_upper_address + 1u;
+
+    if (number_of_bytes < free_space_in_page)
+    {
+        next_address = logical_address + number_of_bytes;
+    }
+    else
+    {
+        next_address = page_details.upper_address_within_page
+                        + PAGE_HEADER_LENGTH_BYTES + 1u
+                        + (number_of_bytes - free_space_in_page);
+    }
+
+    return next_address;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * partition_data_end_get returns the address after the last data in the
+ * partition, which is the next available address unless the partition is
+ * full, in which case it's the address after the end of the partition.
+ *
+ * @param   p_partition     Pointer to partition information.
+ * @retval  uint32_t        Address after the last data in the partition.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t partition_data_end_get
+                        (const rs_partition_info_t * const p_partition)
+{
+    uint32_t    data_end_address = p_partition->next_available_address;
+
+    if (data_end_address > p_partition->end_address)
+    {
+        data_end_address = p_partition->end_address + 1u;
+    }
+
+    return data_end_address;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
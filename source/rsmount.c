@@ -0,0 +1,763 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        rsmount.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Support functions for the recording system mount record.
+ * @details
+ * Support functions for the recording system, anything related to the
+ * mount record which allows the partitions to be mounted quickly at startup.
+ *
+ * Normally each partition is mounted using a bisection search over whole
+ * pages followed by a backwards search for the next free address, which is
+ * a lot of flash access to repeat at every power up.  A mount record holds,
+ * for every partition, the next available address, the free and full page
+ * counters and the partition status, along with a generation number and a
+ * signature of the partition layout, all protected by a CRC.
+ *
+ * The mount records are appended to an area of RS_CFG_MOUNT_RECORD_BLOCKS
+ * blocks which follows the last partition.  The blocks are used in turn -
+ * once a block is full the next one is erased and used, so the latest mount
+ * record is never erased until a newer one has been written.
+ *
+ * A mount record is written after a partition is formatted, whenever
+ * rsapi_mount_record_write() is called (i.e. on a clean shutdown), every
+ * RS_CFG_MOUNT_RECORD_INTERVAL records written and at the end of startup if
+ * any partition could not be restored directly.
+ *
+ * At startup the latest mount record is found and each partition is checked
+ * against it.  The location just before the stored next free address must
+ * have been written and a short area from the next free address must still
+ * be blank - if so the partition is restored without any searching.  If the
+ * area at the next free address has been written since (i.e. the mount record
+ * is older than the data) then the bisection search only has to cover the
+ * pages from the stored one onwards.  Anything else falls back to the normal
+ * bisection search over the whole partition.
+ *
+ * @note
+ * These functions should only be called from other recording system functions,
+ * not directly as if they were part of the API.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rspages.h"
+#include "rspartition.h"
+#include "rsmount.h"
+#include "rsmount_prv.h"
+#include "flash_hal.h"
+#include "buffer_utils.h"
+#include "crc.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define MOUNT_RECORD_SIZE_BYTES     128u    ///< Size of each mount record slot.
+#define MOUNT_RECORD_SYNC_1         0xC3u   ///< First sync byte of a mount record.
+#define MOUNT_RECORD_SYNC_2         0x5Au   ///< Second sync byte of a mount record.
+#define MOUNT_GENERATION_OFFSET     2u      ///< Offset of generation (LSB first).
+#define MOUNT_LAYOUT_OFFSET         6u      ///< Offset of layout signature (LSB first).
+#define MOUNT_PARTITION_OFFSET      8u      ///< Offset of first partition.
+#define MOUNT_PARTITION_SIZE        14u     ///< Address, free, full, status, spare.
+#define MOUNT_PARTITION_FREE        4u      ///< Offset of free pages within partition.
+#define MOUNT_PARTITION_FULL        8u      ///< Offset of full pages within partition.
+#define MOUNT_PARTITION_STATUS      12u     ///< Offset of status within partition.
+
+/// CRC follows the partitions and covers everything before it (MSB first).
+#define MOUNT_CRC_OFFSET            (MOUNT_PARTITION_OFFSET                 \
+                                        + (MOUNT_PARTITION_SIZE             \
+                                            * RS_CFG_MAX_NUMBER_OF_PARTITIONS))
+
+#if ((MOUNT_CRC_OFFSET + 2u) > MOUNT_RECORD_SIZE_BYTES)
+#error "Too many partitions to fit in a mount record."
+#endif
+
+/// Number of bytes read either side of the next free address.
+#define MOUNT_USED_CHECK_BYTES      2u
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t record_read(const uint16_t block, const uint32_t slot);
+
+static uint32_t count_slots_used(const uint16_t block);
+
+static uint16_t layout_signature_calculate(void);
+
+static bool_t location_is_used(const uint32_t logical_address);
+
+static uint32_t slot_address_get(const uint16_t block, const uint32_t slot);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// State of the mount record area.
+//lint -e{956} Doesn't need to be volatile, only used by the read \ write task.
+static rsmount_state_t      m_mount_state;
+
+/// Partition details from the latest mount record.
+//lint -e{956} Doesn't need to be volatile, only used by the read \ write task.
+static rsmount_partition_t  m_mount_partitions[RS_CFG_MAX_NUMBER_OF_PARTITIONS];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * rsmount_load finds the latest mount record and loads it, ready for the
+ * partitions to be restored.
+ *
+ * The block holding the latest record is the one whose first record has the
+ * highest generation, and the records in a block are found with a bisection
+ * search (they're only ever appended).  If the last record in the block is
+ * corrupt (power lost while writing it) the one before is used instead.
+ *
+ * @note
+ * This function needs the partition addresses to have been calculated and
+ * the flash HAL to have been initialised before it is called.
+ *
+ */
+// ----------------------------------------------------------------------------
+void rsmount_load(void)
+{
+    uint32_t    area_end_address;
+    uint16_t    block;
+    uint32_t    highest_generation = 0u;
+    bool_t      b_block_found = FALSE;
+    uint32_t    slots_used;
+
+    m_mount_state.b_record_loaded     = FALSE;
+    m_mount_state.b_refresh_required  = FALSE;
+    m_mount_state.records_since_write = 0u;
+    m_mount_state.generation          = 0u;
+
+    m_mount_state.b_area_available
+        = rspartition_mount_area_get(&m_mount_state.area_start_address,
+                                     &area_end_address);
+
+    if (m_mount_state.b_area_available)
+    {
+        m_mount_state.block_size_bytes = ((area_end_address
+                                            - m_mount_state.area_start_address) + 1u)
+                                                / RS_CFG_MOUNT_RECORD_BLOCKS;
+
+        m_mount_state.slots_per_block = m_mount_state.block_size_bytes
+                                            / MOUNT_RECORD_SIZE_BYTES;
+
+        m_mount_state.layout_signature = layout_signature_calculate();
+
+        /*
+         * Nothing found yet, so the first write moves on to (and erases)
+         * the first block, as we can't be sure what state it's in.
+         */
+        m_mount_state.current_block = RS_CFG_MOUNT_RECORD_BLOCKS - 1u;
+        m_mount_state.next_slot     = m_mount_state.slots_per_block;
+
+        for (block = 0u; block < RS_CFG_MOUNT_RECORD_BLOCKS; block++)
+        {
+            if ( (record_read(block, 0u))
+                    && ( (!b_block_found)
+                            || (m_mount_state.generation > highest_generation) ) )
+            {
+                b_block_found = TRUE;
+                highest_generation = m_mount_state.generation;
+                m_mount_state.current_block = block;
+            }
+        }
+
+        if (b_block_found)
+        {
+            slots_used = count_slots_used(m_mount_state.current_block);
+
+            m_mount_state.next_slot = slots_used;
+
+            /* Fall back to the previous record if the last one is corrupt. */
+            if (record_read(m_mount_state.current_block, slots_used - 1u))
+            {
+                m_mount_state.b_record_loaded = TRUE;
+            }
+            else if ( (slots_used > 1u)
+                        && (record_read(m_mount_state.current_block, slots_used - 2u)) )
+            {
+                m_mount_state.b_record_loaded = TRUE;
+            }
+            else
+            {
+                /* Make sure the next record still has the highest generation. */
+                m_mount_state.generation = highest_generation + slots_used;
+            }
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsmount_partition_restore uses the latest mount record to set up the
+ * partition information, without having to search the partition.
+ *
+ * A partition is only restored if the mount record matches what is in the
+ * flash - the location before the next free address must have been written
+ * (or for the first location in a page, the page header) and a short area
+ * from the next free address must be blank.  If the area from the next free
+ * address has been written since the mount record then the bisection search
+ * is done, but only from the page which the mount record points at.
+ *
+ * A ring log is always searched, as its sequence numbers find the page being
+ * written in a handful of header reads - the mount record can't say where
+ * the oldest data is.
+ *
+ * @param   partition_index     Partition number to restore (0,1,2 etc).
+ * @retval  bool_t              TRUE if partition set up, FALSE if the partition
+ *                              still needs to be searched.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rsmount_partition_restore(const uint8_t partition_index)
+{
+    const uint32_t              page_size_in_bytes = RS_CFG_PAGE_SIZE_KB * 1024u;
+    const rs_partition_info_t*  p_partition;
+    const rsmount_partition_t*  p_mount;
+    uint32_t                    tail_address;
+    uint32_t                    page_number;
+    uint32_t                    page_start_address;
+    uint32_t                    offset_in_page;
+    uint32_t                    used_check_address;
+    uint32_t                    tail_check_bytes;
+    bool_t                      b_restored = FALSE;
+
+    p_partition = rspartition_partition_ptr_get(partition_index);
+
+    if ( (p_partition != NULL) && (m_mount_state.b_record_loaded) )
+    {
+        p_mount = &m_mount_partitions[partition_index];
+
+        /* Ring log - no need to refresh the mount record afterwards. */
+        if (p_partition->ring_unit_pages != 0u)
+        {
+            //lint -e{920} Ignoring return value, the search sets up the partition status.
+            (void)rspartition_bisection_search_do(partition_index);
+            b_restored = TRUE;
+        }
+        /* Unformatted - the first page must still be blank. */
+        else if (p_mount->partition_error_status == RS_ERR_PARTITION_NEEDS_FORMAT)
+        {
+            if (!location_is_used(p_partition->start_address))
+            {
+                b_restored = rspartition_mount_state_set(partition_index,
+                                                         0xFFFFFFFFu,
+                                                         0u,
+                                                         0u,
+                                                         RS_ERR_PARTITION_NEEDS_FORMAT);
+            }
+        }
+        /* Full - the last page header must still be there. */
+        else if (p_mount->partition_error_status == RS_ERR_PARTITION_IS_FULL)
+        {
+            page_start_address = p_partition->start_address
+                                    + ((p_partition->number_of_pages - 1u)
+                                        * page_size_in_bytes);
+
+            if ( (p_mount->free_pages == 0u)
+                    && (p_mount->full_pages == p_partition->number_of_pages)
+                    && (location_is_used(page_start_address)) )
+            {
+                b_restored = rspartition_mount_state_set(partition_index,
+                                                         0xFFFFFFFFu,
+                                                         0u,
+                                                         p_partition->number_of_pages,
+                                                         RS_ERR_PARTITION_IS_FULL);
+            }
+        }
+        else if (p_mount->partition_error_status == RS_ERR_NO_ERROR)
+        {
+            tail_address = p_mount->next_available_address;
+
+            if ( (tail_address >= (p_partition->start_address + PAGE_HEADER_LENGTH_BYTES))
+                    && (tail_address <= p_partition->end_address) )
+            {
+                page_number        = (tail_address - p_partition->start_address)
+                                        / page_size_in_bytes;
+                page_start_address = p_partition->start_address
+                                        + (page_number * page_size_in_bytes);
+                offset_in_page     = tail_address - page_start_address;
+
+                if (offset_in_page == PAGE_HEADER_LENGTH_BYTES)
+                {
+                    used_check_address = page_start_address;
+                }
+                else
+                {
+                    used_check_address = tail_address - MOUNT_USED_CHECK_BYTES;
+                }
+
+                if ( (offset_in_page >= PAGE_HEADER_LENGTH_BYTES)
+                        && (p_mount->full_pages == page_number)
+                        && (p_mount->free_pages
+                                == (p_partition->number_of_pages - page_number))
+                        && (location_is_used(used_check_address)) )
+                {
+                    tail_check_bytes = page_size_in_bytes - offset_in_page;
+
+                    if (tail_check_bytes > RS_CFG_MOUNT_TAIL_CHECK_BYTES)
+                    {
+                        tail_check_bytes = RS_CFG_MOUNT_TAIL_CHECK_BYTES;
+                    }
+
+                    if (flash_hal_device_blank_check(tail_address, tail_check_bytes))
+                    {
+                        b_restored = rspartition_mount_state_set(partition_index,
+                                                                 tail_address,
+                                                                 p_mount->free_pages,
+                                                                 p_mount->full_pages,
+                                                                 RS_ERR_NO_ERROR);
+                    }
+                    else
+                    {
+                        /* Written since, but nothing before this page has changed. */
+                        //lint -e{920} Ignoring return value, page is known to be formatted.
+                        (void)rspartition_bisection_search_from(partition_index,
+                                                                page_number);
+                        m_mount_state.b_refresh_required = TRUE;
+                        b_restored = TRUE;
+                    }
+                }
+            }
+        }
+        else
+        {
+            ;   // Extra else for MISRA compliance - any other status needs a search.
+        }
+    }
+
+    if (!b_restored)
+    {
+        m_mount_state.b_refresh_required = TRUE;
+    }
+
+    return b_restored;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsmount_partitions_mounted is called once all of the partitions have been
+ * mounted, and writes a new mount record if any of them had to be searched
+ * so that the next startup is quick.
+ *
+ */
+// ----------------------------------------------------------------------------
+void rsmount_partitions_mounted(void)
+{
+    if ( (m_mount_state.b_area_available)
+            && ( (m_mount_state.b_refresh_required)
+                    || (!m_mount_state.b_record_loaded) ) )
+    {
+        //lint -e{920} Ignoring return value, startup carries on regardless.
+        (void)rsmount_record_write();
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsmount_record_write writes a new mount record, holding the current state
+ * of every partition, into the next free slot in the mount record area.
+ *
+ * If the current block is full then the next block is erased first.
+ *
+ * @retval  bool_t      TRUE if the mount record was written OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rsmount_record_write(void)
+{
+    uint8_t                     record_buffer[MOUNT_RECORD_SIZE_BYTES];
+    const rs_partition_info_t*  p_partition;
+    uint8_t                     partition_index;
+    uint16_t                    byte_index;
+    uint16_t                    offset;
+    uint16_t                    calculated_crc;
+    flash_hal_error_t           flash_status = FLASH_HAL_NO_ERROR;
+    bool_t                      b_write_ok = FALSE;
+
+    if (m_mount_state.b_area_available)
+    {
+        /* Move on to the next block once this one is full. */
+        if (m_mount_state.next_slot >= m_mount_state.slots_per_block)
+        {
+            m_mount_state.current_block++;
+
+            if (m_mount_state.current_block >= RS_CFG_MOUNT_RECORD_BLOCKS)
+            {
+                m_mount_state.current_block = 0u;
+            }
+
+            m_mount_state.next_slot = 0u;
+
+            flash_status = flash_hal_device_erase(slot_address_get(m_mount_state.current_block, 0u),
+                                                  m_mount_state.block_size_bytes);
+        }
+
+        if (flash_status == FLASH_HAL_NO_ERROR)
+        {
+            m_mount_state.generation++;
+
+            for (byte_index = 0u; byte_index < MOUNT_RECORD_SIZE_BYTES; byte_index++)
+            {
+                record_buffer[byte_index] = RS_CFG_BLANK_LOCATION_CONTAINS;
+            }
+
+            record_buffer[0u] = MOUNT_RECORD_SYNC_1;
+            record_buffer[1u] = MOUNT_RECORD_SYNC_2;
+
+            //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+            (void)BUFFER_UTILS_Uint32To8bitBuf(&record_buffer[MOUNT_GENERATION_OFFSET],
+                                               m_mount_state.generation);
+
+            //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+            (void)BUFFER_UTILS_Uint16To8bitBuf(&record_buffer[MOUNT_LAYOUT_OFFSET],
+                                               m_mount_state.layout_signature);
+
+            for (partition_index = 0u;
+                    partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS;
+                    partition_index++)
+            {
+                p_partition = rspartition_partition_ptr_get(partition_index);
+
+                offset = MOUNT_PARTITION_OFFSET
+                            + (partition_index * MOUNT_PARTITION_SIZE);
+
+                //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+                (void)BUFFER_UTILS_Uint32To8bitBuf(&record_buffer[offset],
+                                                   p_partition->next_available_address);
+
+                //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+                (void)BUFFER_UTILS_Uint32To8bitBuf(&record_buffer[offset + MOUNT_PARTITION_FREE],
+                                                   p_partition->free_pages);
+
+                //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+                (void)BUFFER_UTILS_Uint32To8bitBuf(&record_buffer[offset + MOUNT_PARTITION_FULL],
+                                                   p_partition->full_pages);
+
+                //lint -e{921} Cast from enum to uint8_t, values are all small.
+                record_buffer[offset + MOUNT_PARTITION_STATUS]
+                    = (uint8_t)p_partition->partition_error_status;
+            }
+
+            calculated_crc = CRC_CCITTOnByteCalculate(&record_buffer[0u],
+                                                      MOUNT_CRC_OFFSET,
+                                                      0x0000u);
+
+            //lint -e{921} Cast to 8 bits, just take the MSB here.
+            record_buffer[MOUNT_CRC_OFFSET] = (uint8_t)((calculated_crc >> 8u) & 0x00FFu);
+
+            //lint -e{921} Cast to 8 bits, just take the LSB here.
+            record_buffer[MOUNT_CRC_OFFSET + 1u] = (uint8_t)(calculated_crc & 0x00FFu);
+
+            //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+            flash_status = flash_hal_device_write(slot_address_get(m_mount_state.current_block,
+                                                                   m_mount_state.next_slot),
+                                                  (uint32_t)MOUNT_RECORD_SIZE_BYTES,
+                                                  &record_buffer[0u]);
+
+            /* The slot is used up whether the write worked or not. */
+            m_mount_state.next_slot++;
+
+            if (flash_status == FLASH_HAL_NO_ERROR)
+            {
+                m_mount_state.records_since_write = 0u;
+                b_write_ok = TRUE;
+            }
+        }
+    }
+
+    return b_write_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsmount_record_written is called whenever a record has been written into
+ * a partition, and writes a new mount record every
+ * RS_CFG_MOUNT_RECORD_INTERVAL records (if the interval isn't zero).
+ *
+ */
+// ----------------------------------------------------------------------------
+void rsmount_record_written(void)
+{
+    if ( (m_mount_state.b_area_available)
+            && (RS_CFG_MOUNT_RECORD_INTERVAL != 0u) )
+    {
+        m_mount_state.records_since_write++;
+
+        if (m_mount_state.records_since_write >= RS_CFG_MOUNT_RECORD_INTERVAL)
+        {
+            //lint -e{920} Ignoring return value, a failed write just uses up a slot.
+            (void)rsmount_record_write();
+        }
+    }
+}
+
+
+#ifdef UNIT_TEST_BUILD
+// ----------------------------------------------------------------------------
+/**
+ * rsmount_unit_test_ptrs_get returns a pointer to the unit test pointers
+ * structure, for test purposes.
+ * We use an ifdef to ensure that this pointer can't be accessed under
+ * normal operation.
+ *
+ * @retval rsmount_unit_test_ptrs_t*    Pointer to test structure.
+ *
+ */
+// ----------------------------------------------------------------------------
+rsmount_unit_test_ptrs_t* rsmount_unit_test_ptrs_get(void)
+{
+    //lint -e{956} Doesn't need to be volatile here. Pointers never change.
+    static rsmount_unit_test_ptrs_t p_unit_test_structure =
+    {
+        &m_mount_state,
+        &m_mount_partitions[0u],
+    };
+
+    return &p_unit_test_structure;
+}
+#endif
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * record_read reads a single mount record and checks the sync bytes, the CRC
+ * and the layout signature.  If the record is OK then the generation and the
+ * partition details are copied out of it.
+ *
+ * @param   block       Block to read from (0,1,2 etc).
+ * @param   slot        Slot to read (0,1,2 etc).
+ * @retval  bool_t      TRUE if mount record read OK, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_read(const uint16_t block, const uint32_t slot)
+{
+    uint8_t             record_buffer[MOUNT_RECORD_SIZE_BYTES];
+    flash_hal_error_t   flash_read_status;
+    uint16_t            extracted_crc;
+    uint16_t            calculated_crc;
+    uint8_t             partition_index;
+    uint16_t            offset;
+    bool_t              b_record_ok = FALSE;
+
+    //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+    flash_read_status = flash_hal_device_read(slot_address_get(block, slot),
+                                              (uint32_t)MOUNT_RECORD_SIZE_BYTES,
+                                              &record_buffer[0u]);
+
+    if ( (flash_read_status == FLASH_HAL_NO_ERROR)
+            && (record_buffer[0u] == MOUNT_RECORD_SYNC_1)
+            && (record_buffer[1u] == MOUNT_RECORD_SYNC_2) )
+    {
+        //lint -e{921} Cast from uint8_t to uint16_t before shifting.
+        extracted_crc = (((uint16_t)record_buffer[MOUNT_CRC_OFFSET] << 8u) & 0xFF00u)
+                            | ((uint16_t)record_buffer[MOUNT_CRC_OFFSET + 1u] & 0x00FFu);
+
+        calculated_crc = CRC_CCITTOnByteCalculate(&record_buffer[0u],
+                                                  MOUNT_CRC_OFFSET,
+                                                  0x0000u);
+
+        /* A record for a different partition layout is no use. */
+        if ( (extracted_crc == calculated_crc)
+                && (BUFFER_UTILS_8bitBufToUint16(&record_buffer[MOUNT_LAYOUT_OFFSET])
+                        == m_mount_state.layout_signature) )
+        {
+            m_mount_state.generation
+                = BUFFER_UTILS_8bitBufToUint32(&record_buffer[MOUNT_GENERATION_OFFSET]);
+
+            for (partition_index = 0u;
+                    partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS;
+                    partition_index++)
+            {
+                offset = MOUNT_PARTITION_OFFSET
+                            + (partition_index * MOUNT_PARTITION_SIZE);
+
+                m_mount_partitions[partition_index].next_available_address
+                    = BUFFER_UTILS_8bitBufToUint32(&record_buffer[offset]);
+
+                m_mount_partitions[partition_index].free_pages
+                    = BUFFER_UTILS_8bitBufToUint32(&record_buffer[offset + MOUNT_PARTITION_FREE]);
+
+                m_mount_partitions[partition_index].full_pages
+                    = BUFFER_UTILS_8bitBufToUint32(&record_buffer[offset + MOUNT_PARTITION_FULL]);
+
+                //lint -e{930} Cast from uint8_t to enum, checked when used.
+                m_mount_partitions[partition_index].partition_error_status
+                    = (rs_error_t)record_buffer[offset + MOUNT_PARTITION_STATUS];
+            }
+
+            b_record_ok = TRUE;
+        }
+    }
+
+    return b_record_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * count_slots_used uses a bisection search to find the first blank slot in
+ * a block, which is the number of slots used.
+ *
+ * @note
+ * This works because the mount records are only ever appended, so all the
+ * used slots are at the start of the block and the blank ones at the end.
+ *
+ * @param   block       Block to check (0,1,2 etc).
+ * @retval  uint32_t    Number of slots used.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t count_slots_used(const uint16_t block)
+{
+    uint32_t    lower_slot = 0u;
+    uint32_t    upper_slot = m_mount_state.slots_per_block;
+    uint32_t    slot_to_check;
+    bool_t      b_slot_is_blank;
+
+    while (lower_slot < upper_slot)
+    {
+        slot_to_check = (lower_slot + upper_slot) / 2u;
+
+        //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+        b_slot_is_blank = flash_hal_device_blank_check(slot_address_get(block, slot_to_check),
+                                                       (uint32_t)MOUNT_RECORD_SIZE_BYTES);
+
+        if (b_slot_is_blank)
+        {
+            upper_slot = slot_to_check;
+        }
+        else
+        {
+            lower_slot = slot_to_check + 1u;
+        }
+    }
+
+    return lower_slot;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * layout_signature_calculate works out a CRC over the addresses of every
+ * partition, so that a mount record written for a different partition layout
+ * (i.e. different firmware settings) is never used.
+ *
+ * @retval  uint16_t    Layout signature.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t layout_signature_calculate(void)
+{
+    uint8_t                     address_buffer[12u];
+    const rs_partition_info_t*  p_partition;
+    uint8_t                     partition_index;
+    uint16_t                    running_crc = 0x0000u;
+
+    for (partition_index = 0u;
+            partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS;
+            partition_index++)
+    {
+        p_partition = rspartition_partition_ptr_get(partition_index);
+
+        //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+        (void)BUFFER_UTILS_Uint32To8bitBuf(&address_buffer[0u],
+                                           p_partition->start_address);
+
+        //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+        (void)BUFFER_UTILS_Uint32To8bitBuf(&address_buffer[4u],
+                                           p_partition->end_address);
+
+        //lint -e{920} Ignoring return values, not used as we use fixed offsets.
+        (void)BUFFER_UTILS_Uint32To8bitBuf(&address_buffer[8u],
+                                           p_partition->index_end_address);
+
+        running_crc = CRC_CCITTOnByteCalculate(&address_buffer[0u],
+                                               12u,
+                                               running_crc);
+    }
+
+    return running_crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * location_is_used reads a couple of bytes and checks whether they have
+ * been written.
+ *
+ * @param   logical_address     Address of first byte to check (even).
+ * @retval  bool_t              TRUE if written, FALSE if blank or read error.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t location_is_used(const uint32_t logical_address)
+{
+    uint8_t             check_buffer[MOUNT_USED_CHECK_BYTES];
+    flash_hal_error_t   flash_read_status;
+    bool_t              b_location_used = FALSE;
+
+    //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+    flash_read_status = flash_hal_device_read(logical_address,
+                                              (uint32_t)MOUNT_USED_CHECK_BYTES,
+                                              &check_buffer[0u]);
+
+    if ( (flash_read_status == FLASH_HAL_NO_ERROR)
+            && ( (check_buffer[0u] != RS_CFG_BLANK_LOCATION_CONTAINS)
+                    || (check_buffer[1u] != RS_CFG_BLANK_LOCATION_CONTAINS) ) )
+    {
+        b_location_used = TRUE;
+    }
+
+    return b_location_used;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * slot_address_get returns the logical address of a mount record slot.
+ *
+ * @param   block       Block (0,1,2 etc).
+ * @param   slot        Slot within the block (0,1,2 etc).
+ * @retval  uint32_t    Logical address of the slot.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t slot_address_get(const uint16_t block, const uint32_t slot)
+{
+    //lint -e{921} Cast to uint32_t to force arithmetic as 32 bit.
+    return m_mount_state.area_start_address
+            + ((uint32_t)block * m_mount_state.block_size_bytes)
+            + (slot * MOUNT_RECORD_SIZE_BYTES);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -30,6 +30,8 @@
 #include "flash_hal.h"
 #include "crc.h"
 #include "rspartition.h"
+#include "rsindex.h"
+#include "rsmount.h"
 
 
 // ----------------------------------------------------------------------------
@@ -47,6 +49,8 @@
 #define PAGE_HEADER_STATUS_MSB      3u          ///< Offset in page header for MSB of status.
 #define PAGE_HEADER_STATUS_LSB      4u          ///< Offset in page header for LSB of status.
 #define PAGE_HEADER_ERROR_OFFSET    5u          ///< Offset in page header for error.
+#define PAGE_HEADER_SEQUENCE_OFFSET 8u          ///< Offset in page header for sequence (MSB first).
+#define PAGE_HEADER_INVERSE_OFFSET  12u         ///< Offset in page header for inverse of sequence.
 
 
 // ----------------------------------------------------------------------------
@@ -84,18 +88,49 @@ static rs_page_status_t compare_header_with_addresses
 static rs_page_status_t check_next_page_is_blank
                             (const rs_header_data_t * const p_header_data);
 
+static rs_header_status_t page_header_read
+                            (const uint32_t partition_logical_start_address,
+                             const uint32_t partition_logical_end_address,
+                             const uint32_t page_number_to_check,
+                             const uint8_t  partition_id,
+                             uint8_t * const p_buffer);
+
 static rs_header_status_t check_contents_of_page_header
                             (const uint8_t * const p_buffer,
                              const uint8_t partition_id);
 
+static uint32_t convert_msb_first_8bits_into_32bits
+                            (const uint8_t * const p_buffer);
+
 static rs_header_status_t write_page_and_page_is_full
                                 (const rs_page_write_t * const p_write,
                                  const uint32_t current_page_number);
 
+static uint32_t next_page_data_address_get
+                                (const rs_page_write_t * const p_write,
+                                 const rs_page_details_t * const p_page_details);
+
+static bool_t ring_wrap_required(const rs_page_write_t * const p_write_data);
+
+static void rsr_wrapper_build(uint8_t * const p_rsr,
+                              const uint16_t record_id,
+                              const uint16_t rsr_length);
+
+static void batch_write_stage(rspages_batch_t * const p_batch,
+                              const uint16_t write_index);
+
+static void batch_write_flush(rspages_batch_t * const p_batch);
+
+static void batch_write_single(rspages_batch_t * const p_batch,
+                               const uint16_t write_index);
+
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module:
 
+/// Staging buffer where batched RSRs are assembled before being written.
+static uint8_t  m_batch_staging_buffer[RS_CFG_BATCH_STAGING_SIZE_BYTES];
+
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -125,40 +160,72 @@ rs_header_status_t rspages_page_header_check
                          const uint32_t page_number_to_check,
                          const uint8_t  partition_id)
 {
+    uint8_t             page_buffer[PAGE_HEADER_LENGTH_BYTES];
+
+    return page_header_read(partition_logical_start_address,
+                            partition_logical_end_address,
+                            page_number_to_check,
+                            partition_id,
+                            &page_buffer[0u]);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rspages_page_sequence_get loads a page header for a ring log partition and
+ * returns the page sequence number from it.
+ *
+ * The sequence number is only returned if the header is OK, the sequence is
+ * followed by its inverse (so a header which has been partly erased doesn't
+ * give a bogus sequence) and it belongs to this page - the page number is
+ * the sequence number modulo the number of pages in the partition.
+ *
+ * @param   partition_logical_start_address     The partition start address.
+ * @param   partition_logical_end_address       The partition end address.
+ * @param   page_number_to_check                The page number to check.
+ * @param   partition_id                        The ID for the partition.
+ * @param   p_sequence          Pointer to return the sequence number, or
+ *                              PAGE_HEADER_NO_SEQUENCE if there isn't one.
+ * @retval  rs_header_status_t  Enumerated value for any error found.
+ *
+ */
+// ----------------------------------------------------------------------------
+rs_header_status_t rspages_page_sequence_get
+                        (const uint32_t partition_logical_start_address,
+                         const uint32_t partition_logical_end_address,
+                         const uint32_t page_number_to_check,
+                         const uint8_t  partition_id,
+                         uint32_t * const p_sequence)
+{
+    const uint32_t      page_size_in_bytes = RS_CFG_PAGE_SIZE_KB * 1024u;
     rs_header_status_t  return_value;
-    uint32_t            read_address;
-    uint32_t            last_potential_read_address;
-    flash_hal_error_t   flash_read_status;
     uint8_t             page_buffer[PAGE_HEADER_LENGTH_BYTES];
+    uint32_t            number_of_pages;
+    uint32_t            sequence;
+    uint32_t            inverse;
 
-    read_address = partition_logical_start_address
-                    + (RS_CFG_PAGE_SIZE_KB
-                                * 1024u
-                                * page_number_to_check);
+    *p_sequence = PAGE_HEADER_NO_SEQUENCE;
 
-    last_potential_read_address
-        = read_address + (PAGE_HEADER_LENGTH_BYTES - 1u);
+    return_value = page_header_read(partition_logical_start_address,
+                                    partition_logical_end_address,
+                                    page_number_to_check,
+                                    partition_id,
+                                    &page_buffer[0u]);
 
-    if (last_potential_read_address
-            > partition_logical_end_address)
-    {
-        return_value = RS_HDR_INVALID_PAGE_NUMBER;
-    }
-    else
+    if ( (return_value == RS_HDR_PAGE_IS_CLOSED)
+            || (return_value == RS_HDR_PAGE_IS_OPEN)
+            || (return_value == RS_HDR_PAGE_IS_EMPTY) )
     {
-        //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
-        flash_read_status = flash_hal_device_read(read_address,
-                                                  (uint32_t)PAGE_HEADER_LENGTH_BYTES,
-                                                  &page_buffer[0u]);
+        sequence = convert_msb_first_8bits_into_32bits(&page_buffer[PAGE_HEADER_SEQUENCE_OFFSET]);
+        inverse  = convert_msb_first_8bits_into_32bits(&page_buffer[PAGE_HEADER_INVERSE_OFFSET]);
 
-        if (flash_read_status != FLASH_HAL_NO_ERROR)
-        {
-            return_value = RS_HDR_FLASH_READ_ERROR;
-        }
-        else
+        number_of_pages = ((partition_logical_end_address - partition_logical_start_address)
+                                / page_size_in_bytes) + 1u;
+
+        if ( (sequence == ~inverse)
+                && ((sequence % number_of_pages) == page_number_to_check) )
         {
-            return_value = check_contents_of_page_header(&page_buffer[0u],
-                                                         partition_id);
+            *p_sequence = sequence;
         }
     }
 
@@ -231,13 +298,31 @@ rs_header_status_t rspages_page_header_write
             //lint -e{921} Cast to 8 bits, just take the LSB here.
             header_write[7u] = (uint8_t)(p_header_data->error_address & 0x00FFu);
 
-            for (header_offset = 8u;
+            /*
+             * Pages in a ring log have the sequence number (MSB first) and
+             * its inverse, everything else leaves the rest of the header blank.
+             */
+            for (header_offset = PAGE_HEADER_SEQUENCE_OFFSET;
                     header_offset < PAGE_HEADER_LENGTH_BYTES;
                     header_offset++)
             {
                 header_write[header_offset] = 0xFFu;
             }
 
+            if (p_header_data->sequence != PAGE_HEADER_NO_SEQUENCE)
+            {
+                for (header_offset = 0u; header_offset < 4u; header_offset++)
+                {
+                    //lint -e{921} Cast to 8 bits, one byte at a time.
+                    header_write[PAGE_HEADER_SEQUENCE_OFFSET + header_offset]
+                        = (uint8_t)((p_header_data->sequence >> (24u - (8u * header_offset))) & 0x00FFu);
+
+                    //lint -e{921} Cast to 8 bits, one byte at a time.
+                    header_write[PAGE_HEADER_INVERSE_OFFSET + header_offset]
+                        = (uint8_t)(~header_write[PAGE_HEADER_SEQUENCE_OFFSET + header_offset] & 0x00FFu);
+                }
+            }
+
             //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
             b_write_completed_ok = write_and_read_back(write_address,
                                                        (uint32_t)PAGE_HEADER_LENGTH_BYTES,
@@ -393,13 +478,14 @@ rs_page_write_status_t rspages_page_data_write
                             (const rs_page_write_t * const p_write_data)
 {
     rs_page_write_status_t  status = RS_PG_WRITE_ERROR;
-    uint16_t                running_crc;
-    uint32_t                crc_length;
-    uint16_t                tdr_length;
+    rs_page_write_t         write;
+    rs_page_details_t       page_details;
     uint32_t                write_address;
     bool_t                  b_rsr_will_fit;
 
-    b_rsr_will_fit = check_rsr_will_fit_in_partition(p_write_data);
+    write = *p_write_data;
+
+    b_rsr_will_fit = check_rsr_will_fit_in_partition(&write);
 
     /* Fail if RSR will not fit for any reason. */
     if (!b_rsr_will_fit)
@@ -408,39 +494,31 @@ rs_page_write_status_t rspages_page_data_write
     }
     else
     {
-        tdr_length = (p_write_data->bytes_to_write - RSAPI_BYTES_BEFORE_TDR)
-                            - RSAPI_BYTES_AFTER_TDR;
-
-        //lint -e{921} RSR_SYNC_CHARACTER includes a cast to uint8_t.
-        p_write_data->p_write_buffer[0u] = RSR_SYNC_CHARACTER;
-
-        //lint -e{921} Cast to 8 bits, just take the LSB here.
-        p_write_data->p_write_buffer[1u] = (uint8_t)(p_write_data->record_id & 0x00FFu);
-
-        //lint -e{921} Cast to 8 bits, just take the MSB here.
-        p_write_data->p_write_buffer[2u] = (uint8_t)((p_write_data->record_id >> 8u) & 0x00FFu);
-
-        //lint -e{921} Cast to 8 bits, just take the LSB here.
-        p_write_data->p_write_buffer[3u] = (uint8_t)(tdr_length & 0x00FFu);
-
-        //lint -e{921} Cast to 8 bits, just take the MSB here.
-        p_write_data->p_write_buffer[4u] = (uint8_t)((tdr_length >> 8u) & 0x00FFu);
-
-        //lint -e{921} Cast to uint32_t to force arithmetic on composite expression as 32 bit.
-        crc_length = (uint32_t)p_write_data->bytes_to_write - RSAPI_BYTES_AFTER_TDR;
+        /*
+         * An RSR never spans the end of a ring log, so if it doesn't fit in
+         * the last page then that page is closed and the RSR goes at the
+         * start of the first page instead.
+         */
+        if (ring_wrap_required(&write))
+        {
+            page_details.partition_logical_start_address = write.partition_logical_start_addr;
+            page_details.partition_logical_end_address   = write.partition_logical_end_addr;
+            page_details.address_within_partition        = write.next_free_addr;
 
-        running_crc = CRC_CCITTOnByteCalculate(p_write_data->p_write_buffer, crc_length, 0x0000u);
+            //lint -e{920} Ignore return value as we know page details are valid here.
+            (void)rspages_page_details_calculate(&page_details);
 
-        //lint -e{921} Cast to 8 bits, just take the MSB here.
-        p_write_data->p_write_buffer[crc_length] = (uint8_t)((running_crc >> 8u) & 0x00FFu);
+            //lint -e{920} Cast from enum to void
+            (void)write_page_and_page_is_full(&write, page_details.page_number);
 
-        //lint -e{921} Cast to 8 bits, just take the LSB here.
-        p_write_data->p_write_buffer[crc_length + 1u] = (uint8_t)(running_crc & 0x00FFu);
+            write.next_free_addr = next_page_data_address_get(&write, &page_details);
+        }
 
-        //lint -e{921} RSR_ENDSYNC_CHARACTER includes a cast to uint8_t.
-        p_write_data->p_write_buffer[crc_length + 2u] = RSR_ENDSYNC_CHARACTER;
+        rsr_wrapper_build(write.p_write_buffer,
+                          write.record_id,
+                          write.bytes_to_write);
 
-        status = write_page_data_handle_overlap(p_write_data, &write_address);
+        status = write_page_data_handle_overlap(&write, &write_address);
 
         /*
          * Update the next address in the partition module.
@@ -449,14 +527,171 @@ rs_page_write_status_t rspages_page_data_write
          * locations.
          */
         //lint -e{920} Ignore the return value as this will always work.
-        (void)rspartition_next_address_set(p_write_data->partition_index,
+        (void)rspartition_next_address_set(write.partition_index,
                                            write_address);
+
+        /* Keep the record index in step with what's just been written. */
+        rsindex_record_written(write.partition_index,
+                               write.next_free_addr,
+                               write.record_id,
+                               ( (status == RS_PG_WRITE_OK)
+                                   || (status == RS_PG_WRITE_OK_PAGE_FULL) ));
+
+        rsmount_record_written();
+
+        /* Get on with erasing ahead in any ring log. */
+        rspartition_ring_erase_step();
     }
 
     return status;
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * rspages_page_data_write_batch writes a number of consecutive tool data
+ * records (TDRs) into the flash memory, using as few flash writes as possible.
+ *
+ * The RSRs are assembled back to back in a staging buffer, and each run of
+ * RSRs which sits within a single page is then written with one call to the
+ * flash HAL (so the main flash gets full write buffer lines rather than one
+ * short write per record).  A staged run is written out early if:
+ *  - the staging buffer would overflow,
+ *  - the next RSR would span a page boundary (this RSR is then written on its
+ *    own by rspages_page_data_write(), which handles the page header),
+ *  - an RSR fills the page exactly.
+ *
+ * If a staged write fails, the failed locations are skipped (as with a single
+ * write) and the records in that run are written again one at a time, so that
+ * a single bad location only costs the records which actually hit it.
+ *
+ * @note
+ * The first entry in p_write_data must have next_free_addr set to the next
+ * free address in the partition, and all entries must be for the same
+ * partition.  The next_free_addr member of each entry is updated with the
+ * address the RSR was written to, and each write buffer must have the same
+ * layout as for rspages_page_data_write() (so it can be used for a retry).
+ *
+ * @param   p_write_data        Pointer to array of writes to carry out.
+ * @param   number_of_writes    Number of entries in the write array.
+ * @param   p_write_status      Pointer to array to return status of each write.
+ * @retval  uint16_t            Number of records written successfully.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t rspages_page_data_write_batch(rs_page_write_t * const p_write_data,
+                                       const uint16_t number_of_writes,
+                                       rs_page_write_status_t * const p_write_status)
+{
+    rspages_batch_t         batch;
+    rs_page_details_t       page_details;
+    const rs_partition_info_t*  p_partition;
+    rs_page_write_t*        p_write;
+    uint16_t                write_index;
+    uint16_t                records_written = 0u;
+    uint32_t                free_space_in_page;
+    bool_t                  b_space_available = TRUE;
+
+    if (number_of_writes != 0u)
+    {
+        batch.p_write_data       = p_write_data;
+        batch.p_write_status     = p_write_status;
+        batch.first_staged_index = 0u;
+        batch.staged_writes      = 0u;
+        batch.staged_bytes       = 0u;
+        batch.next_free_addr     = p_write_data[0].next_free_addr;
+        batch.b_read_back        = FALSE;
+        batch.b_page_filled      = FALSE;
+
+        p_partition = rspartition_partition_ptr_get(p_write_data[0].partition_index);
+
+        for (write_index = 0u; write_index < number_of_writes; write_index++)
+        {
+            p_write = &p_write_data[write_index];
+            p_write->next_free_addr = batch.next_free_addr;
+
+            /*
+             * Once a record has failed to fit (or the last page has been
+             * filled) nothing else will fit, so fail the rest of the batch.
+             */
+            if ( (b_space_available)
+                && (p_partition->partition_error_status != RS_ERR_PARTITION_IS_FULL) )
+            {
+                b_space_available = check_rsr_will_fit_in_partition(p_write);
+            }
+            else
+            {
+                b_space_available = FALSE;
+            }
+
+            if (!b_space_available)
+            {
+                p_write_status[write_index] = RS_PG_WRITE_INVALID_ADDRESSES;
+            }
+            else
+            {
+                page_details.partition_logical_start_address
+                                            = p_write->partition_logical_start_addr;
+                page_details.partition_logical_end_address
+                                            = p_write->partition_logical_end_addr;
+                page_details.address_within_partition
+                                            = p_write->next_free_addr;
+
+                //lint -e{920} Ignore return value as we know page details are valid here.
+                (void)rspages_page_details_calculate(&page_details);
+
+                /* Distance doesn't take into account the current address. */
+                free_space_in_page = page_details.distance_to_upper_address + 1u;
+
+                //lint -e{921} Cast to uint32_t to force arithmetic as 32 bit.
+                if ( (p_write->bytes_to_write > free_space_in_page)
+                    || ((uint32_t)p_write->bytes_to_write > RS_CFG_BATCH_STAGING_SIZE_BYTES) )
+                {
+                    /* RSR spans a page (or is too big to stage) - write it on its own. */
+                    batch_write_flush(&batch);
+                    batch_write_single(&batch, write_index);
+                }
+                else
+                {
+                    //lint -e{921} Cast to uint32_t to force arithmetic as 32 bit.
+                    if ( (batch.staged_bytes + (uint32_t)p_write->bytes_to_write)
+                            > RS_CFG_BATCH_STAGING_SIZE_BYTES )
+                    {
+                        batch_write_flush(&batch);
+                    }
+
+                    batch_write_stage(&batch, write_index);
+
+                    /* An RSR which fills the page exactly closes the page. */
+                    if (p_write->bytes_to_write == free_space_in_page)
+                    {
+                        batch.b_page_filled = TRUE;
+                        batch.next_free_addr = next_page_data_address_get(p_write, &page_details);
+                        batch_write_flush(&batch);
+                    }
+                }
+            }
+        }
+
+        batch_write_flush(&batch);
+
+        /* Get on with erasing ahead in any ring log. */
+        rspartition_ring_erase_step();
+
+        for (write_index = 0u; write_index < number_of_writes; write_index++)
+        {
+            if ( (p_write_status[write_index] == RS_PG_WRITE_OK)
+                || (p_write_status[write_index] == RS_PG_WRITE_OK_PAGE_FULL) )
+            {
+                records_written++;
+            }
+        }
+    }
+
+    return records_written;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * rspages_page_details_calculate works fills in the output members of the
@@ -706,7 +941,8 @@ static bool_t write_and_read_back(const uint32_t logical_start_address,
 // ----------------------------------------------------------------------------
 /**
  * read_back_and_compare reads a block of data back from the flash and compares
- * it with another set of data to check that the two blocks match.
+ * it with another set of data to check that the two blocks match.  The data is
+ * read from the device itself, not from a driver's write-behind cache.
  *
  * @param   logical_start_address       Logical start address in flash for write.
  * @param   number_of_bytes_to_read     Number of bytes to read back.
@@ -724,9 +960,9 @@ static bool_t read_back_and_compare(const uint32_t logical_start_address,
     uint8_t             header_read[RS_CFG_LOCAL_BLOCK_READ_SIZE];
 
     flash_read_status
-        = flash_hal_device_read(logical_start_address,
-                                number_of_bytes_to_read,
-                                &header_read[0u]);
+        = flash_hal_device_verify_read(logical_start_address,
+                                       number_of_bytes_to_read,
+                                       &header_read[0u]);
 
     if (flash_read_status == FLASH_HAL_NO_ERROR)
     {
@@ -840,8 +1076,7 @@ static rs_page_write_status_t write_page_data_handle_overlap
         {
             b_filled_page = TRUE;
 
-            next_free_address = page_details.upper_address_within_page
-                + PAGE_HEADER_LENGTH_BYTES + 1u;
+            next_free_address = next_page_data_address_get(p_write, &page_details);
 
             /*
              * The page is full so write the page header for the next page.
@@ -878,8 +1113,7 @@ static rs_page_write_status_t write_page_data_handle_overlap
          * first write worked or not - if it failed we want to skip these
          * addresses in future writes as the flash might be damaged
          */
-        next_free_address  = page_details.upper_address_within_page
-                                + PAGE_HEADER_LENGTH_BYTES + 1u;
+        next_free_address  = next_page_data_address_get(p_write, &page_details);
 
         if (b_write_ok)
         {
@@ -928,6 +1162,8 @@ static rs_page_write_status_t write_page_data_handle_overlap
  * check_rsr_will_fit_in_partition checks to make sure that the entire RSR
  * will fit in whatever space is available in the partition.
  *
+ * A partition which is being formatted has no space available.
+ *
  * @param   p_write_data    Pointer to data to write.
  * @retval  bool_t          TRUE if there is space, FALSE if any error.
  *
@@ -949,7 +1185,14 @@ static bool_t check_rsr_will_fit_in_partition
     page_details.address_within_partition
                             = p_write_data->next_free_addr;
 
-    b_page_ok = rspages_page_details_calculate(&page_details);
+    if (rspartition_format_in_progress_check(p_write_data->partition_index))
+    {
+        b_page_ok = FALSE;
+    }
+    else
+    {
+        b_page_ok = rspages_page_details_calculate(&page_details);
+    }
 
     if (b_page_ok)
     {
@@ -983,6 +1226,16 @@ static bool_t check_rsr_will_fit_in_partition
                             = next_page_address + remainder_to_write - 1u;
 
             b_page_ok = rspages_page_details_calculate(&page_details);
+
+            /* A ring log starts again at the first page if it has to. */
+            //lint -e{921} Cast to uint32_t to force arithmetic as 32 bit.
+            if ( (!b_page_ok)
+                    && (rspartition_partition_ptr_get(p_write_data->partition_index)->ring_unit_pages != 0u)
+                    && ((uint32_t)p_write_data->bytes_to_write
+                            <= ((RS_CFG_PAGE_SIZE_KB * 1024u) - PAGE_HEADER_LENGTH_BYTES)) )
+            {
+                b_page_ok = TRUE;
+            }
         }
     }
 
@@ -1179,6 +1432,67 @@ static rs_page_status_t check_next_page_is_blank
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * page_header_read loads a page header for a particular partition into a
+ * buffer and checks that it's OK.
+ *
+ * @param   partition_logical_start_address     The partition start address.
+ * @param   partition_logical_end_address       The partition end address.
+ * @param   page_number_to_check                The page number to check.
+ * @param   partition_id                        The ID for the partition.
+ * @param   p_buffer            Pointer to buffer to load the header into.
+ * @retval  rs_header_status_t  Enumerated value for any error found.
+ *
+ */
+// ----------------------------------------------------------------------------
+static rs_header_status_t page_header_read
+                            (const uint32_t partition_logical_start_address,
+                             const uint32_t partition_logical_end_address,
+                             const uint32_t page_number_to_check,
+                             const uint8_t  partition_id,
+                             uint8_t * const p_buffer)
+{
+    rs_header_status_t  return_value;
+    uint32_t            read_address;
+    uint32_t            last_potential_read_address;
+    flash_hal_error_t   flash_read_status;
+
+    read_address = partition_logical_start_address
+                    + (RS_CFG_PAGE_SIZE_KB
+                                * 1024u
+                                * page_number_to_check);
+
+    last_potential_read_address
+        = read_address + (PAGE_HEADER_LENGTH_BYTES - 1u);
+
+    if (last_potential_read_address
+            > partition_logical_end_address)
+    {
+        return_value = RS_HDR_INVALID_PAGE_NUMBER;
+    }
+    else
+    {
+        //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+        flash_read_status = flash_hal_device_read(read_address,
+                                                  (uint32_t)PAGE_HEADER_LENGTH_BYTES,
+                                                  p_buffer);
+
+        if (flash_read_status != FLASH_HAL_NO_ERROR)
+        {
+            return_value = RS_HDR_FLASH_READ_ERROR;
+        }
+        else
+        {
+            return_value = check_contents_of_page_header(p_buffer,
+                                                         partition_id);
+        }
+    }
+
+    return return_value;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * check_contents_of_page_header checks to make sure that the contents of
@@ -1259,6 +1573,33 @@ static rs_header_status_t check_contents_of_page_header
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * convert_msb_first_8bits_into_32bits converts four successive 8 bit words
+ * in a buffer (arranged MSB first) into a single 32 bit word.
+ *
+ * @param   p_buffer        Pointer to the buffer containing the 8 bit words.
+ * @retval  uint32_t        32 bit result.
+ *
+ */
+// ----------------------------------------------------------------------------
+//lint -e{661} -e{662} Access \ creation of out-of-bounds pointer.  All ok.
+static uint32_t convert_msb_first_8bits_into_32bits
+                            (const uint8_t * const p_buffer)
+{
+    uint32_t    result = 0u;
+    uint8_t     byte_offset;
+
+    for (byte_offset = 0u; byte_offset < 4u; byte_offset++)
+    {
+        //lint -e{921} Cast to uint32_t, masking off anything above 8 bits.
+        result = (result << 8u) | ((uint32_t)p_buffer[byte_offset] & 0x000000FFu);
+    }
+
+    return result;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * write_page_and_page_is_full is called when a page has been written and
@@ -1275,12 +1616,25 @@ static rs_header_status_t write_page_and_page_is_full
                                 (const rs_page_write_t * const p_write,
                                  const uint32_t current_page_number)
 {
+    const rs_partition_info_t*  p_partition;
     rs_header_data_t    header_data;
     rs_header_status_t  header_write;
+    uint32_t            next_page_number;
+
+    p_partition = rspartition_partition_ptr_get(p_write->partition_index);
 
     /* Update the running page counters as we've filled a page. */
     rspartition_flag_page_as_full(p_write->partition_index);
 
+    /* A ring log goes round from the last page to the first. */
+    next_page_number = current_page_number + 1u;
+
+    if ( (p_partition->ring_unit_pages != 0u)
+            && (next_page_number == p_partition->number_of_pages) )
+    {
+        next_page_number = 0u;
+    }
+
     /* Write the next page header now we want to use the next page. */
     header_data.partition_index = p_write->partition_index;
     header_data.partition_id    = p_write->partition_id;
@@ -1292,7 +1646,14 @@ static rs_header_status_t write_page_and_page_is_full
     header_data.status          = 0x6996u;
     header_data.error_code      = 0xFFu;
     header_data.error_address   = 0xFFFFu;
-    header_data.page_number     = current_page_number + 1u;
+    header_data.page_number     = next_page_number;
+    header_data.sequence        = PAGE_HEADER_NO_SEQUENCE;
+
+    /* Opening a page in a ring log might mean erasing ahead of it. */
+    if (p_partition->ring_unit_pages != 0u)
+    {
+        header_data.sequence = rspartition_ring_page_open(p_write->partition_index);
+    }
 
     header_write = rspages_page_header_write(&header_data);
 
@@ -1300,5 +1661,335 @@ static rs_header_status_t write_page_and_page_is_full
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * next_page_data_address_get returns the first address which data can be
+ * written to in the page after the one described by p_page_details.  In a
+ * ring log this is the first page again, after the last page.
+ *
+ * @param   p_write             Pointer to write data for page.
+ * @param   p_page_details      Pointer to details of the current page.
+ * @retval  uint32_t            First data address in the next page.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t next_page_data_address_get
+                                (const rs_page_write_t * const p_write,
+                                 const rs_page_details_t * const p_page_details)
+{
+    uint32_t    next_page_address;
+
+    next_page_address = p_page_details->upper_address_within_page
+                            + PAGE_HEADER_LENGTH_BYTES + 1u;
+
+    if ( (rspartition_partition_ptr_get(p_write->partition_index)->ring_unit_pages != 0u)
+            && ((p_page_details->page_number + 1u) == p_page_details->maximum_number_of_pages) )
+    {
+        next_page_address = p_write->partition_logical_start_addr
+                                + PAGE_HEADER_LENGTH_BYTES;
+    }
+
+    return next_page_address;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ring_wrap_required checks whether an RSR has to go round to the start of
+ * a ring log - it's being written into the last page and won't fit in what's
+ * left of it.  RSRs never span the end of a ring log, so that a search never
+ * has to join the end of one back onto the start.
+ *
+ * @param   p_write_data    Pointer to data to write.
+ * @retval  bool_t          TRUE if the RSR goes at the start of the first page.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t ring_wrap_required(const rs_page_write_t * const p_write_data)
+{
+    rs_page_details_t   page_details;
+    bool_t              b_wrap = FALSE;
+
+    if (rspartition_partition_ptr_get(p_write_data->partition_index)->ring_unit_pages != 0u)
+    {
+        page_details.partition_logical_start_address = p_write_data->partition_logical_start_addr;
+        page_details.partition_logical_end_address   = p_write_data->partition_logical_end_addr;
+        page_details.address_within_partition        = p_write_data->next_free_addr;
+
+        //lint -e{920} Ignore return value as the addresses have already been checked.
+        (void)rspages_page_details_calculate(&page_details);
+
+        //lint -e{921} Cast to uint32_t to force arithmetic as 32 bit.
+        if ( ((page_details.page_number + 1u) == page_details.maximum_number_of_pages)
+                && ((uint32_t)p_write_data->bytes_to_write > (page_details.distance_to_upper_address + 1u)) )
+        {
+            b_wrap = TRUE;
+        }
+    }
+
+    return b_wrap;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsr_wrapper_build adds the RSR wrapper (SYNC, REC ID, LEN, CRC and ENDSYNC)
+ * around a TDR which is already in place at RSAPI_BYTES_BEFORE_TDR in p_rsr.
+ *
+ * @param   p_rsr           Pointer to start of RSR.
+ * @param   record_id       Record ID.
+ * @param   rsr_length      Total length of RSR, including the wrapper.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void rsr_wrapper_build(uint8_t * const p_rsr,
+                              const uint16_t record_id,
+                              const uint16_t rsr_length)
+{
+    uint16_t    running_crc;
+    uint32_t    crc_length;
+    uint16_t    tdr_length;
+
+    tdr_length = (rsr_length - RSAPI_BYTES_BEFORE_TDR) - RSAPI_BYTES_AFTER_TDR;
+
+    //lint -e{921} RSR_SYNC_CHARACTER includes a cast to uint8_t.
+    p_rsr[0u] = RSR_SYNC_CHARACTER;
+
+    //lint -e{921} Cast to 8 bits, just take the LSB here.
+    p_rsr[1u] = (uint8_t)(record_id & 0x00FFu);
+
+    //lint -e{921} Cast to 8 bits, just take the MSB here.
+    p_rsr[2u] = (uint8_t)((record_id >> 8u) & 0x00FFu);
+
+    //lint -e{921} Cast to 8 bits, just take the LSB here.
+    p_rsr[3u] = (uint8_t)(tdr_length & 0x00FFu);
+
+    //lint -e{921} Cast to 8 bits, just take the MSB here.
+    p_rsr[4u] = (uint8_t)((tdr_length >> 8u) & 0x00FFu);
+
+    //lint -e{921} Cast to uint32_t to force arithmetic on composite expression as 32 bit.
+    crc_length = (uint32_t)rsr_length - RSAPI_BYTES_AFTER_TDR;
+
+    running_crc = CRC_CCITTOnByteCalculate(p_rsr, crc_length, 0x0000u);
+
+    //lint -e{921} Cast to 8 bits, just take the MSB here.
+    p_rsr[crc_length] = (uint8_t)((running_crc >> 8u) & 0x00FFu);
+
+    //lint -e{921} Cast to 8 bits, just take the LSB here.
+    p_rsr[crc_length + 1u] = (uint8_t)(running_crc & 0x00FFu);
+
+    //lint -e{921} RSR_ENDSYNC_CHARACTER includes a cast to uint8_t.
+    p_rsr[crc_length + 2u] = RSR_ENDSYNC_CHARACTER;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * batch_write_stage copies a TDR into the staging buffer, after any RSRs
+ * which are already there, and builds the RSR wrapper around it.
+ *
+ * @note
+ * The caller has already checked that the RSR fits in the staging buffer.
+ *
+ * @param   p_batch         Pointer to batch write state.
+ * @param   write_index     Index of write to stage.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void batch_write_stage(rspages_batch_t * const p_batch,
+                              const uint16_t write_index)
+{
+    const rs_page_write_t*  p_write = &p_batch->p_write_data[write_index];
+    uint8_t*                p_rsr;
+    uint16_t                byte_index;
+
+    if (p_batch->staged_writes == 0u)
+    {
+        p_batch->first_staged_index = write_index;
+    }
+
+    p_rsr = &m_batch_staging_buffer[p_batch->staged_bytes];
+
+    for (byte_index = RSAPI_BYTES_BEFORE_TDR;
+         byte_index < (p_write->bytes_to_write - RSAPI_BYTES_AFTER_TDR);
+         byte_index++)
+    {
+        p_rsr[byte_index] = p_write->p_write_buffer[byte_index];
+    }
+
+    rsr_wrapper_build(p_rsr, p_write->record_id, p_write->bytes_to_write);
+
+    if (p_write->b_read_back_write_command)
+    {
+        p_batch->b_read_back = TRUE;
+    }
+
+    p_batch->staged_writes++;
+    p_batch->staged_bytes   += p_write->bytes_to_write;
+    p_batch->next_free_addr += p_write->bytes_to_write;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * batch_write_flush writes whatever is in the staging buffer into the flash
+ * with a single write, and updates the partition and record index to suit.
+ *
+ * If the write fails then the locations are skipped (as the flash might be
+ * damaged) and each staged record is written again on its own, after them.
+ *
+ * @param   p_batch         Pointer to batch write state.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void batch_write_flush(rspages_batch_t * const p_batch)
+{
+    rs_page_write_t*        p_first;
+    rs_page_details_t       page_details;
+    bool_t                  b_write_ok;
+    uint16_t                write_index;
+    uint16_t                last_index;
+    rs_page_write_status_t  status_for_last;
+
+    if (p_batch->staged_writes != 0u)
+    {
+        p_first    = &p_batch->p_write_data[p_batch->first_staged_index];
+        last_index = (p_batch->first_staged_index + p_batch->staged_writes) - 1u;
+
+        b_write_ok = write_and_read_back(p_first->next_free_addr,
+                                         p_batch->staged_bytes,
+                                         m_batch_staging_buffer,
+                                         p_batch->b_read_back);
+
+        if (p_batch->b_page_filled)
+        {
+            page_details.partition_logical_start_address
+                                        = p_first->partition_logical_start_addr;
+            page_details.partition_logical_end_address
+                                        = p_first->partition_logical_end_addr;
+            page_details.address_within_partition
+                                        = p_first->next_free_addr;
+
+            //lint -e{920} Ignore return value as we know page details are valid here.
+            (void)rspages_page_details_calculate(&page_details);
+
+            /*
+             * The page is full so write the page header for the next page.
+             * Ignore the return value here - if the write of the header fails
+             * we will still carry on using the memory.
+             */
+            //lint -e{920} Cast from enum to void
+            (void)write_page_and_page_is_full(p_first, page_details.page_number);
+        }
+
+        /*
+         * Update the next address in the partition module regardless of
+         * whether the write worked, so that any bad locations are skipped.
+         */
+        //lint -e{920} Ignore the return value as this will always work.
+        (void)rspartition_next_address_set(p_first->partition_index,
+                                           p_batch->next_free_addr);
+
+        if (b_write_ok)
+        {
+            status_for_last = RS_PG_WRITE_OK;
+
+            if (p_batch->b_page_filled)
+            {
+                status_for_last = RS_PG_WRITE_OK_PAGE_FULL;
+            }
+
+            for (write_index = p_batch->first_staged_index;
+                 write_index <= last_index;
+                 write_index++)
+            {
+                p_batch->p_write_status[write_index] = RS_PG_WRITE_OK;
+
+                rsindex_record_written(p_first->partition_index,
+                                       p_batch->p_write_data[write_index].next_free_addr,
+                                       p_batch->p_write_data[write_index].record_id,
+                                       TRUE);
+
+                rsmount_record_written();
+            }
+
+            p_batch->p_write_status[last_index] = status_for_last;
+
+            p_batch->staged_writes = 0u;
+            p_batch->staged_bytes  = 0u;
+            p_batch->b_read_back   = FALSE;
+            p_batch->b_page_filled = FALSE;
+        }
+        else
+        {
+            /* The index can't be trusted past a failed write. */
+            rsindex_record_written(p_first->partition_index,
+                                   p_first->next_free_addr,
+                                   p_first->record_id,
+                                   FALSE);
+
+            p_batch->staged_writes = 0u;
+            p_batch->staged_bytes  = 0u;
+            p_batch->b_read_back   = FALSE;
+            p_batch->b_page_filled = FALSE;
+
+            /* Fall back to writing the staged records one at a time. */
+            for (write_index = p_batch->first_staged_index;
+                 write_index <= last_index;
+                 write_index++)
+            {
+                if (rspartition_partition_ptr_get(p_first->partition_index)->partition_error_status
+                        == RS_ERR_PARTITION_IS_FULL)
+                {
+                    p_batch->p_write_status[write_index] = RS_PG_WRITE_INVALID_ADDRESSES;
+                }
+                else
+                {
+                    p_batch->p_write_data[write_index].next_free_addr
+                                                    = p_batch->next_free_addr;
+                    batch_write_single(p_batch, write_index);
+                }
+            }
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * batch_write_single writes one record from a batch on its own, using
+ * rspages_page_data_write(), and picks up the next free address afterwards.
+ *
+ * @param   p_batch         Pointer to batch write state.
+ * @param   write_index     Index of write to carry out.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void batch_write_single(rspages_batch_t * const p_batch,
+                               const uint16_t write_index)
+{
+    rs_page_write_t*            p_write = &p_batch->p_write_data[write_index];
+    const rs_partition_info_t*  p_partition;
+    bool_t                      b_wrap;
+
+    p_write->next_free_addr = p_batch->next_free_addr;
+
+    b_wrap = ring_wrap_required(p_write);
+
+    p_batch->p_write_status[write_index] = rspages_page_data_write(p_write);
+
+    /* The RSR went to the start of the ring log rather than the end. */
+    if (b_wrap)
+    {
+        p_write->next_free_addr = p_write->partition_logical_start_addr
+                                        + PAGE_HEADER_LENGTH_BYTES;
+    }
+
+    p_partition = rspartition_partition_ptr_get(p_write->partition_index);
+
+    p_batch->next_free_addr = p_partition->next_available_address;
+}
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
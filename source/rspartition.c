@@ -28,12 +28,20 @@
 #include "rspartition.h"
 #include "rspartition_prv.h"
 #include "rssearch.h"
+#include "rsindex.h"
+#include "rsmount.h"
 #include "flash_hal.h"
 
 
 // ----------------------------------------------------------------------------
 // Defines section - add all #defines here:
 
+#define FORMAT_PROGRESS_ERASE_START     1u      ///< Progress when the erase starts.
+#define FORMAT_PROGRESS_ERASE_END       98u     ///< Progress when the last block is erased.
+#define FORMAT_PROGRESS_HEADER_WRITE    99u     ///< Progress while writing the page header.
+#define FORMAT_PROGRESS_DONE            100u    ///< Progress when the format is complete.
+#define FORMAT_MINIMUM_STEP_BYTES       1024u   ///< Least to erase per step, for small blocks.
+#define RING_MINIMUM_UNITS              3u      ///< Units needed to use a partition as a ring log.
 
 // ----------------------------------------------------------------------------
 // Function prototypes for functions which only have scope within this module:
@@ -44,6 +52,25 @@ static void partition_counters_clear
 static void update_progress_counter(uint8_t * const p_counter,
                                     const uint8_t new_value);
 
+static rs_error_t format_block_erase(void);
+
+static rs_error_t format_header_write(void);
+
+static void header_data_build(const uint8_t partition_index,
+                              const uint32_t page_number,
+                              const uint32_t sequence,
+                              rs_header_data_t * const p_header_data);
+
+static bool_t ring_head_search(const uint8_t partition_index);
+
+static bool_t ring_page_key_get(const uint8_t partition_index,
+                                const uint32_t page_number,
+                                uint32_t * const p_key);
+
+static uint32_t ring_tail_sequence_get(const rs_partition_info_t * const p_partition);
+
+static void ring_erase_finish(const uint8_t partition_index);
+
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module:
@@ -57,6 +84,23 @@ static void update_progress_counter(uint8_t * const p_counter,
 static rs_partition_info_t  m_rs_partition_info[RS_CFG_MAX_NUMBER_OF_PARTITIONS]
                                                 = RS_CFG_PARTITION_SETTINGS;
 
+/// First logical address of the mount record area (0 if none).
+//lint -e{956} Doesn't need to be volatile here. Is only read from outside.
+static uint32_t             m_mount_area_start_address = 0u;
+
+/// Last logical address of the mount record area (0 if none).
+//lint -e{956} Doesn't need to be volatile here. Is only read from outside.
+static uint32_t             m_mount_area_end_address = 0u;
+
+/// State of the partition format (if any) in progress.
+//lint -e{956} Doesn't need to be volatile here. Is only read from outside.
+static rspartition_format_t m_format = { RSPARTITION_FORMAT_IDLE, 0u, 0u, 0u, 0u, 0u,
+                                         FALSE, 0u, RS_ERR_NO_ERROR };
+
+/// Erase-ahead state of each partition used as a ring log.
+//lint -e{956} Doesn't need to be volatile, only used by the read \ write task.
+static rspartition_ring_t   m_ring[RS_CFG_MAX_NUMBER_OF_PARTITIONS];
+
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -72,6 +116,16 @@ static rs_partition_info_t  m_rs_partition_info[RS_CFG_MAX_NUMBER_OF_PARTITIONS]
  * partitions appear in the logical address range in the same order as they
  * appear in the partition info array.
  *
+ * If a partition has any record index pages, the index area is placed
+ * immediately after the data pages (and any padding), and is rounded up to
+ * a whole number of blocks so that it can be erased along with the partition.
+ *
+ * A partition which is to be used as a ring log is erased a unit at a time -
+ * a block, or a page if pages are bigger than blocks - so it has to be made up
+ * of whole units, and needs at least RING_MINIMUM_UNITS of them (one being
+ * written, one erased ahead of it and one holding the oldest data).  If not,
+ * it is used as a normal partition.
+ *
  * This function uses the flash_hal_block_size_bytes_get() function, BEFORE
  * the flash HAL is initialised.  This is the only function in the flash HAL
  * which can be called before initialising - we have to do this to set up all
@@ -94,6 +148,7 @@ void rspartition_addresses_calculate(void)
     uint32_t            bytes_in_partition;
     uint32_t            pages_per_block;
     uint32_t            padding_bytes = 0u;
+    uint32_t            index_bytes;
 
     for (partition = 0u; partition < RS_CFG_MAX_NUMBER_OF_PARTITIONS;
             partition++)
@@ -164,6 +219,39 @@ void rspartition_addresses_calculate(void)
         /* Update number of pages in case it's been modified. */
         m_rs_partition_info[partition].number_of_pages = number_of_pages;
 
+        /* Work out how many pages each erase of a ring log clears. */
+        m_rs_partition_info[partition].ring_unit_pages = 0u;
+
+        if ( (m_rs_partition_info[partition].b_circular)
+                && (block_size_in_bytes != 0u) )
+        {
+            if ( (block_size_in_bytes > page_size_in_bytes)
+                    && ((block_size_in_bytes % page_size_in_bytes) == 0u) )
+            {
+                pages_per_block = block_size_in_bytes / page_size_in_bytes;
+            }
+            else if ( (page_size_in_bytes % block_size_in_bytes) == 0u)
+            {
+                pages_per_block = 1u;
+            }
+            else
+            {
+                pages_per_block = 0u;
+            }
+
+            if ( (pages_per_block != 0u)
+                    && ((number_of_pages / pages_per_block) >= RING_MINIMUM_UNITS) )
+            {
+                m_rs_partition_info[partition].ring_unit_pages = pages_per_block;
+
+                /*
+                 * The oldest records in a ring log get erased from under the
+                 * record index, so don't waste any pages on one.
+                 */
+                m_rs_partition_info[partition].index_pages = 0u;
+            }
+        }
+
         /* Next partition starts where the last one finished. */
         m_rs_partition_info[partition].start_address
             = previous_partition_end_address;
@@ -175,7 +263,79 @@ void rspartition_addresses_calculate(void)
         /* Setup end address for next time round. */
         previous_partition_end_address
             = m_rs_partition_info[partition].end_address + 1u;
+
+        /* Reserve the record index area (if any) after the data pages. */
+        m_rs_partition_info[partition].index_start_address = 0u;
+        m_rs_partition_info[partition].index_end_address   = 0u;
+
+        index_bytes = m_rs_partition_info[partition].index_pages
+                        * page_size_in_bytes;
+
+        if (index_bytes != 0u)
+        {
+            if ( (index_bytes % block_size_in_bytes) != 0u)
+            {
+                index_bytes += block_size_in_bytes
+                                    - (index_bytes % block_size_in_bytes);
+            }
+
+            m_rs_partition_info[partition].index_start_address
+                = previous_partition_end_address;
+
+            m_rs_partition_info[partition].index_end_address
+                = m_rs_partition_info[partition].index_start_address
+                    + index_bytes - 1u;
+
+            previous_partition_end_address
+                = m_rs_partition_info[partition].index_end_address + 1u;
+        }
+    }
+
+    /*
+     * Reserve the mount record area (if any) after the last partition,
+     * in the same device, using the block size of that device.
+     */
+    m_mount_area_start_address = 0u;
+    m_mount_area_end_address   = 0u;
+
+    if (RS_CFG_MOUNT_RECORD_BLOCKS != 0u)
+    {
+        block_size_in_bytes = flash_hal_block_size_bytes_get
+            (m_rs_partition_info[RS_CFG_MAX_NUMBER_OF_PARTITIONS - 1u].device_to_use);
+
+        m_mount_area_start_address = previous_partition_end_address;
+
+        m_mount_area_end_address = m_mount_area_start_address
+                                    + (RS_CFG_MOUNT_RECORD_BLOCKS * block_size_in_bytes)
+                                    - 1u;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_mount_area_get returns the logical addresses of the mount record
+ * area, which follows the last partition (see rsmount.c).
+ *
+ * @param   p_start_address     Pointer to return first logical address.
+ * @param   p_end_address       Pointer to return last logical address.
+ * @retval  bool_t              TRUE if there is a mount record area, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rspartition_mount_area_get(uint32_t * const p_start_address,
+                                  uint32_t * const p_end_address)
+{
+    bool_t  b_area_available = FALSE;
+
+    if (m_mount_area_end_address != 0u)
+    {
+        *p_start_address = m_mount_area_start_address;
+        *p_end_address   = m_mount_area_end_address;
+        b_area_available = TRUE;
     }
+
+    return b_area_available;
 }
 
 
@@ -196,6 +356,9 @@ void rspartition_addresses_calculate(void)
  *      RS_ERR_PARTITION_IS_FULL            (returns TRUE)
  *      RS_ERR_PARTITION_NEEDS_FORMAT       (returns FALSE)
  *
+ * A ring log is searched using the page sequence numbers instead, as the
+ * page being written can be anywhere in the partition (see ring_head_search).
+ *
  * @warning
  * This code does NOT check for an invalid partition_index, so ensure that
  * the calling function does so.
@@ -206,15 +369,50 @@ void rspartition_addresses_calculate(void)
  */
 // ----------------------------------------------------------------------------
 bool_t rspartition_bisection_search_do(const uint8_t partition_index)
+{
+    bool_t  b_partition_ready_to_use;
+
+    if (m_rs_partition_info[partition_index].ring_unit_pages != 0u)
+    {
+        b_partition_ready_to_use = ring_head_search(partition_index);
+    }
+    else
+    {
+        b_partition_ready_to_use = rspartition_bisection_search_from(partition_index, 0u);
+    }
+
+    return b_partition_ready_to_use;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_bisection_search_from is the same as
+ * rspartition_bisection_search_do(), but only searches the pages from
+ * first_page onwards.  This is used when it's already known that all of the
+ * pages before first_page are full (i.e. from the mount record).
+ *
+ * @warning
+ * first_page must contain data, otherwise the partition is treated as
+ * needing a format, exactly as if page 0 was blank.
+ *
+ * @param   partition_index     Partition number to check (0,1,2 etc).
+ * @param   first_page          First page to include in the search.
+ * @retval  bool_t              TRUE if search was OK, partition is ready.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rspartition_bisection_search_from(const uint8_t partition_index,
+                                         const uint32_t first_page)
 {
     const uint32_t          page_length_in_bytes = (RS_CFG_PAGE_SIZE_KB * 1024u);
     rs_partition_info_t*    p_partition;
-    uint32_t                lower_page_to_check = 0u;
+    uint32_t                lower_page_to_check = first_page;
     uint32_t                upper_page_to_check;
     uint32_t                page_to_check;
     uint32_t                previous_page_to_check = 0xFFFFFFFFu;
     bool_t                  b_done = FALSE;
-    uint32_t                page_start_address;
+    uint32_t                page_start_address = 0u;
     uint32_t                next_page_start_address;
     bool_t                  b_page_is_blank;
     rs_error_t              rs_error = RS_ERR_NO_ERROR;
@@ -261,7 +459,7 @@ bool_t rspartition_bisection_search_do(const uint8_t partition_index)
                 upper_page_to_check = page_to_check - 1u;
 
                 /* Special case where the memory is unformatted, so all blank. */
-                if (page_to_check == 0u)
+                if (page_to_check == first_page)
                 {
                     rs_error = RS_ERR_PARTITION_NEEDS_FORMAT;
                     p_partition->blank_headers_and_pages = p_partition->number_of_pages;
@@ -293,7 +491,6 @@ bool_t rspartition_bisection_search_do(const uint8_t partition_index)
          * This function returns the address of the first location
          * in the next page if the page is full.
          */
-        //lint -e{644} Page start address will have been initialised before use.
         next_free_address
             = rssearch_find_next_free_address((page_start_address + PAGE_HEADER_LENGTH_BYTES),
                                               (page_length_in_bytes - PAGE_HEADER_LENGTH_BYTES) );
@@ -340,20 +537,61 @@ bool_t rspartition_bisection_search_do(const uint8_t partition_index)
  * rspartition_format_partition formats a partition.  This erases all the data
  * in the partition and then writes the page headers.
  *
+ * This starts the format and then carries out every step of it before
+ * returning - see rspartition_format_start() and rspartition_format_step().
+ * The progress counter is updated after every step.
+ *
+ * @note
+ * This function doesn't check for the recording system having been initialised,
+ * but as this function should only be called from the recording system API
+ * (which does check, then this is OK.
+ *
+ * @param   partition_index     Partition index relating to partition to format.
+ * @param   p_progress_counter  Pointer to progress counter (0-100)
+ * @retval  rs_error_t          Enumerated value for error code.
+ *
+ */
+// ----------------------------------------------------------------------------
+rs_error_t rspartition_format_partition(const uint8_t partition_index,
+                                        uint8_t * const p_progress_counter)
+{
+    rs_error_t  format_status;
+
+    format_status = rspartition_format_start(partition_index);
+    update_progress_counter(p_progress_counter, m_format.progress);
+
+    while (format_status == RS_ERR_FORMAT_IN_PROGRESS)
+    {
+        format_status = rspartition_format_step();
+        update_progress_counter(p_progress_counter, m_format.progress);
+    }
+
+    return format_status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_format_start starts to format a partition.  The format is then
+ * carried out by calling rspartition_format_step() until it stops returning
+ * RS_ERR_FORMAT_IN_PROGRESS, so the caller can get on with other things in
+ * between (each step erases a single block).
+ *
  * The progress counter is updated during the formatting, as follows:
  *
  *      0 - initial value
  *      1 - starting to erase the device
- *     29 - finished the erase
- *     30 - starting to blank check the device
- *     49 - finished the blank check
- *     50 - starting to write page headers
+ *  1..98 - in proportion to the blocks erased and blank checked
+ *     99 - starting to write the page header
  *    100 - done
  *
+ * Starting a format abandons any format which is already in progress.
+ *
  * @note
- * This function doesn't check for the recording system having been initialised,
- * but as this function should only be called from the recording system API
- * (which does check, then this is OK.
+ * While the format is in progress the partition is flagged as needing a
+ * format, so that it isn't read or written, and a mount record is written so
+ * that the partition isn't mounted from an older record if the format doesn't
+ * finish.  The other partitions can be used as normal between the steps.
  *
  * @note
  * In contravention of the recording system specification, we only write the
@@ -364,24 +602,30 @@ bool_t rspartition_bisection_search_do(const uint8_t partition_index)
  * because we do not re-write any of the memory (to avoid issues with data
  * retention at temperature).
  *
+ * @note
+ * If the partition has a record index area then this is erased along with
+ * the data pages, and the index is reset to match the empty partition.
+ *
+ * @note
+ * Once formatted, the partition information is updated to suit the empty
+ * partition and a new mount record is written.
+ *
  * @param   partition_index     Partition index relating to partition to format.
- * @param   p_progress_counter  Pointer to progress counter (0-100)
- * @retval  rs_error_t          Enumerated value for error code.
+ * @retval  rs_error_t          RS_ERR_FORMAT_IN_PROGRESS if the format has
+ *                              started, otherwise the error code.
  *
  */
 // ----------------------------------------------------------------------------
-rs_error_t rspartition_format_partition(const uint8_t partition_index,
-                                        uint8_t * const p_progress_counter)
+rs_error_t rspartition_format_start(const uint8_t partition_index)
 {
-    rs_error_t                  format_status = RS_ERR_UNIT_TEST_DEFAULT_VAL;
+    rs_error_t                  format_status = RS_ERR_FORMAT_IN_PROGRESS;
     uint32_t                    number_of_bytes;
+    uint32_t                    block_size_in_bytes;
     const rs_partition_info_t*  p_partition;
-    flash_hal_error_t           flash_error;
-    bool_t                      b_partition_is_blank;
-    rs_header_data_t            header_data;
-    rs_header_status_t          write_status;
+    uint8_t                     ring_index;
 
-    update_progress_counter(p_progress_counter, 0u);
+    m_format.stage    = RSPARTITION_FORMAT_IDLE;
+    m_format.progress = 0u;
 
     if (partition_index >= RS_CFG_MAX_NUMBER_OF_PARTITIONS)
     {
@@ -389,89 +633,169 @@ rs_error_t rspartition_format_partition(const uint8_t partition_index,
     }
     else
     {
-
         /* Use a pointer just to make the code tidier - having to use
          * m_rs_partition_info[partition_index] each time is messy!
          */
         p_partition = &m_rs_partition_info[partition_index];
 
-        number_of_bytes = RS_CFG_PAGE_SIZE_KB
-                            * 1024u
-                            * p_partition->number_of_pages;
+        /*
+         * The index area follows the data pages (and any padding),
+         * so if there is one just erase everything up to the end of it.
+         */
+        if (p_partition->index_pages != 0u)
+        {
+            number_of_bytes = (p_partition->index_end_address
+                                - p_partition->start_address) + 1u;
+        }
+        else
+        {
+            number_of_bytes = RS_CFG_PAGE_SIZE_KB
+                                * 1024u
+                                * p_partition->number_of_pages;
+        }
 
-        /* Starting the erase so set the progress counter to 1. */
-        update_progress_counter(p_progress_counter, 1u);
+        /*
+         * Erase a block per step, or enough blocks to make up
+         * FORMAT_MINIMUM_STEP_BYTES on devices with small blocks (the serial
+         * flash is erased a byte at a time).  Partitions are always whole
+         * blocks (see rspartition_addresses_calculate) but if not, erase it
+         * in one go.
+         */
+        block_size_in_bytes = flash_hal_block_size_bytes_get(p_partition->device_to_use);
 
-        flash_error = flash_hal_device_erase(p_partition->start_address,
-                                             number_of_bytes);
+        if ( (block_size_in_bytes != 0u)
+                && (block_size_in_bytes < FORMAT_MINIMUM_STEP_BYTES)
+                && ((FORMAT_MINIMUM_STEP_BYTES % block_size_in_bytes) == 0u) )
+        {
+            block_size_in_bytes = FORMAT_MINIMUM_STEP_BYTES;
+        }
 
-        /* Finished the erase so set the progress counter to 29. */
-        update_progress_counter(p_progress_counter, 29u);
+        if ( (block_size_in_bytes != 0u)
+                && ((number_of_bytes % block_size_in_bytes) == 0u) )
+        {
+            m_format.erase_size_bytes = block_size_in_bytes;
+            m_format.blocks_to_erase  = number_of_bytes / block_size_in_bytes;
+        }
+        else
+        {
+            m_format.erase_size_bytes = number_of_bytes;
+            m_format.blocks_to_erase  = 1u;
+        }
 
-        if (flash_error == FLASH_HAL_NO_ERROR)
+        /*
+         * The format uses the background erase in the flash HAL, so finish
+         * any ring log erase which is using it, and forget about any erase
+         * due in this partition as it's about to be erased anyway.
+         */
+        for (ring_index = 0u; ring_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS; ring_index++)
         {
-            /* Starting the blank check so set the progress counter to 30. */
-            update_progress_counter(p_progress_counter, 30u);
+            if (m_ring[ring_index].b_erase_running)
+            {
+                ring_erase_finish(ring_index);
+            }
+        }
 
-            b_partition_is_blank = flash_hal_device_blank_check
-                                        (p_partition->start_address,
-                                         number_of_bytes);
+        m_ring[partition_index].b_erase_due = FALSE;
 
-            /* Finished the blank check so set the progress counter to 49. */
-            update_progress_counter(p_progress_counter, 49u);
+        m_format.stage              = RSPARTITION_FORMAT_ERASING;
+        m_format.partition_index    = partition_index;
+        m_format.next_erase_address = p_partition->start_address;
+        m_format.blocks_erased      = 0u;
+        m_format.b_erase_running    = FALSE;
 
-            if (b_partition_is_blank)
-            {
-                header_data.partition_index = partition_index;
-                header_data.partition_id    = p_partition->id;
-                header_data.partition_logical_start_addr
-                                            = p_partition->start_address;
-                header_data.partition_logical_end_addr
-                                            = p_partition->end_address;
-                header_data.format_code     = 0x8Du;
+        /* Keep everything out of the partition until the format is done. */
+        //lint -e{920} Ignoring return value, index is already checked.
+        (void)rspartition_mount_state_set(partition_index,
+                                          p_partition->start_address
+                                            + PAGE_HEADER_LENGTH_BYTES,
+                                          0u,
+                                          0u,
+                                          RS_ERR_PARTITION_NEEDS_FORMAT);
 
-                /*
-                 * Set status to closed to avoid re-writing header
-                 * once the page has been used.
-                 */
-                header_data.status          = 0x6996u;
+        //lint -e{920} Ignoring return value, next startup will search instead.
+        (void)rsmount_record_write();
+
+        /* Starting the erase so set the progress counter to 1. */
+        m_format.progress = FORMAT_PROGRESS_ERASE_START;
+    }
 
-                header_data.error_code      = 0xFFu;
-                header_data.error_address   = 0xFFFFu;
-                header_data.page_number     = 0u;
+    m_format.format_status = format_status;
 
-                /* Starting the header write so set the progress counter to 50. */
-                update_progress_counter(p_progress_counter, 50u);
+    return format_status;
+}
 
-                write_status = rspages_page_header_write(&header_data);
 
-                if (write_status == RS_HDR_HEADER_WRITE_OK)
-                {
-                    format_status = RS_ERR_NO_ERROR;
-                }
-                else
-                {
-                    format_status = RS_ERR_HEADER_WRITE_FAILURE;
-                }
-            }
-            else
-            {
-                format_status = RS_ERR_PARTITION_ERASE_FAILURE;
-            }
-        }
-        else
-        {
-            format_status = RS_ERR_PARTITION_ERASE_FAILURE;
-        }
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_format_step carries out the next step of the format started by
+ * rspartition_format_start() - either erasing and blank checking the next
+ * block, or (once they've all been erased) writing the page header.
+ *
+ * Once the format has finished this just returns the result again.
+ *
+ * @retval  rs_error_t      RS_ERR_FORMAT_IN_PROGRESS if there are more steps
+ *                          to do, otherwise the result of the format.
+ *
+ */
+// ----------------------------------------------------------------------------
+rs_error_t rspartition_format_step(void)
+{
+    //lint -e{788} Not all enum types used in switch, but we have a default case.
+    switch (m_format.stage)
+    {
+        case RSPARTITION_FORMAT_ERASING:
+            m_format.format_status = format_block_erase();
+        break;
+
+        case RSPARTITION_FORMAT_HEADER_WRITE:
+            m_format.format_status = format_header_write();
+        break;
+
+        default:
+            /* Nothing in progress, the last result stands. */
+        break;
     }
 
-    if (format_status == RS_ERR_NO_ERROR)
+    return m_format.format_status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_format_progress_get returns the progress counter for the current
+ * (or last) format - see rspartition_format_start() for the values.
+ *
+ * @retval  uint8_t     Partition format progress, between 0 and 100%.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint8_t rspartition_format_progress_get(void)
+{
+    return m_format.progress;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_format_in_progress_check checks whether a partition is part way
+ * through being formatted.
+ *
+ * @param   partition_index     Partition index of partition.
+ * @retval  bool_t              TRUE if the partition is being formatted.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rspartition_format_in_progress_check(const uint8_t partition_index)
+{
+    bool_t  b_in_progress = FALSE;
+
+    if ( (m_format.stage != RSPARTITION_FORMAT_IDLE)
+            && (m_format.partition_index == partition_index) )
     {
-        /* Finished successfully so set the progress counter to 100. */
-        update_progress_counter(p_progress_counter, 100u);
+        b_in_progress = TRUE;
     }
 
-    return format_status;
+    return b_in_progress;
 }
 
 
@@ -570,6 +894,54 @@ bool_t rspartition_next_address_set(const uint8_t partition_index,
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_mount_state_set sets up the next available address, the page
+ * counters and the status of a partition from the mount record, instead of
+ * using the bisection search.
+ *
+ * @param   partition_index         Partition index of partition.
+ * @param   next_free_address       Next free address in the partition.
+ * @param   free_pages              Number of free pages.
+ * @param   full_pages              Number of full pages.
+ * @param   partition_error_status  Partition status.
+ * @retval  bool_t                  TRUE if partition updated, FALSE if bad index.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rspartition_mount_state_set(const uint8_t partition_index,
+                                   const uint32_t next_free_address,
+                                   const uint32_t free_pages,
+                                   const uint32_t full_pages,
+                                   const rs_error_t partition_error_status)
+{
+    bool_t                  b_partition_updated = FALSE;
+    rs_partition_info_t*    p_partition;
+
+    if (partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+    {
+        p_partition = &m_rs_partition_info[partition_index];
+
+        partition_counters_clear(p_partition);
+
+        p_partition->next_available_address = next_free_address;
+        p_partition->free_pages             = free_pages;
+        p_partition->full_pages             = full_pages;
+        p_partition->partition_error_status = partition_error_status;
+
+        /* Same as the bisection search does for an unformatted partition. */
+        if (partition_error_status == RS_ERR_PARTITION_NEEDS_FORMAT)
+        {
+            p_partition->blank_headers_and_pages = p_partition->number_of_pages;
+        }
+
+        b_partition_updated = TRUE;
+    }
+
+    return b_partition_updated;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * rspartition_partition_ptr_get returns a const pointer to the required index
@@ -594,33 +966,208 @@ const rs_partition_info_t* rspartition_partition_ptr_get
 }
 
 
-#ifdef UNIT_TEST_BUILD
 // ----------------------------------------------------------------------------
 /**
- * rspartition_unit_test_ptrs_get returns a pointer to the unit test pointers
- * structure, for test purposes.
- * We use an ifdef to ensure that this pointer can't be accessed under
- * normal operation.
+ * rspartition_ring_page_open moves a ring log on to the next page, and
+ * returns the sequence number to write into its page header.
  *
- * @retval rspartition_unit_test_ptrs_t*    Pointer to test structure.
+ * When the next page is the first page of a unit, the unit must have been
+ * erased, so any erase which is still due is finished here.  Once the ring
+ * has gone all the way round, the unit after this one then becomes due for
+ * erasing - the oldest data in the partition is discarded, so the pages are
+ * counted as free again and the record index can no longer be used.
+ *
+ * @param   partition_index     Partition index of the ring log.
+ * @retval  uint32_t            Sequence number of the page, or
+ *                              PAGE_HEADER_NO_SEQUENCE if not a ring log.
  *
  */
 // ----------------------------------------------------------------------------
-rspartition_unit_test_ptrs_t* rspartition_unit_test_ptrs_get(void)
+uint32_t rspartition_ring_page_open(const uint8_t partition_index)
 {
-    //lint -e{956} Doesn't need to be volatile here. Pointers never change.
-    static rspartition_unit_test_ptrs_t p_unit_test_structure =
+    const uint32_t          page_length_in_bytes = (RS_CFG_PAGE_SIZE_KB * 1024u);
+    rs_partition_info_t*    p_partition;
+    rspartition_ring_t*     p_ring;
+    uint32_t                sequence = PAGE_HEADER_NO_SEQUENCE;
+    uint32_t                number_of_units;
+    uint32_t                next_unit;
+
+    if ( (partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+            && (m_rs_partition_info[partition_index].ring_unit_pages != 0u) )
     {
-        &m_rs_partition_info[0u],
-    };
+        p_partition = &m_rs_partition_info[partition_index];
+        p_ring      = &m_ring[partition_index];
 
-    return &p_unit_test_structure;
-}
-#endif
+        p_partition->page_sequence++;
+        sequence = p_partition->page_sequence;
 
+        if ( (sequence % p_partition->ring_unit_pages) == 0u)
+        {
+            ring_erase_finish(partition_index);
 
-// ----------------------------------------------------------------------------
-// ----------------------------------------------------------------------------
+            number_of_units = p_partition->number_of_pages / p_partition->ring_unit_pages;
+            next_unit       = (sequence / p_partition->ring_unit_pages) + 1u;
+
+            if (next_unit >= number_of_units)
+            {
+                p_ring->b_erase_due   = TRUE;
+                p_ring->erase_address = p_partition->start_address
+                                            + ((next_unit % number_of_units)
+                                                * p_partition->ring_unit_pages
+                                                * page_length_in_bytes);
+
+                if (p_partition->full_pages >= p_partition->ring_unit_pages)
+                {
+                    p_partition->full_pages -= p_partition->ring_unit_pages;
+                    p_partition->free_pages += p_partition->ring_unit_pages;
+                }
+            }
+        }
+    }
+
+    return sequence;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_ring_erase_step moves on the erase of the next unit of a ring
+ * log, without waiting for the flash - it either starts the erase or polls
+ * it.  This is called after each write, so the unit is usually erased well
+ * before the ring gets to it.
+ *
+ * @note
+ * A format uses the same background erase, so nothing is done while a
+ * format is in progress.
+ *
+ */
+// ----------------------------------------------------------------------------
+void rspartition_ring_erase_step(void)
+{
+    const uint32_t          page_length_in_bytes = (RS_CFG_PAGE_SIZE_KB * 1024u);
+    rspartition_ring_t*     p_ring;
+    flash_hal_error_t       flash_error = FLASH_HAL_NO_ERROR;
+    uint8_t                 partition_index;
+    bool_t                  b_erase_stepped = FALSE;
+
+    if (m_format.stage == RSPARTITION_FORMAT_IDLE)
+    {
+        /* Only one erase runs in the background, so carry on with that first. */
+        for (partition_index = 0u;
+                (partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS) && (!b_erase_stepped);
+                partition_index++)
+        {
+            p_ring = &m_ring[partition_index];
+
+            if (p_ring->b_erase_running)
+            {
+                p_ring->b_erase_running = flash_hal_erase_poll(&flash_error);
+
+                /* If the erase failed, try again when the unit is opened. */
+                if ( (!p_ring->b_erase_running) && (flash_error == FLASH_HAL_NO_ERROR) )
+                {
+                    p_ring->b_erase_due = FALSE;
+                }
+
+                b_erase_stepped = TRUE;
+            }
+        }
+
+        for (partition_index = 0u;
+                (partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS) && (!b_erase_stepped);
+                partition_index++)
+        {
+            p_ring = &m_ring[partition_index];
+
+            if (p_ring->b_erase_due)
+            {
+                flash_error = flash_hal_device_erase_start
+                                    (p_ring->erase_address,
+                                     m_rs_partition_info[partition_index].ring_unit_pages
+                                        * page_length_in_bytes);
+
+                p_ring->b_erase_running = (flash_error == FLASH_HAL_NO_ERROR);
+                b_erase_stepped = TRUE;
+            }
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_ring_oldest_address_get returns the address of the oldest data
+ * in a ring log - the first data address of the oldest unit which hasn't been
+ * discarded.
+ *
+ * @param   partition_index     Partition index of the ring log.
+ * @param   p_oldest_address    Pointer to return the address of the oldest data.
+ * @retval  bool_t              TRUE if the ring log has discarded data (so the
+ *                              oldest data isn't at the start of the partition).
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t rspartition_ring_oldest_address_get(const uint8_t partition_index,
+                                           uint32_t * const p_oldest_address)
+{
+    const uint32_t              page_length_in_bytes = (RS_CFG_PAGE_SIZE_KB * 1024u);
+    const rs_partition_info_t*  p_partition;
+    uint32_t                    tail_sequence = 0u;
+
+    if ( (partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+            && (m_rs_partition_info[partition_index].ring_unit_pages != 0u) )
+    {
+        p_partition   = &m_rs_partition_info[partition_index];
+        tail_sequence = ring_tail_sequence_get(p_partition);
+
+        *p_oldest_address = p_partition->start_address
+                                + ((tail_sequence % p_partition->number_of_pages)
+                                    * page_length_in_bytes)
+                                + PAGE_HEADER_LENGTH_BYTES;
+    }
+    else if (partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+    {
+        *p_oldest_address = m_rs_partition_info[partition_index].start_address
+                                + PAGE_HEADER_LENGTH_BYTES;
+    }
+    else
+    {
+        ;   // Extra else for MISRA compliance
+    }
+
+    return (tail_sequence != 0u);
+}
+
+
+#ifdef UNIT_TEST_BUILD
+// ----------------------------------------------------------------------------
+/**
+ * rspartition_unit_test_ptrs_get returns a pointer to the unit test pointers
+ * structure, for test purposes.
+ * We use an ifdef to ensure that this pointer can't be accessed under
+ * normal operation.
+ *
+ * @retval rspartition_unit_test_ptrs_t*    Pointer to test structure.
+ *
+ */
+// ----------------------------------------------------------------------------
+rspartition_unit_test_ptrs_t* rspartition_unit_test_ptrs_get(void)
+{
+    //lint -e{956} Doesn't need to be volatile here. Pointers never change.
+    static rspartition_unit_test_ptrs_t p_unit_test_structure =
+    {
+        &m_rs_partition_info[0u],
+        &m_format,
+        &m_ring[0u],
+    };
+
+    return &p_unit_test_structure;
+}
+#endif
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
 // FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -641,6 +1188,436 @@ static void partition_counters_clear(rs_partition_info_t * const p_partition)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * format_block_erase erases and blank checks the next block of the partition
+ * being formatted, and moves on to writing the page header after the last one.
+ *
+ * The erase runs in the background in the flash HAL, so the first step for
+ * each block starts it and the following steps poll it, and reads from the
+ * rest of the flash can carry on meanwhile.
+ *
+ * @note
+ * For the main flash the blank check doesn't need to read anything, as the
+ * flash HAL knows that the block has just been erased.
+ *
+ * @retval  rs_error_t      RS_ERR_FORMAT_IN_PROGRESS, or the erase failure.
+ *
+ */
+// ----------------------------------------------------------------------------
+static rs_error_t format_block_erase(void)
+{
+    rs_error_t          format_status = RS_ERR_FORMAT_IN_PROGRESS;
+    flash_hal_error_t   flash_error = FLASH_HAL_NO_ERROR;
+    bool_t              b_block_is_blank = FALSE;
+
+    if (!m_format.b_erase_running)
+    {
+        flash_error = flash_hal_device_erase_start(m_format.next_erase_address,
+                                                   m_format.erase_size_bytes);
+
+        m_format.b_erase_running = (flash_error == FLASH_HAL_NO_ERROR);
+    }
+
+    if (m_format.b_erase_running)
+    {
+        m_format.b_erase_running = flash_hal_erase_poll(&flash_error);
+
+        if ( (!m_format.b_erase_running) && (flash_error == FLASH_HAL_NO_ERROR) )
+        {
+            b_block_is_blank = flash_hal_device_blank_check(m_format.next_erase_address,
+                                                            m_format.erase_size_bytes);
+        }
+    }
+
+    if (m_format.b_erase_running)
+    {
+        /* Still erasing - come back next step. */
+    }
+    else if (b_block_is_blank)
+    {
+        m_format.next_erase_address += m_format.erase_size_bytes;
+        m_format.blocks_erased++;
+
+        //lint -e{921} Cast to uint8_t - result is no more than FORMAT_PROGRESS_ERASE_END.
+        m_format.progress = (uint8_t)(FORMAT_PROGRESS_ERASE_START
+                                + (((FORMAT_PROGRESS_ERASE_END - FORMAT_PROGRESS_ERASE_START)
+                                        * m_format.blocks_erased) / m_format.blocks_to_erase));
+
+        if (m_format.blocks_erased >= m_format.blocks_to_erase)
+        {
+            m_format.stage = RSPARTITION_FORMAT_HEADER_WRITE;
+        }
+    }
+    else
+    {
+        m_format.stage = RSPARTITION_FORMAT_IDLE;
+        format_status  = RS_ERR_PARTITION_ERASE_FAILURE;
+    }
+
+    return format_status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * format_header_write writes the first page header of the partition being
+ * formatted, and then updates the partition to suit the empty partition.
+ *
+ * @retval  rs_error_t      Enumerated value for error code.
+ *
+ */
+// ----------------------------------------------------------------------------
+static rs_error_t format_header_write(void)
+{
+    rs_error_t                  format_status;
+    const rs_partition_info_t*  p_partition;
+    rs_header_data_t            header_data;
+    rs_header_status_t          write_status;
+
+    p_partition = &m_rs_partition_info[m_format.partition_index];
+
+    /* A ring log starts again from the first sequence number. */
+    m_rs_partition_info[m_format.partition_index].page_sequence = 0u;
+
+    if (p_partition->ring_unit_pages != 0u)
+    {
+        header_data_build(m_format.partition_index, 0u, 0u, &header_data);
+    }
+    else
+    {
+        header_data_build(m_format.partition_index, 0u, PAGE_HEADER_NO_SEQUENCE, &header_data);
+    }
+
+    /* Starting the header write so set the progress counter to 99. */
+    m_format.progress = FORMAT_PROGRESS_HEADER_WRITE;
+
+    write_status = rspages_page_header_write(&header_data);
+
+    if (write_status == RS_HDR_HEADER_WRITE_OK)
+    {
+        rsindex_partition_reset(m_format.partition_index);
+
+        /*
+         * The partition is now empty, so update it to suit and
+         * write a new mount record, otherwise the old one could
+         * be used to mount the partition at the next startup.
+         */
+        //lint -e{920} Ignoring return value, index is already checked.
+        (void)rspartition_mount_state_set(m_format.partition_index,
+                                          p_partition->start_address
+                                            + PAGE_HEADER_LENGTH_BYTES,
+                                          p_partition->number_of_pages,
+                                          0u,
+                                          RS_ERR_NO_ERROR);
+
+        //lint -e{920} Ignoring return value, next startup will search instead.
+        (void)rsmount_record_write();
+
+        /* Finished successfully so set the progress counter to 100. */
+        m_format.progress = FORMAT_PROGRESS_DONE;
+        format_status     = RS_ERR_NO_ERROR;
+    }
+    else
+    {
+        format_status = RS_ERR_HEADER_WRITE_FAILURE;
+    }
+
+    m_format.stage = RSPARTITION_FORMAT_IDLE;
+
+    return format_status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * header_data_build fills in the page header data for a page in a partition.
+ *
+ * @param   partition_index     Partition index of partition.
+ * @param   page_number         Page number in the partition.
+ * @param   sequence            Ring log sequence number (or PAGE_HEADER_NO_SEQUENCE).
+ * @param   p_header_data       Pointer to header data structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void header_data_build(const uint8_t partition_index,
+                              const uint32_t page_number,
+                              const uint32_t sequence,
+                              rs_header_data_t * const p_header_data)
+{
+    const rs_partition_info_t*  p_partition = &m_rs_partition_info[partition_index];
+
+    p_header_data->partition_index = partition_index;
+    p_header_data->partition_id    = p_partition->id;
+    p_header_data->partition_logical_start_addr
+                                   = p_partition->start_address;
+    p_header_data->partition_logical_end_addr
+                                   = p_partition->end_address;
+    p_header_data->format_code     = 0x8Du;
+
+    /*
+     * Set status to closed to avoid re-writing header
+     * once the page has been used.
+     */
+    p_header_data->status          = 0x6996u;
+
+    p_header_data->error_code      = 0xFFu;
+    p_header_data->error_address   = 0xFFFFu;
+    p_header_data->page_number     = page_number;
+    p_header_data->sequence        = sequence;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ring_head_search finds the page being written in a ring log, and sets up
+ * the next available address and the page counters to suit.
+ *
+ * Each page header in a ring log holds a sequence number, which goes up by
+ * one for each page written, so the sequence number less the page number is
+ * the same for every page written since the ring last went round, and lower
+ * for the pages before that.  A bisection search for the last page with the
+ * same value as the first page finds the page being written, with only a
+ * handful of header reads.  If the first unit has just been erased (the
+ * power was lost between the erase and the header write) then the search
+ * starts from the second unit instead.
+ *
+ * If the page being written is full, then the header of the next page is
+ * written now, as it can't have been written before.
+ *
+ * @param   partition_index     Partition index of the ring log.
+ * @retval  bool_t              TRUE if search was OK, partition is ready.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t ring_head_search(const uint8_t partition_index)
+{
+    const uint32_t          page_length_in_bytes = (RS_CFG_PAGE_SIZE_KB * 1024u);
+    rs_partition_info_t*    p_partition;
+    rspartition_ring_t*     p_ring;
+    rs_header_data_t        header_data;
+    uint32_t                first_key;
+    uint32_t                second_key;
+    uint32_t                page_key;
+    uint32_t                head_key;
+    uint32_t                lower_page_to_check = 0u;
+    uint32_t                upper_page_to_check;
+    uint32_t                page_to_check;
+    uint32_t                page_start_address;
+    uint32_t                next_free_address;
+    uint32_t                number_of_units;
+    uint32_t                next_unit;
+    bool_t                  b_first_key_ok;
+    bool_t                  b_second_key_ok;
+    bool_t                  b_partition_ready_to_use = TRUE;
+
+    p_partition = &m_rs_partition_info[partition_index];
+    p_ring      = &m_ring[partition_index];
+
+    partition_counters_clear(p_partition);
+    p_partition->next_available_address = 0xFFFFFFFFu;
+    p_partition->page_sequence          = 0u;
+    p_ring->b_erase_due                 = FALSE;
+
+    b_first_key_ok  = ring_page_key_get(partition_index, 0u, &first_key);
+    b_second_key_ok = ring_page_key_get(partition_index, p_partition->ring_unit_pages, &second_key);
+
+    if ( (!b_first_key_ok) && (!b_second_key_ok) )
+    {
+        p_partition->partition_error_status  = RS_ERR_PARTITION_NEEDS_FORMAT;
+        p_partition->blank_headers_and_pages = p_partition->number_of_pages;
+        b_partition_ready_to_use = FALSE;
+    }
+    else
+    {
+        head_key = first_key;
+
+        if ( (!b_first_key_ok)
+                || ((b_second_key_ok) && (second_key > first_key)) )
+        {
+            head_key            = second_key;
+            lower_page_to_check = p_partition->ring_unit_pages;
+        }
+
+        upper_page_to_check = p_partition->number_of_pages - 1u;
+
+        /* Find the last page written since the ring last went round. */
+        while (lower_page_to_check < upper_page_to_check)
+        {
+            page_to_check = ((lower_page_to_check + upper_page_to_check) + 1u) / 2u;
+
+            if ( (ring_page_key_get(partition_index, page_to_check, &page_key))
+                    && (page_key == head_key) )
+            {
+                lower_page_to_check = page_to_check;
+            }
+            else
+            {
+                upper_page_to_check = page_to_check - 1u;
+            }
+        }
+
+        p_partition->page_sequence = head_key + lower_page_to_check;
+
+        /* Everything between the oldest page and this one is full. */
+        p_partition->full_pages = p_partition->page_sequence
+                                    - ring_tail_sequence_get(p_partition);
+        p_partition->free_pages = p_partition->number_of_pages
+                                    - p_partition->full_pages;
+        p_partition->partition_error_status = RS_ERR_NO_ERROR;
+
+        /* The unit after this one might not have been erased yet. */
+        number_of_units = p_partition->number_of_pages / p_partition->ring_unit_pages;
+        next_unit       = (p_partition->page_sequence / p_partition->ring_unit_pages) + 1u;
+
+        if (next_unit >= number_of_units)
+        {
+            p_ring->b_erase_due   = TRUE;
+            p_ring->erase_address = p_partition->start_address
+                                        + ((next_unit % number_of_units)
+                                            * p_partition->ring_unit_pages
+                                            * page_length_in_bytes);
+        }
+
+        page_start_address = p_partition->start_address
+                                + (lower_page_to_check * page_length_in_bytes);
+
+        next_free_address
+            = rssearch_find_next_free_address((page_start_address + PAGE_HEADER_LENGTH_BYTES),
+                                              (page_length_in_bytes - PAGE_HEADER_LENGTH_BYTES) );
+
+        /* Page is full, so move on to the next one and write its header. */
+        if (next_free_address >= (page_start_address + page_length_in_bytes))
+        {
+            rspartition_flag_page_as_full(partition_index);
+
+            lower_page_to_check = (lower_page_to_check + 1u) % p_partition->number_of_pages;
+
+            header_data_build(partition_index,
+                              lower_page_to_check,
+                              rspartition_ring_page_open(partition_index),
+                              &header_data);
+
+            //lint -e{920} Ignore the return value - carry on using the memory anyway.
+            (void)rspages_page_header_write(&header_data);
+
+            next_free_address = p_partition->start_address
+                                    + (lower_page_to_check * page_length_in_bytes)
+                                    + PAGE_HEADER_LENGTH_BYTES;
+        }
+
+        p_partition->next_available_address = next_free_address;
+    }
+
+    return b_partition_ready_to_use;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ring_page_key_get reads the sequence number from a page header in a ring
+ * log and returns the sequence number less the page number, which is the
+ * same for every page written since the ring last went round.
+ *
+ * @param   partition_index     Partition index of the ring log.
+ * @param   page_number         Page number to read.
+ * @param   p_key               Pointer to return the key.
+ * @retval  bool_t              TRUE if the page has a valid sequence number.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t ring_page_key_get(const uint8_t partition_index,
+                                const uint32_t page_number,
+                                uint32_t * const p_key)
+{
+    const rs_partition_info_t*  p_partition = &m_rs_partition_info[partition_index];
+    uint32_t                    sequence;
+    bool_t                      b_key_ok = FALSE;
+
+    //lint -e{920} Ignore the header status, the sequence number says it all.
+    (void)rspages_page_sequence_get(p_partition->start_address,
+                                    p_partition->end_address,
+                                    page_number,
+                                    p_partition->id,
+                                    &sequence);
+
+    if (sequence != PAGE_HEADER_NO_SEQUENCE)
+    {
+        *p_key   = sequence - page_number;
+        b_key_ok = TRUE;
+    }
+
+    return b_key_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ring_tail_sequence_get returns the sequence number of the oldest page in
+ * a ring log which hasn't been discarded.  The unit being written and the
+ * one after it (which is erased ahead) leave the rest of the units holding
+ * the oldest data.
+ *
+ * @param   p_partition     Pointer to the ring log partition.
+ * @retval  uint32_t        Sequence number of the oldest page.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t ring_tail_sequence_get(const rs_partition_info_t * const p_partition)
+{
+    uint32_t    number_of_units;
+    uint32_t    head_unit;
+    uint32_t    tail_sequence = 0u;
+
+    number_of_units = p_partition->number_of_pages / p_partition->ring_unit_pages;
+    head_unit       = p_partition->page_sequence / p_partition->ring_unit_pages;
+
+    if ((head_unit + 2u) > number_of_units)
+    {
+        tail_sequence = ((head_unit + 2u) - number_of_units) * p_partition->ring_unit_pages;
+    }
+
+    return tail_sequence;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ring_erase_finish finishes any erase which is running or due in a ring log,
+ * waiting for the flash, as the unit is about to be written.
+ *
+ * @param   partition_index     Partition index of the ring log.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void ring_erase_finish(const uint8_t partition_index)
+{
+    const uint32_t          page_length_in_bytes = (RS_CFG_PAGE_SIZE_KB * 1024u);
+    rspartition_ring_t*     p_ring = &m_ring[partition_index];
+    flash_hal_error_t       flash_error = FLASH_HAL_NO_ERROR;
+
+    while (p_ring->b_erase_running)
+    {
+        p_ring->b_erase_running = flash_hal_erase_poll(&flash_error);
+
+        if ( (!p_ring->b_erase_running) && (flash_error == FLASH_HAL_NO_ERROR) )
+        {
+            p_ring->b_erase_due = FALSE;
+        }
+    }
+
+    if (p_ring->b_erase_due)
+    {
+        //lint -e{920} Ignore the return value - a failed erase shows up as a failed write.
+        (void)flash_hal_device_erase(p_ring->erase_address,
+                                     m_rs_partition_info[partition_index].ring_unit_pages
+                                        * page_length_in_bytes);
+
+        p_ring->b_erase_due = FALSE;
+    }
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * update_progress_counter updates the progress counter variable.
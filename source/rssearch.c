@@ -45,6 +45,12 @@
 /// A blank character in the RSR will be an 0xFF.
 #define RSR_BLANK_CHARACTER         0xFFu
 
+/// Areas with fewer blocks than this are always searched linearly.
+#define PROBE_MINIMUM_BLOCKS        8u
+
+/// Bytes read back from the next free address to look for the last RSR.
+#define PROBE_FIRST_WINDOW_SIZE     (2u * RS_CFG_LOCAL_BLOCK_READ_SIZE)
+
 
 // ----------------------------------------------------------------------------
 // Function prototypes for functions which only have scope within this module:
@@ -52,6 +58,21 @@
 static uint16_t count_blanks_from_end(const uint8_t * const p_area,
                                       const uint16_t size_of_area);
 
+static uint32_t linear_free_address_find(const uint32_t logical_start_address,
+                                         const uint32_t number_of_bytes_to_check);
+
+static bool_t   probe_free_address_find(const uint32_t logical_start_address,
+                                        const uint32_t number_of_bytes_to_check,
+                                        uint32_t * const p_next_free_address);
+
+static bool_t   probe_block_read(const uint32_t logical_start_address,
+                                 const uint32_t number_of_bytes_to_check,
+                                 const uint32_t block_index,
+                                 uint32_t * const p_used_end_address);
+
+static bool_t   rsr_ends_at(const uint32_t logical_start_address,
+                            const uint32_t end_address);
+
 static uint8_t partition_memory_read_setup
                         (const rssearch_internal_memory_t * const p_memory_data,
                          uint32_t * const p_read_addresses,
@@ -59,11 +80,13 @@ static uint8_t partition_memory_read_setup
 
 static uint8_t partition_memory_read_setup_fwd
                     (const rs_page_details_t * const p_page_details,
+                     const uint32_t last_page_number,
                      uint32_t * const p_read_addresses,
                      uint32_t * const p_bytes_to_read);
 
 static uint8_t partition_memory_read_setup_bwd
                     (const rs_page_details_t * const p_page_details,
+                     const uint32_t first_page_number,
                      uint32_t * const p_read_addresses,
                      uint32_t * const p_bytes_to_read);
 
@@ -105,6 +128,9 @@ static uint32_t calc_next_search_address_bwd
                              const uint8_t number_of_reads,
                              const uint16_t last_valid_search_index);
 
+static uint32_t ring_offset_get(const rssearch_search_data_t * const p_search_data,
+                                const uint32_t logical_address);
+
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module:
@@ -149,6 +175,16 @@ static volatile bool_t      mb_rssearch_timeout = FALSE;
  * as well, so this situation needs to be checked for elsewhere.
  * Unfortunately the recording system specification doesn't cater for this.
  *
+ * The area is first searched by probing blocks (see probe_free_address_find),
+ * which only needs a handful of reads however full the area is.  If the
+ * probes can't be shown to have found the end of the last RSR then the area
+ * is searched linearly from the end, as it always used to be, so the result
+ * is the same either way.
+ *
+ * @note
+ * The probe search uses the RSR search buffer, so any RSR previously found
+ * by rssearch_find_valid_RSR_start is no longer valid.
+ *
  * @param   logical_start_address       Start address of contiguous area.
  * @param   number_of_bytes_to_check    Number of contiguous bytes to check.
  * @retval  uint32_t                    Start of blank area or 0xFFFFFFFF for fail.
@@ -158,89 +194,14 @@ static volatile bool_t      mb_rssearch_timeout = FALSE;
 uint32_t rssearch_find_next_free_address(const uint32_t logical_start_address,
                                          const uint32_t number_of_bytes_to_check)
 {
-    uint32_t            next_free_address = 0xFFFFFFFFu;
-    flash_hal_error_t   flash_read_status;
-    uint8_t             block_buffer[RS_CFG_LOCAL_BLOCK_READ_SIZE];
-    uint32_t            whole_blocks_to_read;
-    uint32_t            remainder_to_read;
-    uint32_t            logical_read_address;
-    uint32_t            blanks_from_end = 0u;
-    uint32_t            total_blanks_from_end = 0u;
-    bool_t              b_found_used_data = FALSE;
-    bool_t              b_flash_ok = TRUE;
-
-    whole_blocks_to_read = number_of_bytes_to_check / RS_CFG_LOCAL_BLOCK_READ_SIZE;
-    remainder_to_read    = number_of_bytes_to_check % RS_CFG_LOCAL_BLOCK_READ_SIZE;
-
-    /* Setup the initial address to start at.
-     * We might underflow if we haven't got a whole page, but it doesn't
-     * matter because the remainder code doesn't use this logical_read_address.
-     */
-    logical_read_address = (logical_start_address + number_of_bytes_to_check)
-                                - RS_CFG_LOCAL_BLOCK_READ_SIZE;
-
-    /* Read whole blocks until we've done them all or the flash fails. */
-    while ( (whole_blocks_to_read != 0u) && (b_flash_ok) )
-    {
-        //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
-        flash_read_status = flash_hal_device_read(logical_read_address,
-                                                  (uint32_t)RS_CFG_LOCAL_BLOCK_READ_SIZE,
-                                                  &block_buffer[0u]);
-
-        if (flash_read_status != FLASH_HAL_NO_ERROR)
-        {
-            b_flash_ok = FALSE;
-        }
-        else
-        {
-            blanks_from_end = count_blanks_from_end(&block_buffer[0u],
-                                                    RS_CFG_LOCAL_BLOCK_READ_SIZE);
-
-            total_blanks_from_end += blanks_from_end;
-
-            /* Jump out as soon as we find something not completely blank. */
-            if (blanks_from_end != RS_CFG_LOCAL_BLOCK_READ_SIZE)
-            {
-                b_found_used_data = TRUE;
-                break;
-            }
-
-            logical_read_address -= RS_CFG_LOCAL_BLOCK_READ_SIZE;
-            whole_blocks_to_read--;
-        }
-    }
-
-    /* Only do the remainder if we haven't already found some used data.
-     * There will only ever be a single remainder, so read from the
-     * logical start address.
-     */
-    if ( (remainder_to_read != 0u) && (!b_found_used_data) && (b_flash_ok) )
-    {
-        flash_read_status = flash_hal_device_read(logical_start_address,
-                                                  remainder_to_read,
-                                                  &block_buffer[0u]);
-
-        if (flash_read_status != FLASH_HAL_NO_ERROR)
-        {
-            b_flash_ok = FALSE;
-        }
-        else
-        {
-            //lint -e{921} Cast remainder to 16 bit - buffer isn't bigger than this.
-            blanks_from_end = count_blanks_from_end(&block_buffer[0u],
-                                                    (uint16_t)remainder_to_read);
-
-            total_blanks_from_end += blanks_from_end;
-        }
-    }
+    uint32_t    next_free_address;
 
-    /* Any flash error and we simply return an address of 0xFFFFFFFF,
-     * otherwise calculate the next free address.
-     */
-    if (b_flash_ok)
+    if (!probe_free_address_find(logical_start_address,
+                                 number_of_bytes_to_check,
+                                 &next_free_address))
     {
-        next_free_address = (logical_start_address + number_of_bytes_to_check)
-                                - total_blanks_from_end;
+        next_free_address = linear_free_address_find(logical_start_address,
+                                                     number_of_bytes_to_check);
     }
 
     return next_free_address;
@@ -316,6 +277,28 @@ bool_t rssearch_find_valid_RSR_start
         memory_data.partition_logical_start_address = p_search_data->partition_logical_start_address;
         memory_data.partition_logical_end_address   = p_search_data->partition_logical_end_address;
         memory_data.search_start_address            = p_search_data->search_start_address;
+        memory_data.first_page_number               = 0u;
+        memory_data.last_page_number
+            = (p_search_data->partition_logical_end_address
+                    - p_search_data->partition_logical_start_address)
+                / (RS_CFG_PAGE_SIZE_KB * 1024u);
+
+        /*
+         * A ring log which has gone round only has data from the oldest page
+         * up to the page being written - the rest is being erased.
+         */
+        if (p_search_data->b_ring_wrapped)
+        {
+            memory_data.first_page_number
+                = (p_search_data->ring_oldest_address
+                        - p_search_data->partition_logical_start_address)
+                    / (RS_CFG_PAGE_SIZE_KB * 1024u);
+
+            memory_data.last_page_number
+                = (p_search_data->ring_next_free_address
+                        - p_search_data->partition_logical_start_address)
+                    / (RS_CFG_PAGE_SIZE_KB * 1024u);
+        }
 
         search_data.search_direction                = p_search_data->search_direction;
 
@@ -518,6 +501,8 @@ rssearch_unit_test_pointers_t* rssearch_unit_test_ptr_get(void)
         &m_rsr_info,
 
         count_blanks_from_end,
+        linear_free_address_find,
+        probe_free_address_find,
         partition_memory_read_setup,
         read_partition_data,
         search_for_valid_rsr_in_buffer,
@@ -568,6 +553,419 @@ static uint16_t count_blanks_from_end(const uint8_t * const p_area,
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * linear_free_address_find searches back through a contiguous area of memory
+ * one block at a time, looking for the start of a blank section.
+ *
+ * @param   logical_start_address       Start address of contiguous area.
+ * @param   number_of_bytes_to_check    Number of contiguous bytes to check.
+ * @retval  uint32_t                    Start of blank area or 0xFFFFFFFF for fail.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t linear_free_address_find(const uint32_t logical_start_address,
+                                         const uint32_t number_of_bytes_to_check)
+{
+    uint32_t            next_free_address = 0xFFFFFFFFu;
+    flash_hal_error_t   flash_read_status;
+    uint8_t             block_buffer[RS_CFG_LOCAL_BLOCK_READ_SIZE];
+    uint32_t            whole_blocks_to_read;
+    uint32_t            remainder_to_read;
+    uint32_t            logical_read_address;
+    uint32_t            blanks_from_end = 0u;
+    uint32_t            total_blanks_from_end = 0u;
+    bool_t              b_found_used_data = FALSE;
+    bool_t              b_flash_ok = TRUE;
+
+    whole_blocks_to_read = number_of_bytes_to_check / RS_CFG_LOCAL_BLOCK_READ_SIZE;
+    remainder_to_read    = number_of_bytes_to_check % RS_CFG_LOCAL_BLOCK_READ_SIZE;
+
+    /* Setup the initial address to start at.
+     * We might underflow if we haven't got a whole page, but it doesn't
+     * matter because the remainder code doesn't use this logical_read_address.
+     */
+    logical_read_address = (logical_start_address + number_of_bytes_to_check)
+                                - RS_CFG_LOCAL_BLOCK_READ_SIZE;
+
+    /* Read whole blocks until we've done them all or the flash fails. */
+    while ( (whole_blocks_to_read != 0u) && (b_flash_ok) )
+    {
+        //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+        flash_read_status = flash_hal_device_read(logical_read_address,
+                                                  (uint32_t)RS_CFG_LOCAL_BLOCK_READ_SIZE,
+                                                  &block_buffer[0u]);
+
+        if (flash_read_status != FLASH_HAL_NO_ERROR)
+        {
+            b_flash_ok = FALSE;
+        }
+        else
+        {
+            blanks_from_end = count_blanks_from_end(&block_buffer[0u],
+                                                    RS_CFG_LOCAL_BLOCK_READ_SIZE);
+
+            total_blanks_from_end += blanks_from_end;
+
+            /* Jump out as soon as we find something not completely blank. */
+            if (blanks_from_end != RS_CFG_LOCAL_BLOCK_READ_SIZE)
+            {
+                b_found_used_data = TRUE;
+                break;
+            }
+
+            logical_read_address -= RS_CFG_LOCAL_BLOCK_READ_SIZE;
+            whole_blocks_to_read--;
+        }
+    }
+
+    /* Only do the remainder if we haven't already found some used data.
+     * There will only ever be a single remainder, so read from the
+     * logical start address.
+     */
+    if ( (remainder_to_read != 0u) && (!b_found_used_data) && (b_flash_ok) )
+    {
+        flash_read_status = flash_hal_device_read(logical_start_address,
+                                                  remainder_to_read,
+                                                  &block_buffer[0u]);
+
+        if (flash_read_status != FLASH_HAL_NO_ERROR)
+        {
+            b_flash_ok = FALSE;
+        }
+        else
+        {
+            //lint -e{921} Cast remainder to 16 bit - buffer isn't bigger than this.
+            blanks_from_end = count_blanks_from_end(&block_buffer[0u],
+                                                    (uint16_t)remainder_to_read);
+
+            total_blanks_from_end += blanks_from_end;
+        }
+    }
+
+    /* Any flash error and we simply return an address of 0xFFFFFFFF,
+     * otherwise calculate the next free address.
+     */
+    if (b_flash_ok)
+    {
+        next_free_address = (logical_start_address + number_of_bytes_to_check)
+                                - total_blanks_from_end;
+    }
+
+    return next_free_address;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * probe_free_address_find looks for the start of the blank section at the
+ * end of a contiguous area by reading single blocks, rather than every block
+ * from the end.
+ *
+ * The area is split into blocks of RS_CFG_LOCAL_BLOCK_READ_SIZE from its
+ * start (the last one may be short).  Blocks are probed going back from the
+ * end, doubling the step each time, until one which isn't blank is found,
+ * and then the gap between that and the last blank block probed is halved
+ * until the two are next to each other.  The data ends in the used block.
+ *
+ * Records are written one after another, so a blank block can also be part
+ * of a TDR which is full of 0xFF.  The result is only used if there is a
+ * valid RSR ending at it (see rsr_ends_at) - after that RSR there must be a
+ * whole blank block, and if anything had been written after the RSR it would
+ * have started with a SYNC.  (A TDR which itself holds a whole valid RSR
+ * followed by a blank block could still fool this, just as it could fool
+ * rssearch_find_valid_RSR_start.)  If the very last block isn't blank then the
+ * answer is worked out from that, exactly as the linear search would.  If
+ * every probe is blank then the area may well be empty, which is confirmed
+ * with flash_hal_device_blank_check - that uses the device's own blank check
+ * (and the erased cache for the main flash), so it's far cheaper than reading
+ * the whole area.  Only if that fails is the area searched linearly.
+ *
+ * @param   logical_start_address       Start address of contiguous area.
+ * @param   number_of_bytes_to_check    Number of contiguous bytes to check.
+ * @param   p_next_free_address         Start of blank area is written here.
+ * @retval  bool_t                      TRUE if the start of the blank area
+ *                                      was found, FALSE to search linearly.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t probe_free_address_find(const uint32_t logical_start_address,
+                                      const uint32_t number_of_bytes_to_check,
+                                      uint32_t * const p_next_free_address)
+{
+    uint32_t    number_of_blocks;
+    uint32_t    used_block = 0u;
+    uint32_t    blank_block;
+    uint32_t    probe_block;
+    uint32_t    step = 1u;
+    uint32_t    used_end_address;
+    uint32_t    data_end_address = 0u;
+    bool_t      b_found = FALSE;
+    bool_t      b_flash_ok = TRUE;
+    bool_t      b_used_found = FALSE;
+
+    number_of_blocks = (number_of_bytes_to_check + (RS_CFG_LOCAL_BLOCK_READ_SIZE - 1u))
+                            / RS_CFG_LOCAL_BLOCK_READ_SIZE;
+
+    if (number_of_blocks >= PROBE_MINIMUM_BLOCKS)
+    {
+        /* Gallop back from the end until a block with data in it is found. */
+        blank_block = number_of_blocks;
+        probe_block = number_of_blocks - 1u;
+
+        while ( (!b_used_found) && (b_flash_ok) && (blank_block != 0u) )
+        {
+            b_flash_ok = probe_block_read(logical_start_address, number_of_bytes_to_check,
+                                          probe_block, &used_end_address);
+
+            if (used_end_address != 0xFFFFFFFFu)
+            {
+                used_block       = probe_block;
+                data_end_address = used_end_address;
+                b_used_found     = TRUE;
+            }
+            else
+            {
+                blank_block = probe_block;
+                probe_block = (probe_block > step) ? (probe_block - step) : 0u;
+                step <<= 1u;
+            }
+        }
+
+        /* Then halve the gap until the used and blank blocks are adjacent. */
+        while ( (b_used_found) && (b_flash_ok) && ((blank_block - used_block) > 1u) )
+        {
+            probe_block = used_block + ((blank_block - used_block) >> 1u);
+
+            b_flash_ok = probe_block_read(logical_start_address, number_of_bytes_to_check,
+                                          probe_block, &used_end_address);
+
+            if (used_end_address != 0xFFFFFFFFu)
+            {
+                used_block       = probe_block;
+                data_end_address = used_end_address;
+            }
+            else
+            {
+                blank_block = probe_block;
+            }
+        }
+
+        /*
+         * A flash failure is left for the linear search to report.  An area
+         * where every probe was blank is empty if the device says it's blank,
+         * otherwise there's data between the probes and the linear search
+         * has to find it.
+         */
+        if (!b_flash_ok)
+        {
+            b_found = FALSE;
+        }
+        else if (!b_used_found)
+        {
+            data_end_address = logical_start_address;
+            b_found = flash_hal_device_blank_check(logical_start_address,
+                                                   number_of_bytes_to_check);
+        }
+        else if (blank_block == number_of_blocks)
+        {
+            /* The last block has data in it, so nothing else can be blank. */
+            b_found = TRUE;
+        }
+        else
+        {
+            b_found = rsr_ends_at(logical_start_address, data_end_address);
+        }
+    }
+
+    if (b_found)
+    {
+        *p_next_free_address = data_end_address;
+    }
+
+    return b_found;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * probe_block_read reads a single block of a contiguous area and works out
+ * where the data in it ends.
+ *
+ * @param   logical_start_address       Start address of contiguous area.
+ * @param   number_of_bytes_to_check    Number of contiguous bytes in the area.
+ * @param   block_index                 Block to read, counting from the start.
+ * @param   p_used_end_address          Address after the last byte which isn't
+ *                                      blank is written here, or 0xFFFFFFFF if
+ *                                      the block is blank.
+ * @retval  bool_t                      TRUE if the read worked, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t probe_block_read(const uint32_t logical_start_address,
+                               const uint32_t number_of_bytes_to_check,
+                               const uint32_t block_index,
+                               uint32_t * const p_used_end_address)
+{
+    uint8_t     block_buffer[RS_CFG_LOCAL_BLOCK_READ_SIZE];
+    uint32_t    block_offset;
+    uint16_t    block_length = RS_CFG_LOCAL_BLOCK_READ_SIZE;
+    uint16_t    blanks_from_end;
+    bool_t      b_flash_ok = FALSE;
+
+    *p_used_end_address = 0xFFFFFFFFu;
+
+    block_offset = block_index * RS_CFG_LOCAL_BLOCK_READ_SIZE;
+
+    if ((number_of_bytes_to_check - block_offset) < RS_CFG_LOCAL_BLOCK_READ_SIZE)
+    {
+        //lint -e{921} Cast to 16 bit - less than a block.
+        block_length = (uint16_t)(number_of_bytes_to_check - block_offset);
+    }
+
+    //lint -e{921} Cast to uint32_t to avoid prototype coercion on 16 bit platforms.
+    if (flash_hal_device_read(logical_start_address + block_offset,
+                              (uint32_t)block_length,
+                              &block_buffer[0u]) == FLASH_HAL_NO_ERROR)
+    {
+        blanks_from_end = count_blanks_from_end(&block_buffer[0u], block_length);
+
+        if (blanks_from_end != block_length)
+        {
+            *p_used_end_address = (logical_start_address + block_offset + block_length)
+                                    - blanks_from_end;
+        }
+
+        b_flash_ok = TRUE;
+    }
+
+    return b_flash_ok;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsr_ends_at checks whether there is a valid RSR which ends just before an
+ * address, within a contiguous area.
+ *
+ * The area before the address is read back into the RSR search buffer,
+ * starting with a small window and doubling it each time, up to the largest
+ * possible RSR, so that short records only need a short read.  Only the part
+ * read each time is searched for a SYNC, as the rest has already been looked
+ * at.  A SYNC counts if its length field puts the ENDSYNC just before the
+ * address and the CRC matches.
+ *
+ * @note
+ * An RSR which started in the previous page isn't found - the search stops
+ * at the start of the area and the caller falls back to the linear search.
+ *
+ * @param   logical_start_address   Start address of contiguous area.
+ * @param   end_address             Address after the ENDSYNC of the RSR.
+ * @retval  bool_t                  TRUE if there is an RSR ending here.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t rsr_ends_at(const uint32_t logical_start_address,
+                          const uint32_t end_address)
+{
+    uint32_t    read_end_address;
+    uint32_t    buffer_start_address;
+    uint32_t    earliest_address;
+    uint32_t    window_start_address;
+    uint32_t    read_start_address;
+    uint32_t    window_size = PROBE_FIRST_WINDOW_SIZE;
+    uint32_t    sync_address;
+    uint16_t    sync_index;
+    uint16_t    tdr_length;
+    uint16_t    calculated_crc;
+    uint16_t    extracted_crc;
+    bool_t      b_rsr_found = FALSE;
+    bool_t      b_searching = TRUE;
+
+    /* The search buffer is about to be overwritten. */
+    mb_rsr_is_valid = FALSE;
+
+    /*
+     * Reads are kept to an even number of bytes from the start of the area,
+     * so that they stay on word boundaries for the main flash.  The buffer
+     * holds the bytes up to the (rounded up) end address in its last locations.
+     */
+    read_end_address     = end_address + ((end_address - logical_start_address) & 1u);
+    buffer_start_address = read_end_address - RSR_FIND_BUFFER_SIZE;
+
+    if ((end_address - logical_start_address) > (RS_CFG_MAX_TDR_SIZE_BYTES + RSR_WRAPPER_SIZE_OVERHEAD))
+    {
+        earliest_address = end_address - (RS_CFG_MAX_TDR_SIZE_BYTES + RSR_WRAPPER_SIZE_OVERHEAD);
+        earliest_address -= (earliest_address - logical_start_address) & 1u;
+    }
+    else
+    {
+        earliest_address = logical_start_address;
+    }
+
+    window_start_address = read_end_address;
+
+    while ( (!b_rsr_found) && (b_searching) && (window_start_address > earliest_address) )
+    {
+        read_start_address = ((window_start_address - earliest_address) > window_size)
+                                ? (window_start_address - window_size) : earliest_address;
+
+        //lint -e{921} Cast index to 16 bit - less than the size of the buffer.
+        if (flash_hal_device_read(read_start_address,
+                                  window_start_address - read_start_address,
+                                  &m_rsr_search_buffer[(uint16_t)(read_start_address - buffer_start_address)])
+                != FLASH_HAL_NO_ERROR)
+        {
+            b_searching = FALSE;
+        }
+        else if (m_rsr_search_buffer[(RSR_FIND_BUFFER_SIZE - 1u) - (read_end_address - end_address)]
+                    != RSR_ENDSYNC_CHARACTER)
+        {
+            /* No ENDSYNC, no RSR - no need to read any further back. */
+            b_searching = FALSE;
+        }
+        else
+        {
+            /* Search back through the part which has just been read. */
+            sync_address = window_start_address;
+
+            while ( (!b_rsr_found) && (sync_address > read_start_address) )
+            {
+                sync_address--;
+
+                //lint -e{921} Cast index to 16 bit - less than the size of the buffer.
+                sync_index = (uint16_t)(sync_address - buffer_start_address);
+
+                if ( ((end_address - sync_address) >= RSR_WRAPPER_SIZE_OVERHEAD)
+                        && (m_rsr_search_buffer[sync_index] == RSR_SYNC_CHARACTER) )
+                {
+                    tdr_length = convert_lsb_msb_8bits_into_16bits
+                                    (&m_rsr_search_buffer[sync_index + RSR_TDR_OFFSET_FROM_SYNC]);
+
+                    if ((end_address - sync_address) == ((uint32_t)tdr_length + RSR_WRAPPER_SIZE_OVERHEAD))
+                    {
+                        //lint -e{921} Cast to uint32_t to avoid prototype coercion.
+                        calculated_crc = CRC_CCITTOnByteCalculate(&m_rsr_search_buffer[sync_index],
+                                                                  (uint32_t)tdr_length + RSR_CRC_EXTRA_LENGTH,
+                                                                  0x0000u);
+
+                        extracted_crc = convert_msb_lsb_8bits_into_16bits
+                                            (&m_rsr_search_buffer[sync_index + RSR_CRC_EXTRA_LENGTH + tdr_length]);
+
+                        b_rsr_found = (calculated_crc == extracted_crc) ? TRUE : FALSE;
+                    }
+                }
+            }
+
+            window_start_address = read_start_address;
+            window_size <<= 1u;
+        }
+    }
+
+    return b_rsr_found;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * partition_memory_read_setup sets up the required reads to get enough data
@@ -578,8 +976,10 @@ static uint16_t count_blanks_from_end(const uint8_t * const p_area,
  * starting at the search start address and working forwards or backwards
  * depending on the search direction.
  *
- * If we've reached the bottom or top of the partition itself then the read is
- * truncated, as an RSR will not span partitions.
+ * If we've reached the first or last page with data in it (normally the bottom
+ * or top of the partition itself) then the read is truncated, as an RSR will
+ * not span partitions.  In a ring log the read carries on from the last page
+ * to the first page (or the other way round), as long as there's data there.
  *
  * This function skips any page headers which it encounters along the way,
  * splitting the read into two chunks, one before and one after the header.
@@ -613,12 +1013,14 @@ static uint8_t partition_memory_read_setup
         {
             case RSSEARCH_FORWARDS:
                number_of_reads = partition_memory_read_setup_fwd(&page_details,
+                                                                 p_memory_data->last_page_number,
                                                                  p_read_addresses,
                                                                  p_bytes_to_read);
             break;
 
             case RSSEARCH_BACKWARDS:
                 number_of_reads = partition_memory_read_setup_bwd(&page_details,
+                                                                  p_memory_data->first_page_number,
                                                                   p_read_addresses,
                                                                   p_bytes_to_read);
             break;
@@ -640,6 +1042,7 @@ static uint8_t partition_memory_read_setup
  * partition_memory_read_setup() function when searching forwards.
  *
  * @param   p_page_details      Pointer to page details structure.
+ * @param   last_page_number    Last page with data in it.
  * @param   p_read_addresses    Pointer to array to write read addresses into.
  * @param   p_bytes_to_read     Pointer to array to write bytes to read into.
  * @retval  uint8_t             Number of reads required.
@@ -648,13 +1051,11 @@ static uint8_t partition_memory_read_setup
 // ----------------------------------------------------------------------------
 static uint8_t partition_memory_read_setup_fwd
                             (const rs_page_details_t * const p_page_details,
+                             const uint32_t last_page_number,
                              uint32_t * const p_read_addresses,
                              uint32_t * const p_bytes_to_read)
 {
     uint8_t     number_of_reads = 1u;
-    uint32_t    last_page_number;
-
-    last_page_number = p_page_details->maximum_number_of_pages - 1u;
 
     /* Does the read fit somewhere in a page with no shortening of the read? */
     if (p_page_details->distance_to_upper_address >= RSR_FIND_BUFFER_SIZE)
@@ -681,9 +1082,12 @@ static uint8_t partition_memory_read_setup_fwd
         p_bytes_to_read[0u]  = p_page_details->distance_to_upper_address + 1u;
         p_read_addresses[0u] = p_page_details->address_within_partition;
     }
-    /* Does the read fall off the top of the page but we can read the next page? */
+    /*
+     * Does the read fall off the top of the page but we can read the next page?
+     * In a ring log which has gone round the last page can be below this one.
+     */
     else if ((p_page_details->distance_to_upper_address < RSR_FIND_BUFFER_SIZE)
-                && (p_page_details->page_number < last_page_number))
+                && (p_page_details->page_number != last_page_number))
     {
         p_bytes_to_read[0u]  = p_page_details->distance_to_upper_address + 1u;
         p_read_addresses[0u] = p_page_details->address_within_partition;
@@ -691,6 +1095,13 @@ static uint8_t partition_memory_read_setup_fwd
         p_bytes_to_read[1u]  = RSR_FIND_BUFFER_SIZE - p_bytes_to_read[0u];
         p_read_addresses[1u] = p_page_details->upper_address_within_page + PAGE_HEADER_LENGTH_BYTES + 1u;
 
+        /* A ring log carries on from the top of the partition at the first page. */
+        if ((p_page_details->page_number + 1u) == p_page_details->maximum_number_of_pages)
+        {
+            p_read_addresses[1u] = p_page_details->partition_logical_start_address
+                                        + PAGE_HEADER_LENGTH_BYTES;
+        }
+
         number_of_reads = 2u;
     }
     /* Any other condition is a mistake, so don't read anything. */
@@ -709,6 +1120,7 @@ static uint8_t partition_memory_read_setup_fwd
  * partition_memory_read_setup() function when searching backwards.
  *
  * @param   p_page_details      Pointer to page details structure.
+ * @param   first_page_number   First page with data in it.
  * @param   p_read_addresses    Pointer to array to write read addresses into.
  * @param   p_bytes_to_read     Pointer to array to write bytes to read into.
  * @retval  uint8_t             Number of reads required.
@@ -717,6 +1129,7 @@ static uint8_t partition_memory_read_setup_fwd
 // ----------------------------------------------------------------------------
 static uint8_t partition_memory_read_setup_bwd
                             (const rs_page_details_t * const p_page_details,
+                             const uint32_t first_page_number,
                              uint32_t * const p_read_addresses,
                              uint32_t * const p_bytes_to_read)
 {
@@ -734,10 +1147,10 @@ static uint8_t partition_memory_read_setup_bwd
     }
     /* Does the read fall off the bottom of the page and this is the first page? */
     else if ((p_page_details->distance_to_lower_address < RSR_FIND_BUFFER_SIZE)
-                && (p_page_details->page_number == 0u))
+                && (p_page_details->page_number == first_page_number))
     {
         p_bytes_to_read[0u]  = p_page_details->distance_to_lower_address;
-        p_read_addresses[0u] = p_page_details->partition_logical_start_address + PAGE_HEADER_LENGTH_BYTES;
+        p_read_addresses[0u] = p_page_details->lower_address_within_page;
 
         /* If we're in the header then there's no read to be done. */
         if (p_page_details->distance_to_lower_address == 0u)
@@ -746,22 +1159,33 @@ static uint8_t partition_memory_read_setup_bwd
             number_of_reads = 0u;
         }
     }
-    /* Does the read fall off the bottom of the page but we can read the previous page? */
+    /*
+     * Does the read fall off the bottom of the page but we can read the previous page?
+     * In a ring log which has gone round the first page can be above this one.
+     */
     else if ((p_page_details->distance_to_lower_address < RSR_FIND_BUFFER_SIZE)
-                && (p_page_details->page_number > 0u))
+                && (p_page_details->page_number != first_page_number))
     {
         /*
-         * Special case if we're in the header - just read an equal
-         * number of bytes from the previous and current pages.
+         * Calculate end address of the previous page - in a ring log
+         * the page before the first page is the last page.
          */
-        if (p_page_details->distance_to_lower_address == 0u)
+        p_read_addresses[0u] = p_page_details->lower_address_within_page - PAGE_HEADER_LENGTH_BYTES;
+
+        if (p_page_details->page_number == 0u)
         {
-            /* Setup read for the current page (from the page boundary). */
-            p_bytes_to_read[1u]  = RSR_FIND_BUFFER_SIZE / 2u;
-            p_read_addresses[1u] = p_page_details->lower_address_within_page;
+            p_read_addresses[0u] = p_page_details->partition_logical_end_address + 1u;
+        }
 
-            /* Number of bytes to read from previous page. */
-            p_bytes_to_read[0u]  = RSR_FIND_BUFFER_SIZE / 2u;
+        /*
+         * Special case if we're in the header - the search started at the
+         * start of the page, so everything before it is in the previous page.
+         * Reading any of the current page would find the same RSR again.
+         */
+        if (p_page_details->distance_to_lower_address == 0u)
+        {
+            p_bytes_to_read[0u]  = RSR_FIND_BUFFER_SIZE;
+            p_read_addresses[0u] -= p_bytes_to_read[0u];
         }
         else
         {
@@ -769,19 +1193,15 @@ static uint8_t partition_memory_read_setup_bwd
             p_bytes_to_read[1u]  = p_page_details->distance_to_lower_address;
             p_read_addresses[1u] = p_page_details->lower_address_within_page;
 
-            /* Number of bytes to read from previous page. */
+            /*
+             * Subtract the number of bytes which we need to read from the
+             * previous page to arrive at the read address for the previous page.
+             */
             p_bytes_to_read[0u]  = RSR_FIND_BUFFER_SIZE - p_bytes_to_read[1u];
-        }
-
-        /*
-         * Calculate start address of current page and then subtract the
-         * number of bytes which we need to read from the previous page
-         * to arrive at the read address for the previous page.
-         */
-        p_read_addresses[0u] = p_page_details->lower_address_within_page - PAGE_HEADER_LENGTH_BYTES;
-        p_read_addresses[0u] -= p_bytes_to_read[0u];
+            p_read_addresses[0u] -= p_bytes_to_read[0u];
 
-        number_of_reads = 2u;
+            number_of_reads = 2u;
+        }
     }
     /* Any other condition is a mistake, so don't read anything. */
     else
@@ -942,8 +1362,8 @@ static bool_t search_for_valid_rsr_in_buffer
         {
             tdr_offset = search_index + RSR_TDR_OFFSET_FROM_SYNC;
 
-            /* If the TDR lies within the buffer then extract the TDR length. */
-            if (tdr_offset < p_internal_data->bytes_read_into_buffer)
+            /* If the TDR length lies within the buffer then extract it. */
+            if ((tdr_offset + 1u) < p_internal_data->bytes_read_into_buffer)
             {
                 m_rsr_info.tdr_length = convert_lsb_msb_8bits_into_16bits(&m_rsr_search_buffer[tdr_offset]);
 
@@ -952,8 +1372,11 @@ static bool_t search_for_valid_rsr_in_buffer
                 /*
                  * If the CRC lies within the buffer (plus a space for the ENDSYNC
                  * then calculate the CRC from the buffer and extract the expected value.
+                 * The TDR length is checked first, as a corrupt length can wrap
+                 * the CRC offset round to somewhere within the buffer.
                  */
-                if (crc_offset < (p_internal_data->bytes_read_into_buffer - 1u))
+                if ((m_rsr_info.tdr_length < p_internal_data->bytes_read_into_buffer)
+                        && (crc_offset < (p_internal_data->bytes_read_into_buffer - 1u)))
                 {
                     crc_length = m_rsr_info.tdr_length + RSR_CRC_EXTRA_LENGTH;
 
@@ -1187,11 +1610,30 @@ static bool_t calc_next_search_address
         /*
          * Have we fallen off the end of the partition by
          * adjusting the start address?  If so, we're done.
+         * A ring log which has gone round is done once we've
+         * got to the next free address instead.
          */
-        if (next_search_start_address >= p_search_data->partition_logical_end_address)
+        if (p_search_data->b_ring_wrapped)
+        {
+            if (next_search_start_address > p_search_data->partition_logical_end_address)
+            {
+                next_search_start_address = p_search_data->partition_logical_start_address;
+            }
+
+            if (ring_offset_get(p_search_data, next_search_start_address)
+                    >= ring_offset_get(p_search_data, p_search_data->ring_next_free_address))
+            {
+                b_finished_searching = TRUE;
+            }
+        }
+        else if (next_search_start_address >= p_search_data->partition_logical_end_address)
         {
             b_finished_searching = TRUE;
         }
+        else
+        {
+            ;   // Extra else for MISRA compliance
+        }
     }
     else
     {
@@ -1204,13 +1646,27 @@ static bool_t calc_next_search_address
         /*
          * Have we fallen off the start of the partition by
          * adjusting the start address?  If so, we're done.
+         * A ring log which has gone round is done once we've
+         * got to the oldest data instead.
          */
-        if (next_search_start_address <=
-                (p_search_data->partition_logical_start_address
+        if (p_search_data->b_ring_wrapped)
+        {
+            if (ring_offset_get(p_search_data, next_search_start_address)
+                    <= PAGE_HEADER_LENGTH_BYTES)
+            {
+                b_finished_searching = TRUE;
+            }
+        }
+        else if (next_search_start_address <=
+                    (p_search_data->partition_logical_start_address
                         + PAGE_HEADER_LENGTH_BYTES))
         {
             b_finished_searching = TRUE;
         }
+        else
+        {
+            ;   // Extra else for MISRA compliance
+        }
     }
 
     if (!b_finished_searching)
@@ -1399,5 +1855,39 @@ static uint32_t calc_next_search_address_bwd
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * ring_offset_get converts an address in a ring log which has gone round into
+ * an offset from the start of the oldest page, so that addresses after the
+ * end of the partition (at the start of it) compare as higher.
+ *
+ * @param   p_search_data       Pointer to structure containing search data.
+ * @param   logical_address     Address to convert.
+ * @retval  uint32_t            Offset from the start of the oldest page.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t ring_offset_get(const rssearch_search_data_t * const p_search_data,
+                                const uint32_t logical_address)
+{
+    uint32_t    oldest_page_address;
+    uint32_t    offset;
+
+    oldest_page_address = p_search_data->ring_oldest_address - PAGE_HEADER_LENGTH_BYTES;
+
+    if (logical_address >= oldest_page_address)
+    {
+        offset = logical_address - oldest_page_address;
+    }
+    else
+    {
+        offset = (logical_address - p_search_data->partition_logical_start_address)
+                    + ((p_search_data->partition_logical_end_address + 1u) - oldest_page_address);
+    }
+
+    return offset;
+}
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -126,9 +126,11 @@ static uint16_t     GetNumberOfCharsInTxFifo(const uint32_t baseAddress);
 /// Structure to hold serial port related variables.
 typedef struct
 {
-    uint8_t*                p_rxBuffer;          ///< Pointer to receive buffer.
-    uint16_t                rxOffset;            ///< Current offset into buffer.
-    uint16_t                rxMaxLength;         ///< Maximum length of receive buffer.
+    uint8_t*                p_rxBuffer;          ///< Pointer to receive ring buffer.
+    volatile uint16_t       rxHead;              ///< Characters written by the interrupt (free running).
+    volatile uint16_t       rxTail;              ///< Characters released by the reader (free running).
+    uint16_t                rxMaxLength;         ///< Size of the ring buffer - a power of two.
+    uint16_t                rxOverrunCounter;    ///< Characters lost because the ring was full.
     pTriggerTimerFunction   p_timerTrigger;      ///< Pointer to the function triggering sci related timer.
     bool_t                  b_matchRequired;     ///< Flag to say character match required.
     uint8_t                 matchCharacter;      ///< 'Character' to match.
@@ -184,8 +186,10 @@ void SCI_Open(const ESCIModule_t module)
         // initialising the module, just in case we get any interrupts (and if
         // the variables weren't initialised, bad stuff could happen).
         m_serialPorts[module].p_rxBuffer          = NULL;
-        m_serialPorts[module].rxOffset            = 0u;
+        m_serialPorts[module].rxHead              = 0u;
+        m_serialPorts[module].rxTail              = 0u;
         m_serialPorts[module].rxMaxLength         = 0u;
+        m_serialPorts[module].rxOverrunCounter    = 0u;
         m_serialPorts[module].p_timerTrigger      = NULL;
         m_serialPorts[module].b_matchRequired     = FALSE;
         m_serialPorts[module].matchCharacter      = 0x00u;
@@ -388,10 +392,16 @@ bool_t SCI_BaudRateSet(const ESCIModule_t module,
 // ----------------------------------------------------------------------------
 /**
  * SCI_RxBufferInitialise sets up the receive variables for a particular
- * buffer - stores a pointer to the buffer to write in, and zeros the offset.
- * Note that we don't actually erase the buffer, only set the offset to zero
- * (as we always write a NULL after any received character there is no
- * requirement to erase as well).
+ * buffer - stores a pointer to the buffer to write in, and empties it.
+ * The buffer is used as a ring, written by the receive interrupt and read by
+ * SCI_RxSpanGet / SCI_RxSpanRelease, so there is no need for the reader to
+ * reset it after every message.  Only the largest power of two which fits in
+ * maxRxLength is used, so that the ring indices can simply be masked.
+ *
+ * @note
+ * This changes both ring indices, so must only be called when the receive
+ * interrupt can't write to the buffer (i.e. before the port is in use).
+ * Use SCI_RxBufferFlush to discard received characters.
  *
  * @param	Module		Enumerated type for which SCI port to initialise.
  * @param	pBuffer		Pointer to start of buffer to put received data in.
@@ -404,11 +414,43 @@ void SCI_RxBufferInitialise(const ESCIModule_t module,
                             uint8_t * const p_receiveBuffer,
                             const uint16_t maxRxLength)
 {
+    uint16_t    ringLength = 0x8000u;
+
     if (module < SCI_NUMBER_OF_PORTS)
     {
-        m_serialPorts[module].rxOffset    = 0u;
-        m_serialPorts[module].p_rxBuffer  = p_receiveBuffer;
-        m_serialPorts[module].rxMaxLength = maxRxLength;
+        while (ringLength > maxRxLength)
+        {
+            ringLength >>= 1;
+        }
+
+        m_serialPorts[module].p_rxBuffer       = NULL;
+        m_serialPorts[module].rxHead           = 0u;
+        m_serialPorts[module].rxTail           = 0u;
+        m_serialPorts[module].rxMaxLength      = ringLength;
+        m_serialPorts[module].rxOverrunCounter = 0u;
+
+        if (ringLength != 0u)
+        {
+            m_serialPorts[module].p_rxBuffer = p_receiveBuffer;
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * SCI_RxBufferFlush discards all the characters in the receive buffer.
+ * Only the reader's index is changed, so this is safe to call at any time.
+ *
+ * @param	Module		Enumerated type for which serial port buffer to flush.
+ *
+ */
+// ----------------------------------------------------------------------------
+void SCI_RxBufferFlush(const ESCIModule_t module)
+{
+    if (module < SCI_NUMBER_OF_PORTS)
+    {
+        m_serialPorts[module].rxTail = m_serialPorts[module].rxHead;
     }
 }
 
@@ -448,7 +490,7 @@ void SCI_RxTriggerInitialise(const ESCIModule_t module,
 // ----------------------------------------------------------------------------
 /**
  * SCI_RxBufferNumberOfCharsGet returns the number of characters which are
- * currently in the receive buffer.
+ * currently in the receive buffer, i.e. received but not yet released.
  *
  * @param	Module		Enumerated type for which serial port buffer to query.
  * @retval	uint16_t	Number of received characters.
@@ -461,13 +503,149 @@ uint16_t SCI_RxBufferNumberOfCharsGet(const ESCIModule_t module)
 
     if (module < SCI_NUMBER_OF_PORTS)
     {
-        numberOfCharacters = m_serialPorts[module].rxOffset;
+        //lint -e{921} Cast to keep the wrap around in 16 bits.
+        numberOfCharacters = (uint16_t)(m_serialPorts[module].rxHead
+                                            - m_serialPorts[module].rxTail);
     }
 
     return numberOfCharacters;
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * SCI_RxSpanGet gives direct access to the received characters, without
+ * copying them.  It returns the number of characters which can be read
+ * contiguously from the ring, starting offset characters after the oldest
+ * unreleased character, and points p_span at the first of them.  If the
+ * characters wrap around the end of the ring, calling again with the offset
+ * moved on by the returned length gives the rest.
+ *
+ * The characters stay in the ring, and can't be overwritten by the receive
+ * interrupt, until they are released by SCI_RxSpanRelease.
+ *
+ * @param   module      Enumerated type for which serial port buffer to read.
+ * @param   offset      Number of unreleased characters to skip.
+ * @param   pp_span     Pointer to the start of the span is written here.
+ * @retval  uint16_t    Number of contiguous characters, zero if none.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t SCI_RxSpanGet(const ESCIModule_t module,
+                       const uint16_t offset,
+                       const uint8_t ** const pp_span)
+{
+    uint16_t    spanLength = 0u;
+    uint16_t    available;
+    uint16_t    index;
+    uint16_t    charactersToEnd;
+
+    if ( (module < SCI_NUMBER_OF_PORTS)
+            && (m_serialPorts[module].p_rxBuffer != NULL) )
+    {
+        //lint -e{921} Cast to keep the wrap around in 16 bits.
+        available = (uint16_t)(m_serialPorts[module].rxHead
+                                   - m_serialPorts[module].rxTail);
+
+        if (offset < available)
+        {
+            //lint -e{921} Cast to keep the wrap around in 16 bits.
+            index = (uint16_t)(m_serialPorts[module].rxTail + offset)
+                        & (m_serialPorts[module].rxMaxLength - 1u);
+
+            spanLength      = available - offset;
+            charactersToEnd = m_serialPorts[module].rxMaxLength - index;
+
+            if (spanLength > charactersToEnd)
+            {
+                spanLength = charactersToEnd;
+            }
+
+            *pp_span = &m_serialPorts[module].p_rxBuffer[index];
+        }
+    }
+
+    return spanLength;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * SCI_RxSpanRelease hands characters back to the receive interrupt once they
+ * have been read, oldest first.  Releasing more characters than have been
+ * received just empties the buffer.
+ *
+ * @param   module      Enumerated type for which serial port buffer to release.
+ * @param   count       Number of characters to release.
+ *
+ */
+// ----------------------------------------------------------------------------
+void SCI_RxSpanRelease(const ESCIModule_t module, const uint16_t count)
+{
+    uint16_t    available;
+
+    if (module < SCI_NUMBER_OF_PORTS)
+    {
+        //lint -e{921} Cast to keep the wrap around in 16 bits.
+        available = (uint16_t)(m_serialPorts[module].rxHead
+                                   - m_serialPorts[module].rxTail);
+
+        //lint -e{921} Cast to keep the wrap around in 16 bits.
+        m_serialPorts[module].rxTail = (uint16_t)(m_serialPorts[module].rxTail
+                                        + ((count < available) ? count : available));
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * SCI_RxCharacterGet reads and releases the oldest received character.
+ *
+ * @param   module      Enumerated type for which serial port buffer to read.
+ * @param   p_data      Pointer to where the character should be written.
+ * @retval  bool_t      TRUE if a character was read.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t SCI_RxCharacterGet(const ESCIModule_t module, uint8_t * const p_data)
+{
+    const uint8_t*  p_span = NULL;
+    bool_t          b_characterRead = FALSE;
+
+    if (SCI_RxSpanGet(module, 0u, &p_span) != 0u)
+    {
+        *p_data = *p_span;
+        SCI_RxSpanRelease(module, 1u);
+        b_characterRead = TRUE;
+    }
+
+    return b_characterRead;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * SCI_RxOverrunCountGet returns the number of received characters which have
+ * been thrown away because the receive buffer was full.
+ *
+ * @param	Module		Enumerated type for which serial port buffer to query.
+ * @retval	uint16_t	Number of characters lost.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t SCI_RxOverrunCountGet(const ESCIModule_t module)
+{
+    uint16_t    overrunCount = 0u;
+
+    if (module < SCI_NUMBER_OF_PORTS)
+    {
+        overrunCount = m_serialPorts[module].rxOverrunCounter;
+    }
+
+    return overrunCount;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * SCI_TxTriggerInitialise sets up the transmit trigger variables for a
@@ -588,6 +766,94 @@ bool_t SCI_TxDoneCheck(const ESCIModule_t module)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * SCI_TxBufferFreeCheck checks whether the transmit interrupt has finished
+ * with the buffer passed to SCI_TxStart, i.e. every character has been put
+ * into the transmit FIFO.  The last few characters are still being sent, but
+ * the buffer can be reused, and SCI_TxStart can be called for the next
+ * message, which follows on without a gap.
+ *
+ * @param   module      Enumerated type for which SCI module to use.
+ * @retval  bool_t      TRUE if the transmit buffer is no longer in use.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t SCI_TxBufferFreeCheck(const ESCIModule_t module)
+{
+    bool_t      b_bufferFree = FALSE;
+
+    if ( (module < SCI_NUMBER_OF_PORTS)
+            && (m_serialPorts[module].txOffset == m_serialPorts[module].txMessageLength))
+    {
+        b_bufferFree = TRUE;
+    }
+
+    return b_bufferFree;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * SCI_RxFifoPoll empties the receive FIFO of a serial port into the receive
+ * buffer, exactly as the receive interrupt would.  This is for use while
+ * interrupts are disabled, e.g. from the flash API callback while the internal
+ * flash is being programmed, to stop the FIFO overflowing.
+ *
+ * @note
+ * This function runs from RAM, as it is called while the flash is busy.  It
+ * is only safe to call when the receive interrupt cannot run.
+ *
+ * @param   module      Enumerated type for which SCI module to use.
+ *
+ */
+// ----------------------------------------------------------------------------
+#pragma CODE_SECTION(SCI_RxFifoPoll, "ramfuncs")
+void SCI_RxFifoPoll(const ESCIModule_t module)
+{
+    volatile struct SCI_REGS * p_sciRegs = NULL;
+    uint16_t    receivedWords;
+    uint16_t    readCounter;
+
+    switch (module)
+    {
+        case SCI_A:
+            p_sciRegs = &SciaRegs;
+            break;
+
+        case SCI_B:
+            p_sciRegs = &ScibRegs;
+            break;
+
+        case SCI_C:
+            p_sciRegs = &ScicRegs;
+            break;
+
+        default:
+            break;
+    }
+
+    if (p_sciRegs != NULL)
+    {
+        // Same error handling as the receive interrupt.
+        if (p_sciRegs->SCIRXST.bit.RXERROR != 0u)
+        {
+            p_sciRegs->SCICTL1.bit.SWRESET = 0u;
+            p_sciRegs->SCICTL1.bit.SWRESET = 1u;
+        }
+        else
+        {
+            receivedWords = p_sciRegs->SCIFFRX.bit.RXFFST;
+
+            for (readCounter = 0u; readCounter < receivedWords; readCounter++)
+            {
+                RxIntPutCharInBufferAndCheckIt(module, p_sciRegs->SCIRXBUF.all);
+            }
+        }
+    }
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * SCI_RxInterruptA_ISR is the interrupt service routine for the receiver of
@@ -880,8 +1146,12 @@ static inline void RxInterruptHandler(const ESCIModule_t module,
 // ----------------------------------------------------------------------------
 /**
  * RxIntPutCharInBufferAndCheckIt is called from the receive interrupt handler
- * above, and puts a received character in the receive buffer, and also checks
- * to see whether the character matches the match character.
+ * above, and puts a received character in the receive ring buffer, and also
+ * checks to see whether the character matches the match character.
+ * If the ring is full the character is thrown away and counted as an overrun,
+ * so that characters the reader hasn't released yet are never overwritten.
+ * The character is written before the head index is moved on, so the reader
+ * never sees a character which hasn't been written.
  *
  * @note
  * This function is declared as inline, but will only be compiled inline if
@@ -897,10 +1167,12 @@ static inline void RxInterruptHandler(const ESCIModule_t module,
  *
  */
 // ----------------------------------------------------------------------------
+#pragma CODE_SECTION(RxIntPutCharInBufferAndCheckIt, "ramfuncs")
 static inline void RxIntPutCharInBufferAndCheckIt(const ESCIModule_t module,
                                                   const uint16_t dataWord)
 {
-    uint8_t receivedData;
+    uint8_t     receivedData;
+    uint16_t    head;
 
 #ifdef FREE_RTOS_USED
     BaseType_t  higherPriorityTaskWoken;
@@ -910,8 +1182,7 @@ static inline void RxIntPutCharInBufferAndCheckIt(const ESCIModule_t module,
      * Note that the top bits in the data word read from the receive buffer
      * tell us if we've had any FIFO receive error.
      * If either FIFO error bit is set then just ignore the new word,
-     * otherwise store the next received word in the receiver buffer
-     * plus a null character after the received word.
+     * otherwise store the next received word in the receive ring buffer.
      */
     if ( (0u == (dataWord & SCIRXBUF_ERROR_BIT_MASK))
             && (m_serialPorts[module].p_rxBuffer != NULL) )
@@ -919,20 +1190,21 @@ static inline void RxIntPutCharInBufferAndCheckIt(const ESCIModule_t module,
         //lint -e{921} Cast to uint8_t to remove top bits.
         receivedData = (uint8_t)(dataWord & 0x00FFu);
 
-        m_serialPorts[module].p_rxBuffer[m_serialPorts[module].rxOffset]
-            = receivedData;
+        head = m_serialPorts[module].rxHead;
 
-        m_serialPorts[module].p_rxBuffer[m_serialPorts[module].rxOffset + 1u]
-            = 0x00u;
+        //lint -e{921} Cast to keep the wrap around in 16 bits.
+        if ((uint16_t)(head - m_serialPorts[module].rxTail)
+                < m_serialPorts[module].rxMaxLength)
+        {
+            m_serialPorts[module].p_rxBuffer[head
+                & (m_serialPorts[module].rxMaxLength - 1u)] = receivedData;
 
-        /*
-         * Increment the offset if we haven't reached the end of the
-         * buffer - uses -2 to make sure we leave room for the '\0'.
-         */
-        if (m_serialPorts[module].rxOffset
-                < (m_serialPorts[module].rxMaxLength - 2u) )
+            //lint -e{921} Cast to keep the wrap around in 16 bits.
+            m_serialPorts[module].rxHead = (uint16_t)(head + 1u);
+        }
+        else
         {
-            m_serialPorts[module].rxOffset++;
+            m_serialPorts[module].rxOverrunCounter++;
         }
 
         if (m_serialPorts[module].b_matchRequired
@@ -20,25 +20,41 @@
 #include "tool_specific_config.h"
 #include "timer.h"
 #include "tool_specific_hardware.h"
-#include "dsp_crc.h"
+#include "tool_specific_programming.h"
+#include "prom_hardware.h"
+#include "image_verify.h"
 
 
 // ----------------------------------------------------------------------------
 // Defines section
 // Add all #defines here
 
+#define SELF_TEST_BOOTLOADER_IMAGE      0u      // Index of bootloader image.
+#define SELF_TEST_APPLICATION_IMAGE     1u      // Index of application image.
+#define SELF_TEST_NUMBER_OF_IMAGES      2u      // Number of images checked.
+
+// State of the background CRC calculation for one image.
+typedef struct BackgroundVerify
+{
+    bool_t              bPending;   // CRC still to be calculated.
+    Uint16              Partition;  // Partition number of the image.
+    ImageVerifyCRC_t    CRC;        // CRC so far.
+} BackgroundVerify_t;
 
 // ----------------------------------------------------------------------------
 // Function prototypes for functions which only have scope within this module
 
-static Uint16 CalculateBootloaderCRC(void);
-static Uint16 CalculateApplicationCRC(void);
+static Uint16 CalculateImageCRC(Uint32 StartAddress, Uint32 Length);
+static void   BackgroundVerifyStart(Uint16 Image, Uint16 Partition,
+                                    Uint32 StartAddress, Uint32 Length);
+static void   ResultUpdate(Uint16 Image, Uint16 ActualCRC);
 
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module
 
 static SelfTestResult_t mSelfTestResult;
+static BackgroundVerify_t mBackgroundVerify[SELF_TEST_NUMBER_OF_IMAGES];
 
 
 // ----------------------------------------------------------------------------
@@ -50,6 +66,12 @@ static SelfTestResult_t mSelfTestResult;
  * @note
  * SelfTest_TestExecute tests the SCI port, bootloader CRC and application CRC,
  * and populates the structure mSelfTest result accordingly.
+ * If an image has an intact verified image descriptor which matches its
+ * expected CRC, the image is trusted straight away and its CRC is calculated
+ * in the background by SelfTest_BackgroundVerifyStep(), which keeps the full
+ * CRC off the boot path.  Otherwise the CRC is calculated here, and if it is
+ * good a descriptor is written so that the next boot can skip it.  A full
+ * descriptor log is reported on the debug port.
  *
  */
 // ----------------------------------------------------------------------------
@@ -65,28 +87,57 @@ void SelfTest_TestExecute(void)
     mSelfTestResult.ISBPort_Status = ToolSpecificHardware_ISBPortSelfTest();
 #endif
 
-    mSelfTestResult.ActualBootloaderCRC = CalculateBootloaderCRC();
-    mSelfTestResult.ActualApplicationCRC = CalculateApplicationCRC();
     mSelfTestResult.ExpectedBootloaderCRC = *((Uint16*)BOOTLOADER_CRC_ADDRESS);
     mSelfTestResult.ExpectedApplicationCRC = *((Uint16*)APPLICATION_CRC_ADDRESS);
+    mSelfTestResult.bImagesVerified = TRUE;
+    mBackgroundVerify[SELF_TEST_BOOTLOADER_IMAGE].bPending = FALSE;
+    mBackgroundVerify[SELF_TEST_APPLICATION_IMAGE].bPending = FALSE;
 
-    if (mSelfTestResult.ActualBootloaderCRC == mSelfTestResult.ExpectedBootloaderCRC)
+    if (ImageVerify_DescriptorTrustedCheck(BOOT_PARTITION, BOOTLOADER_LENGTH,
+                                           mSelfTestResult.ExpectedBootloaderCRC) == TRUE)
     {
-    	mSelfTestResult.bBootloaderCRCIsOK = TRUE;
+        BackgroundVerifyStart(SELF_TEST_BOOTLOADER_IMAGE, BOOT_PARTITION,
+                              BOOTLOADER_START_ADDRESS, BOOTLOADER_LENGTH);
     }
     else
     {
-    	mSelfTestResult.bBootloaderCRCIsOK = FALSE;
+        ResultUpdate(SELF_TEST_BOOTLOADER_IMAGE,
+                     CalculateImageCRC(BOOTLOADER_START_ADDRESS, BOOTLOADER_LENGTH));
+
+        if (mSelfTestResult.bBootloaderCRCIsOK == TRUE)
+        {
+            (void)ImageVerify_DescriptorWrite(BOOT_PARTITION, BOOTLOADER_LENGTH,
+                                              mSelfTestResult.ActualBootloaderCRC);
+        }
     }
 
-    if (mSelfTestResult.ActualApplicationCRC == mSelfTestResult.ExpectedApplicationCRC)
+    if (ImageVerify_DescriptorTrustedCheck(APPLICATION_PARTITION, APPLICATION_LENGTH,
+                                           mSelfTestResult.ExpectedApplicationCRC) == TRUE)
     {
-    	mSelfTestResult.bApplicationCRCIsOK = TRUE;
+        BackgroundVerifyStart(SELF_TEST_APPLICATION_IMAGE, APPLICATION_PARTITION,
+                              APPLICATION_START_ADDRESS, APPLICATION_LENGTH);
     }
     else
     {
-    	mSelfTestResult.bApplicationCRCIsOK = FALSE;
+        ResultUpdate(SELF_TEST_APPLICATION_IMAGE,
+                     CalculateImageCRC(APPLICATION_START_ADDRESS, APPLICATION_LENGTH));
+
+        if (mSelfTestResult.bApplicationCRCIsOK == TRUE)
+        {
+            (void)ImageVerify_DescriptorWrite(APPLICATION_PARTITION, APPLICATION_LENGTH,
+                                              mSelfTestResult.ActualApplicationCRC);
+        }
+    }
+
+    // With a full log, images programmed from now on can never be trusted.
+    mSelfTestResult.bDescriptorLogFull = ImageVerify_LogFullCheck();
+
+#ifdef COMM_DEBUG
+    if (mSelfTestResult.bDescriptorLogFull == TRUE)
+    {
+        ToolSpecificHardware_DebugMessageSend("SELF TEST: image descriptor log full - program the parameters to clear it\r");
     }
+#endif
 
 #ifdef _WEI_DEBUG
     //Print out crcs
@@ -162,6 +213,77 @@ const SelfTestResult_t* SelfTest_ResultPointerGet(void)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * SelfTest_BackgroundVerifyStep calculates the next SELF_TEST_BACKGROUND_WORDS
+ * of the CRC of any image which was trusted from its verified image descriptor.
+ * When an image is complete its result is updated - if the CRC turns out to be
+ * bad, the image is marked as invalid and its descriptor is retired so that it
+ * won't be trusted again.
+ * This is called while the bootloader is waiting for a message.
+ *
+ * @retval	bool_t	TRUE if all images have been verified, FALSE if not.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t SelfTest_BackgroundVerifyStep(void)
+{
+	BackgroundVerify_t*	pVerify;
+	Uint16				Image;
+	bool_t				bStepDone = FALSE;
+	bool_t				bAllVerified = TRUE;
+
+	for (Image = 0u; Image < SELF_TEST_NUMBER_OF_IMAGES; Image++)
+	{
+		pVerify = &mBackgroundVerify[Image];
+
+		if ( (pVerify->bPending == TRUE) && (bStepDone == FALSE) )
+		{
+			if (ImageVerify_CRCStep(&pVerify->CRC, SELF_TEST_BACKGROUND_WORDS) == TRUE)
+			{
+				pVerify->bPending = FALSE;
+				ResultUpdate(Image, pVerify->CRC.RunningCRC);
+
+				if ( ( (Image == SELF_TEST_BOOTLOADER_IMAGE) && (mSelfTestResult.bBootloaderCRCIsOK == FALSE) )
+						|| ( (Image == SELF_TEST_APPLICATION_IMAGE) && (mSelfTestResult.bApplicationCRCIsOK == FALSE) ) )
+				{
+					(void)ImageVerify_DescriptorRetire(pVerify->Partition);
+				}
+			}
+
+			bStepDone = TRUE;
+		}
+
+		if (pVerify->bPending == TRUE)
+		{
+			bAllVerified = FALSE;
+		}
+	}
+
+	mSelfTestResult.bImagesVerified = bAllVerified;
+
+	return bAllVerified;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * SelfTest_VerificationComplete finishes off any background CRC calculation,
+ * for when the real CRCs are needed straight away.
+ *
+ */
+// ----------------------------------------------------------------------------
+void SelfTest_VerificationComplete(void)
+{
+	while (SelfTest_BackgroundVerifyStep() == FALSE)
+	{
+		// Keep calculating.
+	}
+}
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 // FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
@@ -169,38 +291,89 @@ const SelfTestResult_t* SelfTest_ResultPointerGet(void)
 // ----------------------------------------------------------------------------
 /**
  * @note
- * CalculateBootloaderCRC calculates the CRC of the bootloader area of memory.
+ * CalculateImageCRC calculates the CRC of an image area of memory in one go.
  *
- * @retval	Uint16		Bootloader CRC.
+ * @param	StartAddress	Start address of the image.
+ * @param	Length			Length of the image in words.
+ * @retval	Uint16			Image CRC.
  *
  */
 // ----------------------------------------------------------------------------
-static Uint16 CalculateBootloaderCRC(void)
+static Uint16 CalculateImageCRC(Uint32 StartAddress, Uint32 Length)
 {
-    Uint16 CRC;
+    ImageVerifyCRC_t CRC;
 
-    CRC = crc_calcRunningCRC(0, (Uint16*)BOOTLOADER_START_ADDRESS, BOOTLOADER_LENGTH, WORD_CRC_CALC);
-    CRC = crc_calcFinalCRC(CRC, WORD_CRC_CALC);
-    return CRC;
+    ImageVerify_CRCStart(&CRC, StartAddress, Length);
+    (void)ImageVerify_CRCStep(&CRC, Length);
+    return CRC.RunningCRC;
 }
 
 
 // ----------------------------------------------------------------------------
 /**
  * @note
- * CalculateApplicationCRC calculates the CRC of the application area of memory.
+ * BackgroundVerifyStart trusts an image from its verified image descriptor,
+ * and sets up the background CRC calculation for it.
  *
- * @retval	Uint16		Application CRC.
+ * @param	Image			Image index (bootloader or application).
+ * @param	Partition		Partition number of the image.
+ * @param	StartAddress	Start address of the image.
+ * @param	Length			Length of the image in words.
  *
  */
 // ----------------------------------------------------------------------------
-static Uint16 CalculateApplicationCRC(void)
+static void BackgroundVerifyStart(Uint16 Image, Uint16 Partition,
+                                  Uint32 StartAddress, Uint32 Length)
 {
-    Uint16 CRC;
+	mBackgroundVerify[Image].bPending = TRUE;
+	mBackgroundVerify[Image].Partition = Partition;
+	ImageVerify_CRCStart(&mBackgroundVerify[Image].CRC, StartAddress, Length);
+
+	// Descriptor CRC matches the expected CRC, so this is the CRC we expect to find.
+	if (Image == SELF_TEST_BOOTLOADER_IMAGE)
+	{
+		ResultUpdate(Image, mSelfTestResult.ExpectedBootloaderCRC);
+	}
+	else
+	{
+		ResultUpdate(Image, mSelfTestResult.ExpectedApplicationCRC);
+	}
+
+	mSelfTestResult.bImagesVerified = FALSE;
+}
 
-    CRC = crc_calcRunningCRC(0, (Uint16*)APPLICATION_START_ADDRESS, APPLICATION_LENGTH, WORD_CRC_CALC);
-    CRC = crc_calcFinalCRC(CRC, WORD_CRC_CALC);
-    return CRC;
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ResultUpdate stores the actual CRC of an image and compares it against the
+ * expected CRC.
+ *
+ * @param	Image			Image index (bootloader or application).
+ * @param	ActualCRC		Actual CRC of the image.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void ResultUpdate(Uint16 Image, Uint16 ActualCRC)
+{
+	if (Image == SELF_TEST_BOOTLOADER_IMAGE)
+	{
+		mSelfTestResult.ActualBootloaderCRC = ActualCRC;
+		mSelfTestResult.bBootloaderCRCIsOK = FALSE;
+		if (ActualCRC == mSelfTestResult.ExpectedBootloaderCRC)
+		{
+			mSelfTestResult.bBootloaderCRCIsOK = TRUE;
+		}
+	}
+	else
+	{
+		mSelfTestResult.ActualApplicationCRC = ActualCRC;
+		mSelfTestResult.bApplicationCRCIsOK = FALSE;
+		if (ActualCRC == mSelfTestResult.ExpectedApplicationCRC)
+		{
+			mSelfTestResult.bApplicationCRCIsOK = TRUE;
+		}
+	}
 }
 
 
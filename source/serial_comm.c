@@ -26,16 +26,24 @@
 #include "utils.h"
 
 #define SLAVE_ADDRESS_NOT_SET           (0U)
+#define SERIAL_FRAME_HEADER_LENGTH      4u      // Address, length (2 bytes) and opcode, after SOF
+#define SERIAL_FRAME_TRAILER_LENGTH     3u      // Checksum (2 bytes) and end character
 
 static void     TransmitEnable(EBusType_t busType);
 static void     TransmitDisable(EBusType_t busType);
 static void     CommPortByteSend(unsigned char data, EBusType_t busType);
-static bool_t 	CheckForNextSerialCharacter(unsigned char* pCharacter, EBusType_t busType);
+static void     CommPortBufferSend(const unsigned char* pData, Uint16 Count, EBusType_t busType);
 static bool_t 	CheckForStartCharacter(Timer_t* pTimer, EBusType_t busType);
 static bool_t   CheckForSlaveAddress(EBusType_t busType);
+static Uint16   ReceiveSpanGet(Uint16 Offset, const unsigned char** ppData, EBusType_t busType);
+static void     ReceiveSpanRelease(Uint16 Count, EBusType_t busType);
+static bool_t   ReceivedCharactersWait(Uint16 Count, EBusType_t busType);
+static void     ReceivedCharactersCopy(Uint16 Offset, Uint16 Count, unsigned char* pDestination, EBusType_t busType);
 
 static LoaderMessage_t 	mLoaderMessage;
 static Timer_t 			mInterCharacterTimer;
+static Uint16           mReleaseLength = 0u;            // Last message, still in the receive buffer
+static EBusType_t       mReleaseBusType = BUS_UNDEFINED;
 static uint8_t			mSSBSlaveAddress = SSB_SLAVE_ADDRESS;
 static uint8_t          mAltSSBSlaveAddress = SLAVE_ADDRESS_NOT_SET;
 static uint8_t          mISBSlaveAddress = ISB_SLAVE_ADDRESS;
@@ -85,6 +93,31 @@ bool_t serial_StartCharacterReceivedCheck(EBusType_t busType)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * serial_CharacterReceivedCheck checks whether anything has arrived on the
+ * BUS port since the last message, without taking it out of the receive
+ * buffer.  The last message is handed back to the receive interrupt first,
+ * as serial_MessageWait would, so it must have been dealt with.  We don't
+ * wait in here.
+ *
+ * @param   busType     Serial port bus type (ISB or SSB).
+ * @retval	bool_t		TRUE if there is something to read, otherwise FALSE.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t serial_CharacterReceivedCheck(EBusType_t busType)
+{
+    const unsigned char*    pSpan = NULL;
+
+    ReceiveSpanRelease(mReleaseLength, mReleaseBusType);
+    mReleaseLength = 0u;
+
+    return (ReceiveSpanGet(0u, &pSpan, busType) != 0u);
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * @note
@@ -110,6 +143,14 @@ LoaderMessage_t* serial_LoaderMessagePointerGet(void)
  * function (which is used for the overall timeout and timeout waiting for the
  * start) and a local timer which is used for the inter-character timeout.
  *
+ * The message is parsed where the receive interrupt put it, in the receive
+ * ring buffer, rather than being read out a character at a time - we wait for
+ * the header, then for the rest of the frame, then check it in one go.  The
+ * data pointer in the loader message points straight into the ring buffer
+ * (unless the data wraps around the end of the ring, when it is copied into
+ * gRxBuffer), so the message is left in the ring until the next call, when it
+ * has been dealt with.
+ *
  * @param	pExternalTimer					Pointer to external timer structure.
  * @param	bFoundStartCharacterAlready		Look for start character?
  * @param   busType                         Serial port bus type (ISB or SSB)
@@ -121,210 +162,129 @@ EMessageStatus_t serial_MessageWait(Timer_t* pExternalTimer,
                                     bool_t bFoundStartCharacterAlready,
                                     EBusType_t busType)
 {
-    unsigned char 		character;
-    unsigned char 		msgLength[2];
-    unsigned char 		checksumBytes[2];
-    Uint16 				i;
-    Uint16 				dataLength = 0;
-    Uint16 				calculatedChecksum;
-    bool_t 				done = FALSE;
-    EMessageStatus_t 	replyStatus = MESSAGE_OK;
-    Uint16				stateCounter = 0u;
-    bool_t				bStateResetRequired;
+    unsigned char           header[SERIAL_FRAME_HEADER_LENGTH];
+    unsigned char           trailer[SERIAL_FRAME_TRAILER_LENGTH];
+    const unsigned char*    pData = NULL;
+    Uint16                  i;
+    Uint16                  frameLength = 0u;
+    Uint16                  calculatedChecksum;
+    EMessageStatus_t        replyStatus = MESSAGE_OK;
+
+    // The previous message has been dealt with, so hand it back to the
+    // receive interrupt.
+    ReceiveSpanRelease(mReleaseLength, mReleaseBusType);
+    mReleaseLength = 0u;
 
     Timer_TimerSet(&mInterCharacterTimer, (Uint32)COMM_TIMEOUT);
 
-	while (done == FALSE)
-	{
-		bStateResetRequired = FALSE;
-
-		// Note - the state engine executes one state each time is is called
-		// (the while(!done) above ensures we keep looping round).
-		// The stateCounter is incremented at the end of the state engine,
-		// or reset if the bStateResetRequired flag is set.
-		switch (stateCounter)
-		{
-			// Check for the main timer expired - exit if it has.
-			case 0u:
-				if (Timer_TimerExpiredCheck(pExternalTimer) == TRUE)
-				{
-					replyStatus = MESSAGE_TIMEOUT;
-					done = TRUE;
-				}
-				break;
-
-			// Look for the start character (if we need to).
-			// If the main timer has expired then exit.
-			case 1u:
-				if (bFoundStartCharacterAlready == FALSE)
-				{
-					if (CheckForStartCharacter(pExternalTimer, busType) == FALSE)
-					{
-						replyStatus = MESSAGE_TIMEOUT;
-						done = TRUE;
-					}
-				}
-				break;
-
-			// Look for the address.
-			case 2u:
-				if (CheckForNextSerialCharacter(&character, busType) == FALSE)
-				{
-					bStateResetRequired = TRUE;
-				}
-				break;
-
-			// Copy the address which was stored in the previous state, then
-			// look for the length - 2 bytes, dealt with by cases 3 and 4.
-			// Note that the state cannot be incremented unless a character has#
-			// been received
-			case 3u:
-				mLoaderMessage.address = character;									//lint !e644 May not have been initialised
-				if (CheckForNextSerialCharacter(&msgLength[0], busType) == FALSE)
-				{
-					bStateResetRequired = TRUE;
-				}
-				break;
-
-    		// Case 4 also checks that the length is within the proper range.
-			case 4u:
-				if (CheckForNextSerialCharacter(&msgLength[1], busType) == TRUE)
-				{
-					mLoaderMessage.length = utils_toUint16(msgLength, TARGET_ENDIAN_TYPE);
-					if (mLoaderMessage.length > SERIAL_MAX_LENGTH)
-					{
-						ToolSpecificHardware_DebugMessageSend("SERIAL PORT: Invalid Length.\r");
-						replyStatus = MESSAGE_ERROR;
-						done = TRUE;
-					}
-					else
-					{
-					    mLoaderMessage.dataLengthInBytes = mLoaderMessage.length - SERIAL_HEADER_LENGTH;
-					}
-				}
-				else
-				{
-					bStateResetRequired = TRUE;
-				}
-				break;
-
-			// Look for the command.
-			case 5u:
-				if (CheckForNextSerialCharacter(&character, busType) == FALSE)
-				{
-					bStateResetRequired = TRUE;
-				}
-				break;
-
-			// Copy the opcode which was received in the previous state, then
-			// get the data.
-			// warning, long delay here is possible if data length
-			// somehow becomes REALLY long (bad length read).
-			case 6u:
-				mLoaderMessage.opcode = character;
-				dataLength = mLoaderMessage.length - SERIAL_HEADER_LENGTH;
-				for (i = 0; i < dataLength; ++i)
-				{
-					if (CheckForNextSerialCharacter(&gRxBuffer[i], busType) == FALSE)
-					{
-						break;	// Out of for loop.
-					}
-				}
-
-				if (i != dataLength)
-				{
-					ToolSpecificHardware_DebugMessageSend("SERIAL PORT: Timeout waiting for next data character.\r");
-					replyStatus = MESSAGE_TIMEOUT;
-					done = TRUE;
-				}
-				// If we got here, we have all the data.
-				else
-				{
-					mLoaderMessage.dataPtr = gRxBuffer;
-				}
-				break;
-
-			// Read the checksum - 2 bytes, dealt with by cases 7 and 8.
-			case 7u:
-				if (CheckForNextSerialCharacter(&checksumBytes[0], busType) == FALSE)
-				{
-					bStateResetRequired = TRUE;
-				}
-				break;
-
-			case 8u:
-				if (CheckForNextSerialCharacter(&checksumBytes[1], busType) == FALSE)
-				{
-					bStateResetRequired = TRUE;
-				}
-				break;
-
-			// Look for the end character.
-			case 9u:
-				mLoaderMessage.checksum = utils_toUint16(checksumBytes, TARGET_ENDIAN_TYPE);
-				if (CheckForNextSerialCharacter(&character, busType) == TRUE)
-				{
-					if (character != SERIAL_ENDCHAR)
-					{
-						ToolSpecificHardware_DebugMessageSend("SERIAL PORT: No terminating Character.\r");
-						replyStatus = MESSAGE_ERROR;
-						done = TRUE;
-					}
-				}
-				else
-				{
-					bStateResetRequired = TRUE;
-				}
-				break;
-
-			// Check the checksum.
-			case 10u:
-				calculatedChecksum = mLoaderMessage.address + msgLength[0] + msgLength[1] + mLoaderMessage.opcode;	//lint !e644 May not have been initialised
-				for (i = 0; i < mLoaderMessage.dataLengthInBytes; ++i)
-				{
-					calculatedChecksum += mLoaderMessage.dataPtr[i];
-				}
-
-				if (calculatedChecksum != mLoaderMessage.checksum)
-				{
-					ToolSpecificHardware_DebugMessageSend("SERIAL PORT: Checksum Error.\r");
-					replyStatus = MESSAGE_ERROR;
-					done = TRUE;
-				}
-				break;
-
-			// Check the slave address.
-			// Note - according to the opcodes specification, opcode zero is to be treated
-			// as a broadcast address.  This doesn't work with multiple slaves, so is not
-			// implemented here unless the ALLOW_BROADCAST macro is defined in the tool configuration.
-			case 11u:
-
-                if ( !CheckForSlaveAddress( busType ) )
-                {
-                    ToolSpecificHardware_DebugMessageSend( "SERIAL PORT: Slave Address Error.\r" );
-                    replyStatus = MESSAGE_ERROR;
-                }
-
-                done = TRUE;
-                break;
+    // Check for the main timer expired - exit if it has.
+    if (Timer_TimerExpiredCheck(pExternalTimer) == TRUE)
+    {
+        replyStatus = MESSAGE_TIMEOUT;
+    }
+    // Look for the start character (if we need to).
+    else if ( (bFoundStartCharacterAlready == FALSE)
+                && (CheckForStartCharacter(pExternalTimer, busType) == FALSE) )
+    {
+        replyStatus = MESSAGE_TIMEOUT;
+    }
+    // Wait for the address, the length and the opcode.
+    else if (ReceivedCharactersWait(SERIAL_FRAME_HEADER_LENGTH, busType) == FALSE)
+    {
+        ToolSpecificHardware_DebugMessageSend("SERIAL PORT: Timeout waiting for header.\r");
+        replyStatus = MESSAGE_TIMEOUT;
+    }
+    else
+    {
+        ReceivedCharactersCopy(0u, SERIAL_FRAME_HEADER_LENGTH, header, busType);
+        mLoaderMessage.address = header[0];
+        mLoaderMessage.length = utils_toUint16(&header[1], TARGET_ENDIAN_TYPE);
+        mLoaderMessage.opcode = header[3];
+
+        // Check that the length is within the proper range - anything else
+        // is left in the buffer, to be skipped while looking for the next SOF.
+        if ( (mLoaderMessage.length > SERIAL_MAX_LENGTH)
+                || (mLoaderMessage.length < SERIAL_HEADER_LENGTH) )
+        {
+            ToolSpecificHardware_DebugMessageSend("SERIAL PORT: Invalid Length.\r");
+            replyStatus = MESSAGE_ERROR;
+        }
+        else
+        {
+            mLoaderMessage.dataLengthInBytes = mLoaderMessage.length - SERIAL_HEADER_LENGTH;
+            frameLength = SERIAL_FRAME_HEADER_LENGTH + mLoaderMessage.dataLengthInBytes
+                            + SERIAL_FRAME_TRAILER_LENGTH;
+        }
+    }
+
+    // Wait for the data, the checksum and the end character.
+    if (replyStatus == MESSAGE_OK)
+    {
+        if (ReceivedCharactersWait(frameLength, busType) == FALSE)
+        {
+            ToolSpecificHardware_DebugMessageSend("SERIAL PORT: Timeout waiting for next data character.\r");
+            replyStatus = MESSAGE_TIMEOUT;
+        }
+        else
+        {
+            // From here on the whole frame is thrown away with the message.
+            mReleaseLength = frameLength;
+            mReleaseBusType = busType;
+
+            ReceivedCharactersCopy(frameLength - SERIAL_FRAME_TRAILER_LENGTH,
+                                   SERIAL_FRAME_TRAILER_LENGTH, trailer, busType);
+            mLoaderMessage.checksum = utils_toUint16(trailer, TARGET_ENDIAN_TYPE);
+
+            if (trailer[2] != SERIAL_ENDCHAR)
+            {
+                ToolSpecificHardware_DebugMessageSend("SERIAL PORT: No terminating Character.\r");
+                replyStatus = MESSAGE_ERROR;
+            }
+        }
+    }
 
-			default:
-				bStateResetRequired = TRUE;
-				break;
+    // Point at the data in place if it's contiguous in the ring, otherwise
+    // copy it out, then check the checksum.
+    if (replyStatus == MESSAGE_OK)
+    {
+        if ( (mLoaderMessage.dataLengthInBytes != 0u)
+                && (ReceiveSpanGet(SERIAL_FRAME_HEADER_LENGTH, &pData, busType)
+                        >= mLoaderMessage.dataLengthInBytes) )
+        {
+            mLoaderMessage.dataPtr = (unsigned char*)pData;				//lint !e929 The ring buffer is writeable.
+        }
+        else
+        {
+            ReceivedCharactersCopy(SERIAL_FRAME_HEADER_LENGTH, mLoaderMessage.dataLengthInBytes,
+                                   gRxBuffer, busType);
+            mLoaderMessage.dataPtr = gRxBuffer;
+        }
+
+        calculatedChecksum = mLoaderMessage.address + header[1] + header[2] + mLoaderMessage.opcode;
+        for (i = 0; i < mLoaderMessage.dataLengthInBytes; ++i)
+        {
+            calculatedChecksum += mLoaderMessage.dataPtr[i];
         }
 
-		// Reset or increment the state counter
-		// (depending on what happened above in the current state).
-		// Generally the state is reset if we've timed out waiting for a character.
-		if (bStateResetRequired == TRUE)
-		{
-			stateCounter = 0u;
-		}
-		else
-		{
-			stateCounter++;
-		}
-	}
+        if (calculatedChecksum != mLoaderMessage.checksum)
+        {
+            ToolSpecificHardware_DebugMessageSend("SERIAL PORT: Checksum Error.\r");
+            replyStatus = MESSAGE_ERROR;
+        }
+    }
+
+    // Check the slave address.
+    // Note - according to the opcodes specification, opcode zero is to be treated
+    // as a broadcast address.  This doesn't work with multiple slaves, so is not
+    // implemented here unless the ALLOW_BROADCAST macro is defined in the tool configuration.
+    if (replyStatus == MESSAGE_OK)
+    {
+        if ( !CheckForSlaveAddress( busType ) )
+        {
+            ToolSpecificHardware_DebugMessageSend( "SERIAL PORT: Slave Address Error.\r" );
+            replyStatus = MESSAGE_ERROR;
+        }
+    }
 
 	return replyStatus;
 }
@@ -390,6 +350,87 @@ void serial_MessageSend(Uint8 status, Uint16 length, char * data, EBusType_t bus
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * serial_StreamStart enables the SSB or ISB transmit, ready to send a stream
+ * of messages with serial_StreamMessageSend.
+ *
+ * @param   busType     Enumerated type for the bus type
+ *
+ */
+// ----------------------------------------------------------------------------
+void serial_StreamStart(EBusType_t busType)
+{
+    // Enable transmission (includes delay).
+    TransmitEnable(busType);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * serial_StreamMessageSend builds a message around the data in pFrame, which
+ * starts LOADER_STREAM_PREFIX_LENGTH bytes in and is followed by
+ * LOADER_STREAM_SUFFIX_LENGTH spare bytes, and starts sending the whole
+ * message once the previous one has been taken by the transmitter.  It
+ * doesn't wait for the message to be sent, so pFrame must be left alone until
+ * the next call has returned.  serial_StreamStart must be called first, and
+ * serial_StreamEnd after the last message.
+ *
+ * @note
+ * The length isn't checked here - the caller must keep it within
+ * COMM_MAX_LENGTH, as that's the most any message may carry.
+ *
+ * @param   status      Status of returned message.
+ * @param   length      Number of bytes of data in pFrame.
+ * @param   pFrame      Pointer to buffer holding the data.
+ * @param   busType     Enumerated type for the bus type
+ *
+ */
+// ----------------------------------------------------------------------------
+void serial_StreamMessageSend(Uint8 status, Uint16 length, unsigned char * pFrame, EBusType_t busType)
+{
+    Uint16          checksum;
+    Uint16          i;
+    unsigned char*  pSuffix = &pFrame[LOADER_STREAM_PREFIX_LENGTH + length];
+
+    // Build the header in front of the data.
+    pFrame[0] = SERIAL_STARTCHAR;
+    pFrame[1] = mLoaderMessage.address;
+    utils_to2Bytes(&pFrame[2], (Uint16)(length + SERIAL_HEADER_LENGTH), TARGET_ENDIAN_TYPE);
+    pFrame[4] = status;
+
+    // Calculate checksum, which covers the header (after SOF) and the data.
+    checksum = 0u;
+    for (i = 1u; i < (LOADER_STREAM_PREFIX_LENGTH + length); ++i)
+    {
+        checksum += (Uint16)pFrame[i];
+    }
+
+    // Add the checksum and the end character after the data.
+    utils_to2Bytes(pSuffix, checksum, TARGET_ENDIAN_TYPE);
+    pSuffix[2] = SERIAL_ENDCHAR;
+
+    CommPortBufferSend(pFrame, LOADER_STREAM_PREFIX_LENGTH + length + LOADER_STREAM_SUFFIX_LENGTH,
+                       busType);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * serial_StreamEnd waits for the last message of a stream to be sent and
+ * then disables the SSB or ISB transmit.
+ *
+ * @param   busType     Enumerated type for the bus type
+ *
+ */
+// ----------------------------------------------------------------------------
+void serial_StreamEnd(EBusType_t busType)
+{
+    // Disable transmission (this waits for transmit done before disabling).
+    TransmitDisable(busType);
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * @note
@@ -578,42 +619,38 @@ static void CommPortByteSend(unsigned char data, EBusType_t busType)
 // ----------------------------------------------------------------------------
 /**
  * @note
- * CheckForNextSSBCharacter polls the SSB/ISB port, looking for the next character,
- * until either we've received a character or the inter-character timer has
- * expired.
+ * CommPortBufferSend starts sending a buffer on the SSB or ISB port, without
+ * waiting for it to be sent.
  *
- * @param	pCharacter		Pointer to write received character into.
- *          busType         Bus Type
- * @retval	bool_t			TRUE if character received, FALSE if timed out.
+ * @param   pData       Pointer to the characters to send.
+ * @param   Count       Number of characters to send.
+ * @param   busType     Bus Type
  *
  */
 // ----------------------------------------------------------------------------
-static bool_t CheckForNextSerialCharacter(unsigned char* pCharacter, EBusType_t busType)
+static void CommPortBufferSend(const unsigned char* pData, Uint16 Count, EBusType_t busType)
 {
-    Timer_TimerReset(&mInterCharacterTimer);
-
-    if ( BUS_SSB == busType )
+    if (BUS_SSB == busType)
     {
-        return ToolSpecificHardware_SSBPortCharacterReceiveByPolling( pCharacter , &mInterCharacterTimer);
+        ToolSpecificHardware_SSBPortBufferSend(pData, Count);
     }
-    else if ( BUS_ISB == busType )
+    else if (BUS_ISB == busType)
     {
-        return ToolSpecificHardware_ISBPortCharacterReceiveByPolling( pCharacter , &mInterCharacterTimer);
+        ToolSpecificHardware_ISBPortBufferSend(pData, Count);
     }
     else
     {
         // Do nothing if we're not SSB or ISB.
     }
-
-    return FALSE;
 }
 
 
 // ----------------------------------------------------------------------------
 /**
  * @note
- * CheckForStartCharacter polls the SSB port, looking for the start of frame
- * character, until we've either received SOF or the timer has expired.
+ * CheckForStartCharacter searches the SSB/ISB receive buffer for the start of
+ * frame character, until we've either received SOF or the timer has expired.
+ * Everything up to and including SOF is thrown away.
  *
  * @param	pTimer			Pointer to timer structure to check for expiry.
  *          busType         Bus Type
@@ -623,37 +660,28 @@ static bool_t CheckForNextSerialCharacter(unsigned char* pCharacter, EBusType_t
 // ----------------------------------------------------------------------------
 static bool_t CheckForStartCharacter(Timer_t* pTimer, EBusType_t busType)
 {
-	bool_t			bGotStartCharacter = FALSE;
-	unsigned char	character;
-	bool_t          status;
+	bool_t			        bGotStartCharacter = FALSE;
+	bool_t                  bTimerHasTimedOut = FALSE;
+	const unsigned char*    pSpan = NULL;
+	Uint16                  spanLength;
+	Uint16                  i;
 
-    // Look for start character.
-    while (bGotStartCharacter == FALSE)
+    while ( (bGotStartCharacter == FALSE) && (bTimerHasTimedOut == FALSE) )
     {
-    	// If a new character received then check to see if it's SOF.
-    	// Note that ToolSpecificHardware_SSBPortCharacterReceiveByPolling
-    	// returns TRUE for any character received, not just SOF!!
-        if ( BUS_SSB == busType )
-        {
-            status = ToolSpecificHardware_SSBPortCharacterReceiveByPolling( &character , pTimer);
-        }
-        else if ( BUS_ISB == busType )
-        {
-            status = ToolSpecificHardware_ISBPortCharacterReceiveByPolling( &character , pTimer);
-        }
+        bTimerHasTimedOut = Timer_TimerExpiredCheck(pTimer);
 
-        if ( status != FALSE)
+        spanLength = ReceiveSpanGet(0u, &pSpan, busType);
+        for (i = 0u; i < spanLength; i++)
         {
-            if (character == SERIAL_STARTCHAR)
+            if (pSpan[i] == SERIAL_STARTCHAR)
             {
                 bGotStartCharacter = TRUE;
+                i++;
+                break;
             }
         }
-        // If here then we've timed out, so jump out of while loop.
-        else
-        {
-            break;
-        }
+
+        ReceiveSpanRelease(i, busType);
     }
 
     return bGotStartCharacter;
@@ -701,5 +729,158 @@ static bool_t CheckForSlaveAddress(EBusType_t busType)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ReceiveSpanGet gets the characters in the SSB/ISB receive buffer which can
+ * be read in place, starting Offset characters after the oldest one.
+ *
+ * @param   Offset          Number of received characters to skip.
+ * @param   ppData          Pointer to the first character is written here.
+ *          busType         Bus Type
+ * @retval  Uint16          Number of contiguous characters, zero if none.
+ *
+ */
+// ----------------------------------------------------------------------------
+static Uint16 ReceiveSpanGet(Uint16 Offset, const unsigned char** ppData, EBusType_t busType)
+{
+    Uint16  spanLength = 0u;
+
+    if ( BUS_SSB == busType )
+    {
+        spanLength = ToolSpecificHardware_SSBPortReceiveSpanGet(Offset, ppData);
+    }
+    else if ( BUS_ISB == busType )
+    {
+        spanLength = ToolSpecificHardware_ISBPortReceiveSpanGet(Offset, ppData);
+    }
+    else
+    {
+        // Do nothing if we're not SSB or ISB.
+    }
+
+    return spanLength;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ReceiveSpanRelease throws away the oldest characters in the SSB/ISB receive
+ * buffer, once they have been dealt with.
+ *
+ * @param   Count           Number of characters to throw away.
+ *          busType         Bus Type
+ *
+ */
+// ----------------------------------------------------------------------------
+static void ReceiveSpanRelease(Uint16 Count, EBusType_t busType)
+{
+    if ( BUS_SSB == busType )
+    {
+        ToolSpecificHardware_SSBPortReceiveSpanRelease(Count);
+    }
+    else if ( BUS_ISB == busType )
+    {
+        ToolSpecificHardware_ISBPortReceiveSpanRelease(Count);
+    }
+    else
+    {
+        // Do nothing if we're not SSB or ISB.
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ReceivedCharactersWait waits until there are at least Count characters in
+ * the SSB/ISB receive buffer.  The inter-character timer is restarted every
+ * time more characters turn up, so we only time out if the characters stop.
+ *
+ * @param   Count           Number of characters to wait for.
+ *          busType         Bus Type
+ * @retval  bool_t          TRUE if the characters are there, FALSE if timed out.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t ReceivedCharactersWait(Uint16 Count, EBusType_t busType)
+{
+    const unsigned char*    pSpan = NULL;
+    Uint16                  received;
+    Uint16                  previouslyReceived;
+    bool_t                  bTimerHasTimedOut = FALSE;
+
+    Timer_TimerReset(&mInterCharacterTimer);
+
+    // The characters may wrap around the end of the buffer, in which case
+    // there are two spans.
+    received = ReceiveSpanGet(0u, &pSpan, busType);
+    received += ReceiveSpanGet(received, &pSpan, busType);
+    previouslyReceived = received;
+
+    while ( (received < Count) && (bTimerHasTimedOut == FALSE) )
+    {
+        if (received != previouslyReceived)
+        {
+            Timer_TimerReset(&mInterCharacterTimer);
+            previouslyReceived = received;
+        }
+        else
+        {
+            bTimerHasTimedOut = Timer_TimerExpiredCheck(&mInterCharacterTimer);
+        }
+
+        received = ReceiveSpanGet(0u, &pSpan, busType);
+        received += ReceiveSpanGet(received, &pSpan, busType);
+    }
+
+    return (received >= Count) ? TRUE : FALSE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ReceivedCharactersCopy copies characters out of the SSB/ISB receive buffer,
+ * without throwing them away.  The characters must already have been received.
+ *
+ * @param   Offset          Number of received characters to skip.
+ * @param   Count           Number of characters to copy.
+ * @param   pDestination    Pointer to buffer to copy the characters into.
+ *          busType         Bus Type
+ *
+ */
+// ----------------------------------------------------------------------------
+static void ReceivedCharactersCopy(Uint16 Offset, Uint16 Count, unsigned char* pDestination, EBusType_t busType)
+{
+    const unsigned char*    pSpan = NULL;
+    Uint16                  spanLength;
+    Uint16                  i;
+
+    while (Count != 0u)
+    {
+        spanLength = ReceiveSpanGet(Offset, &pSpan, busType);
+        if (spanLength == 0u)
+        {
+            break;
+        }
+
+        if (spanLength > Count)
+        {
+            spanLength = Count;
+        }
+
+        for (i = 0u; i < spanLength; i++)
+        {
+            *pDestination++ = pSpan[i];
+        }
+
+        Offset += spanLength;
+        Count -= spanLength;
+    }
+}
+
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -36,6 +36,20 @@
 
 #define SPISTS_SPIINT_BIT_MASK		0x0040u	///< SPIINT is bit 6
 
+#define SPIFFTX_SPIRST_BIT_MASK		0x8000u	///< SPIRST is bit 15
+#define SPIFFTX_SPIFFENA_BIT_MASK	0x4000u	///< SPIFFENA is bit 14
+#define SPIFFTX_TXFIFO_BIT_MASK		0x2000u	///< TXFIFO (reset, active low) is bit 13
+#define SPIFFTX_TXFFINTCLR_BIT_MASK	0x0040u	///< TXFFINTCLR is bit 6
+
+#define SPIFFRX_RXFFOVFCLR_BIT_MASK	0x4000u	///< RXFFOVFCLR is bit 14
+#define SPIFFRX_RXFIFORESET_BIT_MASK	0x2000u	///< RXFIFORESET (active low) is bit 13
+#define SPIFFRX_RXFFST_BIT_MASK		0x1F00u	///< RXFFST is bits 12:8
+#define SPIFFRX_RXFFST_SHIFT		8u		///< Shift to right justify RXFFST
+#define SPIFFRX_RXFFINTCLR_BIT_MASK	0x0040u	///< RXFFINTCLR is bit 6
+#define SPIFFRX_RXFFIL_DEFAULT		0x0001u	///< RX FIFO interrupt depth, as set by SPI_Open
+
+#define SPI_FIFO_DEPTH				16u		///< Words in each of the TX and RX FIFOs
+
 #define EEPROM_ACTIVE_STATE_SET 	GpioDataRegs.GPBCLEAR.bit.GPIO57 ///< Sets the EEPROM SPISTE pin into the active state.
 #define EEPROM_INACTIVE_STATE_SET 	GpioDataRegs.GPBSET.bit.GPIO57	 ///< Sets the EEPROM SPISTE pin into the inactive state.
 
@@ -48,6 +62,7 @@
 
 static void ResetAllSPIRegisters(void);
 static void WaitForSPIReady(void);
+static void FIFOModeSet(const bool_t bEnable);
 
 
 // ----------------------------------------------------------------------------
@@ -73,7 +88,8 @@ static const uint16_t	mReceiveBitMask[16] = {	0x0001u, 0x0003u, 0x0007u, 0x000Fu
 /**
  * @note
  * SPI_Open opens the SPI serial port (SPI-A) on the 28335.
- * Interrupts and FIFOs are not currently used.
+ * Interrupts are not currently used, and the FIFOs are only used by
+ * SPI_TransferBlock.
  *
 */
 // ----------------------------------------------------------------------------
@@ -326,6 +342,84 @@ void SPI_Write(uint16_t DataToWrite)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * SPI_TransferBlock transmits and receives a block of words through the SPI
+ * port, using the 16 level FIFOs so that the words go out back to back.
+ *
+ * The transmit FIFO is kept topped up while the receive FIFO is emptied, but
+ * never with more words on their way than the receive FIFO can hold, so
+ * nothing is lost if the CPU is held up.  The FIFOs are only enabled for the
+ * length of the block - SPI_Read() and SPI_Write() still use the SPI one word
+ * at a time.  This returns once the last word has been received.
+ *
+ * @warning
+ * This function does not drive the SPISTE pin - it is the responsibility of
+ * the next software layer up to do this, as for SPI_Read() and SPI_Write().
+ *
+ * @param	p_tx_buffer		Words to transmit, or NULL to transmit zeros.
+ * @param	p_rx_buffer		Buffer for the words received, or NULL to discard them.
+ * @param	NumberOfWords	Number of words to transfer.
+ *
+ */
+// ----------------------------------------------------------------------------
+void SPI_TransferBlock(const uint8_t * const p_tx_buffer,
+						uint8_t * const p_rx_buffer,
+						const uint32_t NumberOfWords)
+{
+	uint32_t	TxCounter = 0u;
+	uint32_t	RxCounter = 0u;
+	uint16_t	ShiftQty;
+	uint16_t	TxData = 0u;
+	uint16_t	RxData;
+	uint16_t	WordsReceived;
+
+	// Data to transmit must be left justified in the transmit buffer.
+	ShiftQty = 16u - mNumberOfSPIDataBits;
+
+	FIFOModeSet(TRUE);
+
+	while (RxCounter < NumberOfWords)
+	{
+		// Top up the transmit FIFO.
+		while ( (TxCounter < NumberOfWords)
+				&& ((TxCounter - RxCounter) < SPI_FIFO_DEPTH) )
+		{
+			if (p_tx_buffer != NULL)
+			{
+				//lint -e{921} Cast from uint8_t to uint16_t.
+				TxData = (uint16_t)p_tx_buffer[TxCounter] << ShiftQty;
+			}
+
+			genericIO_16bitWrite( (SPI_A_BASE_ADDRESS + SPITXBUF_OFFSET), TxData);
+			TxCounter++;
+		}
+
+		// Empty whatever has been received so far.
+		WordsReceived = genericIO_16bitRead(SPI_A_BASE_ADDRESS + SPIFFRX_OFFSET);
+		WordsReceived = (WordsReceived & SPIFFRX_RXFFST_BIT_MASK) >> SPIFFRX_RXFFST_SHIFT;
+
+		while (WordsReceived != 0u)
+		{
+			RxData  = genericIO_16bitRead(SPI_A_BASE_ADDRESS + SPIRXBUF_OFFSET);
+			RxData &= mReceiveBitMask[mNumberOfSPIDataBits - 1u];
+
+			if (p_rx_buffer != NULL)
+			{
+				//lint -e{921} Cast from uint16_t to uint8_t.
+				p_rx_buffer[RxCounter] = (uint8_t)RxData;
+			}
+
+			RxCounter++;
+			WordsReceived--;
+		}
+	}
+
+	FIFOModeSet(FALSE);
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * SPI_EEPROMActiveSet sets the EEPROM SPISTE pin into the active (low) state, by
@@ -459,3 +553,39 @@ static void WaitForSPIReady(void)
 
 }
 
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * FIFOModeSet enables the transmit and receive FIFOs, with both emptied, or
+ * disables them again, leaving the FIFO registers as SPI_Open set them.
+ *
+ * @param	bEnable		TRUE to enable the FIFOs, FALSE to disable them.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void FIFOModeSet(const bool_t bEnable)
+{
+	uint16_t	FIFOEnable = 0u;
+
+	if (bEnable == TRUE)
+	{
+		FIFOEnable = SPIFFTX_SPIFFENA_BIT_MASK;
+	}
+
+	// Hold both FIFO pointers in reset to empty the FIFOs...
+	genericIO_16bitWrite( (SPI_A_BASE_ADDRESS + SPIFFTX_OFFSET),
+							SPIFFTX_SPIRST_BIT_MASK | FIFOEnable | SPIFFTX_TXFFINTCLR_BIT_MASK);
+	genericIO_16bitWrite( (SPI_A_BASE_ADDRESS + SPIFFRX_OFFSET),
+							SPIFFRX_RXFFOVFCLR_BIT_MASK | SPIFFRX_RXFFINTCLR_BIT_MASK
+							| SPIFFRX_RXFFIL_DEFAULT);
+
+	// ...and then let them go again.
+	genericIO_16bitWrite( (SPI_A_BASE_ADDRESS + SPIFFTX_OFFSET),
+							SPIFFTX_SPIRST_BIT_MASK | FIFOEnable | SPIFFTX_TXFIFO_BIT_MASK
+							| SPIFFTX_TXFFINTCLR_BIT_MASK);
+	genericIO_16bitWrite( (SPI_A_BASE_ADDRESS + SPIFFRX_OFFSET),
+							SPIFFRX_RXFFOVFCLR_BIT_MASK | SPIFFRX_RXFIFORESET_BIT_MASK
+							| SPIFFRX_RXFFINTCLR_BIT_MASK | SPIFFRX_RXFFIL_DEFAULT);
+}
+
@@ -0,0 +1,324 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        spi_burst_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side benchmark of FIFO burst SPI transfers to the M95.
+ * @details
+ * Reads a range of the simulated serial flash (flash_sim.c), and writes part
+ * of a page, two ways, and measures each with the simulated time:
+ *
+ *  - Word - SPI_Write for the command and address and SPI_Read \ SPI_Write
+ *    for the data, one word at a time, waiting for each, as the M95 driver
+ *    used to.
+ *  - Burst - M95_ReadCommandSend and M95_WriteCommandSend, which send the
+ *    command and address, and then the data, with SPI_TransferBlock.
+ *
+ * The write is timed up to the end of the frame, so the page write cycle is
+ * not included.  Both reads must return what is in the device, and both
+ * writes must leave the data in it.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs and resets the
+ * simulated devices, so the serial flash and SPI must have been set up
+ * (M95_DeviceSizeInitialise(128u, 65536u), SPI_Open(8u)) before it is run -
+ * the word transfers use a 16 bit address, as the M95512 does.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "m95.h"
+#include "spi.h"
+#include "flash_sim.h"
+#include "spi_burst_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define SERIAL_FLASH_BYTES          65536u      ///< Size of the simulated M95.
+#define SERIAL_FLASH_PAGE_BYTES     128u        ///< Page size of the simulated M95.
+
+#define M95_READ_COMMAND            0x03u       ///< Read command.
+#define M95_WRITE_COMMAND           0x02u       ///< Write command.
+
+#define DEFAULT_CONFIG              { 0x2000u, 2048u, 128u }
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     word_read(const uint32_t address,
+                          const uint32_t number_of_bytes);
+
+static void     word_write(const uint32_t address,
+                           const uint32_t number_of_bytes);
+
+static uint32_t bytes_per_second(const uint32_t number_of_bytes,
+                                 const uint64_t elapsed_ns);
+
+static bool_t   data_check(const uint8_t * const p_buffer,
+                           const uint32_t number_of_bytes);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_data[SPI_BURST_SIM_MAX_READ_BYTES];
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_read[SPI_BURST_SIM_MAX_READ_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * spi_burst_sim_config_default fills in the configuration for a 2k byte read
+ * and a full page write.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void spi_burst_sim_config_default(spi_burst_sim_config_t * const p_config)
+{
+    const spi_burst_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * spi_burst_sim_run reads and writes each way.  The first page of the range
+ * is written a word at a time, and the second in a burst.
+ *
+ * @param   p_config    Pointer to the transfers to make.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t spi_burst_sim_run(const spi_burst_sim_config_t * const p_config,
+                         spi_burst_sim_result_t * const p_result)
+{
+    const uint32_t  burst_page = p_config->address + SERIAL_FLASH_PAGE_BYTES;
+    uint32_t        i;
+    uint64_t        start_ns;
+    uint64_t        elapsed_ns;
+    bool_t          b_valid = FALSE;
+
+    if ( (p_config->read_bytes != 0u)
+            && (p_config->read_bytes <= SPI_BURST_SIM_MAX_READ_BYTES)
+            && (p_config->write_bytes != 0u)
+            && (p_config->write_bytes <= SERIAL_FLASH_PAGE_BYTES)
+            && ((p_config->address & (SERIAL_FLASH_PAGE_BYTES - 1u)) == 0u)
+            && ((p_config->address + p_config->read_bytes) <= SERIAL_FLASH_BYTES)
+            && ((burst_page + SERIAL_FLASH_PAGE_BYTES) <= SERIAL_FLASH_BYTES) )
+    {
+        flash_sim_install();
+        flash_sim_reset();
+        b_valid = TRUE;
+    }
+
+    if (b_valid)
+    {
+        for (i = 0u; i < p_config->read_bytes; i++)
+        {
+            m_data[i] = (uint8_t)((i * 11u) ^ (i >> 8u));
+        }
+
+        (void)flash_sim_backdoor_write(STORAGE_DEVICE_SERIAL_FLASH, p_config->address,
+                                       p_config->read_bytes, &m_data[0]);
+
+        /* Read both ways. */
+        start_ns = flash_sim_time_ns_get();
+        word_read(p_config->address, p_config->read_bytes);
+        elapsed_ns = flash_sim_time_ns_get() - start_ns;
+
+        p_result->word.read_us          = elapsed_ns / 1000u;
+        p_result->word.read_bytes_per_s = bytes_per_second(p_config->read_bytes, elapsed_ns);
+        p_result->b_read_matches        = data_check(&m_read[0], p_config->read_bytes);
+
+        start_ns = flash_sim_time_ns_get();
+        M95_ReadCommandSend(p_config->address, p_config->read_bytes, &m_read[0]);
+        elapsed_ns = flash_sim_time_ns_get() - start_ns;
+
+        p_result->burst.read_us          = elapsed_ns / 1000u;
+        p_result->burst.read_bytes_per_s = bytes_per_second(p_config->read_bytes, elapsed_ns);
+
+        if (!data_check(&m_read[0], p_config->read_bytes))
+        {
+            p_result->b_read_matches = FALSE;
+        }
+
+        /* Write a page each way, starting blank. */
+        flash_sim_reset();
+
+        M95_WriteEnableCommandSend();
+        start_ns = flash_sim_time_ns_get();
+        word_write(p_config->address, p_config->write_bytes);
+        elapsed_ns = flash_sim_time_ns_get() - start_ns;
+        (void)M95_WriteCompletePoll();
+
+        p_result->word.write_us          = elapsed_ns / 1000u;
+        p_result->word.write_bytes_per_s = bytes_per_second(p_config->write_bytes, elapsed_ns);
+
+        M95_WriteEnableCommandSend();
+        start_ns = flash_sim_time_ns_get();
+        M95_WriteCommandSend(burst_page, p_config->write_bytes, &m_data[0]);
+        elapsed_ns = flash_sim_time_ns_get() - start_ns;
+        (void)M95_WriteCompletePoll();
+
+        p_result->burst.write_us          = elapsed_ns / 1000u;
+        p_result->burst.write_bytes_per_s = bytes_per_second(p_config->write_bytes, elapsed_ns);
+
+        (void)flash_sim_backdoor_read(STORAGE_DEVICE_SERIAL_FLASH, p_config->address,
+                                      p_config->write_bytes, &m_read[0]);
+        p_result->b_write_matches = data_check(&m_read[0], p_config->write_bytes);
+
+        (void)flash_sim_backdoor_read(STORAGE_DEVICE_SERIAL_FLASH, burst_page,
+                                      p_config->write_bytes, &m_read[0]);
+
+        if (!data_check(&m_read[0], p_config->write_bytes))
+        {
+            p_result->b_write_matches = FALSE;
+        }
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * word_read reads from the device a word at a time, as M95_ReadCommandSend
+ * used to.
+ *
+ * @param   address             First address to read.
+ * @param   number_of_bytes     Number of bytes to read.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void word_read(const uint32_t address,
+                      const uint32_t number_of_bytes)
+{
+    uint32_t    i;
+
+    SPI_EEPROMActiveSet();
+    SPI_Write(M95_READ_COMMAND);
+    SPI_Write((uint16_t)((address >> 8u) & 0x000000FFu));
+    SPI_Write((uint16_t)(address & 0x000000FFu));
+
+    for (i = 0u; i < number_of_bytes; i++)
+    {
+        m_read[i] = (uint8_t)(SPI_Read(0u) & 0x00FFu);
+    }
+
+    SPI_EEPROMInactiveSet();
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * word_write writes into the device a word at a time, as M95_WriteCommandSend
+ * used to.  Write enable must have been sent first.
+ *
+ * @param   address             First address to write.
+ * @param   number_of_bytes     Number of bytes to write.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void word_write(const uint32_t address,
+                       const uint32_t number_of_bytes)
+{
+    uint32_t    i;
+
+    SPI_EEPROMActiveSet();
+    SPI_Write(M95_WRITE_COMMAND);
+    SPI_Write((uint16_t)((address >> 8u) & 0x000000FFu));
+    SPI_Write((uint16_t)(address & 0x000000FFu));
+
+    for (i = 0u; i < number_of_bytes; i++)
+    {
+        SPI_Write(m_data[i]);
+    }
+
+    SPI_EEPROMInactiveSet();
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * bytes_per_second works out the throughput of a transfer.
+ *
+ * @param   number_of_bytes     Number of data bytes transferred.
+ * @param   elapsed_ns          Simulated time of the transfer.
+ * @retval  uint32_t            Bytes per second.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t bytes_per_second(const uint32_t number_of_bytes,
+                                 const uint64_t elapsed_ns)
+{
+    uint32_t    rate = 0u;
+
+    if (elapsed_ns != 0u)
+    {
+        rate = (uint32_t)(((uint64_t)number_of_bytes * 1000000000u) / elapsed_ns);
+    }
+
+    return rate;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * data_check checks that a buffer holds the start of the data.
+ *
+ * @param   p_buffer            Pointer to the buffer to check.
+ * @param   number_of_bytes     Number of bytes to check.
+ * @retval  bool_t              TRUE if the buffer holds the data.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t data_check(const uint8_t * const p_buffer,
+                         const uint32_t number_of_bytes)
+{
+    uint32_t    i;
+    bool_t      b_matches = TRUE;
+
+    for (i = 0u; i < number_of_bytes; i++)
+    {
+        if (p_buffer[i] != m_data[i])
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -53,7 +53,7 @@
 
 #define	HALT_FOR_TEST	for(;;){;}	///< infinite loop for halting under test
 #define MAX_DEBUG_BUFFER_RX_SIZE	128u	// For receive interrupt to use.
-#define MAX_SSB_BUFFER_RX_SIZE		513u	// For receive interrupt to use (max SSB length plus 1 for NULL).
+#define MAX_SSB_BUFFER_RX_SIZE		2048u	// For receive interrupt to use (power of two, room for two max length SSB frames).
 
 #ifdef FLASH
 extern uint16_t	RamfuncsLoadStart;
@@ -72,10 +72,12 @@ static void DebugRxBufferInitialise(void);
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module.
 //
-// The receive buffers are temporary buffers which the RX interrupts use
+// The receive buffers are ring buffers which the RX interrupts write into
 // and which are then read from by the main code - these buffers need to be
 // big enough to store an entire message, just in case the main code can't
-// read any characters before the whole message is received.
+// read any characters before the whole message is received.  The SSB buffer
+// also holds the last message received while it is being dealt with (the
+// message data is used in place), so has room for two messages.
 // These buffers are declared as having module scope to avoid putting them on
 // the stack, to make the memory usage more predictable (easier to work out).
 
@@ -383,9 +385,9 @@ void ToolSpecificHardware_ISBTransmitDisable(void)
 /**
  * @note
  * ToolSpecificHardware_SSBTransmitEnable disables the SSB receiver, and
- * enables the transmitter.  We also reset the receive interrupt buffer in
- * here - as the SSB is single duplex, it is impossible to receive and transmit
- * at the same time, so the buffer can be reset here.
+ * enables the transmitter.  The receive buffer is not reset here, as the
+ * message being replied to is still in it (its data is used in place) - the
+ * message is thrown away when the next message is waited for.
  *
  */
 // ----------------------------------------------------------------------------
@@ -393,7 +395,6 @@ void ToolSpecificHardware_SSBTransmitEnable(void)
 {
 	IOCONTROLCOMMON_RS485ReceiverDisable();
 	IOCONTROLCOMMON_RS485TransmitterEnable();
-	SSBRxBufferInitialise();
 }
 
 
@@ -484,32 +485,9 @@ void ToolSpecificHardware_ApplicationExecute(void* ExecutionAddress)
 // ----------------------------------------------------------------------------
 bool_t ToolSpecificHardware_SSBPortCharacterReceiveReadOnce(unsigned char* pData)
 {
-	static uint16_t		PreviousNumberOfCharacters = 0u;
-	uint16_t			CurrentNumberOfCharacters;
-	bool_t				bFoundACharacter = FALSE;
-
-	CurrentNumberOfCharacters = SCI_RxBufferNumberOfCharsGet(SCI_B);
-
-	// If there are no characters in the receive buffer then reset the
-	// previous counter - we're waiting for something to happen.
-	if (CurrentNumberOfCharacters == 0u)
-	{
-		PreviousNumberOfCharacters = 0u;
-	}
-	else
-	{
-		// If we've received one (or more) characters then read one from
-		// the receive buffer.  Any other characters will simply be buffered
-		// in the interrupt buffer until they're read.
-		if (CurrentNumberOfCharacters > PreviousNumberOfCharacters)
-		{
-			bFoundACharacter = TRUE;
-			*pData = mSSBReceiveInterruptBuffer[PreviousNumberOfCharacters];
-			PreviousNumberOfCharacters++;
-		}
-	}
-
-	return bFoundACharacter;
+	// Read the oldest character from the receive buffer.  Any other characters
+	// will simply be buffered in the interrupt buffer until they're read.
+	return SCI_RxCharacterGet(SCI_B, pData);
 }
 
 
@@ -530,6 +508,75 @@ bool_t ToolSpecificHardware_ISBPortCharacterReceiveReadOnce(unsigned char* pData
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ToolSpecificHardware_SSBPortReceiveSpanGet gives direct access to the
+ * characters in the SSB serial port (SCI B) receive buffer, without reading
+ * them out one at a time.
+ *
+ * @param   Offset      Number of received characters to skip.
+ * @param   ppData      Pointer to the first character is written here.
+ * @retval  uint16_t    Number of contiguous characters, zero if none.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t ToolSpecificHardware_SSBPortReceiveSpanGet(uint16_t Offset, const unsigned char** ppData)
+{
+	return SCI_RxSpanGet(SCI_B, Offset, ppData);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ToolSpecificHardware_ISBPortReceiveSpanGet does nothing, as there is no ISB
+ * port on the Xceed board, so we always just return zero.
+ *
+ * @param   Offset      Number of received characters to skip.
+ * @param   ppData      Pointer to the first character is written here.
+ * @retval  uint16_t    Number of contiguous characters, zero if none.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t ToolSpecificHardware_ISBPortReceiveSpanGet(uint16_t Offset, const unsigned char** ppData)
+{
+    return 0u;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ToolSpecificHardware_SSBPortReceiveSpanRelease throws away the oldest
+ * characters in the SSB serial port (SCI B) receive buffer.
+ *
+ * @param   Count       Number of characters to throw away.
+ *
+ */
+// ----------------------------------------------------------------------------
+void ToolSpecificHardware_SSBPortReceiveSpanRelease(uint16_t Count)
+{
+	SCI_RxSpanRelease(SCI_B, Count);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ToolSpecificHardware_ISBPortReceiveSpanRelease does nothing, as there is no
+ * ISB port on the Xceed board.
+ *
+ * @param   Count       Number of characters to throw away.
+ *
+ */
+// ----------------------------------------------------------------------------
+void ToolSpecificHardware_ISBPortReceiveSpanRelease(uint16_t Count)
+{
+    ;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * @note
@@ -599,6 +646,48 @@ void ToolSpecificHardware_ISBPortByteSend(unsigned char data)
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ToolSpecificHardware_SSBPortBufferSend waits until the transmit interrupt
+ * has put the whole of the previous buffer into the transmit FIFO, and then
+ * starts sending the new buffer.  It doesn't wait for the new buffer to be
+ * sent, so the caller can get on with the next one - the buffer mustn't be
+ * changed until the next call has returned.
+ *
+ * @param   pData	Pointer to the characters to send.
+ * @param   Count	Number of characters to send.
+ *
+ */
+// ----------------------------------------------------------------------------
+void ToolSpecificHardware_SSBPortBufferSend(const unsigned char* pData, uint16_t Count)
+{
+	while (SCI_TxBufferFreeCheck(SCI_B) == FALSE)
+	{
+		;
+	}
+
+	SCI_TxStart(SCI_B, (const uint8_t*)pData, Count);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ToolSpecificHardware_ISBPortBufferSend does nothing, as there is no ISB port
+ * on the Xceed board.
+ *
+ * @param   pData   Pointer to the characters to send.
+ * @param   Count   Number of characters to send.
+ *
+ */
+// ----------------------------------------------------------------------------
+void ToolSpecificHardware_ISBPortBufferSend(const unsigned char* pData, uint16_t Count)
+{
+    ;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * @note
@@ -645,6 +734,24 @@ bool_t ToolSpecificHardware_ISBPortCharacterReceiveByPolling(unsigned char *pDat
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * @note
+ * ToolSpecificHardware_SSBPortReceivePoll empties the SSB serial port (SCI B)
+ * receive FIFO into the receive interrupt buffer.  This is called from the
+ * flash API callback, as interrupts are disabled while the internal flash is
+ * programmed, so that the next message can still be received.  It runs from
+ * RAM because the flash can't be read while it is being programmed.
+ *
+ */
+// ----------------------------------------------------------------------------
+#pragma CODE_SECTION(ToolSpecificHardware_SSBPortReceivePoll, "ramfuncs")
+void ToolSpecificHardware_SSBPortReceivePoll(void)
+{
+	SCI_RxFifoPoll(SCI_B);
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * @note
@@ -764,41 +871,9 @@ void ToolSpecificHardware_DebugMessageSend(char* pDebugMessage)
 // ----------------------------------------------------------------------------
 bool_t ToolSpecificHardware_DebugPortCharacterReceiveReadOnce(unsigned char* pData)
 {
-	static uint16_t		PreviousNumberOfCharacters = 0u;
-	uint16_t			CurrentNumberOfCharacters;
-	bool_t				bFoundACharacter = FALSE;
-
-	CurrentNumberOfCharacters = SCI_RxBufferNumberOfCharsGet(SCI_A);
-
-	// If there are no characters in the receive buffer then reset the
-	// previous counter - we're waiting for something to happen.
-	if (CurrentNumberOfCharacters == 0u)
-	{
-		PreviousNumberOfCharacters = 0u;
-	}
-	else
-	{
-		// If we've received one (or more) characters then read one from
-		// the receive buffer.  Any other characters will simply be buffered
-		// in the interrupt buffer until they're read.
-		if (CurrentNumberOfCharacters > PreviousNumberOfCharacters)
-		{
-			bFoundACharacter = TRUE;
-			*pData = mDebugReceiveInterruptBuffer[PreviousNumberOfCharacters];
-			PreviousNumberOfCharacters++;
-
-			// If character received is CR then reset the buffer.
-			// This is safe to do because we only receive the characters one by one,
-			// so we don't need to worry about overwriting data in the buffer - by
-			// this point the characters are 'old' and are no longer useful.
-			if (*pData == '\r')
-			{
-				DebugRxBufferInitialise();
-			}
-		}
-	}
-
-	return bFoundACharacter;
+	// Read the oldest character from the receive buffer - the buffer is a
+	// ring, so there's no need to reset it at the end of each line.
+	return SCI_RxCharacterGet(SCI_A, pData);
 }
 
 
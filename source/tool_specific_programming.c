@@ -147,11 +147,13 @@ bool_t ToolSpecificProgramming_SafeFlashProgram(void* pFlashAddress,
 	TESTPOINTS_Set(TP_OFFSET_FLASH_PROGRAM);
 
 	// Program appropriate sector(s) using TI flash program library function.
-	// Note that the code will wait in here until programming has completed.
-	//Flash_CallbackPtr = FlashProgrammingCallBackFunction;
+	// Note that the code will wait in here until programming has completed,
+	// with interrupts disabled - the callback keeps the SSB receiving.
+	Flash_CallbackPtr = FlashProgrammingCallBackFunction;
 	DINT;
 	ProgramAPIStatus = Flash_Program( (Uint16*)pFlashAddress, (Uint16*)pBufferAddress, Length, &FlashStatus);
     EINT;
+	Flash_CallbackPtr = NULL;
 	// Copy status from TI structure into Thor flash status structure.
 	pFlashProgrammingStatus->ActualData = FlashStatus.ActualData;
 	pFlashProgrammingStatus->ExpectedData = FlashStatus.ExpectedData;
@@ -276,10 +278,13 @@ static void FlashEraseCallBackFunction(void)
 }
 
 // Callback function for flash programming - this is called during the program
-// function, and we can use this to check that the device is still alive.
+// function, and is used to empty the SSB receive FIFO, as the receive interrupt
+// is disabled.  This has to run from RAM (as does everything it calls), so the
+// testpoint can't be toggled in here.
+#pragma CODE_SECTION(FlashProgrammingCallBackFunction, "ramfuncs")
 static void FlashProgrammingCallBackFunction(void)
 {
-	TESTPOINTS_Toggle(TP_OFFSET_FLASH_PROGRAM);
+	ToolSpecificHardware_SSBPortReceivePoll();
 }
 
 
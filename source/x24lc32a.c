@@ -23,6 +23,25 @@
 #define SLAVE_ADDRESS_SHIFT		8			///< shift by 8 bits.
 #define X24LC32A_WRITE_PAGE_SIZE	32u			///< each page is 32 bytes.
 #define X24LC32A_DEVICE_SIZE		4096u		///< total device size is 32k bytes.
+#define X24LC32A_CACHE_PAGES		32u			///< Pages held by the write-behind cache (1k bytes).
+#define X24LC32A_ACK_POLL_LIMIT		1000u		///< Ack polls before a write cycle times out (27ms at 400kbps, tWC is 5ms).
+
+
+// ----------------------------------------------------------------------------
+// Typedefs section
+
+/**
+ * Structure holding one page of the write-behind cache - the bytes from
+ * first_offset up to (but not including) end_offset are waiting to be
+ * written into the device.
+ */
+typedef struct
+{
+    uint32_t    page_address;                       ///< First device address of the page.
+    uint32_t    first_offset;                       ///< Offset of the first byte waiting.
+    uint32_t    end_offset;                         ///< Offset after the last byte waiting.
+    uint8_t     data[X24LC32A_WRITE_PAGE_SIZE];     ///< Page data (only the bytes waiting are valid).
+} x24lc32a_cache_page_t;
 
 
 // ----------------------------------------------------------------------------
@@ -35,10 +54,62 @@ static EI2CStatus_t local_memcpy(uint32_t StartAddress,
 static uint16_t SlaveAddressGenerate(const uint32_t EntireAddress);
 static uint16_t DeviceAddressGenerate(const uint32_t EntireAddress);
 
+static void cache_page_add(const uint32_t StartAddress,
+                           const uint16_t NumberOfWrites,
+                           const uint8_t * const p_source_buffer);
+
+static bool_t cache_read(const uint32_t StartAddress,
+                         const uint16_t NumberOfReads,
+                         uint8_t * const p_destination_buffer);
+
+static void cache_overlay(const uint32_t StartAddress,
+                          const uint16_t NumberOfReads,
+                          uint8_t * const p_destination_buffer);
+
+static bool_t cache_range_check(const uint32_t StartAddress,
+                                const uint16_t NumberOfReads);
+
+static EI2CStatus_t cache_write_wait(void);
+
+static void cache_write_complete(void * const p_context, const EI2CStatus_t Status);
+static void cache_page_written(void * const p_context, const EI2CStatus_t Status);
+
+static EI2CStatus_t cache_status_take(void);
+
+static uint16_t cache_index_get(const uint16_t Position);
+
 
 // ----------------------------------------------------------------------------
 // Variables which only have scope within this module
 
+/// Write-behind cache - a queue of pages, oldest first, waiting to be written.
+//lint -e{956} Only accessed from the background loop.
+static x24lc32a_cache_page_t m_cache[X24LC32A_CACHE_PAGES];
+
+/// Index of the oldest page in the cache.
+//lint -e{956} Only accessed from the background loop.
+static uint16_t m_cache_head = 0u;
+
+/// Number of pages in the cache.
+//lint -e{956} Only accessed from the background loop.
+static uint16_t m_cache_count = 0u;
+
+/// TRUE while the oldest page in the cache is queued on the I2C, being written.
+//lint -e{956} Only accessed from the background loop.
+static bool_t m_b_cache_writing = FALSE;
+
+/// First error from writing the cache back, until it is reported.
+//lint -e{956} Only accessed from the background loop.
+static EI2CStatus_t m_cache_status = I2C_COMPLETED_OK;
+
+/// Bumped by every write into the device, so that users of copies of the
+/// data can tell when something else has written it.
+//lint -e{956} Only accessed from the background loop.
+static uint16_t m_write_count = 0u;
+
+/// First error writing the page being written, for a read waiting on it.
+//lint -e{956} Only accessed from the background loop.
+static EI2CStatus_t m_page_status = I2C_COMPLETED_OK;
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -52,6 +123,16 @@ static uint16_t DeviceAddressGenerate(const uint32_t EntireAddress);
  * Note that the slave address does NOT include the R/!W bit - this is only
  * the seven bits (1010 A2 A1 A0 in this case).
  *
+ * Data still in the write-behind cache is newer than the device, so a read
+ * which only wants cached data is served from the cache without touching the
+ * bus.  Otherwise the device is read (once it has finished writing the current
+ * page - it doesn't acknowledge during a write cycle) and any cached data is
+ * copied over the top.  If that page write fails, nothing is read.
+ *
+ * @note
+ * As the data may come from the cache, this can't be used to check that data
+ * has been written into the device - use X24LC32A_VerifyRead for that.
+ *
  * @param	StartAddress		Initial address to start reading from.
  * @param	NumberOfReads		Number of bytes to read from the device.
  * @param	pDestBuffer[]		Pointer to buffer to put data in.
@@ -63,16 +144,80 @@ EI2CStatus_t X24LC32A_BlockRead(const uint32_t StartAddress,
 								const uint16_t NumberOfReads,
 								uint8_t * const p_destination_buffer)
 {
-	EI2CStatus_t	status;
+	EI2CStatus_t	status = I2C_COMPLETED_OK;
 	uint16_t		DeviceAddress;
 	uint16_t		SlaveAddress;
 
-	// Generate slave and device addresses for this access.
-	SlaveAddress = SlaveAddressGenerate(StartAddress);
-	DeviceAddress = DeviceAddressGenerate(StartAddress);
+	if (!cache_read(StartAddress, NumberOfReads, p_destination_buffer))
+	{
+		// Generate slave and device addresses for this access.
+		SlaveAddress = SlaveAddressGenerate(StartAddress);
+		DeviceAddress = DeviceAddressGenerate(StartAddress);
+
+		status = cache_write_wait();
+
+		// Read from I2C device.
+		if (status == I2C_COMPLETED_OK)
+		{
+			status = I2C_Read(SlaveAddress, DeviceAddress, NumberOfReads, p_destination_buffer);
+
+			cache_overlay(StartAddress, NumberOfReads, p_destination_buffer);
+		}
+
+		// Carry on with the next page, if the wait finished one.
+		(void)X24LC32A_FlushStep();
+	}
+
+	return status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * X24LC32A_VerifyRead reads data back from the device itself, to check a
+ * write.  Any pages in the write-behind cache which hold part of the data are
+ * written into the device first, and then the device is read without the
+ * cache.
+ *
+ * An error writing the cache back is returned here (and nothing is read) as
+ * the device might not hold the data which was written.
+ *
+ * @param	StartAddress		Initial address to start reading from.
+ * @param	NumberOfReads		Number of bytes to read from the device.
+ * @param	p_destination_buffer	Pointer to buffer to put data in.
+ * @retval	EI2CStatus_t		I2C bus \ programming status.
+ *
+ */
+// ----------------------------------------------------------------------------
+EI2CStatus_t X24LC32A_VerifyRead(const uint32_t StartAddress,
+								 const uint16_t NumberOfReads,
+								 uint8_t * const p_destination_buffer)
+{
+	EI2CStatus_t	status;
+
+	// The cache is written back oldest first, so keep going until none of
+	// the pages left hold any of the data.  Every page finishes, as the ack
+	// polling is limited.
+	while (cache_range_check(StartAddress, NumberOfReads))
+	{
+		(void)X24LC32A_FlushStep();
+	}
+
+	status = cache_write_wait();
+
+	if (status == I2C_COMPLETED_OK)
+	{
+		status = cache_status_take();
+	}
+
+	if (status == I2C_COMPLETED_OK)
+	{
+		status = I2C_Read(SlaveAddressGenerate(StartAddress),
+		                  DeviceAddressGenerate(StartAddress),
+		                  NumberOfReads,
+		                  p_destination_buffer);
+	}
 
-	// Read from I2C device and return status.
-	status = I2C_Read(SlaveAddress, DeviceAddress, NumberOfReads, p_destination_buffer);
 	return status;
 }
 // ----------------------------------------------------------------------------
@@ -88,6 +233,9 @@ EI2CStatus_t X24LC32A_BlockRead(const uint32_t StartAddress,
  * is dealt with by the X24LC32A_memcmy function, which feeds data into this
  * function.
  *
+ * This write goes straight into the device, so the write-behind cache is
+ * flushed first - otherwise older cached data could be written over it.
+ *
  * @param	StartAddress		Initial address to start writing into.
  * @param	NumberOfWrites		Number of bytes to write into the device.
  * @param	pSourceBuffer[]		Pointer to buffer to get source data from.
@@ -107,15 +255,21 @@ EI2CStatus_t X24LC32A_BlockWrite(const uint32_t StartAddress,
 	SlaveAddress = SlaveAddressGenerate(StartAddress);
 	DeviceAddress = DeviceAddressGenerate(StartAddress);
 
-	// Write to I2C device and return status.
-	status = I2C_Write(SlaveAddress, DeviceAddress, NumberOfWrites, p_source_buffer);
+	status = X24LC32A_Flush();
+
+	m_write_count++;
+
+	// Write to I2C device.
+	if (status == I2C_COMPLETED_OK)
+	{
+		status = I2C_Write(SlaveAddress, DeviceAddress, NumberOfWrites, p_source_buffer);
+	}
 
-	// If status is OK then poll for write complete.
-	// Note that we set the timeout to zero to make the acknowledgement poll
-	// function use the force timeout flag.
+	// If status is OK then poll for write complete, giving up after
+	// X24LC32A_ACK_POLL_LIMIT polls.
 	if (status == I2C_COMPLETED_OK)
 	{
-		status = I2C_AckPoll(SlaveAddress, 0u);
+		status = I2C_AckPoll(SlaveAddress, X24LC32A_ACK_POLL_LIMIT);
 	}
 
 	return status;
@@ -124,9 +278,21 @@ EI2CStatus_t X24LC32A_BlockWrite(const uint32_t StartAddress,
 // ----------------------------------------------------------------------------
 /**
  * local_memcpy attempts to mimic the standard memcpy function for the device.
- * Data is written into the device, aligning to page boundaries as required.
- * local_memcpy ģ豸ı׼ memcpy 
- * ݱд豸Ҫҳ߽롣
+ * Data is split up on page boundaries and put into the write-behind cache,
+ * and the first page write is started - the rest are written in the
+ * background by X24LC32A_FlushStep(), each one as soon as acknowledgement
+ * polling shows that the last has finished.  The caller only waits if the
+ * cache is full, until the device has written enough pages to make room.
+ *
+ * @note
+ * A return of I2C_COMPLETED_OK means that all of the data has been accepted -
+ * use X24LC32A_Flush() to wait until it is in the device.  An error writing
+ * earlier data back is returned by the next call to this or X24LC32A_Flush().
+ * Until then the data is only in RAM, so a power failure loses whatever is
+ * still in the cache - at most X24LC32A_CACHE_PAGES pages (1k bytes, up to
+ * 160ms of write cycles).  Anything which tells the surface that a write is done
+ * must flush first, as XDIMEMORY_WriteRequest does.
+ *
  * @param	StartAddress		Initial address to start writing to.
  * @param	NumberOfWrites		Number of bytes to write into the device.
  * @param	p_source_buffer     Pointer to buffer containing source data.
@@ -138,77 +304,42 @@ static EI2CStatus_t local_memcpy(uint32_t StartAddress,
                                  uint16_t NumberOfWrites,
 							     const uint8_t * const p_source_buffer)
 {
-	EI2CStatus_t	status = I2C_COMPLETED_OK;
 	uint32_t		AddressMask;
 	uint32_t		StartOffsetInPage;
 	uint16_t		InternalWriteCounter;
     uint16_t        write_offset = 0u;
 
-	// Setup address mask and work out whether start address is within a page
-	// or appears nicely on a page boundary.
-    // õַ벢ȷʼַҳڻǺܺõسҳ߽ϡ
 	AddressMask = X24LC32A_WRITE_PAGE_SIZE - 1u;
-	StartOffsetInPage = StartAddress & AddressMask;
 
-	// If the address starts somewhere within a block, then write as many words
-	// as are required to align the data (or just write the required words, if
-	// there aren't more than will fill the block).
-	// ַӿڵĳʼдľֻ֣ܶд֣ûг֣
-	if (StartOffsetInPage != 0u)
+	m_write_count++;
+
+	// Cache the data a page at a time - the first and last pages might only
+	// be partly written.
+	while (NumberOfWrites != 0u)
 	{
-		// Setup internal write counter for correct number of words to either
-		// fill the first page, or just as many words as are required.
-		// ڲдԻȡȷһҳ߸Ҫþܶ
-		if (NumberOfWrites < (X24LC32A_WRITE_PAGE_SIZE - StartOffsetInPage) )
+		StartOffsetInPage = StartAddress & AddressMask;
+
+	    //lint -e{921} Cast from uint32_t to uint16_t - never more than a page.
+		InternalWriteCounter = (uint16_t)(X24LC32A_WRITE_PAGE_SIZE - StartOffsetInPage);
+
+		if (NumberOfWrites < InternalWriteCounter)
 		{
 			InternalWriteCounter = NumberOfWrites;
 		}
-		else
-		{
-		    // Note the cast - the result will never be more than 16 bits.
-			// עǿת - Զᳬ 16 λ
-		    //lint -e{921} Cast from uint32_t to uint16_t
-			InternalWriteCounter = (uint16_t)(X24LC32A_WRITE_PAGE_SIZE - StartOffsetInPage);
-		}
 
-		// Write first page (might be only page).
-		// дһҳֻһҳ
-		status = X24LC32A_BlockWrite(StartAddress,
-		                           InternalWriteCounter,
-		                           &p_source_buffer[write_offset]);
+		cache_page_add(StartAddress,
+		               InternalWriteCounter,
+		               &p_source_buffer[write_offset]);
 
-		// Update remaining number of bytes to write, start address and buffer pointer.
-		// Ҫдʣֽʼַͻָ롣
 		NumberOfWrites  -= InternalWriteCounter;
 		StartAddress    += InternalWriteCounter;
 		write_offset    += InternalWriteCounter;
 	}
 
-	// Having aligned the data to the page size, carry on writing in page sized
-	// chunks (or skip this if there's less than a page to go).
-	// ҳС󣬼дҳСĿ飨Ҫߵҳһҳ˲裩
-	while ( (NumberOfWrites >= X24LC32A_WRITE_PAGE_SIZE)
-			&& (status == I2C_COMPLETED_OK) )
-	{
-		status = X24LC32A_BlockWrite(StartAddress,
-		                           X24LC32A_WRITE_PAGE_SIZE,
-		                           &p_source_buffer[write_offset]);
-
-		NumberOfWrites  -= X24LC32A_WRITE_PAGE_SIZE;
-		StartAddress    += X24LC32A_WRITE_PAGE_SIZE;
-		write_offset    += X24LC32A_WRITE_PAGE_SIZE;
-	}
+	// Get the first page going.
+	(void)X24LC32A_FlushStep();
 
-	// If there's any more data to write (less than a page) then do it.
-	// иҪд루һҳ
-	if ( (NumberOfWrites != 0u) && (status == I2C_COMPLETED_OK) )
-	{
-		status = X24LC32A_BlockWrite(StartAddress,
-		                           NumberOfWrites,
-		                           &p_source_buffer[write_offset]);
-	}
-
-	return status;
+	return cache_status_take();
 }
 
 /**
@@ -259,10 +390,109 @@ EI2CStatus_t X24LC32A_DeviceErase()
 		Counter--;
 	}
 
+	// Don't report the device as erased until it is.
+	if (Status == I2C_COMPLETED_OK)
+	{
+		Status = X24LC32A_Flush();
+	}
+
 	return Status;
 }
 
 
+// ----------------------------------------------------------------------------
+/**
+ * X24LC32A_FlushStep moves the write-behind cache on, without waiting for the
+ * device.  When no page is being written, the oldest page is queued on the
+ * I2C as a write followed by an ack poll, and then the I2C transaction queue
+ * is stepped once - so each call is at most one page write or one poll of the
+ * device.  This should be called whenever there is nothing else to do.
+ *
+ * A page which the device hasn't acknowledged after X24LC32A_ACK_POLL_LIMIT
+ * polls is dropped, and I2C_ACKPOLL_TIMEOUT_EXCEEDED is kept for the next
+ * call to X24LC32A_memcpy, X24LC32A_Flush or X24LC32A_VerifyRead to return.
+ *
+ * @retval	bool_t		TRUE if there are still pages waiting to be written.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t X24LC32A_FlushStep(void)
+{
+	const x24lc32a_cache_page_t*	p_page;
+	I2CTransaction_t				Transaction;
+	uint32_t						Address;
+
+	if ( (!m_b_cache_writing) && (m_cache_count != 0u)
+			&& (I2C_TransactionCountGet() <= (I2C_TRANSACTION_QUEUE_SIZE - 2u)) )
+	{
+		p_page  = &m_cache[m_cache_head];
+		Address = p_page->page_address + p_page->first_offset;
+
+		Transaction.Type			= I2C_TRANSACTION_WRITE;
+		Transaction.SlaveAddress	= SlaveAddressGenerate(Address);
+		Transaction.DeviceAddress	= DeviceAddressGenerate(Address);
+	    //lint -e{921} Cast from uint32_t to uint16_t - never more than a page.
+		Transaction.DataCount		= (uint16_t)(p_page->end_offset - p_page->first_offset);
+		Transaction.p_read_data		= NULL;
+		Transaction.p_write_data	= &p_page->data[p_page->first_offset];
+		Transaction.MaxPolls		= X24LC32A_ACK_POLL_LIMIT;
+		Transaction.p_callback		= cache_write_complete;
+		Transaction.p_context		= NULL;
+		(void)I2C_TransactionQueue(&Transaction);
+
+		// Poll until the write cycle has finished, or the polls run out.
+		Transaction.Type			= I2C_TRANSACTION_ACK_POLL;
+		Transaction.p_callback		= cache_page_written;
+		(void)I2C_TransactionQueue(&Transaction);
+
+		m_page_status     = I2C_COMPLETED_OK;
+		m_b_cache_writing = TRUE;
+	}
+
+	(void)I2C_TransactionStep();
+
+	return (m_cache_count != 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * X24LC32A_Flush waits until everything in the write-behind cache has been
+ * written into the device.  This always finishes, as each page is dropped
+ * once its acknowledgement polling runs out.
+ *
+ * @retval	EI2CStatus_t		First error writing the cache back, if any.
+ *
+ */
+// ----------------------------------------------------------------------------
+EI2CStatus_t X24LC32A_Flush(void)
+{
+	while (X24LC32A_FlushStep())
+	{
+		;	// Keep going.
+	}
+
+	return cache_status_take();
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * X24LC32A_WriteCountGet returns a count of the writes made into the device
+ * (including X24LC32A_DeviceErase).  Anything which keeps a copy of part of
+ * the device can note the count when it reads or writes its copy, and read
+ * the device again once the count has moved on.
+ *
+ * @retval	uint16_t		Number of writes, wrapping around.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t X24LC32A_WriteCountGet(void)
+{
+	return m_write_count;
+}
+
+
 // ----------------------------------------------------------------------------
 /**
  * X24LC32A_ForceTimeoutFlagSet calls the function in the I2C driver to set the
@@ -328,3 +558,343 @@ static uint16_t DeviceAddressGenerate(const uint32_t EntireAddress)
 	return DeviceAddress;
 }
 
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_page_add puts data for one device page into the write-behind cache.
+ * If the newest cached copy of the page touches the data (and isn't already
+ * being written) the data is merged into it, otherwise the page goes on the
+ * end of the queue, waiting for room if the cache is full.
+ *
+ * @param	StartAddress		Initial address to write to.
+ * @param	NumberOfWrites		Number of bytes to write, all in the same page.
+ * @param	p_source_buffer     Pointer to buffer containing source data.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void cache_page_add(const uint32_t StartAddress,
+                           const uint16_t NumberOfWrites,
+                           const uint8_t * const p_source_buffer)
+{
+	x24lc32a_cache_page_t*	p_page = NULL;
+	uint32_t				PageAddress;
+	uint32_t				FirstOffset;
+	uint32_t				EndOffset;
+	uint16_t				Counter;
+	uint16_t				Position;
+	bool_t					b_found = FALSE;
+
+	PageAddress = StartAddress & ~(X24LC32A_WRITE_PAGE_SIZE - 1u);
+	FirstOffset = StartAddress - PageAddress;
+	EndOffset   = FirstOffset + NumberOfWrites;
+
+	// Only the newest copy of the page can be merged into, so that the pages
+	// still go into the device in the order they were written.
+	for (Position = m_cache_count; (Position != 0u) && (!b_found); Position--)
+	{
+		if (m_cache[cache_index_get(Position - 1u)].page_address == PageAddress)
+		{
+			b_found = TRUE;
+
+			if ( ((Position != 1u) || (!m_b_cache_writing))
+					&& (FirstOffset <= m_cache[cache_index_get(Position - 1u)].end_offset)
+					&& (EndOffset >= m_cache[cache_index_get(Position - 1u)].first_offset) )
+			{
+				p_page = &m_cache[cache_index_get(Position - 1u)];
+			}
+		}
+	}
+
+	if (p_page == NULL)
+	{
+		// Wait for the device to make room - a page which times out is
+		// dropped, so this always finishes.
+		while (m_cache_count >= X24LC32A_CACHE_PAGES)
+		{
+			(void)X24LC32A_FlushStep();
+		}
+
+		p_page = &m_cache[cache_index_get(m_cache_count)];
+
+		p_page->page_address = PageAddress;
+		p_page->first_offset = FirstOffset;
+		p_page->end_offset   = EndOffset;
+
+		m_cache_count++;
+	}
+
+	for (Counter = 0u; Counter < NumberOfWrites; Counter++)
+	{
+		p_page->data[FirstOffset + Counter] = p_source_buffer[Counter];
+	}
+
+	if (FirstOffset < p_page->first_offset)
+	{
+		p_page->first_offset = FirstOffset;
+	}
+
+	if (EndOffset > p_page->end_offset)
+	{
+		p_page->end_offset = EndOffset;
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_read copies data out of the write-behind cache, if every byte asked
+ * for is in the newest cached copy of its page.
+ *
+ * @param	StartAddress			Initial address to read from.
+ * @param	NumberOfReads			Number of bytes to read.
+ * @param	p_destination_buffer	Pointer to buffer to put data in.
+ * @retval	bool_t					TRUE if all of the data came from the cache.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t cache_read(const uint32_t StartAddress,
+                         const uint16_t NumberOfReads,
+                         uint8_t * const p_destination_buffer)
+{
+	const x24lc32a_cache_page_t*	p_page;
+	uint32_t						Address = StartAddress;
+	uint32_t						ReadsRemaining = NumberOfReads;
+	uint32_t						read_offset = 0u;
+	uint32_t						PageAddress;
+	uint32_t						FirstOffset;
+	uint32_t						InternalReadCounter;
+	uint32_t						Counter;
+	uint16_t						Position;
+	bool_t							b_found;
+	bool_t							b_hit = (m_cache_count != 0u);
+
+	while ( (ReadsRemaining != 0u) && (b_hit) )
+	{
+		PageAddress         = Address & ~(X24LC32A_WRITE_PAGE_SIZE - 1u);
+		FirstOffset         = Address - PageAddress;
+		InternalReadCounter = X24LC32A_WRITE_PAGE_SIZE - FirstOffset;
+
+		if (ReadsRemaining < InternalReadCounter)
+		{
+			InternalReadCounter = ReadsRemaining;
+		}
+
+		// Newest copy first - an older copy might have been written over.
+		b_found = FALSE;
+		b_hit   = FALSE;
+
+		for (Position = m_cache_count; (Position != 0u) && (!b_found); Position--)
+		{
+			p_page = &m_cache[cache_index_get(Position - 1u)];
+
+			if ( (p_page->page_address == PageAddress)
+					&& (FirstOffset < p_page->end_offset)
+					&& ((FirstOffset + InternalReadCounter) > p_page->first_offset) )
+			{
+				b_found = TRUE;
+
+				if ( (FirstOffset >= p_page->first_offset)
+						&& ((FirstOffset + InternalReadCounter) <= p_page->end_offset) )
+				{
+					for (Counter = 0u; Counter < InternalReadCounter; Counter++)
+					{
+						p_destination_buffer[read_offset + Counter] = p_page->data[FirstOffset + Counter];
+					}
+
+					b_hit = TRUE;
+				}
+			}
+		}
+
+		ReadsRemaining  -= InternalReadCounter;
+		Address         += InternalReadCounter;
+		read_offset     += InternalReadCounter;
+	}
+
+	return b_hit;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_overlay copies anything in the write-behind cache over data which has
+ * been read from the device, oldest first so that the newest data wins.
+ *
+ * @param	StartAddress			Initial address the data was read from.
+ * @param	NumberOfReads			Number of bytes read.
+ * @param	p_destination_buffer	Pointer to buffer holding the data read.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void cache_overlay(const uint32_t StartAddress,
+                          const uint16_t NumberOfReads,
+                          uint8_t * const p_destination_buffer)
+{
+	const x24lc32a_cache_page_t*	p_page;
+	uint32_t						CacheStart;
+	uint32_t						CacheEnd;
+	uint32_t						Address;
+	uint16_t						Position;
+
+	for (Position = 0u; Position < m_cache_count; Position++)
+	{
+		p_page = &m_cache[cache_index_get(Position)];
+
+		CacheStart = p_page->page_address + p_page->first_offset;
+		CacheEnd   = p_page->page_address + p_page->end_offset;
+
+		for (Address = CacheStart; Address < CacheEnd; Address++)
+		{
+			if ( (Address >= StartAddress) && (Address < (StartAddress + NumberOfReads)) )
+			{
+				p_destination_buffer[Address - StartAddress] = p_page->data[Address - p_page->page_address];
+			}
+		}
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_range_check checks whether any page in the write-behind cache holds
+ * data for part of a range of addresses.
+ *
+ * @param	StartAddress		Initial address of the range.
+ * @param	NumberOfReads		Number of bytes in the range.
+ * @retval	bool_t				TRUE if some of the range is still cached.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t cache_range_check(const uint32_t StartAddress,
+                                const uint16_t NumberOfReads)
+{
+	const x24lc32a_cache_page_t*	p_page;
+	uint16_t						Position;
+	bool_t							b_cached = FALSE;
+
+	for (Position = 0u; (Position < m_cache_count) && (!b_cached); Position++)
+	{
+		p_page = &m_cache[cache_index_get(Position)];
+
+		if ( ((p_page->page_address + p_page->first_offset) < (StartAddress + NumberOfReads))
+				&& ((p_page->page_address + p_page->end_offset) > StartAddress) )
+		{
+			b_cached = TRUE;
+		}
+	}
+
+	return b_cached;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_write_wait waits for the device to finish writing the current page,
+ * without starting the next one.  The wait always finishes, as the
+ * acknowledgement polling is limited to X24LC32A_ACK_POLL_LIMIT polls.
+ *
+ * @retval	EI2CStatus_t		I2C_COMPLETED_OK if the device finished the
+ *								page (or wasn't writing one) and can be read.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EI2CStatus_t cache_write_wait(void)
+{
+	EI2CStatus_t	status = I2C_COMPLETED_OK;
+
+	if (m_b_cache_writing)
+	{
+		while (m_b_cache_writing)
+		{
+			(void)I2C_TransactionStep();
+		}
+
+		status = m_page_status;
+	}
+
+	return status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_write_complete is called by the I2C when the write of the oldest page
+ * in the cache has been sent, and keeps any error.
+ *
+ * @param	p_context		Not used.
+ * @param	Status			I2C bus status.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void cache_write_complete(void * const p_context, const EI2CStatus_t Status)
+{
+	(void)p_context;
+
+	if ( (Status != I2C_COMPLETED_OK) && (m_cache_status == I2C_COMPLETED_OK) )
+	{
+		m_cache_status = Status;
+	}
+
+	if ( (Status != I2C_COMPLETED_OK) && (m_page_status == I2C_COMPLETED_OK) )
+	{
+		m_page_status = Status;
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_page_written is called by the I2C when acknowledgement polling has
+ * finished for the oldest page in the cache.  The page is dropped from the
+ * cache - if the poll timed out the error is kept, as for the write.
+ *
+ * @param	p_context		Not used.
+ * @param	Status			Acknowledgement poll status.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void cache_page_written(void * const p_context, const EI2CStatus_t Status)
+{
+	cache_write_complete(p_context, Status);
+
+	//lint -e{921} Cast to uint16_t - always less than X24LC32A_CACHE_PAGES.
+	m_cache_head = (uint16_t)((m_cache_head + 1u) % X24LC32A_CACHE_PAGES);
+	m_cache_count--;
+	m_b_cache_writing = FALSE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_status_take returns the first error from writing the cache back, if
+ * there has been one since it was last taken, and clears it.
+ *
+ * @retval	EI2CStatus_t		I2C_COMPLETED_OK, or the first error.
+ *
+ */
+// ----------------------------------------------------------------------------
+static EI2CStatus_t cache_status_take(void)
+{
+	EI2CStatus_t	status = m_cache_status;
+
+	m_cache_status = I2C_COMPLETED_OK;
+
+	return status;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * cache_index_get converts a position in the write-behind cache queue
+ * (0 is the oldest page) into an index into m_cache.
+ *
+ * @param	Position	Position in the queue.
+ * @retval	uint16_t	Index into m_cache.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t cache_index_get(const uint16_t Position)
+{
+	//lint -e{921} Cast to uint16_t - always less than X24LC32A_CACHE_PAGES.
+	return (uint16_t)((m_cache_head + Position) % X24LC32A_CACHE_PAGES);
+}
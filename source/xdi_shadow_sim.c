@@ -0,0 +1,251 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        xdi_shadow_sim.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side benchmark of the XDI memory RAM shadow.
+ * @details
+ * Writes an XDI record into the simulated EEPROM (flash_sim.c), reads it back
+ * twice, and then changes a few coefficient bytes and writes it again, two
+ * ways, measuring each with the simulated time:
+ *
+ *  - Full - the whole framed record with X24LC32A_memcpy, as every
+ *    XDIMEMORY_WriteRequest used to.
+ *  - Delta - XDIMEMORY_WriteRequest, which only programs the pages which
+ *    differ from the shadow.
+ *
+ * Each write is timed up to the end of X24LC32A_Flush(), so that the page
+ * write cycles are included.  The first read loads the shadow from the
+ * EEPROM, and the second is served from RAM.  Afterwards the EEPROM and a
+ * fresh read must hold the record.
+ *
+ * @note
+ * This module is only built for UNIT_TEST_BUILD.  It installs and resets the
+ * simulated devices.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#ifdef UNIT_TEST_BUILD
+
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "x24lc32a.h"
+#include "XDImemory.h"
+#include "flash_sim.h"
+#include "xdi_shadow_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define XDI_ADDRESS                 0x400u      ///< XDI region in the EEPROM.
+#define XDI_BYTES                   1024u       ///< Size of the XDI region.
+#define RECORD_START_IDX            3u          ///< First write buffer byte which goes into the EEPROM.
+#define DATA_START_IDX              5u          ///< First coefficient byte in the write buffer.
+
+#define DEFAULT_CONFIG              { 497u, 100u, 2u }
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   record_check(const uint16_t record_bytes);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_buffer[XDI_BYTES + RECORD_START_IDX];
+
+//lint -e{956} Only used from a single host thread.
+static uint8_t      m_read[XDI_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * xdi_shadow_sim_config_default fills in the configuration for the record
+ * opcode 206 writes, with one 16 bit coefficient changed.
+ *
+ * @param   p_config    Pointer to structure to fill in.
+ *
+ */
+// ----------------------------------------------------------------------------
+void xdi_shadow_sim_config_default(xdi_shadow_sim_config_t * const p_config)
+{
+    const xdi_shadow_sim_config_t default_config = DEFAULT_CONFIG;
+
+    *p_config = default_config;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * xdi_shadow_sim_run writes, reads and updates the record.
+ *
+ * @param   p_config    Pointer to the record to use.
+ * @param   p_result    Pointer to structure to fill in.
+ * @retval  bool_t      FALSE if the configuration is invalid, TRUE otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t xdi_shadow_sim_run(const xdi_shadow_sim_config_t * const p_config,
+                          xdi_shadow_sim_result_t * const p_result)
+{
+    flash_sim_stats_t   stats;
+    rs_queue_status_t   status;
+    uint16_t            length;
+    uint32_t            i;
+    uint64_t            start_ns;
+    bool_t              b_valid = FALSE;
+
+    if ( (p_config->record_bytes > (DATA_START_IDX + 3u))
+            && ((p_config->record_bytes + 2u) <= XDI_BYTES)
+            && (p_config->changed_bytes != 0u)
+            && ((DATA_START_IDX + p_config->changed_offset + p_config->changed_bytes)
+                    <= (p_config->record_bytes - 3u)) )
+    {
+        flash_sim_install();
+        flash_sim_reset();
+        XDIMEMORY_ShadowDiscard_TDD();
+        b_valid = TRUE;
+    }
+
+    if (b_valid)
+    {
+        for (i = DATA_START_IDX; i < (uint32_t)(p_config->record_bytes + RECORD_START_IDX + 2u); i++)
+        {
+            m_buffer[i] = (uint8_t)((i * 29u) ^ (i >> 8u));
+        }
+
+        /* First write, into a blank EEPROM. */
+        p_result->b_data_matches = XDIMEMORY_WriteRequest(&m_buffer[0], p_config->record_bytes, &status);
+
+        if (X24LC32A_Flush() != I2C_COMPLETED_OK)
+        {
+            p_result->b_data_matches = FALSE;
+        }
+
+        /* Read back, as after a power cycle, then again. */
+        XDIMEMORY_ShadowDiscard_TDD();
+
+        start_ns = flash_sim_time_ns_get();
+        (void)XDIMEMORY_ReadRequest(&m_read[0], &length, &status);
+        p_result->first_read_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        start_ns = flash_sim_time_ns_get();
+        (void)XDIMEMORY_ReadRequest(&m_read[0], &length, &status);
+        p_result->repeat_read_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+
+        /* Change one coefficient, and write it through the shadow. */
+        for (i = 0u; i < p_config->changed_bytes; i++)
+        {
+            m_buffer[DATA_START_IDX + p_config->changed_offset + i] ^= 0x5Au;
+        }
+
+        flash_sim_stats_clear();
+        start_ns = flash_sim_time_ns_get();
+
+        if ( (!XDIMEMORY_WriteRequest(&m_buffer[0], p_config->record_bytes, &status))
+                || (X24LC32A_Flush() != I2C_COMPLETED_OK) )
+        {
+            p_result->b_data_matches = FALSE;
+        }
+
+        p_result->delta_write_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+        flash_sim_stats_get(&stats);
+        p_result->delta_write_cycles = stats.x24lc32a_write_cycles;
+
+        if (!record_check(p_config->record_bytes))
+        {
+            p_result->b_data_matches = FALSE;
+        }
+
+        /* The same framed record, the old way. */
+        flash_sim_stats_clear();
+        start_ns = flash_sim_time_ns_get();
+
+        if ( (X24LC32A_memcpy(XDI_ADDRESS, p_config->record_bytes + 2u, &m_buffer[RECORD_START_IDX])
+                    != I2C_COMPLETED_OK)
+                || (X24LC32A_Flush() != I2C_COMPLETED_OK) )
+        {
+            p_result->b_data_matches = FALSE;
+        }
+
+        p_result->full_write_us = (flash_sim_time_ns_get() - start_ns) / 1000u;
+        flash_sim_stats_get(&stats);
+        p_result->full_write_cycles = stats.x24lc32a_write_cycles;
+    }
+
+    return b_valid;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * record_check checks that the simulated EEPROM holds the framed record, and
+ * that a read through a reloaded shadow returns it.
+ *
+ * @param   record_bytes    numberOfBytesToWrite for the record.
+ * @retval  bool_t          TRUE if the record is there.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_check(const uint16_t record_bytes)
+{
+    rs_queue_status_t   status;
+    uint16_t            length;
+    uint32_t            i;
+    bool_t              b_matches = TRUE;
+
+    (void)flash_sim_backdoor_read(STORAGE_DEVICE_I2C_EEPROM, XDI_ADDRESS,
+                                  (uint32_t)record_bytes + 2u, &m_read[0]);
+
+    for (i = 0u; i < ((uint32_t)record_bytes + 2u); i++)
+    {
+        if (m_read[i] != m_buffer[RECORD_START_IDX + i])
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    /* The read drops the two length bytes. */
+    XDIMEMORY_ShadowDiscard_TDD();
+
+    if ( (!XDIMEMORY_ReadRequest(&m_read[0], &length, &status))
+            || (length != record_bytes) )
+    {
+        b_matches = FALSE;
+    }
+
+    for (i = 0u; i < ((uint32_t)record_bytes - 2u); i++)
+    {
+        if (m_read[i] != m_buffer[DATA_START_IDX + i])
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+#endif /* UNIT_TEST_BUILD */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,475 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        host_stubs.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host side replacements for the target only parts of the tree.
+ * @details
+ * The host programs link the recording system, the flash HAL and the device
+ * drivers against flash_sim.c.  This module provides what those modules
+ * otherwise get from the target build:
+ *
+ *  - The peripheral register structures which genericIO.c, spi.c, i2c.c and
+ *    sci.c refer to (they are placed by the linker command file on the
+ *    target).
+ *  - The millisecond timer, run from the simulated clock, so that the flash
+ *    HAL's erase suspend timing follows the simulated devices.
+ *  - The RTOS semaphore give used by rsapi.c, which has nothing to wake here.
+ *  - The loader reply functions (normally in comm.c) used by the opcodes,
+ *    which hand each reply to the test which set a hook, instead of sending
+ *    it.
+ *  - The flash programming functions (normally tool_specific_programming.c
+ *    and the flash API), which hand each program to the test which set a
+ *    hook.  host_program_memory_install() sets a hook which models the
+ *    download buffer and the application partition, with the buffer and
+ *    flash read and written through genericIO as on the target, so that
+ *    prom_hardware.c and the download opcodes can be run.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include "common_data_types.h"
+#include "DSP28335_device.h"
+#include "timer.h"
+#include "tool_specific_hardware.h"
+#include "comm.h"
+#include "genericIO.h"
+#include "tool_specific_config.h"
+#include "tool_specific_programming.h"
+#include "flash_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define NS_PER_TIMER_TICK           1000000u    ///< The timer counts milliseconds.
+
+/// Words of the application partition modelled, including its CRC.
+#define PROGRAM_FLASH_WORDS         ((uint32_t)APPLICATION_END_ADDRESS - APPLICATION_START_ADDRESS + 1u)
+
+
+// ----------------------------------------------------------------------------
+// Variables with global scope:
+
+volatile struct GPIO_DATA_REGS  GpioDataRegs;
+volatile struct SPI_REGS        SpiaRegs;
+volatile struct I2C_REGS        I2caRegs;
+volatile struct SCI_REGS        SciaRegs;
+volatile struct SCI_REGS        ScibRegs;
+volatile struct SCI_REGS        ScicRegs;
+volatile struct PIE_CTRL_REGS   PieCtrlRegs;
+
+int xSemaphoreGive(void* p_semaphore);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// Where the loader calls go, or NULL to drop them.
+static host_loader_hook_t   m_loader_hook = NULL;
+
+/// Where the flash programs go, or NULL to fail them.
+static host_flash_program_hook_t    m_flash_program_hook = NULL;
+
+/// The download buffer and application partition, while installed.
+static bool_t       m_b_program_memory_installed = FALSE;
+static uint16_t     m_program_buffer[BUFFER_LENGTH];
+static uint16_t     m_program_flash[PROGRAM_FLASH_WORDS];
+static uint32_t     m_programs;             ///< Programs since installed.
+static uint32_t     m_program_to_fail;      ///< Program which fails, 0 for none.
+
+static uint16_t (*m_saved_16bit_read)(const uint32_t address);
+static void     (*m_saved_16bit_write)(const uint32_t address, const uint16_t data);
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   program_memory_program(const uint32_t flash_address,
+                                       const void* const p_buffer,
+                                       const uint32_t length);
+
+static uint16_t program_memory_16bit_read(const uint32_t address);
+
+static void     program_memory_16bit_write(const uint32_t address, const uint16_t data);
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificHardware_TimerRawTimeGet returns the simulated time in
+ * milliseconds.
+ *
+ * @retval  Uint32      Simulated time, in timer ticks.
+ *
+ */
+// ----------------------------------------------------------------------------
+Uint32 ToolSpecificHardware_TimerRawTimeGet(void)
+{
+    return (Uint32)(flash_sim_time_ns_get() / NS_PER_TIMER_TICK);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * xSemaphoreGive stands in for the RTOS call.  Nothing waits on a semaphore
+ * in the host programs.
+ *
+ * @param   p_semaphore     Semaphore handle (unused).
+ * @retval  int             Always 1 (pdTRUE).
+ *
+ */
+// ----------------------------------------------------------------------------
+int xSemaphoreGive(void* p_semaphore)
+{
+    (void)p_semaphore;
+
+    return 1;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * host_loader_hook_set sets the function to be called for each loader reply
+ * function called by an opcode.
+ *
+ * @param   hook        Function to call, or NULL to drop the replies.
+ *
+ */
+// ----------------------------------------------------------------------------
+void host_loader_hook_set(const host_loader_hook_t hook)
+{
+    m_loader_hook = hook;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * The loader reply functions used by the opcodes, as in comm.c.
+ */
+// ----------------------------------------------------------------------------
+void loader_MessageSend(Uint8 Status, Uint16 LengthOfDataInBytes, char* pData)
+{
+    if (m_loader_hook != NULL)
+    {
+        m_loader_hook(HOST_LOADER_SEND, Status, LengthOfDataInBytes, (const uint8_t*)pData);
+    }
+}
+
+void loader_MessageStreamStart(void)
+{
+    if (m_loader_hook != NULL)
+    {
+        m_loader_hook(HOST_LOADER_STREAM_START, 0u, 0u, NULL);
+    }
+}
+
+void loader_MessageStreamSend(Uint8 Status, Uint16 LengthOfDataInBytes, unsigned char* pFrame)
+{
+    if (m_loader_hook != NULL)
+    {
+        m_loader_hook(HOST_LOADER_STREAM_SEND, Status, LengthOfDataInBytes,
+                      &pFrame[LOADER_STREAM_PREFIX_LENGTH]);
+    }
+}
+
+void loader_MessageStreamEnd(void)
+{
+    if (m_loader_hook != NULL)
+    {
+        m_loader_hook(HOST_LOADER_STREAM_END, 0u, 0u, NULL);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * host_flash_program_hook_set sets the function to be called for each flash
+ * program, in place of the flash API.
+ *
+ * @param   hook        Function to call, or NULL to fail every program.
+ *
+ */
+// ----------------------------------------------------------------------------
+void host_flash_program_hook_set(const host_flash_program_hook_t hook)
+{
+    m_flash_program_hook = hook;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificProgramming_SafeFlashProgram hands the program to the hook.
+ *
+ * @param   pFlashAddress           Flash address to program.
+ * @param   pBufferAddress          Data to program.
+ * @param   Length                  Number of words.
+ * @param   pFlashProgrammingStatus Not used.
+ * @retval  bool_t                  What the hook returned, FALSE if none.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ToolSpecificProgramming_SafeFlashProgram(void* pFlashAddress,
+                                                void* pBufferAddress,
+                                                uint32_t Length,
+                                                FlashStatus_t* pFlashProgrammingStatus)
+{
+    bool_t  b_programmed = FALSE;
+
+    pFlashProgrammingStatus->FlashStatusCode = 0u;
+
+    if (m_flash_program_hook != NULL)
+    {
+        b_programmed = m_flash_program_hook((uint32_t)(uintptr_t)pFlashAddress,
+                                            pBufferAddress, Length);
+    }
+
+    return b_programmed;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ToolSpecificProgramming_SafeFlashErase erases the modelled application
+ * partition, if installed, whichever sectors are asked for.
+ *
+ * @param   SectorMask          Not used.
+ * @param   pFlashEraseStatus   Set to no error.
+ * @retval  bool_t              Always TRUE.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t ToolSpecificProgramming_SafeFlashErase(uint16_t SectorMask, FlashStatus_t* pFlashEraseStatus)
+{
+    uint32_t    word;
+
+    (void)SectorMask;
+
+    pFlashEraseStatus->FlashStatusCode = 0u;
+
+    if (m_b_program_memory_installed)
+    {
+        for (word = 0u; word < PROGRAM_FLASH_WORDS; word++)
+        {
+            m_program_flash[word] = 0xFFFFu;
+        }
+    }
+
+    return TRUE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * host_program_memory_install points genericIO and the flash programming
+ * functions at the model of the download buffer and application partition,
+ * which starts erased.
+ *
+ */
+// ----------------------------------------------------------------------------
+void host_program_memory_install(void)
+{
+    uint32_t    word;
+
+    for (word = 0u; word < BUFFER_LENGTH; word++)
+    {
+        m_program_buffer[word] = 0u;
+    }
+
+    for (word = 0u; word < PROGRAM_FLASH_WORDS; word++)
+    {
+        m_program_flash[word] = 0xFFFFu;
+    }
+
+    m_programs = 0u;
+    m_program_to_fail = 0u;
+
+    m_saved_16bit_read = genericIO_16bitRead;
+    m_saved_16bit_write = genericIO_16bitWrite;
+    genericIO_16bitRead = program_memory_16bit_read;
+    genericIO_16bitWrite = program_memory_16bit_write;
+
+    host_flash_program_hook_set(program_memory_program);
+
+    m_b_program_memory_installed = TRUE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * host_program_memory_remove puts genericIO back as it was, and fails any
+ * further programs.
+ *
+ */
+// ----------------------------------------------------------------------------
+void host_program_memory_remove(void)
+{
+    if (m_b_program_memory_installed)
+    {
+        genericIO_16bitRead = m_saved_16bit_read;
+        genericIO_16bitWrite = m_saved_16bit_write;
+
+        host_flash_program_hook_set(NULL);
+
+        m_b_program_memory_installed = FALSE;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * host_program_memory_fail_set makes one program fail, without programming
+ * anything, as a flash fault would.
+ *
+ * @param   program     Program to fail, counting from 1 since installed, or
+ *                      0 for none.
+ *
+ */
+// ----------------------------------------------------------------------------
+void host_program_memory_fail_set(const uint32_t program)
+{
+    m_program_to_fail = program;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * host_program_memory_programs_get returns the number of programs made
+ * since the model was installed, including any which failed.
+ *
+ * @retval  uint32_t    Programs made.
+ *
+ */
+// ----------------------------------------------------------------------------
+uint32_t host_program_memory_programs_get(void)
+{
+    return m_programs;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * host_program_memory_flash_get reads a word of the modelled application
+ * partition.
+ *
+ * @param   address     Flash address.
+ * @retval  uint16_t    Word at the address (0xFFFF outside the partition).
+ *
+ */
+// ----------------------------------------------------------------------------
+uint16_t host_program_memory_flash_get(const uint32_t address)
+{
+    uint16_t    data = 0xFFFFu;
+
+    if ( (address >= APPLICATION_START_ADDRESS)
+            && ((address - APPLICATION_START_ADDRESS) < PROGRAM_FLASH_WORDS) )
+    {
+        data = m_program_flash[address - APPLICATION_START_ADDRESS];
+    }
+
+    return data;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * program_memory_program programs the modelled application partition from
+ * the modelled download buffer, as prom_hardware.c programs the flash from
+ * BUFFER_BASE_ADDRESS.  Bits can only be cleared.
+ *
+ * @param   flash_address   Flash address to program.
+ * @param   p_buffer        Address in the download buffer, as a pointer.
+ * @param   length          Number of words.
+ * @retval  bool_t          TRUE if programmed, FALSE if out of range or the
+ *                          program set to fail.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t program_memory_program(const uint32_t flash_address,
+                                     const void* const p_buffer,
+                                     const uint32_t length)
+{
+    const uint32_t  buffer_address = (uint32_t)(uintptr_t)p_buffer;
+    uint32_t        word;
+    bool_t          b_programmed = FALSE;
+
+    m_programs++;
+
+    if ( (m_programs != m_program_to_fail)
+            && (buffer_address >= BUFFER_BASE_ADDRESS)
+            && ((buffer_address - BUFFER_BASE_ADDRESS + length) <= BUFFER_LENGTH)
+            && (flash_address >= APPLICATION_START_ADDRESS)
+            && ((flash_address - APPLICATION_START_ADDRESS + length) <= PROGRAM_FLASH_WORDS) )
+    {
+        for (word = 0u; word < length; word++)
+        {
+            m_program_flash[flash_address - APPLICATION_START_ADDRESS + word]
+                &= m_program_buffer[buffer_address - BUFFER_BASE_ADDRESS + word];
+        }
+
+        b_programmed = TRUE;
+    }
+
+    return b_programmed;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * program_memory_16bit_read reads the modelled download buffer or
+ * application partition.  Anything else reads as erased flash.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t program_memory_16bit_read(const uint32_t address)
+{
+    uint16_t    data;
+
+    if ( (address >= BUFFER_BASE_ADDRESS)
+            && ((address - BUFFER_BASE_ADDRESS) < BUFFER_LENGTH) )
+    {
+        data = m_program_buffer[address - BUFFER_BASE_ADDRESS];
+    }
+    else
+    {
+        data = host_program_memory_flash_get(address);
+    }
+
+    return data;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * program_memory_16bit_write writes the modelled download buffer.  Writes
+ * anywhere else are dropped, as flash can't be written this way.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void program_memory_16bit_write(const uint32_t address, const uint16_t data)
+{
+    if ( (address >= BUFFER_BASE_ADDRESS)
+            && ((address - BUFFER_BASE_ADDRESS) < BUFFER_LENGTH) )
+    {
+        m_program_buffer[address - BUFFER_BASE_ADDRESS] = data;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
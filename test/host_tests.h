@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        host_tests.h
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host checks run by sim_runner.c, besides the *_sim modules.
+ * @note        Each test_*.c module provides one or more checks, returning
+ *              TRUE if they pass.  Add them to HOST_TESTS to have them run.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+#ifndef TEST_HOST_TESTS_H_
+#define TEST_HOST_TESTS_H_
+
+/**
+ * What the opcode being tested asked the loader (comm.c) to do - see
+ * host_loader_hook_set() in host_stubs.c.
+ */
+typedef enum
+{
+    HOST_LOADER_SEND,               ///< loader_MessageSend.
+    HOST_LOADER_STREAM_START,       ///< loader_MessageStreamStart.
+    HOST_LOADER_STREAM_SEND,        ///< loader_MessageStreamSend.
+    HOST_LOADER_STREAM_END          ///< loader_MessageStreamEnd.
+} host_loader_call_t;
+
+/// Called for each loader call, with the status and data of any reply.
+typedef void (*host_loader_hook_t)(const host_loader_call_t call,
+                                   const uint8_t status,
+                                   const uint16_t length,
+                                   const uint8_t* const p_data);
+
+void    host_loader_hook_set(const host_loader_hook_t hook);
+
+/// Called for each ToolSpecificProgramming_SafeFlashProgram, with the flash
+/// address, the buffer to program from and the number of words, in place of
+/// the flash API.  Returns TRUE if programmed.
+typedef bool_t (*host_flash_program_hook_t)(const uint32_t flash_address,
+                                            const void* const p_buffer,
+                                            const uint32_t length);
+
+void        host_flash_program_hook_set(const host_flash_program_hook_t hook);
+
+void        host_program_memory_install(void);
+void        host_program_memory_remove(void);
+void        host_program_memory_fail_set(const uint32_t program);
+uint32_t    host_program_memory_programs_get(void);
+uint16_t    host_program_memory_flash_get(const uint32_t address);
+
+bool_t  test_blank_cache_check(void);
+bool_t  test_crc_engines_check(void);
+bool_t  test_dump_codec_check(void);
+bool_t  test_format_check(void);
+bool_t  test_free_address_check(void);
+bool_t  test_image_verify_check(void);
+bool_t  test_m95_cache_check(void);
+bool_t  test_opcode013_check(void);
+bool_t  test_opcode040_check(void);
+bool_t  test_opcode046_check(void);
+bool_t  test_opcode191_check(void);
+bool_t  test_opcode204_check(void);
+bool_t  test_opcode219_check(void);
+bool_t  test_page_batch_check(void);
+bool_t  test_prom_hardware_check(void);
+bool_t  test_record_index_check(void);
+bool_t  test_ring_log_check(void);
+bool_t  test_serial_comm_check(void);
+bool_t  test_x24lc32a_cache_check(void);
+bool_t  test_xdi_shadow_check(void);
+
+/// Entries for the sim_runner list of checks.
+#define HOST_TESTS                                          \
+    { "blank_cache",        test_blank_cache_check },           \
+    { "crc_engines",        test_crc_engines_check },           \
+    { "dump_codec",         test_dump_codec_check },            \
+    { "format",             test_format_check },                \
+    { "free_address",       test_free_address_check },          \
+    { "image_verify",       test_image_verify_check },          \
+    { "m95_cache",          test_m95_cache_check },             \
+    { "opcode013",          test_opcode013_check },             \
+    { "opcode040",          test_opcode040_check },             \
+    { "opcode046",          test_opcode046_check },             \
+    { "opcode191",          test_opcode191_check },             \
+    { "opcode204",          test_opcode204_check },             \
+    { "opcode219",          test_opcode219_check },             \
+    { "page_batch",         test_page_batch_check },            \
+    { "prom_hardware",      test_prom_hardware_check },         \
+    { "record_index",       test_record_index_check },          \
+    { "ring_log",           test_ring_log_check },              \
+    { "serial_comm",        test_serial_comm_check },           \
+    { "x24lc32a_cache",     test_x24lc32a_cache_check },        \
+    { "xdi_shadow",         test_xdi_shadow_check },
+
+#endif /* TEST_HOST_TESTS_H_ */
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
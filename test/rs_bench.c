@@ -0,0 +1,379 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        rs_bench.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host benchmark of the recording system on the simulated flash.
+ * @details
+ * Runs the recording system against flash_sim.c, with the partitions laid
+ * out by RS_CFG_PARTITION_SETTINGS, and times it with the simulated clock:
+ *
+ *  - rsapi_recording_system_init - once on blank devices, then repeatedly
+ *    once every partition holds data.
+ *  - rspartition_format_partition - each partition in turn.
+ *  - rspages_page_data_write - BENCH_WRITES records into each partition.
+ *  - rssearch_find_valid_RSR_start - backwards from the next free address
+ *    to a pseudo-random instance in each partition.  The record found must
+ *    be the one written at that position.
+ *
+ * For each operation the throughput and the 50th, 90th and 99th percentile
+ * and the longest latency are printed.  The times are simulated, so they
+ * don't depend on the host and can be compared from one build to the next.
+ * The program returns non-zero if any operation fails, so that it can be run
+ * by "make -C test bench".
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rspages.h"
+#include "rspartition.h"
+#include "rssearch.h"
+#include "m95.h"
+#include "spi.h"
+#include "flash_sim.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define BENCH_WRITES                100u        ///< Records written into each partition.
+#define BENCH_TDR_BYTES             64u         ///< Size of each TDR.
+#define BENCH_SEARCHES              100u        ///< Searches made in each partition.
+#define BENCH_INITS                 20u         ///< Initialisations once there is data.
+#define BENCH_FIRST_RECORD_ID       0x0100u     ///< Record ID of the first record written.
+#define BENCH_MAX_SAMPLES           (BENCH_WRITES * RS_CFG_MAX_NUMBER_OF_PARTITIONS)
+
+
+// ----------------------------------------------------------------------------
+// Types section:
+
+/**
+ * Latencies of one operation, in simulated nanoseconds.
+ */
+typedef struct
+{
+    const char* p_name;                     ///< Operation name, as printed.
+    uint64_t    sample_ns[BENCH_MAX_SAMPLES];   ///< Latency of each call.
+    uint32_t    samples;                    ///< Number of calls.
+    uint64_t    bytes;                      ///< Bytes handled, for the throughput.
+    uint32_t    failures;                   ///< Calls which failed.
+} bench_operation_t;
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     sample_add(bench_operation_t * const p_operation,
+                           const uint64_t start_ns,
+                           const uint32_t bytes,
+                           const bool_t b_ok);
+
+static void     operation_print(bench_operation_t * const p_operation);
+
+static int      ns_compare(const void* p_a, const void* p_b);
+
+static bool_t   record_write(const uint8_t partition_index,
+                             const uint16_t record_id);
+
+static bool_t   record_find(const uint8_t partition_index,
+                            const uint32_t instance,
+                            const uint16_t expected_record_id);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static bench_operation_t    m_init_blank    = { "init (blank)", { 0u }, 0u, 0u, 0u };
+static bench_operation_t    m_init_mounted  = { "init (data)", { 0u }, 0u, 0u, 0u };
+static bench_operation_t    m_format        = { "format", { 0u }, 0u, 0u, 0u };
+static bench_operation_t    m_write         = { "page_data_write", { 0u }, 0u, 0u, 0u };
+static bench_operation_t    m_search        = { "find_valid_RSR", { 0u }, 0u, 0u, 0u };
+
+static uint8_t              m_write_buffer[RSAPI_BYTES_BEFORE_TDR + BENCH_TDR_BYTES
+                                            + RSAPI_BYTES_AFTER_TDR];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * main runs each operation on every partition and prints the results.
+ *
+ * @retval  int     0 if every operation succeeded, 1 otherwise.
+ *
+ */
+// ----------------------------------------------------------------------------
+int main(void)
+{
+    const rs_partition_info_t*  p_partition;
+    uint64_t    start_ns;
+    uint32_t    partition_bytes;
+    uint32_t    i;
+    uint32_t    instance;
+    uint8_t     partition_index;
+    uint8_t     progress;
+    bool_t      b_ok;
+
+    flash_sim_install();
+    flash_sim_reset();
+    M95_DeviceSizeInitialise(128u, 65536u);
+    SPI_Open(8u);
+    srand(1u);
+
+    start_ns = flash_sim_time_ns_get();
+    sample_add(&m_init_blank, start_ns, 0u, rsapi_recording_system_init());
+
+    for (partition_index = 0u; partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS; partition_index++)
+    {
+        p_partition     = rspartition_partition_ptr_get(partition_index);
+        partition_bytes = (p_partition->end_address - p_partition->start_address) + 1u;
+
+        start_ns = flash_sim_time_ns_get();
+        b_ok = (rspartition_format_partition(partition_index, &progress) == RS_ERR_NO_ERROR);
+        sample_add(&m_format, start_ns, partition_bytes, b_ok);
+    }
+
+    for (partition_index = 0u; partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS; partition_index++)
+    {
+        for (i = 0u; i < BENCH_WRITES; i++)
+        {
+            start_ns = flash_sim_time_ns_get();
+            b_ok = record_write(partition_index, (uint16_t)(BENCH_FIRST_RECORD_ID + i));
+            sample_add(&m_write, start_ns, BENCH_TDR_BYTES, b_ok);
+        }
+    }
+
+    for (partition_index = 0u; partition_index < RS_CFG_MAX_NUMBER_OF_PARTITIONS; partition_index++)
+    {
+        for (i = 0u; i < BENCH_SEARCHES; i++)
+        {
+            instance = (uint32_t)rand() % BENCH_WRITES;
+
+            start_ns = flash_sim_time_ns_get();
+            b_ok = record_find(partition_index, instance,
+                               (uint16_t)((BENCH_FIRST_RECORD_ID + BENCH_WRITES - 1u) - instance));
+            sample_add(&m_search, start_ns, BENCH_TDR_BYTES, b_ok);
+        }
+    }
+
+    for (i = 0u; i < BENCH_INITS; i++)
+    {
+        start_ns = flash_sim_time_ns_get();
+        sample_add(&m_init_mounted, start_ns, 0u, rsapi_recording_system_init());
+    }
+
+    printf("%-18s %8s %12s %10s %10s %10s %10s %8s\n",
+           "operation", "calls", "kbyte/s", "p50 us", "p90 us", "p99 us", "max us", "failed");
+
+    operation_print(&m_init_blank);
+    operation_print(&m_format);
+    operation_print(&m_write);
+    operation_print(&m_search);
+    operation_print(&m_init_mounted);
+
+    b_ok = ( (m_init_blank.failures == 0u) && (m_format.failures == 0u)
+                && (m_write.failures == 0u) && (m_search.failures == 0u)
+                && (m_init_mounted.failures == 0u) );
+
+    return b_ok ? 0 : 1;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * sample_add records the latency of one call.
+ *
+ * @param   p_operation     Operation the call was for.
+ * @param   start_ns        Simulated time when the call was made.
+ * @param   bytes           Bytes handled by the call.
+ * @param   b_ok            TRUE if the call succeeded.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void sample_add(bench_operation_t * const p_operation,
+                       const uint64_t start_ns,
+                       const uint32_t bytes,
+                       const bool_t b_ok)
+{
+    if (p_operation->samples < BENCH_MAX_SAMPLES)
+    {
+        p_operation->sample_ns[p_operation->samples] = flash_sim_time_ns_get() - start_ns;
+        p_operation->samples++;
+    }
+
+    p_operation->bytes += bytes;
+
+    if (!b_ok)
+    {
+        p_operation->failures++;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * operation_print prints the throughput and latency percentiles of an
+ * operation.
+ *
+ * @param   p_operation     Operation to print (its samples are sorted).
+ *
+ */
+// ----------------------------------------------------------------------------
+static void operation_print(bench_operation_t * const p_operation)
+{
+    uint64_t    total_ns = 0u;
+    uint64_t    kbytes_per_s = 0u;
+    uint32_t    n = p_operation->samples;
+    uint32_t    i;
+
+    if (n != 0u)
+    {
+        qsort(p_operation->sample_ns, n, sizeof(p_operation->sample_ns[0]), ns_compare);
+
+        for (i = 0u; i < n; i++)
+        {
+            total_ns += p_operation->sample_ns[i];
+        }
+
+        if (total_ns != 0u)
+        {
+            kbytes_per_s = (p_operation->bytes * 1000000u) / total_ns;
+        }
+
+        printf("%-18s %8u ", p_operation->p_name, n);
+
+        if (p_operation->bytes != 0u)
+        {
+            printf("%12llu ", (unsigned long long)kbytes_per_s);
+        }
+        else
+        {
+            printf("%12s ", "-");
+        }
+
+        printf("%10llu %10llu %10llu %10llu %8u\n",
+               (unsigned long long)(p_operation->sample_ns[(n * 50u) / 100u] / 1000u),
+               (unsigned long long)(p_operation->sample_ns[(n * 90u) / 100u] / 1000u),
+               (unsigned long long)(p_operation->sample_ns[(n * 99u) / 100u] / 1000u),
+               (unsigned long long)(p_operation->sample_ns[n - 1u] / 1000u),
+               p_operation->failures);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ns_compare orders latencies for qsort.
+ *
+ */
+// ----------------------------------------------------------------------------
+static int ns_compare(const void* p_a, const void* p_b)
+{
+    const uint64_t a = *(const uint64_t*)p_a;
+    const uint64_t b = *(const uint64_t*)p_b;
+
+    return (a > b) - (a < b);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * record_write writes one record with rspages_page_data_write, as the read \
+ * write task does.  The TDR is made from the record ID.
+ *
+ * @param   partition_index     Partition to write into.
+ * @param   record_id           Record ID to write.
+ * @retval  bool_t              TRUE if the record was written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_write(const uint8_t partition_index,
+                           const uint16_t record_id)
+{
+    const rs_partition_info_t*  p_partition;
+    rs_page_write_t             write_data;
+    rs_page_write_status_t      status;
+    uint32_t                    i;
+
+    p_partition = rspartition_partition_ptr_get(partition_index);
+
+    for (i = 0u; i < BENCH_TDR_BYTES; i++)
+    {
+        m_write_buffer[RSAPI_BYTES_BEFORE_TDR + i] = (uint8_t)((record_id * 7u) + i);
+    }
+
+    write_data.partition_index              = partition_index;
+    write_data.partition_id                 = p_partition->id;
+    write_data.partition_logical_start_addr = p_partition->start_address;
+    write_data.partition_logical_end_addr   = p_partition->end_address;
+    write_data.next_free_addr               = p_partition->next_available_address;
+    write_data.record_id                    = record_id;
+    write_data.p_write_buffer               = &m_write_buffer[0];
+    write_data.bytes_to_write               = (uint16_t)sizeof(m_write_buffer);
+    write_data.b_read_back_write_command    = TRUE;
+
+    status = rspages_page_data_write(&write_data);
+
+    return ( (status == RS_PG_WRITE_OK) || (status == RS_PG_WRITE_OK_PAGE_FULL) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * record_find searches backwards from the next free address for a record
+ * instance, and checks that the one found has the expected record ID.
+ *
+ * @param   partition_index     Partition to search.
+ * @param   instance            Record instance, 0 for the newest.
+ * @param   expected_record_id  Record ID written at that position.
+ * @retval  bool_t              TRUE if the record was found.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_find(const uint8_t partition_index,
+                          const uint32_t instance,
+                          const uint16_t expected_record_id)
+{
+    const rs_partition_info_t*  p_partition;
+    rssearch_search_data_t      search_data;
+    bool_t                      b_found;
+
+    p_partition = rspartition_partition_ptr_get(partition_index);
+
+    search_data.search_direction                = RSSEARCH_BACKWARDS;
+    search_data.partition_logical_start_address = p_partition->start_address;
+    search_data.partition_logical_end_address   = p_partition->end_address;
+    search_data.search_start_address            = p_partition->next_available_address;
+    search_data.required_record_instance        = instance;
+    search_data.b_match_record_id               = FALSE;
+    search_data.required_record_id              = 0u;
+    search_data.b_ring_wrapped                  = FALSE;
+    search_data.ring_oldest_address             = p_partition->start_address;
+    search_data.ring_next_free_address          = p_partition->next_available_address;
+
+    b_found = rssearch_find_valid_RSR_start(&search_data);
+
+    return ( (b_found)
+                && (rssearch_valid_rsr_pointer_get()->record_id == expected_record_id) );
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
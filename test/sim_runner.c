@@ -0,0 +1,472 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        sim_runner.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Runs every host simulation and checks its results.
+ * @details
+ * Each *_sim module in source/ measures one change against the simulated
+ * devices, and reports whether the data came out as it went in.  This
+ * program runs each of them with its default configuration, prints the
+ * headline numbers, and fails if any of them reports a mismatch, or if the
+ * new path is no better than the one it replaced.
+ *
+ * Checks which need more than a sim's default run are in the test_*.c
+ * modules, listed in host_tests.h, and are run from here as well.
+ *
+ * Run with "make -C test check".  Returns the number of failures.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdio.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rspartition.h"
+#include "m95.h"
+#include "spi.h"
+#include "flash_sim.h"
+#include "download_sim.h"
+#include "dual_die_sim.h"
+#include "erase_suspend_sim.h"
+#include "fast_dump_sim.h"
+#include "flash_read_sim.h"
+#include "format_sim.h"
+#include "free_address_sim.h"
+#include "m95_cache_sim.h"
+#include "ring_log_sim.h"
+#include "spi_burst_sim.h"
+#include "x24lc32a_cache_sim.h"
+#include "xdi_shadow_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Types section:
+
+/**
+ * One entry in the list of checks.
+ */
+typedef struct
+{
+    const char* p_name;                 ///< Name, as printed.
+    bool_t      (*p_check)(void);       ///< Runs the check, TRUE if it passed.
+} sim_runner_check_t;
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   download_check(void);
+static bool_t   fast_dump_check(void);
+static bool_t   flash_read_check(void);
+static bool_t   free_address_check(void);
+static bool_t   format_check(void);
+static bool_t   erase_suspend_check(void);
+static bool_t   dual_die_check(void);
+static bool_t   ring_log_check(void);
+static bool_t   m95_cache_check(void);
+static bool_t   spi_burst_check(void);
+static bool_t   x24lc32a_cache_check(void);
+static bool_t   xdi_shadow_check(void);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static const sim_runner_check_t m_checks[] =
+{
+    { "download_sim",       download_check },
+    { "fast_dump_sim",      fast_dump_check },
+    { "flash_read_sim",     flash_read_check },
+    { "free_address_sim",   free_address_check },
+    { "format_sim",         format_check },
+    { "erase_suspend_sim",  erase_suspend_check },
+    { "dual_die_sim",       dual_die_check },
+    { "ring_log_sim",       ring_log_check },
+    { "m95_cache_sim",      m95_cache_check },
+    { "spi_burst_sim",      spi_burst_check },
+    { "x24lc32a_cache_sim", x24lc32a_cache_check },
+    { "xdi_shadow_sim",     xdi_shadow_check },
+    HOST_TESTS
+};
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * main runs every check in turn.  The devices are installed and the serial
+ * flash set up first, as the target does at start up.
+ *
+ * @retval  int     Number of checks which failed.
+ *
+ */
+// ----------------------------------------------------------------------------
+int main(void)
+{
+    uint32_t    i;
+    int         failures = 0;
+
+    flash_sim_install();
+    M95_DeviceSizeInitialise(128u, 65536u);
+    SPI_Open(8u);
+
+    for (i = 0u; i < (sizeof(m_checks) / sizeof(m_checks[0])); i++)
+    {
+        printf("%-20s ", m_checks[i].p_name);
+        (void)fflush(stdout);
+
+        if (m_checks[i].p_check())
+        {
+            printf("  PASS\n");
+        }
+        else
+        {
+            printf("  FAIL\n");
+            failures++;
+        }
+    }
+
+    printf("%d of %u checks failed\n", failures,
+           (unsigned)(sizeof(m_checks) / sizeof(m_checks[0])));
+
+    return failures;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * download_check - programming overlapped with reception must hide program
+ * time, and finish sooner than the single buffered download.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t download_check(void)
+{
+    download_sim_config_t   config;
+    download_sim_result_t   single;
+    download_sim_result_t   overlapped;
+
+    download_sim_config_default(&config);
+    config.b_double_buffered = FALSE;
+    download_sim_run(&config, &single);
+    config.b_double_buffered = TRUE;
+    download_sim_run(&config, &overlapped);
+
+    printf("%llu -> %llu us", (unsigned long long)single.total_us,
+           (unsigned long long)overlapped.total_us);
+
+    return ( (overlapped.total_us < single.total_us)
+                && (overlapped.program_hidden_us != 0u)
+                && (overlapped.total_us >= overlapped.link_limited_us) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * fast_dump_check - preparing the next frame while this one is sent must
+ * finish sooner than the blocking dump.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t fast_dump_check(void)
+{
+    fast_dump_sim_config_t  config;
+    fast_dump_sim_result_t  blocking;
+    fast_dump_sim_result_t  overlapped;
+
+    fast_dump_sim_config_default(&config);
+    config.b_overlapped = FALSE;
+    fast_dump_sim_run(&config, &blocking);
+    config.b_overlapped = TRUE;
+    fast_dump_sim_run(&config, &overlapped);
+
+    printf("%llu -> %llu us, link %u%%", (unsigned long long)blocking.total_us,
+           (unsigned long long)overlapped.total_us, overlapped.link_utilisation_percent);
+
+    return ( (overlapped.total_us < blocking.total_us)
+                && (overlapped.total_us >= overlapped.wire_us) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * flash_read_check - the burst paths must read the same data as the word
+ * loop, with fewer address set ups.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t flash_read_check(void)
+{
+    flash_read_sim_config_t config;
+    flash_read_sim_result_t result;
+    bool_t                  b_valid;
+
+    flash_read_sim_config_default(&config);
+    b_valid = flash_read_sim_run(&config, &result);
+
+    printf("setups %u -> %u", result.word_loop.address_setups,
+           result.burst_words.address_setups);
+
+    return ( (b_valid) && (result.b_data_matches)
+                && (result.burst_words.address_setups < result.word_loop.address_setups) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * free_address_check - the probe search must find the end of the data on
+ * every page, at every fill level.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t free_address_check(void)
+{
+    free_address_sim_config_t   config;
+    free_address_sim_result_t   result;
+    bool_t                      b_valid;
+
+    free_address_sim_config_default(&config);
+    b_valid = free_address_sim_run(&config, &result);
+
+    printf("mismatches %u", result.mismatches);
+
+    return ( (b_valid) && (result.mismatches == 0u) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * format_check - a stepped format must complete, refuse writes into the
+ * partition, and leave traffic in the other partition intact.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t format_check(void)
+{
+    format_sim_config_t config;
+    format_sim_result_t result;
+    bool_t              b_valid;
+
+    format_sim_config_default(&config);
+    b_valid = format_sim_run(&config, &result);
+
+    printf("%u steps, longest %llu us", result.steps,
+           (unsigned long long)result.longest_step_us);
+
+    return ( (b_valid)
+                && (result.format_status == RS_ERR_NO_ERROR)
+                && (result.b_progress_ok)
+                && (result.traffic_write_failures == 0u)
+                && (result.traffic_read_mismatches == 0u)
+                && (result.writes_not_refused == 0u)
+                && (result.b_partition_usable) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * erase_suspend_check - reads during a background erase must return the
+ * flash contents, and the erase must never be suspended too early.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t erase_suspend_check(void)
+{
+    erase_suspend_sim_config_t  config;
+    erase_suspend_sim_result_t  result;
+    bool_t                      b_valid;
+
+    erase_suspend_sim_config_default(&config);
+    b_valid = erase_suspend_sim_run(&config, &result);
+
+    printf("longest read %llu us, erase %llu us",
+           (unsigned long long)result.same_die.longest_us,
+           (unsigned long long)result.blocking_erase_us);
+
+    return ( (b_valid)
+                && (result.b_erase_ok)
+                && (result.b_data_matches)
+                && (result.early_suspends == 0u)
+                && (result.suspended_sector_reads == 0u)
+                && (result.erase_suspends == result.erase_resumes)
+                && (result.same_die.longest_us < result.blocking_erase_us) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * dual_die_check - erasing and writing both devices together must leave the
+ * same contents as one at a time, in less time.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t dual_die_check(void)
+{
+    dual_die_sim_config_t   config;
+    dual_die_sim_result_t   result;
+    bool_t                  b_valid;
+
+    dual_die_sim_config_default(&config);
+    b_valid = dual_die_sim_run(&config, &result);
+
+    printf("erase %llu -> %llu us", (unsigned long long)result.serial_erase_us,
+           (unsigned long long)result.parallel_erase_us);
+
+    return ( (b_valid)
+                && (result.b_erased)
+                && (result.b_data_matches)
+                && (result.parallel_erase_us < result.serial_erase_us)
+                && (result.parallel_write_us <= result.serial_write_us) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ring_log_check - the ring log must keep every record written since the
+ * oldest one kept, and mount back to the same place.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t ring_log_check(void)
+{
+    ring_log_sim_config_t   config;
+    ring_log_sim_result_t   result;
+    bool_t                  b_valid;
+
+    ring_log_sim_config_default(&config);
+    b_valid = ring_log_sim_run(&config, &result);
+
+    printf("%u records, longest write %llu us", result.records_written,
+           (unsigned long long)result.longest_write_us);
+
+    return ( (b_valid)
+                && (result.write_failures == 0u)
+                && (result.b_mount_matches)
+                && (result.b_no_index)
+                && (result.b_ends_ok)
+                && (result.read_mismatches == 0u)
+                && (result.bit_raise_attempts == 0u) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * m95_cache_check - the write-behind cache must read back what was written
+ * before and after the flush, with no more write cycles than before.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t m95_cache_check(void)
+{
+    m95_cache_sim_config_t  config;
+    m95_cache_sim_result_t  result;
+    bool_t                  b_valid;
+
+    m95_cache_sim_config_default(&config);
+    b_valid = m95_cache_sim_run(&config, &result);
+
+    printf("write %llu -> %llu us", (unsigned long long)result.blocking_write_us,
+           (unsigned long long)result.cached_write_us);
+
+    return ( (b_valid)
+                && (result.b_cache_reads_match)
+                && (result.b_data_matches)
+                && (result.cached_write_cycles <= result.blocking_write_cycles) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * spi_burst_check - FIFO transfers must move the same data as the word at a
+ * time transfers, faster.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t spi_burst_check(void)
+{
+    spi_burst_sim_config_t  config;
+    spi_burst_sim_result_t  result;
+    bool_t                  b_valid;
+
+    spi_burst_sim_config_default(&config);
+    b_valid = spi_burst_sim_run(&config, &result);
+
+    printf("read %u -> %u B/s", result.word.read_bytes_per_s,
+           result.burst.read_bytes_per_s);
+
+    return ( (b_valid)
+                && (result.b_read_matches)
+                && (result.b_write_matches)
+                && (result.burst.read_us < result.word.read_us) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * x24lc32a_cache_check - the EEPROM cache must read back what was written
+ * before and after the flush, with no more write cycles than before, and no
+ * single step may block for as long as the old write did.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t x24lc32a_cache_check(void)
+{
+    x24lc32a_cache_sim_config_t config;
+    x24lc32a_cache_sim_result_t result;
+    bool_t                      b_valid;
+
+    x24lc32a_cache_sim_config_default(&config);
+    b_valid = x24lc32a_cache_sim_run(&config, &result);
+
+    printf("longest call %llu -> %llu us", (unsigned long long)result.longest_blocking_us,
+           (unsigned long long)result.longest_step_us);
+
+    return ( (b_valid)
+                && (result.b_cache_reads_match)
+                && (result.b_data_matches)
+                && (result.cached_write_cycles <= result.blocking_write_cycles)
+                && (result.longest_step_us < result.longest_blocking_us) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * xdi_shadow_check - a one coefficient update must take fewer write cycles
+ * than writing the whole record, and leave the record in the EEPROM.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t xdi_shadow_check(void)
+{
+    xdi_shadow_sim_config_t config;
+    xdi_shadow_sim_result_t result;
+    bool_t                  b_valid;
+
+    xdi_shadow_sim_config_default(&config);
+    b_valid = xdi_shadow_sim_run(&config, &result);
+
+    printf("cycles %u -> %u", result.full_write_cycles, result.delta_write_cycles);
+
+    return ( (b_valid)
+                && (result.b_data_matches)
+                && (result.delta_write_cycles < result.full_write_cycles) );
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
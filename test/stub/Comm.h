@@ -0,0 +1,2 @@
+/* Host build only - the target build is not case sensitive. */
+#include "comm.h"
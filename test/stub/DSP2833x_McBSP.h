@@ -0,0 +1 @@
+/* Host build only - the McBSP registers are not used by the modules built here. */
@@ -0,0 +1,16 @@
+/* Host build only - the sector masks used by tool_specific_config.h.  The
+ * flash API itself is replaced by the ToolSpecificProgramming functions in
+ * host_stubs.c. */
+#ifndef FLASH2833X_API_LIBRARY_H
+#define FLASH2833X_API_LIBRARY_H
+
+#define SECTORA   (Uint16)0x0001
+#define SECTORB   (Uint16)0x0002
+#define SECTORC   (Uint16)0x0004
+#define SECTORD   (Uint16)0x0008
+#define SECTORE   (Uint16)0x0010
+#define SECTORF   (Uint16)0x0020
+#define SECTORG   (Uint16)0x0040
+#define SECTORH   (Uint16)0x0080
+
+#endif
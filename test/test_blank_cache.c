@@ -0,0 +1,340 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_blank_cache.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the flash_hal cache of erased main flash pages.
+ * @details
+ * Random erases, writes and blank checks are made through flash_hal on the
+ * simulated main flash, over a window of sectors either side of the die 0/1
+ * boundary.  A shadow copy of the window says what every blank check should
+ * return, so a page the cache wrongly remembers as erased shows up as a
+ * mismatch.
+ *
+ * The cache must also save the reads it was added for:
+ *  - the pages of a sector which has just been erased are known blank, with
+ *    no bus reads;
+ *  - a region which passed a blank check passes again with no bus reads;
+ *  - a region which failed is read again every time;
+ *  - flash_hal_initialise forgets everything, so the first check after it
+ *    reads the flash.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "flash_hal.h"
+#include "flash_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_OPERATIONS         20000u      ///< Random erases, writes and blank checks.
+#define TEST_SECTOR_BYTES       131072u     ///< Main flash sector size.
+#define TEST_PAGE_BYTES         (RS_CFG_PAGE_SIZE_KB * 1024u)
+#define TEST_SECTORS            4u          ///< Sectors in the window, half on each die.
+#define TEST_WINDOW_BYTES       (TEST_SECTORS * TEST_SECTOR_BYTES)
+#define TEST_DIE_BOUNDARY       0x08000000u ///< First byte address in device one.
+#define TEST_WINDOW_START       (TEST_DIE_BOUNDARY - (TEST_WINDOW_BYTES / 2u))
+#define TEST_MAX_WRITE_BYTES    (2u * TEST_PAGE_BYTES)
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+/// Whole of the main flash in the first partition, the rest just fill the map.
+#define TEST_LOGICAL_ADDRESSES                                      \
+{                                                                   \
+    { STORAGE_DEVICE_MAIN_FLASH,   0x00000000u, 0x0FFFFFFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10000000u, 0x10001FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10002000u, 0x10003FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10004000u, 0x10005FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10006000u, 0x10007FFFu },      \
+    { STORAGE_DEVICE_SERIAL_FLASH, 0x10008000u, 0x10009FFFu },      \
+    { STORAGE_DEVICE_I2C_EEPROM,   0x10010000u, 0x10010FFFu },      \
+}
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     RandomErase(void);
+
+static void     RandomWrite(void);
+
+static void     RandomBlankCheck(void);
+
+static bool_t   ShadowBlank(const uint32_t offset, const uint32_t length);
+
+static uint32_t FlashReads(void);
+
+static uint32_t Random(void);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static const flash_hal_logical_t m_logical_addresses[RS_CFG_MAX_NUMBER_OF_PARTITIONS]
+                                    = TEST_LOGICAL_ADDRESSES;
+
+static uint8_t  m_shadow[TEST_WINDOW_BYTES];        ///< What the window should hold.
+static uint8_t  m_write[TEST_MAX_WRITE_BYTES];
+static uint32_t m_checks;
+static uint32_t m_mismatches;
+static uint32_t m_failures;
+static uint32_t m_random = 0x2468ACE1u;
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_blank_cache_check runs the random operations, then the read saving
+ * cases.
+ *
+ * @retval  bool_t      TRUE if every blank check agreed with the shadow, and
+ *                      every case passed.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_blank_cache_check(void)
+{
+    const uint32_t  sector = TEST_WINDOW_START + TEST_SECTOR_BYTES;
+    uint32_t        operation;
+    uint32_t        page;
+    uint32_t        reads;
+
+    m_checks = 0u;
+    m_mismatches = 0u;
+    m_failures = 0u;
+
+    flash_sim_install();
+    flash_sim_reset();
+    TEST_EXPECT(flash_hal_initialise(&m_logical_addresses[0]));
+    TEST_EXPECT(flash_hal_block_size_bytes_get(STORAGE_DEVICE_MAIN_FLASH) == TEST_SECTOR_BYTES);
+    memset(m_shadow, 0xFF, sizeof(m_shadow));
+
+    // Random operations, checked against the shadow.
+    for (operation = 0u; operation < TEST_OPERATIONS; operation++)
+    {
+        switch (Random() % 10u)
+        {
+            case 0u:
+                RandomErase();
+                break;
+
+            case 1u:
+            case 2u:
+            case 3u:
+            case 4u:
+                RandomWrite();
+                break;
+
+            default:
+                RandomBlankCheck();
+                break;
+        }
+    }
+
+    // The pages of a sector which has just been erased need no reads.
+    TEST_EXPECT(flash_hal_device_erase(sector, TEST_SECTOR_BYTES) == FLASH_HAL_NO_ERROR);
+    flash_sim_stats_clear();
+    for (page = 0u; page < (TEST_SECTOR_BYTES / TEST_PAGE_BYTES); page++)
+    {
+        TEST_EXPECT(flash_hal_device_blank_check(sector + (page * TEST_PAGE_BYTES), TEST_PAGE_BYTES));
+    }
+    TEST_EXPECT(FlashReads() == 0u);
+
+    // After initialising, the first check reads the flash and the repeat is
+    // free.
+    TEST_EXPECT(flash_hal_initialise(&m_logical_addresses[0]));
+    flash_sim_stats_clear();
+    TEST_EXPECT(flash_hal_device_blank_check(sector, TEST_PAGE_BYTES));
+    reads = FlashReads();
+    TEST_EXPECT(reads != 0u);
+    TEST_EXPECT(flash_hal_device_blank_check(sector, TEST_PAGE_BYTES));
+    TEST_EXPECT(FlashReads() == reads);
+
+    // A page which isn't blank is read every time.
+    m_write[0] = 0x00u;
+    m_write[1] = 0x00u;
+    TEST_EXPECT(flash_hal_device_write(sector + TEST_PAGE_BYTES - 2u, 2u, m_write)
+                    == FLASH_HAL_NO_ERROR);
+    flash_sim_stats_clear();
+    TEST_EXPECT(!flash_hal_device_blank_check(sector, TEST_PAGE_BYTES));
+    reads = FlashReads();
+    TEST_EXPECT(!flash_hal_device_blank_check(sector, TEST_PAGE_BYTES));
+    TEST_EXPECT(FlashReads() == (2u * reads));
+
+    printf("%u blank checks, %u mismatches", m_checks, m_mismatches);
+
+    return ( (m_mismatches == 0u) && (m_failures == 0u) );
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * RandomErase erases one sector of the window.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void RandomErase(void)
+{
+    const uint32_t  offset = (Random() % TEST_SECTORS) * TEST_SECTOR_BYTES;
+
+    TEST_EXPECT(flash_hal_device_erase(TEST_WINDOW_START + offset, TEST_SECTOR_BYTES)
+                    == FLASH_HAL_NO_ERROR);
+    memset(&m_shadow[offset], 0xFF, TEST_SECTOR_BYTES);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * RandomWrite programs a random run of words, which may cross pages, sectors
+ * and the die boundary.  Only bits which are still set are cleared, so the
+ * write is always valid.  Now and then a byte is written as it already is,
+ * which programs nothing but must still make the cache forget the page.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void RandomWrite(void)
+{
+    const uint32_t  length = 2u * (1u + (Random() % (TEST_MAX_WRITE_BYTES / 2u)));
+    const uint32_t  offset = 2u * (Random() % ((TEST_WINDOW_BYTES - length) / 2u + 1u));
+    uint32_t        i;
+
+    for (i = 0u; i < length; i++)
+    {
+        //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+        m_write[i] = ((Random() % 8u) == 0u) ? m_shadow[offset + i]
+                                              : (uint8_t)(m_shadow[offset + i] & Random());
+    }
+
+    TEST_EXPECT(flash_hal_device_write(TEST_WINDOW_START + offset, length, m_write)
+                    == FLASH_HAL_NO_ERROR);
+    memcpy(&m_shadow[offset], m_write, length);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * RandomBlankCheck checks a page, a random run of words or a sector, and
+ * compares the result with the shadow.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void RandomBlankCheck(void)
+{
+    uint32_t    offset;
+    uint32_t    length;
+
+    switch (Random() % 4u)
+    {
+        case 0u:
+        case 1u:
+            length = TEST_PAGE_BYTES;
+            offset = (Random() % (TEST_WINDOW_BYTES / TEST_PAGE_BYTES)) * TEST_PAGE_BYTES;
+            break;
+
+        case 2u:
+            length = 2u * (1u + (Random() % ((3u * TEST_PAGE_BYTES) / 2u)));
+            offset = 2u * (Random() % ((TEST_WINDOW_BYTES - length) / 2u + 1u));
+            break;
+
+        default:
+            length = TEST_SECTOR_BYTES;
+            offset = (Random() % TEST_SECTORS) * TEST_SECTOR_BYTES;
+            break;
+    }
+
+    m_checks++;
+
+    if (flash_hal_device_blank_check(TEST_WINDOW_START + offset, length) != ShadowBlank(offset, length))
+    {
+        m_mismatches++;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ShadowBlank says whether a region of the window should be blank.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t ShadowBlank(const uint32_t offset, const uint32_t length)
+{
+    uint32_t    i;
+
+    for (i = 0u; i < length; i++)
+    {
+        if (m_shadow[offset + i] != 0xFFu)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * FlashReads returns the main flash reads made since the stats were cleared,
+ * counting each sector blank check command as one.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t FlashReads(void)
+{
+    flash_sim_stats_t   stats;
+
+    flash_sim_stats_get(&stats);
+
+    return stats.main_flash_bus_reads + stats.main_flash_blank_checks;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * Random returns the next number from a 32 bit xorshift generator.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t Random(void)
+{
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+
+    return m_random;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,497 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_crc.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Equivalence test and benchmark of the CRC-CCITT engines.
+ * @details
+ * crc.c is built once for each CRC_ENGINE (see the Makefile), with the names
+ * of its functions given a suffix - _byte, _word and _slice4 - so that all
+ * three engines can be run side by side.  Each one is checked against the
+ * byte at a time loops which crc.c and dsp_crc.c used before the engines were
+ * added, rebuilt here bit by bit from the polynomial, for every length from
+ * 0 to CRC_TEST_MAX_WORDS, at every start offset into the buffer and with
+ * the usual initial values.  The standard check value ("123456789" gives
+ * 0x29B1) is checked as well, and dsp_crc.c is checked through the engine
+ * which the other host programs are built with.
+ *
+ * Each engine is then timed over a CRC_BENCH_WORDS buffer.  The times are the
+ * host's, so they only show how the engines compare with each other.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "common_data_types.h"
+#include "dsp_crc.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define CRC_TEST_MAX_WORDS      600u        ///< Longest buffer checked.
+#define CRC_TEST_OFFSETS        4u          ///< Start offsets into the buffer.
+#define CRC_BENCH_WORDS         32768u      ///< Size of the timed buffer.
+#define CRC_BENCH_PASSES        200u        ///< Passes timed for each engine.
+#define CRC_POLYNOMIAL          0x1021u     ///< x^16 + x^12 + x^5 + 1.
+
+/// Declares the functions of one build of crc.c.
+#define CRC_ENGINE_DECLARE(suffix)                                              \
+    bool_t   CRC_Check_##suffix(const uint16_t* const pBuffer,                  \
+                                const uint32_t LengthInBytes,                   \
+                                const uint16_t InitialValue,                    \
+                                const uint16_t ExpectedCRC);                    \
+    uint16_t CRC_CCITTCalculate_##suffix(const uint16_t * const pBuffer,        \
+                                         uint32_t LengthInBytes,                \
+                                         const uint16_t InitialValue);          \
+    uint16_t CRC_CCITTOnByteCalculate_##suffix(const uint8_t * const pBuffer,   \
+                                               uint32_t LengthInBytes,          \
+                                               const uint16_t InitialValue);    \
+    uint16_t CRC_CCITTAugmentedCalculate_##suffix(const uint16_t * const pBuffer, \
+                                                  uint32_t LengthInWords,       \
+                                                  const uint16_t RunningValue); \
+    uint16_t CRC_CCITTAugmentedOnBytePairCalculate_##suffix(                    \
+                                                  const uint16_t * const pBuffer, \
+                                                  const uint32_t LengthInBytes, \
+                                                  const uint16_t RunningValue);
+
+/// Entry in m_engines[] for one build of crc.c.
+#define CRC_ENGINE_ENTRY(suffix)                                                \
+    { #suffix, CRC_Check_##suffix, CRC_CCITTCalculate_##suffix,                 \
+      CRC_CCITTOnByteCalculate_##suffix, CRC_CCITTAugmentedCalculate_##suffix,  \
+      CRC_CCITTAugmentedOnBytePairCalculate_##suffix }
+
+
+// ----------------------------------------------------------------------------
+// Types section:
+
+/**
+ * The functions of one build of crc.c.
+ */
+typedef struct
+{
+    const char* p_name;
+    bool_t      (*p_check)(const uint16_t* const, const uint32_t,
+                           const uint16_t, const uint16_t);
+    uint16_t    (*p_words)(const uint16_t * const, uint32_t, const uint16_t);
+    uint16_t    (*p_bytes)(const uint8_t * const, uint32_t, const uint16_t);
+    uint16_t    (*p_augmented)(const uint16_t * const, uint32_t, const uint16_t);
+    uint16_t    (*p_byte_pairs)(const uint16_t * const, const uint32_t,
+                                const uint16_t);
+} crc_engine_t;
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+CRC_ENGINE_DECLARE(byte)
+CRC_ENGINE_DECLARE(word)
+CRC_ENGINE_DECLARE(slice4)
+
+static uint16_t DirectByteStep(uint16_t Crc, const uint16_t Byte);
+
+static uint16_t AugmentedByteStep(uint16_t Crc, const uint16_t Byte);
+
+static uint16_t ReferenceWords(const uint16_t * const pBuffer,
+                               const uint32_t LengthInWords,
+                               const uint16_t InitialValue);
+
+static uint16_t ReferenceBytes(const uint8_t * const pBuffer,
+                               const uint32_t LengthInBytes,
+                               const uint16_t InitialValue);
+
+static uint16_t ReferenceAugmented(const uint16_t * const pBuffer,
+                                   const uint32_t LengthInWords,
+                                   const uint16_t RunningValue);
+
+static uint16_t ReferenceAugmentedBytePairs(const uint16_t * const pBuffer,
+                                            const uint32_t LengthInBytes,
+                                            const uint16_t RunningValue);
+
+static uint32_t EngineCompare(const crc_engine_t * const p_engine);
+
+static uint32_t DspCrcCompare(void);
+
+static uint32_t EngineTime(const crc_engine_t * const p_engine);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static const crc_engine_t m_engines[] =
+{
+    CRC_ENGINE_ENTRY(byte),
+    CRC_ENGINE_ENTRY(word),
+    CRC_ENGINE_ENTRY(slice4)
+};
+
+/// Initial values used by the callers - see crc.c.
+static const uint16_t m_initial_values[] = { 0xFFFFu, 0x1D0Fu, 0x0000u };
+
+/// Test data - one word spare for the byte pair form's odd length over-read.
+static uint16_t m_words[CRC_TEST_MAX_WORDS + CRC_TEST_OFFSETS + 1u];
+static uint8_t  m_bytes[(2u * CRC_TEST_MAX_WORDS) + CRC_TEST_OFFSETS];
+static uint16_t m_bench[CRC_BENCH_WORDS];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_crc_engines_check checks every CRC engine against the reference, and
+ * times them.
+ *
+ * @retval  bool_t      TRUE if every engine gave the reference results.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_crc_engines_check(void)
+{
+    static const uint8_t check_string[] = "123456789";
+    uint32_t    i;
+    uint32_t    mismatches = 0u;
+
+    srand(5u);
+
+    for (i = 0u; i < (sizeof(m_words) / sizeof(m_words[0])); i++)
+    {
+        m_words[i] = (uint16_t)rand();
+    }
+
+    for (i = 0u; i < sizeof(m_bytes); i++)
+    {
+        m_bytes[i] = (uint8_t)rand();
+    }
+
+    for (i = 0u; i < CRC_BENCH_WORDS; i++)
+    {
+        m_bench[i] = (uint16_t)rand();
+    }
+
+    for (i = 0u; i < (sizeof(m_engines) / sizeof(m_engines[0])); i++)
+    {
+        if ( (m_engines[i].p_bytes(check_string, 9u, 0xFFFFu) != 0x29B1u)
+                || (m_engines[i].p_bytes(check_string, 9u, 0x1D0Fu) != 0xE5CCu) )
+        {
+            mismatches++;
+        }
+
+        mismatches += EngineCompare(&m_engines[i]);
+    }
+
+    mismatches += DspCrcCompare();
+
+    printf("mismatches %u,", mismatches);
+
+    for (i = 0u; i < (sizeof(m_engines) / sizeof(m_engines[0])); i++)
+    {
+        printf(" %s %u", m_engines[i].p_name, EngineTime(&m_engines[i]));
+    }
+
+    printf(" MB/s");
+
+    return (mismatches == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * DirectByteStep adds one byte to a direct form CRC, a bit at a time.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t DirectByteStep(uint16_t Crc, const uint16_t Byte)
+{
+    uint16_t    bit;
+
+    Crc ^= (uint16_t)((Byte & 0x00FFu) << 8);
+
+    for (bit = 0u; bit < 8u; bit++)
+    {
+        Crc = ((Crc & 0x8000u) != 0u) ? (uint16_t)((Crc << 1) ^ CRC_POLYNOMIAL)
+                                      : (uint16_t)(Crc << 1);
+    }
+
+    return Crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * AugmentedByteStep shifts one byte into an augmented form CRC, a bit at a
+ * time, most significant bit first.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t AugmentedByteStep(uint16_t Crc, const uint16_t Byte)
+{
+    uint16_t    bit;
+    bool_t      b_carry;
+
+    for (bit = 0u; bit < 8u; bit++)
+    {
+        b_carry = ((Crc & 0x8000u) != 0u);
+        Crc = (uint16_t)(Crc << 1) | ((Byte >> (7u - bit)) & 1u);
+
+        if (b_carry)
+        {
+            Crc ^= CRC_POLYNOMIAL;
+        }
+    }
+
+    return Crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ReferenceWords - the original CRC_CCITTCalculate(), low byte of each word
+ * first.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t ReferenceWords(const uint16_t * const pBuffer,
+                               const uint32_t LengthInWords,
+                               const uint16_t InitialValue)
+{
+    uint16_t    Crc = InitialValue;
+    uint32_t    index;
+
+    for (index = 0u; index < LengthInWords; index++)
+    {
+        Crc = DirectByteStep(Crc, pBuffer[index]);
+        Crc = DirectByteStep(Crc, pBuffer[index] >> 8);
+    }
+
+    return Crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ReferenceBytes - the original CRC_CCITTOnByteCalculate().
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t ReferenceBytes(const uint8_t * const pBuffer,
+                               const uint32_t LengthInBytes,
+                               const uint16_t InitialValue)
+{
+    uint16_t    Crc = InitialValue;
+    uint32_t    index;
+
+    for (index = 0u; index < LengthInBytes; index++)
+    {
+        Crc = DirectByteStep(Crc, pBuffer[index]);
+    }
+
+    return Crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ReferenceAugmented - the original WORD_CRC_CALC loop of
+ * crc_calcRunningCRC(), low byte of each word first.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t ReferenceAugmented(const uint16_t * const pBuffer,
+                                   const uint32_t LengthInWords,
+                                   const uint16_t RunningValue)
+{
+    uint16_t    Crc = RunningValue;
+    uint32_t    index;
+
+    for (index = 0u; index < LengthInWords; index++)
+    {
+        Crc = AugmentedByteStep(Crc, pBuffer[index] & 0x00FFu);
+        Crc = AugmentedByteStep(Crc, (pBuffer[index] >> 8) & 0x00FFu);
+    }
+
+    return Crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ReferenceAugmentedBytePairs - the original BYTE_CRC_CALC loop of
+ * crc_calcRunningCRC(), second byte of each pair first.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t ReferenceAugmentedBytePairs(const uint16_t * const pBuffer,
+                                            const uint32_t LengthInBytes,
+                                            const uint16_t RunningValue)
+{
+    uint16_t    Crc = RunningValue;
+    uint32_t    index;
+
+    for (index = 0u; index < LengthInBytes; index += 2u)
+    {
+        Crc = AugmentedByteStep(Crc, pBuffer[index + 1u] & 0x00FFu);
+        Crc = AugmentedByteStep(Crc, pBuffer[index] & 0x00FFu);
+    }
+
+    return Crc;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * EngineCompare runs one engine against the reference over every length,
+ * offset and initial value.
+ *
+ * @param   p_engine        Engine to check.
+ * @retval  uint32_t        Number of results which differed.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t EngineCompare(const crc_engine_t * const p_engine)
+{
+    uint32_t        length;
+    uint32_t        offset;
+    uint32_t        seed;
+    uint32_t        mismatches = 0u;
+    uint16_t        initial;
+    uint16_t        expected;
+    const uint16_t* p_words;
+    const uint8_t*  p_bytes;
+
+    for (seed = 0u; seed < (sizeof(m_initial_values) / sizeof(m_initial_values[0])); seed++)
+    {
+        initial = m_initial_values[seed];
+
+        for (offset = 0u; offset < CRC_TEST_OFFSETS; offset++)
+        {
+            p_words = &m_words[offset];
+            p_bytes = &m_bytes[offset];
+
+            for (length = 0u; length <= CRC_TEST_MAX_WORDS; length++)
+            {
+                expected = ReferenceWords(p_words, length, initial);
+
+                if ( (p_engine->p_words(p_words, length, initial) != expected)
+                        || (!p_engine->p_check(p_words, length, initial, expected))
+                        || (p_engine->p_check(p_words, length, initial, expected ^ 1u)) )
+                {
+                    mismatches++;
+                }
+
+                if (p_engine->p_augmented(p_words, length, initial)
+                        != ReferenceAugmented(p_words, length, initial))
+                {
+                    mismatches++;
+                }
+
+                if (p_engine->p_byte_pairs(p_words, length, initial)
+                        != ReferenceAugmentedBytePairs(p_words, length, initial))
+                {
+                    mismatches++;
+                }
+
+                if ( (p_engine->p_bytes(p_bytes, 2u * length, initial)
+                            != ReferenceBytes(p_bytes, 2u * length, initial))
+                        || (p_engine->p_bytes(p_bytes, (2u * length) + 1u, initial)
+                            != ReferenceBytes(p_bytes, (2u * length) + 1u, initial)) )
+                {
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * DspCrcCompare checks dsp_crc.c, running and finished off, in both modes.
+ *
+ * @retval  uint32_t        Number of results which differed.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t DspCrcCompare(void)
+{
+    static const uint16_t zero = 0u;
+    uint32_t    length;
+    uint32_t    mismatches = 0u;
+    uint16_t    running;
+
+    for (length = 0u; length <= CRC_TEST_MAX_WORDS; length++)
+    {
+        running = crc_calcRunningCRC(0xFFFFu, m_words, length, WORD_CRC_CALC);
+
+        if ( (running != ReferenceAugmented(m_words, length, 0xFFFFu))
+                || (crc_calcFinalCRC(running, WORD_CRC_CALC)
+                    != ReferenceAugmented(&zero, 1u, running)) )
+        {
+            mismatches++;
+        }
+
+        running = crc_calcRunningCRC(0u, m_words, length, BYTE_CRC_CALC);
+
+        if (running != ReferenceAugmentedBytePairs(m_words, length, 0u))
+        {
+            mismatches++;
+        }
+    }
+
+    return mismatches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * EngineTime runs one engine over the benchmark buffer.
+ *
+ * @param   p_engine        Engine to time.
+ * @retval  uint32_t        Host throughput, in Mbytes/s.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t EngineTime(const crc_engine_t * const p_engine)
+{
+    volatile uint16_t   sink = 0u;
+    uint32_t            pass;
+    clock_t             start;
+    double              seconds;
+
+    start = clock();
+
+    for (pass = 0u; pass < CRC_BENCH_PASSES; pass++)
+    {
+        sink ^= p_engine->p_words(m_bench, CRC_BENCH_WORDS, 0xFFFFu);
+    }
+
+    seconds = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+
+    if (seconds <= 0.0)
+    {
+        seconds = 1.0 / (double)CLOCKS_PER_SEC;
+    }
+
+    return (uint32_t)(((double)CRC_BENCH_PASSES * 2.0 * (double)CRC_BENCH_WORDS)
+                      / (seconds * 1.0e6));
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,392 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_dump_codec.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the compressed dump codec.
+ * @details
+ * The cases are:
+ *  - blocks of mixed data (random bytes, erased runs, runs of one byte and
+ *    repeated records) round-trip through dump_codec_encode() and
+ *    dump_codec_decode(), both coded whole and coded a piece at a time into
+ *    small output buffers, as the dump does into its frames;
+ *  - random data grows by no more than DUMP_CODEC_MAX_ENCODED_BYTES();
+ *  - an erased run longer than one token can code is split correctly;
+ *  - coded blocks which point outside themselves are refused;
+ *  - a partition image of 32 byte records, coded 1 Kbyte at a time into 512
+ *    byte frames as opcode 46 command 7 does, shrinks by at least
+ *    TEST_MIN_RATIO, and its erased part by much more.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "common_data_types.h"
+#include "dump_codec.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_BLOCKS             3000u       ///< Mixed blocks round-tripped.
+#define TEST_MAX_BLOCK          1024u       ///< Largest mixed block.
+#define TEST_LONG_RUN           20000u      ///< Erased run longer than one token.
+#define TEST_RANDOM_BYTES       0x10000u    ///< Random data coded for the growth.
+#define TEST_IMAGE_BYTES        0x40000u    ///< Partition image size.
+#define TEST_IMAGE_USED         ((TEST_IMAGE_BYTES * 45u) / 100u)
+#define TEST_RECORD_BYTES       32u         ///< Size of a record in the image.
+#define TEST_READ_BYTES         1024u       ///< Read size of the compressed dump.
+#define TEST_FRAME_PAYLOAD      512u        ///< Frame payload of the compressed dump.
+#define TEST_MIN_RATIO          3u          ///< Least acceptable cut for the records.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static uint16_t BlockBuild(uint8_t * const p_block);
+
+static bool_t   RoundTrip(const uint8_t * const p_block,
+                          const uint16_t length,
+                          const uint16_t capacity,
+                          uint32_t * const p_coded);
+
+static void     ImageBuild(void);
+
+static uint32_t Random(void);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint8_t  m_block[TEST_LONG_RUN];
+static uint8_t  m_coded[DUMP_CODEC_MAX_ENCODED_BYTES(TEST_LONG_RUN)];
+static uint8_t  m_decoded[TEST_LONG_RUN];
+static uint8_t  m_image[TEST_IMAGE_BYTES];
+static uint32_t m_failures;
+static uint32_t m_random = 0x13579BDFu;
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_dump_codec_check runs every codec case.
+ *
+ * @retval  bool_t      TRUE if every case passed.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_dump_codec_check(void)
+{
+    static const uint8_t    far_match[] = { 0x00u, 0x41u, 0x80u, 0x01u };
+    static const uint8_t    cut_match[] = { 0x00u, 0x41u, 0x80u };
+    static const uint8_t    early_repeat[] = { 0xE0u };
+    static const uint8_t    cut_literals[] = { 0x03u, 0x41u, 0x42u };
+    uint32_t    block;
+    uint32_t    offset;
+    uint32_t    coded;
+    uint32_t    used_coded = 0u;
+    uint32_t    erased_coded = 0u;
+    uint32_t    random_coded = 0u;
+    uint16_t    length;
+    uint16_t    capacity;
+    uint16_t    read_length;
+    uint16_t    consumed;
+    uint16_t    decoded_length;
+
+    m_failures = 0u;
+
+    // Mixed blocks, coded whole and into small buffers.
+    for (block = 0u; block < TEST_BLOCKS; block++)
+    {
+        length = BlockBuild(m_block);
+        capacity = (uint16_t)(4u + (Random() % 96u));
+
+        TEST_EXPECT(RoundTrip(m_block, length, DUMP_CODEC_MAX_ENCODED_BYTES(length), &coded));
+        TEST_EXPECT(RoundTrip(m_block, length, capacity, &coded));
+    }
+
+    // Random data - the worst case.
+    for (offset = 0u; offset < TEST_RANDOM_BYTES; offset += TEST_MAX_BLOCK)
+    {
+        for (length = 0u; length < TEST_MAX_BLOCK; length++)
+        {
+            //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+            m_block[length] = (uint8_t)Random();
+        }
+        TEST_EXPECT(RoundTrip(m_block, TEST_MAX_BLOCK,
+                              DUMP_CODEC_MAX_ENCODED_BYTES(TEST_MAX_BLOCK), &coded));
+        random_coded += coded;
+    }
+    TEST_EXPECT(random_coded <= DUMP_CODEC_MAX_ENCODED_BYTES(TEST_RANDOM_BYTES));
+
+    // An erased run longer than one token, with a byte after it.
+    memset(m_block, 0xFF, TEST_LONG_RUN);
+    m_block[TEST_LONG_RUN - 1u] = 0x5Au;
+    TEST_EXPECT(RoundTrip(m_block, TEST_LONG_RUN, sizeof(m_coded), &coded));
+    TEST_EXPECT(coded <= 8u);
+
+    // Coded blocks which reach outside themselves.
+    TEST_EXPECT(!dump_codec_decode(far_match, sizeof(far_match),
+                                   m_decoded, sizeof(m_decoded), &decoded_length));
+    TEST_EXPECT(!dump_codec_decode(cut_match, sizeof(cut_match),
+                                   m_decoded, sizeof(m_decoded), &decoded_length));
+    TEST_EXPECT(!dump_codec_decode(early_repeat, sizeof(early_repeat),
+                                   m_decoded, sizeof(m_decoded), &decoded_length));
+    TEST_EXPECT(!dump_codec_decode(cut_literals, sizeof(cut_literals),
+                                   m_decoded, sizeof(m_decoded), &decoded_length));
+    TEST_EXPECT(!dump_codec_decode(cut_literals, 1u, m_decoded, 2u, &decoded_length));
+
+    // A partition image, dumped the way opcode 46 command 7 does it.
+    ImageBuild();
+    offset = 0u;
+    while (offset < TEST_IMAGE_BYTES)
+    {
+        read_length = (uint16_t)(((TEST_IMAGE_BYTES - offset) < TEST_READ_BYTES)
+                                    ? (TEST_IMAGE_BYTES - offset) : TEST_READ_BYTES);
+        coded = dump_codec_encode(&m_image[offset], read_length,
+                                  m_coded, TEST_FRAME_PAYLOAD, &consumed);
+
+        TEST_EXPECT( (consumed != 0u) && (coded <= TEST_FRAME_PAYLOAD) );
+        TEST_EXPECT( (dump_codec_decode(m_coded, (uint16_t)coded, m_decoded,
+                                        sizeof(m_decoded), &decoded_length))
+                        && (decoded_length == consumed)
+                        && (memcmp(m_decoded, &m_image[offset], consumed) == 0) );
+        if (consumed == 0u)
+        {
+            break;
+        }
+
+        if (offset < TEST_IMAGE_USED)
+        {
+            used_coded += coded;
+        }
+        else
+        {
+            erased_coded += coded;
+        }
+        offset += consumed;
+    }
+    TEST_EXPECT((used_coded * TEST_MIN_RATIO) <= TEST_IMAGE_USED);
+    TEST_EXPECT((erased_coded * 100u) <= (TEST_IMAGE_BYTES - TEST_IMAGE_USED));
+
+    printf("records %.1fx, random +%.1f%%, failures %u",
+           (double)TEST_IMAGE_USED / (double)used_coded,
+           (100.0 * (double)(random_coded - TEST_RANDOM_BYTES)) / (double)TEST_RANDOM_BYTES,
+           m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * BlockBuild fills a block of up to TEST_MAX_BLOCK bytes with pieces of
+ * random bytes, erased runs, runs of one byte and copies of earlier pieces.
+ *
+ * @param   p_block     Block to fill.
+ * @retval  uint16_t    Number of bytes in the block.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t BlockBuild(uint8_t * const p_block)
+{
+    uint16_t    length = (uint16_t)(Random() % (TEST_MAX_BLOCK + 1u));
+    uint16_t    position = 0u;
+    uint16_t    piece;
+    uint16_t    source;
+    uint16_t    i;
+    uint8_t     value;
+
+    while (position < length)
+    {
+        piece = (uint16_t)(1u + (Random() % 80u));
+        if (piece > (length - position))
+        {
+            piece = length - position;
+        }
+
+        //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+        value = (uint8_t)Random();
+
+        switch (Random() % 4u)
+        {
+            case 0u:
+                for (i = 0u; i < piece; i++)
+                {
+                    //lint -e{921} Cast to uint8_t as buffer holds uint8_t's
+                    p_block[position + i] = (uint8_t)Random();
+                }
+                break;
+
+            case 1u:
+                memset(&p_block[position], 0xFF, piece);
+                break;
+
+            case 2u:
+                memset(&p_block[position], value, piece);
+                break;
+
+            default:
+                // A copy of an earlier piece - it may overlap this one.
+                if (position == 0u)
+                {
+                    memset(&p_block[position], value, piece);
+                }
+                else
+                {
+                    source = (uint16_t)(Random() % position);
+                    for (i = 0u; i < piece; i++)
+                    {
+                        p_block[position + i] = p_block[source + i];
+                    }
+                }
+                break;
+        }
+
+        position += piece;
+    }
+
+    return length;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * RoundTrip codes a block a piece at a time, each piece into an output buffer
+ * of the given capacity, and checks that every piece decodes on its own back
+ * to the bytes it was coded from.
+ *
+ * @param   p_block     Block to code.
+ * @param   length      Number of bytes in the block.
+ * @param   capacity    Size of the output buffer for each piece.
+ * @param   p_coded     Total number of coded bytes.
+ * @retval  bool_t      TRUE if the whole block round-tripped.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t RoundTrip(const uint8_t * const p_block,
+                        const uint16_t length,
+                        const uint16_t capacity,
+                        uint32_t * const p_coded)
+{
+    uint16_t    position = 0u;
+    uint16_t    coded;
+    uint16_t    consumed;
+    uint16_t    decoded_length;
+
+    *p_coded = 0u;
+
+    while (position < length)
+    {
+        coded = dump_codec_encode(&p_block[position], length - position,
+                                  m_coded, capacity, &consumed);
+
+        if ( (consumed == 0u) || (coded > capacity)
+                || (!dump_codec_decode(m_coded, coded, m_decoded,
+                                       sizeof(m_decoded), &decoded_length))
+                || (decoded_length != consumed)
+                || (memcmp(m_decoded, &p_block[position], consumed) != 0) )
+        {
+            return FALSE;
+        }
+
+        *p_coded += coded;
+        position += consumed;
+    }
+
+    return TRUE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * ImageBuild fills the partition image with 32 byte records - a sequence
+ * number, a time stamp, a status word, slowly changing sensor readings and
+ * spare bytes - up to TEST_IMAGE_USED, and leaves the rest erased.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void ImageBuild(void)
+{
+    uint32_t    record;
+    uint32_t    time_stamp = 0x00100000u;
+    uint16_t    sensor[6] = { 0x0800u, 0x0400u, 0x1200u, 0x0100u, 0x7F00u, 0x0020u };
+    uint8_t*    p_record;
+    uint16_t    i;
+
+    memset(m_image, 0xFF, sizeof(m_image));
+
+    for (record = 0u; record < (TEST_IMAGE_USED / TEST_RECORD_BYTES); record++)
+    {
+        p_record = &m_image[record * TEST_RECORD_BYTES];
+        time_stamp += 100u + (Random() % 3u);
+
+        p_record[0] = (uint8_t)(record & 0xFFu);
+        p_record[1] = (uint8_t)((record >> 8) & 0xFFu);
+        p_record[2] = (uint8_t)(time_stamp & 0xFFu);
+        p_record[3] = (uint8_t)((time_stamp >> 8) & 0xFFu);
+        p_record[4] = (uint8_t)((time_stamp >> 16) & 0xFFu);
+        p_record[5] = (uint8_t)((time_stamp >> 24) & 0xFFu);
+        p_record[6] = 0xA5u;
+        p_record[7] = ((Random() % 64u) == 0u) ? 0x01u : 0x00u;
+
+        for (i = 0u; i < 6u; i++)
+        {
+            if ((Random() % 4u) == 0u)
+            {
+                sensor[i] += (uint16_t)((Random() % 5u) - 2u);
+            }
+            p_record[8u + (2u * i)] = (uint8_t)(sensor[i] & 0xFFu);
+            p_record[9u + (2u * i)] = (uint8_t)(sensor[i] >> 8);
+        }
+
+        memset(&p_record[20], 0x00, TEST_RECORD_BYTES - 20u);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * Random returns the next number from a 32 bit xorshift generator.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t Random(void)
+{
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+
+    return m_random;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
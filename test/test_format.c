@@ -0,0 +1,125 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_format.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the stepped partition format, on the partitions
+ *              which format_sim's default run doesn't use.
+ * @details
+ * format_sim is run three more ways:
+ *  - each serial flash partition is formatted while records go into a main
+ *    flash partition, and no step may take longer than TEST_SERIAL_STEP_US,
+ *    as serial flash blocks are erased (and checked) 1 Kbyte at a time;
+ *  - a main flash partition is formatted while records go into the serial
+ *    flash, so that the traffic uses the other driver.
+ *
+ * Each format must complete with its progress going only forwards, refuse
+ * every write into the partition while it runs, and leave the records
+ * written elsewhere as they were.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "format_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_RUNS               3u          ///< Formats made.
+#define TEST_SERIAL_STEP_US     50000u      ///< Longest serial flash format step.
+#define TEST_NO_STEP_LIMIT      0xFFFFFFFFu
+
+
+// ----------------------------------------------------------------------------
+// Types section:
+
+/**
+ * One format, and the longest step it may take.
+ */
+typedef struct
+{
+    uint8_t     format_partition_index;
+    uint8_t     traffic_partition_index;
+    uint32_t    longest_step_us;
+} test_format_run_t;
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static const test_format_run_t  m_runs[TEST_RUNS] =
+{
+    { 0u,   2u,     TEST_SERIAL_STEP_US },      // Calibration, serial flash.
+    { 1u,   2u,     TEST_SERIAL_STEP_US },      // Configuration, serial flash.
+    { 2u,   1u,     TEST_NO_STEP_LIMIT },       // MWD, main flash.
+};
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_format_check makes every format in m_runs.
+ *
+ * @retval  bool_t      TRUE if every format passed.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_format_check(void)
+{
+    format_sim_config_t config;
+    format_sim_result_t result;
+    uint64_t            longest_serial_us = 0u;
+    uint32_t            run;
+    uint32_t            failed_runs = 0u;
+
+    for (run = 0u; run < TEST_RUNS; run++)
+    {
+        format_sim_config_default(&config);
+        config.format_partition_index = m_runs[run].format_partition_index;
+        config.traffic_partition_index = m_runs[run].traffic_partition_index;
+
+        if ( (!format_sim_run(&config, &result))
+                || (result.format_status != RS_ERR_NO_ERROR)
+                || (!result.b_progress_ok)
+                || (result.traffic_writes == 0u)
+                || (result.traffic_write_failures != 0u)
+                || (result.traffic_read_mismatches != 0u)
+                || (result.writes_not_refused != 0u)
+                || (!result.b_partition_usable)
+                || (result.longest_step_us > m_runs[run].longest_step_us) )
+        {
+            printf("partition %u failed  ", m_runs[run].format_partition_index);
+            failed_runs++;
+        }
+
+        if ( (m_runs[run].longest_step_us == TEST_SERIAL_STEP_US)
+                && (result.longest_step_us > longest_serial_us) )
+        {
+            longest_serial_us = result.longest_step_us;
+        }
+    }
+
+    printf("serial flash step %llu us", (unsigned long long)longest_serial_us);
+
+    return (failed_runs == 0u);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
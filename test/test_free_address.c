@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_free_address.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the next free address probe search, over more
+ *              pages than free_address_sim's default run.
+ * @details
+ * free_address_sim is run with four seeds, each with three mixes of TDR size
+ * and 0xFF runs in the TDRs - short records with no 0xFF, the default mix,
+ * and records of up to RS_CFG_MAX_TDR_SIZE_BYTES which are half 0xFF.  Long
+ * runs of 0xFF in the data are what could fool the probes into stopping
+ * early.
+ *
+ * Every page must give the known end of the data with both searches.  From
+ * 10% to 75% full the probe search must also make fewer bus reads than the
+ * linear one, except with the half 0xFF mix - there most probes land in a
+ * run of 0xFF which can't be confirmed, and the page falls back to the
+ * linear search.  An empty page must never fall back - every probe is blank
+ * and the device blank check confirms it.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "free_address_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_SEEDS              4u          ///< Random number seeds used.
+#define TEST_MIXES              3u          ///< TDR size and 0xFF run mixes used.
+#define TEST_PAGES_PER_LEVEL    50u         ///< Pages at each fill level, per run.
+#define TEST_FIRST_FAST_LEVEL   1u          ///< 10% full.
+#define TEST_LAST_FAST_LEVEL    4u          ///< 75% full.
+#define TEST_EMPTY_LEVEL        0u          ///< 0% full.
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static const uint32_t   m_seeds[TEST_SEEDS] = { 1u, 0x1234u, 0xBEEF01u, 0x7FFFFFFFu };
+
+/// Largest TDR, chance of a 0xFF run, and whether the probes must be cheaper,
+/// for each mix.
+static const uint16_t   m_mixes[TEST_MIXES][3] =
+{
+    { 16u,                          0u,     TRUE },
+    { 64u,                          2u,     TRUE },
+    { RS_CFG_MAX_TDR_SIZE_BYTES,    50u,    FALSE },
+};
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_free_address_check runs every seed with every mix.
+ *
+ * @retval  bool_t      TRUE if every page matched, and the probes were
+ *                      cheaper at the middle fill levels where they must be.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_free_address_check(void)
+{
+    free_address_sim_config_t   config;
+    free_address_sim_result_t   result;
+    uint32_t                    seed;
+    uint32_t                    mix;
+    uint32_t                    level;
+    uint32_t                    pages = 0u;
+    uint32_t                    mismatches = 0u;
+    uint32_t                    fallbacks = 0u;
+    uint32_t                    empty_fallbacks = 0u;
+    uint32_t                    slower_levels = 0u;
+    uint32_t                    invalid_runs = 0u;
+
+    for (seed = 0u; seed < TEST_SEEDS; seed++)
+    {
+        for (mix = 0u; mix < TEST_MIXES; mix++)
+        {
+            free_address_sim_config_default(&config);
+            config.pages_per_level = TEST_PAGES_PER_LEVEL;
+            config.max_tdr_bytes = m_mixes[mix][0];
+            config.ff_run_percent = m_mixes[mix][1];
+            config.seed = m_seeds[seed];
+
+            if (!free_address_sim_run(&config, &result))
+            {
+                invalid_runs++;
+                continue;
+            }
+
+            mismatches += result.mismatches;
+
+            for (level = 0u; level < FREE_ADDRESS_SIM_FILL_LEVELS; level++)
+            {
+                pages += result.level[level].pages;
+                fallbacks += result.level[level].fallbacks;
+
+                if (level == TEST_EMPTY_LEVEL)
+                {
+                    empty_fallbacks += result.level[level].fallbacks;
+                }
+
+                if ( (m_mixes[mix][2] == TRUE)
+                        && (level >= TEST_FIRST_FAST_LEVEL) && (level <= TEST_LAST_FAST_LEVEL)
+                        && (result.level[level].probe_bus_reads
+                                >= result.level[level].linear_bus_reads) )
+                {
+                    slower_levels++;
+                }
+            }
+        }
+    }
+
+    printf("%u pages, %u mismatches, %u fallbacks, %u when empty",
+           pages, mismatches, fallbacks, empty_fallbacks);
+
+    return ( (invalid_runs == 0u) && (mismatches == 0u) && (slower_levels == 0u)
+                && (empty_fallbacks == 0u) );
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,289 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_image_verify.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the verified image descriptor log.
+ * @details
+ * The descriptor log at IMAGE_DESCRIPTOR_START_ADDRESS is kept in a RAM copy
+ * of the flash here.  genericIO_16bitRead() is pointed at it while the test
+ * runs, and flash programs are handed to LogProgram() (see
+ * host_flash_program_hook_set()), which programs it the way flash does - bits
+ * can only be cleared - and can be made to stop part way, as a reset would.
+ *
+ * The cases are:
+ *  - a blank log trusts nothing;
+ *  - a valid descriptor is trusted, but only for its own partition, length
+ *    and CRC;
+ *  - a stale descriptor (replaced, retired, or followed by a newer generation
+ *    which was never marked verified) is not trusted;
+ *  - a corrupt descriptor (an append cut off in the body, or a bit flip)
+ *    stops every older descriptor being trusted, until a newer one is
+ *    written;
+ *  - a full log refuses the write, keeps the newest descriptor, and is
+ *    reported as full - but not one slot before.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "common_data_types.h"
+#include "tool_specific_config.h"
+#include "tool_specific_programming.h"
+#include "genericIO.h"
+#include "image_verify.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_BOOTLOADER         1u          ///< Partition numbers used.
+#define TEST_APPLICATION        2u
+#define TEST_LENGTH             0x8000u     ///< Image length, in words.
+#define TEST_SLOT_WORDS         8u          ///< Words in a descriptor slot.
+#define TEST_NUMBER_OF_SLOTS    (IMAGE_DESCRIPTOR_LENGTH / TEST_SLOT_WORDS)
+#define TEST_NO_LIMIT           0xFFFFFFFFu ///< Program without stopping.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static uint16_t LogRead(const uint32_t address);
+
+static bool_t   LogProgram(const uint32_t flash_address,
+                           const void* const p_buffer,
+                           const uint32_t length);
+
+static void     LogErase(void);
+
+static bool_t   Trusted(const uint16_t Partition, const uint16_t ImageCRC);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint16_t m_log[IMAGE_DESCRIPTOR_LENGTH];     ///< RAM copy of the log.
+static uint32_t m_program_limit;                    ///< Words left before a "reset".
+static uint32_t m_failures;
+
+static uint16_t (*m_saved_16bit_read)(const uint32_t address);
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_image_verify_check runs every descriptor log case.
+ *
+ * @retval  bool_t      TRUE if every case passed.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_image_verify_check(void)
+{
+    ImageDescriptor_t   descriptor;
+    uint32_t            slot;
+    uint32_t            writes;
+
+    m_failures = 0u;
+    m_program_limit = TEST_NO_LIMIT;
+    m_saved_16bit_read = genericIO_16bitRead;
+    genericIO_16bitRead = LogRead;
+    host_flash_program_hook_set(LogProgram);
+
+    // Blank log.
+    LogErase();
+    TEST_EXPECT(!ImageVerify_DescriptorGet(TEST_BOOTLOADER, &descriptor));
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x1234u));
+    TEST_EXPECT(!ImageVerify_LogFullCheck());
+
+    // Valid descriptor - only for its own partition, length and CRC.
+    TEST_EXPECT(ImageVerify_DescriptorWrite(TEST_BOOTLOADER, TEST_LENGTH, 0x1234u));
+    TEST_EXPECT(Trusted(TEST_BOOTLOADER, 0x1234u));
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x1235u));
+    TEST_EXPECT(!ImageVerify_DescriptorTrustedCheck(TEST_BOOTLOADER, TEST_LENGTH - 1u, 0x1234u));
+    TEST_EXPECT(!Trusted(TEST_APPLICATION, 0x1234u));
+    TEST_EXPECT(ImageVerify_DescriptorWrite(TEST_APPLICATION, TEST_LENGTH, 0xBEEFu));
+    TEST_EXPECT(Trusted(TEST_APPLICATION, 0xBEEFu));
+    TEST_EXPECT(Trusted(TEST_BOOTLOADER, 0x1234u));
+
+    // Stale - replaced by a newer image, then retired.
+    TEST_EXPECT(ImageVerify_DescriptorWrite(TEST_BOOTLOADER, TEST_LENGTH, 0x5678u));
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x1234u));
+    TEST_EXPECT(Trusted(TEST_BOOTLOADER, 0x5678u));
+    TEST_EXPECT( (ImageVerify_DescriptorGet(TEST_BOOTLOADER, &descriptor))
+                    && (descriptor.Generation == 2u) );
+    TEST_EXPECT(ImageVerify_DescriptorRetire(TEST_BOOTLOADER));
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x5678u));
+    TEST_EXPECT(Trusted(TEST_APPLICATION, 0xBEEFu));
+
+    // Stale - the newer generation's body was written, but not its marker.
+    TEST_EXPECT(ImageVerify_DescriptorWrite(TEST_BOOTLOADER, TEST_LENGTH, 0x1111u));
+    m_program_limit = 1u + (TEST_SLOT_WORDS - 1u);
+    TEST_EXPECT(!ImageVerify_DescriptorWrite(TEST_BOOTLOADER, TEST_LENGTH, 0x2222u));
+    m_program_limit = TEST_NO_LIMIT;
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x1111u));
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x2222u));
+    TEST_EXPECT(Trusted(TEST_APPLICATION, 0xBEEFu));
+
+    // Corrupt - an append cut off in the body hides everything before it.
+    TEST_EXPECT(ImageVerify_DescriptorWrite(TEST_BOOTLOADER, TEST_LENGTH, 0x3333u));
+    m_program_limit = 3u;
+    TEST_EXPECT(!ImageVerify_DescriptorWrite(TEST_APPLICATION, TEST_LENGTH, 0xCAFEu));
+    m_program_limit = TEST_NO_LIMIT;
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x3333u));
+    TEST_EXPECT(!Trusted(TEST_APPLICATION, 0xBEEFu));
+    TEST_EXPECT(!Trusted(TEST_APPLICATION, 0xCAFEu));
+    TEST_EXPECT(ImageVerify_DescriptorWrite(TEST_APPLICATION, TEST_LENGTH, 0xCAFEu));
+    TEST_EXPECT(Trusted(TEST_APPLICATION, 0xCAFEu));
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x3333u));
+
+    // Corrupt - a bit flip in the newest descriptor's image CRC.
+    LogErase();
+    TEST_EXPECT(ImageVerify_DescriptorWrite(TEST_BOOTLOADER, TEST_LENGTH, 0x1234u));
+    TEST_EXPECT(ImageVerify_DescriptorWrite(TEST_APPLICATION, TEST_LENGTH, 0xBEEFu));
+    m_log[TEST_SLOT_WORDS + 6u] ^= 0x0100u;
+    TEST_EXPECT(!Trusted(TEST_APPLICATION, 0xBEEFu));
+    TEST_EXPECT(!Trusted(TEST_APPLICATION, 0xBEEFu ^ 0x0100u));
+    TEST_EXPECT(!Trusted(TEST_BOOTLOADER, 0x1234u));
+
+    // Full log - the last write is refused and the newest descriptor kept.
+    LogErase();
+    writes = 0u;
+    for (slot = 0u; slot < (TEST_NUMBER_OF_SLOTS + 1u); slot++)
+    {
+        if (slot == (TEST_NUMBER_OF_SLOTS - 1u))
+        {
+            TEST_EXPECT(!ImageVerify_LogFullCheck());
+        }
+
+        if (ImageVerify_DescriptorWrite(TEST_BOOTLOADER, TEST_LENGTH, (uint16_t)slot))
+        {
+            writes++;
+        }
+    }
+    TEST_EXPECT(ImageVerify_LogFullCheck());
+    TEST_EXPECT(writes == TEST_NUMBER_OF_SLOTS);
+    TEST_EXPECT(Trusted(TEST_BOOTLOADER, (uint16_t)(TEST_NUMBER_OF_SLOTS - 1u)));
+    TEST_EXPECT(!ImageVerify_DescriptorWrite(TEST_APPLICATION, TEST_LENGTH, 0xBEEFu));
+
+    genericIO_16bitRead = m_saved_16bit_read;
+    host_flash_program_hook_set(NULL);
+
+    printf("failures %u", m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * LogRead reads the RAM copy of the log, and passes any other address on.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t LogRead(const uint32_t address)
+{
+    if ( (address >= IMAGE_DESCRIPTOR_START_ADDRESS)
+            && (address < (IMAGE_DESCRIPTOR_START_ADDRESS + IMAGE_DESCRIPTOR_LENGTH)) )
+    {
+        return m_log[address - IMAGE_DESCRIPTOR_START_ADDRESS];
+    }
+
+    return m_saved_16bit_read(address);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * LogProgram programs the RAM copy of the log.  Bits can only be cleared.
+ * Once m_program_limit words have been programmed it stops, and fails, as if
+ * the processor had been reset.
+ *
+ * @param   flash_address   Address in the log to program.
+ * @param   p_buffer        Data to program.
+ * @param   length          Number of words.
+ * @retval  bool_t          TRUE if every word was programmed.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t LogProgram(const uint32_t flash_address,
+                         const void* const p_buffer,
+                         const uint32_t length)
+{
+    const uint16_t* p_data = (const uint16_t*)p_buffer;
+    uint32_t        offset = flash_address - IMAGE_DESCRIPTOR_START_ADDRESS;
+    uint32_t        index;
+
+    for (index = 0u; index < length; index++)
+    {
+        if ( (m_program_limit == 0u) || ((offset + index) >= IMAGE_DESCRIPTOR_LENGTH) )
+        {
+            return FALSE;
+        }
+
+        if (m_program_limit != TEST_NO_LIMIT)
+        {
+            m_program_limit--;
+        }
+
+        m_log[offset + index] &= p_data[index];
+    }
+
+    return TRUE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * LogErase erases the RAM copy of the log, as erasing the parameter sector
+ * does.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void LogErase(void)
+{
+    (void)memset(m_log, 0xFF, sizeof(m_log));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * Trusted checks a full length image with the given CRC.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t Trusted(const uint16_t Partition, const uint16_t ImageCRC)
+{
+    return ImageVerify_DescriptorTrustedCheck(Partition, TEST_LENGTH, ImageCRC);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
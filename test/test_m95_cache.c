@@ -0,0 +1,370 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_m95_cache.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the M95 write-behind cache, with ranges which
+ *              m95_cache_sim's default run doesn't use, the verify read and
+ *              page writes which never finish.
+ * @details
+ * m95_cache_sim is run with a few bytes at an odd address, with a range which
+ * starts and ends part way through a page and is patched, and with the most
+ * it can write.  Each must read back the same from the cache as from the
+ * device, and take no more write cycles than writing a page at a time, apart
+ * from the pages of the patch which had already been written back.
+ *
+ * Then, straight through the driver:
+ *  - M95_VerifyRead must write the cached pages back and read the device,
+ *    where M95_BlockRead is served from the cache without reading it;
+ *  - with a page write time far longer than M95_PAGE_WRITE_TIMEOUT_MS, the
+ *    flush, the verify read and a read which has to wait for the device must
+ *    all return M95_POLL_TIMEOUT_EXCEEDED in bounded time, and a read which
+ *    is forced to time out must not read anything.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "flash_sim.h"
+#include "m95.h"
+#include "m95_prv.h"
+#include "m95_cache_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_RUNS               3u          ///< m95_cache_sim ranges written.
+#define TEST_ADDRESS            0x3041u     ///< Odd address, part way through a page.
+#define TEST_BYTES              300u        ///< Spread over three pages.
+#define TEST_OTHER_ADDRESS      0x8000u     ///< Not cached by the direct tests.
+#define TEST_STUCK_WRITE_US     1000000u    ///< Page write time which is never waited out.
+#define TEST_TIMEOUT_LIMIT_US   100000u     ///< Longest a timed out call may take.
+#define TEST_FILL               0x5Au       ///< Left in the buffer if nothing is read.
+#define TEST_PAGE_BYTES         128u        ///< Page size of the simulated M95.
+
+/// Most extra write cycles a patch can take, if its pages were written back already.
+#define TEST_PATCH_CYCLES(run)  (((run).patch_bytes + (2u * TEST_PAGE_BYTES) - 1u) / TEST_PAGE_BYTES)
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     sim_runs_check(void);
+
+static void     verify_read_check(void);
+
+static void     stuck_write_check(void);
+
+static bool_t   buffer_check(const uint8_t * const p_buffer,
+                             const uint32_t number_of_bytes,
+                             const uint8_t offset);
+
+static bool_t   device_check(const uint32_t address,
+                             const uint32_t number_of_bytes,
+                             const uint8_t offset);
+
+static uint32_t elapsed_us(const uint64_t start_ns);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// Address, bytes written, bytes patched, idle time between flush steps (us).
+static const m95_cache_sim_config_t m_runs[TEST_RUNS] =
+{
+    { 0x1001u,  7u,                         0u,     0u },
+    { 0x20F0u,  2000u,                      100u,   200u },
+    { 0x4000u,  M95_CACHE_SIM_MAX_BYTES,    2048u,  5000u },
+};
+
+static uint32_t m_failures;
+
+static uint8_t  m_data[TEST_BYTES];
+
+static uint8_t  m_read[TEST_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_m95_cache_check runs the m95_cache_sim ranges, then the verify read
+ * and timeout tests.
+ *
+ * @retval  bool_t      TRUE if everything was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_m95_cache_check(void)
+{
+    flash_sim_timing_t  timing;
+
+    m_failures = 0u;
+    flash_sim_timing_get(&timing);
+
+    sim_runs_check();
+    verify_read_check();
+    stuck_write_check();
+
+    /* Leave the driver and the device as the next check expects. */
+    M95_ForceTimeoutFlagReset_TDD();
+    M95_CacheDiscard_TDD();
+    flash_sim_timing_set(&timing);
+    flash_sim_reset();
+
+    printf("failures %u", m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * sim_runs_check writes every range in m_runs with m95_cache_sim.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void sim_runs_check(void)
+{
+    m95_cache_sim_result_t  result;
+    uint32_t                run;
+
+    for (run = 0u; run < TEST_RUNS; run++)
+    {
+        TEST_EXPECT(m95_cache_sim_run(&m_runs[run], &result));
+        TEST_EXPECT(result.b_cache_reads_match);
+        TEST_EXPECT(result.b_data_matches);
+        TEST_EXPECT(result.cached_write_cycles
+                        <= (result.blocking_write_cycles + TEST_PATCH_CYCLES(m_runs[run])));
+        TEST_EXPECT(result.cached_write_us < result.blocking_write_us);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * verify_read_check checks that M95_VerifyRead reads the data from the device,
+ * where M95_BlockRead returns it from the cache.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void verify_read_check(void)
+{
+    flash_sim_stats_t   stats;
+    uint32_t            i;
+
+    M95_CacheDiscard_TDD();
+    flash_sim_reset();
+
+    for (i = 0u; i < TEST_BYTES; i++)
+    {
+        m_data[i] = (uint8_t)(i + 1u);
+    }
+
+    TEST_EXPECT(M95_memcpy(TEST_ADDRESS, TEST_BYTES, &m_data[0])
+                    == M95_POLL_NO_WRITE_IN_PROGRESS);
+    TEST_EXPECT(!device_check(TEST_ADDRESS, TEST_BYTES, 1u));
+
+    flash_sim_stats_clear();
+    TEST_EXPECT(M95_BlockRead(TEST_ADDRESS, TEST_BYTES, &m_read[0])
+                    == M95_POLL_NO_WRITE_IN_PROGRESS);
+    TEST_EXPECT(buffer_check(&m_read[0], TEST_BYTES, 1u));
+    flash_sim_stats_get(&stats);
+    TEST_EXPECT(stats.m95_bytes_read == 0u);
+
+    for (i = 0u; i < TEST_BYTES; i++)
+    {
+        m_read[i] = TEST_FILL;
+    }
+
+    flash_sim_stats_clear();
+    TEST_EXPECT(M95_VerifyRead(TEST_ADDRESS, TEST_BYTES, &m_read[0])
+                    == M95_POLL_NO_WRITE_IN_PROGRESS);
+    TEST_EXPECT(buffer_check(&m_read[0], TEST_BYTES, 1u));
+    TEST_EXPECT(device_check(TEST_ADDRESS, TEST_BYTES, 1u));
+    flash_sim_stats_get(&stats);
+    TEST_EXPECT(stats.m95_bytes_read >= TEST_BYTES);
+
+    TEST_EXPECT(M95_Flush() == M95_POLL_NO_WRITE_IN_PROGRESS);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * stuck_write_check makes every page write outlast M95_PAGE_WRITE_TIMEOUT_MS,
+ * and checks that the driver gives up with an error rather than waiting.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void stuck_write_check(void)
+{
+    flash_sim_timing_t  timing;
+    uint64_t            start_ns;
+    uint32_t            i;
+
+    M95_CacheDiscard_TDD();
+    flash_sim_reset();
+
+    flash_sim_timing_get(&timing);
+    timing.m95_page_write_us = TEST_STUCK_WRITE_US;
+    flash_sim_timing_set(&timing);
+
+    for (i = 0u; i < TEST_BYTES; i++)
+    {
+        m_data[i] = (uint8_t)(i + 2u);
+    }
+
+    /* The flush drops each page which doesn't finish, and reports it once. */
+    TEST_EXPECT(M95_memcpy(TEST_ADDRESS, TEST_BYTES, &m_data[0])
+                    == M95_POLL_NO_WRITE_IN_PROGRESS);
+
+    start_ns = flash_sim_time_ns_get();
+    TEST_EXPECT(M95_Flush() == M95_POLL_TIMEOUT_EXCEEDED);
+    TEST_EXPECT(elapsed_us(start_ns) < TEST_TIMEOUT_LIMIT_US);
+    TEST_EXPECT(!M95_FlushStep());
+    TEST_EXPECT(M95_Flush() == M95_POLL_NO_WRITE_IN_PROGRESS);
+
+    /* The verify read can't vouch for the data, so reads nothing. */
+    flash_sim_reset();
+    TEST_EXPECT(M95_memcpy(TEST_ADDRESS, TEST_BYTES, &m_data[0])
+                    == M95_POLL_NO_WRITE_IN_PROGRESS);
+
+    for (i = 0u; i < TEST_BYTES; i++)
+    {
+        m_read[i] = TEST_FILL;
+    }
+
+    start_ns = flash_sim_time_ns_get();
+    TEST_EXPECT(M95_VerifyRead(TEST_ADDRESS, TEST_BYTES, &m_read[0])
+                    == M95_POLL_TIMEOUT_EXCEEDED);
+    TEST_EXPECT(elapsed_us(start_ns) < TEST_TIMEOUT_LIMIT_US);
+    TEST_EXPECT(m_read[0] == TEST_FILL);
+    TEST_EXPECT(M95_Flush() == M95_POLL_NO_WRITE_IN_PROGRESS);
+
+    /* A read which has to wait for the device times out with it. */
+    M95_CacheDiscard_TDD();
+    flash_sim_reset();
+    TEST_EXPECT(M95_memcpy(TEST_ADDRESS, 1u, &m_data[0])
+                    == M95_POLL_NO_WRITE_IN_PROGRESS);
+
+    start_ns = flash_sim_time_ns_get();
+    TEST_EXPECT(M95_BlockRead(TEST_OTHER_ADDRESS, TEST_BYTES, &m_read[0])
+                    == M95_POLL_TIMEOUT_EXCEEDED);
+    TEST_EXPECT(elapsed_us(start_ns) < TEST_TIMEOUT_LIMIT_US);
+    TEST_EXPECT(m_read[0] == TEST_FILL);
+    TEST_EXPECT(M95_Flush() == M95_POLL_TIMEOUT_EXCEEDED);
+
+    /* Nor is anything read while a forced time out leaves the page going. */
+    M95_CacheDiscard_TDD();
+    flash_sim_reset();
+    TEST_EXPECT(M95_memcpy(TEST_ADDRESS, 1u, &m_data[0])
+                    == M95_POLL_NO_WRITE_IN_PROGRESS);
+
+    M95_ForceTimeoutFlagSet();
+    TEST_EXPECT(M95_BlockRead(TEST_OTHER_ADDRESS, TEST_BYTES, &m_read[0])
+                    == M95_POLL_TIMEOUT_EXCEEDED);
+    TEST_EXPECT(m_read[0] == TEST_FILL);
+    M95_ForceTimeoutFlagReset_TDD();
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * buffer_check checks that a buffer holds the test pattern.
+ *
+ * @param   p_buffer            Pointer to the buffer.
+ * @param   number_of_bytes     Number of bytes to check.
+ * @param   offset              Value of the first byte in the pattern.
+ * @retval  bool_t              TRUE if the buffer holds the pattern.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t buffer_check(const uint8_t * const p_buffer,
+                           const uint32_t number_of_bytes,
+                           const uint8_t offset)
+{
+    uint32_t    i;
+    bool_t      b_matches = TRUE;
+
+    for (i = 0u; i < number_of_bytes; i++)
+    {
+        if (p_buffer[i] != (uint8_t)(i + offset))
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * device_check checks, straight from the simulated serial flash, that a range
+ * holds the test pattern.
+ *
+ * @param   address             First address to check.
+ * @param   number_of_bytes     Number of bytes to check.
+ * @param   offset              Value of the first byte in the pattern.
+ * @retval  bool_t              TRUE if the range holds the pattern.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t device_check(const uint32_t address,
+                           const uint32_t number_of_bytes,
+                           const uint8_t offset)
+{
+    uint8_t     device[TEST_BYTES];
+
+    (void)flash_sim_backdoor_read(STORAGE_DEVICE_SERIAL_FLASH, address,
+                                  number_of_bytes, &device[0]);
+
+    return buffer_check(&device[0], number_of_bytes, offset);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * elapsed_us returns the simulated time since a start time.
+ *
+ * @param   start_ns    Start time, from flash_sim_time_ns_get().
+ * @retval  uint32_t    Microseconds since then.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t elapsed_us(const uint64_t start_ns)
+{
+    return (uint32_t)((flash_sim_time_ns_get() - start_ns) / 1000u);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,300 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_opcode013.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the opcode 13 format, sent once or again and again.
+ * @details
+ * Opcode 13 requests are sent to the real opcode013.c, with the replies
+ * recorded through host_loader_hook_set(), and opcode13_FormatStep() is
+ * called between them as the loader does while it waits for a message.
+ *
+ *  - A host which sends the message once must get LOADER_FORMAT_IN_PROGRESS,
+ *    and the format must then finish between messages, leaving the partition
+ *    formatted and empty.  The next message for the partition must get
+ *    LOADER_OK without erasing anything, and the one after that must start a
+ *    new format.
+ *  - A host which sends the message again and again, with the loader waiting
+ *    a little between them, must get LOADER_FORMAT_IN_PROGRESS with the
+ *    progress never going back, and then LOADER_OK once, and the partition
+ *    must be formatted.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "timer.h"
+#include "comm.h"
+#include "opcode013.h"
+#include "rsapi.h"
+#include "rspartition.h"
+#include "rspages.h"
+#include "flash_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_PARTITION          4u          ///< Trajectory, main flash.
+#define TEST_IDLE_NS            1000000u    ///< Time between idle steps.
+#define TEST_IDLE_STEPS         50u         ///< Idle steps between resent messages.
+#define TEST_MAXIMUM_STEPS      100000u     ///< More than any format takes.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     request_send(const uint8_t partition_index);
+
+static uint32_t idle_steps_do(const uint32_t maximum_steps);
+
+static bool_t   partition_empty_check(void);
+
+static uint32_t sector_erases_get(void);
+
+static void     loader_call_record(const host_loader_call_t call,
+                                   const uint8_t status,
+                                   const uint16_t length,
+                                   const uint8_t* const p_data);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint32_t m_failures;
+static uint32_t m_replies;              ///< Replies to the last request.
+static uint8_t  m_reply_status;         ///< Status of the last reply.
+static uint8_t  m_reply_progress;       ///< Progress in the last reply, if any.
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_opcode013_check formats the partition as each host would.
+ *
+ * @retval  bool_t      TRUE if every reply was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_opcode013_check(void)
+{
+    uint32_t    erases_before;
+    uint32_t    idle_steps;
+    uint32_t    messages = 0u;
+    uint8_t     last_progress = 0u;
+    bool_t      b_finished = FALSE;
+
+    m_failures = 0u;
+
+    host_loader_hook_set(loader_call_record);
+
+    flash_sim_install();
+    flash_sim_reset();
+
+    TEST_EXPECT(rsapi_recording_system_init());
+
+    /* Sent once - the rest is done while the loader waits. */
+    request_send(TEST_PARTITION);
+    TEST_EXPECT(m_replies == 1u);
+    TEST_EXPECT(m_reply_status == LOADER_FORMAT_IN_PROGRESS);
+    TEST_EXPECT(rspartition_format_in_progress_check(TEST_PARTITION));
+
+    idle_steps = idle_steps_do(TEST_MAXIMUM_STEPS);
+    TEST_EXPECT(idle_steps < TEST_MAXIMUM_STEPS);
+    TEST_EXPECT(!rspartition_format_in_progress_check(TEST_PARTITION));
+    TEST_EXPECT(partition_empty_check());
+
+    /* The next message gets the result, without formatting again. */
+    erases_before = sector_erases_get();
+    request_send(TEST_PARTITION);
+    TEST_EXPECT(m_replies == 1u);
+    TEST_EXPECT(m_reply_status == LOADER_OK);
+    TEST_EXPECT(sector_erases_get() == erases_before);
+    TEST_EXPECT(!rspartition_format_in_progress_check(TEST_PARTITION));
+
+    /* The result has been given, so this is a new format - sent until done. */
+    while ( (!b_finished) && (messages < TEST_MAXIMUM_STEPS) )
+    {
+        request_send(TEST_PARTITION);
+        messages++;
+
+        TEST_EXPECT(m_replies == 1u);
+
+        if (m_reply_status == LOADER_FORMAT_IN_PROGRESS)
+        {
+            TEST_EXPECT(m_reply_progress >= last_progress);
+            last_progress = m_reply_progress;
+
+            (void)idle_steps_do(TEST_IDLE_STEPS);
+        }
+        else
+        {
+            TEST_EXPECT(m_reply_status == LOADER_OK);
+            b_finished = TRUE;
+        }
+    }
+
+    TEST_EXPECT(b_finished);
+    TEST_EXPECT(messages > 1u);
+    TEST_EXPECT(partition_empty_check());
+    TEST_EXPECT(!opcode13_FormatStep());
+
+    host_loader_hook_set(NULL);
+    flash_sim_reset();
+
+    printf("%u idle steps, %u messages, failures %u", idle_steps, messages, m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * request_send clears the recorded replies and sends an opcode 13 request.
+ *
+ * @param   partition_index     Partition to format.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void request_send(const uint8_t partition_index)
+{
+    LoaderMessage_t message;
+    Timer_t         timer;
+    uint8_t         data[1];
+
+    data[0] = partition_index;
+
+    message.opcode            = 13u;
+    message.dataPtr           = &data[0];
+    message.dataLengthInBytes = 1u;
+
+    m_replies        = 0u;
+    m_reply_status   = LOADER_OK;
+    m_reply_progress = 0u;
+
+    opcode13_execute(NULL, &message, &timer);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * idle_steps_do calls opcode13_FormatStep as the loader does while waiting
+ * for a message, until the format is done or enough steps have been made.
+ *
+ * @param   maximum_steps   Most steps to make.
+ * @retval  uint32_t        Steps made.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t idle_steps_do(const uint32_t maximum_steps)
+{
+    uint32_t    steps = 0u;
+    bool_t      b_more_to_do = TRUE;
+
+    while ( (b_more_to_do) && (steps < maximum_steps) )
+    {
+        b_more_to_do = opcode13_FormatStep();
+        flash_sim_time_advance(TEST_IDLE_NS);
+        steps++;
+    }
+
+    return steps;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * partition_empty_check checks that the partition is formatted and empty.
+ *
+ * @retval  bool_t      TRUE if it is.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t partition_empty_check(void)
+{
+    const rs_partition_info_t*  p_partition;
+
+    p_partition = rspartition_partition_ptr_get(TEST_PARTITION);
+
+    return ( (p_partition->partition_error_status == RS_ERR_NO_ERROR)
+                && (p_partition->next_available_address
+                        == (p_partition->start_address + PAGE_HEADER_LENGTH_BYTES)) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * sector_erases_get returns the number of main flash sectors erased so far.
+ *
+ * @retval  uint32_t    Sectors erased.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t sector_erases_get(void)
+{
+    flash_sim_stats_t   stats;
+
+    flash_sim_stats_get(&stats);
+
+    return stats.main_flash_sector_erases;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * loader_call_record records the status and any progress of each reply.
+ *
+ * @param   call        Loader function called.
+ * @param   status      Status of the reply.
+ * @param   length      Data length of the reply.
+ * @param   p_data      Pointer to the data of the reply.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void loader_call_record(const host_loader_call_t call,
+                               const uint8_t status,
+                               const uint16_t length,
+                               const uint8_t* const p_data)
+{
+    if (call == HOST_LOADER_SEND)
+    {
+        m_replies++;
+        m_reply_status = status;
+
+        if (length != 0u)
+        {
+            m_reply_progress = p_data[0];
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
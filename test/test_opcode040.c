@@ -0,0 +1,440 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_opcode040.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the opcode 40 windowed download.
+ * @details
+ * An application is downloaded with opcode 40 into the application partition
+ * modelled by host_program_memory_install(), through the real opcode040.c
+ * and prom_hardware.c, with the replies recorded through
+ * host_loader_hook_set().  The frames are OPCODE40_FRAME_WORDS long, apart
+ * from a short last one, so that every slot of the download buffer is used.
+ *
+ *  - A window with frames missing must program the frames up to the first
+ *    missing one, stage the rest each in its own slot, and reply with the
+ *    next expected frame and a bitmap of the missing ones.
+ *  - The next window, with the missing frames sent again, must ignore frames
+ *    already programmed or staged (even if their data has changed) and
+ *    frames past the end of the window, and program everything received in
+ *    order.  A frame past the end of the window must be reported missing.
+ *  - Sending the WINDOW_END again must give the same reply without
+ *    programming anything.
+ *  - The partition must then hold the whole image, each frame programmed
+ *    exactly once, with nothing after the short last frame.
+ *  - A malformed frame must fail the download until it is started again,
+ *    and opcode 40 must be refused outside a download.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "timer.h"
+#include "comm.h"
+#include "loader_state.h"
+#include "opcode040.h"
+#include "tool_specific_config.h"
+#include "tool_specific_programming.h"
+#include "prom_hardware.h"
+#include "genericIO.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_FRAMES             20u         ///< Frames in the image.
+#define TEST_LAST_FRAME_WORDS   100u        ///< Length of the short last frame.
+#define TEST_HEADER_BYTES       7u          ///< Subfield, sequence and address.
+#define TEST_MAX_MESSAGE_BYTES  (TEST_HEADER_BYTES + (OPCODE40_FRAME_WORDS * 2u))
+#define TEST_CHANGED_DATA       0x5A5Au     ///< Mixed into a frame sent again.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     start_send(void);
+
+static void     frame_send(const uint16_t frame, const uint16_t changed_data);
+
+static void     window_end_send(const uint16_t last_frame);
+
+static bool_t   window_reply_check(const uint16_t next_frame, const uint16_t missing_frames);
+
+static void     request_send(const uint16_t length);
+
+static bool_t   frame_programmed_check(const uint16_t frame);
+
+static uint32_t frame_words_get(const uint16_t frame);
+
+static uint16_t frame_word_get(const uint16_t frame, const uint32_t word);
+
+static void     loader_call_record(const host_loader_call_t call,
+                                   const uint8_t status,
+                                   const uint16_t length,
+                                   const uint8_t* const p_data);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint32_t         m_failures;
+static ELoaderState_t   m_loader_state;
+static uint8_t          m_message[TEST_MAX_MESSAGE_BYTES];
+static uint32_t         m_replies;              ///< Replies to the last request.
+static uint8_t          m_reply_status;         ///< Status of the last reply.
+static uint16_t         m_reply_length;         ///< Data length of the last reply.
+static uint8_t          m_reply[4];             ///< Data of the last reply.
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_opcode040_check downloads the image a window at a time.
+ *
+ * @retval  bool_t      TRUE if every reply and the image were as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_opcode040_check(void)
+{
+    uint16_t    frame;
+    uint32_t    programs;
+
+    m_failures = 0u;
+
+    host_loader_hook_set(loader_call_record);
+    host_program_memory_install();
+
+    TEST_EXPECT(PromHardware_PartitionPrepare(APPLICATION_PARTITION) == 0u);
+    m_loader_state = LOADER_SCRATCH_PREPARED;
+
+    start_send();
+    TEST_EXPECT(m_replies == 1u);
+    TEST_EXPECT(m_reply_status == LOADER_OK);
+    TEST_EXPECT(m_loader_state == LOADER_DOWNLOADING);
+
+    /* First window - frames 3 and 9 go missing. */
+    for (frame = 0u; frame < OPCODE40_WINDOW_FRAMES; frame++)
+    {
+        if ( (frame != 3u) && (frame != 9u) )
+        {
+            frame_send(frame, 0u);
+            TEST_EXPECT(m_replies == 0u);
+        }
+    }
+
+    window_end_send(OPCODE40_WINDOW_FRAMES - 1u);
+    TEST_EXPECT(window_reply_check(3u, (uint16_t)((1u << 0) | (1u << 6))));
+    TEST_EXPECT(host_program_memory_programs_get() == 3u);
+    TEST_EXPECT(frame_programmed_check(2u));
+    TEST_EXPECT(!frame_programmed_check(3u));
+    TEST_EXPECT(!frame_programmed_check(4u));
+
+    /* Frame 10 waits in its own slot of the buffer. */
+    TEST_EXPECT(genericIO_16bitRead(BUFFER_BASE_ADDRESS + (10u * OPCODE40_FRAME_WORDS))
+                    == frame_word_get(10u, 0u));
+
+    /* Second window - the missing frames, frames already programmed or
+     * staged (changed, so using them would show), then new frames into the
+     * slots freed, up to one past the end of the window. */
+    frame_send(3u, 0u);
+    frame_send(9u, 0u);
+    frame_send(1u, TEST_CHANGED_DATA);
+    frame_send(4u, TEST_CHANGED_DATA);
+
+    for (frame = OPCODE40_WINDOW_FRAMES; frame < TEST_FRAMES; frame++)
+    {
+        frame_send(frame, 0u);
+    }
+
+    TEST_EXPECT(m_replies == 0u);
+
+    window_end_send(TEST_FRAMES - 1u);
+    TEST_EXPECT(window_reply_check(TEST_FRAMES - 1u, 1u));
+    TEST_EXPECT(host_program_memory_programs_get() == (TEST_FRAMES - 1u));
+
+    /* Last window - the frame which was past the end of the window. */
+    frame_send(TEST_FRAMES - 1u, 0u);
+    window_end_send(TEST_FRAMES - 1u);
+    TEST_EXPECT(window_reply_check(TEST_FRAMES, 0u));
+
+    /* The reply was lost, so the window end is sent again. */
+    window_end_send(TEST_FRAMES - 1u);
+    TEST_EXPECT(window_reply_check(TEST_FRAMES, 0u));
+
+    programs = host_program_memory_programs_get();
+    TEST_EXPECT(programs == TEST_FRAMES);
+
+    for (frame = 0u; frame < TEST_FRAMES; frame++)
+    {
+        TEST_EXPECT(frame_programmed_check(frame));
+    }
+
+    TEST_EXPECT(host_program_memory_flash_get(APPLICATION_START_ADDRESS
+                                              + ((TEST_FRAMES - 1u) * OPCODE40_FRAME_WORDS)
+                                              + TEST_LAST_FRAME_WORDS) == 0xFFFFu);
+
+    /* A malformed frame (an odd number of data bytes) fails the download. */
+    start_send();
+    m_message[0] = OPCODE40_DATA;
+    request_send(TEST_HEADER_BYTES + 1u);
+    window_end_send(0u);
+    TEST_EXPECT( (m_replies == 1u) && (m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE) );
+
+    start_send();
+    window_end_send(0u);
+    TEST_EXPECT(window_reply_check(0u, 1u));
+
+    /* Refused if empty, or outside a download. */
+    request_send(0u);
+    TEST_EXPECT( (m_replies == 1u) && (m_reply_status == LOADER_WRONG_NUM_PARAMETERS) );
+
+    m_loader_state = LOADER_WAITING;
+    start_send();
+    TEST_EXPECT( (m_replies == 1u) && (m_reply_status == LOADER_INVALID_OPCODE) );
+
+    host_program_memory_remove();
+    host_loader_hook_set(NULL);
+
+    printf("%u frames, %u programs, failures %u", TEST_FRAMES, programs, m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * start_send sends OPCODE40_START.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void start_send(void)
+{
+    m_message[0] = OPCODE40_START;
+
+    request_send(1u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * frame_send sends a data frame of the image.
+ *
+ * @param   frame           Frame to send.
+ * @param   changed_data    Mixed into every word, or 0 to send the image.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void frame_send(const uint16_t frame, const uint16_t changed_data)
+{
+    const uint32_t  address = APPLICATION_START_ADDRESS + ((uint32_t)frame * OPCODE40_FRAME_WORDS);
+    const uint32_t  words = frame_words_get(frame);
+    uint32_t        word;
+    uint16_t        data;
+
+    m_message[0] = OPCODE40_DATA;
+    m_message[1] = (uint8_t)(frame & 0xFFu);
+    m_message[2] = (uint8_t)(frame >> 8);
+    m_message[3] = (uint8_t)(address & 0xFFu);
+    m_message[4] = (uint8_t)((address >> 8) & 0xFFu);
+    m_message[5] = (uint8_t)((address >> 16) & 0xFFu);
+    m_message[6] = (uint8_t)(address >> 24);
+
+    /* The data is sent most significant byte first (DOWNLOAD_ENDIANESS). */
+    for (word = 0u; word < words; word++)
+    {
+        data = frame_word_get(frame, word) ^ changed_data;
+
+        m_message[TEST_HEADER_BYTES + (word * 2u)]      = (uint8_t)(data >> 8);
+        m_message[TEST_HEADER_BYTES + (word * 2u) + 1u] = (uint8_t)(data & 0xFFu);
+    }
+
+    request_send((uint16_t)(TEST_HEADER_BYTES + (words * 2u)));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * window_end_send sends OPCODE40_WINDOW_END.
+ *
+ * @param   last_frame  Last frame sent in the window.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void window_end_send(const uint16_t last_frame)
+{
+    m_message[0] = OPCODE40_WINDOW_END;
+    m_message[1] = (uint8_t)(last_frame & 0xFFu);
+    m_message[2] = (uint8_t)(last_frame >> 8);
+
+    request_send(3u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * window_reply_check checks the reply to a WINDOW_END.
+ *
+ * @param   next_frame      Next frame expected.
+ * @param   missing_frames  Bitmap of the frames missing, from next_frame.
+ * @retval  bool_t          TRUE if the reply was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t window_reply_check(const uint16_t next_frame, const uint16_t missing_frames)
+{
+    return ( (m_replies == 1u)
+                && (m_reply_status == LOADER_OK)
+                && (m_reply_length == 4u)
+                && (m_reply[0] == (uint8_t)(next_frame & 0xFFu))
+                && (m_reply[1] == (uint8_t)(next_frame >> 8))
+                && (m_reply[2] == (uint8_t)(missing_frames & 0xFFu))
+                && (m_reply[3] == (uint8_t)(missing_frames >> 8)) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * request_send clears the recorded replies and sends the opcode 40 request
+ * in m_message.
+ *
+ * @param   length      Data length of the request.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void request_send(const uint16_t length)
+{
+    LoaderMessage_t message;
+    Timer_t         timer;
+
+    message.opcode            = 40u;
+    message.dataPtr           = &m_message[0];
+    message.dataLengthInBytes = length;
+
+    m_replies      = 0u;
+    m_reply_status = LOADER_OK;
+    m_reply_length = 0u;
+
+    opcode40_execute(&m_loader_state, &message, &timer);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * frame_programmed_check checks that a frame of the image is in the flash.
+ *
+ * @param   frame       Frame to check.
+ * @retval  bool_t      TRUE if every word of it is.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t frame_programmed_check(const uint16_t frame)
+{
+    const uint32_t  address = APPLICATION_START_ADDRESS + ((uint32_t)frame * OPCODE40_FRAME_WORDS);
+    uint32_t        word;
+    bool_t          b_programmed = TRUE;
+
+    for (word = 0u; word < frame_words_get(frame); word++)
+    {
+        if (host_program_memory_flash_get(address + word) != frame_word_get(frame, word))
+        {
+            b_programmed = FALSE;
+        }
+    }
+
+    return b_programmed;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * frame_words_get returns the length of a frame of the image.
+ *
+ * @param   frame       Frame.
+ * @retval  uint32_t    Length, in words.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t frame_words_get(const uint16_t frame)
+{
+    return (frame == (TEST_FRAMES - 1u)) ? TEST_LAST_FRAME_WORDS : OPCODE40_FRAME_WORDS;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * frame_word_get returns a word of the image, different in every frame.
+ *
+ * @param   frame       Frame.
+ * @param   word        Word within the frame.
+ * @retval  uint16_t    Word of the image.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t frame_word_get(const uint16_t frame, const uint32_t word)
+{
+    return (uint16_t)((((uint32_t)frame + 1u) * 0x1F3Du) ^ (word * 0x0101u));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * loader_call_record records the status and data of each reply.
+ *
+ * @param   call        Loader function called.
+ * @param   status      Status of the reply.
+ * @param   length      Data length of the reply.
+ * @param   p_data      Pointer to the data of the reply.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void loader_call_record(const host_loader_call_t call,
+                               const uint8_t status,
+                               const uint16_t length,
+                               const uint8_t* const p_data)
+{
+    uint16_t    byte;
+
+    if (call == HOST_LOADER_SEND)
+    {
+        m_replies++;
+        m_reply_status = status;
+        m_reply_length = length;
+
+        for (byte = 0u; (byte < length) && (byte < sizeof(m_reply)); byte++)
+        {
+            m_reply[byte] = p_data[byte];
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
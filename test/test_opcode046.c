@@ -0,0 +1,661 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_opcode046.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the opcode 46 fast dump.
+ * @details
+ * The MWD partition is filled with a known pattern, then opcode 46 requests
+ * are sent to the real opcode046.c, which sends its frames through the real
+ * sci.c.  The SCI B transmit interrupt is run from a host interval timer, so
+ * it arrives at any point of the dump as it would on the target, and takes
+ * one character from the driver each time (the FIFO is shown as all but
+ * full), which is recorded as the character on the wire.
+ *
+ *  - Selecting the partition (command 5) must reply with its ID and next
+ *    free address.
+ *  - A command 4 dump must be sent as one long frame - the 10 byte header,
+ *    the data, then the CRC over both and ^Z - as before the dump was
+ *    overlapped.
+ *  - A command 6 dump of a range which starts and ends on odd bytes must be
+ *    sent as complete frames of up to 512 bytes, each with its byte offset
+ *    and CRC, and the data of the range.
+ *  - The same dump restarted from the end of its first frame, as the host
+ *    does after a link drop, must send the rest of the frames unchanged.
+ *  - Frames must be read from the flash while the one before is being sent,
+ *    and the bus must only be turned round once for a whole dump.
+ *  - A command 6 with the wrong length, an empty range or a range past the
+ *    end of the partition must be refused, with nothing sent.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include "common_data_types.h"
+#include "DSP28335_device.h"
+#include "timer.h"
+#include "comm.h"
+#include "loader_state.h"
+#include "opcode046.h"
+#include "crc.h"
+#include "genericIO.h"
+#include "iocontrolcommon.h"
+#include "rsapi.h"
+#include "rspartition.h"
+#include "flash_hal.h"
+#include "flash_sim.h"
+#include "sci.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_PARTITION          2u          ///< MWD, main flash.
+#define TEST_FILL_BYTES         0x3000u     ///< Bytes of pattern at the start of the partition.
+#define TEST_FILL_CHUNK         256u        ///< Bytes of pattern written at a time.
+#define TEST_MAX_CHARACTERS     4096u       ///< Characters recorded for one dump.
+#define TEST_INTERRUPT_US       10          ///< Host timer period for the transmit interrupt.
+
+#define TEST_LEGACY_KBYTES      3u          ///< Command 4 dump size.
+#define TEST_RANGE_OFFSET       0x2001u     ///< Command 6 dump, from an odd byte...
+#define TEST_RANGE_BYTES        1301u       ///< ...to an odd byte, in three frames.
+
+#define TEST_FRAME_DATA_BYTES   512u        ///< Most data in a range frame.
+#define TEST_LEGACY_HEADER      10u
+#define TEST_RANGE_HEADER       9u
+#define TEST_TRAILER            3u          ///< CRC MSB, CRC LSB and ^Z.
+
+#define TEST_NO_CHARACTER       0xFFFFu     ///< SCITXBUF before the interrupt runs.
+#define TEST_SCI_TX_FIFO_DEPTH  16u
+#define TEST_SCIB_SCICTL2       0x7754u     ///< SCI B registers sci.c reads through genericIO.
+#define TEST_SCIB_SCIFFTX       0x775Au
+#define TEST_SCICTL2_TXEMPTY    0x0040u
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   pattern_fill(void);
+
+static uint8_t  pattern_byte(const uint32_t offset);
+
+static void     request_send(const uint8_t command,
+                             const uint32_t first,
+                             const uint32_t second,
+                             const uint16_t data_length);
+
+static bool_t   legacy_frame_check(const uint32_t partition_start);
+
+static bool_t   range_frames_check(const uint32_t byte_offset, const uint32_t byte_count);
+
+static void     tx_interrupt(int signal_number);
+
+static uint16_t sci_register_read(const uint32_t address);
+
+static void     loader_call_record(const host_loader_call_t call,
+                                   const uint8_t status,
+                                   const uint16_t length,
+                                   const uint8_t* const p_data);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint32_t     m_failures;
+static uint32_t     m_replies;              ///< Replies to the last request.
+static uint8_t      m_reply_status;         ///< Status of the last reply.
+static uint16_t     m_reply_length;         ///< Data length of the last reply.
+static uint8_t      m_reply[5];             ///< Data of the last reply.
+
+static uint8_t      m_characters[TEST_MAX_CHARACTERS];  ///< Sent by the last request.
+static volatile uint32_t    m_character_count;
+static volatile uint32_t    m_reads_while_sending;      ///< Interrupts with flash reads since a busy one.
+static volatile uint32_t    m_bus_reads;                ///< Flash bus reads at the last interrupt.
+static volatile bool_t      m_b_sending;                ///< The last interrupt sent a character.
+
+static bool_t       m_b_transmitter_enabled;
+static bool_t       m_b_receiver_enabled;
+static uint32_t     m_transmitter_enables;  ///< Times the bus was turned round to send.
+
+static uint16_t (*m_saved_16bit_read)(const uint32_t address);
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_opcode046_check fills the partition and makes each request.
+ *
+ * @retval  bool_t      TRUE if every dump and reply was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_opcode046_check(void)
+{
+    const rs_partition_info_t*  p_partition;
+    uint8_t                     first_dump[TEST_MAX_CHARACTERS];
+    uint32_t                    first_dump_length;
+    uint32_t                    first_frame_length;
+    uint32_t                    partition_bytes;
+    uint32_t                    reads_while_sending;
+
+    m_failures = 0u;
+
+    host_loader_hook_set(loader_call_record);
+
+    flash_sim_install();
+    flash_sim_reset();
+
+    m_saved_16bit_read  = genericIO_16bitRead;
+    genericIO_16bitRead = sci_register_read;
+
+    TEST_EXPECT(rsapi_recording_system_init());
+    TEST_EXPECT(pattern_fill());
+
+    p_partition     = rspartition_partition_ptr_get(TEST_PARTITION);
+    partition_bytes = (p_partition->end_address - p_partition->start_address) + 1u;
+
+    /* Select the partition. */
+    request_send(5u, TEST_PARTITION, 0u, 2u);
+    TEST_EXPECT( (m_replies == 1u) && (m_reply_status == LOADER_OK) && (m_reply_length == 5u) );
+    TEST_EXPECT(m_reply[0] == (uint8_t)p_partition->id);
+    TEST_EXPECT(m_reply[1] == (uint8_t)(p_partition->next_available_address & 0xFFu));
+    TEST_EXPECT(m_reply[4] == (uint8_t)(p_partition->next_available_address >> 24));
+
+    /* The Toolscope dump, from the start of the partition. */
+    TEST_EXPECT((p_partition->start_address & 0xFFu) == 0u);
+    request_send(4u, TEST_LEGACY_KBYTES | (p_partition->start_address & 0xFFFFFF00u), 0u, 6u);
+    TEST_EXPECT(m_replies == 0u);
+    TEST_EXPECT(legacy_frame_check(p_partition->start_address));
+    TEST_EXPECT(m_transmitter_enables == 1u);
+
+    /* A range from and to odd bytes. */
+    request_send(6u, TEST_RANGE_OFFSET, TEST_RANGE_BYTES, 9u);
+    TEST_EXPECT(m_replies == 0u);
+    TEST_EXPECT(range_frames_check(TEST_RANGE_OFFSET, TEST_RANGE_BYTES));
+    TEST_EXPECT(m_transmitter_enables == 1u);
+
+    reads_while_sending = m_reads_while_sending;
+    TEST_EXPECT(reads_while_sending != 0u);
+
+    first_dump_length = m_character_count;
+    (void)memcpy(&first_dump[0], &m_characters[0], first_dump_length);
+
+    /* Restarted after the first frame. */
+    first_frame_length = TEST_RANGE_HEADER + TEST_FRAME_DATA_BYTES + TEST_TRAILER;
+
+    request_send(6u, TEST_RANGE_OFFSET + TEST_FRAME_DATA_BYTES,
+                 TEST_RANGE_BYTES - TEST_FRAME_DATA_BYTES, 9u);
+    TEST_EXPECT(range_frames_check(TEST_RANGE_OFFSET + TEST_FRAME_DATA_BYTES,
+                                   TEST_RANGE_BYTES - TEST_FRAME_DATA_BYTES));
+    TEST_EXPECT(m_character_count == (first_dump_length - first_frame_length));
+    TEST_EXPECT(memcmp(&m_characters[0], &first_dump[first_frame_length],
+                       m_character_count) == 0);
+
+    /* Refused, with nothing sent. */
+    request_send(6u, TEST_RANGE_OFFSET, TEST_RANGE_BYTES, 8u);
+    TEST_EXPECT( (m_replies == 1u) && (m_reply_status == LOADER_WRONG_NUM_PARAMETERS) );
+    TEST_EXPECT( (m_character_count == 0u) && (m_transmitter_enables == 0u) );
+
+    request_send(6u, TEST_RANGE_OFFSET, TEST_RANGE_BYTES, 10u);
+    TEST_EXPECT( (m_replies == 1u) && (m_reply_status == LOADER_WRONG_NUM_PARAMETERS) );
+    TEST_EXPECT( (m_character_count == 0u) && (m_transmitter_enables == 0u) );
+
+    request_send(6u, TEST_RANGE_OFFSET, 0u, 9u);
+    TEST_EXPECT( (m_replies == 1u) && (m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE) );
+    TEST_EXPECT(m_character_count == 0u);
+
+    request_send(6u, partition_bytes - 1u, 2u, 9u);
+    TEST_EXPECT( (m_replies == 1u) && (m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE) );
+    TEST_EXPECT(m_character_count == 0u);
+
+    /* Up to the last byte of the partition. */
+    request_send(6u, partition_bytes - 1u, 1u, 9u);
+    TEST_EXPECT(m_replies == 0u);
+    TEST_EXPECT(m_character_count == (TEST_RANGE_HEADER + 1u + TEST_TRAILER));
+
+    genericIO_16bitRead = m_saved_16bit_read;
+    host_loader_hook_set(NULL);
+    flash_sim_reset();
+
+    printf("%u interrupts found reads while sending, failures %u", reads_while_sending, m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * IOCONTROLCOMMON_RS485ReceiverEnable stands in for iocontrolcommon.c,
+ * recording the direction of the bus.
+ *
+ */
+// ----------------------------------------------------------------------------
+void IOCONTROLCOMMON_RS485ReceiverEnable(void)
+{
+    m_b_receiver_enabled = TRUE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * IOCONTROLCOMMON_RS485ReceiverDisable stands in for iocontrolcommon.c.
+ *
+ */
+// ----------------------------------------------------------------------------
+void IOCONTROLCOMMON_RS485ReceiverDisable(void)
+{
+    m_b_receiver_enabled = FALSE;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * IOCONTROLCOMMON_RS485TransmitterEnable stands in for iocontrolcommon.c,
+ * counting the times the bus is turned round to send.
+ *
+ */
+// ----------------------------------------------------------------------------
+void IOCONTROLCOMMON_RS485TransmitterEnable(void)
+{
+    m_b_transmitter_enabled = TRUE;
+    m_transmitter_enables++;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * IOCONTROLCOMMON_RS485TransmitterDisable stands in for iocontrolcommon.c.
+ *
+ */
+// ----------------------------------------------------------------------------
+void IOCONTROLCOMMON_RS485TransmitterDisable(void)
+{
+    m_b_transmitter_enabled = FALSE;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * pattern_fill writes the pattern into the start of the partition, and
+ * leaves the rest erased.
+ *
+ * @retval  bool_t          TRUE if every write worked.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t pattern_fill(void)
+{
+    const rs_partition_info_t*  p_partition;
+    uint8_t                     chunk[TEST_FILL_CHUNK];
+    uint32_t                    offset;
+    uint32_t                    i;
+    bool_t                      b_filled = TRUE;
+
+    p_partition = rspartition_partition_ptr_get(TEST_PARTITION);
+
+    for (offset = 0u; offset < TEST_FILL_BYTES; offset += TEST_FILL_CHUNK)
+    {
+        for (i = 0u; i < TEST_FILL_CHUNK; i++)
+        {
+            chunk[i] = pattern_byte(offset + i);
+        }
+
+        if (flash_hal_device_write(p_partition->start_address + offset,
+                                   TEST_FILL_CHUNK, &chunk[0]) != FLASH_HAL_NO_ERROR)
+        {
+            b_filled = FALSE;
+        }
+    }
+
+    return b_filled;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * pattern_byte works out the pattern at an offset into the partition, or
+ * the erased value past the end of it.  It repeats every 253 bytes, so no
+ * frame looks like another.
+ *
+ * @param   offset      Offset into the partition.
+ * @retval  uint8_t     Pattern byte.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint8_t pattern_byte(const uint32_t offset)
+{
+    uint8_t     data = 0xFFu;
+
+    if (offset < TEST_FILL_BYTES)
+    {
+        data = (uint8_t)((offset % 253u) ^ 0xA5u);
+    }
+
+    return data;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * request_send clears the recorded replies and characters and makes an
+ * opcode 46 request, with the transmit interrupt running.  The two values
+ * go after the command byte, LSB first, then a zero byte, as much of them
+ * as fits the length.
+ *
+ * @param   command         Command byte.
+ * @param   first           First value - partition, size and address, or offset.
+ * @param   second          Second value - byte count.
+ * @param   data_length     Bytes in the request, including the command byte.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void request_send(const uint8_t command,
+                         const uint32_t first,
+                         const uint32_t second,
+                         const uint16_t data_length)
+{
+    LoaderMessage_t     message;
+    Timer_t             timer;
+    struct itimerval    interval;
+    void                (*p_saved_handler)(int);
+    uint8_t             data[10];
+    uint16_t            i;
+
+    data[0] = command;
+    data[9] = 0u;
+
+    for (i = 0u; i < 4u; i++)
+    {
+        data[1u + i] = (uint8_t)((first >> (8u * i)) & 0xFFu);
+        data[5u + i] = (uint8_t)((second >> (8u * i)) & 0xFFu);
+    }
+
+    message.opcode            = 46u;
+    message.dataPtr           = &data[0];
+    message.dataLengthInBytes = data_length;
+
+    m_replies               = 0u;
+    m_character_count       = 0u;
+    m_reads_while_sending   = 0u;
+    m_b_sending             = FALSE;
+    m_transmitter_enables   = 0u;
+    m_b_transmitter_enabled = FALSE;
+    m_b_receiver_enabled    = TRUE;
+
+    ScibRegs.SCIFFTX.all = 0u;
+
+    interval.it_interval.tv_sec  = 0;
+    interval.it_interval.tv_usec = TEST_INTERRUPT_US;
+    interval.it_value            = interval.it_interval;
+
+    p_saved_handler = signal(SIGALRM, tx_interrupt);
+    (void)setitimer(ITIMER_REAL, &interval, NULL);
+
+    opcode46_execute(NULL, &message, &timer);
+
+    (void)memset(&interval, 0, sizeof(interval));
+    (void)setitimer(ITIMER_REAL, &interval, NULL);
+    (void)signal(SIGALRM, p_saved_handler);
+
+    /* Every dump must leave the bus listening. */
+    if ( (m_b_transmitter_enabled) || (!m_b_receiver_enabled) )
+    {
+        printf("bus left sending  ");
+        m_failures++;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * legacy_frame_check checks the characters sent by a command 4 dump of
+ * TEST_LEGACY_KBYTES from the start of the partition.
+ *
+ * @param   partition_start     Logical start address of the partition.
+ * @retval  bool_t              TRUE if the frame was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t legacy_frame_check(const uint32_t partition_start)
+{
+    const uint32_t  data_bytes = TEST_LEGACY_KBYTES * 1024u;
+    uint8_t         header[TEST_LEGACY_HEADER];
+    uint16_t        crc;
+    uint32_t        i;
+    bool_t          b_matches;
+
+    header[0] = 0x01u;
+    header[1] = 0xFDu;
+    header[2] = (uint8_t)((data_bytes + 11u) & 0xFFu);
+    header[3] = (uint8_t)((data_bytes + 11u) >> 8);
+    header[4] = 0u;
+    header[5] = TEST_LEGACY_KBYTES;
+    header[6] = (uint8_t)((partition_start >> 8) & 0xFFu);
+    header[7] = (uint8_t)((partition_start >> 16) & 0xFFu);
+    header[8] = (uint8_t)((partition_start >> 24) & 0xFFu);
+    header[9] = 0u;
+
+    b_matches = (m_character_count == (TEST_LEGACY_HEADER + data_bytes + TEST_TRAILER))
+                    && (memcmp(&m_characters[0], &header[0], TEST_LEGACY_HEADER) == 0);
+
+    for (i = 0u; (b_matches) && (i < data_bytes); i++)
+    {
+        b_matches = (m_characters[TEST_LEGACY_HEADER + i] == pattern_byte(i));
+    }
+
+    if (b_matches)
+    {
+        crc = CRC_CCITTOnByteCalculate(&m_characters[0], TEST_LEGACY_HEADER + data_bytes, 0u);
+
+        b_matches = (m_characters[TEST_LEGACY_HEADER + data_bytes] == (uint8_t)(crc >> 8))
+                    && (m_characters[TEST_LEGACY_HEADER + data_bytes + 1u] == (uint8_t)(crc & 0xFFu))
+                    && (m_characters[TEST_LEGACY_HEADER + data_bytes + 2u] == 0x1Au);
+    }
+
+    return b_matches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * range_frames_check checks the characters sent by a command 6 dump - one
+ * frame after another, each holding the next part of the range.
+ *
+ * @param   byte_offset     Offset into the partition the dump started from.
+ * @param   byte_count      Bytes dumped.
+ * @retval  bool_t          TRUE if every frame was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t range_frames_check(const uint32_t byte_offset, const uint32_t byte_count)
+{
+    const uint8_t*  p_frame;
+    uint32_t        position = 0u;
+    uint32_t        offset = byte_offset;
+    uint32_t        frame_offset;
+    uint16_t        length;
+    uint16_t        crc;
+    uint16_t        i;
+    bool_t          b_matches = TRUE;
+
+    while ( (b_matches) && (offset < (byte_offset + byte_count)) )
+    {
+        p_frame = &m_characters[position];
+
+        length = (uint16_t)(byte_offset + byte_count - offset);
+
+        if (length > TEST_FRAME_DATA_BYTES)
+        {
+            length = TEST_FRAME_DATA_BYTES;
+        }
+
+        frame_offset = (uint32_t)p_frame[5] | ((uint32_t)p_frame[6] << 8)
+                        | ((uint32_t)p_frame[7] << 16) | ((uint32_t)p_frame[8] << 24);
+
+        b_matches = ((position + TEST_RANGE_HEADER + length + TEST_TRAILER) <= m_character_count)
+                    && (p_frame[0] == 0x01u) && (p_frame[1] == 0xFDu)
+                    && (p_frame[2] == (uint8_t)(length & 0xFFu))
+                    && (p_frame[3] == (uint8_t)(length >> 8))
+                    && (p_frame[4] == LOADER_OK)
+                    && (frame_offset == offset);
+
+        for (i = 0u; (b_matches) && (i < length); i++)
+        {
+            b_matches = (p_frame[TEST_RANGE_HEADER + i] == pattern_byte(offset + i));
+        }
+
+        if (b_matches)
+        {
+            crc = CRC_CCITTOnByteCalculate(p_frame, TEST_RANGE_HEADER + (uint32_t)length, 0u);
+
+            b_matches = (p_frame[TEST_RANGE_HEADER + length] == (uint8_t)(crc >> 8))
+                        && (p_frame[TEST_RANGE_HEADER + length + 1u] == (uint8_t)(crc & 0xFFu))
+                        && (p_frame[TEST_RANGE_HEADER + length + 2u] == 0x1Au);
+        }
+
+        position += TEST_RANGE_HEADER + length + TEST_TRAILER;
+        offset   += length;
+    }
+
+    return ( (b_matches) && (position == m_character_count) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * tx_interrupt runs the SCI B transmit interrupt, if it is enabled, with
+ * room in the FIFO for one character, and records the character it sends.
+ * It also counts the interrupts which find the flash has been read since
+ * the last one, while the transmitter was busy the whole time.
+ *
+ * @param   signal_number   SIGALRM.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void tx_interrupt(int signal_number)
+{
+    flash_sim_stats_t   stats;
+    bool_t              b_sent = FALSE;
+
+    if (ScibRegs.SCIFFTX.bit.TXFFIENA != 0u)
+    {
+        ScibRegs.SCIFFTX.bit.TXFFST = TEST_SCI_TX_FIFO_DEPTH - 1u;
+        ScibRegs.SCITXBUF = TEST_NO_CHARACTER;
+
+        SCI_TxInterruptB_ISR();
+
+        /* The character has gone by the next interrupt. */
+        ScibRegs.SCIFFTX.bit.TXFFST = 0u;
+
+        if ( (ScibRegs.SCITXBUF != TEST_NO_CHARACTER)
+                && (m_character_count < TEST_MAX_CHARACTERS) )
+        {
+            m_characters[m_character_count] = (uint8_t)ScibRegs.SCITXBUF;
+            m_character_count++;
+            b_sent = TRUE;
+        }
+    }
+
+    flash_sim_stats_get(&stats);
+
+    if ( (b_sent) && (m_b_sending) && (stats.main_flash_bus_reads != m_bus_reads) )
+    {
+        m_reads_while_sending++;
+    }
+
+    m_b_sending = b_sent;
+    m_bus_reads = stats.main_flash_bus_reads;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * sci_register_read shows the SCI B transmit FIFO and shift register empty
+ * between interrupts, and passes every other read on.
+ *
+ * @param   address     Address to read.
+ * @retval  uint16_t    Register contents.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t sci_register_read(const uint32_t address)
+{
+    uint16_t    data;
+
+    if (address == TEST_SCIB_SCIFFTX)
+    {
+        data = ScibRegs.SCIFFTX.all;
+    }
+    else if (address == TEST_SCIB_SCICTL2)
+    {
+        data = TEST_SCICTL2_TXEMPTY;
+    }
+    else
+    {
+        data = m_saved_16bit_read(address);
+    }
+
+    return data;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * loader_call_record records the last reply.
+ *
+ * @param   call        Loader function called.
+ * @param   status      Status of the reply.
+ * @param   length      Data length of the reply.
+ * @param   p_data      Pointer to the data of the reply.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void loader_call_record(const host_loader_call_t call,
+                               const uint8_t status,
+                               const uint16_t length,
+                               const uint8_t* const p_data)
+{
+    uint16_t    i;
+
+    m_replies++;
+    m_reply_status = status;
+    m_reply_length = length;
+
+    for (i = 0u; (i < length) && (i < sizeof(m_reply)); i++)
+    {
+        m_reply[i] = p_data[i];
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,469 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_opcode191.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the opcode 191 partition and range CRCs.
+ * @details
+ * An application image, with its CRC in the last word, is programmed into
+ * the application partition modelled by host_program_memory_install().
+ * genericIO_16bitRead() is then wrapped so that each word read takes
+ * TEST_READ_NS of simulated time, so that a CRC of the whole partition takes
+ * several OPCODE191_TIME_SLICE_MS slices.  Opcode 191 requests are sent to
+ * the real opcode191.c, with the replies recorded through
+ * host_loader_hook_set().
+ *
+ *  - A partition CRC must reply LOADER_FORMAT_IN_PROGRESS until it is done,
+ *    then LOADER_OK with the CRC and the expected CRC, both matching the CRC
+ *    calculated here straight from the image.  Polling again must give the
+ *    same result.
+ *  - A range CRC must match too, with zero for the expected CRC, and must be
+ *    allowed up to the last word of the flash and of the OTP.
+ *  - A range which isn't all within the flash or the OTP (peripheral
+ *    registers, RAM, or across the end of either) must be refused, as must
+ *    an unknown partition, and a poll must then be refused as well.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "tool_specific_config.h"
+#include "tool_specific_programming.h"
+#include "loader_state.h"
+#include "timer.h"
+#include "comm.h"
+#include "opcode191.h"
+#include "prom_hardware.h"
+#include "genericIO.h"
+#include "dsp_crc.h"
+#include "utils.h"
+#include "flash_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_READ_NS            1000u       ///< Simulated time for each word read.
+#define TEST_MAXIMUM_POLLS      100u        ///< More than any CRC takes.
+#define TEST_RANGE_START        0x300100uL  ///< Range within the image.
+#define TEST_RANGE_WORDS        1000u
+#define TEST_FLASH_LAST         0x33FFFFuL  ///< Last word of the flash.
+#define TEST_OTP_START          0x380400uL  ///< OTP, which reads as erased here.
+#define TEST_OTP_WORDS          0x400u
+#define TEST_NO_REPLY           0xFFu       ///< Status before any reply.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     image_program(void);
+
+static uint16_t image_word_get(const uint32_t address);
+
+static uint16_t image_crc_get(const uint32_t start_address, const uint32_t length);
+
+static void     partition_request_send(const uint16_t partition);
+
+static void     range_request_send(const uint32_t start_address, const uint32_t length);
+
+static void     poll_request_send(void);
+
+static uint32_t polls_until_done(void);
+
+static void     request_send(uint8_t* const p_data, const uint16_t length);
+
+static uint16_t timed_16bit_read(const uint32_t address);
+
+static void     loader_call_record(const host_loader_call_t call,
+                                   const uint8_t status,
+                                   const uint16_t length,
+                                   const uint8_t* const p_data);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint32_t m_failures;
+static uint32_t m_replies;              ///< Replies to the last request.
+static uint8_t  m_reply_status;         ///< Status of the last reply.
+static uint16_t m_reply_crc;            ///< CRC in the last LOADER_OK reply.
+static uint16_t m_reply_expected_crc;   ///< Expected CRC in the same reply.
+
+/// The model's genericIO_16bitRead, wrapped by timed_16bit_read().
+static uint16_t (*m_model_16bit_read)(const uint32_t address);
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_opcode191_check calculates the CRCs of the image, and of ranges in
+ * and out of the flash and OTP.
+ *
+ * @retval  bool_t      TRUE if every reply was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_opcode191_check(void)
+{
+    uint16_t    image_crc;
+    uint32_t    polls;
+
+    m_failures = 0u;
+
+    host_loader_hook_set(loader_call_record);
+    host_program_memory_install();
+    flash_sim_reset();
+
+    image_program();
+    image_crc = image_crc_get(APPLICATION_START_ADDRESS, APPLICATION_LENGTH);
+    TEST_EXPECT(genericIO_16bitRead(APPLICATION_CRC_ADDRESS) == image_crc);
+
+    m_model_16bit_read = genericIO_16bitRead;
+    genericIO_16bitRead = timed_16bit_read;
+
+    /* The whole partition takes more than one slice. */
+    partition_request_send(APPLICATION_PARTITION);
+    TEST_EXPECT(m_replies == 1u);
+    TEST_EXPECT(m_reply_status == LOADER_FORMAT_IN_PROGRESS);
+
+    polls = polls_until_done();
+    TEST_EXPECT(polls > 1u);
+    TEST_EXPECT(polls < TEST_MAXIMUM_POLLS);
+    TEST_EXPECT(m_reply_crc == image_crc);
+    TEST_EXPECT(m_reply_expected_crc == image_crc);
+
+    /* Polled again, in case the reply was lost. */
+    poll_request_send();
+    TEST_EXPECT(m_reply_status == LOADER_OK);
+    TEST_EXPECT(m_reply_crc == image_crc);
+
+    /* A range within the image, done in the first slice. */
+    range_request_send(TEST_RANGE_START, TEST_RANGE_WORDS);
+    TEST_EXPECT(m_replies == 1u);
+    TEST_EXPECT(m_reply_status == LOADER_OK);
+    TEST_EXPECT(m_reply_crc == image_crc_get(TEST_RANGE_START, TEST_RANGE_WORDS));
+    TEST_EXPECT(m_reply_expected_crc == 0u);
+
+    /* Up to the last word of the flash, and the whole OTP. */
+    range_request_send(TEST_FLASH_LAST, 1u);
+    TEST_EXPECT(m_reply_status == LOADER_OK);
+    TEST_EXPECT(m_reply_crc == image_crc_get(TEST_FLASH_LAST, 1u));
+
+    range_request_send(TEST_OTP_START, TEST_OTP_WORDS);
+    TEST_EXPECT(m_reply_status == LOADER_OK);
+    TEST_EXPECT(m_reply_crc == image_crc_get(TEST_OTP_START, TEST_OTP_WORDS));
+
+    /* Anything else is refused, and there's nothing to poll for after. */
+    range_request_send(0x007000uL, 1u);             /* Peripheral registers. */
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+    poll_request_send();
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+
+    range_request_send(BUFFER_BASE_ADDRESS, 1u);    /* RAM. */
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+    range_request_send(APPLICATION_START_ADDRESS - 1u, 2u);
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+    range_request_send(TEST_FLASH_LAST, 2u);
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+    range_request_send(TEST_OTP_START, TEST_OTP_WORDS + 1u);
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+    range_request_send(TEST_RANGE_START, 0u);
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+    range_request_send(TEST_RANGE_START, 0xFFFFFFFFuL);
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+
+    partition_request_send(UNDEFINED_PARTITION);
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+    poll_request_send();
+    TEST_EXPECT(m_reply_status == LOADER_PARAMETER_OUT_OF_RANGE);
+
+    genericIO_16bitRead = m_model_16bit_read;
+    host_program_memory_remove();
+    host_loader_hook_set(NULL);
+
+    printf("%u polls for the partition, failures %u", polls, m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * image_program programs the image into the application partition, a
+ * buffer at a time through the download buffer, then its CRC into the last
+ * word.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void image_program(void)
+{
+    FlashStatus_t   flash_status;
+    uint32_t        address;
+    uint32_t        words;
+    uint32_t        word;
+
+    for (address = APPLICATION_START_ADDRESS;
+         address < (APPLICATION_START_ADDRESS + APPLICATION_LENGTH);
+         address += words)
+    {
+        words = (APPLICATION_START_ADDRESS + APPLICATION_LENGTH) - address;
+        if (words > BUFFER_LENGTH)
+        {
+            words = BUFFER_LENGTH;
+        }
+
+        for (word = 0u; word < words; word++)
+        {
+            genericIO_16bitWrite(BUFFER_BASE_ADDRESS + word, image_word_get(address + word));
+        }
+
+        TEST_EXPECT(ToolSpecificProgramming_SafeFlashProgram((void*)(uintptr_t)address,
+                                                             (uint16_t*)(uintptr_t)BUFFER_BASE_ADDRESS,
+                                                             words, &flash_status));
+    }
+
+    genericIO_16bitWrite(BUFFER_BASE_ADDRESS,
+                         image_crc_get(APPLICATION_START_ADDRESS, APPLICATION_LENGTH));
+    TEST_EXPECT(ToolSpecificProgramming_SafeFlashProgram((void*)(uintptr_t)APPLICATION_CRC_ADDRESS,
+                                                         (uint16_t*)(uintptr_t)BUFFER_BASE_ADDRESS,
+                                                         1u, &flash_status));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * image_word_get returns a word of the image, or erased flash outside it.
+ *
+ * @param   address     Address of the word.
+ * @retval  uint16_t    Word at the address.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t image_word_get(const uint32_t address)
+{
+    uint16_t    data = 0xFFFFu;
+
+    if ( (address >= APPLICATION_START_ADDRESS)
+            && (address < (APPLICATION_START_ADDRESS + APPLICATION_LENGTH)) )
+    {
+        data = (uint16_t)((address * 0x9E37u) ^ (address >> 7));
+    }
+
+    return data;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * image_crc_get calculates the CRC of part of the image straight from
+ * image_word_get(), as opcode 39 calculates the CRC stored with an image.
+ *
+ * @param   start_address   First address.
+ * @param   length          Number of words.
+ * @retval  uint16_t        CRC.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t image_crc_get(const uint32_t start_address, const uint32_t length)
+{
+    uint32_t    word;
+    uint16_t    data;
+    uint16_t    crc = 0u;
+
+    for (word = 0u; word < length; word++)
+    {
+        data = image_word_get(start_address + word);
+        crc = crc_calcRunningCRC(crc, &data, 1u, WORD_CRC_CALC);
+    }
+
+    return crc_calcFinalCRC(crc, WORD_CRC_CALC);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * partition_request_send sends an OPCODE191_PARTITION request.
+ *
+ * @param   partition   Partition number.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void partition_request_send(const uint16_t partition)
+{
+    uint8_t     data[3];
+
+    data[0] = OPCODE191_PARTITION;
+    utils_to2Bytes(&data[1], partition, TARGET_ENDIAN_TYPE);
+
+    request_send(&data[0], 3u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * range_request_send sends an OPCODE191_RANGE request.
+ *
+ * @param   start_address   First address.
+ * @param   length          Number of words.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void range_request_send(const uint32_t start_address, const uint32_t length)
+{
+    uint8_t     data[9];
+
+    data[0] = OPCODE191_RANGE;
+    utils_to4Bytes(&data[1], start_address, TARGET_ENDIAN_TYPE);
+    utils_to4Bytes(&data[5], length, TARGET_ENDIAN_TYPE);
+
+    request_send(&data[0], 9u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * poll_request_send sends an OPCODE191_POLL request.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void poll_request_send(void)
+{
+    uint8_t     data[1];
+
+    data[0] = OPCODE191_POLL;
+
+    request_send(&data[0], 1u);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * polls_until_done polls until the CRC is done, or enough polls have been
+ * sent.  Every reply until then must be LOADER_FORMAT_IN_PROGRESS.
+ *
+ * @retval  uint32_t    Polls sent.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t polls_until_done(void)
+{
+    uint32_t    polls = 0u;
+
+    do
+    {
+        poll_request_send();
+        polls++;
+
+        TEST_EXPECT(m_replies == 1u);
+        TEST_EXPECT( (m_reply_status == LOADER_OK)
+                        || (m_reply_status == LOADER_FORMAT_IN_PROGRESS) );
+    } while ( (m_reply_status == LOADER_FORMAT_IN_PROGRESS)
+                && (polls < TEST_MAXIMUM_POLLS) );
+
+    return polls;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * request_send clears the recorded replies and sends an opcode 191 request.
+ *
+ * @param   p_data      Message data.
+ * @param   length      Message length, in bytes.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void request_send(uint8_t* const p_data, const uint16_t length)
+{
+    LoaderMessage_t message;
+    Timer_t         timer;
+
+    message.opcode            = 191u;
+    message.dataPtr           = p_data;
+    message.dataLengthInBytes = length;
+
+    m_replies            = 0u;
+    m_reply_status       = TEST_NO_REPLY;
+    m_reply_crc          = 0u;
+    m_reply_expected_crc = 0u;
+
+    opcode191_execute(NULL, &message, &timer);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * timed_16bit_read reads a word through the model, taking TEST_READ_NS.
+ *
+ * @param   address     Address to read.
+ * @retval  uint16_t    Word read.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t timed_16bit_read(const uint32_t address)
+{
+    flash_sim_time_advance(TEST_READ_NS);
+
+    return m_model_16bit_read(address);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * loader_call_record records the status and any CRCs of each reply.
+ *
+ * @param   call        Loader function called.
+ * @param   status      Status of the reply.
+ * @param   length      Data length of the reply.
+ * @param   p_data      Pointer to the data of the reply.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void loader_call_record(const host_loader_call_t call,
+                               const uint8_t status,
+                               const uint16_t length,
+                               const uint8_t* const p_data)
+{
+    if (call == HOST_LOADER_SEND)
+    {
+        m_replies++;
+        m_reply_status = status;
+
+        if (length == 4u)
+        {
+            m_reply_crc          = (uint16_t)(p_data[0] | ((uint16_t)p_data[1] << 8));
+            m_reply_expected_crc = (uint16_t)(p_data[2] | ((uint16_t)p_data[3] << 8));
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,387 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_opcode204.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the opcode 204 Dpoint table, kept in RAM.
+ * @details
+ * The configuration record is written by the real opcode205.c, and read back
+ * by the real opcode204.c with the replies recorded through
+ * host_loader_hook_set().  Each read keeps the Dpoints in RAM, so after each
+ * way of erasing the configuration partition the next read must come from
+ * flash again:
+ *
+ *  - opcode 217 erasing the serial flash (block 2) - the Dpoints must then
+ *    read back blank;
+ *  - opcode 13 formatting the configuration partition - a record written
+ *    after the format must then be read, not the Dpoints from before it.
+ *    This record is written straight to flash, as opcode 205 does but without
+ *    its own invalidate, so that only the format can have thrown the old
+ *    table away.
+ *
+ * The partition is searched after each record is written, as the mount
+ * would do at startup, so that opcode 204 finds the record.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "timer.h"
+#include "comm.h"
+#include "opcode013.h"
+#include "opcode204.h"
+#include "opcode205.h"
+#include "opcode217.h"
+#include "rsapi.h"
+#include "rspartition.h"
+#include "rspages.h"
+#include "flash_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_CONFIG_INDEX       1u          ///< Configuration partition (ID 7).
+#define TEST_DPOINTS            103u        ///< Dpoints written by opcode 205.
+#define TEST_DPOINT_BYTES       4u          ///< Bytes per Dpoint.
+#define TEST_TABLE_BYTES        (TEST_DPOINTS * TEST_DPOINT_BYTES)
+#define TEST_RECORD_ADDRESS     0x00002010u ///< As CONFIG_RECORD_ADDRESS in opcode204.c.
+#define TEST_RECORD_BYTES       524u        ///< Configuration record size.
+#define TEST_RECORD_ID          28u         ///< Configuration record ID.
+#define TEST_DPOINT_OFFSET      105u        ///< First Dpoint in the record.
+#define TEST_SERIAL_FLASH_BLOCK 2u          ///< Opcode 217 block of the serial flash.
+#define TEST_MAXIMUM_STEPS      100000u     ///< More than any format takes.
+#define TEST_FIRST_SEED         0x10u       ///< Pattern written by opcode 205.
+#define TEST_SECOND_SEED        0x60u       ///< Pattern written after the format.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     config_format(void);
+
+static void     dpoints_opcode205_write(const uint8_t seed);
+
+static void     dpoints_flash_write(const uint8_t seed);
+
+static bool_t   dpoints_read_check(const bool_t b_blank, const uint8_t seed);
+
+static void     request_send(void (*p_execute)(ELoaderState_t*, LoaderMessage_t*, Timer_t*),
+                             const uint8_t opcode,
+                             uint8_t* const p_data,
+                             const uint16_t length);
+
+static uint8_t  dpoint_byte_get(const uint8_t seed, const uint32_t byte_index);
+
+static void     loader_call_record(const host_loader_call_t call,
+                                   const uint8_t status,
+                                   const uint16_t length,
+                                   const uint8_t* const p_data);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint32_t m_failures;
+static uint32_t m_replies;                      ///< Replies to the last request.
+static uint8_t  m_reply_status;                 ///< Status of the last reply.
+static uint16_t m_reply_length;                 ///< Data length of the last reply.
+static uint8_t  m_reply[TEST_TABLE_BYTES];      ///< Data of the last reply.
+static uint8_t  m_record[TEST_RECORD_BYTES];    ///< Record written straight to flash.
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_opcode204_check reads the Dpoints after each way of erasing them.
+ *
+ * @retval  bool_t      TRUE if every read was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_opcode204_check(void)
+{
+    uint8_t     block = TEST_SERIAL_FLASH_BLOCK;
+
+    m_failures = 0u;
+
+    host_loader_hook_set(loader_call_record);
+
+    flash_sim_install();
+    flash_sim_reset();
+
+    TEST_EXPECT(rsapi_recording_system_init());
+
+    /* Written by opcode 205, and kept in RAM by the first read. */
+    config_format();
+    dpoints_opcode205_write(TEST_FIRST_SEED);
+    TEST_EXPECT(dpoints_read_check(FALSE, TEST_FIRST_SEED));
+    TEST_EXPECT(dpoints_read_check(FALSE, TEST_FIRST_SEED));
+
+    /* Opcode 217 erases the serial flash from under the table. */
+    request_send(opcode217_execute, 217u, &block, 1u);
+    TEST_EXPECT(m_replies == 1u);
+    TEST_EXPECT(m_reply_status == LOADER_OK);
+    TEST_EXPECT(dpoints_read_check(TRUE, 0u));
+
+    /* Opcode 13 formats the partition from under the (blank) table. */
+    config_format();
+    dpoints_flash_write(TEST_SECOND_SEED);
+    TEST_EXPECT(dpoints_read_check(FALSE, TEST_SECOND_SEED));
+
+    host_loader_hook_set(NULL);
+    flash_sim_reset();
+
+    printf("failures %u", m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * config_format formats the configuration partition with opcode 13, finishes
+ * the format as the loader does while it waits for a message, and sends the
+ * message again for the result.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void config_format(void)
+{
+    uint8_t     partition_index = TEST_CONFIG_INDEX;
+    uint32_t    steps = 0u;
+
+    request_send(opcode13_execute, 13u, &partition_index, 1u);
+
+    while ( (opcode13_FormatStep()) && (steps < TEST_MAXIMUM_STEPS) )
+    {
+        steps++;
+    }
+
+    TEST_EXPECT(steps < TEST_MAXIMUM_STEPS);
+
+    /* Collect the result, as the host would. */
+    request_send(opcode13_execute, 13u, &partition_index, 1u);
+    TEST_EXPECT(m_reply_status == LOADER_OK);
+    TEST_EXPECT(rspartition_partition_ptr_get(TEST_CONFIG_INDEX)->partition_error_status
+                    == RS_ERR_NO_ERROR);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * dpoints_opcode205_write writes every Dpoint with opcode 205, the last one
+ * writing the configuration record.
+ *
+ * @param   seed    First byte of the pattern written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void dpoints_opcode205_write(const uint8_t seed)
+{
+    uint8_t     data[1u + TEST_DPOINT_BYTES];
+    uint32_t    dpoint;
+    uint32_t    byte;
+
+    for (dpoint = 0u; dpoint < TEST_DPOINTS; dpoint++)
+    {
+        data[0] = (uint8_t)dpoint;
+
+        for (byte = 0u; byte < TEST_DPOINT_BYTES; byte++)
+        {
+            data[1u + byte] = dpoint_byte_get(seed, (dpoint * TEST_DPOINT_BYTES) + byte);
+        }
+
+        request_send(opcode205_execute, 205u, &data[0], (uint16_t)sizeof(data));
+        TEST_EXPECT(m_reply_status == LOADER_OK);
+    }
+
+    TEST_EXPECT(rspartition_bisection_search_do(TEST_CONFIG_INDEX));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * dpoints_flash_write writes the configuration record straight to flash, the
+ * way opcode 205 does, but without telling opcode 204.
+ *
+ * @param   seed    First byte of the pattern written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void dpoints_flash_write(const uint8_t seed)
+{
+    const rs_partition_info_t*  p_partition;
+    rs_page_write_t             write_data;
+    uint32_t                    byte;
+
+    for (byte = 0u; byte < TEST_TABLE_BYTES; byte++)
+    {
+        m_record[TEST_DPOINT_OFFSET + byte] = dpoint_byte_get(seed, byte);
+    }
+
+    p_partition = rspartition_partition_ptr_get(TEST_CONFIG_INDEX);
+
+    write_data.partition_index              = TEST_CONFIG_INDEX;
+    write_data.partition_id                 = RS_PARTITION_CONFIGURATION;
+    write_data.partition_logical_start_addr = p_partition->start_address;
+    write_data.partition_logical_end_addr   = p_partition->end_address;
+    write_data.next_free_addr               = TEST_RECORD_ADDRESS;
+    write_data.record_id                    = TEST_RECORD_ID;
+    write_data.p_write_buffer               = &m_record[0];
+    write_data.bytes_to_write               = TEST_RECORD_BYTES;
+    write_data.b_read_back_write_command    = FALSE;
+
+    TEST_EXPECT(rspages_page_data_write(&write_data) != RS_PG_WRITE_ERROR);
+    TEST_EXPECT(rspartition_bisection_search_do(TEST_CONFIG_INDEX));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * dpoints_read_check reads every Dpoint written with opcode 204 and checks it.
+ *
+ * @param   b_blank     TRUE if the Dpoints should read back blank.
+ * @param   seed        First byte of the pattern, if not.
+ * @retval  bool_t      TRUE if every Dpoint was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t dpoints_read_check(const bool_t b_blank, const uint8_t seed)
+{
+    uint8_t     data[2];
+    uint32_t    byte;
+    uint8_t     expected;
+    bool_t      b_matches;
+
+    data[0] = 0u;
+    data[1] = (uint8_t)(TEST_DPOINTS - 1u);
+
+    request_send(opcode204_execute, 204u, &data[0], 2u);
+
+    b_matches = ( (m_replies == 1u)
+                    && (m_reply_status == LOADER_OK)
+                    && (m_reply_length == TEST_TABLE_BYTES) );
+
+    for (byte = 0u; (b_matches) && (byte < TEST_TABLE_BYTES); byte++)
+    {
+        expected = (b_blank) ? 0xFFu : dpoint_byte_get(seed, byte);
+
+        if (m_reply[byte] != expected)
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * request_send clears the recorded replies and sends a request.
+ *
+ * @param   p_execute   Opcode function to call.
+ * @param   opcode      Opcode of the request.
+ * @param   p_data      Pointer to the data of the request.
+ * @param   length      Data length of the request.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void request_send(void (*p_execute)(ELoaderState_t*, LoaderMessage_t*, Timer_t*),
+                         const uint8_t opcode,
+                         uint8_t* const p_data,
+                         const uint16_t length)
+{
+    LoaderMessage_t message;
+    Timer_t         timer;
+
+    message.opcode            = opcode;
+    message.dataPtr           = p_data;
+    message.dataLengthInBytes = length;
+
+    m_replies      = 0u;
+    m_reply_status = LOADER_OK;
+    m_reply_length = 0u;
+
+    p_execute(NULL, &message, &timer);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * dpoint_byte_get returns a byte of the Dpoint pattern.
+ *
+ * @param   seed        First byte of the pattern.
+ * @param   byte_index  Byte of the Dpoint table.
+ * @retval  uint8_t     Byte of the pattern.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint8_t dpoint_byte_get(const uint8_t seed, const uint32_t byte_index)
+{
+    return (uint8_t)((seed + (byte_index * 7u)) & 0xFFu);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * loader_call_record records the status and data of each reply.
+ *
+ * @param   call        Loader function called.
+ * @param   status      Status of the reply.
+ * @param   length      Data length of the reply.
+ * @param   p_data      Pointer to the data of the reply.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void loader_call_record(const host_loader_call_t call,
+                               const uint8_t status,
+                               const uint16_t length,
+                               const uint8_t* const p_data)
+{
+    uint16_t    byte;
+
+    if (call == HOST_LOADER_SEND)
+    {
+        m_replies++;
+        m_reply_status = status;
+        m_reply_length = length;
+
+        for (byte = 0u; (byte < length) && (byte < TEST_TABLE_BYTES); byte++)
+        {
+            m_reply[byte] = p_data[byte];
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,409 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_opcode219.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the opcode 219 bulk read.
+ * @details
+ * The MWD partition is filled with a known pattern, then opcode 219 requests
+ * are sent to the real opcode219.c with the loader replies recorded through
+ * host_loader_hook_set().
+ *
+ *  - A bulk read of full size packets must have each packet cut to fit in
+ *    COMM_MAX_LENGTH with its sequence number, and every reply must hold
+ *    the next sequence number and the data which follows straight on from
+ *    the last packet.
+ *  - A bulk read of smaller packets must do the same, without cutting them.
+ *  - A bulk read which ends exactly at the end of the partition must be sent,
+ *    and one which goes a packet past it must be rejected with a single
+ *    error reply and no stream.
+ *  - A single (5 byte) request for a full packet must still be sent in one
+ *    reply of 512 bytes.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "timer.h"
+#include "comm.h"
+#include "opcode219.h"
+#include "rsapi.h"
+#include "rspartition.h"
+#include "flash_hal.h"
+#include "flash_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_PARTITION          2u          ///< MWD, main flash.
+#define TEST_SEGMENT_BYTES      512u        ///< As SEGMENT_SIZE_IN_WORDS in opcode219.c.
+#define TEST_SEQUENCE_SIZE      2u          ///< Sequence number at the start of each reply.
+#define TEST_FILL_CHUNK         256u        ///< Bytes of pattern written at a time.
+#define TEST_MAX_REPLIES        64u         ///< Replies recorded for one request.
+#define TEST_FIRST_SEGMENT      3u          ///< Segment the bulk reads start from.
+#define TEST_BULK_PACKETS       40u         ///< Packets in the bulk reads.
+#define TEST_SMALL_WORDS        100u        ///< Packet size of the smaller bulk read.
+#define TEST_END_WORDS          128u        ///< Packet size of the reads at the end.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Types section:
+
+/**
+ * One reply, as the loader was asked to send it.
+ */
+typedef struct
+{
+    bool_t      b_streamed;         ///< Sent by loader_MessageStreamSend.
+    uint8_t     status;
+    uint16_t    length;             ///< Data length, including any sequence number.
+    uint32_t    mismatches;         ///< Data bytes which weren't as in the partition.
+    uint16_t    sequence;           ///< Sequence number, if streamed.
+} test_reply_t;
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   pattern_fill(const uint32_t start_offset, const uint32_t length);
+
+static uint8_t  pattern_byte(const uint32_t offset);
+
+static void     request_send(const uint32_t segment,
+                             const uint8_t words,
+                             const bool_t b_bulk,
+                             const uint16_t packets);
+
+static void     bulk_replies_check(const uint32_t segment,
+                                   const uint16_t packets,
+                                   const uint16_t packet_bytes);
+
+static void     loader_call_record(const host_loader_call_t call,
+                                   const uint8_t status,
+                                   const uint16_t length,
+                                   const uint8_t* const p_data);
+
+
+// ----------------------------------------------------------------------------
+// Variables with global scope:
+
+/// In opcode046.c - the partition opcode 219 reads from.
+extern uint8_t selectPartitionIndex;
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint32_t     m_failures;
+static uint32_t     m_data_offset;      ///< Partition offset of the next data expected.
+static uint32_t     m_stream_starts;
+static uint32_t     m_stream_ends;
+static uint32_t     m_reply_count;
+static test_reply_t m_replies[TEST_MAX_REPLIES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_opcode219_check fills the partition and makes each request.
+ *
+ * @retval  bool_t      TRUE if every reply was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_opcode219_check(void)
+{
+    const rs_partition_info_t*  p_partition;
+    uint32_t                    partition_bytes;
+    uint32_t                    last_segment;
+    uint32_t                    longest_reply = 0u;
+    uint32_t                    i;
+
+    m_failures = 0u;
+    selectPartitionIndex = TEST_PARTITION;
+
+    host_loader_hook_set(loader_call_record);
+
+    flash_sim_install();
+    flash_sim_reset();
+
+    TEST_EXPECT(rsapi_recording_system_init());
+
+    p_partition     = rspartition_partition_ptr_get(TEST_PARTITION);
+    partition_bytes = (p_partition->end_address - p_partition->start_address) + 1u;
+    last_segment    = (partition_bytes / TEST_SEGMENT_BYTES) - 1u;
+
+    TEST_EXPECT(pattern_fill(TEST_FIRST_SEGMENT * TEST_SEGMENT_BYTES,
+                             TEST_BULK_PACKETS * TEST_SEGMENT_BYTES));
+    TEST_EXPECT(pattern_fill(last_segment * TEST_SEGMENT_BYTES, TEST_SEGMENT_BYTES));
+
+    /* Full size packets (0 means 256 words) are cut to fit the sequence number. */
+    request_send(TEST_FIRST_SEGMENT, 0u, TRUE, TEST_BULK_PACKETS);
+    bulk_replies_check(TEST_FIRST_SEGMENT, TEST_BULK_PACKETS,
+                       COMM_MAX_LENGTH - TEST_SEQUENCE_SIZE);
+
+    for (i = 0u; i < m_reply_count; i++)
+    {
+        TEST_EXPECT(m_replies[i].length <= COMM_MAX_LENGTH);
+
+        if (m_replies[i].length > longest_reply)
+        {
+            longest_reply = m_replies[i].length;
+        }
+    }
+
+    /* Smaller packets are sent as they are. */
+    request_send(TEST_FIRST_SEGMENT, TEST_SMALL_WORDS, TRUE, TEST_BULK_PACKETS);
+    bulk_replies_check(TEST_FIRST_SEGMENT, TEST_BULK_PACKETS, TEST_SMALL_WORDS * 2u);
+
+    /* Up to the last byte of the partition, and a packet past it. */
+    request_send(last_segment, TEST_END_WORDS, TRUE, 2u);
+    bulk_replies_check(last_segment, 2u, TEST_END_WORDS * 2u);
+
+    request_send(last_segment, TEST_END_WORDS, TRUE, 3u);
+    TEST_EXPECT(m_stream_starts == 0u);
+    TEST_EXPECT(m_reply_count == 1u);
+    TEST_EXPECT(!m_replies[0].b_streamed);
+    TEST_EXPECT(m_replies[0].status == LOADER_PARAMETER_OUT_OF_RANGE);
+    TEST_EXPECT(m_replies[0].length == 0u);
+
+    /* A single request still sends the whole of a full size packet. */
+    request_send(TEST_FIRST_SEGMENT, 0u, FALSE, 0u);
+    TEST_EXPECT(m_reply_count == 1u);
+    TEST_EXPECT(!m_replies[0].b_streamed);
+    TEST_EXPECT(m_replies[0].status == LOADER_OK);
+    TEST_EXPECT(m_replies[0].length == TEST_SEGMENT_BYTES);
+    TEST_EXPECT(m_replies[0].mismatches == 0u);
+
+    host_loader_hook_set(NULL);
+    flash_sim_reset();
+
+    printf("longest bulk reply %u bytes, failures %u", longest_reply, m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * pattern_fill writes the pattern into part of the partition.
+ *
+ * @param   start_offset    Offset into the partition to start at.
+ * @param   length          Bytes to write, a whole number of TEST_FILL_CHUNK.
+ * @retval  bool_t          TRUE if every write worked.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t pattern_fill(const uint32_t start_offset, const uint32_t length)
+{
+    const rs_partition_info_t*  p_partition;
+    uint8_t                     chunk[TEST_FILL_CHUNK];
+    uint32_t                    offset;
+    uint32_t                    i;
+    bool_t                      b_filled = TRUE;
+
+    p_partition = rspartition_partition_ptr_get(TEST_PARTITION);
+
+    for (offset = start_offset; offset < (start_offset + length); offset += TEST_FILL_CHUNK)
+    {
+        for (i = 0u; i < TEST_FILL_CHUNK; i++)
+        {
+            chunk[i] = pattern_byte(offset + i);
+        }
+
+        if (flash_hal_device_write(p_partition->start_address + offset,
+                                   TEST_FILL_CHUNK, &chunk[0]) != FLASH_HAL_NO_ERROR)
+        {
+            b_filled = FALSE;
+        }
+    }
+
+    return b_filled;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * pattern_byte works out the pattern at an offset into the partition.  It
+ * repeats every 251 bytes, so no packet or segment looks like another.
+ *
+ * @param   offset      Offset into the partition.
+ * @retval  uint8_t     Pattern byte.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint8_t pattern_byte(const uint32_t offset)
+{
+    return (uint8_t)((offset % 251u) ^ 0x5Au);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * request_send clears the recorded replies and makes an opcode 219 request.
+ *
+ * @param   segment     Segment to read from.
+ * @param   words       Packet size in words (0 for 256).
+ * @param   b_bulk      TRUE for a bulk request.
+ * @param   packets     Packets in a bulk request.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void request_send(const uint32_t segment,
+                         const uint8_t words,
+                         const bool_t b_bulk,
+                         const uint16_t packets)
+{
+    LoaderMessage_t message;
+    Timer_t         timer;
+    uint8_t         data[7];
+
+    data[0] = (uint8_t)(segment & 0xFFu);
+    data[1] = (uint8_t)((segment >> 8) & 0xFFu);
+    data[2] = (uint8_t)((segment >> 16) & 0xFFu);
+    data[3] = (uint8_t)((segment >> 24) & 0xFFu);
+    data[4] = words;
+    data[5] = (uint8_t)(packets & 0xFFu);
+    data[6] = (uint8_t)(packets >> 8);
+
+    message.opcode            = 219u;
+    message.dataPtr           = &data[0];
+    message.dataLengthInBytes = b_bulk ? 7u : 5u;
+
+    m_stream_starts = 0u;
+    m_stream_ends   = 0u;
+    m_reply_count   = 0u;
+    m_data_offset   = segment * TEST_SEGMENT_BYTES;
+
+    opcode219_execute(NULL, &message, &timer);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * bulk_replies_check checks the replies to a bulk request which should have
+ * been sent - one stream, with one reply for each packet in sequence, and
+ * the data following on from one packet to the next.
+ *
+ * @param   segment         Segment the request started from.
+ * @param   packets         Packets requested.
+ * @param   packet_bytes    Data bytes expected in each packet.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void bulk_replies_check(const uint32_t segment,
+                               const uint16_t packets,
+                               const uint16_t packet_bytes)
+{
+    uint32_t    i;
+
+    TEST_EXPECT(m_stream_starts == 1u);
+    TEST_EXPECT(m_stream_ends == 1u);
+    TEST_EXPECT(m_reply_count == packets);
+    TEST_EXPECT(m_data_offset == ((segment * TEST_SEGMENT_BYTES)
+                                    + ((uint32_t)packets * packet_bytes)));
+
+    for (i = 0u; i < m_reply_count; i++)
+    {
+        TEST_EXPECT(m_replies[i].b_streamed);
+        TEST_EXPECT(m_replies[i].status == LOADER_OK);
+        TEST_EXPECT(m_replies[i].sequence == i);
+        TEST_EXPECT(m_replies[i].length == (TEST_SEQUENCE_SIZE + packet_bytes));
+        TEST_EXPECT(m_replies[i].mismatches == 0u);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * loader_call_record records a loader call, checking the data of a reply
+ * against the pattern from where the last reply finished.
+ *
+ * @param   call        Loader function called.
+ * @param   status      Status of the reply.
+ * @param   length      Data length of the reply.
+ * @param   p_data      Pointer to the data of the reply.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void loader_call_record(const host_loader_call_t call,
+                               const uint8_t status,
+                               const uint16_t length,
+                               const uint8_t* const p_data)
+{
+    test_reply_t*   p_reply;
+    uint16_t        data_start = 0u;
+    uint16_t        i;
+
+    if (call == HOST_LOADER_STREAM_START)
+    {
+        m_stream_starts++;
+    }
+    else if (call == HOST_LOADER_STREAM_END)
+    {
+        m_stream_ends++;
+    }
+    else
+    {
+        if (m_reply_count < TEST_MAX_REPLIES)
+        {
+            p_reply = &m_replies[m_reply_count];
+
+            p_reply->b_streamed = (call == HOST_LOADER_STREAM_SEND);
+            p_reply->status     = status;
+            p_reply->length     = length;
+            p_reply->mismatches = 0u;
+            p_reply->sequence   = 0u;
+
+            if ( (p_reply->b_streamed) && (length >= TEST_SEQUENCE_SIZE) )
+            {
+                p_reply->sequence = (uint16_t)p_data[0] | ((uint16_t)p_data[1] << 8);
+                data_start = TEST_SEQUENCE_SIZE;
+            }
+
+            for (i = data_start; i < length; i++)
+            {
+                if (p_data[i] != pattern_byte(m_data_offset))
+                {
+                    p_reply->mismatches++;
+                }
+
+                m_data_offset++;
+            }
+        }
+
+        m_reply_count++;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,464 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_page_batch.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the batched record writes,
+ *              rspages_page_data_write_batch().
+ * @details
+ * Batches are written into MWD, each one ending a staged run in a different
+ * way:
+ *  - more RSRs than fit in the staging buffer, so that it is written out
+ *    when full and the part-filled remainder is written at the end of the
+ *    batch - with fewer flash programs than the same records written one
+ *    at a time;
+ *  - an RSR in the middle of the batch which fills the page exactly, so the
+ *    run is written, the next page header goes down and the rest of the
+ *    batch carries on after it;
+ *  - an RSR in the middle of the batch which spans the page boundary, so it
+ *    is written on its own around the next page header.
+ *
+ * Every RSR must be written where it was expected, read back as written,
+ * and be found again (with the same next free address) after a restart.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rspages.h"
+#include "rspartition.h"
+#include "flash_hal.h"
+#include "flash_sim.h"
+#include "S29GLxxxS.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_PARTITION          2u          ///< MWD, in the main flash.
+#define TEST_MAX_WRITES         16u         ///< Records in a batch (RS_CFG_BATCH_MAX_RECORDS).
+#define TEST_RSR_OVERHEAD       (RSAPI_BYTES_BEFORE_TDR + RSAPI_BYTES_AFTER_TDR)
+#define TEST_PAGE_BYTES         (RS_CFG_PAGE_SIZE_KB * 1024u)
+#define TEST_SMALL_RSR          128u        ///< Eight fill the staging buffer.
+#define TEST_STAGED_RECORDS     13u         ///< A full staging buffer and 5 more.
+#define TEST_LARGE_RSR          512u        ///< Records before the one which fills the page.
+#define TEST_SPAN_RSR           1000u       ///< One of these spans the page.
+#define TEST_SPAN_RECORDS       10u
+#define TEST_WRITE_BUFFER_BYTES (LLD_BUFFER_SIZE * 2u)  ///< Main flash write buffer line.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static uint32_t batch_write(const uint16_t * const p_rsr_bytes,
+                            const uint16_t number_of_writes);
+
+static bool_t   batch_check(const uint16_t number_of_writes,
+                            const uint16_t page_full_index);
+
+static bool_t   rsr_read_check(const uint16_t write_index);
+
+static uint32_t address_advance(const uint32_t address, const uint32_t bytes);
+
+static uint32_t page_space_get(const uint32_t address);
+
+static uint32_t write_programs_get(const uint32_t address, const uint32_t bytes);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint32_t                 m_failures;
+static uint16_t                 m_record_number;
+
+static rs_page_write_t          m_writes[TEST_MAX_WRITES];
+static rs_page_write_status_t   m_status[TEST_MAX_WRITES];
+static uint32_t                 m_start_address;   ///< Next free address before the batch.
+
+static uint8_t  m_buffers[TEST_MAX_WRITES][RS_CFG_MAX_TDR_SIZE_BYTES + TEST_RSR_OVERHEAD];
+static uint8_t  m_read[RS_CFG_MAX_TDR_SIZE_BYTES + TEST_RSR_OVERHEAD];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_page_batch_check writes each batch, and checks the records after it
+ * and after a restart.
+ *
+ * @retval  bool_t      TRUE if every batch was written as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_page_batch_check(void)
+{
+    const rs_partition_info_t*  p_partition;
+    uint16_t                    rsr_bytes[TEST_MAX_WRITES];
+    uint32_t                    batch_programs;
+    uint32_t                    single_programs = 0u;
+    uint32_t                    next_free_address;
+    uint32_t                    space;
+    uint16_t                    i;
+    uint16_t                    page_full_index;
+    uint8_t                     dummy_progress;
+
+    m_failures = 0u;
+    m_record_number = 0u;
+
+    flash_sim_install();
+    flash_sim_reset();
+
+    TEST_EXPECT(rsapi_recording_system_init());
+    TEST_EXPECT(rspartition_format_partition(TEST_PARTITION, &dummy_progress)
+                    == RS_ERR_NO_ERROR);
+
+    p_partition = rspartition_partition_ptr_get(TEST_PARTITION);
+
+    /* A full staging buffer is written, then the rest at the end. */
+    for (i = 0u; i < TEST_STAGED_RECORDS; i++)
+    {
+        rsr_bytes[i] = TEST_SMALL_RSR;
+    }
+
+    batch_programs = batch_write(&rsr_bytes[0], TEST_STAGED_RECORDS);
+    TEST_EXPECT(batch_check(TEST_STAGED_RECORDS, TEST_MAX_WRITES));
+    TEST_EXPECT(batch_programs
+                    == (write_programs_get(m_start_address, RS_CFG_BATCH_STAGING_SIZE_BYTES)
+                        + write_programs_get(m_start_address + RS_CFG_BATCH_STAGING_SIZE_BYTES,
+                                             (TEST_STAGED_RECORDS * TEST_SMALL_RSR)
+                                                 - RS_CFG_BATCH_STAGING_SIZE_BYTES)));
+
+    /* The same records, one at a time. */
+    for (i = 0u; i < TEST_STAGED_RECORDS; i++)
+    {
+        single_programs += batch_write(&rsr_bytes[i], 1u);
+        TEST_EXPECT(batch_check(1u, TEST_MAX_WRITES));
+    }
+
+    TEST_EXPECT(batch_programs < single_programs);
+
+    /* Large records, then one which fills the page exactly (staged, as it
+     * fits in the staging buffer), then small ones in the next page. */
+    space = page_space_get(p_partition->next_available_address);
+    i = 0u;
+
+    while ( (space > RS_CFG_BATCH_STAGING_SIZE_BYTES) && (i < (TEST_MAX_WRITES - 2u)) )
+    {
+        rsr_bytes[i] = TEST_LARGE_RSR;
+        space -= TEST_LARGE_RSR;
+        i++;
+    }
+
+    page_full_index = i;
+    rsr_bytes[i] = (uint16_t)space;
+    i++;
+
+    TEST_EXPECT(space <= RS_CFG_BATCH_STAGING_SIZE_BYTES);
+
+    while (i < TEST_MAX_WRITES)
+    {
+        rsr_bytes[i] = TEST_SMALL_RSR;
+        i++;
+    }
+
+    (void)batch_write(&rsr_bytes[0], TEST_MAX_WRITES);
+    TEST_EXPECT(batch_check(TEST_MAX_WRITES, page_full_index));
+    TEST_EXPECT(page_space_get(m_writes[page_full_index + 1u].next_free_addr)
+                    == (TEST_PAGE_BYTES - PAGE_HEADER_LENGTH_BYTES));
+
+    /* Records which can't share the staging buffer, one spanning the page. */
+    for (i = 0u; i < TEST_SPAN_RECORDS; i++)
+    {
+        rsr_bytes[i] = TEST_SPAN_RSR;
+    }
+
+    (void)batch_write(&rsr_bytes[0], TEST_SPAN_RECORDS);
+
+    /* The one which spans fills the page it starts in. */
+    page_full_index = TEST_MAX_WRITES;
+
+    for (i = 0u; i < TEST_SPAN_RECORDS; i++)
+    {
+        if (page_space_get(m_writes[i].next_free_addr) < TEST_SPAN_RSR)
+        {
+            page_full_index = i;
+        }
+    }
+
+    TEST_EXPECT(page_full_index < (TEST_SPAN_RECORDS - 1u));
+    TEST_EXPECT(batch_check(TEST_SPAN_RECORDS, page_full_index));
+
+    /* Start again, as after a power cycle - the records must all be found. */
+    next_free_address = p_partition->next_available_address;
+
+    TEST_EXPECT(rsapi_recording_system_init());
+    TEST_EXPECT(p_partition->next_available_address == next_free_address);
+
+    for (i = 0u; i < TEST_SPAN_RECORDS; i++)
+    {
+        TEST_EXPECT(rsr_read_check(i));
+    }
+
+    flash_sim_reset();
+
+    printf("%u programs batched, %u one at a time, failures %u",
+           batch_programs, single_programs, m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * batch_write writes a batch of records at the next free address, set up as
+ * rsapi_write_batch_request() does.  Each TDR starts with its record number.
+ *
+ * @param   p_rsr_bytes         RSR length of each record.
+ * @param   number_of_writes    Records in the batch.
+ * @retval  uint32_t            Main flash programs made by the batch.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t batch_write(const uint16_t * const p_rsr_bytes,
+                            const uint16_t number_of_writes)
+{
+    const rs_partition_info_t*  p_partition;
+    flash_sim_stats_t           stats;
+    uint32_t                    programs;
+    uint16_t                    i;
+    uint16_t                    byte_index;
+
+    p_partition = rspartition_partition_ptr_get(TEST_PARTITION);
+    m_start_address = p_partition->next_available_address;
+
+    for (i = 0u; i < number_of_writes; i++)
+    {
+        m_record_number++;
+
+        for (byte_index = RSAPI_BYTES_BEFORE_TDR;
+             byte_index < (p_rsr_bytes[i] - RSAPI_BYTES_AFTER_TDR);
+             byte_index++)
+        {
+            m_buffers[i][byte_index] = (uint8_t)((m_record_number * 7u) + byte_index);
+        }
+
+        m_writes[i].partition_index              = TEST_PARTITION;
+        m_writes[i].partition_id                 = p_partition->id;
+        m_writes[i].partition_logical_start_addr = p_partition->start_address;
+        m_writes[i].partition_logical_end_addr   = p_partition->end_address;
+        m_writes[i].next_free_addr               = m_start_address;
+        m_writes[i].record_id                    = m_record_number;
+        m_writes[i].p_write_buffer               = &m_buffers[i][0];
+        m_writes[i].bytes_to_write               = p_rsr_bytes[i];
+        m_writes[i].b_read_back_write_command    = FALSE;
+        m_status[i]                              = RS_PG_WRITE_ERROR;
+    }
+
+    flash_sim_stats_get(&stats);
+    programs = stats.main_flash_program_operations;
+
+    if (rspages_page_data_write_batch(&m_writes[0], number_of_writes, &m_status[0])
+            != number_of_writes)
+    {
+        m_failures++;
+    }
+
+    flash_sim_stats_get(&stats);
+
+    return (stats.main_flash_program_operations - programs);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * batch_check checks that each record of the last batch went straight after
+ * the one before it (after the page header, if it went into the next page),
+ * reads back as written, and that the partition's next free address is
+ * after the last one.
+ *
+ * @param   number_of_writes    Records in the batch.
+ * @param   page_full_index     Record which must fill the page, or
+ *                              TEST_MAX_WRITES for none.
+ * @retval  bool_t              TRUE if every record was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t batch_check(const uint16_t number_of_writes,
+                          const uint16_t page_full_index)
+{
+    uint32_t    address = m_start_address;
+    uint16_t    i;
+    bool_t      b_ok = TRUE;
+
+    for (i = 0u; i < number_of_writes; i++)
+    {
+        if ( (m_writes[i].next_free_addr != address)
+                || (!rsr_read_check(i)) )
+        {
+            b_ok = FALSE;
+        }
+
+        if (i == page_full_index)
+        {
+            b_ok = b_ok && (m_status[i] == RS_PG_WRITE_OK_PAGE_FULL);
+        }
+        else
+        {
+            b_ok = b_ok && (m_status[i] == RS_PG_WRITE_OK);
+        }
+
+        address = address_advance(address, m_writes[i].bytes_to_write);
+    }
+
+    return ( (b_ok)
+                && (rspartition_partition_ptr_get(TEST_PARTITION)->next_available_address
+                        == address) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * rsr_read_check reads a record of the last batch back from the flash,
+ * stepping over a page header if it spans the page.
+ *
+ * @param   write_index     Record in the batch.
+ * @retval  bool_t          TRUE if the RSR matches its write buffer.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t rsr_read_check(const uint16_t write_index)
+{
+    const rs_page_write_t*  p_write = &m_writes[write_index];
+    uint32_t                address = p_write->next_free_addr;
+    uint32_t                space;
+    uint16_t                byte_index;
+    bool_t                  b_matches;
+
+    space = page_space_get(address);
+
+    if (space >= p_write->bytes_to_write)
+    {
+        b_matches = (flash_hal_device_read(address, p_write->bytes_to_write, &m_read[0])
+                        == FLASH_HAL_NO_ERROR);
+    }
+    else
+    {
+        b_matches = ( (flash_hal_device_read(address, space, &m_read[0])
+                            == FLASH_HAL_NO_ERROR)
+                        && (flash_hal_device_read(address + space + PAGE_HEADER_LENGTH_BYTES,
+                                                  p_write->bytes_to_write - space,
+                                                  &m_read[space])
+                                == FLASH_HAL_NO_ERROR) );
+    }
+
+    /* The wrapper was built in the write buffer, or a copy of it. */
+    for (byte_index = RSAPI_BYTES_BEFORE_TDR;
+         byte_index < (p_write->bytes_to_write - RSAPI_BYTES_AFTER_TDR);
+         byte_index++)
+    {
+        if (m_read[byte_index] != p_write->p_write_buffer[byte_index])
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return ( (b_matches)
+                && (m_read[0] == RSR_SYNC_CHARACTER)
+                && (m_read[1] == (uint8_t)(p_write->record_id & 0xFFu))
+                && (m_read[2] == (uint8_t)(p_write->record_id >> 8))
+                && (m_read[p_write->bytes_to_write - 1u] == RSR_ENDSYNC_CHARACTER) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * address_advance returns the address after an RSR, stepping over the next
+ * page header if the RSR spans or fills the page.
+ *
+ * @param   address     Address of the RSR.
+ * @param   bytes       RSR length.
+ * @retval  uint32_t    Next free address after it.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t address_advance(const uint32_t address, const uint32_t bytes)
+{
+    uint32_t    next_address = address + bytes;
+
+    if (bytes >= page_space_get(address))
+    {
+        next_address += PAGE_HEADER_LENGTH_BYTES;
+    }
+
+    return next_address;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * page_space_get returns the bytes from an address to the end of its page.
+ *
+ * @param   address     Logical address within TEST_PARTITION.
+ * @retval  uint32_t    Bytes to the end of the page.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t page_space_get(const uint32_t address)
+{
+    uint32_t    start_address;
+
+    start_address = rspartition_partition_ptr_get(TEST_PARTITION)->start_address;
+
+    return (TEST_PAGE_BYTES - ((address - start_address) % TEST_PAGE_BYTES));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * write_programs_get returns the main flash programs needed to write bytes
+ * from an address in one go - one for each write buffer line it touches.
+ * The partition starts on a line, so logical addresses line up with them.
+ *
+ * @param   address     Logical address within TEST_PARTITION.
+ * @param   bytes       Bytes written.
+ * @retval  uint32_t    Program operations.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t write_programs_get(const uint32_t address, const uint32_t bytes)
+{
+    return ( (((address + bytes) - 1u) / TEST_WRITE_BUFFER_BYTES)
+                - (address / TEST_WRITE_BUFFER_BYTES) ) + 1u;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,327 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_prom_hardware.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the double buffered incremental flash writes.
+ * @details
+ * Opcode 37 style blocks are written with PromHardware_ProgramMemoryWrite()
+ * into the application partition modelled by host_program_memory_install(),
+ * with PromHardware_PendingProgramComplete() called in between as the
+ * loader does when it starts to wait for a message.
+ *
+ *  - Each block must be left pending, not programmed, when the write
+ *    returns, and programmed by the next wait.
+ *  - Blocks written with no wait in between must go into alternate halves
+ *    of the buffer, each programmed when the next one is staged, without
+ *    overwriting it.
+ *  - The last block must be programmed before it is read back, with
+ *    nothing else waiting.
+ *  - A block which fails to program in the wait, after it has been
+ *    acknowledged, must fail the next write (and every one after it), until
+ *    the partition is prepared again.  One which fails while the next block
+ *    is staged must fail that write.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "tool_specific_config.h"
+#include "tool_specific_programming.h"
+#include "prom_hardware.h"
+#include "genericIO.h"
+#include "utils.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_BLOCK_WORDS        126u        ///< Words in a block, as opcode 37.
+#define TEST_BLOCK_BYTES        (TEST_BLOCK_WORDS * 2u)
+#define TEST_BLOCKS             8u          ///< Blocks written without a fault.
+#define TEST_HALF_WORDS         (BUFFER_LENGTH / 2u)
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   block_write(const uint16_t block);
+
+static bool_t   block_programmed_check(const uint16_t block);
+
+static bool_t   block_staged_check(const uint16_t block, const uint32_t buffer_offset);
+
+static bool_t   block_read_back_check(const uint16_t block);
+
+static uint32_t block_address_get(const uint16_t block);
+
+static uint16_t block_word_get(const uint16_t block, const uint32_t word);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint32_t m_failures;
+static uint8_t  m_block[TEST_BLOCK_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_prom_hardware_check writes the blocks with and without waits, and
+ * with a fault in each place.
+ *
+ * @retval  bool_t      TRUE if every write was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_prom_hardware_check(void)
+{
+    uint16_t    block;
+    uint32_t    programs;
+
+    m_failures = 0u;
+
+    host_program_memory_install();
+    PromHardware_AllowIncrementalFlashWriteFlagSet(TRUE);
+
+    TEST_EXPECT(PromHardware_PartitionPrepare(APPLICATION_PARTITION) == 0u);
+
+    /* Acknowledged straight away, programmed in the wait. */
+    TEST_EXPECT(block_write(0u));
+    TEST_EXPECT(host_program_memory_programs_get() == 0u);
+    TEST_EXPECT(!block_programmed_check(0u));
+    TEST_EXPECT(PromHardware_PendingProgramComplete());
+    TEST_EXPECT(host_program_memory_programs_get() == 1u);
+    TEST_EXPECT(block_programmed_check(0u));
+
+    /* Nothing pending, so waiting again programs nothing. */
+    TEST_EXPECT(PromHardware_PendingProgramComplete());
+    TEST_EXPECT(host_program_memory_programs_get() == 1u);
+
+    /* No waits - each block goes into the other half, and the one before
+     * it is programmed once it has been staged. */
+    for (block = 1u; block < TEST_BLOCKS; block++)
+    {
+        TEST_EXPECT(block_write(block));
+        TEST_EXPECT(block_staged_check(block, (block & 1u) * TEST_HALF_WORDS));
+        TEST_EXPECT(block_programmed_check(block - 1u));
+        TEST_EXPECT(!block_programmed_check(block));
+    }
+
+    TEST_EXPECT(host_program_memory_programs_get() == (TEST_BLOCKS - 1u));
+
+    /* The last block is read back with nothing else to push it out. */
+    TEST_EXPECT(block_read_back_check(TEST_BLOCKS - 1u));
+    TEST_EXPECT(block_programmed_check(TEST_BLOCKS - 1u));
+
+    programs = host_program_memory_programs_get();
+    TEST_EXPECT(programs == TEST_BLOCKS);
+
+    /* A block fails in the wait, after being acknowledged - the next write
+     * reports it, and so does every one after, until prepared again. */
+    TEST_EXPECT(PromHardware_PartitionPrepare(APPLICATION_PARTITION) == 0u);
+    TEST_EXPECT(block_write(0u));
+    TEST_EXPECT(PromHardware_PendingProgramComplete());
+    TEST_EXPECT(block_write(1u));
+    host_program_memory_fail_set(host_program_memory_programs_get() + 1u);
+    TEST_EXPECT(!PromHardware_PendingProgramComplete());
+    TEST_EXPECT(!block_write(2u));
+    TEST_EXPECT(!block_write(3u));
+    TEST_EXPECT(!PromHardware_PendingProgramComplete());
+    TEST_EXPECT(!block_programmed_check(2u));
+
+    TEST_EXPECT(PromHardware_PartitionPrepare(APPLICATION_PARTITION) == 0u);
+    TEST_EXPECT(block_write(0u));
+    TEST_EXPECT(PromHardware_PendingProgramComplete());
+    TEST_EXPECT(block_programmed_check(0u));
+
+    /* A block fails while the next one is staged - that write fails. */
+    TEST_EXPECT(block_write(1u));
+    host_program_memory_fail_set(host_program_memory_programs_get() + 1u);
+    TEST_EXPECT(!block_write(2u));
+    TEST_EXPECT(!block_write(3u));
+
+    host_program_memory_remove();
+
+    printf("%u blocks, %u programs, failures %u", TEST_BLOCKS, programs, m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * block_write writes a block of the image, as opcode 37 does.
+ *
+ * @param   block       Block to write.
+ * @retval  bool_t      What PromHardware_ProgramMemoryWrite returned.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t block_write(const uint16_t block)
+{
+    uint32_t    word;
+    uint16_t    data;
+
+    /* Sent most significant byte first (DOWNLOAD_ENDIANESS). */
+    for (word = 0u; word < TEST_BLOCK_WORDS; word++)
+    {
+        data = block_word_get(block, word);
+
+        m_block[word * 2u]      = (uint8_t)(data >> 8);
+        m_block[(word * 2u) + 1u] = (uint8_t)(data & 0xFFu);
+    }
+
+    return PromHardware_ProgramMemoryWrite(&m_block[0], TEST_BLOCK_BYTES, block_address_get(block));
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * block_programmed_check checks that a block is in the flash.
+ *
+ * @param   block       Block to check.
+ * @retval  bool_t      TRUE if every word of it is.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t block_programmed_check(const uint16_t block)
+{
+    uint32_t    word;
+    bool_t      b_programmed = TRUE;
+
+    for (word = 0u; word < TEST_BLOCK_WORDS; word++)
+    {
+        if (host_program_memory_flash_get(block_address_get(block) + word)
+                != block_word_get(block, word))
+        {
+            b_programmed = FALSE;
+        }
+    }
+
+    return b_programmed;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * block_staged_check checks that a block is in the download buffer.
+ *
+ * @param   block           Block to check.
+ * @param   buffer_offset   Words from the start of the buffer.
+ * @retval  bool_t          TRUE if every word of it is.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t block_staged_check(const uint16_t block, const uint32_t buffer_offset)
+{
+    uint32_t    word;
+    bool_t      b_staged = TRUE;
+
+    for (word = 0u; word < TEST_BLOCK_WORDS; word++)
+    {
+        if (genericIO_16bitRead(BUFFER_BASE_ADDRESS + buffer_offset + word)
+                != block_word_get(block, word))
+        {
+            b_staged = FALSE;
+        }
+    }
+
+    return b_staged;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * block_read_back_check reads a block back, as opcode 38 does.
+ *
+ * @param   block       Block to read.
+ * @retval  bool_t      TRUE if the read worked and matched.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t block_read_back_check(const uint16_t block)
+{
+    uint32_t    word;
+    uint16_t    data;
+    bool_t      b_matches;
+
+    b_matches = PromHardware_ProgramMemoryRead(&m_block[0], TEST_BLOCK_BYTES,
+                                               block_address_get(block));
+
+    /* Read back in UPLOAD_ENDIANESS. */
+    for (word = 0u; (b_matches) && (word < TEST_BLOCK_WORDS); word++)
+    {
+        data = utils_toUint16(&m_block[word * 2u], UPLOAD_ENDIANESS);
+
+        if (data != block_word_get(block, word))
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * block_address_get returns the flash address of a block.
+ *
+ * @param   block       Block.
+ * @retval  uint32_t    Flash address.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t block_address_get(const uint16_t block)
+{
+    return APPLICATION_START_ADDRESS + ((uint32_t)block * TEST_BLOCK_WORDS);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * block_word_get returns a word of the image, different in every block.
+ *
+ * @param   block       Block.
+ * @param   word        Word within the block.
+ * @retval  uint16_t    Word of the image.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint16_t block_word_get(const uint16_t block, const uint32_t word)
+{
+    return (uint16_t)((((uint32_t)block + 1u) * 0x2B67u) ^ (word * 0x0301u));
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
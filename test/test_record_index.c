@@ -0,0 +1,445 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_record_index.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the record index, with searches which match the
+ *              record ID as well as searches which don't.
+ * @details
+ * Records are written into ALL_OTHER (made smaller so it formats quickly)
+ * with their record IDs in runs of different lengths - single records,
+ * short runs, and runs longer than RS_CFG_INDEX_RECORD_INTERVAL - using one
+ * more record ID than the index counts.  There must be one checkpoint for
+ * every RS_CFG_INDEX_RECORD_INTERVAL records, and the index must still be
+ * valid after a restart.
+ *
+ * Then records are searched for both ways, by instance and by instance of
+ * each record ID, as a read request sets the search up.  rsindex_search_seek
+ * must seek every search for a record which is there, except for the record
+ * ID which isn't counted, the search must then find the right record, and a
+ * search for a record which isn't there must find nothing.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "rsapi.h"
+#include "rspartition.h"
+#include "rspartition_prv.h"
+#include "rssearch.h"
+#include "rsindex.h"
+#include "rsindex_prv.h"
+#include "flash_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_PARTITION          6u          ///< ALL_OTHER, which has an index area.
+#define TEST_PAGES              32u         ///< Data pages while the test runs.
+#define TEST_RECORDS            400u        ///< Records written.
+#define TEST_TDR_BYTES          40u         ///< TDR length, even for the main flash.
+#define TEST_RUN_TYPES          13u         ///< Entries in m_runs.
+#define TEST_RECORD_IDS         (RS_CFG_INDEX_RECORD_IDS + 1u)  ///< Record IDs used in m_runs.
+
+/// Checkpoints for TEST_RECORDS, one every RS_CFG_INDEX_RECORD_INTERVAL.
+#define TEST_CHECKPOINTS        ((TEST_RECORDS + RS_CFG_INDEX_RECORD_INTERVAL - 1u) \
+                                    / RS_CFG_INDEX_RECORD_INTERVAL)
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Types section:
+
+/**
+ * A run of records with the same record ID.
+ */
+typedef struct
+{
+    uint16_t    record_id;
+    uint16_t    records;
+} test_run_t;
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static bool_t   records_write(void);
+
+static void     searches_check(const rs_search_direction_t direction,
+                               const bool_t b_match_record_id,
+                               const uint16_t record_id,
+                               const bool_t b_seek_expected);
+
+static uint32_t expected_record_get(const rs_search_direction_t direction,
+                                    const bool_t b_match_record_id,
+                                    const uint16_t record_id,
+                                    const uint32_t instance);
+
+static bool_t   record_find(const rs_search_direction_t direction,
+                            const bool_t b_match_record_id,
+                            const uint16_t record_id,
+                            const uint32_t instance,
+                            bool_t * const p_b_seeked,
+                            uint32_t * const p_record_number);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// Runs written, in order, over and over until TEST_RECORDS are written.
+static const test_run_t m_runs[TEST_RUN_TYPES] =
+{
+    { 10u,  1u },
+    { 20u,  3u },
+    { 10u,  40u },
+    { 30u,  1u },
+    { 20u,  70u },
+    { 10u,  2u },
+    { 30u,  5u },
+    { 20u,  1u },
+    { 10u,  33u },
+    { 40u,  2u },
+    { 50u,  1u },
+    { 60u,  3u },
+    { 70u,  4u },
+};
+
+/// The last record ID is written after all the others, so it isn't counted.
+static const uint16_t   m_record_ids[TEST_RECORD_IDS] = { 10u, 20u, 30u, 40u, 50u, 60u, 70u };
+
+static uint32_t m_failures;
+
+/// Record ID of each record written, by record number - 1.
+static uint16_t m_written_ids[TEST_RECORDS];
+
+static uint8_t  m_write_buffer[TEST_TDR_BYTES + RSAPI_BYTES_BEFORE_TDR
+                                + RSAPI_BYTES_AFTER_TDR];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_record_index_check writes the records, then searches for them with
+ * the record index.
+ *
+ * @retval  bool_t      TRUE if everything was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_record_index_check(void)
+{
+    rs_partition_info_t*    p_settings;
+    const rsindex_state_t*  p_index;
+    uint32_t                saved_pages;
+    uint32_t                id;
+    uint8_t                 dummy_progress;
+
+    m_failures = 0u;
+
+    p_settings  = &rspartition_unit_test_ptrs_get()->p_partitions[TEST_PARTITION];
+    p_index     = &rsindex_unit_test_ptrs_get()->p_index_state[TEST_PARTITION];
+    saved_pages = p_settings->number_of_pages;
+
+    p_settings->number_of_pages = TEST_PAGES;
+
+    flash_sim_install();
+    flash_sim_reset();
+
+    TEST_EXPECT(rsapi_recording_system_init());
+    TEST_EXPECT(rspartition_format_partition(TEST_PARTITION, &dummy_progress)
+                    == RS_ERR_NO_ERROR);
+
+    TEST_EXPECT(records_write());
+    TEST_EXPECT(rsindex_query_if_valid(TEST_PARTITION));
+    TEST_EXPECT(p_index->entries_used == TEST_CHECKPOINTS);
+    TEST_EXPECT(p_index->records_written == TEST_RECORDS);
+
+    /* Start again, as after a power cycle, and the index must be the same. */
+    TEST_EXPECT(rsapi_recording_system_init());
+    TEST_EXPECT(rsindex_query_if_valid(TEST_PARTITION));
+    TEST_EXPECT(p_index->entries_used == TEST_CHECKPOINTS);
+    TEST_EXPECT(p_index->records_written == TEST_RECORDS);
+    TEST_EXPECT(p_index->id_table.ids_tracked == RS_CFG_INDEX_RECORD_IDS);
+
+    searches_check(RSSEARCH_FORWARDS, FALSE, 0u, TRUE);
+    searches_check(RSSEARCH_BACKWARDS, FALSE, 0u, TRUE);
+
+    for (id = 0u; id < TEST_RECORD_IDS; id++)
+    {
+        searches_check(RSSEARCH_FORWARDS, TRUE, m_record_ids[id],
+                       (id < RS_CFG_INDEX_RECORD_IDS));
+        searches_check(RSSEARCH_BACKWARDS, TRUE, m_record_ids[id],
+                       (id < RS_CFG_INDEX_RECORD_IDS));
+    }
+
+    /* Leave the partitions as the next check expects. */
+    p_settings->number_of_pages = saved_pages;
+    flash_sim_reset();
+
+    printf("%u checkpoints, failures %u", p_index->entries_used, m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * records_write writes TEST_RECORDS records, with the record IDs taken from
+ * m_runs.  The TDR starts with the record number.
+ *
+ * @retval  bool_t      TRUE if every record was written.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t records_write(void)
+{
+    const rs_partition_info_t*  p_partition;
+    rs_queue_status_t           write_status;
+    rs_write_request_t          write_request;
+    rs_write_batch_request_t    batch_request;
+    uint32_t                    record_number;
+    uint32_t                    run_type = 0u;
+    uint32_t                    in_run_type = 0u;
+    uint16_t                    i;
+    bool_t                      b_written = TRUE;
+
+    p_partition = rspartition_partition_ptr_get(TEST_PARTITION);
+
+    for (record_number = 1u; record_number <= TEST_RECORDS; record_number++)
+    {
+        if (in_run_type == m_runs[run_type].records)
+        {
+            run_type    = (run_type + 1u) % TEST_RUN_TYPES;
+            in_run_type = 0u;
+        }
+
+        in_run_type++;
+
+        m_written_ids[record_number - 1u] = m_runs[run_type].record_id;
+
+        for (i = 0u; i < TEST_TDR_BYTES; i++)
+        {
+            m_write_buffer[RSAPI_BYTES_BEFORE_TDR + i]
+                = (uint8_t)((record_number >> ((i % 4u) * 8u)) & 0xFFu);
+        }
+
+        write_status = RS_QUEUE_COULD_NOT_ADD_TO_QUEUE;
+
+        write_request.partition_id         = p_partition->id;
+        write_request.record_id            = m_runs[run_type].record_id;
+        write_request.p_write_buffer       = &m_write_buffer[0];
+        write_request.tdr_bytes_to_write   = TEST_TDR_BYTES;
+        write_request.b_read_back_required = FALSE;
+        write_request.p_write_status       = &write_status;
+        write_request.p_write_semaphore    = NULL;
+
+        batch_request.partition_id       = p_partition->id;
+        batch_request.p_write_requests   = &write_request;
+        batch_request.number_of_requests = 1u;
+
+        if ( (rsapi_write_batch_request(&batch_request) != RS_ERR_NO_ERROR)
+                || (write_status != RS_QUEUE_REQUEST_COMPLETE) )
+        {
+            b_written = FALSE;
+        }
+    }
+
+    return b_written;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * searches_check searches for every instance, and for the instance just past
+ * the last one.
+ *
+ * @param   direction           Direction to search in.
+ * @param   b_match_record_id   TRUE to search for instances of record_id.
+ * @param   record_id           Record ID to match.
+ * @param   b_seek_expected     TRUE if the index should seek the searches.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void searches_check(const rs_search_direction_t direction,
+                           const bool_t b_match_record_id,
+                           const uint16_t record_id,
+                           const bool_t b_seek_expected)
+{
+    uint32_t    instance = 0u;
+    uint32_t    expected_record;
+    uint32_t    found_record = 0u;
+    bool_t      b_seeked;
+    bool_t      b_found;
+    bool_t      b_finished = FALSE;
+
+    while (!b_finished)
+    {
+        expected_record = expected_record_get(direction, b_match_record_id,
+                                              record_id, instance);
+
+        b_found = record_find(direction, b_match_record_id, record_id,
+                              instance, &b_seeked, &found_record);
+
+        if (expected_record == 0u)
+        {
+            TEST_EXPECT(!b_found);
+            b_finished = TRUE;
+        }
+        else
+        {
+            TEST_EXPECT(b_seeked == b_seek_expected);
+            TEST_EXPECT(b_found);
+            TEST_EXPECT(found_record == expected_record);
+
+            instance++;
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * expected_record_get works out which record a search should find from the
+ * record IDs written.
+ *
+ * @param   direction           Direction to search in.
+ * @param   b_match_record_id   TRUE to search for instances of record_id.
+ * @param   record_id           Record ID to match.
+ * @param   instance            Instance to find.
+ * @retval  uint32_t            Record number, or 0 if there's no such record.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t expected_record_get(const rs_search_direction_t direction,
+                                    const bool_t b_match_record_id,
+                                    const uint16_t record_id,
+                                    const uint32_t instance)
+{
+    uint32_t    checked;
+    uint32_t    record_number;
+    uint32_t    instances_seen = 0u;
+    uint32_t    expected_record = 0u;
+
+    for (checked = 0u; (checked < TEST_RECORDS) && (expected_record == 0u); checked++)
+    {
+        if (direction == RSSEARCH_FORWARDS)
+        {
+            record_number = checked + 1u;
+        }
+        else
+        {
+            record_number = TEST_RECORDS - checked;
+        }
+
+        if ( (!b_match_record_id) || (m_written_ids[record_number - 1u] == record_id) )
+        {
+            if (instances_seen == instance)
+            {
+                expected_record = record_number;
+            }
+
+            instances_seen++;
+        }
+    }
+
+    return expected_record;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * record_find sets up a search as read_required_state_do does, seeks it with
+ * the record index and then carries it out.
+ *
+ * @param   direction           Direction to search in.
+ * @param   b_match_record_id   TRUE to search for instances of record_id.
+ * @param   record_id           Record ID to match.
+ * @param   instance            Instance to find.
+ * @param   p_b_seeked          Pointer to return whether the index was used.
+ * @param   p_record_number     Pointer to return the record number found.
+ * @retval  bool_t              TRUE if a record with the right ID was found.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_find(const rs_search_direction_t direction,
+                          const bool_t b_match_record_id,
+                          const uint16_t record_id,
+                          const uint32_t instance,
+                          bool_t * const p_b_seeked,
+                          uint32_t * const p_record_number)
+{
+    const rs_partition_info_t*  p_partition;
+    const rssearch_rsr_info_t*  p_rsr_info;
+    rssearch_search_data_t      search_data;
+    bool_t                      b_found = FALSE;
+
+    p_partition = rspartition_partition_ptr_get(TEST_PARTITION);
+
+    search_data.search_direction                = direction;
+    search_data.partition_logical_start_address = p_partition->start_address;
+    search_data.partition_logical_end_address   = p_partition->end_address;
+    search_data.required_record_instance        = instance;
+    search_data.b_match_record_id               = b_match_record_id;
+    search_data.required_record_id              = record_id;
+    search_data.b_ring_wrapped                  = FALSE;
+    search_data.ring_oldest_address             = p_partition->start_address;
+    search_data.ring_next_free_address          = p_partition->next_available_address;
+
+    if (direction == RSSEARCH_FORWARDS)
+    {
+        search_data.search_start_address = p_partition->start_address;
+    }
+    else
+    {
+        search_data.search_start_address = p_partition->next_available_address;
+    }
+
+    *p_b_seeked = rsindex_search_seek(TEST_PARTITION, &search_data);
+
+    if (rssearch_find_valid_RSR_start(&search_data))
+    {
+        p_rsr_info = rssearch_valid_rsr_pointer_get();
+
+        *p_record_number = (uint32_t)p_rsr_info->p_start_of_tdr[0]
+                            | ((uint32_t)p_rsr_info->p_start_of_tdr[1] << 8u)
+                            | ((uint32_t)p_rsr_info->p_start_of_tdr[2] << 16u)
+                            | ((uint32_t)p_rsr_info->p_start_of_tdr[3] << 24u);
+
+        b_found = ( (p_rsr_info->tdr_length == TEST_TDR_BYTES)
+                    && ( (!b_match_record_id) || (p_rsr_info->record_id == record_id) ) );
+    }
+
+    return b_found;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
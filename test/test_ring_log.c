@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_ring_log.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the circular partition mode, with ring sizes and
+ *              record sizes which ring_log_sim's default run doesn't use.
+ * @details
+ * ring_log_sim is run with:
+ *  - the smallest ring allowed, three erase units, filled with short records
+ *    so that most pages hold many of them;
+ *  - the largest TDRs, so that records often don't fit at the end of a page,
+ *    nor at the end of the ring;
+ *  - a ring size which isn't a whole number of blocks, with every record
+ *    read back.
+ *
+ * Each run must keep every record from the oldest to the newest, mount back
+ * to the same head after a restart, have no record index (the oldest records
+ * are erased from under it), and never program flash which isn't erased.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "rsappconfig.h"
+#include "ring_log_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_RUNS               3u          ///< Ring logs written.
+#define TEST_BURST_PARTITION    5u          ///< Partition used as the ring log.
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// Partition, ring pages, TDR bytes, wraps, write interval (us), read stride.
+static const ring_log_sim_config_t  m_runs[TEST_RUNS] =
+{
+    { TEST_BURST_PARTITION, 48u,    64u,                        2u, 500u,   97u },
+    { TEST_BURST_PARTITION, 64u,    RING_LOG_SIM_MAX_TDR_BYTES, 3u, 2000u,  5u },
+    { TEST_BURST_PARTITION, 70u,    254u,                       2u, 1000u,  1u },
+};
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_ring_log_check writes every ring log in m_runs.
+ *
+ * @retval  bool_t      TRUE if every ring log passed.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_ring_log_check(void)
+{
+    ring_log_sim_result_t   result;
+    uint32_t                run;
+    uint32_t                records = 0u;
+    uint32_t                reads = 0u;
+    uint32_t                failed_runs = 0u;
+
+    for (run = 0u; run < TEST_RUNS; run++)
+    {
+        if ( (!ring_log_sim_run(&m_runs[run], &result))
+                || (result.write_failures != 0u)
+                || (!result.b_mount_matches)
+                || (!result.b_no_index)
+                || (!result.b_ends_ok)
+                || (result.reads == 0u)
+                || (result.read_mismatches != 0u)
+                || (result.bit_raise_attempts != 0u) )
+        {
+            printf("ring %u failed  ", run);
+            failed_runs++;
+        }
+
+        records += result.records_written;
+        reads += result.reads;
+    }
+
+    printf("%u records, %u read back", records, reads);
+
+    return (failed_runs == 0u);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
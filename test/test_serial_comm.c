@@ -0,0 +1,625 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_serial_comm.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the SCI receive ring and the SSB frame parser.
+ * @details
+ * A stream of SSB frames is fed through the SCI B receive interrupt, a
+ * character at a time or in FIFO sized bursts, while the real serial_comm.c
+ * parses it out of the ring.  The stream arrives at 115200 baud on the
+ * simulated clock, which moves on as serial_comm.c polls the ring (through
+ * the SSB port functions below, which stand in for tool_specific_hardware.c),
+ * so the inter-character and message timeouts run as they would on the
+ * target.
+ *
+ * The stream holds good frames, with garbage between some of them, frames
+ * with a bad checksum, a bad end character or another slave's address, and
+ * frames which stop part way for longer than the inter-character timeout.
+ * It is long enough to wrap the ring many times.  Each good frame must be
+ * accepted with its data intact after more of the stream has arrived, as it
+ * would while the opcode is being dealt with, every bad frame must be
+ * rejected, and no character may be lost.  Lastly the ring is filled past
+ * the end without being read, which must lose the newest characters, not
+ * the oldest.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdio.h>
+#include <string.h>
+#include "common_data_types.h"
+#include "DSP28335_device.h"
+#include "timer.h"
+#include "comm.h"
+#include "serial_comm.h"
+#include "sci.h"
+#include "tool_specific_config.h"
+#include "tool_specific_hardware.h"
+#include "flash_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_FRAMES             400u        ///< Frames in the stream.
+#define TEST_STREAM_MAX         (TEST_FRAMES * 600u)
+#define TEST_RING_SIZE          2048u       ///< As MAX_SSB_BUFFER_RX_SIZE.
+#define TEST_MAX_DATA           300u        ///< Longest data in a frame.
+#define TEST_STALL_DATA         100u        ///< Data in a frame which stalls.
+#define TEST_OTHER_ADDRESS      0x8Cu       ///< Another slave on the bus.
+#define TEST_CHARACTER_NS       86806u      ///< One character at 115200 baud.
+#define TEST_POLL_NS            2000u       ///< Time taken by each poll.
+#define TEST_STALL_NS           20000000u   ///< Longer than COMM_TIMEOUT.
+#define TEST_MESSAGE_TIMEOUT_MS 100u        ///< Timeout for each message wait.
+#define TEST_PROCESSING_NS      5000000u    ///< Time taken to deal with a frame.
+#define TEST_FIFO_DEPTH         16u         ///< SCI receive FIFO depth.
+
+/**
+ * What each frame in the stream is.
+ */
+typedef enum
+{
+    FRAME_GOOD,
+    FRAME_BAD_CHECKSUM,
+    FRAME_BAD_END,
+    FRAME_OTHER_ADDRESS,
+    FRAME_STALLED
+} test_frame_kind_t;
+
+/**
+ * A good frame, as it should be received.
+ */
+typedef struct
+{
+    uint32_t    offset;             ///< Offset of the data in the stream.
+    uint16_t    length;             ///< Length of the data.
+    uint8_t     opcode;
+} test_expected_t;
+
+/**
+ * Results of one pass over the stream.
+ */
+typedef struct
+{
+    uint32_t    accepted;           ///< MESSAGE_OK.
+    uint32_t    rejected;           ///< MESSAGE_ERROR.
+    uint32_t    timeouts;           ///< MESSAGE_TIMEOUT.
+    uint32_t    copied;             ///< Accepted frames which wrapped the ring.
+    uint32_t    mismatches;         ///< Accepted frames not as sent.
+} test_pass_t;
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     StreamBuild(void);
+
+static void     FrameAppend(const test_frame_kind_t kind);
+
+static void     StreamPut(const uint8_t character);
+
+static void     Deliver(void);
+
+static void     Pass(const uint16_t burst, test_pass_t* const p_pass);
+
+static bool_t   RingFullCheck(void);
+
+static uint32_t Random(void);
+
+
+// ----------------------------------------------------------------------------
+// Variables with global scope:
+
+/// Normally in comm.c - used by serial_comm.c when a frame wraps the ring.
+unsigned char   gRxBuffer[COMM_MAX_LENGTH];
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+static uint8_t          m_ring[TEST_RING_SIZE];
+static uint8_t          m_stream[TEST_STREAM_MAX];
+static uint32_t         m_stream_length;
+static uint32_t         m_stall_at[TEST_FRAMES];
+static uint32_t         m_stalls;
+static test_expected_t  m_expected[TEST_FRAMES];
+static uint32_t         m_expected_count;
+static uint32_t         m_bad_count;
+
+static uint32_t         m_position;         ///< Next character for the ring.
+static uint32_t         m_line_position;    ///< Next character on the line.
+static uint64_t         m_line_ns;          ///< When it will have arrived.
+static uint64_t         m_interrupt_ns;     ///< When the interrupt last ran.
+static uint32_t         m_next_stall;       ///< Index into m_stall_at[].
+static uint16_t         m_burst;            ///< Character times between interrupts.
+static uint32_t         m_random;           ///< Random number state.
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_serial_comm_check runs the stream through a character at a time, and
+ * in FIFO sized bursts.
+ *
+ * @retval  bool_t      TRUE if every frame was dealt with as it should be.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_serial_comm_check(void)
+{
+    test_pass_t single;
+    test_pass_t fifo;
+    bool_t      b_passed = TRUE;
+    uint32_t    i;
+
+    StreamBuild();
+    Pass(1u, &single);
+    Pass(TEST_FIFO_DEPTH, &fifo);
+
+    printf("%u frames, %u bad, %u stalled, %u copied at the wrap",
+           m_expected_count, m_bad_count, m_stalls, fifo.copied);
+
+    for (i = 0u; i < 2u; i++)
+    {
+        const test_pass_t* p_pass = (i == 0u) ? &single : &fifo;
+
+        if ( (p_pass->accepted != m_expected_count)
+                || (p_pass->mismatches != 0u)
+                || (p_pass->rejected != m_bad_count)
+                || (p_pass->timeouts < m_stalls)
+                || (p_pass->copied == 0u) )
+        {
+            printf(" [burst %u: ok %u, errors %u, timeouts %u, mismatches %u]",
+                   (i == 0u) ? 1u : TEST_FIFO_DEPTH, p_pass->accepted,
+                   p_pass->rejected, p_pass->timeouts, p_pass->mismatches);
+            b_passed = FALSE;
+        }
+    }
+
+    if (SCI_RxOverrunCountGet(SCI_B) != 0u)
+    {
+        printf(" overruns %u", SCI_RxOverrunCountGet(SCI_B));
+        b_passed = FALSE;
+    }
+
+    if (!RingFullCheck())
+    {
+        printf(" [full ring overwritten]");
+        b_passed = FALSE;
+    }
+
+    return b_passed;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * The SSB port functions used by serial_comm.c, as in tool_specific_hardware.c.
+ * The span get delivers the next characters of the stream first, as if they
+ * had arrived while serial_comm.c was polling.
+ */
+// ----------------------------------------------------------------------------
+bool_t ToolSpecificHardware_SSBPortCharacterReceiveReadOnce(unsigned char* pData)
+{
+    Deliver();
+
+    return SCI_RxCharacterGet(SCI_B, pData);
+}
+
+uint16_t ToolSpecificHardware_SSBPortReceiveSpanGet(uint16_t Offset, const unsigned char** ppData)
+{
+    Deliver();
+
+    return SCI_RxSpanGet(SCI_B, Offset, ppData);
+}
+
+void ToolSpecificHardware_SSBPortReceiveSpanRelease(uint16_t Count)
+{
+    SCI_RxSpanRelease(SCI_B, Count);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * The rest of the port functions used by serial_comm.c, which the test doesn't
+ * need - there is no ISB port, and nothing is sent.
+ */
+// ----------------------------------------------------------------------------
+bool_t ToolSpecificHardware_ISBPortCharacterReceiveReadOnce(unsigned char* pData)
+{
+    (void)pData;
+
+    return FALSE;
+}
+
+uint16_t ToolSpecificHardware_ISBPortReceiveSpanGet(uint16_t Offset, const unsigned char** ppData)
+{
+    (void)Offset;
+    (void)ppData;
+
+    return 0u;
+}
+
+void ToolSpecificHardware_ISBPortReceiveSpanRelease(uint16_t Count)            { (void)Count; }
+void ToolSpecificHardware_SSBTransmitEnable(void)                              { }
+void ToolSpecificHardware_SSBTransmitDisable(void)                             { }
+void ToolSpecificHardware_ISBTransmitEnable(void)                              { }
+void ToolSpecificHardware_ISBTransmitDisable(void)                             { }
+void ToolSpecificHardware_SSBPortWaitForSendComplete(void)                     { }
+void ToolSpecificHardware_ISBPortWaitForSendComplete(void)                     { }
+void ToolSpecificHardware_SSBPortByteSend(unsigned char data)                  { (void)data; }
+void ToolSpecificHardware_ISBPortByteSend(unsigned char data)                  { (void)data; }
+void ToolSpecificHardware_DebugMessageSend(char* pDebugMessage)                { (void)pDebugMessage; }
+
+void ToolSpecificHardware_SSBPortBufferSend(const unsigned char* pData, uint16_t Count)
+{
+    (void)pData;
+    (void)Count;
+}
+
+void ToolSpecificHardware_ISBPortBufferSend(const unsigned char* pData, uint16_t Count)
+{
+    (void)pData;
+    (void)Count;
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * StreamBuild makes up the stream of frames.  Garbage never holds a start
+ * character, nor does the part of a stalled frame which is sent, so that
+ * neither can be mistaken for the start of the next frame.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void StreamBuild(void)
+{
+    uint32_t    frame;
+    uint32_t    garbage;
+    uint32_t    kind;
+
+    m_random = 10u;
+    m_stream_length = 0u;
+    m_stalls = 0u;
+    m_expected_count = 0u;
+    m_bad_count = 0u;
+
+    for (frame = 0u; frame < TEST_FRAMES; frame++)
+    {
+        if ((Random() % 4u) == 0u)
+        {
+            for (garbage = 1u + (Random() % 40u); garbage != 0u; garbage--)
+            {
+                StreamPut((uint8_t)(2u + (Random() % 254u)));
+            }
+        }
+
+        kind = Random() % 20u;
+
+        if (kind < 14u)
+        {
+            FrameAppend(FRAME_GOOD);
+        }
+        else if (kind < 16u)
+        {
+            FrameAppend(FRAME_BAD_CHECKSUM);
+        }
+        else if (kind < 17u)
+        {
+            FrameAppend(FRAME_BAD_END);
+        }
+        else if (kind < 19u)
+        {
+            FrameAppend(FRAME_OTHER_ADDRESS);
+        }
+        else
+        {
+            FrameAppend(FRAME_STALLED);
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * FrameAppend adds one frame to the stream.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void FrameAppend(const test_frame_kind_t kind)
+{
+    uint16_t    data_length;
+    uint16_t    length;
+    uint16_t    checksum;
+    uint16_t    i;
+    uint8_t     address = SSB_SLAVE_ADDRESS;
+    uint8_t     opcode = (uint8_t)Random();
+    uint8_t     data;
+
+    data_length = (kind == FRAME_STALLED) ? TEST_STALL_DATA
+                                          : (uint16_t)(Random() % (TEST_MAX_DATA + 1u));
+    length = data_length + SERIAL_HEADER_LENGTH;
+
+    if (kind == FRAME_OTHER_ADDRESS)
+    {
+        address = TEST_OTHER_ADDRESS;
+    }
+
+    if (kind == FRAME_STALLED)
+    {
+        opcode = 0x20u;
+    }
+
+    StreamPut(SERIAL_STARTCHAR);
+    StreamPut(address);
+    StreamPut((uint8_t)(length & 0x00FFu));
+    StreamPut((uint8_t)(length >> 8));
+    StreamPut(opcode);
+
+    if (kind == FRAME_GOOD)
+    {
+        m_expected[m_expected_count].offset = m_stream_length;
+        m_expected[m_expected_count].length = data_length;
+        m_expected[m_expected_count].opcode = opcode;
+        m_expected_count++;
+    }
+    else if (kind != FRAME_STALLED)
+    {
+        m_bad_count++;
+    }
+
+    checksum = (uint16_t)(address + (length & 0x00FFu) + (length >> 8) + opcode);
+
+    for (i = 0u; i < data_length; i++)
+    {
+        data = (uint8_t)Random();
+
+        if (kind == FRAME_STALLED)
+        {
+            if (i == (data_length / 2u))
+            {
+                // The rest of the frame never arrives.
+                m_stall_at[m_stalls] = m_stream_length;
+                m_stalls++;
+                return;
+            }
+
+            data |= 0x02u;
+        }
+
+        StreamPut(data);
+        checksum += data;
+    }
+
+    if (kind == FRAME_BAD_CHECKSUM)
+    {
+        checksum ^= 0x0100u;
+    }
+
+    StreamPut((uint8_t)(checksum & 0x00FFu));
+    StreamPut((uint8_t)(checksum >> 8));
+    StreamPut((kind == FRAME_BAD_END) ? (uint8_t)(SERIAL_ENDCHAR + 1u) : SERIAL_ENDCHAR);
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * StreamPut adds one character to the stream.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void StreamPut(const uint8_t character)
+{
+    if (m_stream_length < TEST_STREAM_MAX)
+    {
+        m_stream[m_stream_length] = character;
+        m_stream_length++;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * Deliver moves the simulated clock on by the time a poll takes, lets the
+ * stream arrive on the line at the character rate up to then (idling at a
+ * stall), and runs the receive interrupt once every m_burst character times
+ * to move whatever has arrived into the ring, a character in the FIFO each
+ * time.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void Deliver(void)
+{
+    uint64_t    now;
+
+    flash_sim_time_advance(TEST_POLL_NS);
+    now = flash_sim_time_ns_get();
+
+    while ( (m_line_position < m_stream_length) && (m_line_ns <= now) )
+    {
+        if ( (m_next_stall < m_stalls) && (m_line_position == m_stall_at[m_next_stall]) )
+        {
+            m_line_ns += TEST_STALL_NS;
+            m_next_stall++;
+        }
+        else
+        {
+            m_line_position++;
+            m_line_ns += TEST_CHARACTER_NS;
+        }
+    }
+
+    if ( (m_position < m_line_position)
+            && ((now - m_interrupt_ns) >= ((uint64_t)m_burst * TEST_CHARACTER_NS)) )
+    {
+        m_interrupt_ns = now;
+
+        while (m_position < m_line_position)
+        {
+            ScibRegs.SCIFFRX.bit.RXFFST = 1u;
+            ScibRegs.SCIRXBUF.all = m_stream[m_position];
+            SCI_RxInterruptB_ISR();
+
+            m_position++;
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * Pass runs the whole stream through serial_comm.c.
+ *
+ * @param   burst       Characters delivered by each receive interrupt.
+ * @param   p_pass      Results are written here.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void Pass(const uint16_t burst, test_pass_t* const p_pass)
+{
+    LoaderMessage_t*    p_message = serial_LoaderMessagePointerGet();
+    const test_expected_t* p_expected;
+    Timer_t             timer;
+    EMessageStatus_t    status;
+
+    (void)memset(p_pass, 0, sizeof(*p_pass));
+    SCI_RxBufferInitialise(SCI_B, m_ring, TEST_RING_SIZE);
+    m_position = 0u;
+    m_line_position = 0u;
+    m_line_ns = flash_sim_time_ns_get() + TEST_CHARACTER_NS;
+    m_interrupt_ns = flash_sim_time_ns_get();
+    m_next_stall = 0u;
+    m_burst = burst;
+
+    // Until the stream has all arrived, and the last wait found nothing.
+    do
+    {
+        Timer_TimerSet(&timer, TEST_MESSAGE_TIMEOUT_MS);
+        status = serial_MessageWait(&timer, FALSE, BUS_SSB);
+
+        if (status == MESSAGE_OK)
+        {
+            // More of the stream arrives while the opcode deals with it.
+            flash_sim_time_advance(TEST_PROCESSING_NS);
+            Deliver();
+
+            if (p_pass->accepted < m_expected_count)
+            {
+                p_expected = &m_expected[p_pass->accepted];
+
+                if ( (p_message->opcode != p_expected->opcode)
+                        || (p_message->dataLengthInBytes != p_expected->length)
+                        || (memcmp(p_message->dataPtr, &m_stream[p_expected->offset],
+                                   p_expected->length) != 0) )
+                {
+                    p_pass->mismatches++;
+                }
+            }
+            else
+            {
+                p_pass->mismatches++;
+            }
+
+            if ( (p_message->dataPtr == gRxBuffer) && (p_message->dataLengthInBytes != 0u) )
+            {
+                p_pass->copied++;
+            }
+
+            p_pass->accepted++;
+        }
+        else if (status == MESSAGE_ERROR)
+        {
+            p_pass->rejected++;
+        }
+        else
+        {
+            p_pass->timeouts++;
+        }
+    } while ( (m_position < m_stream_length) || (status != MESSAGE_TIMEOUT) );
+}
+
+// ----------------------------------------------------------------------------
+/**
+ * RingFullCheck fills the ring without reading it, with TEST_FIFO_DEPTH
+ * characters more than it holds.  Those must be counted as overruns, and the
+ * characters in the ring must be the first ones sent.
+ *
+ * @retval  bool_t      TRUE if the ring kept the oldest characters.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t RingFullCheck(void)
+{
+    const uint8_t*  p_span = NULL;
+    uint16_t        offset = 0u;
+    uint16_t        span_length;
+    uint32_t        i;
+    bool_t          b_kept = TRUE;
+
+    SCI_RxBufferInitialise(SCI_B, m_ring, TEST_RING_SIZE);
+
+    for (i = 0u; i < (TEST_RING_SIZE + TEST_FIFO_DEPTH); i++)
+    {
+        ScibRegs.SCIFFRX.bit.RXFFST = 1u;
+        ScibRegs.SCIRXBUF.all = m_stream[i];
+        SCI_RxInterruptB_ISR();
+    }
+
+    if ( (SCI_RxOverrunCountGet(SCI_B) != TEST_FIFO_DEPTH)
+            || (SCI_RxBufferNumberOfCharsGet(SCI_B) != TEST_RING_SIZE) )
+    {
+        b_kept = FALSE;
+    }
+
+    while ( (b_kept) && (offset < TEST_RING_SIZE) )
+    {
+        span_length = SCI_RxSpanGet(SCI_B, offset, &p_span);
+
+        if ( (span_length == 0u) || (memcmp(p_span, &m_stream[offset], span_length) != 0) )
+        {
+            b_kept = FALSE;
+        }
+
+        offset += span_length;
+    }
+
+    SCI_RxBufferFlush(SCI_B);
+
+    return b_kept;
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * Random returns the next number from a 32 bit xorshift generator.  The C
+ * library's one can't be used, as stdlib.h clashes with utils.h on the host.
+ *
+ */
+// ----------------------------------------------------------------------------
+static uint32_t Random(void)
+{
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+
+    return m_random;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
@@ -0,0 +1,311 @@
+// ----------------------------------------------------------------------------
+/**
+ * @file        test_xdi_shadow.c
+ * @author      Fei Li (LIF@xsyu.edu.cn)
+ * @date        16 Oct 2026
+ * @brief       Host test of the XDI region RAM shadow, with records which
+ *              xdi_shadow_sim's default run doesn't use, and EEPROM writes
+ *              which don't go through XDIMEMORY_WriteRequest.
+ * @details
+ * xdi_shadow_sim is run with a short record, with a change which spans
+ * a page boundary, and with the longest record.  Each must leave the record
+ * in the EEPROM and take fewer write cycles than writing it all.
+ *
+ * Then the XDI region is written straight through the EEPROM driver, as
+ * flash.c and the flash HAL do, and erased, as FLASH_Erase does.  Each time
+ * XDIMEMORY_ReadRequest must return what is in the EEPROM rather than the
+ * old shadow, and the next XDIMEMORY_WriteRequest must put the record back.
+ *
+ * @attention
+ * (c) Copyright Xi'an Shiyou Univ. DD Lab, unpublished work, created 2026.
+ * This computer program includes confidential, proprietary information and is a
+ * trade secret of Xi'an Shiyou Univ. DD Lab  All use, disclosure, and/or
+ * reproduction is prohibited unless authorized in writing.  All Rights Reserved.
+ *
+ */
+// ----------------------------------------------------------------------------
+// Include section - add all #includes here:
+
+#include <stdint.h>
+#include <stdio.h>
+#include "common_data_types.h"
+#include "rsapi.h"
+#include "crc.h"
+#include "flash_sim.h"
+#include "x24lc32a.h"
+#include "XDImemory.h"
+#include "xdi_shadow_sim.h"
+#include "host_tests.h"
+
+
+// ----------------------------------------------------------------------------
+// Defines section - add all #defines here:
+
+#define TEST_RUNS               3u          ///< xdi_shadow_sim records written.
+#define TEST_XDI_ADDRESS        0x400u      ///< XDI region in the EEPROM.
+#define TEST_XDI_BYTES          1024u       ///< Size of the XDI region.
+#define TEST_RECORD_BYTES       200u        ///< numberOfBytesToWrite for the direct tests.
+#define TEST_DATA_START_IDX     5u          ///< First data byte in the write buffer.
+#define TEST_BYPASS_OFFSET      40u         ///< First data byte written round the shadow.
+#define TEST_BYPASS_BYTES       50u         ///< Data bytes written round the shadow.
+#define TEST_CRC_BYTES          (TEST_RECORD_BYTES - 3u)    ///< Write buffer bytes under the CRC.
+
+/// Counts a failed expectation, with the line it was on.
+#define TEST_EXPECT(condition)                                                  \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("line %d: %s  ", __LINE__, #condition);                      \
+            m_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+
+// ----------------------------------------------------------------------------
+// Function prototypes for functions which only have scope within this module:
+
+static void     sim_runs_check(void);
+
+static void     bypass_write_check(void);
+
+static void     erase_check(void);
+
+static bool_t   record_write(void);
+
+static bool_t   record_read_check(void);
+
+
+// ----------------------------------------------------------------------------
+// Variables which only have scope within this module:
+
+/// Record bytes, first data byte changed, data bytes changed.
+static const xdi_shadow_sim_config_t    m_runs[TEST_RUNS] =
+{
+    { 120u,     0u,     1u },
+    { 300u,     27u,    10u },
+    { 1022u,    900u,   100u },
+};
+
+static uint32_t m_failures;
+
+/// Write buffer, as opcode 206 passes it.
+static uint8_t  m_buffer[TEST_XDI_BYTES + TEST_DATA_START_IDX];
+
+static uint8_t  m_bypass[TEST_BYPASS_BYTES];
+
+static uint8_t  m_read[TEST_XDI_BYTES];
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// CODE STARTS HERE - FUNCTIONS WITH GLOBAL SCOPE - CALLED BY OTHER MODULES
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * test_xdi_shadow_check runs the xdi_shadow_sim records, then writes and
+ * erases the XDI region round the shadow.
+ *
+ * @retval  bool_t      TRUE if everything was as expected.
+ *
+ */
+// ----------------------------------------------------------------------------
+bool_t test_xdi_shadow_check(void)
+{
+    m_failures = 0u;
+
+    sim_runs_check();
+    bypass_write_check();
+    erase_check();
+
+    /* Leave the device as the next check expects. */
+    (void)X24LC32A_Flush();
+    XDIMEMORY_ShadowDiscard_TDD();
+    flash_sim_reset();
+
+    printf("failures %u", m_failures);
+
+    return (m_failures == 0u);
+}
+
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+// FUNCTIONS WITH LOCAL SCOPE BELOW HERE - ONLY ACCESSIBLE BY THIS MODULE
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+/**
+ * sim_runs_check writes every record in m_runs with xdi_shadow_sim.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void sim_runs_check(void)
+{
+    xdi_shadow_sim_result_t result;
+    uint32_t                run;
+
+    for (run = 0u; run < TEST_RUNS; run++)
+    {
+        TEST_EXPECT(xdi_shadow_sim_run(&m_runs[run], &result));
+        TEST_EXPECT(result.b_data_matches);
+        TEST_EXPECT(result.delta_write_cycles < result.full_write_cycles);
+        TEST_EXPECT(result.repeat_read_us < result.first_read_us);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * bypass_write_check writes part of the record straight into the EEPROM,
+ * after the shadow has been loaded.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void bypass_write_check(void)
+{
+    rs_queue_status_t   status;
+    uint16_t            length;
+    uint32_t            i;
+    bool_t              b_matches = TRUE;
+
+    flash_sim_reset();
+    XDIMEMORY_ShadowDiscard_TDD();
+
+    TEST_EXPECT(record_write());
+    TEST_EXPECT(record_read_check());
+
+    for (i = 0u; i < TEST_BYPASS_BYTES; i++)
+    {
+        m_bypass[i] = (uint8_t)~m_buffer[TEST_DATA_START_IDX + TEST_BYPASS_OFFSET + i];
+    }
+
+    /* The two length bytes come before the data in the EEPROM. */
+    TEST_EXPECT(X24LC32A_memcpy(TEST_XDI_ADDRESS + 2u + TEST_BYPASS_OFFSET,
+                                TEST_BYPASS_BYTES, &m_bypass[0]) == I2C_COMPLETED_OK);
+    TEST_EXPECT(X24LC32A_Flush() == I2C_COMPLETED_OK);
+
+    TEST_EXPECT(XDIMEMORY_ReadRequest(&m_read[0], &length, &status));
+
+    for (i = 0u; i < TEST_BYPASS_BYTES; i++)
+    {
+        if (m_read[TEST_BYPASS_OFFSET + i] != m_bypass[i])
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    TEST_EXPECT(b_matches);
+
+    /* The next write must see those bytes differ, and put them back. */
+    TEST_EXPECT(record_write());
+    XDIMEMORY_ShadowDiscard_TDD();
+    TEST_EXPECT(record_read_check());
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * erase_check erases the EEPROM after the shadow has been loaded.
+ *
+ */
+// ----------------------------------------------------------------------------
+static void erase_check(void)
+{
+    rs_queue_status_t   status;
+    uint16_t            length;
+    uint32_t            i;
+    bool_t              b_blank = TRUE;
+
+    flash_sim_reset();
+    XDIMEMORY_ShadowDiscard_TDD();
+
+    TEST_EXPECT(record_write());
+    TEST_EXPECT(record_read_check());
+
+    TEST_EXPECT(X24LC32A_DeviceErase() == I2C_COMPLETED_OK);
+
+    TEST_EXPECT(XDIMEMORY_ReadRequest(&m_read[0], &length, &status));
+    TEST_EXPECT(length == TEST_XDI_BYTES);
+
+    for (i = 0u; i < TEST_XDI_BYTES; i++)
+    {
+        if (m_read[i] != 0xFFu)
+        {
+            b_blank = FALSE;
+        }
+    }
+
+    TEST_EXPECT(b_blank);
+
+    TEST_EXPECT(record_write());
+    XDIMEMORY_ShadowDiscard_TDD();
+    TEST_EXPECT(record_read_check());
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * record_write writes the test record through XDIMEMORY_WriteRequest, which
+ * must not return until it is in the EEPROM, with nothing left in the
+ * write-behind cache.  The CRC put into the record must be the CRC of the
+ * write buffer before it.
+ *
+ * @retval  bool_t      TRUE if the write worked, with the right CRC.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_write(void)
+{
+    rs_queue_status_t   status;
+    uint32_t            i;
+    uint16_t            crc;
+    bool_t              b_written;
+
+    for (i = TEST_DATA_START_IDX; i < (TEST_DATA_START_IDX + TEST_RECORD_BYTES); i++)
+    {
+        m_buffer[i] = (uint8_t)((i * 13u) ^ 0x21u);
+    }
+
+    b_written = ( (XDIMEMORY_WriteRequest(&m_buffer[0], TEST_RECORD_BYTES, &status))
+                    && (!X24LC32A_FlushStep()) );
+
+    crc = CRC_CCITTOnByteCalculate(&m_buffer[0], TEST_CRC_BYTES, 0x0000u);
+
+    return ( (b_written)
+                && (m_buffer[TEST_CRC_BYTES] == (uint8_t)(crc >> 8u))
+                && (m_buffer[TEST_CRC_BYTES + 1u] == (uint8_t)(crc & 0x00FFu)) );
+}
+
+
+// ----------------------------------------------------------------------------
+/**
+ * record_read_check reads the record with XDIMEMORY_ReadRequest, and checks
+ * it against the write buffer (which holds the CRC and end byte as written).
+ *
+ * @retval  bool_t      TRUE if the record was read back.
+ *
+ */
+// ----------------------------------------------------------------------------
+static bool_t record_read_check(void)
+{
+    rs_queue_status_t   status;
+    uint16_t            length;
+    uint32_t            i;
+    bool_t              b_matches;
+
+    b_matches = ( (XDIMEMORY_ReadRequest(&m_read[0], &length, &status))
+                    && (length == TEST_RECORD_BYTES) );
+
+    for (i = 0u; i < (TEST_RECORD_BYTES - 2u); i++)
+    {
+        if (m_read[i] != m_buffer[TEST_DATA_START_IDX + i])
+        {
+            b_matches = FALSE;
+        }
+    }
+
+    return b_matches;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------